@@ -0,0 +1,532 @@
+/*--
+
+This file is a part of libsais, a library for linear time suffix array,
+longest common prefix array and burrows wheeler transform construction.
+
+   Copyright (c) 2021-2024 Ilya Grebnov <ilya.grebnov@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+Please see the file LICENSE for full copyright information.
+
+--*/
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+    #define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "libsais.h"
+#include "libsais16.h"
+#include "libsais16x64.h"
+#include "libsais64.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <dirent.h>
+    #include <sys/stat.h>
+    #include <time.h>
+#endif
+
+#define LIBSAIS_BENCHMARK_MAX_THREADS   64
+#define LIBSAIS_BENCHMARK_PHASES        5
+
+#if defined(__clang__)
+    #define LIBSAIS_BENCHMARK_COMPILER  "clang " __clang_version__
+#elif defined(__GNUC__)
+    #define LIBSAIS_BENCHMARK_COMPILER  "gcc " __VERSION__
+#elif defined(_MSC_VER)
+    #define LIBSAIS_BENCHMARK_STR2(_x)  #_x
+    #define LIBSAIS_BENCHMARK_STR(_x)   LIBSAIS_BENCHMARK_STR2(_x)
+    #define LIBSAIS_BENCHMARK_COMPILER  "msvc " LIBSAIS_BENCHMARK_STR(_MSC_FULL_VER)
+#else
+    #define LIBSAIS_BENCHMARK_COMPILER  "unknown"
+#endif
+
+#if defined(LIBSAIS_OPENMP)
+    #define LIBSAIS_BENCHMARK_OPENMP    1
+    #define LIBSAIS_BENCHMARK_CREATE(_p, _f, _t, _m)                    _p##_##_f##_omp((_t), libsais_benchmark_alloc, libsais_benchmark_free, (_m))
+    #define LIBSAIS_BENCHMARK_LCP(_p, _f, _a, _b, _c, _n, _t)           _p##_##_f##_omp((_a), (_b), (_c), (_n), (_t))
+#else
+    #define LIBSAIS_BENCHMARK_OPENMP    0
+    #define LIBSAIS_BENCHMARK_CREATE(_p, _f, _t, _m)                    ((void)(_t), _p##_##_f(libsais_benchmark_alloc, libsais_benchmark_free, (_m)))
+    #define LIBSAIS_BENCHMARK_LCP(_p, _f, _a, _b, _c, _n, _t)           ((void)(_t), _p##_##_f((_a), (_b), (_c), (_n)))
+#endif
+
+typedef struct LIBSAIS_BENCHMARK_MEMORY
+{
+    size_t      current;
+    size_t      peak;
+} LIBSAIS_BENCHMARK_MEMORY;
+
+typedef struct LIBSAIS_BENCHMARK_VARIANT
+{
+    const char *    name;
+    size_t          symbol_size;
+    size_t          index_size;
+    int64_t         max_n;
+
+    void *          (* create_ctx)(int64_t threads, LIBSAIS_BENCHMARK_MEMORY * memory);
+    void            (* free_ctx)(void * ctx);
+    void *          (* create_unbwt_ctx)(int64_t threads, LIBSAIS_BENCHMARK_MEMORY * memory);
+    void            (* free_unbwt_ctx)(void * ctx);
+
+    int64_t         (* sa)(const void * ctx, const void * T, void * SA, int64_t n);
+    int64_t         (* bwt)(const void * ctx, const void * T, void * U, void * A, int64_t n);
+    int64_t         (* unbwt)(const void * ctx, const void * U, void * V, void * A, int64_t n, int64_t i);
+    int64_t         (* plcp)(const void * T, const void * SA, void * PLCP, int64_t n, int64_t threads);
+    int64_t         (* lcp)(const void * PLCP, const void * SA, void * LCP, int64_t n, int64_t threads);
+} LIBSAIS_BENCHMARK_VARIANT;
+
+static const char * libsais_benchmark_phases[LIBSAIS_BENCHMARK_PHASES] = { "sa", "bwt", "unbwt", "plcp", "lcp" };
+
+static void * libsais_benchmark_alloc(size_t size, size_t alignment, void * opaque)
+{
+    LIBSAIS_BENCHMARK_MEMORY * memory = (LIBSAIS_BENCHMARK_MEMORY *)opaque;
+    size_t header = 2 * sizeof(size_t); if (alignment < sizeof(size_t)) { alignment = sizeof(size_t); }
+
+    unsigned char * address = (unsigned char *)malloc(size + header + alignment - 1);
+    if (address == NULL) { return NULL; }
+
+    unsigned char * aligned_address = address + ((0 - ((uintptr_t)address + header)) & (alignment - 1)) + header;
+    size_t offset = (size_t)(aligned_address - address);
+
+    memcpy(aligned_address - 2 * sizeof(size_t), &offset, sizeof(size_t));
+    memcpy(aligned_address - 1 * sizeof(size_t), &size, sizeof(size_t));
+
+    memory->current += size; if (memory->peak < memory->current) { memory->peak = memory->current; }
+
+    return aligned_address;
+}
+
+static void libsais_benchmark_free(void * address, void * opaque)
+{
+    LIBSAIS_BENCHMARK_MEMORY * memory = (LIBSAIS_BENCHMARK_MEMORY *)opaque;
+    unsigned char * aligned_address = (unsigned char *)address;
+    size_t offset, size;
+
+    memcpy(&offset, aligned_address - 2 * sizeof(size_t), sizeof(size_t));
+    memcpy(&size, aligned_address - 1 * sizeof(size_t), sizeof(size_t));
+
+    memory->current -= size;
+
+    free(aligned_address - offset);
+}
+
+#define LIBSAIS_BENCHMARK_WRAPPERS(_p, _s, _i)                                                                                                                  \
+    static void * _p##_benchmark_create_ctx(int64_t threads, LIBSAIS_BENCHMARK_MEMORY * memory)                                                                 \
+    {                                                                                                                                                           \
+        return LIBSAIS_BENCHMARK_CREATE(_p, create_ctx_alloc, (_i)threads, memory);                                                                             \
+    }                                                                                                                                                           \
+                                                                                                                                                                \
+    static void * _p##_benchmark_create_unbwt_ctx(int64_t threads, LIBSAIS_BENCHMARK_MEMORY * memory)                                                           \
+    {                                                                                                                                                           \
+        return LIBSAIS_BENCHMARK_CREATE(_p, unbwt_create_ctx_alloc, (_i)threads, memory);                                                                       \
+    }                                                                                                                                                           \
+                                                                                                                                                                \
+    static int64_t _p##_benchmark_sa(const void * ctx, const void * T, void * SA, int64_t n)                                                                    \
+    {                                                                                                                                                           \
+        return (int64_t)_p##_ctx(ctx, (const _s *)T, (_i *)SA, (_i)n, 0, NULL);                                                                                 \
+    }                                                                                                                                                           \
+                                                                                                                                                                \
+    static int64_t _p##_benchmark_bwt(const void * ctx, const void * T, void * U, void * A, int64_t n)                                                          \
+    {                                                                                                                                                           \
+        return (int64_t)_p##_bwt_ctx(ctx, (const _s *)T, (_s *)U, (_i *)A, (_i)n, 0, NULL);                                                                     \
+    }                                                                                                                                                           \
+                                                                                                                                                                \
+    static int64_t _p##_benchmark_unbwt(const void * ctx, const void * U, void * V, void * A, int64_t n, int64_t i)                                             \
+    {                                                                                                                                                           \
+        return (int64_t)_p##_unbwt_ctx(ctx, (const _s *)U, (_s *)V, (_i *)A, (_i)n, NULL, (_i)i);                                                               \
+    }                                                                                                                                                           \
+                                                                                                                                                                \
+    static int64_t _p##_benchmark_plcp(const void * T, const void * SA, void * PLCP, int64_t n, int64_t threads)                                                \
+    {                                                                                                                                                           \
+        return (int64_t)LIBSAIS_BENCHMARK_LCP(_p, plcp, (const _s *)T, (const _i *)SA, (_i *)PLCP, (_i)n, (_i)threads);                                         \
+    }                                                                                                                                                           \
+                                                                                                                                                                \
+    static int64_t _p##_benchmark_lcp(const void * PLCP, const void * SA, void * LCP, int64_t n, int64_t threads)                                               \
+    {                                                                                                                                                           \
+        return (int64_t)LIBSAIS_BENCHMARK_LCP(_p, lcp, (const _i *)PLCP, (const _i *)SA, (_i *)LCP, (_i)n, (_i)threads);                                        \
+    }
+
+LIBSAIS_BENCHMARK_WRAPPERS(libsais,         uint8_t,    int32_t)
+LIBSAIS_BENCHMARK_WRAPPERS(libsais16,       uint16_t,   int32_t)
+LIBSAIS_BENCHMARK_WRAPPERS(libsais64,       uint8_t,    int64_t)
+LIBSAIS_BENCHMARK_WRAPPERS(libsais16x64,    uint16_t,   int64_t)
+
+#define LIBSAIS_BENCHMARK_ENTRY(_p, _s, _i, _max)                                                                                                               \
+    { #_p, sizeof(_s), sizeof(_i), (_max),                                                                                                                      \
+      _p##_benchmark_create_ctx, _p##_free_ctx, _p##_benchmark_create_unbwt_ctx, _p##_unbwt_free_ctx,                                                           \
+      _p##_benchmark_sa, _p##_benchmark_bwt, _p##_benchmark_unbwt, _p##_benchmark_plcp, _p##_benchmark_lcp }
+
+static const LIBSAIS_BENCHMARK_VARIANT libsais_benchmark_variants[] =
+{
+    LIBSAIS_BENCHMARK_ENTRY(libsais,        uint8_t,    int32_t,    INT32_MAX),
+    LIBSAIS_BENCHMARK_ENTRY(libsais16,      uint16_t,   int32_t,    INT32_MAX),
+    LIBSAIS_BENCHMARK_ENTRY(libsais64,      uint8_t,    int64_t,    INT64_MAX),
+    LIBSAIS_BENCHMARK_ENTRY(libsais16x64,   uint16_t,   int64_t,    INT64_MAX),
+};
+
+static double libsais_benchmark_time(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER frequency, counter;
+
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+static int libsais_benchmark_compare_names(const void * a, const void * b)
+{
+    return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+static char * libsais_benchmark_join(const char * directory, const char * name)
+{
+    size_t d = strlen(directory), m = strlen(name);
+    char * path = (char *)malloc(d + m + 2);
+
+    if (path != NULL)
+    {
+        memcpy(path, directory, d); path[d] = '/';
+        memcpy(path + d + 1, name, m + 1);
+    }
+
+    return path;
+}
+
+static char * libsais_benchmark_copy(const char * path)
+{
+    char * copy = (char *)malloc(strlen(path) + 1);
+
+    return copy != NULL ? strcpy(copy, path) : NULL;
+}
+
+static int libsais_benchmark_append(char *** files, size_t * count, size_t * capacity, char * path)
+{
+    if (path == NULL) { return -2; }
+
+    if (*count == *capacity)
+    {
+        size_t new_capacity = *capacity > 0 ? 2 * *capacity : 16;
+        char ** new_files = (char **)realloc(*files, new_capacity * sizeof(char *));
+
+        if (new_files == NULL) { free(path); return -2; }
+
+        *files = new_files; *capacity = new_capacity;
+    }
+
+    (*files)[(*count)++] = path;
+
+    return 0;
+}
+
+static int libsais_benchmark_collect(const char * path, char *** files, size_t * count, size_t * capacity)
+{
+    size_t first = *count;
+
+#if defined(_WIN32)
+    DWORD attributes = GetFileAttributesA(path);
+
+    if (attributes == INVALID_FILE_ATTRIBUTES) { return -1; }
+    if ((attributes & FILE_ATTRIBUTE_DIRECTORY) == 0) { return libsais_benchmark_append(files, count, capacity, libsais_benchmark_copy(path)); }
+
+    char * pattern = libsais_benchmark_join(path, "*");
+    if (pattern == NULL) { return -2; }
+
+    WIN32_FIND_DATAA entry;
+    HANDLE handle = FindFirstFileA(pattern, &entry); free(pattern);
+
+    if (handle == INVALID_HANDLE_VALUE) { return -1; }
+
+    do
+    {
+        if ((entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+        {
+            if (libsais_benchmark_append(files, count, capacity, libsais_benchmark_join(path, entry.cFileName)) != 0) { FindClose(handle); return -2; }
+        }
+    } while (FindNextFileA(handle, &entry));
+
+    FindClose(handle);
+#else
+    struct stat st;
+
+    if (stat(path, &st) != 0) { return -1; }
+    if (!S_ISDIR(st.st_mode)) { return libsais_benchmark_append(files, count, capacity, libsais_benchmark_copy(path)); }
+
+    DIR * directory = opendir(path);
+    if (directory == NULL) { return -1; }
+
+    struct dirent * entry;
+    while ((entry = readdir(directory)) != NULL)
+    {
+        char * file = libsais_benchmark_join(path, entry->d_name);
+
+        if (file != NULL && (stat(file, &st) != 0 || !S_ISREG(st.st_mode))) { free(file); continue; }
+        if (libsais_benchmark_append(files, count, capacity, file) != 0) { closedir(directory); return -2; }
+    }
+
+    closedir(directory);
+#endif
+
+    qsort(*files + first, *count - first, sizeof(char *), libsais_benchmark_compare_names);
+
+    return 0;
+}
+
+static uint8_t * libsais_benchmark_read(const char * path, size_t * size)
+{
+    FILE * file = fopen(path, "rb");
+    if (file == NULL) { return NULL; }
+
+    size_t capacity = 1 << 20, length = 0;
+    uint8_t * data = (uint8_t *)malloc(capacity);
+
+    while (data != NULL)
+    {
+        length += fread(data + length, 1, capacity - length, file);
+        if (length < capacity) { break; }
+
+        uint8_t * new_data = (uint8_t *)realloc(data, 2 * capacity);
+        if (new_data == NULL) { free(data); data = NULL; break; }
+
+        data = new_data; capacity *= 2;
+    }
+
+    if (data != NULL && ferror(file)) { free(data); data = NULL; }
+
+    fclose(file); *size = length;
+
+    return data;
+}
+
+static int64_t libsais_benchmark_run(const LIBSAIS_BENCHMARK_VARIANT * variant, int32_t phase, const void * ctx, const void * unbwt_ctx,
+    const uint8_t * T, void * SA, void * U, void * V, void * A, void * PLCP, void * LCP, int64_t n, int64_t i, int64_t threads)
+{
+    switch (phase)
+    {
+        case 0: return variant->sa(ctx, T, SA, n);
+        case 1: return variant->bwt(ctx, T, U, A, n);
+        case 2: return variant->unbwt(unbwt_ctx, U, V, A, n, i);
+        case 3: return variant->plcp(T, SA, PLCP, n, threads);
+        default: return variant->lcp(PLCP, SA, LCP, n, threads);
+    }
+}
+
+static int libsais_benchmark_file(const char * path, const uint8_t * T, size_t size, const LIBSAIS_BENCHMARK_VARIANT * variant, int64_t threads, int32_t runs)
+{
+    int64_t n = (int64_t)(size / variant->symbol_size);
+    if (n < 1 || n > variant->max_n)
+    {
+        fprintf(stderr, "libsais_benchmark: skipping %s for %s (unsupported length)\n", variant->name, path);
+        return 0;
+    }
+
+    size_t symbols = (size_t)n * variant->symbol_size, indexes = (size_t)n * variant->index_size;
+    size_t buffers[LIBSAIS_BENCHMARK_PHASES] =
+    {
+        symbols + indexes,
+        symbols + symbols + indexes,
+        symbols + symbols + indexes + variant->index_size,
+        symbols + indexes + indexes,
+        indexes + indexes + indexes,
+    };
+
+    LIBSAIS_BENCHMARK_MEMORY memory[2] = { { 0, 0 }, { 0, 0 } };
+
+    void * SA           = malloc(indexes);
+    void * U            = malloc(symbols);
+    void * V            = malloc(symbols);
+    void * A            = malloc(indexes + variant->index_size);
+    void * PLCP         = malloc(indexes);
+    void * LCP          = malloc(indexes);
+    void * ctx          = variant->create_ctx(threads, &memory[0]);
+    void * unbwt_ctx    = variant->create_unbwt_ctx(threads, &memory[1]);
+
+    int result = 0;
+    if (SA != NULL && U != NULL && V != NULL && A != NULL && PLCP != NULL && LCP != NULL && ctx != NULL && unbwt_ctx != NULL)
+    {
+        int64_t i = 0;
+        int32_t phase;
+
+        for (phase = 0; phase < LIBSAIS_BENCHMARK_PHASES && result == 0; ++phase)
+        {
+            LIBSAIS_BENCHMARK_MEMORY * tracker = phase < 3 ? &memory[phase / 2] : NULL;
+            double best = 0.0; size_t peak = 0;
+            int32_t run;
+
+            for (run = 0; run < runs; ++run)
+            {
+                if (tracker != NULL) { tracker->peak = tracker->current; }
+
+                double start = libsais_benchmark_time();
+                int64_t r = libsais_benchmark_run(variant, phase, ctx, unbwt_ctx, T, SA, U, V, A, PLCP, LCP, n, i, threads);
+                double elapsed = libsais_benchmark_time() - start;
+
+                if (r < 0) { fprintf(stderr, "libsais_benchmark: %s %s failed on %s (%lld)\n", variant->name, libsais_benchmark_phases[phase], path, (long long)r); result = -1; break; }
+                if (phase == 1) { i = r; }
+
+                if (run == 0 || elapsed < best) { best = elapsed; }
+                if (tracker != NULL && peak < tracker->peak) { peak = tracker->peak; }
+            }
+
+            if (result == 0 && phase == 2 && memcmp(V, T, symbols) != 0)
+            {
+                fprintf(stderr, "libsais_benchmark: %s unbwt does not restore %s\n", variant->name, path); result = -1;
+            }
+
+            if (result == 0)
+            {
+                printf("\"%s\",%d,%s,%s,\"%s\",%lu,%lld,%d,%.6f,%.2f,%lu\n",
+                    LIBSAIS_BENCHMARK_COMPILER, LIBSAIS_BENCHMARK_OPENMP, variant->name, libsais_benchmark_phases[phase], path,
+                    (unsigned long)size, (long long)threads, (int)runs, best, best > 0.0 ? (double)size / best / 1e6 : 0.0, (unsigned long)(buffers[phase] + peak));
+                fflush(stdout);
+            }
+        }
+    }
+    else
+    {
+        fprintf(stderr, "libsais_benchmark: not enough memory for %s on %s\n", variant->name, path); result = -2;
+    }
+
+    if (unbwt_ctx != NULL) { variant->free_unbwt_ctx(unbwt_ctx); }
+    if (ctx != NULL) { variant->free_ctx(ctx); }
+
+    free(LCP); free(PLCP); free(A); free(V); free(U); free(SA);
+
+    return result;
+}
+
+static void libsais_benchmark_usage(void)
+{
+    fprintf(stderr,
+        "usage: libsais_benchmark [-r runs] [-t threads,...] [-v variant,...] <corpus directory or file>...\n"
+        "  -r runs        number of timed runs per phase, the minimum is reported (default 5)\n"
+        "  -t threads     comma-separated thread counts to sweep, 0 for OpenMP default (default 1%s)\n"
+        "  -v variant     comma-separated subset of libsais,libsais16,libsais64,libsais16x64 (default all)\n"
+        "Prints one CSV row per file, variant, thread count and phase (sa, bwt, unbwt, plcp, lcp) with the\n"
+        "minimum time in seconds, the throughput in MB/s of input and the peak memory in bytes, which is the\n"
+        "caller-provided arrays of the phase plus the peak of the library's context and internal allocations.\n",
+        LIBSAIS_BENCHMARK_OPENMP ? ",0" : "");
+}
+
+int main(int argc, char ** argv)
+{
+    int64_t threads[LIBSAIS_BENCHMARK_MAX_THREADS] = { 1, 0 };
+    int32_t thread_count = LIBSAIS_BENCHMARK_OPENMP ? 2 : 1, runs = 5;
+    int selected[sizeof(libsais_benchmark_variants) / sizeof(libsais_benchmark_variants[0])];
+    size_t variant_count = sizeof(libsais_benchmark_variants) / sizeof(libsais_benchmark_variants[0]), v;
+
+    char ** files = NULL; size_t file_count = 0, file_capacity = 0, f;
+    int argi, result = 0;
+
+    for (v = 0; v < variant_count; ++v) { selected[v] = 1; }
+
+    for (argi = 1; argi < argc && argv[argi][0] == '-'; ++argi)
+    {
+        if (argi + 1 >= argc || argv[argi][1] == 0 || argv[argi][2] != 0) { libsais_benchmark_usage(); return 1; }
+
+        const char * value = argv[++argi];
+        if (argv[argi - 1][1] == 'r')
+        {
+            runs = (int32_t)strtol(value, NULL, 10);
+            if (runs < 1) { libsais_benchmark_usage(); return 1; }
+        }
+        else if (argv[argi - 1][1] == 't')
+        {
+            for (thread_count = 0; *value != 0 && thread_count < LIBSAIS_BENCHMARK_MAX_THREADS; )
+            {
+                char * end; long t = strtol(value, &end, 10);
+                if (end == value || t < 0 || (!LIBSAIS_BENCHMARK_OPENMP && t != 1))
+                {
+                    fprintf(stderr, "libsais_benchmark: invalid thread count in '%s'%s\n", argv[argi], LIBSAIS_BENCHMARK_OPENMP ? "" : " (only 1 without OpenMP)");
+                    return 1;
+                }
+
+                threads[thread_count++] = (int64_t)t; value = *end == ',' ? end + 1 : end;
+            }
+
+            if (thread_count == 0) { libsais_benchmark_usage(); return 1; }
+        }
+        else if (argv[argi - 1][1] == 'v')
+        {
+            for (v = 0; v < variant_count; ++v)
+            {
+                const char * name = libsais_benchmark_variants[v].name, * p = value;
+                size_t m = strlen(name);
+
+                for (selected[v] = 0; p != NULL && *p != 0; p = strchr(p, ','), p = p != NULL ? p + 1 : NULL)
+                {
+                    if (strncmp(p, name, m) == 0 && (p[m] == ',' || p[m] == 0)) { selected[v] = 1; }
+                }
+            }
+        }
+        else
+        {
+            libsais_benchmark_usage(); return 1;
+        }
+    }
+
+    if (argi == argc) { libsais_benchmark_usage(); return 1; }
+
+    for (; argi < argc; ++argi)
+    {
+        int r = libsais_benchmark_collect(argv[argi], &files, &file_count, &file_capacity);
+        if (r != 0) { fprintf(stderr, "libsais_benchmark: cannot read %s\n", argv[argi]); result = 1; }
+    }
+
+    printf("compiler,openmp,variant,phase,file,bytes,threads,runs,seconds,mb_per_second,peak_bytes\n");
+
+    for (f = 0; f < file_count; ++f)
+    {
+        size_t size = 0;
+        uint8_t * T = libsais_benchmark_read(files[f], &size);
+
+        if (T == NULL) { fprintf(stderr, "libsais_benchmark: cannot read %s\n", files[f]); result = 1; }
+        else
+        {
+            for (v = 0; v < variant_count; ++v)
+            {
+                int32_t t;
+
+                for (t = 0; t < thread_count && selected[v]; ++t)
+                {
+                    if (libsais_benchmark_file(files[f], T, size, &libsais_benchmark_variants[v], threads[t], runs) != 0) { result = 1; }
+                }
+            }
+
+            free(T);
+        }
+
+        free(files[f]);
+    }
+
+    free(files);
+
+    return result;
+}
@@ -29,6 +29,32 @@ Please see the file LICENSE for full copyright information.
 #define LIBSAIS64_VERSION_PATCH   6
 #define LIBSAIS64_VERSION_STRING  "2.8.6"
 
+#define LIBSAIS64_FLAGS_NONE     0
+#define LIBSAIS64_FLAGS_CTX      1
+#define LIBSAIS64_FLAGS_BUFFER   2
+
+#define LIBSAIS64_PHASE_LEVEL          0
+#define LIBSAIS64_PHASE_GATHER         1
+#define LIBSAIS64_PHASE_RADIX_SORT     2
+#define LIBSAIS64_PHASE_PARTIAL_SORT   3
+#define LIBSAIS64_PHASE_RENUMBER       4
+#define LIBSAIS64_PHASE_RECONSTRUCT    5
+#define LIBSAIS64_PHASE_FINAL_SORT     6
+
+#define LIBSAIS64_PROFILE_NONE         0
+#define LIBSAIS64_PROFILE_6K           1
+#define LIBSAIS64_PROFILE_4K           2
+#define LIBSAIS64_PROFILE_2K           4
+#define LIBSAIS64_PROFILE_1K           8
+#define LIBSAIS64_PROFILE_LOCAL_BUFFER 16
+#define LIBSAIS64_PROFILE_FREE_SPACE   32
+#define LIBSAIS64_PROFILE_ALLOCATION   64
+#define LIBSAIS64_PROFILE_DELEGATED    128
+
+#define LIBSAIS64_NUMA_NONE            0
+#define LIBSAIS64_NUMA_BLOCK           1
+#define LIBSAIS64_NUMA_INTERLEAVE      2
+
 #ifdef _WIN32
     #ifdef LIBSAIS_SHARED
         #ifdef LIBSAIS_EXPORTS
@@ -47,8 +73,186 @@ Please see the file LICENSE for full copyright information.
 extern "C" {
 #endif
 
+    #include <stddef.h>
     #include <stdint.h>
 
+    /**
+    * Creates the libsais64 context that allows reusing allocated memory with each libsais64 operation. 
+    * In multi-threaded environments, use one context per thread for parallel executions.
+    * @return the libsais64 context, NULL otherwise.
+    */
+    LIBSAIS64_API void * libsais64_create_ctx(void);
+
+#if defined(LIBSAIS_OPENMP)
+    /**
+    * Creates the libsais64 context that allows reusing allocated memory with each parallel libsais64 operation using OpenMP. 
+    * In multi-threaded environments, use one context per thread for parallel executions.
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return the libsais64 context, NULL otherwise.
+    */
+    LIBSAIS64_API void * libsais64_create_ctx_omp(int64_t threads);
+#endif
+
+    /**
+    * Destroys the libsass context and free previusly allocated memory.
+    * @param ctx The libsais64 context (can be NULL).
+    */
+    LIBSAIS64_API void libsais64_free_ctx(void * ctx);
+
+    /**
+    * Creates the libsais64 context that routes all internal memory allocations through the given callbacks.
+    * In multi-threaded environments, use one context per thread for parallel executions.
+    * @param alloc_fn The callback that allocates size bytes aligned to alignment bytes (a power of 2), or returns NULL on failure.
+    * @param free_fn The callback that frees memory previously returned by alloc_fn.
+    * @param opaque The user pointer passed to alloc_fn and free_fn.
+    * @return the libsais64 context, NULL otherwise.
+    */
+    LIBSAIS64_API void * libsais64_create_ctx_alloc(void * (* alloc_fn)(size_t size, size_t alignment, void * opaque), void (* free_fn)(void * address, void * opaque), void * opaque);
+
+    /**
+    * Creates the libsais64 context that takes all of its memory from the caller provided buffer and never calls malloc.
+    * Operations on this context return -3 instead of allocating memory once the buffer is exhausted.
+    * The buffer must outlive the context, libsais64_free_ctx does not release it.
+    * @param buffer The caller provided buffer (its size can be queried with libsais64_scratch_size and LIBSAIS64_FLAGS_BUFFER).
+    * @param size The size of the buffer in bytes.
+    * @return the libsais64 context, NULL otherwise.
+    */
+    LIBSAIS64_API void * libsais64_create_ctx_buffer(void * buffer, size_t size);
+
+#if defined(LIBSAIS_OPENMP)
+    /**
+    * Creates the libsais64 context for parallel operations using OpenMP that routes all internal memory allocations through the given callbacks.
+    * In multi-threaded environments, use one context per thread for parallel executions.
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @param alloc_fn The callback that allocates size bytes aligned to alignment bytes (a power of 2), or returns NULL on failure.
+    * @param free_fn The callback that frees memory previously returned by alloc_fn.
+    * @param opaque The user pointer passed to alloc_fn and free_fn.
+    * @return the libsais64 context, NULL otherwise.
+    */
+    LIBSAIS64_API void * libsais64_create_ctx_alloc_omp(int64_t threads, void * (* alloc_fn)(size_t size, size_t alignment, void * opaque), void (* free_fn)(void * address, void * opaque), void * opaque);
+
+    /**
+    * Creates the libsais64 context for parallel operations using OpenMP that takes all of its memory from the caller provided buffer and never calls malloc.
+    * Operations on this context return -3 instead of allocating memory once the buffer is exhausted.
+    * The buffer must outlive the context, libsais64_free_ctx does not release it.
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @param buffer The caller provided buffer (its size can be queried with libsais64_scratch_size and LIBSAIS64_FLAGS_BUFFER).
+    * @param size The size of the buffer in bytes.
+    * @return the libsais64 context, NULL otherwise.
+    */
+    LIBSAIS64_API void * libsais64_create_ctx_buffer_omp(int64_t threads, void * buffer, size_t size);
+#endif
+
+    /**
+    * Returns the worst-case number of bytes requested from the allocator callbacks by libsais64_create_ctx_alloc[_omp]
+    * and a subsequent operation on that context, including alignment padding and the temporary buffers used when the free space is insufficient.
+    * @param n The length of the input.
+    * @param k The alphabet size of the input integer array (can be 0 for string inputs).
+    * @param threads The number of threads of the context (can be 0 for OpenMP default).
+    * @return The number of bytes if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_alloc_size(int64_t n, int64_t k, int64_t threads);
+
+    /**
+    * Returns the number of bytes of scratch memory needed to construct the suffix array or BWT of an input of length n with fs extra space at the end of SA.
+    * The size is an upper bound that does not depend on the content of the input. With context flags it also holds for any local buffer size
+    * (see libsais64_set_local_buffer_size), so it can exceed the memory actually used by a context with the default local buffer.
+    * @param n The length of the input.
+    * @param k The alphabet size of the input integer array (can be 0 for string inputs).
+    * @param fs Extra space available at the end of SA array.
+    * @param threads The number of threads (can be 0 for OpenMP default).
+    * @param flags LIBSAIS64_FLAGS_NONE for the memory allocated by a call without context, LIBSAIS64_FLAGS_CTX for the memory allocated by a call on an existing context,
+    *              LIBSAIS64_FLAGS_BUFFER for the size of the buffer passed to libsais64_create_ctx_buffer[_omp] (the context included).
+    * @return The number of bytes if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_scratch_size(int64_t n, int64_t k, int64_t fs, int64_t threads, int64_t flags);
+
+    /**
+    * Installs the callback that is invoked at the begin and the end of each construction phase of the operations on the libsais64 context
+    * (libsais64_ctx, libsais64_bwt_ctx and the other *_ctx functions), so that the caller can take timestamps and record the recursion.
+    * The callback is always invoked from the calling thread and outside of parallel regions, the operations without context are never profiled.
+    * Depth 0 is the input string and depth d + 1 is the reduced problem of the level at depth d; LIBSAIS64_PHASE_LEVEL spans the whole level
+    * (the nested levels included) and its begin event reports the length n and the alphabet size k of the level. The end event of
+    * LIBSAIS64_PHASE_RENUMBER reports the number of LMS suffixes and the number of their distinct names as n and k instead, that is
+    * the size and the alphabet of the reduced problem when the names are not unique. For the levels of the reduced problems, flags report
+    * the LIBSAIS64_PROFILE_6K/4K/2K/1K induced sorting variant and whether its buckets were placed in the free space at the end of SA
+    * (LIBSAIS64_PROFILE_FREE_SPACE), in the local stack buffer (LIBSAIS64_PROFILE_LOCAL_BUFFER) or in extra allocated memory (LIBSAIS64_PROFILE_ALLOCATION).
+    * Reduced problems that fit 32-bit indexes are reported as a level flagged with LIBSAIS64_PROFILE_DELEGATED, whose phases are then reported
+    * by the 32-bit implementation with depth counted from 0 again.
+    * @param ctx The libsais64 context.
+    * @param profile_fn The callback that receives the LIBSAIS64_PHASE_* phase, 0 for begin or 1 for end, the depth, n, k, flags and opaque (can be NULL to disable profiling).
+    * @param opaque The user pointer passed to profile_fn.
+    * @return 0 if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int32_t libsais64_set_profiler(void * ctx, void (* profile_fn)(int32_t phase, int32_t end, int32_t depth, int64_t n, int64_t k, int32_t flags, void * opaque), void * opaque);
+
+    /**
+    * Installs the callback that is polled by the suffix array and BWT constructions on the libsais64 context (libsais64_ctx, libsais64_bwt_ctx
+    * and the other *_ctx functions) to cancel a long running operation. The callback is invoked from the calling thread and outside of
+    * parallel regions at the begin of each recursion level, after each sorting phase and between the blocks of the parallel induced sorting scans,
+    * so it should be cheap, for example reading an atomic flag or comparing a monotonic clock against a deadline. Once it returns a nonzero value
+    * the operation stops at the next of these points and returns -5, leaving the content of the output arrays undefined.
+    * The callback is shared with the 32-bit context that handles the inputs and the reduced problems that fit 32-bit indexes.
+    * @param ctx The libsais64 context.
+    * @param cancel_fn The callback that receives opaque and returns nonzero to cancel the operation (can be NULL to disable cancellation).
+    * @param opaque The user pointer passed to cancel_fn.
+    * @return 0 if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int32_t libsais64_set_cancel(void * ctx, int32_t (* cancel_fn)(void * opaque), void * opaque);
+
+    /**
+    * Sets the NUMA first-touch placement hint of the libsais64 context for the suffix array and BWT constructions (libsais64_ctx, libsais64_bwt_ctx
+    * and the other *_ctx functions). Before the construction starts, the context threads write the first byte of each page of the suffix
+    * array so that the first-touch policy of the operating system allocates it on their node: LIBSAIS64_NUMA_BLOCK lets each OpenMP thread
+    * touch the pages of the block that it scans in the parallel phases of the top level, LIBSAIS64_NUMA_INTERLEAVE touches the pages
+    * round-robin across the threads, and the per-thread buckets and caches of the context are touched by their owning threads.
+    * This is a placement hint rather than a NUMA-aware layout: pages that are already resident (for example a reused output buffer)
+    * stay where they are, as no pages are migrated with mbind or move_pages, so the reduced problems of the recursion levels reuse the
+    * pages of the top level with their own block boundaries. The input string and the functions without a context are not placed.
+    * Thread t works on block t in every top-level phase, so the threads should be bound to places (for example OMP_PROC_BIND=spread
+    * and OMP_PLACES=cores). While a mode other than LIBSAIS64_NUMA_NONE is set, the adaptive thread selection of libsais64_set_adaptive_threads is disabled.
+    * The mode is shared with the 32-bit context that handles the inputs that fit 32-bit indexes; the suffix array is placed in its
+    * final 64-bit layout before such an input is delegated, so the output blocks match the 64-bit block split of the context.
+    * @param ctx The libsais64 context.
+    * @param mode The placement mode (LIBSAIS64_NUMA_NONE, LIBSAIS64_NUMA_BLOCK or LIBSAIS64_NUMA_INTERLEAVE).
+    * @return 0 if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int32_t libsais64_set_numa(void * ctx, int32_t mode);
+
+    /**
+    * Sets the per-thread cache size of the libsais context, in entries (default 24576), used to block the parallel induced sorting scans.
+    * The size is not derived from the CPU; it is a manual setting, like the build-time prefetch distance of the scans.
+    * The caches of a multi-threaded context are reallocated through its allocator; libsais64_alloc_size and libsais64_scratch_size assume the default size.
+    * @param ctx The libsais context.
+    * @param size The number of cache entries per thread (at least 1024, more than 32 times the number of threads and at most INT32_MAX).
+    * @return 0 if no error occurred, -1 or -2 otherwise (-3 if the caller provided buffer of the context is exhausted).
+    */
+    LIBSAIS64_API int32_t libsais64_set_cache_size(void * ctx, int64_t size);
+
+    /**
+    * Sets the local buffer size of the libsais context, in suffix array entries (default 1024). Single-threaded recursion levels with a
+    * small alphabet and little free space keep their buckets in this buffer instead of allocating them. Sizes above the default are
+    * allocated through the context allocator once, when set, and are not included in libsais64_alloc_size and libsais64_scratch_size.
+    * @param ctx The libsais context.
+    * @param size The number of local buffer entries (can be 0 to always allocate, at most INT32_MAX).
+    * @return 0 if no error occurred, -1 or -2 otherwise (-3 if the caller provided buffer of the context is exhausted).
+    */
+    LIBSAIS64_API int32_t libsais64_set_local_buffer_size(void * ctx, int64_t size);
+
+    /**
+    * Enables adaptive thread selection for the suffix array and BWT constructions on the libsais context (libsais64_ctx, libsais64_bwt_ctx
+    * and the other *_ctx functions). Each recursion level then runs on at most n / block_size of the context threads, and its radix sort
+    * of the LMS suffixes on at most m / block_size threads (the first level either keeps all of its threads or runs it single-threaded),
+    * where the block size is raised to 16 times the alphabet size of the level when that is larger. Levels left with a single thread
+    * use the local buffer like a single-threaded context. The crossover point depends on the machine, so adaptation is disabled until
+    * a block size is set, and it is ignored while a NUMA placement mode other than LIBSAIS64_NUMA_NONE is set, as the placement assumes
+    * that every thread of the context works on its own block.
+    * @param ctx The libsais context.
+    * @param block_size The minimum number of suffix array entries per thread (0 to disable adaptive thread selection).
+    * @return 0 if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int32_t libsais64_set_adaptive_threads(void * ctx, int64_t block_size);
+
     /**
     * Constructs the suffix array of a given string.
     * @param T [0..n-1] The input string.
@@ -63,6 +267,7 @@ extern "C" {
     /**
     * Constructs the suffix array of a given integer array.
     * Note, during construction input array will be modified, but restored at the end if no errors occurred.
+    * Note, when fs is less than 6k, sparsely used alphabets are automatically remapped to a dense alphabet of size (number of distinct symbols).
     * @param T [0..n-1] The input integer array.
     * @param SA [0..n-1+fs] The output array of suffixes.
     * @param n The length of the integer array.
@@ -72,6 +277,59 @@ extern "C" {
     */
     LIBSAIS64_API int64_t libsais64_long(int64_t * T, int64_t * SA, int64_t n, int64_t k, int64_t fs);
 
+    /**
+    * Constructs the suffix array of a given string using libsais64 context.
+    * @param ctx The libsais64 context.
+    * @param T [0..n-1] The input string.
+    * @param SA [0..n-1+fs] The output array of suffixes.
+    * @param n The length of the given string.
+    * @param fs The extra space available at the end of SA array (0 should be enough for most cases).
+    * @param freq [0..255] The output symbol frequency table (can be NULL).
+    * @return 0 if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_ctx(const void * ctx, const uint8_t * T, int64_t * SA, int64_t n, int64_t fs, int64_t * freq);
+
+    /**
+    * Constructs the suffix array of a given integer array using libsais64 context.
+    * Note, during construction input array will be modified, but restored at the end if no errors occurred.
+    * Note, when fs is less than 6k, sparsely used alphabets are automatically remapped to a dense alphabet of size (number of distinct symbols).
+    * @param ctx The libsais64 context.
+    * @param T [0..n-1] The input integer array.
+    * @param SA [0..n-1+fs] The output array of suffixes.
+    * @param n The length of the integer array.
+    * @param k The alphabet size of the input integer array.
+    * @param fs Extra space available at the end of SA array (can be 0, but 4k or better 6k is recommended for optimal performance).
+    * @return 0 if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_long_ctx(const void * ctx, int64_t * T, int64_t * SA, int64_t n, int64_t k, int64_t fs);
+
+    /**
+    * Constructs the generalized suffix array (GSA) of a given string set.
+    * The strings are concatenated and each one is terminated by a 0 symbol, which acts as a unique separator
+    * ordered before any other symbol and before every separator that occurs later in the string set.
+    * There is no GSA counterpart of the bwt and bwt_aux functions, as the BWT of a string set has no primary index and can not be
+    * inverted by unbwt; when needed it follows from the GSA in one pass as U[i] = T[SA[i] - 1], or T[n - 1] when SA[i] is 0.
+    * @param T [0..n-1] The input string set using 0 as separators (T[n-1] must be 0).
+    * @param SA [0..n-1+fs] The output array of suffixes.
+    * @param n The length of the given string set.
+    * @param fs The extra space available at the end of SA array (0 should be enough for most cases).
+    * @param freq [0..255] The output symbol frequency table (can be NULL).
+    * @return 0 if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_gsa(const uint8_t * T, int64_t * SA, int64_t n, int64_t fs, int64_t * freq);
+
+    /**
+    * Constructs the generalized suffix array (GSA) of a given string set using libsais64 context.
+    * @param ctx The libsais64 context.
+    * @param T [0..n-1] The input string set using 0 as separators (T[n-1] must be 0).
+    * @param SA [0..n-1+fs] The output array of suffixes.
+    * @param n The length of the given string set.
+    * @param fs The extra space available at the end of SA array (0 should be enough for most cases).
+    * @param freq [0..255] The output symbol frequency table (can be NULL).
+    * @return 0 if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_gsa_ctx(const void * ctx, const uint8_t * T, int64_t * SA, int64_t n, int64_t fs, int64_t * freq);
+
 #if defined(LIBSAIS_OPENMP)
     /**
     * Constructs the suffix array of a given string in parallel using OpenMP.
@@ -88,6 +346,7 @@ extern "C" {
     /**
     * Constructs the suffix array of a given integer array in parallel using OpenMP.
     * Note, during construction input array will be modified, but restored at the end if no errors occurred.
+    * Note, when fs is less than 6k, sparsely used alphabets are automatically remapped to a dense alphabet of size (number of distinct symbols).
     * @param T [0..n-1] The input integer array.
     * @param SA [0..n-1+fs] The output array of suffixes.
     * @param n The length of the integer array.
@@ -97,6 +356,18 @@ extern "C" {
     * @return 0 if no error occurred, -1 or -2 otherwise.
     */
     LIBSAIS64_API int64_t libsais64_long_omp(int64_t * T, int64_t * SA, int64_t n, int64_t k, int64_t fs, int64_t threads);
+
+    /**
+    * Constructs the generalized suffix array (GSA) of a given string set in parallel using OpenMP.
+    * @param T [0..n-1] The input string set using 0 as separators (T[n-1] must be 0).
+    * @param SA [0..n-1+fs] The output array of suffixes.
+    * @param n The length of the given string set.
+    * @param fs The extra space available at the end of SA array (0 should be enough for most cases).
+    * @param freq [0..255] The output symbol frequency table (can be NULL).
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return 0 if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_gsa_omp(const uint8_t * T, int64_t * SA, int64_t n, int64_t fs, int64_t * freq, int64_t threads);
 #endif
 
     /**
@@ -125,22 +396,37 @@ extern "C" {
     */
     LIBSAIS64_API int64_t libsais64_bwt_aux(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t r, int64_t * I);
 
-#if defined(LIBSAIS_OPENMP)
     /**
-    * Constructs the burrows-wheeler transformed string (BWT) of a given string in parallel using OpenMP.
+    * Constructs the burrows-wheeler transformed string (BWT) of a given string with auxiliary indexes and suffix array samples.
+    * @param T [0..n-1] The input string.
+    * @param U [0..n-1] The output string (can be T).
+    * @param A [0..n-1+fs] The temporary array.
+    * @param n The length of the given string.
+    * @param fs The extra space available at the end of A array (0 should be enough for most cases).
+    * @param freq [0..255] The output symbol frequency table (can be NULL).
+    * @param r The sampling rate for auxiliary indexes (must be power of 2).
+    * @param I [0..(n-1)/r] The output auxiliary indexes.
+    * @param S [0..(n-1)/r] The output suffix array samples, S[j] is the suffix at rank j*r.
+    * @return 0 if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_bwt_aux_sa(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t r, int64_t * I, int64_t * S);
+
+    /**
+    * Constructs the burrows-wheeler transformed string (BWT) of a given string using libsais64 context.
+    * @param ctx The libsais64 context.
     * @param T [0..n-1] The input string.
     * @param U [0..n-1] The output string (can be T).
     * @param A [0..n-1+fs] The temporary array.
     * @param n The length of the given string.
     * @param fs The extra space available at the end of A array (0 should be enough for most cases).
     * @param freq [0..255] The output symbol frequency table (can be NULL).
-    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
     * @return The primary index if no error occurred, -1 or -2 otherwise.
     */
-    LIBSAIS64_API int64_t libsais64_bwt_omp(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t threads);
+    LIBSAIS64_API int64_t libsais64_bwt_ctx(const void * ctx, const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq);
 
     /**
-    * Constructs the burrows-wheeler transformed string (BWT) of a given string with auxiliary indexes in parallel using OpenMP.
+    * Constructs the burrows-wheeler transformed string (BWT) of a given string with auxiliary indexes using libsais64 context.
+    * @param ctx The libsais64 context.
     * @param T [0..n-1] The input string.
     * @param U [0..n-1] The output string (can be T).
     * @param A [0..n-1+fs] The temporary array.
@@ -149,108 +435,939 @@ extern "C" {
     * @param freq [0..255] The output symbol frequency table (can be NULL).
     * @param r The sampling rate for auxiliary indexes (must be power of 2).
     * @param I [0..(n-1)/r] The output auxiliary indexes.
-    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
     * @return 0 if no error occurred, -1 or -2 otherwise.
     */
-    LIBSAIS64_API int64_t libsais64_bwt_aux_omp(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t r, int64_t * I, int64_t threads);
-#endif
+    LIBSAIS64_API int64_t libsais64_bwt_aux_ctx(const void * ctx, const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t r, int64_t * I);
 
     /**
-    * Constructs the original string from a given burrows-wheeler transformed string (BWT) with primary index.
+    * Constructs the burrows-wheeler transformed string (BWT) of a given string with auxiliary indexes and suffix array samples using libsais64 context.
+    * @param ctx The libsais64 context.
     * @param T [0..n-1] The input string.
     * @param U [0..n-1] The output string (can be T).
-    * @param A [0..n] The temporary array (NOTE, temporary array must be n + 1 size).
+    * @param A [0..n-1+fs] The temporary array.
     * @param n The length of the given string.
-    * @param freq [0..255] The input symbol frequency table (can be NULL).
-    * @param i The primary index.
+    * @param fs The extra space available at the end of A array (0 should be enough for most cases).
+    * @param freq [0..255] The output symbol frequency table (can be NULL).
+    * @param r The sampling rate for auxiliary indexes (must be power of 2).
+    * @param I [0..(n-1)/r] The output auxiliary indexes.
+    * @param S [0..(n-1)/r] The output suffix array samples, S[j] is the suffix at rank j*r.
     * @return 0 if no error occurred, -1 or -2 otherwise.
     */
-    LIBSAIS64_API int64_t libsais64_unbwt(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t i);
+    LIBSAIS64_API int64_t libsais64_bwt_aux_sa_ctx(const void * ctx, const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t r, int64_t * I, int64_t * S);
 
     /**
-    * Constructs the original string from a given burrows-wheeler transformed string (BWT) with auxiliary indexes.
+    * Constructs the run-length encoded burrows-wheeler transformed string (BWT) of a given string.
     * @param T [0..n-1] The input string.
-    * @param U [0..n-1] The output string (can be T).
-    * @param A [0..n] The temporary array (NOTE, temporary array must be n + 1 size).
+    * @param C [0..rs-1] The output run symbols.
+    * @param L [0..rs-1] The output run lengths.
+    * @param A [0..n-1+fs] The temporary array.
     * @param n The length of the given string.
-    * @param freq [0..255] The input symbol frequency table (can be NULL).
-    * @param r The sampling rate for auxiliary indexes (must be power of 2).
-    * @param I [0..(n-1)/r] The input auxiliary indexes.
+    * @param fs The extra space available at the end of A array (0 should be enough for most cases).
+    * @param freq [0..255] The output symbol frequency table (can be NULL).
+    * @param rs The capacity of the C and L arrays in runs.
+    * @param runs The output number of runs. If it exceeds rs, C and L are left unspecified and A keeps the BWT, so the runs can be
+    *             extracted into larger arrays with libsais64_rlbwt_encode and the returned primary index without constructing the BWT again.
+    * @return The primary index if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_rlbwt(const uint8_t * T, uint8_t * C, int64_t * L, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t rs, int64_t * runs);
+
+    /**
+    * Extracts the run-length encoded BWT from the temporary array left by libsais64_rlbwt.
+    * @param A [0..n-1] The temporary array returned by libsais64_rlbwt.
+    * @param C [0..rs-1] The output run symbols.
+    * @param L [0..rs-1] The output run lengths.
+    * @param n The length of the original string.
+    * @param i The primary index returned by libsais64_rlbwt.
+    * @param rs The capacity of the C and L arrays in runs.
+    * @param runs The output number of runs (C and L are left unspecified if it exceeds rs).
     * @return 0 if no error occurred, -1 or -2 otherwise.
     */
-    LIBSAIS64_API int64_t libsais64_unbwt_aux(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t r, const int64_t * I);
+    LIBSAIS64_API int64_t libsais64_rlbwt_encode(const int64_t * A, uint8_t * C, int64_t * L, int64_t n, int64_t i, int64_t rs, int64_t * runs);
 
 #if defined(LIBSAIS_OPENMP)
     /**
-    * Constructs the original string from a given burrows-wheeler transformed string (BWT) with primary index in parallel using OpenMP.
+    * Constructs the burrows-wheeler transformed string (BWT) of a given string in parallel using OpenMP.
     * @param T [0..n-1] The input string.
     * @param U [0..n-1] The output string (can be T).
-    * @param A [0..n] The temporary array (NOTE, temporary array must be n + 1 size).
+    * @param A [0..n-1+fs] The temporary array.
     * @param n The length of the given string.
-    * @param freq [0..255] The input symbol frequency table (can be NULL).
-    * @param i The primary index.
+    * @param fs The extra space available at the end of A array (0 should be enough for most cases).
+    * @param freq [0..255] The output symbol frequency table (can be NULL).
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return The primary index if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_bwt_omp(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t threads);
+
+    /**
+    * Constructs the burrows-wheeler transformed string (BWT) of a given string with auxiliary indexes in parallel using OpenMP.
+    * @param T [0..n-1] The input string.
+    * @param U [0..n-1] The output string (can be T).
+    * @param A [0..n-1+fs] The temporary array.
+    * @param n The length of the given string.
+    * @param fs The extra space available at the end of A array (0 should be enough for most cases).
+    * @param freq [0..255] The output symbol frequency table (can be NULL).
+    * @param r The sampling rate for auxiliary indexes (must be power of 2).
+    * @param I [0..(n-1)/r] The output auxiliary indexes.
     * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
     * @return 0 if no error occurred, -1 or -2 otherwise.
     */
-    LIBSAIS64_API int64_t libsais64_unbwt_omp(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t i, int64_t threads);
+    LIBSAIS64_API int64_t libsais64_bwt_aux_omp(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t r, int64_t * I, int64_t threads);
 
     /**
-    * Constructs the original string from a given burrows-wheeler transformed string (BWT) with auxiliary indexes in parallel using OpenMP.
+    * Constructs the burrows-wheeler transformed string (BWT) of a given string with auxiliary indexes and suffix array samples in parallel using OpenMP.
     * @param T [0..n-1] The input string.
     * @param U [0..n-1] The output string (can be T).
-    * @param A [0..n] The temporary array (NOTE, temporary array must be n + 1 size).
+    * @param A [0..n-1+fs] The temporary array.
     * @param n The length of the given string.
-    * @param freq [0..255] The input symbol frequency table (can be NULL).
+    * @param fs The extra space available at the end of A array (0 should be enough for most cases).
+    * @param freq [0..255] The output symbol frequency table (can be NULL).
     * @param r The sampling rate for auxiliary indexes (must be power of 2).
-    * @param I [0..(n-1)/r] The input auxiliary indexes.
+    * @param I [0..(n-1)/r] The output auxiliary indexes.
+    * @param S [0..(n-1)/r] The output suffix array samples, S[j] is the suffix at rank j*r.
     * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
     * @return 0 if no error occurred, -1 or -2 otherwise.
     */
-    LIBSAIS64_API int64_t libsais64_unbwt_aux_omp(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t r, const int64_t * I, int64_t threads);
+    LIBSAIS64_API int64_t libsais64_bwt_aux_sa_omp(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t r, int64_t * I, int64_t * S, int64_t threads);
+
+    /**
+    * Constructs the run-length encoded burrows-wheeler transformed string (BWT) of a given string in parallel using OpenMP.
+    * @param T [0..n-1] The input string.
+    * @param C [0..rs-1] The output run symbols.
+    * @param L [0..rs-1] The output run lengths.
+    * @param A [0..n-1+fs] The temporary array.
+    * @param n The length of the given string.
+    * @param fs The extra space available at the end of A array (0 should be enough for most cases).
+    * @param freq [0..255] The output symbol frequency table (can be NULL).
+    * @param rs The capacity of the C and L arrays in runs.
+    * @param runs The output number of runs. If it exceeds rs, C and L are left unspecified and A keeps the BWT, so the runs can be
+    *             extracted into larger arrays with libsais64_rlbwt_encode and the returned primary index without constructing the BWT again.
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return The primary index if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_rlbwt_omp(const uint8_t * T, uint8_t * C, int64_t * L, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t rs, int64_t * runs, int64_t threads);
+
+    /**
+    * Extracts the run-length encoded BWT from the temporary array left by libsais64_rlbwt_omp in parallel using OpenMP.
+    * @param A [0..n-1] The temporary array returned by libsais64_rlbwt_omp.
+    * @param C [0..rs-1] The output run symbols.
+    * @param L [0..rs-1] The output run lengths.
+    * @param n The length of the original string.
+    * @param i The primary index returned by libsais64_rlbwt_omp.
+    * @param rs The capacity of the C and L arrays in runs.
+    * @param runs The output number of runs (C and L are left unspecified if it exceeds rs).
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return 0 if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_rlbwt_encode_omp(const int64_t * A, uint8_t * C, int64_t * L, int64_t n, int64_t i, int64_t rs, int64_t * runs, int64_t threads);
 #endif
 
     /**
-    * Constructs the permuted longest common prefix array (PLCP) of a given string and a suffix array.
+    * Constructs the suffix arrays (SA) of a batch of independent strings, reusing the allocated memory between them.
+    * @param T [0..count-1] The input strings.
+    * @param SA [0..count-1] The output arrays of suffixes (each SA[i] is [0..n[i]-1+fs[i]]).
+    * @param n [0..count-1] The lengths of the given strings.
+    * @param fs [0..count-1] The extra space available at the end of each SA array (can be NULL for no extra space).
+    * @param freq [0..count-1] The output symbol frequency tables, each [0..255] (can be NULL, or contain NULL entries).
+    * @param result [0..count-1] The output per-string return codes of libsais64().
+    * @param count The number of strings in the batch.
+    * @return 0 if no error occurred, -1 or -2 otherwise (the first failing return code).
+    */
+    LIBSAIS64_API int64_t libsais64_batch(const uint8_t * const * T, int64_t * const * SA, const int64_t * n, const int64_t * fs, int64_t * const * freq, int64_t * result, int64_t count);
+
+    /**
+    * Constructs the burrows-wheeler transformed strings (BWT) of a batch of independent strings, reusing the allocated memory between them.
+    * @param T [0..count-1] The input strings.
+    * @param U [0..count-1] The output strings (each U[i] can be T[i]).
+    * @param A [0..count-1] The temporary arrays (each A[i] is [0..n[i]-1+fs[i]]).
+    * @param n [0..count-1] The lengths of the given strings.
+    * @param fs [0..count-1] The extra space available at the end of each A array (can be NULL for no extra space).
+    * @param freq [0..count-1] The output symbol frequency tables, each [0..255] (can be NULL, or contain NULL entries).
+    * @param result [0..count-1] The output per-string primary indexes, or return codes of libsais64_bwt() on error.
+    * @param count The number of strings in the batch.
+    * @return 0 if no error occurred, -1 or -2 otherwise (the first failing return code).
+    */
+    LIBSAIS64_API int64_t libsais64_bwt_batch(const uint8_t * const * T, uint8_t * const * U, int64_t * const * A, const int64_t * n, const int64_t * fs, int64_t * const * freq, int64_t * result, int64_t count);
+
+#if defined(LIBSAIS_OPENMP)
+    /**
+    * Constructs the suffix arrays (SA) of a batch of independent strings in parallel using OpenMP.
+    * Each thread sorts whole strings on its own, reusing the allocated memory between them.
+    * @param T [0..count-1] The input strings.
+    * @param SA [0..count-1] The output arrays of suffixes (each SA[i] is [0..n[i]-1+fs[i]]).
+    * @param n [0..count-1] The lengths of the given strings.
+    * @param fs [0..count-1] The extra space available at the end of each SA array (can be NULL for no extra space).
+    * @param freq [0..count-1] The output symbol frequency tables, each [0..255] (can be NULL, or contain NULL entries).
+    * @param result [0..count-1] The output per-string return codes of libsais64().
+    * @param count The number of strings in the batch.
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return 0 if no error occurred, -1 or -2 otherwise (the first failing return code).
+    */
+    LIBSAIS64_API int64_t libsais64_batch_omp(const uint8_t * const * T, int64_t * const * SA, const int64_t * n, const int64_t * fs, int64_t * const * freq, int64_t * result, int64_t count, int64_t threads);
+
+    /**
+    * Constructs the burrows-wheeler transformed strings (BWT) of a batch of independent strings in parallel using OpenMP.
+    * Each thread transforms whole strings on its own, reusing the allocated memory between them.
+    * @param T [0..count-1] The input strings.
+    * @param U [0..count-1] The output strings (each U[i] can be T[i]).
+    * @param A [0..count-1] The temporary arrays (each A[i] is [0..n[i]-1+fs[i]]).
+    * @param n [0..count-1] The lengths of the given strings.
+    * @param fs [0..count-1] The extra space available at the end of each A array (can be NULL for no extra space).
+    * @param freq [0..count-1] The output symbol frequency tables, each [0..255] (can be NULL, or contain NULL entries).
+    * @param result [0..count-1] The output per-string primary indexes, or return codes of libsais64_bwt() on error.
+    * @param count The number of strings in the batch.
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return 0 if no error occurred, -1 or -2 otherwise (the first failing return code).
+    */
+    LIBSAIS64_API int64_t libsais64_bwt_batch_omp(const uint8_t * const * T, uint8_t * const * U, int64_t * const * A, const int64_t * n, const int64_t * fs, int64_t * const * freq, int64_t * result, int64_t count, int64_t threads);
+#endif
+
+    /**
+    * Returns the smallest memory budget accepted by libsais64_stream and libsais64_bwt_stream for a string of the given length.
+    * Large strings need well below n bytes, while the difference cover sample has a fixed overhead that makes short strings
+    * (up to a few thousand symbols) need more, though never more than the 8n bytes to sort them in memory.
+    * @param n The length of the string.
+    * @return The minimum budget in bytes if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_stream_min_budget(int64_t n);
+
+    /**
+    * Constructs the suffix array (SA) of a given string within a memory budget, streaming it in order to a caller provided sink.
+    * When the budget does not fit the whole suffix array, suffixes are sorted blockwise using a difference cover sample, so only
+    * the budget (plus the input string, which can be memory mapped) has to reside in memory.
     * @param T [0..n-1] The input string.
-    * @param SA [0..n-1] The input suffix array.
-    * @param PLCP [0..n-1] The output permuted longest common prefix array.
-    * @param n The length of the string and the suffix array.
-    * @return 0 if no error occurred, -1 otherwise.
+    * @param n The length of the given string.
+    * @param budget The memory budget in bytes for the working arrays (at least libsais64_stream_min_budget(n) bytes, or 8n bytes to sort in memory).
+    * @param write_fn The sink receiving consecutive ranges of the suffix array (returns 0 on success).
+    * @param opaque The user data passed to write_fn.
+    * @return 0 if no error occurred, -1, -2, -3 (budget is too small) or -4 (write_fn failed) otherwise.
     */
-    LIBSAIS64_API int64_t libsais64_plcp(const uint8_t * T, const int64_t * SA, int64_t * PLCP, int64_t n);
+    LIBSAIS64_API int64_t libsais64_stream(const uint8_t * T, int64_t n, int64_t budget, int32_t (* write_fn)(const int64_t * SA, int64_t count, void * opaque), void * opaque);
 
     /**
-    * Constructs the longest common prefix array (LCP) of a given permuted longest common prefix array (PLCP) and a suffix array.
-    * @param PLCP [0..n-1] The input permuted longest common prefix array.
-    * @param SA [0..n-1] The input suffix array.
-    * @param LCP [0..n-1] The output longest common prefix array (can be SA).
-    * @param n The length of the permuted longest common prefix array and the suffix array.
-    * @return 0 if no error occurred, -1 otherwise.
+    * Constructs the burrows-wheeler transformed string (BWT) of a given string within a memory budget, streaming it in order to a caller provided sink.
+    * @param T [0..n-1] The input string.
+    * @param n The length of the given string.
+    * @param budget The memory budget in bytes for the working arrays (at least libsais64_stream_min_budget(n) bytes, or 8n bytes to sort in memory).
+    * @param write_fn The sink receiving consecutive ranges of the burrows-wheeler transformed string (returns 0 on success).
+    * @param opaque The user data passed to write_fn.
+    * @return The primary index if no error occurred, -1, -2, -3 (budget is too small) or -4 (write_fn failed) otherwise.
     */
-    LIBSAIS64_API int64_t libsais64_lcp(const int64_t * PLCP, const int64_t * SA, int64_t * LCP, int64_t n);
+    LIBSAIS64_API int64_t libsais64_bwt_stream(const uint8_t * T, int64_t n, int64_t budget, int32_t (* write_fn)(const uint8_t * U, int64_t count, void * opaque), void * opaque);
+
+    /**
+    * Constructs the burrows-wheeler transformed string (BWT) of a given string within a memory budget instead of an n-word temporary array.
+    * Strings up to 2^31-1 symbols are transformed in memory when 4n bytes fit the budget, larger strings or smaller
+    * budgets fall back to the blockwise construction of libsais64_bwt_stream (peak memory is around 2n bytes plus the budget).
+    * @param T [0..n-1] The input string.
+    * @param U [0..n-1] The output string (can not be T).
+    * @param n The length of the given string.
+    * @param budget The memory budget in bytes for the working arrays (at least libsais64_stream_min_budget(n) bytes, or 4n bytes for strings up to 2^31-1 symbols).
+    * @param freq [0..255] The output symbol frequency table (can be NULL).
+    * @return The primary index if no error occurred, -1, -2 or -3 (budget is too small) otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_bwt_lowmem(const uint8_t * T, uint8_t * U, int64_t n, int64_t budget, int64_t * freq);
 
 #if defined(LIBSAIS_OPENMP)
     /**
-    * Constructs the permuted longest common prefix array (PLCP) of a given string and a suffix array in parallel using OpenMP.
+    * Constructs the suffix array (SA) of a given string within a memory budget, streaming it in order to a caller provided sink, using OpenMP for the in-memory sorting steps.
     * @param T [0..n-1] The input string.
-    * @param SA [0..n-1] The input suffix array.
-    * @param PLCP [0..n-1] The output permuted longest common prefix array.
-    * @param n The length of the string and the suffix array.
+    * @param n The length of the given string.
+    * @param budget The memory budget in bytes for the working arrays (at least libsais64_stream_min_budget(n) bytes, or 8n bytes to sort in memory).
+    * @param write_fn The sink receiving consecutive ranges of the suffix array (returns 0 on success).
+    * @param opaque The user data passed to write_fn.
     * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
-    * @return 0 if no error occurred, -1 otherwise.
+    * @return 0 if no error occurred, -1, -2, -3 (budget is too small) or -4 (write_fn failed) otherwise.
     */
-    LIBSAIS64_API int64_t libsais64_plcp_omp(const uint8_t * T, const int64_t * SA, int64_t * PLCP, int64_t n, int64_t threads);
+    LIBSAIS64_API int64_t libsais64_stream_omp(const uint8_t * T, int64_t n, int64_t budget, int32_t (* write_fn)(const int64_t * SA, int64_t count, void * opaque), void * opaque, int64_t threads);
 
     /**
-    * Constructs the longest common prefix array (LCP) of a given permuted longest common prefix array (PLCP) and a suffix array in parallel using OpenMP.
-    * @param PLCP [0..n-1] The input permuted longest common prefix array.
-    * @param SA [0..n-1] The input suffix array.
-    * @param LCP [0..n-1] The output longest common prefix array (can be SA).
-    * @param n The length of the permuted longest common prefix array and the suffix array.
+    * Constructs the burrows-wheeler transformed string (BWT) of a given string within a memory budget, streaming it in order to a caller provided sink, using OpenMP for the in-memory sorting steps.
+    * @param T [0..n-1] The input string.
+    * @param n The length of the given string.
+    * @param budget The memory budget in bytes for the working arrays (at least libsais64_stream_min_budget(n) bytes, or 8n bytes to sort in memory).
+    * @param write_fn The sink receiving consecutive ranges of the burrows-wheeler transformed string (returns 0 on success).
+    * @param opaque The user data passed to write_fn.
     * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
-    * @return 0 if no error occurred, -1 otherwise.
+    * @return The primary index if no error occurred, -1, -2, -3 (budget is too small) or -4 (write_fn failed) otherwise.
     */
-    LIBSAIS64_API int64_t libsais64_lcp_omp(const int64_t * PLCP, const int64_t * SA, int64_t * LCP, int64_t n, int64_t threads);
+    LIBSAIS64_API int64_t libsais64_bwt_stream_omp(const uint8_t * T, int64_t n, int64_t budget, int32_t (* write_fn)(const uint8_t * U, int64_t count, void * opaque), void * opaque, int64_t threads);
+
+    /**
+    * Constructs the burrows-wheeler transformed string (BWT) of a given string within a memory budget instead of an n-word temporary array in parallel using OpenMP.
+    * @param T [0..n-1] The input string.
+    * @param U [0..n-1] The output string (can not be T).
+    * @param n The length of the given string.
+    * @param budget The memory budget in bytes for the working arrays (at least libsais64_stream_min_budget(n) bytes, or 4n bytes for strings up to 2^31-1 symbols).
+    * @param freq [0..255] The output symbol frequency table (can be NULL).
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return The primary index if no error occurred, -1, -2 or -3 (budget is too small) otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_bwt_lowmem_omp(const uint8_t * T, uint8_t * U, int64_t n, int64_t budget, int64_t * freq, int64_t threads);
+#endif
+
+    /**
+    * Creates the libsais64 reverse BWT context that allows reusing allocated memory with each libsais64_unbwt_* operation. 
+    * In multi-threaded environments, use one context per thread for parallel executions.
+    * @return the libsais64 context, NULL otherwise.
+    */
+    LIBSAIS64_API void * libsais64_unbwt_create_ctx(void);
+
+#if defined(LIBSAIS_OPENMP)
+    /**
+    * Creates the libsais64 reverse BWT context that allows reusing allocated memory with each parallel libsais64_unbwt_* operation using OpenMP. 
+    * In multi-threaded environments, use one context per thread for parallel executions.
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return the libsais64 context, NULL otherwise.
+    */
+    LIBSAIS64_API void * libsais64_unbwt_create_ctx_omp(int64_t threads);
+#endif
+
+    /**
+    * Destroys the libsass reverse BWT context and free previusly allocated memory.
+    * @param ctx The libsais64 context (can be NULL).
+    */
+    LIBSAIS64_API void libsais64_unbwt_free_ctx(void * ctx);
+
+    /**
+    * Sets the size of the reverse BWT lookup table of the libsais reverse BWT context to 2^bits entries (default 2^17).
+    * Larger tables shorten the bucket search per decoded symbol but need more cache; the table is reallocated through the context allocator.
+    * Reverse BWT indexes (libsais64_unbwt_index_*) always use the default table size.
+    * @param ctx The libsais reverse BWT context.
+    * @param bits The base 2 logarithm of the table size (from 8 to 24).
+    * @return 0 if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int32_t libsais64_unbwt_set_fastbits(void * ctx, int32_t bits);
+
+    /**
+    * Creates the libsais64 reverse BWT context that routes all internal memory allocations through the given callbacks.
+    * In multi-threaded environments, use one context per thread for parallel executions.
+    * @param alloc_fn The callback that allocates size bytes aligned to alignment bytes (a power of 2), or returns NULL on failure.
+    * @param free_fn The callback that frees memory previously returned by alloc_fn.
+    * @param opaque The user pointer passed to alloc_fn and free_fn.
+    * @return the libsais64 context, NULL otherwise.
+    */
+    LIBSAIS64_API void * libsais64_unbwt_create_ctx_alloc(void * (* alloc_fn)(size_t size, size_t alignment, void * opaque), void (* free_fn)(void * address, void * opaque), void * opaque);
+
+#if defined(LIBSAIS_OPENMP)
+    /**
+    * Creates the libsais64 reverse BWT context for parallel operations using OpenMP that routes all internal memory allocations through the given callbacks.
+    * In multi-threaded environments, use one context per thread for parallel executions.
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @param alloc_fn The callback that allocates size bytes aligned to alignment bytes (a power of 2), or returns NULL on failure.
+    * @param free_fn The callback that frees memory previously returned by alloc_fn.
+    * @param opaque The user pointer passed to alloc_fn and free_fn.
+    * @return the libsais64 context, NULL otherwise.
+    */
+    LIBSAIS64_API void * libsais64_unbwt_create_ctx_alloc_omp(int64_t threads, void * (* alloc_fn)(size_t size, size_t alignment, void * opaque), void (* free_fn)(void * address, void * opaque), void * opaque);
+#endif
+
+    /**
+    * Returns the worst-case number of bytes requested from the allocator callbacks by libsais64_unbwt_create_ctx_alloc[_omp], including alignment padding.
+    * @param threads The number of threads of the context (can be 0 for OpenMP default).
+    * @return The number of bytes if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_unbwt_alloc_size(int64_t threads);
+
+    /**
+    * Returns the recommended sampling rate r for libsais64_bwt_aux[_omp] and libsais64_unbwt_aux[_omp], so that each thread decodes at least 8 interleaved blocks.
+    * Without auxiliary indexes, libsais64_unbwt[_omp] also decodes in parallel, at the cost of an extra pass over the temporary array,
+    * but only with at least 4 threads on as many cores and n of at least 2M symbols; below that it decodes serially.
+    * The number of threads is capped by the number of available cores, and a single core gets r = n (no auxiliary indexes).
+    * @param n The length of the string.
+    * @param threads The number of threads used for the reverse transform (can be 0 for OpenMP default).
+    * @return The sampling rate (power of two, at least 2, or n) if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_unbwt_recommend_r(int64_t n, int64_t threads);
+
+    /**
+    * Constructs the original string from a given burrows-wheeler transformed string (BWT) with primary index.
+    * @param T [0..n-1] The input string.
+    * @param U [0..n-1] The output string (can be T).
+    * @param A [0..n] The temporary array (NOTE, temporary array must be n + 1 size).
+    * @param n The length of the given string.
+    * @param freq [0..255] The input symbol frequency table (can be NULL).
+    * @param i The primary index.
+    * @return 0 if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_unbwt(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t i);
+
+    /**
+    * Constructs the original string from a given burrows-wheeler transformed string (BWT) with primary index using libsais64 reverse BWT context.
+    * @param ctx The libsais64 reverse BWT context.
+    * @param T [0..n-1] The input string.
+    * @param U [0..n-1] The output string (can be T).
+    * @param A [0..n] The temporary array (NOTE, temporary array must be n + 1 size).
+    * @param n The length of the given string.
+    * @param freq [0..255] The input symbol frequency table (can be NULL).
+    * @param i The primary index.
+    * @return 0 if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_unbwt_ctx(const void * ctx, const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t i);
+
+    /**
+    * Constructs the original string from a given burrows-wheeler transformed string (BWT) with auxiliary indexes.
+    * @param T [0..n-1] The input string.
+    * @param U [0..n-1] The output string (can be T).
+    * @param A [0..n] The temporary array (NOTE, temporary array must be n + 1 size).
+    * @param n The length of the given string.
+    * @param freq [0..255] The input symbol frequency table (can be NULL).
+    * @param r The sampling rate for auxiliary indexes (must be power of 2).
+    * @param I [0..(n-1)/r] The input auxiliary indexes.
+    * @return 0 if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_unbwt_aux(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t r, const int64_t * I);
+
+    /**
+    * Constructs the original string from a given burrows-wheeler transformed string (BWT) with auxiliary indexes using libsais64 reverse BWT context.
+    * @param ctx The libsais64 reverse BWT context.
+    * @param T [0..n-1] The input string.
+    * @param U [0..n-1] The output string (can be T).
+    * @param A [0..n] The temporary array (NOTE, temporary array must be n + 1 size).
+    * @param n The length of the given string.
+    * @param freq [0..255] The input symbol frequency table (can be NULL).
+    * @param r The sampling rate for auxiliary indexes (must be power of 2).
+    * @param I [0..(n-1)/r] The input auxiliary indexes.
+    * @return 0 if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_unbwt_aux_ctx(const void * ctx, const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t r, const int64_t * I);
+
+    /**
+    * Constructs the range [start, start+len) of the original string from a given burrows-wheeler transformed string (BWT) with auxiliary indexes.
+    * @param T [0..n-1] The input string.
+    * @param U [0..len-1] The output substring (can be T).
+    * @param A [0..n] The temporary array (NOTE, temporary array must be n + 1 size).
+    * @param n The length of the given string.
+    * @param freq [0..255] The input symbol frequency table (can be NULL).
+    * @param r The sampling rate for auxiliary indexes (must be power of 2).
+    * @param I [0..(n-1)/r] The input auxiliary indexes.
+    * @param start The first position of the original string to decode.
+    * @param len The number of symbols to decode.
+    * @return 0 if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_unbwt_range(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t r, const int64_t * I, int64_t start, int64_t len);
+
+    /**
+    * Constructs the range [start, start+len) of the original string from a given burrows-wheeler transformed string (BWT) with auxiliary indexes using libsais64 reverse BWT context.
+    * @param ctx The libsais64 reverse BWT context.
+    * @param T [0..n-1] The input string.
+    * @param U [0..len-1] The output substring (can be T).
+    * @param A [0..n] The temporary array (NOTE, temporary array must be n + 1 size).
+    * @param n The length of the given string.
+    * @param freq [0..255] The input symbol frequency table (can be NULL).
+    * @param r The sampling rate for auxiliary indexes (must be power of 2).
+    * @param I [0..(n-1)/r] The input auxiliary indexes.
+    * @param start The first position of the original string to decode.
+    * @param len The number of symbols to decode.
+    * @return 0 if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_unbwt_range_ctx(const void * ctx, const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t r, const int64_t * I, int64_t start, int64_t len);
+
+    /**
+    * Returns the size in bytes of the reverse BWT index built by libsais64_unbwt_index_build[_omp] for a string of length n and sampling rate r.
+    * @param n The length of the string.
+    * @param r The sampling rate for auxiliary indexes (must be power of 2).
+    * @return The number of bytes if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_unbwt_index_size(int64_t n, int64_t r);
+
+    /**
+    * Builds the reverse BWT index of a given burrows-wheeler transformed string (BWT) with auxiliary indexes into a caller provided buffer.
+    * The index is a flat, position independent, native endian image that can be saved and later loaded (or memory mapped) for libsais64_unbwt_index_decode[_omp].
+    * @param T [0..n-1] The input string.
+    * @param n The length of the given string.
+    * @param freq [0..255] The input symbol frequency table (can be NULL).
+    * @param r The sampling rate for auxiliary indexes (must be power of 2).
+    * @param I [0..(n-1)/r] The input auxiliary indexes.
+    * @param index The output index buffer (must be 8 byte aligned).
+    * @param size The size of the index buffer in bytes (at least libsais64_unbwt_index_size(n, r)).
+    * @return 0 if no error occurred, -1, -2 or -3 (buffer is too small) otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_unbwt_index_build(const uint8_t * T, int64_t n, const int64_t * freq, int64_t r, const int64_t * I, void * index, size_t size);
+
+    /**
+    * Constructs the range [start, start+len) of the original string from a given reverse BWT index.
+    * @param index The reverse BWT index built by libsais64_unbwt_index_build[_omp].
+    * @param size The size of the index image in bytes (images shorter than libsais64_unbwt_index_size(n, r) are rejected).
+    * @param U [0..len-1] The output substring.
+    * @param start The first position of the original string to decode.
+    * @param len The number of symbols to decode.
+    * @return 0 if no error occurred, -1 otherwise (including a truncated or corrupted index image).
+    */
+    LIBSAIS64_API int64_t libsais64_unbwt_index_decode(const void * index, size_t size, uint8_t * U, int64_t start, int64_t len);
+
+    /**
+    * Merges the burrows-wheeler transform (BWT) of a collection of strings with the BWT of one more, independently transformed, string.
+    * The strings of the collection keep their order and the new string is ordered after them, so k blocks can be merged incrementally.
+    * @param U1 [0..n1-1] The BWT of the collection (without sentinels).
+    * @param I1 [0..m1-1] The ascending sentinel row positions of the collection (the primary index for a single string).
+    * @param n1 The total length of the strings of the collection.
+    * @param m1 The number of strings in the collection (must be positive).
+    * @param T2 [0..n2-1] The new string.
+    * @param U2 [0..n2-1] The BWT of the new string.
+    * @param n2 The length of the new string.
+    * @param i2 The primary index of the new string.
+    * @param U [0..n1+n2-1] The output merged BWT (can not be U1 or U2).
+    * @param I [0..m1] The output ascending sentinel row positions of the merged collection (can not be I1).
+    * @return 0 if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_bwt_merge(const uint8_t * U1, const int64_t * I1, int64_t n1, int64_t m1, const uint8_t * T2, const uint8_t * U2, int64_t n2, int64_t i2, uint8_t * U, int64_t * I);
+
+    /**
+    * Computes balanced partitions of the suffix array of a given string by leading bigram buckets.
+    * Suffix i falls into bucket T[i] * 256 + T[i + 1] (the last suffix into bucket T[n - 1] * 256), so the leading symbol range [a, b) corresponds to the bucket range [a * 256, b * 256).
+    * @param T [0..n-1] The input string.
+    * @param n The length of the given string.
+    * @param parts The number of partitions (must be in range [1, 65536]).
+    * @param bounds [0..parts] The output bucket boundaries, partition p covers the bucket range [bounds[p], bounds[p + 1]).
+    * @param sizes [0..parts-1] The output number of suffixes in each partition (can be NULL).
+    * @return 0 if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_sa_partition(const uint8_t * T, int64_t n, int64_t parts, int64_t * bounds, int64_t * sizes);
+
+    /**
+    * Constructs the slice of the suffix array of a given string that holds the suffixes with leading bigram bucket in range [lo, hi).
+    * Only the slice is stored, highly repetitive inputs fall back to the full suffix array construction (which needs n extra memory unless size is at least n).
+    * @param T [0..n-1] The input string.
+    * @param SA [0..size-1] The output array of suffixes of the slice (in sorted order).
+    * @param n The length of the given string.
+    * @param lo The first bucket of the slice (see libsais64_sa_partition[_omp]).
+    * @param hi The bucket after the last bucket of the slice (at most 65536).
+    * @param size The size of the SA array (must be at least the number of suffixes in the slice).
+    * @return The number of suffixes in the slice if no error occurred, -1, -2 or -3 (array is too small) otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_sa_slice(const uint8_t * T, int64_t * SA, int64_t n, int64_t lo, int64_t hi, int64_t size);
+
+#if defined(LIBSAIS_OPENMP)
+    /**
+    * Constructs the original string from a given burrows-wheeler transformed string (BWT) with primary index in parallel using OpenMP.
+    * @param T [0..n-1] The input string.
+    * @param U [0..n-1] The output string (can be T).
+    * @param A [0..n] The temporary array (NOTE, temporary array must be n + 1 size).
+    * @param n The length of the given string.
+    * @param freq [0..255] The input symbol frequency table (can be NULL).
+    * @param i The primary index.
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return 0 if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_unbwt_omp(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t i, int64_t threads);
+
+    /**
+    * Constructs the original string from a given burrows-wheeler transformed string (BWT) with auxiliary indexes in parallel using OpenMP.
+    * @param T [0..n-1] The input string.
+    * @param U [0..n-1] The output string (can be T).
+    * @param A [0..n] The temporary array (NOTE, temporary array must be n + 1 size).
+    * @param n The length of the given string.
+    * @param freq [0..255] The input symbol frequency table (can be NULL).
+    * @param r The sampling rate for auxiliary indexes (must be power of 2).
+    * @param I [0..(n-1)/r] The input auxiliary indexes.
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return 0 if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_unbwt_aux_omp(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t r, const int64_t * I, int64_t threads);
+
+    /**
+    * Constructs the range [start, start+len) of the original string from a given burrows-wheeler transformed string (BWT) with auxiliary indexes in parallel using OpenMP.
+    * @param T [0..n-1] The input string.
+    * @param U [0..len-1] The output substring (can be T).
+    * @param A [0..n] The temporary array (NOTE, temporary array must be n + 1 size).
+    * @param n The length of the given string.
+    * @param freq [0..255] The input symbol frequency table (can be NULL).
+    * @param r The sampling rate for auxiliary indexes (must be power of 2).
+    * @param I [0..(n-1)/r] The input auxiliary indexes.
+    * @param start The first position of the original string to decode.
+    * @param len The number of symbols to decode.
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return 0 if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_unbwt_range_omp(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t r, const int64_t * I, int64_t start, int64_t len, int64_t threads);
+
+    /**
+    * Builds the reverse BWT index of a given burrows-wheeler transformed string (BWT) with auxiliary indexes into a caller provided buffer in parallel using OpenMP.
+    * @param T [0..n-1] The input string.
+    * @param n The length of the given string.
+    * @param freq [0..255] The input symbol frequency table (can be NULL).
+    * @param r The sampling rate for auxiliary indexes (must be power of 2).
+    * @param I [0..(n-1)/r] The input auxiliary indexes.
+    * @param index The output index buffer (must be 8 byte aligned).
+    * @param size The size of the index buffer in bytes (at least libsais64_unbwt_index_size(n, r)).
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return 0 if no error occurred, -1, -2 or -3 (buffer is too small) otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_unbwt_index_build_omp(const uint8_t * T, int64_t n, const int64_t * freq, int64_t r, const int64_t * I, void * index, size_t size, int64_t threads);
+
+    /**
+    * Constructs the range [start, start+len) of the original string from a given reverse BWT index in parallel using OpenMP.
+    * @param index The reverse BWT index built by libsais64_unbwt_index_build[_omp].
+    * @param size The size of the index image in bytes (images shorter than libsais64_unbwt_index_size(n, r) are rejected).
+    * @param U [0..len-1] The output substring.
+    * @param start The first position of the original string to decode.
+    * @param len The number of symbols to decode.
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return 0 if no error occurred, -1 otherwise (including a truncated or corrupted index image).
+    */
+    LIBSAIS64_API int64_t libsais64_unbwt_index_decode_omp(const void * index, size_t size, uint8_t * U, int64_t start, int64_t len, int64_t threads);
+
+    /**
+    * Merges the burrows-wheeler transform (BWT) of a collection of strings with the BWT of one more, independently transformed, string in parallel using OpenMP.
+    * The strings of the collection keep their order and the new string is ordered after them, so k blocks can be merged incrementally.
+    * @param U1 [0..n1-1] The BWT of the collection (without sentinels).
+    * @param I1 [0..m1-1] The ascending sentinel row positions of the collection (the primary index for a single string).
+    * @param n1 The total length of the strings of the collection.
+    * @param m1 The number of strings in the collection (must be positive).
+    * @param T2 [0..n2-1] The new string.
+    * @param U2 [0..n2-1] The BWT of the new string.
+    * @param n2 The length of the new string.
+    * @param i2 The primary index of the new string.
+    * @param U [0..n1+n2-1] The output merged BWT (can not be U1 or U2).
+    * @param I [0..m1] The output ascending sentinel row positions of the merged collection (can not be I1).
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return 0 if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_bwt_merge_omp(const uint8_t * U1, const int64_t * I1, int64_t n1, int64_t m1, const uint8_t * T2, const uint8_t * U2, int64_t n2, int64_t i2, uint8_t * U, int64_t * I, int64_t threads);
+
+    /**
+    * Computes balanced partitions of the suffix array of a given string by leading bigram buckets in parallel using OpenMP.
+    * Suffix i falls into bucket T[i] * 256 + T[i + 1] (the last suffix into bucket T[n - 1] * 256), so the leading symbol range [a, b) corresponds to the bucket range [a * 256, b * 256).
+    * @param T [0..n-1] The input string.
+    * @param n The length of the given string.
+    * @param parts The number of partitions (must be in range [1, 65536]).
+    * @param bounds [0..parts] The output bucket boundaries, partition p covers the bucket range [bounds[p], bounds[p + 1]).
+    * @param sizes [0..parts-1] The output number of suffixes in each partition (can be NULL).
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return 0 if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_sa_partition_omp(const uint8_t * T, int64_t n, int64_t parts, int64_t * bounds, int64_t * sizes, int64_t threads);
+
+    /**
+    * Constructs the slice of the suffix array of a given string that holds the suffixes with leading bigram bucket in range [lo, hi) in parallel using OpenMP.
+    * Only the slice is stored, highly repetitive inputs fall back to the full suffix array construction (which needs n extra memory unless size is at least n).
+    * @param T [0..n-1] The input string.
+    * @param SA [0..size-1] The output array of suffixes of the slice (in sorted order).
+    * @param n The length of the given string.
+    * @param lo The first bucket of the slice (see libsais64_sa_partition[_omp]).
+    * @param hi The bucket after the last bucket of the slice (at most 65536).
+    * @param size The size of the SA array (must be at least the number of suffixes in the slice).
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return The number of suffixes in the slice if no error occurred, -1, -2 or -3 (array is too small) otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_sa_slice_omp(const uint8_t * T, int64_t * SA, int64_t n, int64_t lo, int64_t hi, int64_t size, int64_t threads);
+#endif
+
+    /**
+    * Constructs the permuted longest common prefix array (PLCP) of a given string and a suffix array.
+    * @param T [0..n-1] The input string.
+    * @param SA [0..n-1] The input suffix array.
+    * @param PLCP [0..n-1] The output permuted longest common prefix array.
+    * @param n The length of the string and the suffix array.
+    * @return 0 if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_plcp(const uint8_t * T, const int64_t * SA, int64_t * PLCP, int64_t n);
+
+    /**
+    * Constructs the permuted longest common prefix array (PLCP) of a given string set and a generalized suffix array.
+    * The common prefixes are not extended past the 0 separators.
+    * @param T [0..n-1] The input string set using 0 as separators (T[n-1] must be 0).
+    * @param SA [0..n-1] The input generalized suffix array.
+    * @param PLCP [0..n-1] The output permuted longest common prefix array.
+    * @param n The length of the string set and the generalized suffix array.
+    * @return 0 if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_plcp_gsa(const uint8_t * T, const int64_t * SA, int64_t * PLCP, int64_t n);
+
+    /**
+    * Constructs the longest common prefix array (LCP) of a given permuted longest common prefix array (PLCP) and a suffix array.
+    * @param PLCP [0..n-1] The input permuted longest common prefix array.
+    * @param SA [0..n-1] The input suffix array.
+    * @param LCP [0..n-1] The output longest common prefix array (can be SA).
+    * @param n The length of the permuted longest common prefix array and the suffix array.
+    * @return 0 if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_lcp(const int64_t * PLCP, const int64_t * SA, int64_t * LCP, int64_t n);
+
+    /**
+    * Constructs the sampled permuted longest common prefix array (PLCP) of a given string and a suffix array.
+    * Only the values of every r-th suffix in text order are computed, PLCP[j] is the PLCP value of suffix j*r.
+    * @param T [0..n-1] The input string.
+    * @param SA [0..n-1] The input suffix array.
+    * @param PLCP [0..(n-1)/r] The output sampled permuted longest common prefix array.
+    * @param n The length of the string and the suffix array.
+    * @param r The sampling rate for the permuted longest common prefix array (must be power of 2).
+    * @return 0 if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_plcp_sampled(const uint8_t * T, const int64_t * SA, int64_t * PLCP, int64_t n, int64_t r);
+
+    /**
+    * Constructs the sampled longest common prefix array (LCP) of a given string, sampled permuted longest common prefix array and a suffix array.
+    * Only the values at every k-th suffix array position are computed, LCP[j] is the LCP value of SA[j*k].
+    * @param T [0..n-1] The input string.
+    * @param PLCP [0..(n-1)/r] The input sampled permuted longest common prefix array.
+    * @param SA [0..n-1] The input suffix array.
+    * @param LCP [0..(n-1)/k] The output sampled longest common prefix array.
+    * @param n The length of the string and the suffix array.
+    * @param r The sampling rate of the permuted longest common prefix array (must be power of 2).
+    * @param k The sampling rate for the longest common prefix array.
+    * @return 0 if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_lcp_sampled(const uint8_t * T, const int64_t * PLCP, const int64_t * SA, int64_t * LCP, int64_t n, int64_t r, int64_t k);
+
+    /**
+    * Constructs the longest common prefix values (LCP) at the suffix array positions flagged in a bitmap.
+    * Suffix array position i is flagged if bit (i & 7) of B[i >> 3] is set, the values are written in suffix array order.
+    * @param T [0..n-1] The input string.
+    * @param PLCP [0..(n-1)/r] The input sampled permuted longest common prefix array.
+    * @param SA [0..n-1] The input suffix array.
+    * @param B [0..(n-1)/8] The input bitmap of flagged suffix array positions.
+    * @param LCP [0..m-1] The output longest common prefix values (m is the number of flagged positions).
+    * @param n The length of the string and the suffix array.
+    * @param r The sampling rate of the permuted longest common prefix array (must be power of 2).
+    * @return The number of longest common prefix values written if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_lcp_marked(const uint8_t * T, const int64_t * PLCP, const int64_t * SA, const uint8_t * B, int64_t * LCP, int64_t n, int64_t r);
+
+    /**
+    * Constructs the byte-packed longest common prefix array (LCP) of a given permuted longest common prefix array (PLCP) and a suffix array.
+    * Values below 255 are stored in LCP directly, larger values are stored as 255 and recorded in the exception table.
+    * @param PLCP [0..n-1] The input permuted longest common prefix array.
+    * @param SA [0..n-1] The input suffix array.
+    * @param LCP [0..n-1] The output byte-packed longest common prefix array.
+    * @param n The length of the permuted longest common prefix array and the suffix array.
+    * @param X [0..2*xs-1] The output exception table of (index, value) pairs sorted by index (can be NULL if xs is 0).
+    * @param xs The capacity of the exception table in pairs.
+    * @return The total number of exceptions (only the first xs are stored) if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_lcp_8u(const int64_t * PLCP, const int64_t * SA, uint8_t * LCP, int64_t n, int64_t * X, int64_t xs);
+
+    /**
+    * Constructs the inverse suffix array (ISA) of a given suffix array.
+    * @param SA [0..n-1] The input suffix array.
+    * @param ISA [0..n-1] The output inverse suffix array (can be SA).
+    * @param n The length of the suffix array.
+    * @return 0 if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_isa(const int64_t * SA, int64_t * ISA, int64_t n);
+
+    /**
+    * Constructs the suffix array and the longest common prefix array (LCP) of a given string.
+    * The permuted longest common prefix array is built in the extra space of SA array if fs >= n, which is faster,
+    * otherwise it is built in LCP array and permuted in-place.
+    * @param T [0..n-1] The input string.
+    * @param SA [0..n-1+fs] The output array of suffixes.
+    * @param LCP [0..n-1] The output longest common prefix array.
+    * @param n The length of the given string.
+    * @param fs The extra space available at the end of SA array (n or more is recommended for optimal performance).
+    * @param freq [0..255] The output symbol frequency table (can be NULL).
+    * @return 0 if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_sa_lcp(const uint8_t * T, int64_t * SA, int64_t * LCP, int64_t n, int64_t fs, int64_t * freq);
+
+    /**
+    * Constructs the suffix array and the longest common prefix array (LCP) of a given string using libsais64 context.
+    * @param ctx The libsais64 context.
+    * @param T [0..n-1] The input string.
+    * @param SA [0..n-1+fs] The output array of suffixes.
+    * @param LCP [0..n-1] The output longest common prefix array.
+    * @param n The length of the given string.
+    * @param fs The extra space available at the end of SA array (n or more is recommended for optimal performance).
+    * @param freq [0..255] The output symbol frequency table (can be NULL).
+    * @return 0 if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_sa_lcp_ctx(const void * ctx, const uint8_t * T, int64_t * SA, int64_t * LCP, int64_t n, int64_t fs, int64_t * freq);
+
+    /**
+    * Packs an array of non-negative 64-bit integers (SA, PLCP or LCP) in-place into 5-byte (40-bit) little-endian entries.
+    * The packed array occupies the first 5n bytes of A; the memory past that point may be released or reused.
+    * @param A [0..n-1] The array to pack (all values must be less than 2^40).
+    * @param n The length of the array (at most 2^40).
+    * @return 0 if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_pack_40u(int64_t * A, int64_t n);
+
+    /**
+    * Unpacks an array of 5-byte (40-bit) entries in-place into 64-bit integers.
+    * @param A [0..n-1] The array holding 5n bytes of packed entries, with room for n 64-bit integers.
+    * @param n The length of the array (at most 2^40).
+    * @return 0 if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_unpack_40u(int64_t * A, int64_t n);
+
+    /**
+    * Constructs the packed 40-bit permuted longest common prefix array (PLCP) of a given string and a packed 40-bit suffix array.
+    * @param T [0..n-1] The input string.
+    * @param SA [0..5n-1] The input suffix array packed by libsais64_pack_40u.
+    * @param PLCP [0..5n-1] The output packed permuted longest common prefix array (built in place, no 64-bit working array is needed).
+    * @param n The length of the string and the suffix array (less than 2^40).
+    * @return 0 if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_plcp_40u(const uint8_t * T, const uint8_t * SA, uint8_t * PLCP, int64_t n);
+
+    /**
+    * Constructs the packed 40-bit longest common prefix array (LCP) of a given packed 40-bit permuted longest common prefix array and packed 40-bit suffix array.
+    * @param PLCP [0..5n-1] The input packed permuted longest common prefix array.
+    * @param SA [0..5n-1] The input packed suffix array.
+    * @param LCP [0..5n-1] The output packed longest common prefix array (can not be SA).
+    * @param n The length of the permuted longest common prefix array and the suffix array (at most 2^40).
+    * @return 0 if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_lcp_40u(const uint8_t * PLCP, const uint8_t * SA, uint8_t * LCP, int64_t n);
+
+#if defined(LIBSAIS_OPENMP)
+    /**
+    * Constructs the permuted longest common prefix array (PLCP) of a given string and a suffix array in parallel using OpenMP.
+    * @param T [0..n-1] The input string.
+    * @param SA [0..n-1] The input suffix array.
+    * @param PLCP [0..n-1] The output permuted longest common prefix array.
+    * @param n The length of the string and the suffix array.
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return 0 if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_plcp_omp(const uint8_t * T, const int64_t * SA, int64_t * PLCP, int64_t n, int64_t threads);
+
+    /**
+    * Constructs the permuted longest common prefix array (PLCP) of a given string set and a generalized suffix array in parallel using OpenMP.
+    * The common prefixes are not extended past the 0 separators.
+    * @param T [0..n-1] The input string set using 0 as separators (T[n-1] must be 0).
+    * @param SA [0..n-1] The input generalized suffix array.
+    * @param PLCP [0..n-1] The output permuted longest common prefix array.
+    * @param n The length of the string set and the generalized suffix array.
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return 0 if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_plcp_gsa_omp(const uint8_t * T, const int64_t * SA, int64_t * PLCP, int64_t n, int64_t threads);
+
+    /**
+    * Constructs the longest common prefix array (LCP) of a given permuted longest common prefix array (PLCP) and a suffix array in parallel using OpenMP.
+    * @param PLCP [0..n-1] The input permuted longest common prefix array.
+    * @param SA [0..n-1] The input suffix array.
+    * @param LCP [0..n-1] The output longest common prefix array (can be SA).
+    * @param n The length of the permuted longest common prefix array and the suffix array.
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return 0 if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_lcp_omp(const int64_t * PLCP, const int64_t * SA, int64_t * LCP, int64_t n, int64_t threads);
+
+    /**
+    * Constructs the sampled permuted longest common prefix array (PLCP) of a given string and a suffix array in parallel using OpenMP.
+    * Only the values of every r-th suffix in text order are computed, PLCP[j] is the PLCP value of suffix j*r.
+    * @param T [0..n-1] The input string.
+    * @param SA [0..n-1] The input suffix array.
+    * @param PLCP [0..(n-1)/r] The output sampled permuted longest common prefix array.
+    * @param n The length of the string and the suffix array.
+    * @param r The sampling rate for the permuted longest common prefix array (must be power of 2).
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return 0 if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_plcp_sampled_omp(const uint8_t * T, const int64_t * SA, int64_t * PLCP, int64_t n, int64_t r, int64_t threads);
+
+    /**
+    * Constructs the sampled longest common prefix array (LCP) of a given string, sampled permuted longest common prefix array and a suffix array in parallel using OpenMP.
+    * Only the values at every k-th suffix array position are computed, LCP[j] is the LCP value of SA[j*k].
+    * @param T [0..n-1] The input string.
+    * @param PLCP [0..(n-1)/r] The input sampled permuted longest common prefix array.
+    * @param SA [0..n-1] The input suffix array.
+    * @param LCP [0..(n-1)/k] The output sampled longest common prefix array.
+    * @param n The length of the string and the suffix array.
+    * @param r The sampling rate of the permuted longest common prefix array (must be power of 2).
+    * @param k The sampling rate for the longest common prefix array.
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return 0 if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_lcp_sampled_omp(const uint8_t * T, const int64_t * PLCP, const int64_t * SA, int64_t * LCP, int64_t n, int64_t r, int64_t k, int64_t threads);
+
+    /**
+    * Constructs the longest common prefix values (LCP) at the suffix array positions flagged in a bitmap in parallel using OpenMP.
+    * Suffix array position i is flagged if bit (i & 7) of B[i >> 3] is set, the values are written in suffix array order.
+    * @param T [0..n-1] The input string.
+    * @param PLCP [0..(n-1)/r] The input sampled permuted longest common prefix array.
+    * @param SA [0..n-1] The input suffix array.
+    * @param B [0..(n-1)/8] The input bitmap of flagged suffix array positions.
+    * @param LCP [0..m-1] The output longest common prefix values (m is the number of flagged positions).
+    * @param n The length of the string and the suffix array.
+    * @param r The sampling rate of the permuted longest common prefix array (must be power of 2).
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return The number of longest common prefix values written if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_lcp_marked_omp(const uint8_t * T, const int64_t * PLCP, const int64_t * SA, const uint8_t * B, int64_t * LCP, int64_t n, int64_t r, int64_t threads);
+
+    /**
+    * Constructs the byte-packed longest common prefix array (LCP) of a given permuted longest common prefix array (PLCP) and a suffix array in parallel using OpenMP.
+    * Values below 255 are stored in LCP directly, larger values are stored as 255 and recorded in the exception table.
+    * @param PLCP [0..n-1] The input permuted longest common prefix array.
+    * @param SA [0..n-1] The input suffix array.
+    * @param LCP [0..n-1] The output byte-packed longest common prefix array.
+    * @param n The length of the permuted longest common prefix array and the suffix array.
+    * @param X [0..2*xs-1] The output exception table of (index, value) pairs sorted by index (can be NULL if xs is 0).
+    * @param xs The capacity of the exception table in pairs.
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return The total number of exceptions (only the first xs are stored) if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_lcp_8u_omp(const int64_t * PLCP, const int64_t * SA, uint8_t * LCP, int64_t n, int64_t * X, int64_t xs, int64_t threads);
+
+    /**
+    * Constructs the inverse suffix array (ISA) of a given suffix array in parallel using OpenMP.
+    * Note, the in-place construction (ISA equal to SA) is only partially parallel.
+    * @param SA [0..n-1] The input suffix array.
+    * @param ISA [0..n-1] The output inverse suffix array (can be SA).
+    * @param n The length of the suffix array.
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return 0 if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_isa_omp(const int64_t * SA, int64_t * ISA, int64_t n, int64_t threads);
+
+    /**
+    * Constructs the suffix array and the longest common prefix array (LCP) of a given string in parallel using OpenMP.
+    * The permuted longest common prefix array is built in the extra space of SA array if fs >= n, which is faster,
+    * otherwise it is built in LCP array and permuted in-place.
+    * @param T [0..n-1] The input string.
+    * @param SA [0..n-1+fs] The output array of suffixes.
+    * @param LCP [0..n-1] The output longest common prefix array.
+    * @param n The length of the given string.
+    * @param fs The extra space available at the end of SA array (n or more is recommended for optimal performance).
+    * @param freq [0..255] The output symbol frequency table (can be NULL).
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return 0 if no error occurred, -1 or -2 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_sa_lcp_omp(const uint8_t * T, int64_t * SA, int64_t * LCP, int64_t n, int64_t fs, int64_t * freq, int64_t threads);
+
+    /**
+    * Packs an array of non-negative 64-bit integers (SA, PLCP or LCP) in-place into 5-byte (40-bit) little-endian entries in parallel using OpenMP.
+    * The packed array occupies the first 5n bytes of A; the memory past that point may be released or reused.
+    * @param A [0..n-1] The array to pack (all values must be less than 2^40).
+    * @param n The length of the array (at most 2^40).
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return 0 if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_pack_40u_omp(int64_t * A, int64_t n, int64_t threads);
+
+    /**
+    * Unpacks an array of 5-byte (40-bit) entries in-place into 64-bit integers in parallel using OpenMP.
+    * @param A [0..n-1] The array holding 5n bytes of packed entries, with room for n 64-bit integers.
+    * @param n The length of the array (at most 2^40).
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return 0 if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_unpack_40u_omp(int64_t * A, int64_t n, int64_t threads);
+
+    /**
+    * Constructs the packed 40-bit permuted longest common prefix array (PLCP) of a given string and a packed 40-bit suffix array in parallel using OpenMP.
+    * @param T [0..n-1] The input string.
+    * @param SA [0..5n-1] The input suffix array packed by libsais64_pack_40u.
+    * @param PLCP [0..5n-1] The output packed permuted longest common prefix array (built in place, no 64-bit working array is needed).
+    * @param n The length of the string and the suffix array (less than 2^40).
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return 0 if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_plcp_40u_omp(const uint8_t * T, const uint8_t * SA, uint8_t * PLCP, int64_t n, int64_t threads);
+
+    /**
+    * Constructs the packed 40-bit longest common prefix array (LCP) of a given packed 40-bit permuted longest common prefix array and packed 40-bit suffix array in parallel using OpenMP.
+    * @param PLCP [0..5n-1] The input packed permuted longest common prefix array.
+    * @param SA [0..5n-1] The input packed suffix array.
+    * @param LCP [0..5n-1] The output packed longest common prefix array (can not be SA).
+    * @param n The length of the permuted longest common prefix array and the suffix array (at most 2^40).
+    * @param threads The number of OpenMP threads to use (can be 0 for OpenMP default).
+    * @return 0 if no error occurred, -1 otherwise.
+    */
+    LIBSAIS64_API int64_t libsais64_lcp_40u_omp(const uint8_t * PLCP, const uint8_t * SA, uint8_t * LCP, int64_t n, int64_t threads);
 #endif
 
 #ifdef __cplusplus
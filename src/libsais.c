@@ -45,7 +45,21 @@ typedef size_t                          fast_uint_t;
 #define SAINT_MIN                       INT32_MIN
 
 #define ALPHABET_SIZE                   (1 << CHAR_BIT)
-#define UNBWT_FASTBITS                  (17)
+
+#if !defined(UNBWT_FASTBITS)
+    #define UNBWT_FASTBITS                 (17)
+#endif
+
+#define UNBWT_FASTBITS_MIN             (8)
+#define UNBWT_FASTBITS_MAX             (24)
+
+#if !defined(UNBWT_SPLITTERS_MIN_THREADS)
+    #define UNBWT_SPLITTERS_MIN_THREADS    (4)
+#endif
+
+#if !defined(UNBWT_SPLITTERS_MIN_SIZE)
+    #define UNBWT_SPLITTERS_MIN_SIZE       (1 << 21)
+#endif
 
 #define SUFFIX_GROUP_BIT                (SAINT_BIT - 1)
 #define SUFFIX_GROUP_MARKER             (((sa_sint_t)1) << (SUFFIX_GROUP_BIT - 1))
@@ -53,8 +67,21 @@ typedef size_t                          fast_uint_t;
 #define BUCKETS_INDEX2(_c, _s)          (((_c) << 1) + (_s))
 #define BUCKETS_INDEX4(_c, _s)          (((_c) << 2) + (_s))
 
-#define LIBSAIS_LOCAL_BUFFER_SIZE       (1024)
-#define LIBSAIS_PER_THREAD_CACHE_SIZE   (24576)
+#if !defined(LIBSAIS_LOCAL_BUFFER_SIZE)
+    #define LIBSAIS_LOCAL_BUFFER_SIZE      (1024)
+#endif
+
+#if !defined(LIBSAIS_PER_THREAD_CACHE_SIZE)
+    #define LIBSAIS_PER_THREAD_CACHE_SIZE  (24576)
+#endif
+
+#if !defined(LIBSAIS_NUMA_PAGE_SIZE)
+    #define LIBSAIS_NUMA_PAGE_SIZE         (4096)
+#endif
+
+#if !defined(LIBSAIS_PREFETCH_DISTANCE)
+    #define LIBSAIS_PREFETCH_DISTANCE      (32)
+#endif
 
 typedef struct LIBSAIS_THREAD_CACHE
 {
@@ -74,16 +101,48 @@ typedef union LIBSAIS_THREAD_STATE
 
         sa_sint_t *                     buckets;
         LIBSAIS_THREAD_CACHE *          cache;
+        fast_sint_t                     cache_size;
+        struct LIBSAIS_MONITOR *        monitor;
     } state;
 
     uint8_t padding[64];
 } LIBSAIS_THREAD_STATE;
 
+typedef struct LIBSAIS_ALLOCATOR
+{
+    void *                              (* alloc)(size_t size, size_t alignment, void * opaque);
+    void                                (* free)(void * address, void * opaque);
+    void *                              opaque;
+} LIBSAIS_ALLOCATOR;
+
+typedef struct LIBSAIS_MONITOR
+{
+    void                                (* profile)(int32_t phase, int32_t end, int32_t depth, int64_t n, int64_t k, int32_t flags, void * opaque);
+    void *                              profile_opaque;
+    int32_t                             (* cancel)(void * opaque);
+    void *                              cancel_opaque;
+    sa_sint_t                           cancelled;
+    sa_sint_t                           thread_block_size;
+} LIBSAIS_MONITOR;
+
+typedef struct LIBSAIS_ARENA
+{
+    uint8_t *                           memory;
+    size_t                              size;
+    size_t                              used;
+    sa_sint_t                           exhausted;
+} LIBSAIS_ARENA;
+
 typedef struct LIBSAIS_CONTEXT
 {
     sa_sint_t *                         buckets;
     LIBSAIS_THREAD_STATE *              thread_state;
     fast_sint_t                         threads;
+    sa_sint_t *                         local_buffer;
+    fast_sint_t                         local_buffer_size;
+    fast_sint_t                         numa;
+    LIBSAIS_ALLOCATOR                   allocator;
+    LIBSAIS_MONITOR                     monitor;
 } LIBSAIS_CONTEXT;
 
 typedef struct LIBSAIS_UNBWT_CONTEXT
@@ -91,9 +150,22 @@ typedef struct LIBSAIS_UNBWT_CONTEXT
     sa_uint_t *                         bucket2;
     uint16_t *                          fastbits;
     sa_uint_t *                         buckets;
+    fast_sint_t                         fastbits_log;
     fast_sint_t                         threads;
+    LIBSAIS_ALLOCATOR                   allocator;
 } LIBSAIS_UNBWT_CONTEXT;
 
+#define LIBSAIS_UNBWT_INDEX_MAGIC           (0x323338304955534cULL)
+
+typedef struct LIBSAIS_UNBWT_INDEX
+{
+    uint64_t                    magic;
+    int64_t                     n;
+    int64_t                     r;
+    int64_t                     lastc;
+    int64_t                     reserved[4];
+} LIBSAIS_UNBWT_INDEX;
+
 #if defined(__GNUC__) || defined(__clang__)
     #define RESTRICT __restrict__
 #elif defined(_MSC_VER) || defined(__INTEL_COMPILER)
@@ -169,6 +241,48 @@ typedef struct LIBSAIS_UNBWT_CONTEXT
     #error Your compiler, configuration or platform is not supported.
 #endif
 
+#if defined(LIBSAIS_SIMD)
+    #if defined(__x86_64__) || defined(__i386__) || defined(_M_AMD64) || defined(_M_IX86)
+        #if defined(__GNUC__) || defined(__clang__)
+            #include <immintrin.h>
+            #define LIBSAIS_SIMD_AVX2
+            #define LIBSAIS_SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+            #define LIBSAIS_SIMD_AVX512
+            #define LIBSAIS_SIMD_TARGET_AVX512 __attribute__((target("avx512f")))
+            #define LIBSAIS_SIMD_DETECT
+            #define libsais_cpu_supports_avx2() (libsais_avx2_supported)
+            #define libsais_cpu_supports_avx512() (libsais_avx512_supported)
+        #elif defined(_MSC_VER) && defined(__AVX2__)
+            #include <immintrin.h>
+            #define LIBSAIS_SIMD_AVX2
+            #define LIBSAIS_SIMD_TARGET_AVX2
+            #define libsais_cpu_supports_avx2() (1)
+            #if defined(__AVX512F__)
+                #define LIBSAIS_SIMD_AVX512
+                #define LIBSAIS_SIMD_TARGET_AVX512
+                #define libsais_cpu_supports_avx512() (1)
+            #endif
+        #endif
+    #elif defined(__aarch64__) || defined(_M_ARM64)
+        #include <arm_neon.h>
+        #define LIBSAIS_SIMD_NEON
+    #endif
+#endif
+
+#if defined(LIBSAIS_SIMD_DETECT)
+
+static int libsais_avx2_supported = 0;
+static int libsais_avx512_supported = 0;
+
+static void __attribute__((constructor)) libsais_detect_simd(void)
+{
+    __builtin_cpu_init();
+    libsais_avx2_supported = __builtin_cpu_supports("avx2") != 0;
+    libsais_avx512_supported = __builtin_cpu_supports("avx512f") != 0;
+}
+
+#endif
+
 static void * libsais_align_up(const void * address, size_t alignment)
 {
     return (void *)((((ptrdiff_t)address) + ((ptrdiff_t)alignment) - 1) & (-((ptrdiff_t)alignment)));
@@ -196,58 +310,104 @@ static void libsais_free_aligned(void * aligned_address)
     }
 }
 
-static LIBSAIS_THREAD_STATE * libsais_alloc_thread_state(sa_sint_t threads)
+static void * libsais_alloc_memory(const LIBSAIS_ALLOCATOR * allocator, size_t size, size_t alignment)
+{
+    return allocator != NULL && allocator->alloc != NULL
+        ? allocator->alloc(size, alignment, allocator->opaque)
+        : libsais_alloc_aligned(size, alignment);
+}
+
+static void libsais_free_memory(const LIBSAIS_ALLOCATOR * allocator, void * address)
+{
+    if (allocator != NULL && allocator->alloc != NULL)
+    {
+        if (address != NULL) { allocator->free(address, allocator->opaque); }
+    }
+    else
+    {
+        libsais_free_aligned(address);
+    }
+}
+
+static void * libsais_arena_alloc(size_t size, size_t alignment, void * opaque)
+{
+    LIBSAIS_ARENA * RESTRICT arena = (LIBSAIS_ARENA *)opaque;
+
+    size_t offset = (size_t)((uint8_t *)libsais_align_up(arena->memory + arena->used, alignment) - arena->memory);
+    if (offset > arena->size || size > arena->size - offset) { arena->exhausted = 1; return NULL; }
+
+    arena->used = offset + size;
+    return arena->memory + offset;
+}
+
+static void libsais_arena_free(void * address, void * opaque)
+{
+    LIBSAIS_ARENA * RESTRICT arena = (LIBSAIS_ARENA *)opaque;
+
+    size_t offset = (size_t)((uint8_t *)address - arena->memory);
+    if (offset < arena->used) { arena->used = offset; }
+}
+
+static LIBSAIS_THREAD_STATE * libsais_alloc_thread_state(sa_sint_t threads, const LIBSAIS_ALLOCATOR * allocator)
 {
-    LIBSAIS_THREAD_STATE *  RESTRICT thread_state    = (LIBSAIS_THREAD_STATE *)libsais_alloc_aligned((size_t)threads * sizeof(LIBSAIS_THREAD_STATE), 4096);
-    sa_sint_t *             RESTRICT thread_buckets  = (sa_sint_t *)libsais_alloc_aligned((size_t)threads * 4 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
-    LIBSAIS_THREAD_CACHE *  RESTRICT thread_cache    = (LIBSAIS_THREAD_CACHE *)libsais_alloc_aligned((size_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE * sizeof(LIBSAIS_THREAD_CACHE), 4096);
+    LIBSAIS_THREAD_STATE *  RESTRICT thread_state    = (LIBSAIS_THREAD_STATE *)libsais_alloc_memory(allocator, (size_t)threads * sizeof(LIBSAIS_THREAD_STATE), 4096);
+    sa_sint_t *             RESTRICT thread_buckets  = (sa_sint_t *)libsais_alloc_memory(allocator, (size_t)threads * 4 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
+    LIBSAIS_THREAD_CACHE *  RESTRICT thread_cache    = (LIBSAIS_THREAD_CACHE *)libsais_alloc_memory(allocator, (size_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE * sizeof(LIBSAIS_THREAD_CACHE), 4096);
 
     if (thread_state != NULL && thread_buckets != NULL && thread_cache != NULL)
     {
         fast_sint_t t;
         for (t = 0; t < threads; ++t)
         { 
-            thread_state[t].state.buckets   = thread_buckets;   thread_buckets  += 4 * ALPHABET_SIZE;
-            thread_state[t].state.cache     = thread_cache;     thread_cache    += LIBSAIS_PER_THREAD_CACHE_SIZE;
+            thread_state[t].state.buckets    = thread_buckets;   thread_buckets  += 4 * ALPHABET_SIZE;
+            thread_state[t].state.cache      = thread_cache;     thread_cache    += LIBSAIS_PER_THREAD_CACHE_SIZE;
+            thread_state[t].state.cache_size = LIBSAIS_PER_THREAD_CACHE_SIZE;
+            thread_state[t].state.monitor    = NULL;
         }
 
         return thread_state;
     }
 
-    libsais_free_aligned(thread_cache);
-    libsais_free_aligned(thread_buckets);
-    libsais_free_aligned(thread_state);
+    libsais_free_memory(allocator, thread_cache);
+    libsais_free_memory(allocator, thread_buckets);
+    libsais_free_memory(allocator, thread_state);
     return NULL;
 }
 
-static void libsais_free_thread_state(LIBSAIS_THREAD_STATE * thread_state)
+static void libsais_free_thread_state(LIBSAIS_THREAD_STATE * thread_state, const LIBSAIS_ALLOCATOR * allocator)
 {
     if (thread_state != NULL)
     {
-        libsais_free_aligned(thread_state[0].state.cache);
-        libsais_free_aligned(thread_state[0].state.buckets);
-        libsais_free_aligned(thread_state);
+        libsais_free_memory(allocator, thread_state[0].state.cache);
+        libsais_free_memory(allocator, thread_state[0].state.buckets);
+        libsais_free_memory(allocator, thread_state);
     }
 }
 
-static LIBSAIS_CONTEXT * libsais_create_ctx_main(sa_sint_t threads)
+static LIBSAIS_CONTEXT * libsais_create_ctx_main(sa_sint_t threads, const LIBSAIS_ALLOCATOR * allocator)
 {
-    LIBSAIS_CONTEXT *       RESTRICT ctx            = (LIBSAIS_CONTEXT *)libsais_alloc_aligned(sizeof(LIBSAIS_CONTEXT), 64);
-    sa_sint_t *             RESTRICT buckets        = (sa_sint_t *)libsais_alloc_aligned((size_t)8 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
-    LIBSAIS_THREAD_STATE *  RESTRICT thread_state   = threads > 1 ? libsais_alloc_thread_state(threads) : NULL;
+    LIBSAIS_CONTEXT *       RESTRICT ctx            = (LIBSAIS_CONTEXT *)libsais_alloc_memory(allocator, sizeof(LIBSAIS_CONTEXT), 64);
+    sa_sint_t *             RESTRICT buckets        = (sa_sint_t *)libsais_alloc_memory(allocator, (size_t)8 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
+    LIBSAIS_THREAD_STATE *  RESTRICT thread_state   = threads > 1 ? libsais_alloc_thread_state(threads, allocator) : NULL;
 
     if (ctx != NULL && buckets != NULL && (thread_state != NULL || threads == 1))
     {
         ctx->buckets = buckets;
         ctx->threads = threads;
         ctx->thread_state = thread_state;
+        ctx->numa = LIBSAIS_NUMA_NONE;
+        ctx->local_buffer = NULL;
+        ctx->local_buffer_size = LIBSAIS_LOCAL_BUFFER_SIZE;
+
+        if (allocator != NULL) { ctx->allocator = *allocator; } else { memset(&ctx->allocator, 0, sizeof(LIBSAIS_ALLOCATOR)); }
+        memset(&ctx->monitor, 0, sizeof(LIBSAIS_MONITOR));
 
         return ctx;
     }
 
-    libsais_free_thread_state(thread_state);
-    libsais_free_aligned(buckets);
-    libsais_free_aligned(ctx);
+    libsais_free_thread_state(thread_state, allocator);
+    libsais_free_memory(allocator, buckets);
+    libsais_free_memory(allocator, ctx);
     return NULL;
 }
 
@@ -255,10 +415,219 @@ static void libsais_free_ctx_main(LIBSAIS_CONTEXT * ctx)
 {
     if (ctx != NULL)
     {
-        libsais_free_thread_state(ctx->thread_state);
-        libsais_free_aligned(ctx->buckets);
-        libsais_free_aligned(ctx);
+        LIBSAIS_ALLOCATOR allocator = ctx->allocator;
+
+        libsais_free_thread_state(ctx->thread_state, &allocator);
+        libsais_free_memory(&allocator, ctx->local_buffer);
+        libsais_free_memory(&allocator, ctx->buckets);
+        libsais_free_memory(&allocator, ctx);
+    }
+}
+
+static LIBSAIS_CONTEXT * libsais_create_ctx_buffer_main(sa_sint_t threads, void * buffer, size_t size)
+{
+    LIBSAIS_ARENA * RESTRICT arena = (LIBSAIS_ARENA *)libsais_align_up(buffer, 64);
+
+    if (buffer != NULL && (size_t)((uint8_t *)(arena + 1) - (uint8_t *)buffer) <= size)
+    {
+        arena->memory       = (uint8_t *)(arena + 1);
+        arena->size         = size - (size_t)(arena->memory - (uint8_t *)buffer);
+        arena->used         = 0;
+        arena->exhausted    = 0;
+
+        LIBSAIS_ALLOCATOR allocator = { libsais_arena_alloc, libsais_arena_free, arena };
+        return libsais_create_ctx_main(threads, &allocator);
+    }
+
+    return NULL;
+}
+
+static sa_sint_t libsais_ctx_status(const LIBSAIS_CONTEXT * ctx, sa_sint_t index)
+{
+    if (ctx->allocator.alloc == libsais_arena_alloc)
+    {
+        LIBSAIS_ARENA * RESTRICT arena = (LIBSAIS_ARENA *)ctx->allocator.opaque;
+
+        if (index == -2 && arena->exhausted) { index = -3; }
+        arena->exhausted = 0;
+    }
+
+    return index;
+}
+
+static void libsais_profile(const LIBSAIS_MONITOR * monitor, sa_sint_t phase, sa_sint_t end, sa_sint_t depth, sa_sint_t n, sa_sint_t k, sa_sint_t flags)
+{
+    if (monitor != NULL && monitor->profile != NULL)
+    {
+        monitor->profile((int32_t)phase, (int32_t)end, (int32_t)depth, (int64_t)n, (int64_t)k, (int32_t)flags, monitor->profile_opaque);
+    }
+}
+
+static sa_sint_t libsais_cancelled(LIBSAIS_MONITOR * monitor)
+{
+    if (monitor != NULL && monitor->cancel != NULL && monitor->cancelled == 0)
+    {
+        monitor->cancelled = monitor->cancel(monitor->cancel_opaque) != 0;
+    }
+
+    return monitor != NULL && monitor->cancelled != 0;
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+static void libsais_numa_touch_pages(void * memory, fast_sint_t size, fast_sint_t start, fast_sint_t end, fast_sint_t page_start, fast_sint_t page_step)
+{
+    uint8_t * RESTRICT bytes = (uint8_t *)memory;
+    ptrdiff_t base = ((ptrdiff_t)bytes) & (-((ptrdiff_t)LIBSAIS_NUMA_PAGE_SIZE));
+
+    if (start < end && end <= size)
+    {
+        fast_sint_t p = (((ptrdiff_t)(bytes + start) - base) / LIBSAIS_NUMA_PAGE_SIZE);
+        fast_sint_t last = (((ptrdiff_t)(bytes + end - 1) - base) / LIBSAIS_NUMA_PAGE_SIZE);
+
+        if (page_step > 1) { p += (page_start - p % page_step + page_step) % page_step; }
+
+        for (; p <= last; p += page_step)
+        {
+            fast_sint_t offset = (fast_sint_t)(base + p * LIBSAIS_NUMA_PAGE_SIZE - (ptrdiff_t)bytes);
+            bytes[offset > start ? offset : start] = 0;
+        }
+    }
+}
+
+#endif
+
+static void libsais_numa_place_thread_state(LIBSAIS_THREAD_STATE * RESTRICT thread_state, fast_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    if (thread_state != NULL && threads > 1)
+    {
+        #pragma omp parallel num_threads(threads)
+        {
+            fast_sint_t omp_thread_num = omp_get_thread_num();
+            fast_sint_t cache_size = thread_state[0].state.cache_size * (fast_sint_t)sizeof(LIBSAIS_THREAD_CACHE);
+
+            if (omp_thread_num < threads)
+            {
+                memset(thread_state[omp_thread_num].state.buckets, 0, (size_t)4 * ALPHABET_SIZE * sizeof(sa_sint_t));
+                libsais_numa_touch_pages(thread_state[omp_thread_num].state.cache, cache_size, 0, cache_size, 0, 1);
+            }
+        }
+    }
+#else
+    UNUSED(thread_state); UNUSED(threads);
+#endif
+}
+
+static void libsais_numa_place_omp(const LIBSAIS_CONTEXT * ctx, sa_sint_t * SA, sa_sint_t n, sa_sint_t fs)
+{
+#if defined(LIBSAIS_OPENMP)
+    if (ctx->numa != LIBSAIS_NUMA_NONE && ctx->threads > 1 && n >= 65536)
+    {
+        fast_sint_t mode = ctx->numa, size = ((fast_sint_t)n + (fast_sint_t)fs) * (fast_sint_t)sizeof(sa_sint_t);
+
+        #pragma omp parallel num_threads(ctx->threads)
+        {
+            fast_sint_t omp_thread_num    = omp_get_thread_num();
+            fast_sint_t omp_num_threads   = omp_get_num_threads();
+            fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+            fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+            fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n + fs - omp_block_start;
+
+            if (mode == LIBSAIS_NUMA_INTERLEAVE)
+            {
+                libsais_numa_touch_pages(SA, size, 0, size, omp_thread_num, omp_num_threads);
+            }
+            else
+            {
+                libsais_numa_touch_pages(SA, size, omp_block_start * (fast_sint_t)sizeof(sa_sint_t), (omp_block_start + omp_block_size) * (fast_sint_t)sizeof(sa_sint_t), 0, 1);
+            }
+        }
+    }
+#else
+    UNUSED(ctx); UNUSED(SA); UNUSED(n); UNUSED(fs);
+#endif
+}
+
+static int64_t libsais_padded_size(int64_t size, int64_t alignment, fast_sint_t flags)
+{
+    return size > 0 ? size + (alignment - 1) + (flags != LIBSAIS_FLAGS_BUFFER ? (int64_t)sizeof(short) : 0) : 0;
+}
+
+static int64_t libsais_thread_state_size(fast_sint_t threads, fast_sint_t flags)
+{
+    int64_t size = 0;
+
+    if (threads > 1)
+    {
+        size += libsais_padded_size((int64_t)threads * (int64_t)sizeof(LIBSAIS_THREAD_STATE), 4096, flags);
+        size += libsais_padded_size((int64_t)threads * 4 * ALPHABET_SIZE * (int64_t)sizeof(sa_sint_t), 4096, flags);
+        size += libsais_padded_size((int64_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE * (int64_t)sizeof(LIBSAIS_THREAD_CACHE), 4096, flags);
+    }
+
+    return size;
+}
+
+static int64_t libsais_ctx_size_main(fast_sint_t threads)
+{
+    int64_t size = libsais_padded_size((int64_t)sizeof(LIBSAIS_CONTEXT), 64, LIBSAIS_FLAGS_CTX);
+
+    size += libsais_padded_size((int64_t)8 * ALPHABET_SIZE * (int64_t)sizeof(sa_sint_t), 4096, LIBSAIS_FLAGS_CTX);
+    size += libsais_thread_state_size(threads, LIBSAIS_FLAGS_CTX);
+
+    return size;
+}
+
+static fast_sint_t libsais_recursion_buffer_size(fast_sint_t n, fast_sint_t k, fast_sint_t fs, fast_sint_t threads, fast_sint_t local_buffer_size)
+{
+    fast_sint_t size = 0;
+
+    fs = fs < (SAINT_MAX - n) ? fs : (SAINT_MAX - n);
+
+    if (fs < k && (threads > 1 || local_buffer_size / k < 2)) { size = k; }
+
+    {
+        fast_sint_t m = n / 2, names = m - 1;
+        if (names > fs + n - 2 * m && (threads > 1 || local_buffer_size / names < 2) && names > size) { size = names; }
+    }
+
+    return size;
+}
+
+static fast_sint_t libsais_alphabet_buffer_size(fast_sint_t n, fast_sint_t k, fast_sint_t fs)
+{
+    fs = fs < (SAINT_MAX - n) ? fs : (SAINT_MAX - n);
+
+    return k > 0 && fs / k < 6 ? (k > n + fs ? k : k < n ? k : n) : 0;
+}
+
+static int64_t libsais_scratch_size_main(fast_sint_t n, fast_sint_t k, fast_sint_t fs, fast_sint_t threads, fast_sint_t flags)
+{
+    int64_t size = 0;
+
+    if (n >= 2)
+    {
+        size += libsais_padded_size((int64_t)libsais_recursion_buffer_size(n, k, fs, threads, flags == LIBSAIS_FLAGS_NONE ? LIBSAIS_LOCAL_BUFFER_SIZE : 0) * (int64_t)sizeof(sa_sint_t), 4096, flags);
+        size += libsais_padded_size((int64_t)libsais_alphabet_buffer_size(n, k, fs) * (int64_t)sizeof(sa_sint_t), 4096, flags);
+
+        if (flags == LIBSAIS_FLAGS_NONE)
+        {
+            size += libsais_thread_state_size(threads, flags);
+            if (k == 0) { size += libsais_padded_size((int64_t)8 * ALPHABET_SIZE * (int64_t)sizeof(sa_sint_t), 4096, flags); }
+        }
+    }
+
+    if (flags == LIBSAIS_FLAGS_BUFFER)
+    {
+        size += (int64_t)sizeof(LIBSAIS_ARENA) + 64 + libsais_ctx_size_main(threads);
     }
+
+    return size;
+}
+
+static int64_t libsais_alloc_size_main(fast_sint_t n, fast_sint_t k, fast_sint_t threads)
+{
+    return libsais_ctx_size_main(threads) + libsais_scratch_size_main(n, k, 0, threads, LIBSAIS_FLAGS_CTX);
 }
 
 #if defined(LIBSAIS_OPENMP)
@@ -283,7 +652,7 @@ static sa_sint_t libsais_count_zero_marked_suffixes(sa_sint_t * RESTRICT SA, fas
 
 static void libsais_place_cached_suffixes(sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
@@ -309,7 +678,7 @@ static void libsais_place_cached_suffixes(sa_sint_t * RESTRICT SA, LIBSAIS_THREA
 
 static void libsais_compact_and_place_cached_suffixes(sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j, l;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - 3, l = omp_block_start; i < j; i += 4)
@@ -406,8 +775,87 @@ static void libsais_accumulate_counts_s32_9(sa_sint_t * RESTRICT bucket00, fast_
     fast_sint_t s; for (s = 0; s < bucket_size; s += 1) { bucket00[s] = bucket00[s] + bucket01[s] + bucket02[s] + bucket03[s] + bucket04[s] + bucket05[s] + bucket06[s] + bucket07[s] + bucket08[s]; }
 }
 
+#if defined(LIBSAIS_SIMD_AVX512)
+
+static LIBSAIS_SIMD_TARGET_AVX512 void libsais_accumulate_counts_s32_avx512(sa_sint_t * RESTRICT buckets, fast_sint_t bucket_size, fast_sint_t bucket_stride, fast_sint_t num_buckets)
+{
+    fast_sint_t s, b;
+    for (s = 0; s < bucket_size - 15; s += 16)
+    {
+        __m512i sum = _mm512_loadu_si512((const void *)&buckets[s]);
+        for (b = 1; b < num_buckets; b += 1) { sum = _mm512_add_epi32(sum, _mm512_loadu_si512((const void *)&buckets[s - b * bucket_stride])); }
+        _mm512_storeu_si512((void *)&buckets[s], sum);
+    }
+
+    for (; s < bucket_size; s += 1)
+    {
+        sa_sint_t sum = buckets[s];
+        for (b = 1; b < num_buckets; b += 1) { sum += buckets[s - b * bucket_stride]; }
+        buckets[s] = sum;
+    }
+}
+
+#endif
+
+#if defined(LIBSAIS_SIMD_AVX2)
+
+static LIBSAIS_SIMD_TARGET_AVX2 void libsais_accumulate_counts_s32_avx2(sa_sint_t * RESTRICT buckets, fast_sint_t bucket_size, fast_sint_t bucket_stride, fast_sint_t num_buckets)
+{
+    fast_sint_t s, b;
+    for (s = 0; s < bucket_size - 7; s += 8)
+    {
+        __m256i sum = _mm256_loadu_si256((const __m256i *)(const void *)&buckets[s]);
+        for (b = 1; b < num_buckets; b += 1) { sum = _mm256_add_epi32(sum, _mm256_loadu_si256((const __m256i *)(const void *)&buckets[s - b * bucket_stride])); }
+        _mm256_storeu_si256((__m256i *)(void *)&buckets[s], sum);
+    }
+
+    for (; s < bucket_size; s += 1)
+    {
+        sa_sint_t sum = buckets[s];
+        for (b = 1; b < num_buckets; b += 1) { sum += buckets[s - b * bucket_stride]; }
+        buckets[s] = sum;
+    }
+}
+
+#elif defined(LIBSAIS_SIMD_NEON)
+
+static void libsais_accumulate_counts_s32_neon(sa_sint_t * RESTRICT buckets, fast_sint_t bucket_size, fast_sint_t bucket_stride, fast_sint_t num_buckets)
+{
+    fast_sint_t s, b;
+    for (s = 0; s < bucket_size - 3; s += 4)
+    {
+        int32x4_t sum = vld1q_s32(&buckets[s]);
+        for (b = 1; b < num_buckets; b += 1) { sum = vaddq_s32(sum, vld1q_s32(&buckets[s - b * bucket_stride])); }
+        vst1q_s32(&buckets[s], sum);
+    }
+
+    for (; s < bucket_size; s += 1)
+    {
+        sa_sint_t sum = buckets[s];
+        for (b = 1; b < num_buckets; b += 1) { sum += buckets[s - b * bucket_stride]; }
+        buckets[s] = sum;
+    }
+}
+
+#endif
+
 static void libsais_accumulate_counts_s32(sa_sint_t * RESTRICT buckets, fast_sint_t bucket_size, fast_sint_t bucket_stride, fast_sint_t num_buckets)
 {
+#if defined(LIBSAIS_SIMD_AVX512)
+    if (libsais_cpu_supports_avx512())
+    {
+        libsais_accumulate_counts_s32_avx512(buckets, bucket_size, bucket_stride, num_buckets); return;
+    }
+#endif
+#if defined(LIBSAIS_SIMD_AVX2)
+    if (libsais_cpu_supports_avx2())
+    {
+        libsais_accumulate_counts_s32_avx2(buckets, bucket_size, bucket_stride, num_buckets); return;
+    }
+#elif defined(LIBSAIS_SIMD_NEON)
+    libsais_accumulate_counts_s32_neon(buckets, bucket_size, bucket_stride, num_buckets); return;
+#endif
+
     while (num_buckets >= 9)
     {
         libsais_accumulate_counts_s32_9(buckets - (num_buckets - 9) * bucket_stride, bucket_size, bucket_stride); num_buckets -= 8;
@@ -502,7 +950,7 @@ static void libsais_gather_lms_suffixes_8u_omp(const uint8_t * RESTRICT T, sa_si
 
 static sa_sint_t libsais_gather_lms_suffixes_32s(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t             i   = n - 2;
     sa_sint_t             m   = n - 1;
@@ -530,7 +978,7 @@ static sa_sint_t libsais_gather_lms_suffixes_32s(const sa_sint_t * RESTRICT T, s
 
 static sa_sint_t libsais_gather_compacted_lms_suffixes_32s(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t             i   = n - 2;
     sa_sint_t             m   = n - 1;
@@ -560,7 +1008,7 @@ static sa_sint_t libsais_gather_compacted_lms_suffixes_32s(const sa_sint_t * RES
 
 static void libsais_count_lms_suffixes_32s_4k(const sa_sint_t * RESTRICT T, sa_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT buckets)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     memset(buckets, 0, 4 * (size_t)k * sizeof(sa_sint_t));
 
@@ -604,7 +1052,7 @@ static void libsais_count_lms_suffixes_32s_4k(const sa_sint_t * RESTRICT T, sa_s
 
 static void libsais_count_lms_suffixes_32s_2k(const sa_sint_t * RESTRICT T, sa_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT buckets)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     memset(buckets, 0, 2 * (size_t)k * sizeof(sa_sint_t));
 
@@ -648,7 +1096,7 @@ static void libsais_count_lms_suffixes_32s_2k(const sa_sint_t * RESTRICT T, sa_s
 
 static void libsais_count_compacted_lms_suffixes_32s_2k(const sa_sint_t * RESTRICT T, sa_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT buckets)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     memset(buckets, 0, 2 * (size_t)k * sizeof(sa_sint_t));
 
@@ -811,7 +1259,7 @@ static sa_sint_t libsais_count_and_gather_lms_suffixes_32s_4k(const sa_sint_t *
 
     if (omp_block_size > 0)
     {
-        const fast_sint_t prefetch_distance = 32;
+        const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
         fast_sint_t i, j = m + 1, c0 = T[m], c1 = -1;
 
@@ -862,7 +1310,7 @@ static sa_sint_t libsais_count_and_gather_lms_suffixes_32s_2k(const sa_sint_t *
 
     if (omp_block_size > 0)
     {
-        const fast_sint_t prefetch_distance = 32;
+        const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
         fast_sint_t i, j = m + 1, c0 = T[m], c1 = -1;
 
@@ -913,7 +1361,7 @@ static sa_sint_t libsais_count_and_gather_compacted_lms_suffixes_32s_2k(const sa
 
     if (omp_block_size > 0)
     {
-        const fast_sint_t prefetch_distance = 32;
+        const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
         fast_sint_t i, j = m + 1, c0 = T[m], c1 = -1;
 
@@ -1328,7 +1776,7 @@ static void libsais_count_and_gather_compacted_lms_suffixes_32s_2k_omp(const sa_
 
 static void libsais_count_suffixes_32s(const sa_sint_t * RESTRICT T, sa_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT buckets)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     memset(buckets, 0, (size_t)k * sizeof(sa_sint_t));
 
@@ -1384,62 +1832,264 @@ static sa_sint_t libsais_initialize_buckets_start_and_end_8u(sa_sint_t * RESTRIC
     return (sa_sint_t)(k + 1);
 }
 
-static void libsais_initialize_buckets_start_and_end_32s_6k(sa_sint_t k, sa_sint_t * RESTRICT buckets)
+#if defined(LIBSAIS_SIMD_AVX512)
+
+static LIBSAIS_SIMD_TARGET_AVX512 __m512i libsais_inclusive_scan_s32_avx512(__m512i x)
 {
-    sa_sint_t * RESTRICT bucket_start = &buckets[4 * (fast_sint_t)k];
-    sa_sint_t * RESTRICT bucket_end   = &buckets[5 * (fast_sint_t)k];
+    const __m512i zero = _mm512_setzero_si512();
 
-    fast_sint_t i, j; sa_sint_t sum = 0;
-    for (i = BUCKETS_INDEX4(0, 0), j = 0; i <= BUCKETS_INDEX4((fast_sint_t)k - 1, 0); i += BUCKETS_INDEX4(1, 0), j += 1)
-    {
-        bucket_start[j] = sum;
-        sum += buckets[i + BUCKETS_INDEX4(0, 0)] + buckets[i + BUCKETS_INDEX4(0, 1)] + buckets[i + BUCKETS_INDEX4(0, 2)] + buckets[i + BUCKETS_INDEX4(0, 3)];
-        bucket_end[j] = sum;
-    }
+    x = _mm512_add_epi32(x, _mm512_alignr_epi32(x, zero, 15));
+    x = _mm512_add_epi32(x, _mm512_alignr_epi32(x, zero, 14));
+    x = _mm512_add_epi32(x, _mm512_alignr_epi32(x, zero, 12));
+    return _mm512_add_epi32(x, _mm512_alignr_epi32(x, zero, 8));
 }
 
-static void libsais_initialize_buckets_start_and_end_32s_4k(sa_sint_t k, sa_sint_t * RESTRICT buckets)
+static LIBSAIS_SIMD_TARGET_AVX512 void libsais_initialize_buckets_start_32s_1k_avx512(sa_sint_t k, sa_sint_t * RESTRICT buckets)
 {
-    sa_sint_t * RESTRICT bucket_start = &buckets[2 * (fast_sint_t)k];
-    sa_sint_t * RESTRICT bucket_end   = &buckets[3 * (fast_sint_t)k];
+    const __m512i last = _mm512_set1_epi32(15);
 
-    fast_sint_t i, j; sa_sint_t sum = 0;
-    for (i = BUCKETS_INDEX2(0, 0), j = 0; i <= BUCKETS_INDEX2((fast_sint_t)k - 1, 0); i += BUCKETS_INDEX2(1, 0), j += 1)
-    { 
-        bucket_start[j] = sum;
-        sum += buckets[i + BUCKETS_INDEX2(0, 0)] + buckets[i + BUCKETS_INDEX2(0, 1)];
-        bucket_end[j] = sum;
-    }
-}
+    fast_sint_t i; __m512i vsum = _mm512_setzero_si512();
+    for (i = 0; i < (fast_sint_t)k - 15; i += 16)
+    {
+        __m512i count = _mm512_loadu_si512((const void *)&buckets[i]);
+        __m512i end   = _mm512_add_epi32(vsum, libsais_inclusive_scan_s32_avx512(count));
 
-static void libsais_initialize_buckets_end_32s_2k(sa_sint_t k, sa_sint_t * RESTRICT buckets)
-{
-    fast_sint_t i; sa_sint_t sum0 = 0;
-    for (i = BUCKETS_INDEX2(0, 0); i <= BUCKETS_INDEX2((fast_sint_t)k - 1, 0); i += BUCKETS_INDEX2(1, 0))
-    { 
-        sum0 += buckets[i + BUCKETS_INDEX2(0, 0)] + buckets[i + BUCKETS_INDEX2(0, 1)]; buckets[i + BUCKETS_INDEX2(0, 0)] = sum0;
+        _mm512_storeu_si512((void *)&buckets[i], _mm512_sub_epi32(end, count));
+
+        vsum = _mm512_permutexvar_epi32(last, end);
     }
+
+    sa_sint_t sum = _mm_cvtsi128_si32(_mm512_castsi512_si128(vsum));
+    for (; i < (fast_sint_t)k; i += 1) { sa_sint_t tmp = buckets[i]; buckets[i] = sum; sum += tmp; }
 }
 
-static void libsais_initialize_buckets_start_and_end_32s_2k(sa_sint_t k, sa_sint_t * RESTRICT buckets)
+static LIBSAIS_SIMD_TARGET_AVX512 void libsais_initialize_buckets_end_32s_1k_avx512(sa_sint_t k, sa_sint_t * RESTRICT buckets)
 {
-    fast_sint_t i, j;
-    for (i = BUCKETS_INDEX2(0, 0), j = 0; i <= BUCKETS_INDEX2((fast_sint_t)k - 1, 0); i += BUCKETS_INDEX2(1, 0), j += 1)
+    const __m512i last = _mm512_set1_epi32(15);
+
+    fast_sint_t i; __m512i vsum = _mm512_setzero_si512();
+    for (i = 0; i < (fast_sint_t)k - 15; i += 16)
     {
-        buckets[j] = buckets[i];
+        __m512i end = _mm512_add_epi32(vsum, libsais_inclusive_scan_s32_avx512(_mm512_loadu_si512((const void *)&buckets[i])));
+
+        _mm512_storeu_si512((void *)&buckets[i], end);
+
+        vsum = _mm512_permutexvar_epi32(last, end);
     }
 
-    buckets[k] = 0; memcpy(&buckets[k + 1], buckets, ((size_t)k - 1) * sizeof(sa_sint_t));
+    sa_sint_t sum = _mm_cvtsi128_si32(_mm512_castsi512_si128(vsum));
+    for (; i < (fast_sint_t)k; i += 1) { sum += buckets[i]; buckets[i] = sum; }
 }
 
-static void libsais_initialize_buckets_start_32s_1k(sa_sint_t k, sa_sint_t * RESTRICT buckets)
+#endif
+
+#if defined(LIBSAIS_SIMD_AVX2)
+
+static LIBSAIS_SIMD_TARGET_AVX2 __m256i libsais_inclusive_scan_s32_avx2(__m256i x)
 {
+    x = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+    x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+
+    __m256i carry = _mm256_shuffle_epi32(x, 0xff);
+    return _mm256_add_epi32(x, _mm256_permute2x128_si256(carry, carry, 0x08));
+}
+
+static LIBSAIS_SIMD_TARGET_AVX2 void libsais_initialize_buckets_start_and_end_32s_6k_avx2(sa_sint_t k, sa_sint_t * RESTRICT buckets)
+{
+    sa_sint_t * RESTRICT bucket_start = &buckets[4 * (fast_sint_t)k];
+    sa_sint_t * RESTRICT bucket_end   = &buckets[5 * (fast_sint_t)k];
+
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    const __m256i last  = _mm256_set1_epi32(7);
+
+    fast_sint_t i, j; __m256i vsum = _mm256_setzero_si256();
+    for (i = BUCKETS_INDEX4(0, 0), j = 0; j < (fast_sint_t)k - 7; i += BUCKETS_INDEX4(8, 0), j += 8)
+    {
+        __m256i h01 = _mm256_hadd_epi32(_mm256_loadu_si256((const __m256i *)(const void *)&buckets[i + BUCKETS_INDEX4(0, 0)]), _mm256_loadu_si256((const __m256i *)(const void *)&buckets[i + BUCKETS_INDEX4(2, 0)]));
+        __m256i h23 = _mm256_hadd_epi32(_mm256_loadu_si256((const __m256i *)(const void *)&buckets[i + BUCKETS_INDEX4(4, 0)]), _mm256_loadu_si256((const __m256i *)(const void *)&buckets[i + BUCKETS_INDEX4(6, 0)]));
+
+        __m256i total = _mm256_permutevar8x32_epi32(_mm256_hadd_epi32(h01, h23), order);
+        __m256i end   = _mm256_add_epi32(vsum, libsais_inclusive_scan_s32_avx2(total));
+
+        _mm256_storeu_si256((__m256i *)(void *)&bucket_start[j], _mm256_sub_epi32(end, total));
+        _mm256_storeu_si256((__m256i *)(void *)&bucket_end[j], end);
+
+        vsum = _mm256_permutevar8x32_epi32(end, last);
+    }
+
+    sa_sint_t sum = _mm_cvtsi128_si32(_mm256_castsi256_si128(vsum));
+    for (; j < (fast_sint_t)k; i += BUCKETS_INDEX4(1, 0), j += 1)
+    {
+        bucket_start[j] = sum;
+        sum += buckets[i + BUCKETS_INDEX4(0, 0)] + buckets[i + BUCKETS_INDEX4(0, 1)] + buckets[i + BUCKETS_INDEX4(0, 2)] + buckets[i + BUCKETS_INDEX4(0, 3)];
+        bucket_end[j] = sum;
+    }
+}
+
+static LIBSAIS_SIMD_TARGET_AVX2 void libsais_initialize_buckets_start_and_end_32s_4k_avx2(sa_sint_t k, sa_sint_t * RESTRICT buckets)
+{
+    sa_sint_t * RESTRICT bucket_start = &buckets[2 * (fast_sint_t)k];
+    sa_sint_t * RESTRICT bucket_end   = &buckets[3 * (fast_sint_t)k];
+
+    const __m256i last = _mm256_set1_epi32(7);
+
+    fast_sint_t i, j; __m256i vsum = _mm256_setzero_si256();
+    for (i = BUCKETS_INDEX2(0, 0), j = 0; j < (fast_sint_t)k - 7; i += BUCKETS_INDEX2(8, 0), j += 8)
+    {
+        __m256i h01   = _mm256_hadd_epi32(_mm256_loadu_si256((const __m256i *)(const void *)&buckets[i + BUCKETS_INDEX2(0, 0)]), _mm256_loadu_si256((const __m256i *)(const void *)&buckets[i + BUCKETS_INDEX2(4, 0)]));
+        __m256i total = _mm256_permute4x64_epi64(h01, 0xd8);
+        __m256i end   = _mm256_add_epi32(vsum, libsais_inclusive_scan_s32_avx2(total));
+
+        _mm256_storeu_si256((__m256i *)(void *)&bucket_start[j], _mm256_sub_epi32(end, total));
+        _mm256_storeu_si256((__m256i *)(void *)&bucket_end[j], end);
+
+        vsum = _mm256_permutevar8x32_epi32(end, last);
+    }
+
+    sa_sint_t sum = _mm_cvtsi128_si32(_mm256_castsi256_si128(vsum));
+    for (; j < (fast_sint_t)k; i += BUCKETS_INDEX2(1, 0), j += 1)
+    {
+        bucket_start[j] = sum;
+        sum += buckets[i + BUCKETS_INDEX2(0, 0)] + buckets[i + BUCKETS_INDEX2(0, 1)];
+        bucket_end[j] = sum;
+    }
+}
+
+static LIBSAIS_SIMD_TARGET_AVX2 void libsais_initialize_buckets_start_32s_1k_avx2(sa_sint_t k, sa_sint_t * RESTRICT buckets)
+{
+    const __m256i last = _mm256_set1_epi32(7);
+
+    fast_sint_t i; __m256i vsum = _mm256_setzero_si256();
+    for (i = 0; i < (fast_sint_t)k - 7; i += 8)
+    {
+        __m256i count = _mm256_loadu_si256((const __m256i *)(const void *)&buckets[i]);
+        __m256i end   = _mm256_add_epi32(vsum, libsais_inclusive_scan_s32_avx2(count));
+
+        _mm256_storeu_si256((__m256i *)(void *)&buckets[i], _mm256_sub_epi32(end, count));
+
+        vsum = _mm256_permutevar8x32_epi32(end, last);
+    }
+
+    sa_sint_t sum = _mm_cvtsi128_si32(_mm256_castsi256_si128(vsum));
+    for (; i < (fast_sint_t)k; i += 1) { sa_sint_t tmp = buckets[i]; buckets[i] = sum; sum += tmp; }
+}
+
+static LIBSAIS_SIMD_TARGET_AVX2 void libsais_initialize_buckets_end_32s_1k_avx2(sa_sint_t k, sa_sint_t * RESTRICT buckets)
+{
+    const __m256i last = _mm256_set1_epi32(7);
+
+    fast_sint_t i; __m256i vsum = _mm256_setzero_si256();
+    for (i = 0; i < (fast_sint_t)k - 7; i += 8)
+    {
+        __m256i end = _mm256_add_epi32(vsum, libsais_inclusive_scan_s32_avx2(_mm256_loadu_si256((const __m256i *)(const void *)&buckets[i])));
+
+        _mm256_storeu_si256((__m256i *)(void *)&buckets[i], end);
+
+        vsum = _mm256_permutevar8x32_epi32(end, last);
+    }
+
+    sa_sint_t sum = _mm_cvtsi128_si32(_mm256_castsi256_si128(vsum));
+    for (; i < (fast_sint_t)k; i += 1) { sum += buckets[i]; buckets[i] = sum; }
+}
+
+#endif
+
+static void libsais_initialize_buckets_start_and_end_32s_6k(sa_sint_t k, sa_sint_t * RESTRICT buckets)
+{
+#if defined(LIBSAIS_SIMD_AVX2)
+    if (libsais_cpu_supports_avx2())
+    {
+        libsais_initialize_buckets_start_and_end_32s_6k_avx2(k, buckets); return;
+    }
+#endif
+
+    sa_sint_t * RESTRICT bucket_start = &buckets[4 * (fast_sint_t)k];
+    sa_sint_t * RESTRICT bucket_end   = &buckets[5 * (fast_sint_t)k];
+
+    fast_sint_t i, j; sa_sint_t sum = 0;
+    for (i = BUCKETS_INDEX4(0, 0), j = 0; i <= BUCKETS_INDEX4((fast_sint_t)k - 1, 0); i += BUCKETS_INDEX4(1, 0), j += 1)
+    {
+        bucket_start[j] = sum;
+        sum += buckets[i + BUCKETS_INDEX4(0, 0)] + buckets[i + BUCKETS_INDEX4(0, 1)] + buckets[i + BUCKETS_INDEX4(0, 2)] + buckets[i + BUCKETS_INDEX4(0, 3)];
+        bucket_end[j] = sum;
+    }
+}
+
+static void libsais_initialize_buckets_start_and_end_32s_4k(sa_sint_t k, sa_sint_t * RESTRICT buckets)
+{
+#if defined(LIBSAIS_SIMD_AVX2)
+    if (libsais_cpu_supports_avx2())
+    {
+        libsais_initialize_buckets_start_and_end_32s_4k_avx2(k, buckets); return;
+    }
+#endif
+
+    sa_sint_t * RESTRICT bucket_start = &buckets[2 * (fast_sint_t)k];
+    sa_sint_t * RESTRICT bucket_end   = &buckets[3 * (fast_sint_t)k];
+
+    fast_sint_t i, j; sa_sint_t sum = 0;
+    for (i = BUCKETS_INDEX2(0, 0), j = 0; i <= BUCKETS_INDEX2((fast_sint_t)k - 1, 0); i += BUCKETS_INDEX2(1, 0), j += 1)
+    { 
+        bucket_start[j] = sum;
+        sum += buckets[i + BUCKETS_INDEX2(0, 0)] + buckets[i + BUCKETS_INDEX2(0, 1)];
+        bucket_end[j] = sum;
+    }
+}
+
+static void libsais_initialize_buckets_end_32s_2k(sa_sint_t k, sa_sint_t * RESTRICT buckets)
+{
+    fast_sint_t i; sa_sint_t sum0 = 0;
+    for (i = BUCKETS_INDEX2(0, 0); i <= BUCKETS_INDEX2((fast_sint_t)k - 1, 0); i += BUCKETS_INDEX2(1, 0))
+    { 
+        sum0 += buckets[i + BUCKETS_INDEX2(0, 0)] + buckets[i + BUCKETS_INDEX2(0, 1)]; buckets[i + BUCKETS_INDEX2(0, 0)] = sum0;
+    }
+}
+
+static void libsais_initialize_buckets_start_and_end_32s_2k(sa_sint_t k, sa_sint_t * RESTRICT buckets)
+{
+    fast_sint_t i, j;
+    for (i = BUCKETS_INDEX2(0, 0), j = 0; i <= BUCKETS_INDEX2((fast_sint_t)k - 1, 0); i += BUCKETS_INDEX2(1, 0), j += 1)
+    {
+        buckets[j] = buckets[i];
+    }
+
+    buckets[k] = 0; memcpy(&buckets[k + 1], buckets, ((size_t)k - 1) * sizeof(sa_sint_t));
+}
+
+static void libsais_initialize_buckets_start_32s_1k(sa_sint_t k, sa_sint_t * RESTRICT buckets)
+{
+#if defined(LIBSAIS_SIMD_AVX512)
+    if (libsais_cpu_supports_avx512())
+    {
+        libsais_initialize_buckets_start_32s_1k_avx512(k, buckets); return;
+    }
+#endif
+#if defined(LIBSAIS_SIMD_AVX2)
+    if (libsais_cpu_supports_avx2())
+    {
+        libsais_initialize_buckets_start_32s_1k_avx2(k, buckets); return;
+    }
+#endif
+
     fast_sint_t i; sa_sint_t sum = 0;
     for (i = 0; i <= (fast_sint_t)k - 1; i += 1) { sa_sint_t tmp = buckets[i]; buckets[i] = sum; sum += tmp; }
 }
 
 static void libsais_initialize_buckets_end_32s_1k(sa_sint_t k, sa_sint_t * RESTRICT buckets)
 {
+#if defined(LIBSAIS_SIMD_AVX512)
+    if (libsais_cpu_supports_avx512())
+    {
+        libsais_initialize_buckets_end_32s_1k_avx512(k, buckets); return;
+    }
+#endif
+#if defined(LIBSAIS_SIMD_AVX2)
+    if (libsais_cpu_supports_avx2())
+    {
+        libsais_initialize_buckets_end_32s_1k_avx2(k, buckets); return;
+    }
+#endif
+
     fast_sint_t i; sa_sint_t sum = 0;
     for (i = 0; i <= (fast_sint_t)k - 1; i += 1) { sum += buckets[i]; buckets[i] = sum; }
 }
@@ -1541,7 +2191,7 @@ static void libsais_initialize_buckets_for_radix_and_partial_sorting_32s_4k(cons
 
 static void libsais_radix_sort_lms_suffixes_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 3; i >= j; i -= 4)
@@ -1615,7 +2265,7 @@ static void libsais_radix_sort_lms_suffixes_8u_omp(const uint8_t * RESTRICT T, s
 
 static void libsais_radix_sort_lms_suffixes_32s_6k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + 2 * prefetch_distance + 3; i >= j; i -= 4)
@@ -1646,7 +2296,7 @@ static void libsais_radix_sort_lms_suffixes_32s_6k(const sa_sint_t * RESTRICT T,
 
 static void libsais_radix_sort_lms_suffixes_32s_2k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + 2 * prefetch_distance + 3; i >= j; i -= 4)
@@ -1679,7 +2329,7 @@ static void libsais_radix_sort_lms_suffixes_32s_2k(const sa_sint_t * RESTRICT T,
 
 static void libsais_radix_sort_lms_suffixes_32s_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
@@ -1707,7 +2357,7 @@ static void libsais_radix_sort_lms_suffixes_32s_block_gather(const sa_sint_t * R
 
 static void libsais_radix_sort_lms_suffixes_32s_6k_block_sort(sa_sint_t * RESTRICT induction_bucket, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 3; i >= j; i -= 4)
@@ -1733,7 +2383,7 @@ static void libsais_radix_sort_lms_suffixes_32s_6k_block_sort(sa_sint_t * RESTRI
 
 static void libsais_radix_sort_lms_suffixes_32s_2k_block_sort(sa_sint_t * RESTRICT induction_bucket, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 3; i >= j; i -= 4)
@@ -1869,7 +2519,9 @@ static void libsais_radix_sort_lms_suffixes_32s_6k_omp(const sa_sint_t * RESTRIC
         fast_sint_t block_start, block_end;
         for (block_start = 0; block_start < (fast_sint_t)m - 1; block_start = block_end)
         {
-            block_end = block_start + (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end >= m) { block_end = (fast_sint_t)m - 1; }
+            if (libsais_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start + (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end >= m) { block_end = (fast_sint_t)m - 1; }
 
             libsais_radix_sort_lms_suffixes_32s_6k_block_omp(T, SA, induction_bucket, thread_state[0].state.cache, (fast_sint_t)n - block_end, block_end - block_start, threads);
         }
@@ -1891,7 +2543,9 @@ static void libsais_radix_sort_lms_suffixes_32s_2k_omp(const sa_sint_t * RESTRIC
         fast_sint_t block_start, block_end;
         for (block_start = 0; block_start < (fast_sint_t)m - 1; block_start = block_end)
         {
-            block_end = block_start + (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end >= m) { block_end = (fast_sint_t)m - 1; }
+            if (libsais_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start + (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end >= m) { block_end = (fast_sint_t)m - 1; }
 
             libsais_radix_sort_lms_suffixes_32s_2k_block_omp(T, SA, induction_bucket, thread_state[0].state.cache, (fast_sint_t)n - block_end, block_end - block_start, threads);
         }
@@ -1903,7 +2557,7 @@ static void libsais_radix_sort_lms_suffixes_32s_2k_omp(const sa_sint_t * RESTRIC
 
 static sa_sint_t libsais_radix_sort_lms_suffixes_32s_1k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t * RESTRICT buckets)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t             i = n - 2;
     sa_sint_t             m = 0;
@@ -1950,7 +2604,7 @@ static sa_sint_t libsais_radix_sort_lms_suffixes_32s_1k(const sa_sint_t * RESTRI
 
 static void libsais_radix_sort_set_markers_32s_6k(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
@@ -1976,7 +2630,7 @@ static void libsais_radix_sort_set_markers_32s_6k(sa_sint_t * RESTRICT SA, sa_si
 
 static void libsais_radix_sort_set_markers_32s_4k(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
@@ -2109,7 +2763,7 @@ static void libsais_initialize_buckets_for_partial_sorting_32s_6k(const sa_sint_
 
 static sa_sint_t libsais_partial_sorting_scan_left_to_right_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, sa_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[4 * ALPHABET_SIZE];
     sa_sint_t * RESTRICT distinct_names   = &buckets[2 * ALPHABET_SIZE];
@@ -2144,7 +2798,7 @@ static sa_sint_t libsais_partial_sorting_scan_left_to_right_8u(const uint8_t * R
 
 static void libsais_partial_sorting_scan_left_to_right_8u_block_prepare(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size, LIBSAIS_THREAD_STATE * RESTRICT state)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[0 * ALPHABET_SIZE];
     sa_sint_t * RESTRICT distinct_names   = &buckets[2 * ALPHABET_SIZE];
@@ -2177,7 +2831,7 @@ static void libsais_partial_sorting_scan_left_to_right_8u_block_prepare(const ui
 
 static void libsais_partial_sorting_scan_left_to_right_8u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count, sa_sint_t d)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[0 * ALPHABET_SIZE];
     sa_sint_t * RESTRICT distinct_names   = &buckets[2 * ALPHABET_SIZE];
@@ -2292,7 +2946,9 @@ static sa_sint_t libsais_partial_sorting_scan_left_to_right_8u_omp(const uint8_t
             }
             else
             {
-                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end > left_suffixes_count) { block_max_end = left_suffixes_count;}
+                if (libsais_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end > left_suffixes_count) { block_max_end = left_suffixes_count;}
                 fast_sint_t block_end     = block_start + 1; while (block_end < block_max_end && SA[block_end] != 0) { block_end++; }
                 fast_sint_t block_size    = block_end - block_start;
 
@@ -2321,7 +2977,7 @@ static sa_sint_t libsais_partial_sorting_scan_left_to_right_8u_omp(const uint8_t
 
 static sa_sint_t libsais_partial_sorting_scan_left_to_right_32s_6k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, sa_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - 2 * prefetch_distance - 1; i < j; i += 2)
@@ -2354,7 +3010,7 @@ static sa_sint_t libsais_partial_sorting_scan_left_to_right_32s_6k(const sa_sint
 
 static sa_sint_t libsais_partial_sorting_scan_left_to_right_32s_4k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, sa_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[2 * (fast_sint_t)k];
     sa_sint_t * RESTRICT distinct_names   = &buckets[0 * (fast_sint_t)k];
@@ -2399,7 +3055,7 @@ static sa_sint_t libsais_partial_sorting_scan_left_to_right_32s_4k(const sa_sint
 
 static void libsais_partial_sorting_scan_left_to_right_32s_1k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - 2 * prefetch_distance - 1; i < j; i += 2)
@@ -2425,7 +3081,7 @@ static void libsais_partial_sorting_scan_left_to_right_32s_1k(const sa_sint_t *
 
 static void libsais_partial_sorting_scan_left_to_right_32s_6k_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -2451,7 +3107,7 @@ static void libsais_partial_sorting_scan_left_to_right_32s_6k_block_gather(const
 
 static void libsais_partial_sorting_scan_left_to_right_32s_4k_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -2475,7 +3131,7 @@ static void libsais_partial_sorting_scan_left_to_right_32s_4k_block_gather(const
 
 static void libsais_partial_sorting_scan_left_to_right_32s_1k_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -2499,7 +3155,7 @@ static void libsais_partial_sorting_scan_left_to_right_32s_1k_block_gather(const
 
 static sa_sint_t libsais_partial_sorting_scan_left_to_right_32s_6k_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT buckets, sa_sint_t d, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j, omp_block_end = omp_block_start + omp_block_size;
     for (i = omp_block_start, j = omp_block_end - prefetch_distance - 1; i < j; i += 2)
@@ -2527,7 +3183,7 @@ static sa_sint_t libsais_partial_sorting_scan_left_to_right_32s_6k_block_sort(co
 
 static sa_sint_t libsais_partial_sorting_scan_left_to_right_32s_4k_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t k, sa_sint_t * RESTRICT buckets, sa_sint_t d, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[2 * (fast_sint_t)k];
     sa_sint_t * RESTRICT distinct_names   = &buckets[0 * (fast_sint_t)k];
@@ -2570,7 +3226,7 @@ static sa_sint_t libsais_partial_sorting_scan_left_to_right_32s_4k_block_sort(co
 
 static void libsais_partial_sorting_scan_left_to_right_32s_1k_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT induction_bucket, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j, omp_block_end = omp_block_start + omp_block_size;
     for (i = omp_block_start, j = omp_block_end - prefetch_distance - 1; i < j; i += 2)
@@ -2774,7 +3430,9 @@ static sa_sint_t libsais_partial_sorting_scan_left_to_right_32s_6k_omp(const sa_
         fast_sint_t block_start, block_end;
         for (block_start = 0; block_start < left_suffixes_count; block_start = block_end)
         {
-            block_end = block_start + (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end > left_suffixes_count) { block_end = left_suffixes_count; }
+            if (libsais_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start + (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end > left_suffixes_count) { block_end = left_suffixes_count; }
 
             d = libsais_partial_sorting_scan_left_to_right_32s_6k_block_omp(T, SA, buckets, d, thread_state[0].state.cache, block_start, block_end - block_start, threads);
         }
@@ -2804,7 +3462,9 @@ static sa_sint_t libsais_partial_sorting_scan_left_to_right_32s_4k_omp(const sa_
         fast_sint_t block_start, block_end;
         for (block_start = 0; block_start < n; block_start = block_end)
         {
-            block_end = block_start + (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end > n) { block_end = n; }
+            if (libsais_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start + (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end > n) { block_end = n; }
 
             d = libsais_partial_sorting_scan_left_to_right_32s_4k_block_omp(T, SA, k, buckets, d, thread_state[0].state.cache, block_start, block_end - block_start, threads);
         }
@@ -2830,7 +3490,9 @@ static void libsais_partial_sorting_scan_left_to_right_32s_1k_omp(const sa_sint_
         fast_sint_t block_start, block_end;
         for (block_start = 0; block_start < n; block_start = block_end)
         {
-            block_end = block_start + (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end > n) { block_end = n; }
+            if (libsais_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start + (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end > n) { block_end = n; }
 
             libsais_partial_sorting_scan_left_to_right_32s_1k_block_omp(T, SA, buckets, thread_state[0].state.cache, block_start, block_end - block_start, threads);
         }
@@ -2842,7 +3504,7 @@ static void libsais_partial_sorting_scan_left_to_right_32s_1k_omp(const sa_sint_
 
 static void libsais_partial_sorting_shift_markers_8u_omp(sa_sint_t * RESTRICT SA, sa_sint_t n, const sa_sint_t * RESTRICT buckets, sa_sint_t threads)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     const sa_sint_t * RESTRICT temp_bucket = &buckets[4 * ALPHABET_SIZE];
 
@@ -2875,7 +3537,7 @@ static void libsais_partial_sorting_shift_markers_8u_omp(sa_sint_t * RESTRICT SA
 
 static void libsais_partial_sorting_shift_markers_32s_6k_omp(sa_sint_t * RESTRICT SA, sa_sint_t k, const sa_sint_t * RESTRICT buckets, sa_sint_t threads)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     const sa_sint_t * RESTRICT temp_bucket = &buckets[4 * (fast_sint_t)k];
     
@@ -2908,7 +3570,7 @@ static void libsais_partial_sorting_shift_markers_32s_6k_omp(sa_sint_t * RESTRIC
 
 static void libsais_partial_sorting_shift_markers_32s_4k(sa_sint_t * RESTRICT SA, sa_sint_t n)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i; sa_sint_t s = SUFFIX_GROUP_MARKER;
     for (i = (fast_sint_t)n - 1; i >= 3; i -= 4)
@@ -2941,7 +3603,7 @@ static void libsais_partial_sorting_shift_buckets_32s_6k(sa_sint_t k, sa_sint_t
 
 static sa_sint_t libsais_partial_sorting_scan_right_to_left_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, sa_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[0 * ALPHABET_SIZE];
     sa_sint_t * RESTRICT distinct_names   = &buckets[2 * ALPHABET_SIZE];
@@ -2976,7 +3638,7 @@ static sa_sint_t libsais_partial_sorting_scan_right_to_left_8u(const uint8_t * R
 
 static void libsais_partial_sorting_scan_right_to_left_8u_block_prepare(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size, LIBSAIS_THREAD_STATE * RESTRICT state)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[0 * ALPHABET_SIZE];
     sa_sint_t * RESTRICT distinct_names   = &buckets[2 * ALPHABET_SIZE];
@@ -3009,7 +3671,7 @@ static void libsais_partial_sorting_scan_right_to_left_8u_block_prepare(const ui
 
 static void libsais_partial_sorting_scan_right_to_left_8u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count, sa_sint_t d)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[0 * ALPHABET_SIZE];
     sa_sint_t * RESTRICT distinct_names   = &buckets[2 * ALPHABET_SIZE];
@@ -3124,7 +3786,9 @@ static void libsais_partial_sorting_scan_right_to_left_8u_omp(const uint8_t * RE
             }
             else
             {
-                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end < scan_start) { block_max_end = scan_start - 1; }
+                if (libsais_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end < scan_start) { block_max_end = scan_start - 1; }
                 fast_sint_t block_end     = block_start - 1; while (block_end > block_max_end && SA[block_end] != 0) { block_end--; }
                 fast_sint_t block_size    = block_start - block_end;
 
@@ -3151,7 +3815,7 @@ static void libsais_partial_sorting_scan_right_to_left_8u_omp(const uint8_t * RE
 
 static sa_sint_t libsais_partial_sorting_scan_right_to_left_32s_6k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, sa_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + 2 * prefetch_distance + 1; i >= j; i -= 2)
@@ -3184,7 +3848,7 @@ static sa_sint_t libsais_partial_sorting_scan_right_to_left_32s_6k(const sa_sint
 
 static sa_sint_t libsais_partial_sorting_scan_right_to_left_32s_4k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, sa_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[3 * (fast_sint_t)k];
     sa_sint_t * RESTRICT distinct_names   = &buckets[0 * (fast_sint_t)k];
@@ -3229,7 +3893,7 @@ static sa_sint_t libsais_partial_sorting_scan_right_to_left_32s_4k(const sa_sint
 
 static void libsais_partial_sorting_scan_right_to_left_32s_1k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + 2 * prefetch_distance + 1; i >= j; i -= 2)
@@ -3255,7 +3919,7 @@ static void libsais_partial_sorting_scan_right_to_left_32s_1k(const sa_sint_t *
 
 static void libsais_partial_sorting_scan_right_to_left_32s_6k_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -3281,7 +3945,7 @@ static void libsais_partial_sorting_scan_right_to_left_32s_6k_block_gather(const
 
 static void libsais_partial_sorting_scan_right_to_left_32s_4k_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -3305,7 +3969,7 @@ static void libsais_partial_sorting_scan_right_to_left_32s_4k_block_gather(const
 
 static void libsais_partial_sorting_scan_right_to_left_32s_1k_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -3329,7 +3993,7 @@ static void libsais_partial_sorting_scan_right_to_left_32s_1k_block_gather(const
 
 static sa_sint_t libsais_partial_sorting_scan_right_to_left_32s_6k_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT buckets, sa_sint_t d, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
@@ -3357,7 +4021,7 @@ static sa_sint_t libsais_partial_sorting_scan_right_to_left_32s_6k_block_sort(co
 
 static sa_sint_t libsais_partial_sorting_scan_right_to_left_32s_4k_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t k, sa_sint_t * RESTRICT buckets, sa_sint_t d, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[3 * (fast_sint_t)k];
     sa_sint_t * RESTRICT distinct_names   = &buckets[0 * (fast_sint_t)k];
@@ -3400,7 +4064,7 @@ static sa_sint_t libsais_partial_sorting_scan_right_to_left_32s_4k_block_sort(co
 
 static void libsais_partial_sorting_scan_right_to_left_32s_1k_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT induction_bucket, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
@@ -3604,7 +4268,9 @@ static sa_sint_t libsais_partial_sorting_scan_right_to_left_32s_6k_omp(const sa_
         fast_sint_t block_start, block_end;
         for (block_start = scan_end - 1; block_start >= scan_start; block_start = block_end)
         {
-            block_end = block_start - (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end < scan_start) { block_end = scan_start - 1; }
+            if (libsais_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start - (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end < scan_start) { block_end = scan_start - 1; }
 
             d = libsais_partial_sorting_scan_right_to_left_32s_6k_block_omp(T, SA, buckets, d, thread_state[0].state.cache, block_end + 1, block_start - block_end, threads);
         }
@@ -3628,7 +4294,9 @@ static sa_sint_t libsais_partial_sorting_scan_right_to_left_32s_4k_omp(const sa_
         fast_sint_t block_start, block_end;
         for (block_start = (fast_sint_t)n - 1; block_start >= 0; block_start = block_end)
         {
-            block_end = block_start - (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end < 0) { block_end = -1; }
+            if (libsais_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start - (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end < 0) { block_end = -1; }
 
             d = libsais_partial_sorting_scan_right_to_left_32s_4k_block_omp(T, SA, k, buckets, d, thread_state[0].state.cache, block_end + 1, block_start - block_end, threads);
         }
@@ -3652,7 +4320,9 @@ static void libsais_partial_sorting_scan_right_to_left_32s_1k_omp(const sa_sint_
         fast_sint_t block_start, block_end;
         for (block_start = (fast_sint_t)n - 1; block_start >= 0; block_start = block_end)
         {
-            block_end = block_start - (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end < 0) { block_end = -1; }
+            if (libsais_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start - (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end < 0) { block_end = -1; }
 
             libsais_partial_sorting_scan_right_to_left_32s_1k_block_omp(T, SA, buckets, thread_state[0].state.cache, block_end + 1, block_start - block_end, threads);
         }
@@ -3664,7 +4334,7 @@ static void libsais_partial_sorting_scan_right_to_left_32s_1k_omp(const sa_sint_
 
 static fast_sint_t libsais_partial_sorting_gather_lms_suffixes_32s_4k(sa_sint_t * RESTRICT SA, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j, l;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - 3, l = omp_block_start; i < j; i += 4)
@@ -3687,7 +4357,7 @@ static fast_sint_t libsais_partial_sorting_gather_lms_suffixes_32s_4k(sa_sint_t
 
 static fast_sint_t libsais_partial_sorting_gather_lms_suffixes_32s_1k(sa_sint_t * RESTRICT SA, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j, l;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - 3, l = omp_block_start; i < j; i += 4)
@@ -3859,7 +4529,7 @@ static void libsais_induce_partial_order_32s_1k_omp(const sa_sint_t * RESTRICT T
 
 static sa_sint_t libsais_renumber_lms_suffixes_8u(sa_sint_t * RESTRICT SA, sa_sint_t m, sa_sint_t name, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAm = &SA[m];
 
@@ -3889,7 +4559,7 @@ static sa_sint_t libsais_renumber_lms_suffixes_8u(sa_sint_t * RESTRICT SA, sa_si
 
 static fast_sint_t libsais_gather_marked_lms_suffixes(sa_sint_t * RESTRICT SA, sa_sint_t m, fast_sint_t l, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     l -= 1;
 
@@ -4043,7 +4713,7 @@ static sa_sint_t libsais_renumber_and_gather_lms_suffixes_omp(sa_sint_t * RESTRI
 
 static sa_sint_t libsais_renumber_distinct_lms_suffixes_32s_4k(sa_sint_t * RESTRICT SA, sa_sint_t m, sa_sint_t name, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAm = &SA[m];
 
@@ -4073,7 +4743,7 @@ static sa_sint_t libsais_renumber_distinct_lms_suffixes_32s_4k(sa_sint_t * RESTR
 
 static void libsais_mark_distinct_lms_suffixes_32s(sa_sint_t * RESTRICT SA, sa_sint_t m, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j; sa_sint_t p0, p1, p2, p3 = 0;
     for (i = (fast_sint_t)m + omp_block_start, j = (fast_sint_t)m + omp_block_start + omp_block_size - 3; i < j; i += 4)
@@ -4094,7 +4764,7 @@ static void libsais_mark_distinct_lms_suffixes_32s(sa_sint_t * RESTRICT SA, sa_s
 
 static void libsais_clamp_lms_suffixes_length_32s(sa_sint_t * RESTRICT SA, sa_sint_t m, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAm = &SA[m];
 
@@ -4225,7 +4895,7 @@ static sa_sint_t libsais_renumber_and_mark_distinct_lms_suffixes_32s_4k_omp(sa_s
 
 static sa_sint_t libsais_renumber_and_mark_distinct_lms_suffixes_32s_1k_omp(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t m, sa_sint_t threads)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAm = &SA[m];
 
@@ -4304,7 +4974,7 @@ static sa_sint_t libsais_renumber_and_mark_distinct_lms_suffixes_32s_1k_omp(sa_s
 
 static void libsais_reconstruct_lms_suffixes(sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t m, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     const sa_sint_t * RESTRICT SAnm = &SA[n - m];
 
@@ -4427,7 +5097,7 @@ static void libsais_place_lms_suffixes_interval_32s_2k(sa_sint_t * RESTRICT SA,
 
 static void libsais_place_lms_suffixes_interval_32s_1k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t m, sa_sint_t * RESTRICT buckets)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t c = k - 1; fast_sint_t i, l = buckets[c];
     for (i = (fast_sint_t)m - 1; i >= prefetch_distance + 3; i -= 4)
@@ -4527,7 +5197,7 @@ static void libsais_place_lms_suffixes_histogram_32s_2k(sa_sint_t * RESTRICT SA,
 
 static void libsais_final_bwt_scan_left_to_right_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -4549,7 +5219,7 @@ static void libsais_final_bwt_scan_left_to_right_8u(const uint8_t * RESTRICT T,
 
 static void libsais_final_bwt_aux_scan_left_to_right_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -4569,9 +5239,31 @@ static void libsais_final_bwt_aux_scan_left_to_right_8u(const uint8_t * RESTRICT
     }
 }
 
+static void libsais_final_bwt_aux_sa_scan_left_to_right_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
+    {
+        libsais_prefetchw(&SA[i + 2 * prefetch_distance]);
+
+        sa_sint_t s0 = SA[i + prefetch_distance + 0]; const uint8_t * Ts0 = &T[s0] - 1; libsais_prefetchr(s0 > 0 ? Ts0 : NULL); Ts0--; libsais_prefetchr(s0 > 0 ? Ts0 : NULL);
+        sa_sint_t s1 = SA[i + prefetch_distance + 1]; const uint8_t * Ts1 = &T[s1] - 1; libsais_prefetchr(s1 > 0 ? Ts1 : NULL); Ts1--; libsais_prefetchr(s1 > 0 ? Ts1 : NULL);
+
+        sa_sint_t p0 = SA[i + 0]; SA[i + 0] = p0 & SAINT_MAX; if (p0 > 0) { p0--; SA[i + 0] = T[p0] | SAINT_MIN; sa_sint_t d0 = induction_bucket[T[p0]]++; SA[d0] = p0 | ((sa_sint_t)(T[p0 - (p0 > 0)] < T[p0]) << (SAINT_BIT - 1)); if ((p0 & rm) == 0) { I[p0 / (rm + 1)] = d0 + 1; } if ((d0 & rm) == 0) { S[d0 / (rm + 1)] = p0; } }
+        sa_sint_t p1 = SA[i + 1]; SA[i + 1] = p1 & SAINT_MAX; if (p1 > 0) { p1--; SA[i + 1] = T[p1] | SAINT_MIN; sa_sint_t d1 = induction_bucket[T[p1]]++; SA[d1] = p1 | ((sa_sint_t)(T[p1 - (p1 > 0)] < T[p1]) << (SAINT_BIT - 1)); if ((p1 & rm) == 0) { I[p1 / (rm + 1)] = d1 + 1; } if ((d1 & rm) == 0) { S[d1 / (rm + 1)] = p1; } }
+    }
+
+    for (j += prefetch_distance + 1; i < j; i += 1)
+    {
+        sa_sint_t p = SA[i]; SA[i] = p & SAINT_MAX; if (p > 0) { p--; SA[i] = T[p] | SAINT_MIN; sa_sint_t d = induction_bucket[T[p]]++; SA[d] = p | ((sa_sint_t)(T[p - (p > 0)] < T[p]) << (SAINT_BIT - 1)); if ((p & rm) == 0) { I[p / (rm + 1)] = d + 1; } if ((d & rm) == 0) { S[d / (rm + 1)] = p; } }
+    }
+}
+
 static void libsais_final_sorting_scan_left_to_right_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -4593,7 +5285,7 @@ static void libsais_final_sorting_scan_left_to_right_8u(const uint8_t * RESTRICT
 
 static void libsais_final_sorting_scan_left_to_right_32s(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - 2 * prefetch_distance - 1; i < j; i += 2)
@@ -4619,7 +5311,7 @@ static void libsais_final_sorting_scan_left_to_right_32s(const sa_sint_t * RESTR
 
 static fast_sint_t libsais_final_bwt_scan_left_to_right_8u_block_prepare(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-   const fast_sint_t prefetch_distance = 32;
+   const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
    memset(buckets, 0, k * sizeof(sa_sint_t));
 
@@ -4645,7 +5337,7 @@ static fast_sint_t libsais_final_bwt_scan_left_to_right_8u_block_prepare(const u
 
 static fast_sint_t libsais_final_sorting_scan_left_to_right_8u_block_prepare(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-   const fast_sint_t prefetch_distance = 32;
+   const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
    memset(buckets, 0, k * sizeof(sa_sint_t));
 
@@ -4671,7 +5363,7 @@ static fast_sint_t libsais_final_sorting_scan_left_to_right_8u_block_prepare(con
 
 static void libsais_final_order_scan_left_to_right_8u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = 0, j = count - 3; i < j; i += 4)
@@ -4692,7 +5384,7 @@ static void libsais_final_order_scan_left_to_right_8u_block_place(sa_sint_t * RE
 
 static void libsais_final_bwt_aux_scan_left_to_right_8u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = 0, j = count - 3; i < j; i += 4)
@@ -4711,9 +5403,28 @@ static void libsais_final_bwt_aux_scan_left_to_right_8u_block_place(sa_sint_t *
     }
 }
 
+static void libsais_final_bwt_aux_sa_scan_left_to_right_8u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = 0, j = count - 1; i < j; i += 2)
+    {
+        libsais_prefetchr(&cache[i + prefetch_distance]);
+
+        sa_sint_t d0 = buckets[cache[i + 0].symbol]++; sa_sint_t p0 = cache[i + 0].index; SA[d0] = p0; p0 &= SAINT_MAX; if ((p0 & rm) == 0) { I[p0 / (rm + 1)] = d0 + 1; } if ((d0 & rm) == 0) { S[d0 / (rm + 1)] = p0; }
+        sa_sint_t d1 = buckets[cache[i + 1].symbol]++; sa_sint_t p1 = cache[i + 1].index; SA[d1] = p1; p1 &= SAINT_MAX; if ((p1 & rm) == 0) { I[p1 / (rm + 1)] = d1 + 1; } if ((d1 & rm) == 0) { S[d1 / (rm + 1)] = p1; }
+    }
+
+    for (j += 1; i < j; i += 1)
+    {
+        sa_sint_t d = buckets[cache[i].symbol]++; sa_sint_t p = cache[i].index; SA[d] = p; p &= SAINT_MAX; if ((p & rm) == 0) { I[p / (rm + 1)] = d + 1; } if ((d & rm) == 0) { S[d / (rm + 1)] = p; }
+    }
+}
+
 static void libsais_final_sorting_scan_left_to_right_32s_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -4737,7 +5448,7 @@ static void libsais_final_sorting_scan_left_to_right_32s_block_gather(const sa_s
 
 static void libsais_final_sorting_scan_left_to_right_32s_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT induction_bucket, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j, omp_block_end = omp_block_start + omp_block_size;
     for (i = omp_block_start, j = omp_block_end - prefetch_distance - 1; i < j; i += 2)
@@ -4881,6 +5592,60 @@ static void libsais_final_bwt_aux_scan_left_to_right_8u_block_omp(const uint8_t
     }
 }
 
+static void libsais_final_bwt_aux_sa_scan_left_to_right_8u_block_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT induction_bucket, fast_sint_t block_start, fast_sint_t block_size, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && block_size >= 64 * (k > 256 ? k : 256) && omp_get_dynamic() == 0)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(k); UNUSED(threads); UNUSED(thread_state);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (block_size / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : block_size - omp_block_start;
+
+        omp_block_start += block_start;
+
+        if (omp_num_threads == 1)
+        {
+            libsais_final_bwt_aux_sa_scan_left_to_right_8u(T, SA, rm, I, S, induction_bucket, omp_block_start, omp_block_size);
+        }
+#if defined(LIBSAIS_OPENMP)
+        else
+        {
+            {
+                thread_state[omp_thread_num].state.count = libsais_final_bwt_scan_left_to_right_8u_block_prepare(T, SA, k, thread_state[omp_thread_num].state.buckets, thread_state[omp_thread_num].state.cache, omp_block_start, omp_block_size);
+            }
+
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                fast_sint_t t;
+                for (t = 0; t < omp_num_threads; ++t)
+                {
+                    sa_sint_t * RESTRICT temp_bucket = thread_state[t].state.buckets;
+                    fast_sint_t c; for (c = 0; c < k; c += 1) { sa_sint_t A = induction_bucket[c], B = temp_bucket[c]; induction_bucket[c] = A + B; temp_bucket[c] = A; }
+                }
+            }
+
+            #pragma omp barrier
+
+            {
+                libsais_final_bwt_aux_sa_scan_left_to_right_8u_block_place(SA, rm, I, S, thread_state[omp_thread_num].state.buckets, thread_state[omp_thread_num].state.cache, thread_state[omp_thread_num].state.count);
+            }
+        }
+#endif
+    }
+}
+
 static void libsais_final_sorting_scan_left_to_right_8u_block_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT induction_bucket, fast_sint_t block_start, fast_sint_t block_size, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
 #if defined(LIBSAIS_OPENMP)
@@ -5006,7 +5771,9 @@ static void libsais_final_bwt_scan_left_to_right_8u_omp(const uint8_t * RESTRICT
             }
             else
             {
-                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
+                if (libsais_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
                 fast_sint_t block_end     = block_start + 1; while (block_end < block_max_end && SA[block_end] != 0) { block_end++; }
                 fast_sint_t block_size    = block_end - block_start;
 
@@ -5052,7 +5819,9 @@ static void libsais_final_bwt_aux_scan_left_to_right_8u_omp(const uint8_t * REST
             }
             else
             {
-                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
+                if (libsais_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
                 fast_sint_t block_end     = block_start + 1; while (block_end < block_max_end && SA[block_end] != 0) { block_end++; }
                 fast_sint_t block_size    = block_end - block_start;
 
@@ -5076,13 +5845,16 @@ static void libsais_final_bwt_aux_scan_left_to_right_8u_omp(const uint8_t * REST
 #endif
 }
 
-static void libsais_final_sorting_scan_left_to_right_8u_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, fast_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+static void libsais_final_bwt_aux_sa_scan_left_to_right_8u_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, fast_sint_t n, sa_sint_t k, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
     SA[induction_bucket[T[(sa_sint_t)n - 1]]++] = ((sa_sint_t)n - 1) | ((sa_sint_t)(T[(sa_sint_t)n - 2] < T[(sa_sint_t)n - 1]) << (SAINT_BIT - 1));
 
+    if ((((sa_sint_t)n - 1) & rm) == 0) { I[((sa_sint_t)n - 1) / (rm + 1)] = induction_bucket[T[(sa_sint_t)n - 1]]; }
+    if (((induction_bucket[T[(sa_sint_t)n - 1]] - 1) & rm) == 0) { S[(induction_bucket[T[(sa_sint_t)n - 1]] - 1) / (rm + 1)] = (sa_sint_t)n - 1; }
+
     if (threads == 1 || n < 65536)
     {
-        libsais_final_sorting_scan_left_to_right_8u(T, SA, induction_bucket, 0, n);
+        libsais_final_bwt_aux_sa_scan_left_to_right_8u(T, SA, rm, I, S, induction_bucket, 0, n);
     }
 #if defined(LIBSAIS_OPENMP)
     else
@@ -5096,7 +5868,9 @@ static void libsais_final_sorting_scan_left_to_right_8u_omp(const uint8_t * REST
             }
             else
             {
-                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
+                if (libsais_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
                 fast_sint_t block_end     = block_start + 1; while (block_end < block_max_end && SA[block_end] != 0) { block_end++; }
                 fast_sint_t block_size    = block_end - block_start;
 
@@ -5104,12 +5878,12 @@ static void libsais_final_sorting_scan_left_to_right_8u_omp(const uint8_t * REST
                 {
                     for (; block_start < block_end; block_start += 1)
                     {
-                        sa_sint_t p = SA[block_start]; SA[block_start] = p ^ SAINT_MIN; if (p > 0) { p--; SA[induction_bucket[T[p]]++] = p | ((sa_sint_t)(T[p - (p > 0)] < T[p]) << (SAINT_BIT - 1)); }
+                        sa_sint_t p = SA[block_start]; SA[block_start] = p & SAINT_MAX; if (p > 0) { p--; SA[block_start] = T[p] | SAINT_MIN; sa_sint_t d = induction_bucket[T[p]]++; SA[d] = p | ((sa_sint_t)(T[p - (p > 0)] < T[p]) << (SAINT_BIT - 1)); if ((p & rm) == 0) { I[p / (rm + 1)] = d + 1; } if ((d & rm) == 0) { S[d / (rm + 1)] = p; } }
                     }
                 }
                 else
                 {
-                    libsais_final_sorting_scan_left_to_right_8u_block_omp(T, SA, k, induction_bucket, block_start, block_size, threads, thread_state);
+                    libsais_final_bwt_aux_sa_scan_left_to_right_8u_block_omp(T, SA, k, rm, I, S, induction_bucket, block_start, block_size, threads, thread_state);
                     block_start = block_end;
                 }
             }
@@ -5120,33 +5894,81 @@ static void libsais_final_sorting_scan_left_to_right_8u_omp(const uint8_t * REST
 #endif
 }
 
-static void libsais_final_sorting_scan_left_to_right_32s_omp(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+static void libsais_final_sorting_scan_left_to_right_8u_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, fast_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
-    SA[induction_bucket[T[n - 1]]++] = (n - 1) | ((sa_sint_t)(T[n - 2] < T[n - 1]) << (SAINT_BIT - 1));
+    SA[induction_bucket[T[(sa_sint_t)n - 1]]++] = ((sa_sint_t)n - 1) | ((sa_sint_t)(T[(sa_sint_t)n - 2] < T[(sa_sint_t)n - 1]) << (SAINT_BIT - 1));
 
     if (threads == 1 || n < 65536)
     {
-        libsais_final_sorting_scan_left_to_right_32s(T, SA, induction_bucket, 0, n);
+        libsais_final_sorting_scan_left_to_right_8u(T, SA, induction_bucket, 0, n);
     }
 #if defined(LIBSAIS_OPENMP)
     else
     {
-        fast_sint_t block_start, block_end;
-        for (block_start = 0; block_start < n; block_start = block_end)
+        fast_sint_t block_start;
+        for (block_start = 0; block_start < n; )
         {
-            block_end = block_start + (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end > n) { block_end = n; }
+            if (SA[block_start] == 0)
+            {
+                block_start++;
+            }
+            else
+            {
+                if (libsais_cancelled(thread_state[0].state.monitor)) { break; }
 
-            libsais_final_sorting_scan_left_to_right_32s_block_omp(T, SA, induction_bucket, thread_state[0].state.cache, block_start, block_end - block_start, threads);
-        }
-    }
-#else
-    UNUSED(thread_state);
-#endif
-}
+                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
+                fast_sint_t block_end     = block_start + 1; while (block_end < block_max_end && SA[block_end] != 0) { block_end++; }
+                fast_sint_t block_size    = block_end - block_start;
+
+                if (block_size < 32)
+                {
+                    for (; block_start < block_end; block_start += 1)
+                    {
+                        sa_sint_t p = SA[block_start]; SA[block_start] = p ^ SAINT_MIN; if (p > 0) { p--; SA[induction_bucket[T[p]]++] = p | ((sa_sint_t)(T[p - (p > 0)] < T[p]) << (SAINT_BIT - 1)); }
+                    }
+                }
+                else
+                {
+                    libsais_final_sorting_scan_left_to_right_8u_block_omp(T, SA, k, induction_bucket, block_start, block_size, threads, thread_state);
+                    block_start = block_end;
+                }
+            }
+        }
+    }
+#else
+    UNUSED(k); UNUSED(thread_state);
+#endif
+}
+
+static void libsais_final_sorting_scan_left_to_right_32s_omp(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+{
+    SA[induction_bucket[T[n - 1]]++] = (n - 1) | ((sa_sint_t)(T[n - 2] < T[n - 1]) << (SAINT_BIT - 1));
+
+    if (threads == 1 || n < 65536)
+    {
+        libsais_final_sorting_scan_left_to_right_32s(T, SA, induction_bucket, 0, n);
+    }
+#if defined(LIBSAIS_OPENMP)
+    else
+    {
+        fast_sint_t block_start, block_end;
+        for (block_start = 0; block_start < n; block_start = block_end)
+        {
+            if (libsais_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start + (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end > n) { block_end = n; }
+
+            libsais_final_sorting_scan_left_to_right_32s_block_omp(T, SA, induction_bucket, thread_state[0].state.cache, block_start, block_end - block_start, threads);
+        }
+    }
+#else
+    UNUSED(thread_state);
+#endif
+}
 
 static sa_sint_t libsais_final_bwt_scan_right_to_left_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j; sa_sint_t index = -1;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
@@ -5174,7 +5996,7 @@ static sa_sint_t libsais_final_bwt_scan_right_to_left_8u(const uint8_t * RESTRIC
 
 static void libsais_final_bwt_aux_scan_right_to_left_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
@@ -5198,9 +6020,35 @@ static void libsais_final_bwt_aux_scan_right_to_left_8u(const uint8_t * RESTRICT
     }
 }
 
+static void libsais_final_bwt_aux_sa_scan_right_to_left_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
+    {
+        libsais_prefetchw(&SA[i - 2 * prefetch_distance]);
+
+        sa_sint_t s0 = SA[i - prefetch_distance - 0]; const uint8_t * Ts0 = &T[s0] - 1; libsais_prefetchr(s0 > 0 ? Ts0 : NULL); Ts0--; libsais_prefetchr(s0 > 0 ? Ts0 : NULL);
+        sa_sint_t s1 = SA[i - prefetch_distance - 1]; const uint8_t * Ts1 = &T[s1] - 1; libsais_prefetchr(s1 > 0 ? Ts1 : NULL); Ts1--; libsais_prefetchr(s1 > 0 ? Ts1 : NULL);
+
+        sa_sint_t p0 = SA[i - 0];
+        SA[i - 0] = p0 & SAINT_MAX; if (p0 > 0) { p0--; uint8_t c0 = T[p0 - (p0 > 0)], c1 = T[p0]; SA[i - 0] = c1; sa_sint_t t = c0 | SAINT_MIN; sa_sint_t d0 = --induction_bucket[c1]; SA[d0] = (c0 <= c1) ? p0 : t; if ((p0 & rm) == 0) { I[p0 / (rm + 1)] = d0 + 1; } if ((d0 & rm) == 0) { S[d0 / (rm + 1)] = p0; } }
+
+        sa_sint_t p1 = SA[i - 1];
+        SA[i - 1] = p1 & SAINT_MAX; if (p1 > 0) { p1--; uint8_t c0 = T[p1 - (p1 > 0)], c1 = T[p1]; SA[i - 1] = c1; sa_sint_t t = c0 | SAINT_MIN; sa_sint_t d1 = --induction_bucket[c1]; SA[d1] = (c0 <= c1) ? p1 : t; if ((p1 & rm) == 0) { I[p1 / (rm + 1)] = d1 + 1; } if ((d1 & rm) == 0) { S[d1 / (rm + 1)] = p1; } }
+    }
+
+    for (j -= prefetch_distance + 1; i >= j; i -= 1)
+    {
+        sa_sint_t p = SA[i];
+        SA[i] = p & SAINT_MAX; if (p > 0) { p--; uint8_t c0 = T[p - (p > 0)], c1 = T[p]; SA[i] = c1; sa_sint_t t = c0 | SAINT_MIN; sa_sint_t d = --induction_bucket[c1]; SA[d] = (c0 <= c1) ? p : t; if ((p & rm) == 0) { I[p / (rm + 1)] = d + 1; } if ((d & rm) == 0) { S[d / (rm + 1)] = p; } }
+    }
+}
+
 static void libsais_final_sorting_scan_right_to_left_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
@@ -5222,7 +6070,7 @@ static void libsais_final_sorting_scan_right_to_left_8u(const uint8_t * RESTRICT
 
 static void libsais_final_sorting_scan_right_to_left_32s(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + 2 * prefetch_distance + 1; i >= j; i -= 2)
@@ -5248,7 +6096,7 @@ static void libsais_final_sorting_scan_right_to_left_32s(const sa_sint_t * RESTR
 
 static fast_sint_t libsais_final_bwt_scan_right_to_left_8u_block_prepare(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-   const fast_sint_t prefetch_distance = 32;
+   const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
    memset(buckets, 0, k * sizeof(sa_sint_t));
 
@@ -5274,7 +6122,7 @@ static fast_sint_t libsais_final_bwt_scan_right_to_left_8u_block_prepare(const u
 
 static fast_sint_t libsais_final_bwt_aux_scan_right_to_left_8u_block_prepare(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-   const fast_sint_t prefetch_distance = 32;
+   const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
    memset(buckets, 0, k * sizeof(sa_sint_t));
 
@@ -5300,7 +6148,7 @@ static fast_sint_t libsais_final_bwt_aux_scan_right_to_left_8u_block_prepare(con
 
 static fast_sint_t libsais_final_sorting_scan_right_to_left_8u_block_prepare(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-   const fast_sint_t prefetch_distance = 32;
+   const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
    memset(buckets, 0, k * sizeof(sa_sint_t));
 
@@ -5326,7 +6174,7 @@ static fast_sint_t libsais_final_sorting_scan_right_to_left_8u_block_prepare(con
 
 static void libsais_final_order_scan_right_to_left_8u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = 0, j = count - 3; i < j; i += 4)
@@ -5347,7 +6195,7 @@ static void libsais_final_order_scan_right_to_left_8u_block_place(sa_sint_t * RE
 
 static void libsais_final_bwt_aux_scan_right_to_left_8u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = 0, j = count - 6; i < j; i += 8)
@@ -5366,9 +6214,28 @@ static void libsais_final_bwt_aux_scan_right_to_left_8u_block_place(sa_sint_t *
     }
 }
 
+static void libsais_final_bwt_aux_sa_scan_right_to_left_8u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = 0, j = count - 2; i < j; i += 4)
+    {
+        libsais_prefetchr(&cache[i + prefetch_distance]);
+
+        sa_sint_t d0 = --buckets[cache[i + 0].symbol]; SA[d0] = cache[i + 0].index; sa_sint_t p0 = cache[i + 1].index; if ((p0 & rm) == 0) { I[p0 / (rm + 1)] = d0 + 1; } if ((d0 & rm) == 0) { S[d0 / (rm + 1)] = p0; }
+        sa_sint_t d1 = --buckets[cache[i + 2].symbol]; SA[d1] = cache[i + 2].index; sa_sint_t p1 = cache[i + 3].index; if ((p1 & rm) == 0) { I[p1 / (rm + 1)] = d1 + 1; } if ((d1 & rm) == 0) { S[d1 / (rm + 1)] = p1; }
+    }
+
+    for (j += 2; i < j; i += 2)
+    {
+        sa_sint_t d = --buckets[cache[i].symbol]; SA[d] = cache[i].index; sa_sint_t p = cache[i + 1].index; if ((p & rm) == 0) { I[p / (rm + 1)] = d + 1; } if ((d & rm) == 0) { S[d / (rm + 1)] = p; }
+    }
+}
+
 static void libsais_final_sorting_scan_right_to_left_32s_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -5392,7 +6259,7 @@ static void libsais_final_sorting_scan_right_to_left_32s_block_gather(const sa_s
 
 static void libsais_final_sorting_scan_right_to_left_32s_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT induction_bucket, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
@@ -5536,6 +6403,60 @@ static void libsais_final_bwt_aux_scan_right_to_left_8u_block_omp(const uint8_t
     }
 }
 
+static void libsais_final_bwt_aux_sa_scan_right_to_left_8u_block_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT induction_bucket, fast_sint_t block_start, fast_sint_t block_size, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && block_size >= 64 * (k > 256 ? k : 256) && omp_get_dynamic() == 0)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(k); UNUSED(threads); UNUSED(thread_state);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (block_size / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : block_size - omp_block_start;
+
+        omp_block_start += block_start;
+
+        if (omp_num_threads == 1)
+        {
+            libsais_final_bwt_aux_sa_scan_right_to_left_8u(T, SA, rm, I, S, induction_bucket, omp_block_start, omp_block_size);
+        }
+#if defined(LIBSAIS_OPENMP)
+        else
+        {
+            {
+                thread_state[omp_thread_num].state.count = libsais_final_bwt_aux_scan_right_to_left_8u_block_prepare(T, SA, k, thread_state[omp_thread_num].state.buckets, thread_state[omp_thread_num].state.cache, omp_block_start, omp_block_size);
+            }
+
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                fast_sint_t t;
+                for (t = omp_num_threads - 1; t >= 0; --t)
+                {
+                    sa_sint_t * RESTRICT temp_bucket = thread_state[t].state.buckets;
+                    fast_sint_t c; for (c = 0; c < k; c += 1) { sa_sint_t A = induction_bucket[c], B = temp_bucket[c]; induction_bucket[c] = A - B; temp_bucket[c] = A; }
+                }
+            }
+
+            #pragma omp barrier
+
+            {
+                libsais_final_bwt_aux_sa_scan_right_to_left_8u_block_place(SA, rm, I, S, thread_state[omp_thread_num].state.buckets, thread_state[omp_thread_num].state.cache, thread_state[omp_thread_num].state.count);
+            }
+        }
+#endif
+    }
+}
+
 static void libsais_final_sorting_scan_right_to_left_8u_block_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT induction_bucket, fast_sint_t block_start, fast_sint_t block_size, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
 #if defined(LIBSAIS_OPENMP)
@@ -5661,7 +6582,9 @@ static sa_sint_t libsais_final_bwt_scan_right_to_left_8u_omp(const uint8_t * RES
             }
             else
             {
-                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end < 0) { block_max_end = -1; }
+                if (libsais_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end < 0) { block_max_end = -1; }
                 fast_sint_t block_end     = block_start - 1; while (block_end > block_max_end && SA[block_end] != 0) { block_end--; }
                 fast_sint_t block_size    = block_start - block_end;
 
@@ -5705,7 +6628,9 @@ static void libsais_final_bwt_aux_scan_right_to_left_8u_omp(const uint8_t * REST
             }
             else
             {
-                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * ((LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads) / 2); if (block_max_end < 0) { block_max_end = -1; }
+                if (libsais_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * ((thread_state[0].state.cache_size - 16 * (fast_sint_t)threads) / 2); if (block_max_end < 0) { block_max_end = -1; }
                 fast_sint_t block_end     = block_start - 1; while (block_end > block_max_end && SA[block_end] != 0) { block_end--; }
                 fast_sint_t block_size    = block_start - block_end;
 
@@ -5729,6 +6654,50 @@ static void libsais_final_bwt_aux_scan_right_to_left_8u_omp(const uint8_t * REST
 #endif
 }
 
+static void libsais_final_bwt_aux_sa_scan_right_to_left_8u_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+{
+    if (threads == 1 || n < 65536)
+    {
+        libsais_final_bwt_aux_sa_scan_right_to_left_8u(T, SA, rm, I, S, induction_bucket, 0, n);
+    }
+#if defined(LIBSAIS_OPENMP)
+    else
+    {
+        fast_sint_t block_start;
+        for (block_start = (fast_sint_t)n - 1; block_start >= 0; )
+        {
+            if (SA[block_start] == 0)
+            {
+                block_start--;
+            }
+            else
+            {
+                if (libsais_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * ((thread_state[0].state.cache_size - 16 * (fast_sint_t)threads) / 2); if (block_max_end < 0) { block_max_end = -1; }
+                fast_sint_t block_end     = block_start - 1; while (block_end > block_max_end && SA[block_end] != 0) { block_end--; }
+                fast_sint_t block_size    = block_start - block_end;
+
+                if (block_size < 32)
+                {
+                    for (; block_start > block_end; block_start -= 1)
+                    {
+                        sa_sint_t p = SA[block_start]; SA[block_start] = p & SAINT_MAX; if (p > 0) { p--; uint8_t c0 = T[p - (p > 0)], c1 = T[p]; SA[block_start] = c1; sa_sint_t t = c0 | SAINT_MIN; sa_sint_t d = --induction_bucket[c1]; SA[d] = (c0 <= c1) ? p : t; if ((p & rm) == 0) { I[p / (rm + 1)] = d + 1; } if ((d & rm) == 0) { S[d / (rm + 1)] = p; } }
+                    }
+                }
+                else
+                {
+                    libsais_final_bwt_aux_sa_scan_right_to_left_8u_block_omp(T, SA, k, rm, I, S, induction_bucket, block_end + 1, block_size, threads, thread_state);
+                    block_start = block_end;
+                }
+            }
+        }
+    }
+#else
+    UNUSED(k); UNUSED(thread_state);
+#endif
+}
+
 static void libsais_final_sorting_scan_right_to_left_8u_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
     if (threads == 1 || n < 65536)
@@ -5747,7 +6716,9 @@ static void libsais_final_sorting_scan_right_to_left_8u_omp(const uint8_t * REST
             }
             else
             {
-                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end < -1) { block_max_end = -1; }
+                if (libsais_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end < -1) { block_max_end = -1; }
                 fast_sint_t block_end     = block_start - 1; while (block_end > block_max_end && SA[block_end] != 0) { block_end--; }
                 fast_sint_t block_size    = block_start - block_end;
 
@@ -5783,7 +6754,9 @@ static void libsais_final_sorting_scan_right_to_left_32s_omp(const sa_sint_t * R
         fast_sint_t block_start, block_end;
         for (block_start = (fast_sint_t)n - 1; block_start >= 0; block_start = block_end)
         {
-            block_end = block_start - (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end < 0) { block_end = -1; }
+            if (libsais_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start - (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end < 0) { block_end = -1; }
 
             libsais_final_sorting_scan_right_to_left_32s_block_omp(T, SA, induction_bucket, thread_state[0].state.cache, block_end + 1, block_start - block_end, threads);
         }
@@ -5811,7 +6784,7 @@ static void libsais_clear_lms_suffixes_omp(sa_sint_t * RESTRICT SA, sa_sint_t n,
     }
 }
 
-static sa_sint_t libsais_induce_final_order_8u_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t bwt, sa_sint_t r, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT buckets, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+static sa_sint_t libsais_induce_final_order_8u_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t bwt, sa_sint_t r, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT buckets, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
     if (!bwt)
     {
@@ -5820,6 +6793,13 @@ static sa_sint_t libsais_induce_final_order_8u_omp(const uint8_t * RESTRICT T, s
         libsais_final_sorting_scan_right_to_left_8u_omp(T, SA, n, k, &buckets[7 * ALPHABET_SIZE], threads, thread_state);
         return 0;
     }
+    else if (S != NULL)
+    {
+        libsais_final_bwt_aux_sa_scan_left_to_right_8u_omp(T, SA, n, k, r - 1, I, S, &buckets[6 * ALPHABET_SIZE], threads, thread_state);
+        if (threads > 1 && n >= 65536) { libsais_clear_lms_suffixes_omp(SA, n, ALPHABET_SIZE, &buckets[6 * ALPHABET_SIZE], &buckets[7 * ALPHABET_SIZE], threads); }
+        libsais_final_bwt_aux_sa_scan_right_to_left_8u_omp(T, SA, n, k, r - 1, I, S, &buckets[7 * ALPHABET_SIZE], threads, thread_state);
+        return 0;
+    }
     else if (I != NULL)
     {
         libsais_final_bwt_aux_scan_left_to_right_8u_omp(T, SA, n, k, r - 1, I, &buckets[6 * ALPHABET_SIZE], threads, thread_state);
@@ -5866,7 +6846,7 @@ static void libsais_induce_final_order_32s_1k(const sa_sint_t * RESTRICT T, sa_s
 
 static sa_sint_t libsais_renumber_unique_and_nonunique_lms_suffixes_32s(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t m, sa_sint_t f, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAm = &SA[m];
 
@@ -5901,7 +6881,7 @@ static sa_sint_t libsais_renumber_unique_and_nonunique_lms_suffixes_32s(sa_sint_
 
 static void libsais_compact_unique_and_nonunique_lms_suffixes_32s(sa_sint_t * RESTRICT SA, sa_sint_t m, fast_sint_t * pl, fast_sint_t * pr, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAl = &SA[0];
     sa_sint_t * RESTRICT SAr = &SA[0];
@@ -5930,7 +6910,7 @@ static void libsais_compact_unique_and_nonunique_lms_suffixes_32s(sa_sint_t * RE
 
 static sa_sint_t libsais_count_unique_suffixes(sa_sint_t * RESTRICT SA, sa_sint_t m, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAm = &SA[m];
 
@@ -6090,7 +7070,7 @@ static sa_sint_t libsais_compact_lms_suffixes_32s_omp(sa_sint_t * RESTRICT T, sa
 
 static void libsais_merge_unique_lms_suffixes_32s(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t m, fast_sint_t l, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     const sa_sint_t * RESTRICT SAnm = &SA[(fast_sint_t)n - (fast_sint_t)m - 1 + l];
 
@@ -6113,7 +7093,7 @@ static void libsais_merge_unique_lms_suffixes_32s(sa_sint_t * RESTRICT T, sa_sin
 
 static void libsais_merge_nonunique_lms_suffixes_32s(sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t m, fast_sint_t l, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     const sa_sint_t * RESTRICT SAnm = &SA[(fast_sint_t)n - (fast_sint_t)m - 1 + l];
 
@@ -6266,32 +7246,58 @@ static void libsais_reconstruct_compacted_lms_suffixes_32s_1k_omp(sa_sint_t * RE
     }
 }
 
-static sa_sint_t libsais_main_32s_recursion(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t * RESTRICT local_buffer)
+static sa_sint_t libsais_adaptive_threads(const LIBSAIS_MONITOR * monitor, sa_sint_t threads, sa_sint_t n, sa_sint_t k)
+{
+    if (monitor == NULL || monitor->thread_block_size <= 0) { return threads; }
+
+    fast_sint_t block_size  = (fast_sint_t)k * 16 > (fast_sint_t)monitor->thread_block_size ? (fast_sint_t)k * 16 : (fast_sint_t)monitor->thread_block_size;
+    fast_sint_t max_threads = (fast_sint_t)n / block_size;
+
+    return max_threads < (fast_sint_t)threads ? (max_threads > 1 ? (sa_sint_t)max_threads : 1) : threads;
+}
+
+static sa_sint_t libsais_main_32s_recursion(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t * RESTRICT local_buffer, sa_sint_t local_buffer_size, const LIBSAIS_ALLOCATOR * allocator, LIBSAIS_MONITOR * monitor, sa_sint_t depth)
 {
     fs = fs < (SAINT_MAX - n) ? fs : (SAINT_MAX - n);
+    threads = libsais_adaptive_threads(monitor, threads, n, k);
+
+    if (libsais_cancelled(monitor)) { return -5; }
 
-    if (k > 0 && ((fs / k >= 6) || (LIBSAIS_LOCAL_BUFFER_SIZE / k >= 6 && threads == 1)))
+    if (k > 0 && ((fs / k >= 6) || (local_buffer_size / k >= 6 && threads == 1)))
     {
         sa_sint_t alignment = (fs - 1024) / k >= 6 ? (sa_sint_t)1024 : (sa_sint_t)16;
         sa_sint_t * RESTRICT buckets = (fs - alignment) / k >= 6 ? (sa_sint_t *)libsais_align_up(&SA[n + fs - 6 * (fast_sint_t)k - alignment], (size_t)alignment * sizeof(sa_sint_t)) : &SA[n + fs - 6 * (fast_sint_t)k];
-        buckets = (LIBSAIS_LOCAL_BUFFER_SIZE / k >= 6 && threads == 1) ? local_buffer : buckets;
+        buckets = (local_buffer_size / k >= 6 && threads == 1) ? local_buffer : buckets;
 
+        sa_sint_t flags = LIBSAIS_PROFILE_6K | (buckets == local_buffer ? LIBSAIS_PROFILE_LOCAL_BUFFER : LIBSAIS_PROFILE_FREE_SPACE);
+        libsais_profile(monitor, LIBSAIS_PHASE_LEVEL, 0, depth, n, k, flags);
+
+        libsais_profile(monitor, LIBSAIS_PHASE_GATHER, 0, depth, n, k, flags);
         sa_sint_t m = libsais_count_and_gather_lms_suffixes_32s_4k_omp(T, SA, n, k, buckets, threads, thread_state);
+        libsais_profile(monitor, LIBSAIS_PHASE_GATHER, 1, depth, n, k, flags);
+
         if (m > 1)
         {
+            libsais_profile(monitor, LIBSAIS_PHASE_RADIX_SORT, 0, depth, n, k, flags);
             memset(SA, 0, ((size_t)n - (size_t)m) * sizeof(sa_sint_t));
 
             sa_sint_t first_lms_suffix    = SA[n - m];
             sa_sint_t left_suffixes_count = libsais_initialize_buckets_for_lms_suffixes_radix_sort_32s_6k(T, k, buckets, first_lms_suffix);
 
-            libsais_radix_sort_lms_suffixes_32s_6k_omp(T, SA, n, m, &buckets[4 * (fast_sint_t)k], threads, thread_state);
+            libsais_radix_sort_lms_suffixes_32s_6k_omp(T, SA, n, m, &buckets[4 * (fast_sint_t)k], libsais_adaptive_threads(monitor, threads, m, k), thread_state);
 
             if ((n / 8192) < k) { libsais_radix_sort_set_markers_32s_6k_omp(SA, k, &buckets[4 * (fast_sint_t)k], threads); }
             if (threads > 1 && n >= 65536) { memset(&SA[(fast_sint_t)n - (fast_sint_t)m], 0, (size_t)m * sizeof(sa_sint_t)); }
+            libsais_profile(monitor, LIBSAIS_PHASE_RADIX_SORT, 1, depth, n, k, flags);
+            if (libsais_cancelled(monitor)) { return -5; }
 
+            libsais_profile(monitor, LIBSAIS_PHASE_PARTIAL_SORT, 0, depth, n, k, flags);
             libsais_initialize_buckets_for_partial_sorting_32s_6k(T, k, buckets, first_lms_suffix, left_suffixes_count);
             libsais_induce_partial_order_32s_6k_omp(T, SA, n, k, buckets, first_lms_suffix, left_suffixes_count, threads, thread_state);
+            libsais_profile(monitor, LIBSAIS_PHASE_PARTIAL_SORT, 1, depth, n, k, flags);
+            if (libsais_cancelled(monitor)) { return -5; }
 
+            libsais_profile(monitor, LIBSAIS_PHASE_RENUMBER, 0, depth, n, k, flags);
             sa_sint_t names = (n / 8192) < k
                 ? libsais_renumber_and_mark_distinct_lms_suffixes_32s_4k_omp(SA, n, m, threads, thread_state)
                 : libsais_renumber_and_gather_lms_suffixes_omp(SA, n, m, fs, threads, thread_state);
@@ -6301,65 +7307,95 @@ static sa_sint_t libsais_main_32s_recursion(sa_sint_t * RESTRICT T, sa_sint_t *
                 sa_sint_t f = (n / 8192) < k
                     ? libsais_compact_lms_suffixes_32s_omp(T, SA, n, m, fs, threads, thread_state)
                     : 0;
+                libsais_profile(monitor, LIBSAIS_PHASE_RENUMBER, 1, depth, m, names, flags);
 
-                if (libsais_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer) != 0)
+                sa_sint_t status = libsais_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer, local_buffer_size, allocator, monitor, depth + 1);
+                if (status != 0)
                 {
-                    return -2;
+                    return status;
                 }
 
+                libsais_profile(monitor, LIBSAIS_PHASE_RECONSTRUCT, 0, depth, n, k, flags);
                 libsais_reconstruct_compacted_lms_suffixes_32s_2k_omp(T, SA, n, k, m, fs, f, buckets, threads, thread_state);
+                libsais_profile(monitor, LIBSAIS_PHASE_RECONSTRUCT, 1, depth, n, k, flags);
             }
             else
             {
+                libsais_profile(monitor, LIBSAIS_PHASE_RENUMBER, 1, depth, m, names, flags);
                 libsais_count_lms_suffixes_32s_2k(T, n, k, buckets);
             }
 
+            libsais_profile(monitor, LIBSAIS_PHASE_FINAL_SORT, 0, depth, n, k, flags);
             libsais_initialize_buckets_start_and_end_32s_4k(k, buckets);
             libsais_place_lms_suffixes_histogram_32s_4k(SA, n, k, m, buckets);
             libsais_induce_final_order_32s_4k(T, SA, n, k, buckets, threads, thread_state);
+            libsais_profile(monitor, LIBSAIS_PHASE_FINAL_SORT, 1, depth, n, k, flags);
+            if (libsais_cancelled(monitor)) { return -5; }
         }
         else
         {
+            libsais_profile(monitor, LIBSAIS_PHASE_FINAL_SORT, 0, depth, n, k, flags);
             SA[0] = SA[n - 1];
 
             libsais_initialize_buckets_start_and_end_32s_6k(k, buckets);
             libsais_place_lms_suffixes_histogram_32s_6k(SA, n, k, m, buckets);
             libsais_induce_final_order_32s_6k(T, SA, n, k, buckets, threads, thread_state);
+            libsais_profile(monitor, LIBSAIS_PHASE_FINAL_SORT, 1, depth, n, k, flags);
+            if (libsais_cancelled(monitor)) { return -5; }
         }
 
+        libsais_profile(monitor, LIBSAIS_PHASE_LEVEL, 1, depth, n, k, flags);
         return 0;
     }
-    else if (k > 0 && (n <= SAINT_MAX / 2) && ((fs / k >= 4) || (LIBSAIS_LOCAL_BUFFER_SIZE / k >= 4 && threads == 1)))
+    else if (k > 0 && (n <= SAINT_MAX / 2) && ((fs / k >= 4) || (local_buffer_size / k >= 4 && threads == 1)))
     {
         sa_sint_t alignment = (fs - 1024) / k >= 4 ? (sa_sint_t)1024 : (sa_sint_t)16;
         sa_sint_t * RESTRICT buckets = (fs - alignment) / k >= 4 ? (sa_sint_t *)libsais_align_up(&SA[n + fs - 4 * (fast_sint_t)k - alignment], (size_t)alignment * sizeof(sa_sint_t)) : &SA[n + fs - 4 * (fast_sint_t)k];
-        buckets = (LIBSAIS_LOCAL_BUFFER_SIZE / k >= 4 && threads == 1) ? local_buffer : buckets;
+        buckets = (local_buffer_size / k >= 4 && threads == 1) ? local_buffer : buckets;
 
+        sa_sint_t flags = LIBSAIS_PROFILE_4K | (buckets == local_buffer ? LIBSAIS_PROFILE_LOCAL_BUFFER : LIBSAIS_PROFILE_FREE_SPACE);
+        libsais_profile(monitor, LIBSAIS_PHASE_LEVEL, 0, depth, n, k, flags);
+
+        libsais_profile(monitor, LIBSAIS_PHASE_GATHER, 0, depth, n, k, flags);
         sa_sint_t m = libsais_count_and_gather_lms_suffixes_32s_2k_omp(T, SA, n, k, buckets, threads, thread_state);
+        libsais_profile(monitor, LIBSAIS_PHASE_GATHER, 1, depth, n, k, flags);
+
         if (m > 1)
         {
+            libsais_profile(monitor, LIBSAIS_PHASE_RADIX_SORT, 0, depth, n, k, flags);
             libsais_initialize_buckets_for_radix_and_partial_sorting_32s_4k(T, k, buckets, SA[n - m]);
 
-            libsais_radix_sort_lms_suffixes_32s_2k_omp(T, SA, n, m, &buckets[1], threads, thread_state);
+            libsais_radix_sort_lms_suffixes_32s_2k_omp(T, SA, n, m, &buckets[1], libsais_adaptive_threads(monitor, threads, m, k), thread_state);
             libsais_radix_sort_set_markers_32s_4k_omp(SA, k, &buckets[1], threads);
+            libsais_profile(monitor, LIBSAIS_PHASE_RADIX_SORT, 1, depth, n, k, flags);
+            if (libsais_cancelled(monitor)) { return -5; }
             
+            libsais_profile(monitor, LIBSAIS_PHASE_PARTIAL_SORT, 0, depth, n, k, flags);
             libsais_place_lms_suffixes_interval_32s_4k(SA, n, k, m - 1, buckets);
             libsais_induce_partial_order_32s_4k_omp(T, SA, n, k, buckets, threads, thread_state);
+            libsais_profile(monitor, LIBSAIS_PHASE_PARTIAL_SORT, 1, depth, n, k, flags);
+            if (libsais_cancelled(monitor)) { return -5; }
 
+            libsais_profile(monitor, LIBSAIS_PHASE_RENUMBER, 0, depth, n, k, flags);
             sa_sint_t names = libsais_renumber_and_mark_distinct_lms_suffixes_32s_4k_omp(SA, n, m, threads, thread_state);
             if (names < m)
             {
                 sa_sint_t f = libsais_compact_lms_suffixes_32s_omp(T, SA, n, m, fs, threads, thread_state);
+                libsais_profile(monitor, LIBSAIS_PHASE_RENUMBER, 1, depth, m, names, flags);
 
-                if (libsais_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer) != 0)
+                sa_sint_t status = libsais_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer, local_buffer_size, allocator, monitor, depth + 1);
+                if (status != 0)
                 {
-                    return -2;
+                    return status;
                 }
 
+                libsais_profile(monitor, LIBSAIS_PHASE_RECONSTRUCT, 0, depth, n, k, flags);
                 libsais_reconstruct_compacted_lms_suffixes_32s_2k_omp(T, SA, n, k, m, fs, f, buckets, threads, thread_state);
+                libsais_profile(monitor, LIBSAIS_PHASE_RECONSTRUCT, 1, depth, n, k, flags);
             }
             else
             {
+                libsais_profile(monitor, LIBSAIS_PHASE_RENUMBER, 1, depth, m, names, flags);
                 libsais_count_lms_suffixes_32s_2k(T, n, k, buckets);
             }
         }
@@ -6368,43 +7404,65 @@ static sa_sint_t libsais_main_32s_recursion(sa_sint_t * RESTRICT T, sa_sint_t *
             SA[0] = SA[n - 1];
         }
 
+        libsais_profile(monitor, LIBSAIS_PHASE_FINAL_SORT, 0, depth, n, k, flags);
         libsais_initialize_buckets_start_and_end_32s_4k(k, buckets);
         libsais_place_lms_suffixes_histogram_32s_4k(SA, n, k, m, buckets);
         libsais_induce_final_order_32s_4k(T, SA, n, k, buckets, threads, thread_state);
+        libsais_profile(monitor, LIBSAIS_PHASE_FINAL_SORT, 1, depth, n, k, flags);
+        if (libsais_cancelled(monitor)) { return -5; }
 
+        libsais_profile(monitor, LIBSAIS_PHASE_LEVEL, 1, depth, n, k, flags);
         return 0;
     }
-    else if (k > 0 && ((fs / k >= 2) || (LIBSAIS_LOCAL_BUFFER_SIZE / k >= 2 && threads == 1)))
+    else if (k > 0 && ((fs / k >= 2) || (local_buffer_size / k >= 2 && threads == 1)))
     {
         sa_sint_t alignment = (fs - 1024) / k >= 2 ? (sa_sint_t)1024 : (sa_sint_t)16;
         sa_sint_t * RESTRICT buckets = (fs - alignment) / k >= 2 ? (sa_sint_t *)libsais_align_up(&SA[n + fs - 2 * (fast_sint_t)k - alignment], (size_t)alignment * sizeof(sa_sint_t)) : &SA[n + fs - 2 * (fast_sint_t)k];
-        buckets = (LIBSAIS_LOCAL_BUFFER_SIZE / k >= 2 && threads == 1) ? local_buffer : buckets;
+        buckets = (local_buffer_size / k >= 2 && threads == 1) ? local_buffer : buckets;
 
+        sa_sint_t flags = LIBSAIS_PROFILE_2K | (buckets == local_buffer ? LIBSAIS_PROFILE_LOCAL_BUFFER : LIBSAIS_PROFILE_FREE_SPACE);
+        libsais_profile(monitor, LIBSAIS_PHASE_LEVEL, 0, depth, n, k, flags);
+
+        libsais_profile(monitor, LIBSAIS_PHASE_GATHER, 0, depth, n, k, flags);
         sa_sint_t m = libsais_count_and_gather_lms_suffixes_32s_2k_omp(T, SA, n, k, buckets, threads, thread_state);
+        libsais_profile(monitor, LIBSAIS_PHASE_GATHER, 1, depth, n, k, flags);
+
         if (m > 1)
         {
+            libsais_profile(monitor, LIBSAIS_PHASE_RADIX_SORT, 0, depth, n, k, flags);
             libsais_initialize_buckets_for_lms_suffixes_radix_sort_32s_2k(T, k, buckets, SA[n - m]);
 
-            libsais_radix_sort_lms_suffixes_32s_2k_omp(T, SA, n, m, &buckets[1], threads, thread_state);
+            libsais_radix_sort_lms_suffixes_32s_2k_omp(T, SA, n, m, &buckets[1], libsais_adaptive_threads(monitor, threads, m, k), thread_state);
             libsais_place_lms_suffixes_interval_32s_2k(SA, n, k, m - 1, buckets);
+            libsais_profile(monitor, LIBSAIS_PHASE_RADIX_SORT, 1, depth, n, k, flags);
+            if (libsais_cancelled(monitor)) { return -5; }
 
+            libsais_profile(monitor, LIBSAIS_PHASE_PARTIAL_SORT, 0, depth, n, k, flags);
             libsais_initialize_buckets_start_and_end_32s_2k(k, buckets);
             libsais_induce_partial_order_32s_2k_omp(T, SA, n, k, buckets, threads, thread_state);
+            libsais_profile(monitor, LIBSAIS_PHASE_PARTIAL_SORT, 1, depth, n, k, flags);
+            if (libsais_cancelled(monitor)) { return -5; }
 
+            libsais_profile(monitor, LIBSAIS_PHASE_RENUMBER, 0, depth, n, k, flags);
             sa_sint_t names = libsais_renumber_and_mark_distinct_lms_suffixes_32s_1k_omp(T, SA, n, m, threads);
             if (names < m)
             {
                 sa_sint_t f = libsais_compact_lms_suffixes_32s_omp(T, SA, n, m, fs, threads, thread_state);
+                libsais_profile(monitor, LIBSAIS_PHASE_RENUMBER, 1, depth, m, names, flags);
 
-                if (libsais_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer) != 0)
+                sa_sint_t status = libsais_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer, local_buffer_size, allocator, monitor, depth + 1);
+                if (status != 0)
                 {
-                    return -2;
+                    return status;
                 }
 
+                libsais_profile(monitor, LIBSAIS_PHASE_RECONSTRUCT, 0, depth, n, k, flags);
                 libsais_reconstruct_compacted_lms_suffixes_32s_2k_omp(T, SA, n, k, m, fs, f, buckets, threads, thread_state);
+                libsais_profile(monitor, LIBSAIS_PHASE_RECONSTRUCT, 1, depth, n, k, flags);
             }
             else
             {
+                libsais_profile(monitor, LIBSAIS_PHASE_RENUMBER, 1, depth, m, names, flags);
                 libsais_count_lms_suffixes_32s_2k(T, n, k, buckets);
             }
         }
@@ -6413,174 +7471,174 @@ static sa_sint_t libsais_main_32s_recursion(sa_sint_t * RESTRICT T, sa_sint_t *
             SA[0] = SA[n - 1];
         }
 
+        libsais_profile(monitor, LIBSAIS_PHASE_FINAL_SORT, 0, depth, n, k, flags);
         libsais_initialize_buckets_end_32s_2k(k, buckets);
         libsais_place_lms_suffixes_histogram_32s_2k(SA, n, k, m, buckets);
 
         libsais_initialize_buckets_start_and_end_32s_2k(k, buckets);
         libsais_induce_final_order_32s_2k(T, SA, n, k, buckets, threads, thread_state);
+        libsais_profile(monitor, LIBSAIS_PHASE_FINAL_SORT, 1, depth, n, k, flags);
+        if (libsais_cancelled(monitor)) { return -5; }
 
+        libsais_profile(monitor, LIBSAIS_PHASE_LEVEL, 1, depth, n, k, flags);
         return 0;
     }
     else
     {
-        sa_sint_t * buffer = fs < k ? (sa_sint_t *)libsais_alloc_aligned((size_t)k * sizeof(sa_sint_t), 4096) : (sa_sint_t *)NULL;
+        sa_sint_t * buffer = fs < k ? (sa_sint_t *)libsais_alloc_memory(allocator, (size_t)k * sizeof(sa_sint_t), 4096) : (sa_sint_t *)NULL;
 
         sa_sint_t alignment = fs - 1024 >= k ? (sa_sint_t)1024 : (sa_sint_t)16;
         sa_sint_t * RESTRICT buckets = fs - alignment >= k ? (sa_sint_t *)libsais_align_up(&SA[n + fs - k - alignment], (size_t)alignment * sizeof(sa_sint_t)) : fs >= k ? &SA[n + fs - k] : buffer;
 
         if (buckets == NULL) { return -2; }
 
+        sa_sint_t flags = LIBSAIS_PROFILE_1K | (buffer != NULL ? LIBSAIS_PROFILE_ALLOCATION : LIBSAIS_PROFILE_FREE_SPACE);
+        libsais_profile(monitor, LIBSAIS_PHASE_LEVEL, 0, depth, n, k, flags);
+
+        libsais_profile(monitor, LIBSAIS_PHASE_GATHER, 0, depth, n, k, flags);
         memset(SA, 0, (size_t)n * sizeof(sa_sint_t));
 
         libsais_count_suffixes_32s(T, n, k, buckets); 
         libsais_initialize_buckets_end_32s_1k(k, buckets);
+        libsais_profile(monitor, LIBSAIS_PHASE_GATHER, 1, depth, n, k, flags);
 
+        libsais_profile(monitor, LIBSAIS_PHASE_RADIX_SORT, 0, depth, n, k, flags);
         sa_sint_t m = libsais_radix_sort_lms_suffixes_32s_1k(T, SA, n, buckets);
+        libsais_profile(monitor, LIBSAIS_PHASE_RADIX_SORT, 1, depth, n, k, flags);
+        if (libsais_cancelled(monitor)) { libsais_free_memory(allocator, buffer); return -5; }
+
         if (m > 1)
         {
+            libsais_profile(monitor, LIBSAIS_PHASE_PARTIAL_SORT, 0, depth, n, k, flags);
             libsais_induce_partial_order_32s_1k_omp(T, SA, n, k, buckets, threads, thread_state);
+            libsais_profile(monitor, LIBSAIS_PHASE_PARTIAL_SORT, 1, depth, n, k, flags);
+            if (libsais_cancelled(monitor)) { libsais_free_memory(allocator, buffer); return -5; }
 
+            libsais_profile(monitor, LIBSAIS_PHASE_RENUMBER, 0, depth, n, k, flags);
             sa_sint_t names = libsais_renumber_and_mark_distinct_lms_suffixes_32s_1k_omp(T, SA, n, m, threads);
             if (names < m)
             {
-                if (buffer != NULL) { libsais_free_aligned(buffer); buckets = NULL; }
+                if (buffer != NULL) { libsais_free_memory(allocator, buffer); buckets = NULL; }
 
                 sa_sint_t f = libsais_compact_lms_suffixes_32s_omp(T, SA, n, m, fs, threads, thread_state);
+                libsais_profile(monitor, LIBSAIS_PHASE_RENUMBER, 1, depth, m, names, flags);
 
-                if (libsais_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer) != 0)
+                sa_sint_t status = libsais_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer, local_buffer_size, allocator, monitor, depth + 1);
+                if (status != 0)
                 {
-                    return -2;
+                    return status;
                 }
 
+                libsais_profile(monitor, LIBSAIS_PHASE_RECONSTRUCT, 0, depth, n, k, flags);
                 libsais_reconstruct_compacted_lms_suffixes_32s_1k_omp(T, SA, n, m, fs, f, threads, thread_state);
+                libsais_profile(monitor, LIBSAIS_PHASE_RECONSTRUCT, 1, depth, n, k, flags);
 
-                if (buckets == NULL) { buckets = buffer = (sa_sint_t *)libsais_alloc_aligned((size_t)k * sizeof(sa_sint_t), 4096); }
+                if (buckets == NULL) { buckets = buffer = (sa_sint_t *)libsais_alloc_memory(allocator, (size_t)k * sizeof(sa_sint_t), 4096); }
                 if (buckets == NULL) { return -2; }
             }
+            else
+            {
+                libsais_profile(monitor, LIBSAIS_PHASE_RENUMBER, 1, depth, m, names, flags);
+            }
             
+            libsais_profile(monitor, LIBSAIS_PHASE_FINAL_SORT, 0, depth, n, k, flags);
             libsais_count_suffixes_32s(T, n, k, buckets);
             libsais_initialize_buckets_end_32s_1k(k, buckets);
             libsais_place_lms_suffixes_interval_32s_1k(T, SA, k, m, buckets);
         }
+        else
+        {
+            libsais_profile(monitor, LIBSAIS_PHASE_FINAL_SORT, 0, depth, n, k, flags);
+        }
 
         libsais_induce_final_order_32s_1k(T, SA, n, k, buckets, threads, thread_state);
-        libsais_free_aligned(buffer);
+        libsais_free_memory(allocator, buffer);
+        libsais_profile(monitor, LIBSAIS_PHASE_FINAL_SORT, 1, depth, n, k, flags);
+        if (libsais_cancelled(monitor)) { return -5; }
 
+        libsais_profile(monitor, LIBSAIS_PHASE_LEVEL, 1, depth, n, k, flags);
         return 0;
     }
 }
 
-static sa_sint_t libsais_main_32s_entry(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+static sa_sint_t libsais_main_32s_entry(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t * RESTRICT local_buffer, sa_sint_t local_buffer_size, const LIBSAIS_ALLOCATOR * allocator, LIBSAIS_MONITOR * monitor, sa_sint_t depth)
 {
-    sa_sint_t local_buffer[LIBSAIS_LOCAL_BUFFER_SIZE];
+    sa_sint_t stack_buffer[LIBSAIS_LOCAL_BUFFER_SIZE];
 
-    return libsais_main_32s_recursion(T, SA, n, k, fs, threads, thread_state, local_buffer);
+    if (thread_state != NULL) { thread_state[0].state.monitor = monitor; }
+
+    return libsais_main_32s_recursion(T, SA, n, k, fs, threads, thread_state, local_buffer != NULL ? local_buffer : stack_buffer, local_buffer_size, allocator, monitor, depth);
 }
 
-static sa_sint_t libsais_main_8u(const uint8_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t * RESTRICT buckets, sa_sint_t bwt, sa_sint_t r, sa_sint_t * RESTRICT I, sa_sint_t fs, sa_sint_t * freq, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+static void libsais_mark_alphabet_32s(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    fs = fs < (SAINT_MAX - n) ? fs : (SAINT_MAX - n);
-
-    sa_sint_t m = libsais_count_and_gather_lms_suffixes_8u_omp(T, SA, n, buckets, threads, thread_state);
-    sa_sint_t k = libsais_initialize_buckets_start_and_end_8u(buckets, freq);
+    fast_sint_t i; for (i = omp_block_start; i < omp_block_start + omp_block_size; i += 1) { SA[T[i]] = SAINT_MIN; }
+}
 
-    if (m > 0)
+static void libsais_mark_alphabet_32s_omp(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
     {
-        sa_sint_t first_lms_suffix    = SA[n - m];
-        sa_sint_t left_suffixes_count = libsais_initialize_buckets_for_lms_suffixes_radix_sort_8u(T, buckets, first_lms_suffix);
-
-        if (threads > 1 && n >= 65536) { memset(SA, 0, ((size_t)n - (size_t)m) * sizeof(sa_sint_t)); }
-        libsais_radix_sort_lms_suffixes_8u_omp(T, SA, n, m, buckets, threads, thread_state);
-        if (threads > 1 && n >= 65536) { memset(&SA[(fast_sint_t)n - (fast_sint_t)m], 0, (size_t)m * sizeof(sa_sint_t)); }
-
-        libsais_initialize_buckets_for_partial_sorting_8u(T, buckets, first_lms_suffix, left_suffixes_count);
-        libsais_induce_partial_order_8u_omp(T, SA, n, k, buckets, first_lms_suffix, left_suffixes_count, threads, thread_state);
-
-        sa_sint_t names = libsais_renumber_and_gather_lms_suffixes_omp(SA, n, m, fs, threads, thread_state);
-        if (names < m)
-        {
-            if (libsais_main_32s_entry(SA + n + fs - m, SA, m, names, fs + n - 2 * m, threads, thread_state) != 0)
-            {
-                return -2;
-            }
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+#else
+        UNUSED(threads);
 
-            libsais_gather_lms_suffixes_8u_omp(T, SA, n, threads, thread_state);
-            libsais_reconstruct_lms_suffixes_omp(SA, n, m, threads);
-        }
+        fast_sint_t omp_block_start   = 0;
+        fast_sint_t omp_block_size    = n;
+#endif
 
-        libsais_place_lms_suffixes_interval_8u(SA, n, m, buckets);
-    }
-    else
-    {
-        memset(SA, 0, (size_t)n * sizeof(sa_sint_t));
+        libsais_mark_alphabet_32s(T, SA, omp_block_start, omp_block_size);
     }
-
-    return libsais_induce_final_order_8u_omp(T, SA, n, k, bwt, r, I, buckets, threads, thread_state);
 }
 
-static sa_sint_t libsais_main(const uint8_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t bwt, sa_sint_t r, sa_sint_t * I, sa_sint_t fs, sa_sint_t * freq, sa_sint_t threads)
+static sa_sint_t libsais_rank_alphabet_32s(sa_sint_t * RESTRICT SA, sa_sint_t k)
 {
-    LIBSAIS_THREAD_STATE *  RESTRICT thread_state   = threads > 1 ? libsais_alloc_thread_state(threads) : NULL;
-    sa_sint_t *             RESTRICT buckets        = (sa_sint_t *)libsais_alloc_aligned((size_t)8 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
+    sa_sint_t d = 0;
 
-    sa_sint_t index = buckets != NULL && (thread_state != NULL || threads == 1)
-        ? libsais_main_8u(T, SA, n, buckets, bwt, r, I, fs, freq, threads, thread_state)
-        : -2;
+    fast_sint_t c; for (c = 0; c < (fast_sint_t)k; c += 1) { if (SA[c] < 0) { SA[c] = d++ | SAINT_MIN; } }
 
-    libsais_free_aligned(buckets);
-    libsais_free_thread_state(thread_state);
+    return d;
+}
 
-    return index;
+static void libsais_unrank_alphabet_32s(const sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT alphabet)
+{
+    fast_sint_t c; for (c = 0; c < (fast_sint_t)k; c += 1) { if (SA[c] < 0) { alphabet[SA[c] & SAINT_MAX] = (sa_sint_t)c; } }
 }
 
-static sa_sint_t libsais_main_int(sa_sint_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads)
+static void libsais_remap_alphabet_32s(sa_sint_t * RESTRICT T, const sa_sint_t * RESTRICT map, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    LIBSAIS_THREAD_STATE * RESTRICT thread_state = threads > 1 ? libsais_alloc_thread_state(threads) : NULL;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
-    sa_sint_t index = thread_state != NULL || threads == 1
-        ? libsais_main_32s_entry(T, SA, n, k, fs, threads, thread_state)
-        : -2;
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
+    {
+        libsais_prefetchw(&T[i + 2 * prefetch_distance]);
 
-    libsais_free_thread_state(thread_state);
+        libsais_prefetchr(&map[T[i + prefetch_distance + 0]]);
+        libsais_prefetchr(&map[T[i + prefetch_distance + 1]]);
+        libsais_prefetchr(&map[T[i + prefetch_distance + 2]]);
+        libsais_prefetchr(&map[T[i + prefetch_distance + 3]]);
 
-    return index;
-}
+        T[i + 0] = map[T[i + 0]] & SAINT_MAX;
+        T[i + 1] = map[T[i + 1]] & SAINT_MAX;
+        T[i + 2] = map[T[i + 2]] & SAINT_MAX;
+        T[i + 3] = map[T[i + 3]] & SAINT_MAX;
+    }
 
-static sa_sint_t libsais_main_ctx(const LIBSAIS_CONTEXT * ctx, const uint8_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t bwt, sa_sint_t r, sa_sint_t * I, sa_sint_t fs, sa_sint_t * freq)
-{
-    return ctx != NULL && (ctx->buckets != NULL && (ctx->thread_state != NULL || ctx->threads == 1))
-        ? libsais_main_8u(T, SA, n, ctx->buckets, bwt, r, I, fs, freq, (sa_sint_t)ctx->threads, ctx->thread_state)
-        : -2;
-}
-
-static void libsais_bwt_copy_8u(uint8_t * RESTRICT U, sa_sint_t * RESTRICT A, sa_sint_t n)
-{
-    const fast_sint_t prefetch_distance = 32;
-
-    fast_sint_t i, j;
-    for (i = 0, j = (fast_sint_t)n - 7; i < j; i += 8)
-    {
-        libsais_prefetchr(&A[i + prefetch_distance]);
-
-        U[i + 0] = (uint8_t)A[i + 0];
-        U[i + 1] = (uint8_t)A[i + 1];
-        U[i + 2] = (uint8_t)A[i + 2];
-        U[i + 3] = (uint8_t)A[i + 3];
-        U[i + 4] = (uint8_t)A[i + 4];
-        U[i + 5] = (uint8_t)A[i + 5];
-        U[i + 6] = (uint8_t)A[i + 6];
-        U[i + 7] = (uint8_t)A[i + 7];
-    }
-
-    for (j += 7; i < j; i += 1)
+    for (j += prefetch_distance + 3; i < j; i += 1)
     {
-        U[i] = (uint8_t)A[i];
+        T[i] = map[T[i]] & SAINT_MAX;
     }
 }
 
-#if defined(LIBSAIS_OPENMP)
-
-static void libsais_bwt_copy_8u_omp(uint8_t * RESTRICT U, sa_sint_t * RESTRICT A, sa_sint_t n, sa_sint_t threads)
+static void libsais_remap_alphabet_32s_omp(sa_sint_t * RESTRICT T, sa_sint_t n, const sa_sint_t * RESTRICT map, sa_sint_t threads)
 {
 #if defined(LIBSAIS_OPENMP)
     #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
@@ -6589,424 +7647,1405 @@ static void libsais_bwt_copy_8u_omp(uint8_t * RESTRICT U, sa_sint_t * RESTRICT A
 #if defined(LIBSAIS_OPENMP)
         fast_sint_t omp_thread_num    = omp_get_thread_num();
         fast_sint_t omp_num_threads   = omp_get_num_threads();
-        fast_sint_t omp_block_stride  = ((fast_sint_t)n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
         fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
-        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : (fast_sint_t)n - omp_block_start;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
 #else
         UNUSED(threads);
 
         fast_sint_t omp_block_start   = 0;
-        fast_sint_t omp_block_size    = (fast_sint_t)n;
+        fast_sint_t omp_block_size    = n;
 #endif
 
-        libsais_bwt_copy_8u(U + omp_block_start, A + omp_block_start, (sa_sint_t)omp_block_size);
+        libsais_remap_alphabet_32s(T, map, omp_block_start, omp_block_size);
     }
 }
 
-#endif
-
-void * libsais_create_ctx(void)
-{
-    return (void *)libsais_create_ctx_main(1);
-}
-
-void libsais_free_ctx(void * ctx)
+static sa_sint_t libsais_main_32s_compact(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t * RESTRICT local_buffer, sa_sint_t local_buffer_size, const LIBSAIS_ALLOCATOR * allocator, LIBSAIS_MONITOR * monitor)
 {
-    libsais_free_ctx_main((LIBSAIS_CONTEXT *)ctx);
-}
+    fs = fs < (SAINT_MAX - n) ? fs : (SAINT_MAX - n);
 
-int32_t libsais(const uint8_t * T, int32_t * SA, int32_t n, int32_t fs, int32_t * freq)
-{
-    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
-    {
-        return -1;
-    }
-    else if (n < 2)
+    if (k > 0 && fs / k < 6)
     {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
-        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
-        return 0;
+        sa_sint_t * RESTRICT buffer = k > n + fs ? (sa_sint_t *)libsais_alloc_memory(allocator, (size_t)k * sizeof(sa_sint_t), 4096) : NULL;
+        sa_sint_t * RESTRICT ranks  = k > n + fs ? buffer : SA;
+
+        if (ranks != NULL)
+        {
+            memset(ranks, 0, (size_t)k * sizeof(sa_sint_t));
+            libsais_mark_alphabet_32s_omp(T, ranks, n, threads);
+
+            sa_sint_t d = libsais_rank_alphabet_32s(ranks, k);
+            if (d + d <= k || fs / d > fs / k)
+            {
+                sa_sint_t * RESTRICT alphabet = buffer != NULL ? buffer : (sa_sint_t *)libsais_alloc_memory(allocator, (size_t)d * sizeof(sa_sint_t), 4096);
+                if (alphabet != NULL)
+                {
+                    libsais_remap_alphabet_32s_omp(T, n, ranks, threads);
+                    libsais_unrank_alphabet_32s(ranks, k, alphabet);
+
+                    sa_sint_t index = libsais_main_32s_entry(T, SA, n, d, fs, threads, thread_state, local_buffer, local_buffer_size, allocator, monitor, 0);
+                    if (index == 0)
+                    {
+                        libsais_remap_alphabet_32s_omp(T, n, alphabet, threads);
+                    }
+
+                    libsais_free_memory(allocator, alphabet);
+                    return index;
+                }
+            }
+
+            libsais_free_memory(allocator, buffer);
+        }
     }
 
-    return libsais_main(T, SA, n, 0, 0, NULL, fs, freq, 1);
+    return libsais_main_32s_entry(T, SA, n, k, fs, threads, thread_state, local_buffer, local_buffer_size, allocator, monitor, 0);
 }
 
-int32_t libsais_int(int32_t * T, int32_t * SA, int32_t n, int32_t k, int32_t fs)
+static void libsais_gsa_rename_separator_lms_suffixes_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n)
 {
-    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
+    fast_sint_t i, j;
+    for (i = 1, j = 0; i < (fast_sint_t)n - 1; i += 1)
     {
-        return -1;
+        if (T[i] == 0 && T[i - 1] != 0) { SA[j++] = (sa_sint_t)i | SAINT_MIN; }
     }
-    else if (n < 2)
+}
+
+static void libsais_gsa_split_last_lms_suffix_group_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t m)
+{
+    fast_sint_t l = (fast_sint_t)n - 2; while (l >= 0 && T[l] >= T[l + 1]) { l--; }
+    while (l > 0 && T[l - 1] <= T[l]) { l--; }
+
+    if (l <= 0 || T[l] == 0) { return; }
+
+    fast_sint_t i = 0; while ((SA[i] & SAINT_MAX) != (sa_sint_t)l) { i++; }
+    if (i + 1 >= (fast_sint_t)m) { return; }
+
+    fast_sint_t len = (fast_sint_t)n - 1 - l, p = (fast_sint_t)(SA[i + 1] & SAINT_MAX) + len, t = p;
+    while (t < (fast_sint_t)n - 1 && T[t] == T[t + 1]) { t++; }
+
+    if (T[p - 1] > T[p] && t < (fast_sint_t)n - 1 && T[t] < T[t + 1] && memcmp(&T[SA[i + 1] & SAINT_MAX], &T[l], (size_t)len * sizeof(uint8_t)) == 0)
     {
-        if (n == 1) { SA[0] = 0; }
-        return 0;
-    }
+        fast_sint_t j = i + 1; while (SA[j] > 0) { j++; }
 
-    return libsais_main_int(T, SA, n, k, fs, 1);
+        fast_sint_t k = i; SA[i] = (sa_sint_t)l;
+        for (t = i + 1; t <= j; t += 1)
+        {
+            sa_sint_t q = SA[t] & SAINT_MAX; SA[t] = q;
+            if (T[q + len] == 0) { SA[t] = SA[k]; SA[k++] = q; }
+        }
+
+        for (t = k; SA[t] != (sa_sint_t)l; t += 1) { }
+        SA[t] = SA[k]; SA[k] = (sa_sint_t)l | SAINT_MIN;
+
+        if (k > i) { SA[k - 1] |= SAINT_MIN; }
+        SA[j] |= SAINT_MIN;
+    }
 }
 
-int32_t libsais_ctx(const void * ctx, const uint8_t * T, int32_t * SA, int32_t n, int32_t fs, int32_t * freq)
+static void libsais_gsa_induce_separator_suffixes_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets)
 {
-    if ((ctx == NULL) || (T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
+    sa_sint_t * RESTRICT induction_bucket = &buckets[6 * ALPHABET_SIZE];
+
+    fast_sint_t i;
+    for (i = 0; i < (fast_sint_t)buckets[7 * ALPHABET_SIZE]; i += 1)
     {
-        return -1;
+        sa_sint_t p = SA[i]; SA[i] = 0; if (p > 0) { p--; SA[induction_bucket[T[p]]++] = p | ((sa_sint_t)(T[p - (p > 0)] < T[p]) << (SAINT_BIT - 1)); }
     }
-    else if (n < 2)
+}
+
+static void libsais_gsa_place_separator_suffixes_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n)
+{
+    fast_sint_t i, j;
+    for (i = 0, j = 0; i < (fast_sint_t)n; i += 1)
     {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
-        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
-        return 0;
+        if (T[i] == 0) { SA[j++] = (sa_sint_t)i; }
     }
-
-    return libsais_main_ctx((const LIBSAIS_CONTEXT *)ctx, T, SA, n, 0, 0, NULL, fs, freq);
 }
 
-int32_t libsais_bwt(const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq)
+static sa_sint_t libsais_main_8u(const uint8_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t * RESTRICT buckets, sa_sint_t bwt, sa_sint_t r, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t fs, sa_sint_t * freq, sa_sint_t gsa, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t * RESTRICT local_buffer, sa_sint_t local_buffer_size, const LIBSAIS_ALLOCATOR * allocator, LIBSAIS_MONITOR * monitor)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0))
-    { 
-        return -1; 
+    fs = fs < (SAINT_MAX - n) ? fs : (SAINT_MAX - n);
+    threads = libsais_adaptive_threads(monitor, threads, n, ALPHABET_SIZE);
+
+    if (thread_state != NULL) { thread_state[0].state.monitor = monitor; }
+
+    libsais_profile(monitor, LIBSAIS_PHASE_LEVEL, 0, 0, n, ALPHABET_SIZE, LIBSAIS_PROFILE_NONE);
+
+    libsais_profile(monitor, LIBSAIS_PHASE_GATHER, 0, 0, n, ALPHABET_SIZE, LIBSAIS_PROFILE_NONE);
+    sa_sint_t m = libsais_count_and_gather_lms_suffixes_8u_omp(T, SA, n, buckets, threads, thread_state);
+    sa_sint_t k = libsais_initialize_buckets_start_and_end_8u(buckets, freq);
+    libsais_profile(monitor, LIBSAIS_PHASE_GATHER, 1, 0, n, ALPHABET_SIZE, LIBSAIS_PROFILE_NONE);
+
+    if (m > 0)
+    {
+        libsais_profile(monitor, LIBSAIS_PHASE_RADIX_SORT, 0, 0, n, ALPHABET_SIZE, LIBSAIS_PROFILE_NONE);
+        sa_sint_t first_lms_suffix    = SA[n - m];
+        sa_sint_t left_suffixes_count = libsais_initialize_buckets_for_lms_suffixes_radix_sort_8u(T, buckets, first_lms_suffix);
+
+        if (threads > 1 && n >= 65536) { memset(SA, 0, ((size_t)n - (size_t)m) * sizeof(sa_sint_t)); }
+        libsais_radix_sort_lms_suffixes_8u_omp(T, SA, n, m, buckets, libsais_adaptive_threads(monitor, threads, m, ALPHABET_SIZE) == threads ? threads : 1, thread_state);
+        if (threads > 1 && n >= 65536) { memset(&SA[(fast_sint_t)n - (fast_sint_t)m], 0, (size_t)m * sizeof(sa_sint_t)); }
+        libsais_profile(monitor, LIBSAIS_PHASE_RADIX_SORT, 1, 0, n, ALPHABET_SIZE, LIBSAIS_PROFILE_NONE);
+        if (libsais_cancelled(monitor)) { return -5; }
+
+        libsais_profile(monitor, LIBSAIS_PHASE_PARTIAL_SORT, 0, 0, n, ALPHABET_SIZE, LIBSAIS_PROFILE_NONE);
+        libsais_initialize_buckets_for_partial_sorting_8u(T, buckets, first_lms_suffix, left_suffixes_count);
+        libsais_induce_partial_order_8u_omp(T, SA, n, k, buckets, first_lms_suffix, left_suffixes_count, threads, thread_state);
+        if (libsais_cancelled(monitor)) { return -5; }
+        if (gsa) { libsais_gsa_rename_separator_lms_suffixes_8u(T, SA, n); libsais_gsa_split_last_lms_suffix_group_8u(T, SA, n, m); }
+        libsais_profile(monitor, LIBSAIS_PHASE_PARTIAL_SORT, 1, 0, n, ALPHABET_SIZE, LIBSAIS_PROFILE_NONE);
+
+        libsais_profile(monitor, LIBSAIS_PHASE_RENUMBER, 0, 0, n, ALPHABET_SIZE, LIBSAIS_PROFILE_NONE);
+        sa_sint_t names = libsais_renumber_and_gather_lms_suffixes_omp(SA, n, m, fs, threads, thread_state);
+        libsais_profile(monitor, LIBSAIS_PHASE_RENUMBER, 1, 0, m, names, LIBSAIS_PROFILE_NONE);
+
+        if (names < m)
+        {
+            sa_sint_t status = libsais_main_32s_entry(SA + n + fs - m, SA, m, names, fs + n - 2 * m, threads, thread_state, local_buffer, local_buffer_size, allocator, monitor, 1);
+            if (status != 0)
+            {
+                return status;
+            }
+
+            libsais_profile(monitor, LIBSAIS_PHASE_RECONSTRUCT, 0, 0, n, ALPHABET_SIZE, LIBSAIS_PROFILE_NONE);
+            libsais_gather_lms_suffixes_8u_omp(T, SA, n, threads, thread_state);
+            libsais_reconstruct_lms_suffixes_omp(SA, n, m, threads);
+            libsais_profile(monitor, LIBSAIS_PHASE_RECONSTRUCT, 1, 0, n, ALPHABET_SIZE, LIBSAIS_PROFILE_NONE);
+        }
+
+        libsais_profile(monitor, LIBSAIS_PHASE_FINAL_SORT, 0, 0, n, ALPHABET_SIZE, LIBSAIS_PROFILE_NONE);
+        libsais_place_lms_suffixes_interval_8u(SA, n, m, buckets);
     }
-    else if (n <= 1) 
-    { 
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
-        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
-        return n;
+    else
+    {
+        libsais_profile(monitor, LIBSAIS_PHASE_FINAL_SORT, 0, 0, n, ALPHABET_SIZE, LIBSAIS_PROFILE_NONE);
+        memset(SA, 0, (size_t)n * sizeof(sa_sint_t));
     }
 
-    sa_sint_t index = libsais_main(T, A, n, 1, 0, NULL, fs, freq, 1);
-    if (index >= 0) 
-    { 
-        index++;
+    if (gsa) { libsais_gsa_induce_separator_suffixes_8u(T, SA, buckets); }
 
-        U[0] = T[n - 1];
-        libsais_bwt_copy_8u(U + 1, A, index - 1);
-        libsais_bwt_copy_8u(U + index, A + index, n - index);
-    }
+    sa_sint_t index = libsais_induce_final_order_8u_omp(T, SA, n, k, bwt, r, I, S, buckets, threads, thread_state);
+    libsais_profile(monitor, LIBSAIS_PHASE_FINAL_SORT, 1, 0, n, ALPHABET_SIZE, LIBSAIS_PROFILE_NONE);
+    if (libsais_cancelled(monitor)) { return -5; }
 
+    libsais_profile(monitor, LIBSAIS_PHASE_LEVEL, 1, 0, n, ALPHABET_SIZE, LIBSAIS_PROFILE_NONE);
     return index;
 }
 
-int32_t libsais_bwt_aux(const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t r, int32_t * I)
+static sa_sint_t libsais_main_gsa_8u(const uint8_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t * RESTRICT buckets, sa_sint_t fs, sa_sint_t * freq, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t * RESTRICT local_buffer, sa_sint_t local_buffer_size, const LIBSAIS_ALLOCATOR * allocator, LIBSAIS_MONITOR * monitor)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL))
-    { 
-        return -1; 
-    }
-    else if (n <= 1) 
+    sa_sint_t q = n - 1; while (q > 0 && T[q - 1] == 0) { q--; }
+
+    if (q > 0)
     {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
-        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
-        I[0] = n;
-        return 0;
-    }
+        sa_sint_t status = libsais_main_8u(T, SA + (n - 1 - q), q + 1, buckets, 0, 0, NULL, NULL, fs, freq, 1, threads, thread_state, local_buffer, local_buffer_size, allocator, monitor);
+        if (status != 0)
+        {
+            return status;
+        }
 
-    if (libsais_main(T, A, n, 1, r, I, fs, freq, 1) != 0)
+        if (freq != NULL) { freq[0] += n - 1 - q; }
+    }
+    else if (freq != NULL)
     {
-        return -2;
+        memset(freq, 0, ALPHABET_SIZE * sizeof(sa_sint_t)); freq[0] = n;
     }
 
-    U[0] = T[n - 1];
-    libsais_bwt_copy_8u(U + 1, A, I[0] - 1);
-    libsais_bwt_copy_8u(U + I[0], A + I[0], n - I[0]);
+    libsais_gsa_place_separator_suffixes_8u(T, SA, n);
 
     return 0;
 }
 
-int32_t libsais_bwt_ctx(const void * ctx, const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq)
+static sa_sint_t libsais_main(const uint8_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t bwt, sa_sint_t r, sa_sint_t * I, sa_sint_t * S, sa_sint_t fs, sa_sint_t * freq, sa_sint_t threads)
 {
-    if ((ctx == NULL) || (T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0))
-    { 
-        return -1; 
-    }
-    else if (n <= 1) 
-    {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
-        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
-        return n;
-    }
-
-    sa_sint_t index = libsais_main_ctx((const LIBSAIS_CONTEXT *)ctx, T, A, n, 1, 0, NULL, fs, freq);
-    if (index >= 0) 
-    { 
-        index++;
+    LIBSAIS_THREAD_STATE *  RESTRICT thread_state   = threads > 1 ? libsais_alloc_thread_state(threads, NULL) : NULL;
+    sa_sint_t *             RESTRICT buckets        = (sa_sint_t *)libsais_alloc_aligned((size_t)8 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
 
-        U[0] = T[n - 1];
+    sa_sint_t index = buckets != NULL && (thread_state != NULL || threads == 1)
+        ? libsais_main_8u(T, SA, n, buckets, bwt, r, I, S, fs, freq, 0, threads, thread_state, NULL, LIBSAIS_LOCAL_BUFFER_SIZE, NULL, NULL)
+        : -2;
 
-#if defined(LIBSAIS_OPENMP)
-        libsais_bwt_copy_8u_omp(U + 1, A, index - 1, (sa_sint_t)((const LIBSAIS_CONTEXT *)ctx)->threads);
-        libsais_bwt_copy_8u_omp(U + index, A + index, n - index, (sa_sint_t)((const LIBSAIS_CONTEXT *)ctx)->threads);
-#else
-        libsais_bwt_copy_8u(U + 1, A, index - 1);
-        libsais_bwt_copy_8u(U + index, A + index, n - index);
-#endif
-    }
+    libsais_free_aligned(buckets);
+    libsais_free_thread_state(thread_state, NULL);
 
     return index;
 }
 
-int32_t libsais_bwt_aux_ctx(const void * ctx, const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t r, int32_t * I)
+static sa_sint_t libsais_main_gsa(const uint8_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t fs, sa_sint_t * freq, sa_sint_t threads)
 {
-    if ((ctx == NULL) || (T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL))
-    { 
-        return -1; 
-    }
-    else if (n <= 1) 
-    {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
-        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
-        I[0] = n;
-        return 0;
-    }
-
-    if (libsais_main_ctx((const LIBSAIS_CONTEXT *)ctx, T, A, n, 1, r, I, fs, freq) != 0)
-    {
-        return -2;
-    }
+    LIBSAIS_THREAD_STATE *  RESTRICT thread_state   = threads > 1 ? libsais_alloc_thread_state(threads, NULL) : NULL;
+    sa_sint_t *             RESTRICT buckets        = (sa_sint_t *)libsais_alloc_aligned((size_t)8 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
 
-    U[0] = T[n - 1];
+    sa_sint_t index = buckets != NULL && (thread_state != NULL || threads == 1)
+        ? libsais_main_gsa_8u(T, SA, n, buckets, fs, freq, threads, thread_state, NULL, LIBSAIS_LOCAL_BUFFER_SIZE, NULL, NULL)
+        : -2;
 
-#if defined(LIBSAIS_OPENMP)
-    libsais_bwt_copy_8u_omp(U + 1, A, I[0] - 1, (sa_sint_t)((const LIBSAIS_CONTEXT *)ctx)->threads);
-    libsais_bwt_copy_8u_omp(U + I[0], A + I[0], n - I[0], (sa_sint_t)((const LIBSAIS_CONTEXT *)ctx)->threads);
-#else
-    libsais_bwt_copy_8u(U + 1, A, I[0] - 1);
-    libsais_bwt_copy_8u(U + I[0], A + I[0], n - I[0]);
-#endif
+    libsais_free_aligned(buckets);
+    libsais_free_thread_state(thread_state, NULL);
 
-    return 0;
+    return index;
 }
 
-#if defined(LIBSAIS_OPENMP)
-
-void * libsais_create_ctx_omp(int32_t threads)
+static sa_sint_t libsais_main_int(sa_sint_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads)
 {
-    if (threads < 0) { return NULL; }
+    LIBSAIS_THREAD_STATE * RESTRICT thread_state = threads > 1 ? libsais_alloc_thread_state(threads, NULL) : NULL;
 
-    threads = threads > 0 ? threads : omp_get_max_threads();
-    return (void *)libsais_create_ctx_main(threads);
+    sa_sint_t index = thread_state != NULL || threads == 1
+        ? libsais_main_32s_compact(T, SA, n, k, fs, threads, thread_state, NULL, LIBSAIS_LOCAL_BUFFER_SIZE, NULL, NULL)
+        : -2;
+
+    libsais_free_thread_state(thread_state, NULL);
+
+    return index;
 }
 
-int32_t libsais_omp(const uint8_t * T, int32_t * SA, int32_t n, int32_t fs, int32_t * freq, int32_t threads)
+static sa_sint_t libsais_main_ctx(const LIBSAIS_CONTEXT * ctx, const uint8_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t bwt, sa_sint_t r, sa_sint_t * I, sa_sint_t * S, sa_sint_t fs, sa_sint_t * freq)
 {
-    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0) || (threads < 0))
+    if (ctx != NULL && (ctx->buckets != NULL && (ctx->thread_state != NULL || ctx->threads == 1)))
     {
-        return -1;
+        libsais_numa_place_omp(ctx, SA, n, fs);
+
+        LIBSAIS_MONITOR monitor = ctx->monitor;
+        if (ctx->numa != LIBSAIS_NUMA_NONE) { monitor.thread_block_size = 0; }
+        return libsais_ctx_status(ctx, libsais_main_8u(T, SA, n, ctx->buckets, bwt, r, I, S, fs, freq, 0, (sa_sint_t)ctx->threads, ctx->thread_state, ctx->local_buffer, (sa_sint_t)ctx->local_buffer_size, &ctx->allocator, &monitor));
     }
-    else if (n < 2)
+
+    return -2;
+}
+
+static sa_sint_t libsais_main_gsa_ctx(const LIBSAIS_CONTEXT * ctx, const uint8_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t fs, sa_sint_t * freq)
+{
+    if (ctx != NULL && (ctx->buckets != NULL && (ctx->thread_state != NULL || ctx->threads == 1)))
     {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
-        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
-        return 0;
-    }
+        libsais_numa_place_omp(ctx, SA, n, fs);
 
-    threads = threads > 0 ? threads : omp_get_max_threads();
+        LIBSAIS_MONITOR monitor = ctx->monitor;
+        if (ctx->numa != LIBSAIS_NUMA_NONE) { monitor.thread_block_size = 0; }
+        return libsais_ctx_status(ctx, libsais_main_gsa_8u(T, SA, n, ctx->buckets, fs, freq, (sa_sint_t)ctx->threads, ctx->thread_state, ctx->local_buffer, (sa_sint_t)ctx->local_buffer_size, &ctx->allocator, &monitor));
+    }
 
-    return libsais_main(T, SA, n, 0, 0, NULL, fs, freq, threads);
+    return -2;
 }
 
-int32_t libsais_int_omp(int32_t * T, int32_t * SA, int32_t n, int32_t k, int32_t fs, int32_t threads)
+static sa_sint_t libsais_main_int_ctx(const LIBSAIS_CONTEXT * ctx, sa_sint_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs)
 {
-    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0) || (threads < 0))
+    if (ctx != NULL && (ctx->thread_state != NULL || ctx->threads == 1))
     {
-        return -1;
-    }
-    else if (n < 2)
-    {
-        if (n == 1) { SA[0] = 0; }
-        return 0;
-    }
+        libsais_numa_place_omp(ctx, SA, n, fs);
 
-    threads = threads > 0 ? threads : omp_get_max_threads();
+        LIBSAIS_MONITOR monitor = ctx->monitor;
+        if (ctx->numa != LIBSAIS_NUMA_NONE) { monitor.thread_block_size = 0; }
+        return libsais_ctx_status(ctx, libsais_main_32s_compact(T, SA, n, k, fs, (sa_sint_t)ctx->threads, ctx->thread_state, ctx->local_buffer, (sa_sint_t)ctx->local_buffer_size, &ctx->allocator, &monitor));
+    }
 
-    return libsais_main_int(T, SA, n, k, fs, threads);
+    return -2;
 }
 
-int32_t libsais_bwt_omp(const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t threads)
+static void libsais_bwt_copy_8u(uint8_t * RESTRICT U, sa_sint_t * RESTRICT A, sa_sint_t n)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (threads < 0))
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = 0, j = (fast_sint_t)n - 7; i < j; i += 8)
     {
-        return -1;
+        libsais_prefetchr(&A[i + prefetch_distance]);
+
+        U[i + 0] = (uint8_t)A[i + 0];
+        U[i + 1] = (uint8_t)A[i + 1];
+        U[i + 2] = (uint8_t)A[i + 2];
+        U[i + 3] = (uint8_t)A[i + 3];
+        U[i + 4] = (uint8_t)A[i + 4];
+        U[i + 5] = (uint8_t)A[i + 5];
+        U[i + 6] = (uint8_t)A[i + 6];
+        U[i + 7] = (uint8_t)A[i + 7];
     }
-    else if (n <= 1)
+
+    for (j += 7; i < j; i += 1)
     {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
-        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
-        return n;
+        U[i] = (uint8_t)A[i];
     }
+}
 
-    threads = threads > 0 ? threads : omp_get_max_threads();
+static fast_sint_t libsais_rlbwt_gather_range_8u(const sa_sint_t * RESTRICT A, uint8_t * RESTRICT C, sa_sint_t * RESTRICT L, fast_sint_t c, fast_sint_t count, fast_sint_t rs, fast_sint_t offset, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
-    sa_sint_t index = libsais_main(T, A, n, 1, 0, NULL, fs, freq, threads);
-    if (index >= 0)
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size; i < j; i += 1)
     {
-        index++;
+        libsais_prefetchr(&A[i + prefetch_distance]);
 
-        U[0] = T[n - 1];
-        libsais_bwt_copy_8u_omp(U + 1, A, index - 1, threads);
-        libsais_bwt_copy_8u_omp(U + index, A + index, n - index, threads);
+        fast_sint_t s = (uint8_t)A[i];
+        if (s != c) { if (count < rs) { C[count] = (uint8_t)s; L[count] = (sa_sint_t)(i + offset); } count++; c = s; }
     }
 
-    return index;
+    return count;
 }
 
-int32_t libsais_bwt_aux_omp(const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t r, int32_t * I, int32_t threads)
+static fast_sint_t libsais_rlbwt_gather_runs_8u(const sa_sint_t * RESTRICT A, uint8_t * RESTRICT C, sa_sint_t * RESTRICT L, fast_sint_t index, fast_sint_t count, fast_sint_t rs, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL) || (threads < 0))
+    fast_sint_t p = index - 1, i = omp_block_start, j = omp_block_start + omp_block_size, c = -1;
+
+    if (i > 0) { c = (uint8_t)A[i - 1 == 0 ? p : i - 1 <= p ? i - 2 : i - 1]; }
+
+    if (i == 0 && i < j)
     {
-        return -1;
+        c = (uint8_t)A[p]; if (count < rs) { C[count] = (uint8_t)c; L[count] = 0; } count++; i = 1;
     }
-    else if (n <= 1)
+
+    if (i <= p && i < j)
     {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
-        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
-        I[0] = n;
-        return 0;
+        fast_sint_t e = j < p + 1 ? j : p + 1;
+        count = libsais_rlbwt_gather_range_8u(A, C, L, c, count, rs, 1, i - 1, e - i);
+        c = (uint8_t)A[e - 2]; i = e;
     }
 
-    threads = threads > 0 ? threads : omp_get_max_threads();
-
-    if (libsais_main(T, A, n, 1, r, I, fs, freq, threads) != 0)
+    if (i < j)
     {
-        return -2;
+        count = libsais_rlbwt_gather_range_8u(A, C, L, c, count, rs, 0, i, j - i);
     }
 
-    U[0] = T[n - 1];
-    libsais_bwt_copy_8u_omp(U + 1, A, I[0] - 1, threads);
-    libsais_bwt_copy_8u_omp(U + I[0], A + I[0], n - I[0], threads);
-
-    return 0;
+    return count;
 }
 
-#endif
+static void libsais_rlbwt_convert_runs(sa_sint_t * RESTRICT L, fast_sint_t next, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - 1; i < j; i += 1)
+    {
+        L[i] = L[i + 1] - L[i];
+    }
+
+    if (omp_block_size > 0) { L[j] = (sa_sint_t)next - L[j]; }
+}
 
-static LIBSAIS_UNBWT_CONTEXT * libsais_unbwt_create_ctx_main(sa_sint_t threads)
+static sa_sint_t libsais_rlbwt_encode_8u_omp(const sa_sint_t * RESTRICT A, uint8_t * RESTRICT C, sa_sint_t * RESTRICT L, sa_sint_t n, sa_sint_t index, sa_sint_t rs, sa_sint_t threads)
 {
-    LIBSAIS_UNBWT_CONTEXT *     RESTRICT ctx            = (LIBSAIS_UNBWT_CONTEXT *)libsais_alloc_aligned(sizeof(LIBSAIS_UNBWT_CONTEXT), 64);
-    sa_uint_t *                 RESTRICT bucket2        = (sa_uint_t *)libsais_alloc_aligned(ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_uint_t), 4096);
-    uint16_t *                  RESTRICT fastbits       = (uint16_t *)libsais_alloc_aligned((1 + (1 << UNBWT_FASTBITS)) * sizeof(uint16_t), 4096);
-    sa_uint_t *                 RESTRICT buckets        = threads > 1 ? (sa_uint_t *)libsais_alloc_aligned((size_t)threads * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE)) * sizeof(sa_uint_t), 4096) : NULL;
+    fast_sint_t count = 0;
 
-    if (ctx != NULL && bucket2 != NULL && fastbits != NULL && (buckets != NULL || threads == 1))
+#if defined(LIBSAIS_OPENMP)
+    fast_sint_t * RESTRICT counts = threads > 1 && n >= 65536 ? (fast_sint_t *)libsais_alloc_aligned((size_t)threads * sizeof(fast_sint_t), 64) : NULL;
+    if (threads > 1 && n >= 65536 && counts == NULL) { return -2; }
+
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
     {
-        ctx->bucket2    = bucket2;
-        ctx->fastbits   = fastbits;
-        ctx->buckets    = buckets;
-        ctx->threads    = threads;
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
 
-        return ctx;
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        if (omp_num_threads == 1)
+        {
+            count = libsais_rlbwt_gather_runs_8u(A, C, L, index, 0, rs, omp_block_start, omp_block_size);
+            if (count <= rs) { libsais_rlbwt_convert_runs(L, n, 0, count); }
+        }
+#if defined(LIBSAIS_OPENMP)
+        else
+        {
+            counts[omp_thread_num] = libsais_rlbwt_gather_runs_8u(A, C, L, index, 0, 0, omp_block_start, omp_block_size);
+
+            #pragma omp barrier
+
+            fast_sint_t t, c = 0, total = 0; for (t = 0; t < omp_num_threads; ++t) { c += t < omp_thread_num ? counts[t] : 0; total += counts[t]; }
+
+            if (total <= rs)
+            {
+                libsais_rlbwt_gather_runs_8u(A, C, L, index, c, rs, omp_block_start, omp_block_size);
+
+                #pragma omp barrier
+
+                fast_sint_t next = c + counts[omp_thread_num] < total ? L[c + counts[omp_thread_num]] : n;
+
+                #pragma omp barrier
+
+                libsais_rlbwt_convert_runs(L, next, c, counts[omp_thread_num]);
+            }
+
+            if (omp_thread_num == omp_num_threads - 1) { count = total; }
+        }
+#endif
     }
 
-    libsais_free_aligned(buckets);
-    libsais_free_aligned(fastbits);
-    libsais_free_aligned(bucket2);
-    libsais_free_aligned(ctx);
+#if defined(LIBSAIS_OPENMP)
+    libsais_free_aligned(counts);
+#endif
 
-    return NULL;
+    return (sa_sint_t)count;
 }
 
-static void libsais_unbwt_free_ctx_main(LIBSAIS_UNBWT_CONTEXT * ctx)
+
+#if defined(LIBSAIS_OPENMP)
+
+static void libsais_bwt_copy_8u_omp(uint8_t * RESTRICT U, sa_sint_t * RESTRICT A, sa_sint_t n, sa_sint_t threads)
 {
-    if (ctx != NULL)
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
     {
-        libsais_free_aligned(ctx->buckets);
-        libsais_free_aligned(ctx->fastbits);
-        libsais_free_aligned(ctx->bucket2);
-        libsais_free_aligned(ctx);
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+        fast_sint_t omp_block_stride  = ((fast_sint_t)n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : (fast_sint_t)n - omp_block_start;
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_block_start   = 0;
+        fast_sint_t omp_block_size    = (fast_sint_t)n;
+#endif
+
+        libsais_bwt_copy_8u(U + omp_block_start, A + omp_block_start, (sa_sint_t)omp_block_size);
     }
 }
 
-static void libsais_unbwt_compute_histogram(const uint8_t * RESTRICT T, fast_sint_t n, sa_uint_t * RESTRICT count)
+#endif
+
+void * libsais_create_ctx(void)
 {
-    const fast_sint_t prefetch_distance = 256;
+    return (void *)libsais_create_ctx_main(1, NULL);
+}
 
-    const uint8_t * RESTRICT T_p = T;
+void * libsais_create_ctx_alloc(void * (* alloc_fn)(size_t size, size_t alignment, void * opaque), void (* free_fn)(void * address, void * opaque), void * opaque)
+{
+    if ((alloc_fn == NULL) || (free_fn == NULL)) { return NULL; }
 
-    if (n >= 1024)
-    {
-        sa_uint_t copy[4 * (ALPHABET_SIZE + 16)];
+    LIBSAIS_ALLOCATOR allocator = { alloc_fn, free_fn, opaque };
+    return (void *)libsais_create_ctx_main(1, &allocator);
+}
 
-        memset(copy, 0, (size_t)4 * (ALPHABET_SIZE + 16) * sizeof(sa_uint_t));
+void * libsais_create_ctx_buffer(void * buffer, size_t size)
+{
+    return (void *)libsais_create_ctx_buffer_main(1, buffer, size);
+}
 
-        sa_uint_t * RESTRICT copy0 = copy + 0 * (ALPHABET_SIZE + 16);
-        sa_uint_t * RESTRICT copy1 = copy + 1 * (ALPHABET_SIZE + 16);
-        sa_uint_t * RESTRICT copy2 = copy + 2 * (ALPHABET_SIZE + 16);
-        sa_uint_t * RESTRICT copy3 = copy + 3 * (ALPHABET_SIZE + 16);
+void libsais_free_ctx(void * ctx)
+{
+    libsais_free_ctx_main((LIBSAIS_CONTEXT *)ctx);
+}
 
-        for (; T_p < (uint8_t * )((ptrdiff_t)(T + 63) & (-64)); T_p += 1) { copy0[T_p[0]]++; }
+int64_t libsais_alloc_size(int32_t n, int32_t k, int32_t threads)
+{
+    if ((n < 0) || (k < 0) || (threads < 0))
+    {
+        return -1;
+    }
 
-        fast_uint_t x = ((const uint32_t *)(const void *)T_p)[0], y = ((const uint32_t *)(const void *)T_p)[1];
+#if defined(LIBSAIS_OPENMP)
+    threads = threads > 0 ? threads : omp_get_max_threads();
+#else
+    threads = 1;
+#endif
 
-        for (; T_p < (uint8_t * )((ptrdiff_t)(T + n - 8) & (-64)); T_p += 64)
-        { 
-            libsais_prefetchr(&T_p[prefetch_distance]);
+    return libsais_alloc_size_main(n, k, threads);
+}
 
-            fast_uint_t z = ((const uint32_t *)(const void *)T_p)[2], w = ((const uint32_t *)(const void *)T_p)[3];
-            copy0[(uint8_t)x]++; x >>= 8; copy1[(uint8_t)x]++; x >>= 8; copy2[(uint8_t)x]++; x >>= 8; copy3[x]++;
-            copy0[(uint8_t)y]++; y >>= 8; copy1[(uint8_t)y]++; y >>= 8; copy2[(uint8_t)y]++; y >>= 8; copy3[y]++;
+int64_t libsais_scratch_size(int32_t n, int32_t k, int32_t fs, int32_t threads, int32_t flags)
+{
+    if ((n < 0) || (k < 0) || (fs < 0) || (threads < 0) || (flags < LIBSAIS_FLAGS_NONE) || (flags > LIBSAIS_FLAGS_BUFFER))
+    {
+        return -1;
+    }
 
-            x = ((const uint32_t *)(const void *)T_p)[4]; y = ((const uint32_t *)(const void *)T_p)[5];
-            copy0[(uint8_t)z]++; z >>= 8; copy1[(uint8_t)z]++; z >>= 8; copy2[(uint8_t)z]++; z >>= 8; copy3[z]++;
-            copy0[(uint8_t)w]++; w >>= 8; copy1[(uint8_t)w]++; w >>= 8; copy2[(uint8_t)w]++; w >>= 8; copy3[w]++;
+#if defined(LIBSAIS_OPENMP)
+    threads = threads > 0 ? threads : omp_get_max_threads();
+#else
+    threads = 1;
+#endif
 
-            z = ((const uint32_t *)(const void *)T_p)[6]; w = ((const uint32_t *)(const void *)T_p)[7];
-            copy0[(uint8_t)x]++; x >>= 8; copy1[(uint8_t)x]++; x >>= 8; copy2[(uint8_t)x]++; x >>= 8; copy3[x]++;
-            copy0[(uint8_t)y]++; y >>= 8; copy1[(uint8_t)y]++; y >>= 8; copy2[(uint8_t)y]++; y >>= 8; copy3[y]++;
+    return libsais_scratch_size_main(n, k, fs, threads, flags);
+}
 
-            x = ((const uint32_t *)(const void *)T_p)[8]; y = ((const uint32_t *)(const void *)T_p)[9];
-            copy0[(uint8_t)z]++; z >>= 8; copy1[(uint8_t)z]++; z >>= 8; copy2[(uint8_t)z]++; z >>= 8; copy3[z]++;
-            copy0[(uint8_t)w]++; w >>= 8; copy1[(uint8_t)w]++; w >>= 8; copy2[(uint8_t)w]++; w >>= 8; copy3[w]++;
+int32_t libsais_set_profiler(void * ctx, void (* profile_fn)(int32_t phase, int32_t end, int32_t depth, int64_t n, int64_t k, int32_t flags, void * opaque), void * opaque)
+{
+    if (ctx == NULL)
+    {
+        return -1;
+    }
 
-            z = ((const uint32_t *)(const void *)T_p)[10]; w = ((const uint32_t *)(const void *)T_p)[11];
-            copy0[(uint8_t)x]++; x >>= 8; copy1[(uint8_t)x]++; x >>= 8; copy2[(uint8_t)x]++; x >>= 8; copy3[x]++;
-            copy0[(uint8_t)y]++; y >>= 8; copy1[(uint8_t)y]++; y >>= 8; copy2[(uint8_t)y]++; y >>= 8; copy3[y]++;
+    LIBSAIS_CONTEXT * RESTRICT context = (LIBSAIS_CONTEXT *)ctx;
 
-            x = ((const uint32_t *)(const void *)T_p)[12]; y = ((const uint32_t *)(const void *)T_p)[13];
-            copy0[(uint8_t)z]++; z >>= 8; copy1[(uint8_t)z]++; z >>= 8; copy2[(uint8_t)z]++; z >>= 8; copy3[z]++;
-            copy0[(uint8_t)w]++; w >>= 8; copy1[(uint8_t)w]++; w >>= 8; copy2[(uint8_t)w]++; w >>= 8; copy3[w]++;
+    context->monitor.profile        = profile_fn;
+    context->monitor.profile_opaque = opaque;
 
-            z = ((const uint32_t *)(const void *)T_p)[14]; w = ((const uint32_t *)(const void *)T_p)[15];
-            copy0[(uint8_t)x]++; x >>= 8; copy1[(uint8_t)x]++; x >>= 8; copy2[(uint8_t)x]++; x >>= 8; copy3[x]++;
-            copy0[(uint8_t)y]++; y >>= 8; copy1[(uint8_t)y]++; y >>= 8; copy2[(uint8_t)y]++; y >>= 8; copy3[y]++;
+    return 0;
+}
 
-            x = ((const uint32_t *)(const void *)T_p)[16]; y = ((const uint32_t *)(const void *)T_p)[17];
-            copy0[(uint8_t)z]++; z >>= 8; copy1[(uint8_t)z]++; z >>= 8; copy2[(uint8_t)z]++; z >>= 8; copy3[z]++;
-            copy0[(uint8_t)w]++; w >>= 8; copy1[(uint8_t)w]++; w >>= 8; copy2[(uint8_t)w]++; w >>= 8; copy3[w]++;
-        }
+int32_t libsais_set_cancel(void * ctx, int32_t (* cancel_fn)(void * opaque), void * opaque)
+{
+    if (ctx == NULL)
+    {
+        return -1;
+    }
 
-        copy0[(uint8_t)x]++; x >>= 8; copy1[(uint8_t)x]++; x >>= 8; copy2[(uint8_t)x]++; x >>= 8; copy3[x]++;
-        copy0[(uint8_t)y]++; y >>= 8; copy1[(uint8_t)y]++; y >>= 8; copy2[(uint8_t)y]++; y >>= 8; copy3[y]++;
+    LIBSAIS_CONTEXT * RESTRICT context = (LIBSAIS_CONTEXT *)ctx;
 
-        T_p += 8;
+    context->monitor.cancel         = cancel_fn;
+    context->monitor.cancel_opaque  = opaque;
 
-        fast_uint_t i; for (i = 0; i < ALPHABET_SIZE; i++) { count[i] += copy0[i] + copy1[i] + copy2[i] + copy3[i]; }
+    return 0;
+}
+
+int32_t libsais_set_numa(void * ctx, int32_t mode)
+{
+    if ((ctx == NULL) || (mode < LIBSAIS_NUMA_NONE) || (mode > LIBSAIS_NUMA_INTERLEAVE))
+    {
+        return -1;
     }
 
-    for (; T_p < T + n; T_p += 1) { count[T_p[0]]++; }
+    LIBSAIS_CONTEXT * RESTRICT context = (LIBSAIS_CONTEXT *)ctx;
+
+    context->numa = mode;
+    if (mode != LIBSAIS_NUMA_NONE) { libsais_numa_place_thread_state(context->thread_state, context->threads); }
+
+    return 0;
 }
 
-static void libsais_unbwt_transpose_bucket2(sa_uint_t * RESTRICT bucket2)
+int32_t libsais_set_cache_size(void * ctx, int32_t size)
 {
-    fast_uint_t x, y, c, d;
-    for (x = 0; x != ALPHABET_SIZE; x += 16)
+    LIBSAIS_CONTEXT * RESTRICT context = (LIBSAIS_CONTEXT *)ctx;
+
+    if ((context == NULL) || (size < 1024) || ((fast_sint_t)size <= 32 * context->threads))
     {
-        for (c = x; c != x + 16; ++c)
+        return -1;
+    }
+
+    if (context->thread_state != NULL)
+    {
+        LIBSAIS_THREAD_CACHE * RESTRICT cache = (LIBSAIS_THREAD_CACHE *)libsais_alloc_memory(&context->allocator, (size_t)context->threads * (size_t)size * sizeof(LIBSAIS_THREAD_CACHE), 4096);
+        if (cache == NULL)
         {
-            for (d = c + 1; d != x + 16; ++d)
-            {
-                sa_uint_t tmp = bucket2[(d << 8) + c]; bucket2[(d << 8) + c] = bucket2[(c << 8) + d]; bucket2[(c << 8) + d] = tmp;
-            }
+            return libsais_ctx_status(context, -2);
         }
 
-        for (y = x + 16; y != ALPHABET_SIZE; y += 16)
+        libsais_free_memory(&context->allocator, context->thread_state[0].state.cache);
+
+        fast_sint_t t;
+        for (t = 0; t < context->threads; ++t)
         {
-            for (c = x; c != x + 16; ++c)
-            {
-                sa_uint_t * bucket2_yc = &bucket2[(y << 8) + c];
-                sa_uint_t * bucket2_cy = &bucket2[(c << 8) + y];
+            context->thread_state[t].state.cache      = cache + t * (fast_sint_t)size;
+            context->thread_state[t].state.cache_size = (fast_sint_t)size;
+        }
 
-                sa_uint_t tmp00 = bucket2_yc[ 0 * 256]; bucket2_yc[ 0 * 256] = bucket2_cy[ 0]; bucket2_cy[ 0] = tmp00;
+        if (context->numa != LIBSAIS_NUMA_NONE) { libsais_numa_place_thread_state(context->thread_state, context->threads); }
+    }
+
+    return 0;
+}
+
+int32_t libsais_set_local_buffer_size(void * ctx, int32_t size)
+{
+    LIBSAIS_CONTEXT * RESTRICT context = (LIBSAIS_CONTEXT *)ctx;
+
+    if ((context == NULL) || (size < 0))
+    {
+        return -1;
+    }
+
+    sa_sint_t * RESTRICT local_buffer = NULL;
+    if (size > LIBSAIS_LOCAL_BUFFER_SIZE)
+    {
+        local_buffer = (sa_sint_t *)libsais_alloc_memory(&context->allocator, (size_t)size * sizeof(sa_sint_t), 4096);
+        if (local_buffer == NULL)
+        {
+            return libsais_ctx_status(context, -2);
+        }
+    }
+
+    libsais_free_memory(&context->allocator, context->local_buffer);
+
+    context->local_buffer      = local_buffer;
+    context->local_buffer_size  = (fast_sint_t)size;
+
+    return 0;
+}
+
+int32_t libsais_set_adaptive_threads(void * ctx, int32_t block_size)
+{
+    if ((ctx == NULL) || (block_size < 0))
+    {
+        return -1;
+    }
+
+    LIBSAIS_CONTEXT * RESTRICT context = (LIBSAIS_CONTEXT *)ctx;
+
+    context->monitor.thread_block_size = (sa_sint_t)block_size;
+
+    return 0;
+}
+
+int32_t libsais(const uint8_t * T, int32_t * SA, int32_t n, int32_t fs, int32_t * freq)
+{
+    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    return libsais_main(T, SA, n, 0, 0, NULL, NULL, fs, freq, 1);
+}
+
+int32_t libsais_int(int32_t * T, int32_t * SA, int32_t n, int32_t k, int32_t fs)
+{
+    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (n == 1) { SA[0] = 0; }
+        return 0;
+    }
+
+    return libsais_main_int(T, SA, n, k, fs, 1);
+}
+
+int32_t libsais_ctx(const void * ctx, const uint8_t * T, int32_t * SA, int32_t n, int32_t fs, int32_t * freq)
+{
+    if ((ctx == NULL) || (T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    return libsais_main_ctx((const LIBSAIS_CONTEXT *)ctx, T, SA, n, 0, 0, NULL, NULL, fs, freq);
+}
+
+int32_t libsais_int_ctx(const void * ctx, int32_t * T, int32_t * SA, int32_t n, int32_t k, int32_t fs)
+{
+    if ((ctx == NULL) || (T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (n == 1) { SA[0] = 0; }
+        return 0;
+    }
+
+    return libsais_main_int_ctx((const LIBSAIS_CONTEXT *)ctx, T, SA, n, k, fs);
+}
+
+int32_t libsais_gsa(const uint8_t * T, int32_t * SA, int32_t n, int32_t fs, int32_t * freq)
+{
+    if ((T == NULL) || (SA == NULL) || (n < 0) || (n > 0 && T[n - 1] != 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    return libsais_main_gsa(T, SA, n, fs, freq, 1);
+}
+
+int32_t libsais_gsa_ctx(const void * ctx, const uint8_t * T, int32_t * SA, int32_t n, int32_t fs, int32_t * freq)
+{
+    if ((ctx == NULL) || (T == NULL) || (SA == NULL) || (n < 0) || (n > 0 && T[n - 1] != 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    return libsais_main_gsa_ctx((const LIBSAIS_CONTEXT *)ctx, T, SA, n, fs, freq);
+}
+
+int32_t libsais_bwt(const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0))
+    { 
+        return -1; 
+    }
+    else if (n <= 1) 
+    { 
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        return n;
+    }
+
+    sa_sint_t index = libsais_main(T, A, n, 1, 0, NULL, NULL, fs, freq, 1);
+    if (index >= 0) 
+    { 
+        index++;
+
+        U[0] = T[n - 1];
+        libsais_bwt_copy_8u(U + 1, A, index - 1);
+        libsais_bwt_copy_8u(U + index, A + index, n - index);
+    }
+
+    return index;
+}
+
+int32_t libsais_bwt_aux(const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t r, int32_t * I)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL))
+    { 
+        return -1; 
+    }
+    else if (n <= 1) 
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        I[0] = n;
+        return 0;
+    }
+
+    if (libsais_main(T, A, n, 1, r, I, NULL, fs, freq, 1) != 0)
+    {
+        return -2;
+    }
+
+    U[0] = T[n - 1];
+    libsais_bwt_copy_8u(U + 1, A, I[0] - 1);
+    libsais_bwt_copy_8u(U + I[0], A + I[0], n - I[0]);
+
+    return 0;
+}
+
+int32_t libsais_bwt_aux_sa(const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t r, int32_t * I, int32_t * S)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL) || (S == NULL))
+    { 
+        return -1; 
+    }
+    else if (n <= 1) 
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        I[0] = n; S[0] = 0;
+        return 0;
+    }
+
+    if (libsais_main(T, A, n, 1, r, I, S, fs, freq, 1) != 0)
+    {
+        return -2;
+    }
+
+    U[0] = T[n - 1];
+    libsais_bwt_copy_8u(U + 1, A, I[0] - 1);
+    libsais_bwt_copy_8u(U + I[0], A + I[0], n - I[0]);
+
+    return 0;
+}
+
+int32_t libsais_bwt_ctx(const void * ctx, const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq)
+{
+    if ((ctx == NULL) || (T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0))
+    { 
+        return -1; 
+    }
+    else if (n <= 1) 
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        return n;
+    }
+
+    sa_sint_t index = libsais_main_ctx((const LIBSAIS_CONTEXT *)ctx, T, A, n, 1, 0, NULL, NULL, fs, freq);
+    if (index >= 0) 
+    { 
+        index++;
+
+        U[0] = T[n - 1];
+
+#if defined(LIBSAIS_OPENMP)
+        libsais_bwt_copy_8u_omp(U + 1, A, index - 1, (sa_sint_t)((const LIBSAIS_CONTEXT *)ctx)->threads);
+        libsais_bwt_copy_8u_omp(U + index, A + index, n - index, (sa_sint_t)((const LIBSAIS_CONTEXT *)ctx)->threads);
+#else
+        libsais_bwt_copy_8u(U + 1, A, index - 1);
+        libsais_bwt_copy_8u(U + index, A + index, n - index);
+#endif
+    }
+
+    return index;
+}
+
+int32_t libsais_bwt_aux_ctx(const void * ctx, const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t r, int32_t * I)
+{
+    if ((ctx == NULL) || (T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL))
+    { 
+        return -1; 
+    }
+    else if (n <= 1) 
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        I[0] = n;
+        return 0;
+    }
+
+    sa_sint_t index = libsais_main_ctx((const LIBSAIS_CONTEXT *)ctx, T, A, n, 1, r, I, NULL, fs, freq);
+    if (index != 0)
+    {
+        return index;
+    }
+
+    U[0] = T[n - 1];
+
+#if defined(LIBSAIS_OPENMP)
+    libsais_bwt_copy_8u_omp(U + 1, A, I[0] - 1, (sa_sint_t)((const LIBSAIS_CONTEXT *)ctx)->threads);
+    libsais_bwt_copy_8u_omp(U + I[0], A + I[0], n - I[0], (sa_sint_t)((const LIBSAIS_CONTEXT *)ctx)->threads);
+#else
+    libsais_bwt_copy_8u(U + 1, A, I[0] - 1);
+    libsais_bwt_copy_8u(U + I[0], A + I[0], n - I[0]);
+#endif
+
+    return 0;
+}
+
+int32_t libsais_bwt_aux_sa_ctx(const void * ctx, const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t r, int32_t * I, int32_t * S)
+{
+    if ((ctx == NULL) || (T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL) || (S == NULL))
+    { 
+        return -1; 
+    }
+    else if (n <= 1) 
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        I[0] = n; S[0] = 0;
+        return 0;
+    }
+
+    sa_sint_t index = libsais_main_ctx((const LIBSAIS_CONTEXT *)ctx, T, A, n, 1, r, I, S, fs, freq);
+    if (index != 0)
+    {
+        return index;
+    }
+
+    U[0] = T[n - 1];
+
+#if defined(LIBSAIS_OPENMP)
+    libsais_bwt_copy_8u_omp(U + 1, A, I[0] - 1, (sa_sint_t)((const LIBSAIS_CONTEXT *)ctx)->threads);
+    libsais_bwt_copy_8u_omp(U + I[0], A + I[0], n - I[0], (sa_sint_t)((const LIBSAIS_CONTEXT *)ctx)->threads);
+#else
+    libsais_bwt_copy_8u(U + 1, A, I[0] - 1);
+    libsais_bwt_copy_8u(U + I[0], A + I[0], n - I[0]);
+#endif
+
+    return 0;
+}
+
+int32_t libsais_rlbwt(const uint8_t * T, uint8_t * C, int32_t * L, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t rs, int32_t * runs)
+{
+    if ((T == NULL) || (C == NULL) || (L == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (rs < 0) || (runs == NULL))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { if (freq != NULL) { freq[T[0]]++; } A[0] = T[0]; if (rs >= 1) { C[0] = T[0]; L[0] = 1; } }
+        *runs = n;
+        return n;
+    }
+
+    sa_sint_t index = libsais_main(T, A, n, 1, 0, NULL, NULL, fs, freq, 1);
+    if (index >= 0)
+    {
+        index++; A[index - 1] = T[n - 1];
+
+        sa_sint_t count = libsais_rlbwt_encode_8u_omp(A, C, L, n, index, rs, 1);
+        if (count < 0) { return count; }
+
+        *runs = count;
+    }
+
+    return index;
+}
+
+int32_t libsais_rlbwt_encode(const int32_t * A, uint8_t * C, int32_t * L, int32_t n, int32_t i, int32_t rs, int32_t * runs)
+{
+    if ((A == NULL) || (C == NULL) || (L == NULL) || (n < 0) || (i < (n > 0)) || (i > n) || (rs < 0) || (runs == NULL))
+    {
+        return -1;
+    }
+    else if (n == 0)
+    {
+        *runs = 0;
+        return 0;
+    }
+
+    sa_sint_t count = libsais_rlbwt_encode_8u_omp(A, C, L, n, i, rs, 1);
+    if (count < 0) { return count; }
+
+    *runs = count;
+    return 0;
+}
+
+static sa_sint_t libsais_batch_main(const uint8_t * const * T, uint8_t * const * U, sa_sint_t * const * SA, const sa_sint_t * n, const sa_sint_t * fs, sa_sint_t * const * freq, sa_sint_t * result, sa_sint_t count, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && count > 1)
+#else
+    UNUSED(threads);
+#endif
+    {
+        LIBSAIS_CONTEXT * ctx = libsais_create_ctx_main(1, NULL);
+
+        fast_sint_t i;
+
+#if defined(LIBSAIS_OPENMP)
+        #pragma omp for schedule(dynamic, 1)
+#endif
+        for (i = 0; i < (fast_sint_t)count; ++i)
+        {
+            sa_sint_t   job_fs      = fs != NULL ? fs[i] : 0;
+            sa_sint_t * job_freq    = freq != NULL ? freq[i] : NULL;
+
+            result[i] = ctx == NULL ? -2 : U != NULL
+                ? libsais_bwt_ctx(ctx, T[i], U[i], SA[i], n[i], job_fs, job_freq)
+                : libsais_ctx(ctx, T[i], SA[i], n[i], job_fs, job_freq);
+        }
+
+        libsais_free_ctx_main(ctx);
+    }
+
+    fast_sint_t i;
+    for (i = 0; i < (fast_sint_t)count; ++i)
+    {
+        if (result[i] < 0) { return result[i]; }
+    }
+
+    return 0;
+}
+
+int32_t libsais_batch(const uint8_t * const * T, int32_t * const * SA, const int32_t * n, const int32_t * fs, int32_t * const * freq, int32_t * result, int32_t count)
+{
+    if ((T == NULL) || (SA == NULL) || (n == NULL) || (result == NULL) || (count < 0))
+    {
+        return -1;
+    }
+
+    return libsais_batch_main(T, NULL, SA, n, fs, freq, result, count, 1);
+}
+
+int32_t libsais_bwt_batch(const uint8_t * const * T, uint8_t * const * U, int32_t * const * A, const int32_t * n, const int32_t * fs, int32_t * const * freq, int32_t * result, int32_t count)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n == NULL) || (result == NULL) || (count < 0))
+    {
+        return -1;
+    }
+
+    return libsais_batch_main(T, U, A, n, fs, freq, result, count, 1);
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+void * libsais_create_ctx_omp(int32_t threads)
+{
+    if (threads < 0) { return NULL; }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return (void *)libsais_create_ctx_main(threads, NULL);
+}
+
+void * libsais_create_ctx_alloc_omp(int32_t threads, void * (* alloc_fn)(size_t size, size_t alignment, void * opaque), void (* free_fn)(void * address, void * opaque), void * opaque)
+{
+    if ((threads < 0) || (alloc_fn == NULL) || (free_fn == NULL)) { return NULL; }
+
+    LIBSAIS_ALLOCATOR allocator = { alloc_fn, free_fn, opaque };
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return (void *)libsais_create_ctx_main(threads, &allocator);
+}
+
+void * libsais_create_ctx_buffer_omp(int32_t threads, void * buffer, size_t size)
+{
+    if (threads < 0) { return NULL; }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return (void *)libsais_create_ctx_buffer_main(threads, buffer, size);
+}
+
+int32_t libsais_omp(const uint8_t * T, int32_t * SA, int32_t n, int32_t fs, int32_t * freq, int32_t threads)
+{
+    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais_main(T, SA, n, 0, 0, NULL, NULL, fs, freq, threads);
+}
+
+int32_t libsais_int_omp(int32_t * T, int32_t * SA, int32_t n, int32_t k, int32_t fs, int32_t threads)
+{
+    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (n == 1) { SA[0] = 0; }
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais_main_int(T, SA, n, k, fs, threads);
+}
+
+int32_t libsais_gsa_omp(const uint8_t * T, int32_t * SA, int32_t n, int32_t fs, int32_t * freq, int32_t threads)
+{
+    if ((T == NULL) || (SA == NULL) || (n < 0) || (n > 0 && T[n - 1] != 0) || (fs < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais_main_gsa(T, SA, n, fs, freq, threads);
+}
+
+int32_t libsais_bwt_omp(const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        return n;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    sa_sint_t index = libsais_main(T, A, n, 1, 0, NULL, NULL, fs, freq, threads);
+    if (index >= 0)
+    {
+        index++;
+
+        U[0] = T[n - 1];
+        libsais_bwt_copy_8u_omp(U + 1, A, index - 1, threads);
+        libsais_bwt_copy_8u_omp(U + index, A + index, n - index, threads);
+    }
+
+    return index;
+}
+
+int32_t libsais_bwt_aux_omp(const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t r, int32_t * I, int32_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        I[0] = n;
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    if (libsais_main(T, A, n, 1, r, I, NULL, fs, freq, threads) != 0)
+    {
+        return -2;
+    }
+
+    U[0] = T[n - 1];
+    libsais_bwt_copy_8u_omp(U + 1, A, I[0] - 1, threads);
+    libsais_bwt_copy_8u_omp(U + I[0], A + I[0], n - I[0], threads);
+
+    return 0;
+}
+
+int32_t libsais_bwt_aux_sa_omp(const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t r, int32_t * I, int32_t * S, int32_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL) || (S == NULL) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        I[0] = n; S[0] = 0;
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    if (libsais_main(T, A, n, 1, r, I, S, fs, freq, threads) != 0)
+    {
+        return -2;
+    }
+
+    U[0] = T[n - 1];
+    libsais_bwt_copy_8u_omp(U + 1, A, I[0] - 1, threads);
+    libsais_bwt_copy_8u_omp(U + I[0], A + I[0], n - I[0], threads);
+
+    return 0;
+}
+
+int32_t libsais_rlbwt_omp(const uint8_t * T, uint8_t * C, int32_t * L, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t rs, int32_t * runs, int32_t threads)
+{
+    if ((T == NULL) || (C == NULL) || (L == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (rs < 0) || (runs == NULL) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { if (freq != NULL) { freq[T[0]]++; } A[0] = T[0]; if (rs >= 1) { C[0] = T[0]; L[0] = 1; } }
+        *runs = n;
+        return n;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    sa_sint_t index = libsais_main(T, A, n, 1, 0, NULL, NULL, fs, freq, threads);
+    if (index >= 0)
+    {
+        index++; A[index - 1] = T[n - 1];
+
+        sa_sint_t count = libsais_rlbwt_encode_8u_omp(A, C, L, n, index, rs, threads);
+        if (count < 0) { return count; }
+
+        *runs = count;
+    }
+
+    return index;
+}
+
+int32_t libsais_rlbwt_encode_omp(const int32_t * A, uint8_t * C, int32_t * L, int32_t n, int32_t i, int32_t rs, int32_t * runs, int32_t threads)
+{
+    if ((A == NULL) || (C == NULL) || (L == NULL) || (n < 0) || (i < (n > 0)) || (i > n) || (rs < 0) || (runs == NULL) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n == 0)
+    {
+        *runs = 0;
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    sa_sint_t count = libsais_rlbwt_encode_8u_omp(A, C, L, n, i, rs, threads);
+    if (count < 0) { return count; }
+
+    *runs = count;
+    return 0;
+}
+
+int32_t libsais_batch_omp(const uint8_t * const * T, int32_t * const * SA, const int32_t * n, const int32_t * fs, int32_t * const * freq, int32_t * result, int32_t count, int32_t threads)
+{
+    if ((T == NULL) || (SA == NULL) || (n == NULL) || (result == NULL) || (count < 0) || (threads < 0))
+    {
+        return -1;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais_batch_main(T, NULL, SA, n, fs, freq, result, count, threads);
+}
+
+int32_t libsais_bwt_batch_omp(const uint8_t * const * T, uint8_t * const * U, int32_t * const * A, const int32_t * n, const int32_t * fs, int32_t * const * freq, int32_t * result, int32_t count, int32_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n == NULL) || (result == NULL) || (count < 0) || (threads < 0))
+    {
+        return -1;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais_batch_main(T, U, A, n, fs, freq, result, count, threads);
+}
+
+#endif
+
+static LIBSAIS_UNBWT_CONTEXT * libsais_unbwt_create_ctx_main(sa_sint_t threads, const LIBSAIS_ALLOCATOR * allocator)
+{
+    LIBSAIS_UNBWT_CONTEXT *     RESTRICT ctx            = (LIBSAIS_UNBWT_CONTEXT *)libsais_alloc_memory(allocator, sizeof(LIBSAIS_UNBWT_CONTEXT), 64);
+    sa_uint_t *                 RESTRICT bucket2        = (sa_uint_t *)libsais_alloc_memory(allocator, ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_uint_t), 4096);
+    uint16_t *                  RESTRICT fastbits       = (uint16_t *)libsais_alloc_memory(allocator, (1 + (1 << UNBWT_FASTBITS)) * sizeof(uint16_t), 4096);
+    sa_uint_t *                 RESTRICT buckets        = threads > 1 ? (sa_uint_t *)libsais_alloc_memory(allocator, (size_t)threads * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE)) * sizeof(sa_uint_t), 4096) : NULL;
+
+    if (ctx != NULL && bucket2 != NULL && fastbits != NULL && (buckets != NULL || threads == 1))
+    {
+        ctx->bucket2      = bucket2;
+        ctx->fastbits     = fastbits;
+        ctx->buckets      = buckets;
+        ctx->fastbits_log = UNBWT_FASTBITS;
+        ctx->threads      = threads;
+
+        if (allocator != NULL) { ctx->allocator = *allocator; } else { memset(&ctx->allocator, 0, sizeof(LIBSAIS_ALLOCATOR)); }
+
+        return ctx;
+    }
+
+    libsais_free_memory(allocator, buckets);
+    libsais_free_memory(allocator, fastbits);
+    libsais_free_memory(allocator, bucket2);
+    libsais_free_memory(allocator, ctx);
+
+    return NULL;
+}
+
+static void libsais_unbwt_free_ctx_main(LIBSAIS_UNBWT_CONTEXT * ctx)
+{
+    if (ctx != NULL)
+    {
+        LIBSAIS_ALLOCATOR allocator = ctx->allocator;
+
+        libsais_free_memory(&allocator, ctx->buckets);
+        libsais_free_memory(&allocator, ctx->fastbits);
+        libsais_free_memory(&allocator, ctx->bucket2);
+        libsais_free_memory(&allocator, ctx);
+    }
+}
+
+static int64_t libsais_unbwt_alloc_size_main(fast_sint_t threads)
+{
+    int64_t size = (int64_t)sizeof(LIBSAIS_UNBWT_CONTEXT) + 64;
+
+    size += (int64_t)ALPHABET_SIZE * ALPHABET_SIZE * (int64_t)sizeof(sa_uint_t) + 4096;
+    size += ((int64_t)1 + ((int64_t)1 << UNBWT_FASTBITS)) * (int64_t)sizeof(uint16_t) + 4096;
+
+    if (threads > 1)
+    {
+        size += (int64_t)threads * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE)) * (int64_t)sizeof(sa_uint_t) + 4096;
+    }
+
+    return size;
+}
+
+static void libsais_unbwt_compute_histogram(const uint8_t * RESTRICT T, fast_sint_t n, sa_uint_t * RESTRICT count)
+{
+    const fast_sint_t prefetch_distance = 256;
+
+    const uint8_t * RESTRICT T_p = T;
+
+    if (n >= 1024)
+    {
+        sa_uint_t copy[4 * (ALPHABET_SIZE + 16)];
+
+        memset(copy, 0, (size_t)4 * (ALPHABET_SIZE + 16) * sizeof(sa_uint_t));
+
+        sa_uint_t * RESTRICT copy0 = copy + 0 * (ALPHABET_SIZE + 16);
+        sa_uint_t * RESTRICT copy1 = copy + 1 * (ALPHABET_SIZE + 16);
+        sa_uint_t * RESTRICT copy2 = copy + 2 * (ALPHABET_SIZE + 16);
+        sa_uint_t * RESTRICT copy3 = copy + 3 * (ALPHABET_SIZE + 16);
+
+        for (; T_p < (uint8_t * )((ptrdiff_t)(T + 63) & (-64)); T_p += 1) { copy0[T_p[0]]++; }
+
+        fast_uint_t x = ((const uint32_t *)(const void *)T_p)[0], y = ((const uint32_t *)(const void *)T_p)[1];
+
+        for (; T_p < (uint8_t * )((ptrdiff_t)(T + n - 8) & (-64)); T_p += 64)
+        { 
+            libsais_prefetchr(&T_p[prefetch_distance]);
+
+            fast_uint_t z = ((const uint32_t *)(const void *)T_p)[2], w = ((const uint32_t *)(const void *)T_p)[3];
+            copy0[(uint8_t)x]++; x >>= 8; copy1[(uint8_t)x]++; x >>= 8; copy2[(uint8_t)x]++; x >>= 8; copy3[x]++;
+            copy0[(uint8_t)y]++; y >>= 8; copy1[(uint8_t)y]++; y >>= 8; copy2[(uint8_t)y]++; y >>= 8; copy3[y]++;
+
+            x = ((const uint32_t *)(const void *)T_p)[4]; y = ((const uint32_t *)(const void *)T_p)[5];
+            copy0[(uint8_t)z]++; z >>= 8; copy1[(uint8_t)z]++; z >>= 8; copy2[(uint8_t)z]++; z >>= 8; copy3[z]++;
+            copy0[(uint8_t)w]++; w >>= 8; copy1[(uint8_t)w]++; w >>= 8; copy2[(uint8_t)w]++; w >>= 8; copy3[w]++;
+
+            z = ((const uint32_t *)(const void *)T_p)[6]; w = ((const uint32_t *)(const void *)T_p)[7];
+            copy0[(uint8_t)x]++; x >>= 8; copy1[(uint8_t)x]++; x >>= 8; copy2[(uint8_t)x]++; x >>= 8; copy3[x]++;
+            copy0[(uint8_t)y]++; y >>= 8; copy1[(uint8_t)y]++; y >>= 8; copy2[(uint8_t)y]++; y >>= 8; copy3[y]++;
+
+            x = ((const uint32_t *)(const void *)T_p)[8]; y = ((const uint32_t *)(const void *)T_p)[9];
+            copy0[(uint8_t)z]++; z >>= 8; copy1[(uint8_t)z]++; z >>= 8; copy2[(uint8_t)z]++; z >>= 8; copy3[z]++;
+            copy0[(uint8_t)w]++; w >>= 8; copy1[(uint8_t)w]++; w >>= 8; copy2[(uint8_t)w]++; w >>= 8; copy3[w]++;
+
+            z = ((const uint32_t *)(const void *)T_p)[10]; w = ((const uint32_t *)(const void *)T_p)[11];
+            copy0[(uint8_t)x]++; x >>= 8; copy1[(uint8_t)x]++; x >>= 8; copy2[(uint8_t)x]++; x >>= 8; copy3[x]++;
+            copy0[(uint8_t)y]++; y >>= 8; copy1[(uint8_t)y]++; y >>= 8; copy2[(uint8_t)y]++; y >>= 8; copy3[y]++;
+
+            x = ((const uint32_t *)(const void *)T_p)[12]; y = ((const uint32_t *)(const void *)T_p)[13];
+            copy0[(uint8_t)z]++; z >>= 8; copy1[(uint8_t)z]++; z >>= 8; copy2[(uint8_t)z]++; z >>= 8; copy3[z]++;
+            copy0[(uint8_t)w]++; w >>= 8; copy1[(uint8_t)w]++; w >>= 8; copy2[(uint8_t)w]++; w >>= 8; copy3[w]++;
+
+            z = ((const uint32_t *)(const void *)T_p)[14]; w = ((const uint32_t *)(const void *)T_p)[15];
+            copy0[(uint8_t)x]++; x >>= 8; copy1[(uint8_t)x]++; x >>= 8; copy2[(uint8_t)x]++; x >>= 8; copy3[x]++;
+            copy0[(uint8_t)y]++; y >>= 8; copy1[(uint8_t)y]++; y >>= 8; copy2[(uint8_t)y]++; y >>= 8; copy3[y]++;
+
+            x = ((const uint32_t *)(const void *)T_p)[16]; y = ((const uint32_t *)(const void *)T_p)[17];
+            copy0[(uint8_t)z]++; z >>= 8; copy1[(uint8_t)z]++; z >>= 8; copy2[(uint8_t)z]++; z >>= 8; copy3[z]++;
+            copy0[(uint8_t)w]++; w >>= 8; copy1[(uint8_t)w]++; w >>= 8; copy2[(uint8_t)w]++; w >>= 8; copy3[w]++;
+        }
+
+        copy0[(uint8_t)x]++; x >>= 8; copy1[(uint8_t)x]++; x >>= 8; copy2[(uint8_t)x]++; x >>= 8; copy3[x]++;
+        copy0[(uint8_t)y]++; y >>= 8; copy1[(uint8_t)y]++; y >>= 8; copy2[(uint8_t)y]++; y >>= 8; copy3[y]++;
+
+        T_p += 8;
+
+        fast_uint_t i; for (i = 0; i < ALPHABET_SIZE; i++) { count[i] += copy0[i] + copy1[i] + copy2[i] + copy3[i]; }
+    }
+
+    for (; T_p < T + n; T_p += 1) { count[T_p[0]]++; }
+}
+
+static void libsais_unbwt_transpose_bucket2(sa_uint_t * RESTRICT bucket2)
+{
+    fast_uint_t x, y, c, d;
+    for (x = 0; x != ALPHABET_SIZE; x += 16)
+    {
+        for (c = x; c != x + 16; ++c)
+        {
+            for (d = c + 1; d != x + 16; ++d)
+            {
+                sa_uint_t tmp = bucket2[(d << 8) + c]; bucket2[(d << 8) + c] = bucket2[(c << 8) + d]; bucket2[(c << 8) + d] = tmp;
+            }
+        }
+
+        for (y = x + 16; y != ALPHABET_SIZE; y += 16)
+        {
+            for (c = x; c != x + 16; ++c)
+            {
+                sa_uint_t * bucket2_yc = &bucket2[(y << 8) + c];
+                sa_uint_t * bucket2_cy = &bucket2[(c << 8) + y];
+
+                sa_uint_t tmp00 = bucket2_yc[ 0 * 256]; bucket2_yc[ 0 * 256] = bucket2_cy[ 0]; bucket2_cy[ 0] = tmp00;
                 sa_uint_t tmp01 = bucket2_yc[ 1 * 256]; bucket2_yc[ 1 * 256] = bucket2_cy[ 1]; bucket2_cy[ 1] = tmp01;
                 sa_uint_t tmp02 = bucket2_yc[ 2 * 256]; bucket2_yc[ 2 * 256] = bucket2_cy[ 2]; bucket2_cy[ 2] = tmp02;
                 sa_uint_t tmp03 = bucket2_yc[ 3 * 256]; bucket2_yc[ 3 * 256] = bucket2_cy[ 3]; bucket2_cy[ 3] = tmp03;
@@ -7027,848 +9066,3402 @@ static void libsais_unbwt_transpose_bucket2(sa_uint_t * RESTRICT bucket2)
     }
 }
 
-static void libsais_unbwt_compute_bigram_histogram_single(const uint8_t * RESTRICT T, sa_uint_t * RESTRICT bucket1, sa_uint_t * RESTRICT bucket2, fast_uint_t index)
+static void libsais_unbwt_compute_bigram_histogram_single(const uint8_t * RESTRICT T, sa_uint_t * RESTRICT bucket1, sa_uint_t * RESTRICT bucket2, fast_uint_t index)
+{
+    fast_uint_t sum, c;
+    for (sum = 1, c = 0; c < ALPHABET_SIZE; ++c)
+    {
+        fast_uint_t prev = sum; sum += bucket1[c]; bucket1[c] = (sa_uint_t)prev;
+        if (prev != sum)
+        {
+            sa_uint_t * RESTRICT bucket2_p = &bucket2[c << 8];
+
+            {
+                fast_uint_t hi = index; if (sum < hi) { hi = sum; }
+                libsais_unbwt_compute_histogram(&T[prev], (fast_sint_t)(hi - prev), bucket2_p);
+            }
+
+            {
+                fast_uint_t lo = index + 1; if (prev > lo) { lo = prev; }
+                libsais_unbwt_compute_histogram(&T[lo - 1], (fast_sint_t)(sum - lo), bucket2_p);
+            }
+        }
+    }
+
+    libsais_unbwt_transpose_bucket2(bucket2);
+}
+
+static void libsais_unbwt_calculate_fastbits(sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t lastc, fast_uint_t shift)
+{
+    fast_uint_t v, w, sum, c, d;
+    for (v = 0, w = 0, sum = 1, c = 0; c < ALPHABET_SIZE; ++c)
+    {
+        if (c == lastc) { sum += 1; }
+
+        for (d = 0; d < ALPHABET_SIZE; ++d, ++w)
+        {
+            fast_uint_t prev = sum; sum += bucket2[w]; bucket2[w] = (sa_uint_t)prev;
+            if (prev != sum)
+            {
+                for (; v <= ((sum - 1) >> shift); ++v) { fastbits[v] = (uint16_t)w; }
+            }
+        }
+    }
+}
+
+static void libsais_unbwt_calculate_biPSI(const uint8_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket1, sa_uint_t * RESTRICT bucket2, fast_uint_t index, fast_sint_t omp_block_start, fast_sint_t omp_block_end)
+{
+    {
+        fast_sint_t i = omp_block_start, j = (fast_sint_t)index; if (omp_block_end < j) { j = omp_block_end; }
+        for (; i < j; ++i)
+        {
+            fast_uint_t c = T[i];
+            fast_uint_t p = bucket1[c]++;
+            fast_sint_t t = (fast_sint_t)(index - p);
+
+            if (t != 0)
+            {
+                fast_uint_t w = (((fast_uint_t)T[p + (fast_uint_t)(t >> ((sizeof(fast_sint_t) * 8) - 1))]) << 8) + c;
+                P[bucket2[w]++] = (sa_uint_t)i;
+            }
+        }
+    }
+
+    {
+        fast_sint_t i = (fast_sint_t)index, j = omp_block_end; if (omp_block_start > i) { i = omp_block_start; }
+        for (i += 1; i <= j; ++i)
+        {
+            fast_uint_t c = T[i - 1];
+            fast_uint_t p = bucket1[c]++;
+            fast_sint_t t = (fast_sint_t)(index - p);
+
+            if (t != 0)
+            {
+                fast_uint_t w = (((fast_uint_t)T[p + (fast_uint_t)(t >> ((sizeof(fast_sint_t) * 8) - 1))]) << 8) + c;
+                P[bucket2[w]++] = (sa_uint_t)i;
+            }
+        }
+    }
+}
+
+static void libsais_unbwt_init_single(const uint8_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift)
+{
+    sa_uint_t bucket1[ALPHABET_SIZE];
+
+    fast_uint_t index = I[0];
+    fast_uint_t lastc = T[0];
+
+    if (freq != NULL)
+    {
+        memcpy(bucket1, freq, ALPHABET_SIZE * sizeof(sa_uint_t));
+    }
+    else
+    {
+        memset(bucket1, 0, ALPHABET_SIZE * sizeof(sa_uint_t));
+        libsais_unbwt_compute_histogram(T, n, bucket1);
+    }
+
+    memset(bucket2, 0, ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_uint_t));
+    libsais_unbwt_compute_bigram_histogram_single(T, bucket1, bucket2, index);
+
+    libsais_unbwt_calculate_fastbits(bucket2, fastbits, lastc, shift);
+    libsais_unbwt_calculate_biPSI(T, P, bucket1, bucket2, index, 0, n);
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+static void libsais_unbwt_compute_bigram_histogram_parallel(const uint8_t * RESTRICT T, fast_uint_t index, sa_uint_t * RESTRICT bucket1, sa_uint_t * RESTRICT bucket2, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i;
+    for (i = omp_block_start; i < omp_block_start + omp_block_size; ++i)
+    {
+        fast_uint_t c = T[i];
+        fast_uint_t p = bucket1[c]++;
+        fast_sint_t t = (fast_sint_t)(index - p);
+
+        if (t != 0)
+        {
+            fast_uint_t w = (((fast_uint_t)T[p + (fast_uint_t)(t >> ((sizeof(fast_sint_t) * 8) - 1))]) << 8) + c;
+            bucket2[w]++;
+        }
+    }
+}
+
+static void libsais_unbwt_init_parallel_histogram(const uint8_t * RESTRICT T, sa_sint_t n, sa_uint_t * RESTRICT buckets, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    sa_uint_t * RESTRICT bucket1_local  = buckets + omp_thread_num * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE));
+
+    fast_sint_t omp_block_stride        = (n / omp_num_threads) & (-16);
+    fast_sint_t omp_block_start         = omp_thread_num * omp_block_stride;
+    fast_sint_t omp_block_size          = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+    memset(bucket1_local, 0, ALPHABET_SIZE * sizeof(sa_uint_t));
+    libsais_unbwt_compute_histogram(T + omp_block_start, omp_block_size, bucket1_local);
+}
+
+static void libsais_unbwt_init_parallel_bucket1(sa_uint_t * RESTRICT bucket1, sa_uint_t * RESTRICT buckets, fast_sint_t omp_num_threads)
+{
+    {
+        sa_uint_t * RESTRICT bucket1_temp = buckets;
+
+        fast_sint_t t;
+        for (t = 0; t < omp_num_threads; ++t, bucket1_temp += ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE))
+        {
+            fast_sint_t c; for (c = 0; c < ALPHABET_SIZE; c += 1) { sa_uint_t A = bucket1[c], B = bucket1_temp[c]; bucket1[c] = A + B; bucket1_temp[c] = A; }
+        }
+    }
+
+    {
+        fast_uint_t sum, c;
+        for (sum = 1, c = 0; c < ALPHABET_SIZE; ++c) { fast_uint_t prev = sum; sum += bucket1[c]; bucket1[c] = (sa_uint_t)prev; }
+    }
+}
+
+static void libsais_unbwt_init_parallel_bigram_histogram(const uint8_t * RESTRICT T, sa_sint_t n, fast_uint_t index, const sa_uint_t * RESTRICT bucket1, sa_uint_t * RESTRICT buckets, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    sa_uint_t * RESTRICT bucket1_local  = buckets + omp_thread_num * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE));
+    sa_uint_t * RESTRICT bucket2_local  = bucket1_local + ALPHABET_SIZE;
+
+    fast_sint_t omp_block_stride        = (n / omp_num_threads) & (-16);
+    fast_sint_t omp_block_start         = omp_thread_num * omp_block_stride;
+    fast_sint_t omp_block_size          = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+    fast_sint_t c; for (c = 0; c < ALPHABET_SIZE; c += 1) { sa_uint_t A = bucket1[c], B = bucket1_local[c]; bucket1_local[c] = A + B; }
+
+    memset(bucket2_local, 0, ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_uint_t));
+    libsais_unbwt_compute_bigram_histogram_parallel(T, index, bucket1_local, bucket2_local, omp_block_start, omp_block_size);
+}
+
+static void libsais_unbwt_init_parallel_bucket2(sa_uint_t * RESTRICT bucket2, sa_uint_t * RESTRICT buckets, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    fast_sint_t omp_bucket2_stride  = ((ALPHABET_SIZE * ALPHABET_SIZE) / omp_num_threads) & (-16);
+    fast_sint_t omp_bucket2_start   = omp_thread_num * omp_bucket2_stride;
+    fast_sint_t omp_bucket2_size    = omp_thread_num < omp_num_threads - 1 ? omp_bucket2_stride : (ALPHABET_SIZE * ALPHABET_SIZE) - omp_bucket2_start;
+
+    sa_uint_t * RESTRICT bucket2_temp = buckets + ALPHABET_SIZE;
+
+    fast_sint_t t;
+    for (t = 0; t < omp_num_threads; ++t, bucket2_temp += ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE))
+    {
+        fast_sint_t c; for (c = omp_bucket2_start; c < omp_bucket2_start + omp_bucket2_size; c += 1) { sa_uint_t A = bucket2[c], B = bucket2_temp[c]; bucket2[c] = A + B; bucket2_temp[c] = A; }
+    }
+}
+
+static void libsais_unbwt_init_parallel_fastbits(const sa_uint_t * RESTRICT bucket1, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, sa_uint_t * RESTRICT buckets, fast_uint_t lastc, fast_uint_t shift, fast_sint_t omp_num_threads)
+{
+    libsais_unbwt_calculate_fastbits(bucket2, fastbits, lastc, shift);
+
+    {
+        fast_sint_t t;
+        for (t = omp_num_threads - 1; t >= 1; --t) 
+        { 
+            sa_uint_t * RESTRICT dst_bucket1 = buckets + t * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE));
+            sa_uint_t * RESTRICT src_bucket1 = dst_bucket1 - (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE));
+
+            memcpy(dst_bucket1, src_bucket1, ALPHABET_SIZE * sizeof(sa_uint_t));
+        }
+
+        memcpy(buckets, bucket1, ALPHABET_SIZE * sizeof(sa_uint_t));
+    }
+}
+
+static void libsais_unbwt_init_parallel_biPSI(const uint8_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_sint_t n, fast_uint_t index, const sa_uint_t * RESTRICT bucket2, sa_uint_t * RESTRICT buckets, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    sa_uint_t * RESTRICT bucket1_local  = buckets + omp_thread_num * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE));
+    sa_uint_t * RESTRICT bucket2_local  = bucket1_local + ALPHABET_SIZE;
+
+    fast_sint_t omp_block_stride        = (n / omp_num_threads) & (-16);
+    fast_sint_t omp_block_start         = omp_thread_num * omp_block_stride;
+    fast_sint_t omp_block_size          = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+    fast_sint_t c; for (c = 0; c < ALPHABET_SIZE * ALPHABET_SIZE; c += 1) { sa_uint_t A = bucket2[c], B = bucket2_local[c]; bucket2_local[c] = A + B; }
+
+    libsais_unbwt_calculate_biPSI(T, P, bucket1_local, bucket2_local, index, omp_block_start, omp_block_start + omp_block_size);
+}
+
+static void libsais_unbwt_init_parallel(const uint8_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, sa_uint_t * RESTRICT buckets, sa_sint_t threads)
+{
+    sa_uint_t bucket1[ALPHABET_SIZE];
+
+    fast_uint_t index = I[0];
+    fast_uint_t lastc = T[0];
+
+    memset(bucket1, 0, ALPHABET_SIZE * sizeof(sa_uint_t));
+    memset(bucket2, 0, ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_uint_t));
+
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+    {
+        fast_sint_t omp_thread_num  = omp_get_thread_num();
+        fast_sint_t omp_num_threads = omp_get_num_threads();
+
+        if (omp_num_threads == 1)
+        {
+            libsais_unbwt_init_single(T, P, n, freq, I, bucket2, fastbits, shift);
+        }
+        else
+        {
+            libsais_unbwt_init_parallel_histogram(T, n, buckets, omp_thread_num, omp_num_threads);
+
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                libsais_unbwt_init_parallel_bucket1(bucket1, buckets, omp_num_threads);
+            }
+
+            #pragma omp barrier
+
+            libsais_unbwt_init_parallel_bigram_histogram(T, n, index, bucket1, buckets, omp_thread_num, omp_num_threads);
+
+            #pragma omp barrier
+
+            libsais_unbwt_init_parallel_bucket2(bucket2, buckets, omp_thread_num, omp_num_threads);
+
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                libsais_unbwt_init_parallel_fastbits(bucket1, bucket2, fastbits, buckets, lastc, shift, omp_num_threads);
+            }
+
+            #pragma omp barrier
+
+            libsais_unbwt_init_parallel_biPSI(T, P, n, index, bucket2, buckets, omp_thread_num, omp_num_threads);
+
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                memcpy(bucket2, buckets + ALPHABET_SIZE + (omp_num_threads - 1) * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE)), ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_uint_t));
+            }
+        }
+    }
+}
+
+#endif
+
+static void libsais_unbwt_decode_1(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t * i0, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
+
+    fast_uint_t i, p0 = *i0;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais_bswap16(c0);
+    }
+
+    *i0 = p0;
+}
+
+static void libsais_unbwt_decode_2(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
+    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
+
+    fast_uint_t i, p0 = *i0, p1 = *i1;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais_bswap16(c0);
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais_bswap16(c1);
+    }
+
+    *i0 = p0; *i1 = p1;
+}
+
+static void libsais_unbwt_decode_3(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
+    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
+    uint16_t * RESTRICT U2 = (uint16_t *)(void *)(((uint8_t *)U1) + r);
+
+    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais_bswap16(c0);
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais_bswap16(c1);
+        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = libsais_bswap16(c2);
+    }
+
+    *i0 = p0; *i1 = p1; *i2 = p2;
+}
+
+static void libsais_unbwt_decode_4(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
+    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
+    uint16_t * RESTRICT U2 = (uint16_t *)(void *)(((uint8_t *)U1) + r);
+    uint16_t * RESTRICT U3 = (uint16_t *)(void *)(((uint8_t *)U2) + r);
+
+    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais_bswap16(c0);
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais_bswap16(c1);
+        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = libsais_bswap16(c2);
+        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = libsais_bswap16(c3);
+    }
+
+    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3;
+}
+
+static void libsais_unbwt_decode_5(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
+    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
+    uint16_t * RESTRICT U2 = (uint16_t *)(void *)(((uint8_t *)U1) + r);
+    uint16_t * RESTRICT U3 = (uint16_t *)(void *)(((uint8_t *)U2) + r);
+    uint16_t * RESTRICT U4 = (uint16_t *)(void *)(((uint8_t *)U3) + r);
+
+    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais_bswap16(c0);
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais_bswap16(c1);
+        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = libsais_bswap16(c2);
+        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = libsais_bswap16(c3);
+        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = libsais_bswap16(c4);
+    }
+
+    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4;
+}
+
+static void libsais_unbwt_decode_6(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t * i5, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
+    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
+    uint16_t * RESTRICT U2 = (uint16_t *)(void *)(((uint8_t *)U1) + r);
+    uint16_t * RESTRICT U3 = (uint16_t *)(void *)(((uint8_t *)U2) + r);
+    uint16_t * RESTRICT U4 = (uint16_t *)(void *)(((uint8_t *)U3) + r);
+    uint16_t * RESTRICT U5 = (uint16_t *)(void *)(((uint8_t *)U4) + r);
+
+    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4, p5 = *i5;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais_bswap16(c0);
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais_bswap16(c1);
+        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = libsais_bswap16(c2);
+        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = libsais_bswap16(c3);
+        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = libsais_bswap16(c4);
+        uint16_t c5 = fastbits[p5 >> shift]; if (bucket2[c5] <= p5) { do { c5++; } while (bucket2[c5] <= p5); } p5 = P[p5]; U5[i] = libsais_bswap16(c5);
+    }
+
+    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4; *i5 = p5;
+}
+
+static void libsais_unbwt_decode_7(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t * i5, fast_uint_t * i6, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
+    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
+    uint16_t * RESTRICT U2 = (uint16_t *)(void *)(((uint8_t *)U1) + r);
+    uint16_t * RESTRICT U3 = (uint16_t *)(void *)(((uint8_t *)U2) + r);
+    uint16_t * RESTRICT U4 = (uint16_t *)(void *)(((uint8_t *)U3) + r);
+    uint16_t * RESTRICT U5 = (uint16_t *)(void *)(((uint8_t *)U4) + r);
+    uint16_t * RESTRICT U6 = (uint16_t *)(void *)(((uint8_t *)U5) + r);
+
+    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4, p5 = *i5, p6 = *i6;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais_bswap16(c0);
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais_bswap16(c1);
+        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = libsais_bswap16(c2);
+        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = libsais_bswap16(c3);
+        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = libsais_bswap16(c4);
+        uint16_t c5 = fastbits[p5 >> shift]; if (bucket2[c5] <= p5) { do { c5++; } while (bucket2[c5] <= p5); } p5 = P[p5]; U5[i] = libsais_bswap16(c5);
+        uint16_t c6 = fastbits[p6 >> shift]; if (bucket2[c6] <= p6) { do { c6++; } while (bucket2[c6] <= p6); } p6 = P[p6]; U6[i] = libsais_bswap16(c6);
+    }
+
+    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4; *i5 = p5; *i6 = p6;
+}
+
+static void libsais_unbwt_decode_8(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t * i5, fast_uint_t * i6, fast_uint_t * i7, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
+    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
+    uint16_t * RESTRICT U2 = (uint16_t *)(void *)(((uint8_t *)U1) + r);
+    uint16_t * RESTRICT U3 = (uint16_t *)(void *)(((uint8_t *)U2) + r);
+    uint16_t * RESTRICT U4 = (uint16_t *)(void *)(((uint8_t *)U3) + r);
+    uint16_t * RESTRICT U5 = (uint16_t *)(void *)(((uint8_t *)U4) + r);
+    uint16_t * RESTRICT U6 = (uint16_t *)(void *)(((uint8_t *)U5) + r);
+    uint16_t * RESTRICT U7 = (uint16_t *)(void *)(((uint8_t *)U6) + r);
+
+    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4, p5 = *i5, p6 = *i6, p7 = *i7;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais_bswap16(c0);
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais_bswap16(c1);
+        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = libsais_bswap16(c2);
+        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = libsais_bswap16(c3);
+        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = libsais_bswap16(c4);
+        uint16_t c5 = fastbits[p5 >> shift]; if (bucket2[c5] <= p5) { do { c5++; } while (bucket2[c5] <= p5); } p5 = P[p5]; U5[i] = libsais_bswap16(c5);
+        uint16_t c6 = fastbits[p6 >> shift]; if (bucket2[c6] <= p6) { do { c6++; } while (bucket2[c6] <= p6); } p6 = P[p6]; U6[i] = libsais_bswap16(c6);
+        uint16_t c7 = fastbits[p7 >> shift]; if (bucket2[c7] <= p7) { do { c7++; } while (bucket2[c7] <= p7); } p7 = P[p7]; U7[i] = libsais_bswap16(c7);
+    }
+
+    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4; *i5 = p5; *i6 = p6; *i7 = p7;
+}
+
+static void libsais_unbwt_decode(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_sint_t blocks, fast_uint_t remainder)
+{
+    fast_uint_t offset      = 0;
+
+    while (blocks > 8)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5], i6 = I[6], i7 = I[7];
+        libsais_unbwt_decode_8(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, &i7, (fast_uint_t)r >> 1);
+        I += 8; blocks -= 8; offset += 8 * (fast_uint_t)r;
+    }
+
+    if (blocks == 1)
+    {
+        fast_uint_t i0 = I[0];
+        libsais_unbwt_decode_1(U + offset, P, bucket2, fastbits, shift, &i0, remainder >> 1);
+    }
+    else if (blocks == 2)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1];
+        libsais_unbwt_decode_2(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, remainder >> 1);
+        libsais_unbwt_decode_1(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, &i0, ((fast_uint_t)r >> 1) - (remainder >> 1));
+    }
+    else if (blocks == 3)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2];
+        libsais_unbwt_decode_3(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, remainder >> 1);
+        libsais_unbwt_decode_2(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, ((fast_uint_t)r >> 1) - (remainder >> 1));
+    }
+    else if (blocks == 4)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3];
+        libsais_unbwt_decode_4(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, remainder >> 1);
+        libsais_unbwt_decode_3(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, ((fast_uint_t)r >> 1) - (remainder >> 1));
+    }
+    else if (blocks == 5)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4];
+        libsais_unbwt_decode_5(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, remainder >> 1);
+        libsais_unbwt_decode_4(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, ((fast_uint_t)r >> 1) - (remainder >> 1));
+    }
+    else if (blocks == 6)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5];
+        libsais_unbwt_decode_6(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, remainder >> 1);
+        libsais_unbwt_decode_5(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, ((fast_uint_t)r >> 1) - (remainder >> 1));
+    }
+    else if (blocks == 7)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5], i6 = I[6];
+        libsais_unbwt_decode_7(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, remainder >> 1);
+        libsais_unbwt_decode_6(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, ((fast_uint_t)r >> 1) - (remainder >> 1));
+    }
+    else
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5], i6 = I[6], i7 = I[7];
+        libsais_unbwt_decode_8(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, &i7, remainder >> 1);
+        libsais_unbwt_decode_7(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, ((fast_uint_t)r >> 1) - (remainder >> 1));
+    }
+}
+
+static void libsais_unbwt_decode_parallel(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_sint_t blocks, fast_uint_t remainder, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    fast_sint_t omp_block_stride    = blocks / omp_num_threads;
+    fast_sint_t omp_block_remainder = blocks % omp_num_threads;
+    fast_sint_t omp_block_size      = omp_block_stride + (omp_thread_num < omp_block_remainder);
+    fast_sint_t omp_block_start     = omp_block_stride * omp_thread_num + (omp_thread_num < omp_block_remainder ? omp_thread_num : omp_block_remainder);
+
+    libsais_unbwt_decode(U + r * omp_block_start, P, r, I + omp_block_start, bucket2, fastbits, shift, omp_block_size, omp_thread_num < omp_num_threads - 1 ? (fast_uint_t)r : remainder);
+}
+
+static void libsais_unbwt_decode_omp(const uint8_t * RESTRICT T, uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, sa_sint_t threads)
+{
+    fast_uint_t lastc       = T[0];
+    fast_sint_t blocks      = 1 + (((fast_sint_t)n - 1) / (fast_sint_t)r);
+    fast_uint_t remainder   = (fast_uint_t)n - ((fast_uint_t)r * ((fast_uint_t)blocks - 1));
+
+#if defined(LIBSAIS_OPENMP)
+    fast_sint_t max_threads = blocks < threads ? blocks : threads;
+    #pragma omp parallel num_threads(max_threads) if(max_threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num      = omp_get_thread_num();
+        fast_sint_t omp_num_threads     = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num      = 0;
+        fast_sint_t omp_num_threads     = 1;
+#endif
+
+        libsais_unbwt_decode_parallel(U, P, r, I, bucket2, fastbits, shift, blocks, remainder, omp_thread_num, omp_num_threads);
+    }
+
+    U[n - 1] = (uint8_t)lastc;
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+static void libsais_unbwt_mark_splitters(sa_uint_t * RESTRICT P, fast_uint_t index, fast_uint_t step, fast_sint_t splitters, sa_uint_t mark)
+{
+    fast_sint_t k;
+    for (k = 0; k <= splitters; ++k)
+    {
+        fast_uint_t q = k < splitters ? (fast_uint_t)k * step : index;
+        if (P[q] != (sa_uint_t)-1) { P[q] = (P[q] & (sa_uint_t)SAINT_MAX) | mark; }
+    }
+}
+
+static void libsais_unbwt_walk_splitters(const sa_uint_t * RESTRICT P, fast_uint_t index, fast_uint_t step, fast_sint_t splitters, sa_uint_t * RESTRICT buckets, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    sa_uint_t * RESTRICT next   = buckets;
+    sa_uint_t * RESTRICT length = buckets + splitters + 1;
+
+    fast_sint_t omp_block_stride    = (splitters + 1) / omp_num_threads;
+    fast_sint_t omp_block_remainder = (splitters + 1) % omp_num_threads;
+    fast_sint_t omp_block_size      = omp_block_stride + (omp_thread_num < omp_block_remainder);
+    fast_sint_t omp_block_start     = omp_block_stride * omp_thread_num + (omp_thread_num < omp_block_remainder ? omp_thread_num : omp_block_remainder);
+
+    fast_sint_t k;
+    for (k = omp_block_start; k < omp_block_start + omp_block_size; ++k)
+    {
+        fast_uint_t q = k < splitters ? (fast_uint_t)k * step : index;
+        fast_uint_t s = 0;
+
+        if (k < splitters && q == index) { next[k] = (sa_uint_t)-1; length[k] = 0; continue; }
+
+        for (;;)
+        {
+            sa_uint_t p = P[q];
+
+            if (p == (sa_uint_t)-1) { next[k] = (sa_uint_t)-1; length[k] = (sa_uint_t)(s + 1); break; }
+            if (s > 0 && (p & (sa_uint_t)SAINT_MIN) != 0) { next[k] = (sa_uint_t)(q == index ? (fast_uint_t)splitters : q / step); length[k] = (sa_uint_t)s; break; }
+
+            q = p & (sa_uint_t)SAINT_MAX; s++;
+        }
+    }
+}
+
+static fast_sint_t libsais_unbwt_rank_splitters(fast_uint_t index, fast_uint_t step, fast_sint_t splitters, fast_uint_t steps, sa_uint_t * RESTRICT buckets)
+{
+    const sa_uint_t * RESTRICT next     = buckets;
+    const sa_uint_t * RESTRICT length   = buckets + 1 * (splitters + 1);
+    sa_uint_t *       RESTRICT rows     = buckets + 2 * (splitters + 1);
+    sa_uint_t *       RESTRICT offsets  = buckets + 3 * (splitters + 1);
+    sa_uint_t *       RESTRICT lengths  = buckets + 4 * (splitters + 1);
+
+    fast_sint_t segments = 0; fast_uint_t offset = 0, k = (fast_uint_t)splitters;
+    while (offset < steps && segments <= splitters)
+    {
+        rows[segments]      = (sa_uint_t)(k < (fast_uint_t)splitters ? k * step : index);
+        offsets[segments]   = (sa_uint_t)offset;
+        lengths[segments]   = (sa_uint_t)(length[k] < steps - offset ? length[k] : steps - offset);
+
+        offset += length[k]; segments++; if (next[k] == (sa_uint_t)-1) { break; } k = next[k];
+    }
+
+    return segments;
+}
+
+static void libsais_unbwt_decode_splitters(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_sint_t splitters, fast_sint_t segments, fast_uint_t steps, const sa_uint_t * RESTRICT buckets, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    const sa_uint_t * RESTRICT rows     = buckets + 2 * (splitters + 1);
+    const sa_uint_t * RESTRICT offsets  = buckets + 3 * (splitters + 1);
+    const sa_uint_t * RESTRICT lengths  = buckets + 4 * (splitters + 1);
+
+    fast_uint_t omp_block_stride    = steps / (fast_uint_t)omp_num_threads;
+    fast_uint_t omp_block_start     = omp_block_stride * (fast_uint_t)omp_thread_num;
+    fast_uint_t omp_block_end       = omp_thread_num < omp_num_threads - 1 ? omp_block_start + omp_block_stride : steps;
+
+    fast_sint_t l = 0, h = segments;
+    while (l < h) { fast_sint_t m = l + ((h - l) >> 1); if (offsets[m] < omp_block_start) { l = m + 1; } else { h = m; } }
+
+    for (; l < segments && offsets[l] < omp_block_end; ++l)
+    {
+        fast_uint_t i0 = rows[l];
+        libsais_unbwt_decode_1(U + 2 * (fast_uint_t)offsets[l], P, bucket2, fastbits, shift, &i0, lengths[l]);
+    }
+}
+
+static sa_sint_t libsais_unbwt_use_splitters(sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    sa_sint_t cores = (sa_sint_t)omp_get_num_procs(); threads = threads < cores ? threads : cores;
+#endif
+
+    return threads >= UNBWT_SPLITTERS_MIN_THREADS && n >= UNBWT_SPLITTERS_MIN_SIZE;
+}
+
+static fast_sint_t libsais_unbwt_count_splitters(sa_sint_t n, sa_sint_t threads)
+{
+    fast_sint_t splitters = (fast_sint_t)threads * 1024;
+    return splitters < ((fast_sint_t)n + 1) / 16 ? splitters : ((fast_sint_t)n + 1) / 16;
+}
+
+static void libsais_unbwt_decode_splitters_omp(const uint8_t * RESTRICT T, uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, fast_uint_t index, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, sa_uint_t * RESTRICT buckets, sa_sint_t threads)
+{
+    fast_uint_t lastc       = T[0];
+    fast_sint_t splitters   = libsais_unbwt_count_splitters(n, threads);
+    fast_uint_t step        = ((fast_uint_t)n + 1) / (fast_uint_t)splitters;
+    fast_uint_t steps       = (fast_uint_t)n >> 1;
+    fast_sint_t segments    = 0;
+
+    libsais_unbwt_mark_splitters(P, index, step, splitters, (sa_uint_t)SAINT_MIN);
+
+    #pragma omp parallel num_threads(threads) if(threads > 1)
+    {
+        fast_sint_t omp_thread_num      = omp_get_thread_num();
+        fast_sint_t omp_num_threads     = omp_get_num_threads();
+
+        libsais_unbwt_walk_splitters(P, index, step, splitters, buckets, omp_thread_num, omp_num_threads);
+
+        #pragma omp barrier
+
+        #pragma omp master
+        {
+            libsais_unbwt_mark_splitters(P, index, step, splitters, 0);
+            segments = libsais_unbwt_rank_splitters(index, step, splitters, steps, buckets);
+        }
+
+        #pragma omp barrier
+
+        libsais_unbwt_decode_splitters(U, P, bucket2, fastbits, shift, splitters, segments, steps, buckets, omp_thread_num, omp_num_threads);
+    }
+
+    U[n - 1] = (uint8_t)lastc;
+}
+
+#endif
+
+static sa_sint_t libsais_unbwt_decode_range(uint8_t * RESTRICT U, const sa_uint_t * RESTRICT P, sa_sint_t n, sa_sint_t r, const sa_uint_t * RESTRICT I, const sa_uint_t * RESTRICT bucket2, const uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t lastc, fast_uint_t start, fast_uint_t len)
+{
+    fast_uint_t end     = start + len;
+
+    if (end == (fast_uint_t)n) { U[len - 1] = (uint8_t)lastc; end--; }
+
+    fast_uint_t i = start;
+    while (i < end)
+    {
+        fast_uint_t b = i / (fast_uint_t)r, block_end = (b + 1) * (fast_uint_t)r < end ? (b + 1) * (fast_uint_t)r : end;
+        fast_uint_t j = b * (fast_uint_t)r, p = I[b]; if (p > (fast_uint_t)n) { return -1; }
+
+        for (; j + 2 <= i; j += 2) { p = P[p]; if (p > (fast_uint_t)n) { return -1; } }
+
+        for (; j < block_end; j += 2)
+        {
+            uint16_t c = fastbits[p >> shift]; if (bucket2[c] <= p) { do { c++; } while (bucket2[c] <= p); } p = P[p]; if (p > (fast_uint_t)n) { return -1; }
+
+            if (j >= i)             { U[j - start]      = (uint8_t)(c >> 8); }
+            if (j + 1 < block_end)  { U[j + 1 - start]  = (uint8_t)c; }
+        }
+
+        i = block_end;
+    }
+
+    return 0;
+}
+
+static sa_sint_t libsais_unbwt_range_core(const uint8_t * RESTRICT T, uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_sint_t start, sa_sint_t len, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, sa_uint_t * RESTRICT buckets, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    if (threads > 1 && n >= 262144)
+    {
+        libsais_unbwt_init_parallel(T, P, n, freq, I, bucket2, fastbits, shift, buckets, threads);
+    }
+    else
+#else
+    UNUSED(buckets); UNUSED(threads);
+#endif
+    {
+        libsais_unbwt_init_single(T, P, n, freq, I, bucket2, fastbits, shift);
+    }
+
+    libsais_unbwt_decode_range(U, P, n, r, I, bucket2, fastbits, shift, T[0], (fast_uint_t)start, (fast_uint_t)len);
+    return 0;
+}
+
+static sa_sint_t libsais_unbwt_core(const uint8_t * RESTRICT T, uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_sint_t start, sa_sint_t len, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, sa_uint_t * RESTRICT buckets, sa_sint_t threads)
+{
+    if (len < n)
+    {
+        return libsais_unbwt_range_core(T, U, P, n, freq, r, I, start, len, bucket2, fastbits, shift, buckets, threads);
+    }
+
+#if defined(LIBSAIS_OPENMP)
+    if (threads > 1 && n >= 262144)
+    {
+        if (r >= n && libsais_unbwt_use_splitters(n, threads)) { memset(P, 0xff, ((size_t)n + 1) * sizeof(sa_uint_t)); }
+
+        libsais_unbwt_init_parallel(T, P, n, freq, I, bucket2, fastbits, shift, buckets, threads);
+
+        if (r >= n && libsais_unbwt_use_splitters(n, threads)) { libsais_unbwt_decode_splitters_omp(T, U, P, n, I[0], bucket2, fastbits, shift, buckets, threads); return 0; }
+    }
+    else
+#else
+    UNUSED(buckets);
+#endif
+    {
+        libsais_unbwt_init_single(T, P, n, freq, I, bucket2, fastbits, shift);
+    }
+
+    libsais_unbwt_decode_omp(T, U, P, n, r, I, bucket2, fastbits, shift, threads);
+    return 0;
+}
+
+static sa_sint_t libsais_unbwt_main(const uint8_t * T, uint8_t * U, sa_uint_t * P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * I, sa_sint_t start, sa_sint_t len, sa_sint_t threads)
+{
+    fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+
+    sa_uint_t *     RESTRICT bucket2        = (sa_uint_t *)libsais_alloc_aligned(ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_uint_t), 4096);
+    uint16_t *      RESTRICT fastbits       = (uint16_t *)libsais_alloc_aligned(((size_t)1 + (size_t)(n >> shift)) * sizeof(uint16_t), 4096);
+    sa_uint_t *     RESTRICT buckets        = threads > 1 && n >= 262144 ? (sa_uint_t *)libsais_alloc_aligned((size_t)threads * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE)) * sizeof(sa_uint_t), 4096) : NULL;
+
+    sa_sint_t index = bucket2 != NULL && fastbits != NULL && (buckets != NULL || threads == 1 || n < 262144)
+        ? libsais_unbwt_core(T, U, P, n, freq, r, I, start, len, bucket2, fastbits, shift, buckets, threads)
+        : -2;
+
+    libsais_free_aligned(buckets);
+    libsais_free_aligned(fastbits);
+    libsais_free_aligned(bucket2);
+
+    return index;
+}
+
+static sa_sint_t libsais_unbwt_main_ctx(const LIBSAIS_UNBWT_CONTEXT * ctx, const uint8_t * T, uint8_t * U, sa_uint_t * P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * I, sa_sint_t start, sa_sint_t len)
+{
+    if (ctx != NULL && ctx->bucket2 != NULL && ctx->fastbits != NULL && (ctx->buckets != NULL || ctx->threads == 1))
+    {
+        fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << ctx->fastbits_log)) { shift++; }
+        return libsais_unbwt_core(T, U, P, n, freq, r, I, start, len, ctx->bucket2, ctx->fastbits, shift, ctx->buckets, (sa_sint_t)ctx->threads);
+    }
+
+    return -2;
+}
+
+void * libsais_unbwt_create_ctx(void)
+{
+    return (void *)libsais_unbwt_create_ctx_main(1, NULL);
+}
+
+void * libsais_unbwt_create_ctx_alloc(void * (* alloc_fn)(size_t size, size_t alignment, void * opaque), void (* free_fn)(void * address, void * opaque), void * opaque)
+{
+    if ((alloc_fn == NULL) || (free_fn == NULL)) { return NULL; }
+
+    LIBSAIS_ALLOCATOR allocator = { alloc_fn, free_fn, opaque };
+    return (void *)libsais_unbwt_create_ctx_main(1, &allocator);
+}
+
+void libsais_unbwt_free_ctx(void * ctx)
+{
+    libsais_unbwt_free_ctx_main((LIBSAIS_UNBWT_CONTEXT *)ctx);
+}
+
+int32_t libsais_unbwt_set_fastbits(void * ctx, int32_t bits)
+{
+    if ((ctx == NULL) || (bits < UNBWT_FASTBITS_MIN) || (bits > UNBWT_FASTBITS_MAX))
+    {
+        return -1;
+    }
+
+    LIBSAIS_UNBWT_CONTEXT * RESTRICT context = (LIBSAIS_UNBWT_CONTEXT *)ctx;
+
+    uint16_t * RESTRICT fastbits = (uint16_t *)libsais_alloc_memory(&context->allocator, ((size_t)1 + ((size_t)1 << bits)) * sizeof(uint16_t), 4096);
+    if (fastbits == NULL)
+    {
+        return -2;
+    }
+
+    libsais_free_memory(&context->allocator, context->fastbits);
+
+    context->fastbits       = fastbits;
+    context->fastbits_log   = bits;
+
+    return 0;
+}
+
+int64_t libsais_unbwt_alloc_size(int32_t threads)
+{
+    if (threads < 0)
+    {
+        return -1;
+    }
+
+#if defined(LIBSAIS_OPENMP)
+    threads = threads > 0 ? threads : omp_get_max_threads();
+#else
+    threads = 1;
+#endif
+
+    return libsais_unbwt_alloc_size_main(threads);
+}
+
+int32_t libsais_unbwt_recommend_r(int32_t n, int32_t threads)
+{
+    if ((n < 0) || (threads < 0))
+    {
+        return -1;
+    }
+
+#if defined(LIBSAIS_OPENMP)
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    threads = threads < omp_get_num_procs() ? threads : omp_get_num_procs();
+#else
+    threads = threads > 0 ? threads : 1;
+#endif
+
+    if (threads == 1) { return n; }
+
+    fast_sint_t r = 2; while (r <= (fast_sint_t)n / ((fast_sint_t)threads * 16)) { r <<= 1; }
+    return (int32_t)r;
+}
+
+int32_t libsais_unbwt(const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t i)
+{
+    return libsais_unbwt_aux(T, U, A, n, freq, n, &i);
+}
+
+int32_t libsais_unbwt_ctx(const void * ctx, const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t i)
+{
+    return libsais_unbwt_aux_ctx(ctx, T, U, A, n, freq, n, &i);
+}
+
+int32_t libsais_unbwt_aux(const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t r, const int32_t * I)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+        if (n == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+
+    return libsais_unbwt_main(T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, 0, n, 1);
+}
+
+int32_t libsais_unbwt_range(const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t r, const int32_t * I, int32_t start, int32_t len)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (start < 0) || (len < 0) || (start > n - len))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+        if (len == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+
+    if (len == 0) { return 0; }
+
+    return libsais_unbwt_main(T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, start, len, 1);
+}
+
+int32_t libsais_unbwt_aux_ctx(const void * ctx, const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t r, const int32_t * I)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+        if (n == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+
+    return libsais_unbwt_main_ctx((const LIBSAIS_UNBWT_CONTEXT *)ctx, T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, 0, n);
+}
+
+int32_t libsais_unbwt_range_ctx(const void * ctx, const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t r, const int32_t * I, int32_t start, int32_t len)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (start < 0) || (len < 0) || (start > n - len))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+        if (len == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+
+    if (len == 0) { return 0; }
+
+    return libsais_unbwt_main_ctx((const LIBSAIS_UNBWT_CONTEXT *)ctx, T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, start, len);
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+void * libsais_unbwt_create_ctx_omp(int32_t threads)
+{
+    if (threads < 0) { return NULL; }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return (void *)libsais_unbwt_create_ctx_main(threads, NULL);
+}
+
+void * libsais_unbwt_create_ctx_alloc_omp(int32_t threads, void * (* alloc_fn)(size_t size, size_t alignment, void * opaque), void (* free_fn)(void * address, void * opaque), void * opaque)
+{
+    if ((threads < 0) || (alloc_fn == NULL) || (free_fn == NULL)) { return NULL; }
+
+    LIBSAIS_ALLOCATOR allocator = { alloc_fn, free_fn, opaque };
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return (void *)libsais_unbwt_create_ctx_main(threads, &allocator);
+}
+
+int32_t libsais_unbwt_omp(const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t i, int32_t threads)
+{
+    return libsais_unbwt_aux_omp(T, U, A, n, freq, n, &i, threads);
+}
+
+int32_t libsais_unbwt_aux_omp(const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t r, const int32_t * I, int32_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+        if (n == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return libsais_unbwt_main(T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, 0, n, threads);
+}
+
+int32_t libsais_unbwt_range_omp(const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t r, const int32_t * I, int32_t start, int32_t len, int32_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (start < 0) || (len < 0) || (start > n - len) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+        if (len == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+
+    if (len == 0) { return 0; }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return libsais_unbwt_main(T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, start, len, threads);
+}
+
+#endif
+
+static int64_t libsais_unbwt_index_layout(sa_sint_t n, sa_sint_t r, int64_t * RESTRICT offsets)
+{
+    fast_uint_t shift   = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+    int64_t     samples = n > 1 ? (int64_t)1 + (int64_t)((n - 1) / r) : 1;
+
+    offsets[0] = (int64_t)sizeof(LIBSAIS_UNBWT_INDEX);
+    offsets[1] = offsets[0] + (int64_t)(ALPHABET_SIZE * ALPHABET_SIZE) * (int64_t)sizeof(sa_uint_t);
+    offsets[2] = offsets[1] + ((((int64_t)1 + (int64_t)(n >> shift)) * (int64_t)sizeof(uint16_t) + 63) & (-64));
+    offsets[3] = offsets[2] + ((samples * (int64_t)sizeof(sa_uint_t) + 63) & (-64));
+
+    return offsets[3] + ((int64_t)n + 1) * (int64_t)sizeof(sa_uint_t);
+}
+
+static sa_sint_t libsais_unbwt_index_validate(const void * index, size_t size)
+{
+    const LIBSAIS_UNBWT_INDEX * RESTRICT header = (const LIBSAIS_UNBWT_INDEX *)index;
+
+    if ((index == NULL) || (((size_t)index & 7) != 0) || (size < sizeof(LIBSAIS_UNBWT_INDEX)) || (header->magic != LIBSAIS_UNBWT_INDEX_MAGIC))
+    {
+        return -1;
+    }
+
+    int64_t n = header->n, r = header->r;
+    if ((n < 0) || ((int64_t)(sa_sint_t)n != n) || ((r != n) && ((r < 2) || ((int64_t)(sa_sint_t)r != r) || ((r & (r - 1)) != 0))))
+    {
+        return -1;
+    }
+
+    int64_t offsets[4];
+    if ((uint64_t)libsais_unbwt_index_layout((sa_sint_t)n, (sa_sint_t)r, offsets) > (uint64_t)size)
+    {
+        return -1;
+    }
+
+    if ((n > 1) && (((const sa_uint_t *)(const void *)((const uint8_t *)index + offsets[0]))[ALPHABET_SIZE * ALPHABET_SIZE - 1] <= (sa_uint_t)n))
+    {
+        return -1;
+    }
+
+    if ((header->lastc < 0) || (header->lastc >= ALPHABET_SIZE))
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+static sa_sint_t libsais_unbwt_index_build_main(const uint8_t * T, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * I, void * index, size_t size, sa_sint_t threads)
+{
+    int64_t offsets[4];
+    if ((uint64_t)libsais_unbwt_index_layout(n, r, offsets) > (uint64_t)size)
+    {
+        return -3;
+    }
+
+    LIBSAIS_UNBWT_INDEX *   RESTRICT header     = (LIBSAIS_UNBWT_INDEX *)index;
+    sa_uint_t *             RESTRICT bucket2    = (sa_uint_t *)(void *)((uint8_t *)index + offsets[0]);
+    uint16_t *              RESTRICT fastbits   = (uint16_t *)(void *)((uint8_t *)index + offsets[1]);
+    sa_uint_t *             RESTRICT samples    = (sa_uint_t *)(void *)((uint8_t *)index + offsets[2]);
+    sa_uint_t *             RESTRICT P          = (sa_uint_t *)(void *)((uint8_t *)index + offsets[3]);
+
+    fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+
+    memset(header, 0, sizeof(LIBSAIS_UNBWT_INDEX));
+    memcpy(samples, I, (n > 1 ? (size_t)1 + (size_t)((n - 1) / r) : 1) * sizeof(sa_uint_t));
+
+    if (n > 1)
+    {
+#if defined(LIBSAIS_OPENMP)
+        if (threads > 1 && n >= 262144)
+        {
+            sa_uint_t * RESTRICT buckets = (sa_uint_t *)libsais_alloc_aligned((size_t)threads * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE)) * sizeof(sa_uint_t), 4096);
+            if (buckets == NULL)
+            {
+                return -2;
+            }
+
+            libsais_unbwt_init_parallel(T, P, n, freq, samples, bucket2, fastbits, shift, buckets, threads);
+            libsais_free_aligned(buckets);
+        }
+        else
+#else
+        UNUSED(threads);
+#endif
+        {
+            libsais_unbwt_init_single(T, P, n, freq, samples, bucket2, fastbits, shift);
+        }
+    }
+
+    header->n       = (int64_t)n;
+    header->r       = (int64_t)r;
+    header->lastc   = n > 0 ? (int64_t)T[0] : 0;
+    header->magic   = LIBSAIS_UNBWT_INDEX_MAGIC;
+
+    return 0;
+}
+
+static sa_sint_t libsais_unbwt_index_decode_main(const void * index, uint8_t * U, sa_sint_t start, sa_sint_t len, sa_sint_t threads)
+{
+    const LIBSAIS_UNBWT_INDEX * RESTRICT header = (const LIBSAIS_UNBWT_INDEX *)index;
+
+    sa_sint_t   n       = (sa_sint_t)header->n;
+    sa_sint_t   r       = (sa_sint_t)header->r;
+    fast_uint_t lastc   = (fast_uint_t)header->lastc;
+
+    if (n <= 1)
+    {
+        if (len == 1) { U[0] = (uint8_t)lastc; }
+        return 0;
+    }
+
+    int64_t offsets[4]; libsais_unbwt_index_layout(n, r, offsets);
+
+    const sa_uint_t *   RESTRICT bucket2    = (const sa_uint_t *)(const void *)((const uint8_t *)index + offsets[0]);
+    const uint16_t *    RESTRICT fastbits   = (const uint16_t *)(const void *)((const uint8_t *)index + offsets[1]);
+    const sa_uint_t *   RESTRICT samples    = (const sa_uint_t *)(const void *)((const uint8_t *)index + offsets[2]);
+    const sa_uint_t *   RESTRICT P          = (const sa_uint_t *)(const void *)((const uint8_t *)index + offsets[3]);
+
+    fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+    sa_sint_t corrupted = 0;
+
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && len >= 65536) reduction(|:corrupted)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num      = omp_get_thread_num();
+        fast_sint_t omp_num_threads     = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num      = 0;
+        fast_sint_t omp_num_threads     = 1;
+#endif
+        fast_sint_t omp_block_stride    = ((fast_sint_t)len / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start     = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size      = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : (fast_sint_t)len - omp_block_start;
+
+        corrupted |= libsais_unbwt_decode_range(U + omp_block_start, P, n, r, samples, bucket2, fastbits, shift, lastc, (fast_uint_t)start + (fast_uint_t)omp_block_start, (fast_uint_t)omp_block_size) != 0;
+    }
+
+    return corrupted ? -1 : 0;
+}
+
+int64_t libsais_unbwt_index_size(int32_t n, int32_t r)
+{
+    if ((n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))))
+    {
+        return -1;
+    }
+
+    int64_t offsets[4]; return libsais_unbwt_index_layout(n, r, offsets);
+}
+
+int32_t libsais_unbwt_index_build(const uint8_t * T, int32_t n, const int32_t * freq, int32_t r, const int32_t * I, void * index, size_t size)
+{
+    if ((T == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (index == NULL) || (((size_t)index & 7) != 0))
+    {
+        return -1;
+    }
+
+    fast_sint_t t;
+    if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+    }
+    else
+    {
+        for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+    }
+
+    return libsais_unbwt_index_build_main(T, n, freq, r, (const sa_uint_t *)I, index, size, 1);
+}
+
+int32_t libsais_unbwt_index_decode(const void * index, size_t size, uint8_t * U, int32_t start, int32_t len)
+{
+    if ((U == NULL) || (libsais_unbwt_index_validate(index, size) != 0) || (start < 0) || (len < 0) || (start > ((const LIBSAIS_UNBWT_INDEX *)index)->n - len))
+    {
+        return -1;
+    }
+
+    if (len == 0) { return 0; }
+
+    return libsais_unbwt_index_decode_main(index, U, start, len, 1);
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+int32_t libsais_unbwt_index_build_omp(const uint8_t * T, int32_t n, const int32_t * freq, int32_t r, const int32_t * I, void * index, size_t size, int32_t threads)
+{
+    if ((T == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (index == NULL) || (((size_t)index & 7) != 0) || (threads < 0))
+    {
+        return -1;
+    }
+
+    fast_sint_t t;
+    if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+    }
+    else
+    {
+        for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return libsais_unbwt_index_build_main(T, n, freq, r, (const sa_uint_t *)I, index, size, threads);
+}
+
+int32_t libsais_unbwt_index_decode_omp(const void * index, size_t size, uint8_t * U, int32_t start, int32_t len, int32_t threads)
+{
+    if ((U == NULL) || (libsais_unbwt_index_validate(index, size) != 0) || (start < 0) || (len < 0) || (start > ((const LIBSAIS_UNBWT_INDEX *)index)->n - len) || (threads < 0))
+    {
+        return -1;
+    }
+
+    if (len == 0) { return 0; }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return libsais_unbwt_index_decode_main(index, U, start, len, threads);
+}
+
+#endif
+
+#if defined(LIBSAIS_OPENMP)
+
+static void libsais_stk_count_8u(const uint8_t * RESTRICT T, const sa_sint_t * RESTRICT A, sa_sint_t * RESTRICT buckets, fast_sint_t n, fast_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    memset(buckets, 0, ALPHABET_SIZE * sizeof(sa_sint_t));
+
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais_prefetchr(&A[i + 2 * prefetch_distance]);
+        libsais_prefetchr(&T[A[i + prefetch_distance] + d]);
+
+        fast_sint_t p = A[i] + d; p -= p >= n ? n : 0; buckets[T[p]]++;
+    }
+
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        fast_sint_t p = A[i] + d; p -= p >= n ? n : 0; buckets[T[p]]++;
+    }
+}
+
+#endif
+
+static void libsais_stk_scatter_8u(const uint8_t * RESTRICT T, const sa_sint_t * RESTRICT A, sa_sint_t * RESTRICT B, sa_sint_t * RESTRICT buckets, fast_sint_t n, fast_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais_prefetchr(&A[i + 2 * prefetch_distance]);
+        libsais_prefetchr(&T[A[i + prefetch_distance] + d]);
+
+        fast_sint_t p = A[i] + d; p -= p >= n ? n : 0; B[buckets[T[p]]++] = A[i];
+    }
+
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        fast_sint_t p = A[i] + d; p -= p >= n ? n : 0; B[buckets[T[p]]++] = A[i];
+    }
+}
+
+static void libsais_stk_radix_pass_8u_omp(const uint8_t * RESTRICT T, const sa_sint_t * RESTRICT A, sa_sint_t * RESTRICT B, sa_sint_t n, sa_sint_t d, const sa_sint_t * RESTRICT bucket_start, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536 && omp_get_dynamic() == 0)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads); UNUSED(thread_state);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        if (omp_num_threads == 1)
+        {
+            sa_sint_t buckets[ALPHABET_SIZE]; memcpy(buckets, bucket_start, ALPHABET_SIZE * sizeof(sa_sint_t));
+
+            libsais_stk_scatter_8u(T, A, B, buckets, n, d, omp_block_start, omp_block_size);
+        }
+#if defined(LIBSAIS_OPENMP)
+        else
+        {
+            libsais_stk_count_8u(T, A, thread_state[omp_thread_num].state.buckets, n, d, omp_block_start, omp_block_size);
+
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                fast_sint_t t, c;
+                for (c = 0; c < ALPHABET_SIZE; c += 1)
+                {
+                    sa_sint_t sum = bucket_start[c];
+                    for (t = 0; t < omp_num_threads; ++t) { sa_sint_t count = thread_state[t].state.buckets[c]; thread_state[t].state.buckets[c] = sum; sum += count; }
+                }
+            }
+
+            #pragma omp barrier
+
+            libsais_stk_scatter_8u(T, A, B, thread_state[omp_thread_num].state.buckets, n, d, omp_block_start, omp_block_size);
+        }
+#endif
+    }
+}
+
+static void libsais_stk_init_identity(sa_sint_t * RESTRICT A, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        fast_sint_t i; for (i = omp_block_start; i < omp_block_start + omp_block_size; i += 1) { A[i] = (sa_sint_t)i; }
+    }
+}
+
+static sa_sint_t libsais_stk_copy_8u_omp(const uint8_t * RESTRICT T, uint8_t * RESTRICT U, const sa_sint_t * RESTRICT A, sa_sint_t n, sa_sint_t threads)
+{
+    sa_sint_t index = 0;
+
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        fast_sint_t i;
+        for (i = omp_block_start; i < omp_block_start + omp_block_size; i += 1)
+        {
+            fast_sint_t p = A[i];
+            if (p > 0) { U[i] = T[p - 1]; } else { U[i] = T[n - 1]; index = (sa_sint_t)i; }
+        }
+    }
+
+    return index;
+}
+
+static sa_sint_t libsais_stk_main(const uint8_t * T, uint8_t * U, sa_sint_t * A, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t * freq, sa_sint_t threads)
+{
+    LIBSAIS_THREAD_STATE *  RESTRICT thread_state   = threads > 1 ? libsais_alloc_thread_state(threads, NULL) : NULL;
+    sa_sint_t *             RESTRICT buffer         = fs < n ? (sa_sint_t *)libsais_alloc_aligned((size_t)n * sizeof(sa_sint_t), 4096) : NULL;
+    sa_sint_t *             RESTRICT B              = fs < n ? buffer : A + n;
+
+    sa_sint_t index = (threads <= 1 || thread_state != NULL) && B != NULL ? 0 : -2;
+    if (index == 0)
+    {
+        sa_sint_t bucket_start[ALPHABET_SIZE];
+
+        {
+            sa_sint_t counts[ALPHABET_SIZE]; memset(counts, 0, sizeof(counts));
+
+            fast_sint_t i, c; sa_sint_t sum = 0;
+            for (i = 0; i < n; i += 1) { counts[T[i]]++; }
+            for (c = 0; c < ALPHABET_SIZE; c += 1) { bucket_start[c] = sum; sum += counts[c]; }
+
+            if (freq != NULL) { memcpy(freq, counts, sizeof(counts)); }
+        }
+
+        sa_sint_t * RESTRICT S = (k & 1) ? B : A;
+        sa_sint_t * RESTRICT D = (k & 1) ? A : B;
+
+        libsais_stk_init_identity(S, n, threads);
+
+        sa_sint_t d;
+        for (d = k - 1; d >= 0; --d)
+        {
+            libsais_stk_radix_pass_8u_omp(T, S, D, n, d % n, bucket_start, threads, thread_state);
+
+            sa_sint_t * RESTRICT X = S; S = D; D = X;
+        }
+
+        index = libsais_stk_copy_8u_omp(T, U, A, n, threads);
+    }
+
+    libsais_free_aligned(buffer);
+    libsais_free_thread_state(thread_state, NULL);
+
+    return index;
+}
+
+static void libsais_unstk_init_thread_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT counts, sa_sint_t * RESTRICT last, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    memset(counts, 0, ALPHABET_SIZE * sizeof(sa_sint_t));
+    memset(last, -1, ALPHABET_SIZE * sizeof(sa_sint_t));
+
+    fast_sint_t i;
+    for (i = omp_block_start; i < omp_block_start + omp_block_size; i += 1)
+    {
+        counts[T[i]]++; last[T[i]] = (sa_sint_t)i;
+    }
+}
+
+static sa_sint_t libsais_unstk_split_groups_8u(const uint8_t * RESTRICT T, const sa_sint_t * RESTRICT G, sa_sint_t * RESTRICT H, sa_sint_t * RESTRICT offsets, sa_sint_t * RESTRICT last, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    sa_sint_t groups = 0;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais_prefetchw(&H[offsets[T[i + prefetch_distance]]]);
+
+        fast_sint_t c = T[i], s = offsets[c]++; sa_sint_t split = last[c] < G[i];
+        H[s] = split ? (sa_sint_t)s : 0; groups += split; last[c] = (sa_sint_t)i;
+    }
+
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        fast_sint_t c = T[i], s = offsets[c]++; sa_sint_t split = last[c] < G[i];
+        H[s] = split ? (sa_sint_t)s : 0; groups += split; last[c] = (sa_sint_t)i;
+    }
+
+    return groups;
+}
+
+static sa_sint_t libsais_unstk_fill_groups(sa_sint_t * RESTRICT H, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    sa_sint_t group = 0;
+
+    fast_sint_t i;
+    for (i = omp_block_start; i < omp_block_start + omp_block_size; i += 1)
+    {
+        group = H[i] > group ? H[i] : group; H[i] = group;
+    }
+
+    return group;
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+static void libsais_unstk_carry_groups(sa_sint_t * RESTRICT H, sa_sint_t group, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i;
+    for (i = omp_block_start; i < omp_block_start + omp_block_size && H[i] < group; i += 1)
+    {
+        H[i] = group;
+    }
+}
+
+#endif
+
+static void libsais_unstk_gather_groups_8u(const uint8_t * RESTRICT T, const sa_sint_t * RESTRICT G, sa_sint_t * RESTRICT H, sa_sint_t * RESTRICT offsets, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais_prefetchr(&G[offsets[T[i + prefetch_distance]]]);
+
+        H[i] = G[offsets[T[i]]++];
+    }
+
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        H[i] = G[offsets[T[i]]++];
+    }
+}
+
+static void libsais_unstk_build_groups_8u_omp(const uint8_t * RESTRICT T, sa_sint_t ** RESTRICT G, sa_sint_t ** RESTRICT H, sa_sint_t n, sa_sint_t k, const sa_sint_t * RESTRICT bucket_start, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+{
+    sa_sint_t groups = 0;
+
+    { fast_sint_t c; for (c = 0; c < ALPHABET_SIZE; c += 1) { groups += (c < ALPHABET_SIZE - 1 ? bucket_start[c + 1] : n) > bucket_start[c]; } }
+
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536 && omp_get_dynamic() == 0)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads); UNUSED(thread_state);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        sa_sint_t local_buckets[4 * ALPHABET_SIZE];
+        sa_sint_t * RESTRICT buckets = omp_num_threads == 1 ? local_buckets : thread_state[omp_thread_num].state.buckets;
+
+        sa_sint_t * RESTRICT thread_offsets = &buckets[0 * ALPHABET_SIZE];
+        sa_sint_t * RESTRICT thread_last    = &buckets[1 * ALPHABET_SIZE];
+        sa_sint_t * RESTRICT offsets        = &buckets[2 * ALPHABET_SIZE];
+        sa_sint_t * RESTRICT last           = &buckets[3 * ALPHABET_SIZE];
+
+        sa_sint_t * RESTRICT X = *G;
+        sa_sint_t * RESTRICT Y = *H;
+
+        libsais_unstk_init_thread_8u(T, thread_offsets, thread_last, omp_block_start, omp_block_size);
+
+        {
+            fast_sint_t i, c;
+            for (c = 0; c < ALPHABET_SIZE; c += 1)
+            {
+                fast_sint_t group = bucket_start[c], end = c < ALPHABET_SIZE - 1 ? bucket_start[c + 1] : n;
+                for (i = group > omp_block_start ? group : omp_block_start; i < end && i < omp_block_start + omp_block_size; i += 1) { X[i] = (sa_sint_t)group; }
+            }
+        }
+
+#if defined(LIBSAIS_OPENMP)
+        if (omp_num_threads > 1)
+        {
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                fast_sint_t t, c;
+                for (c = 0; c < ALPHABET_SIZE; c += 1)
+                {
+                    sa_sint_t sum = bucket_start[c], prev = -1;
+                    for (t = 0; t < omp_num_threads; ++t)
+                    {
+                        sa_sint_t * RESTRICT temp_bucket = thread_state[t].state.buckets;
+                        sa_sint_t count = temp_bucket[c], position = temp_bucket[ALPHABET_SIZE + c];
+
+                        temp_bucket[c] = sum; sum += count;
+                        temp_bucket[ALPHABET_SIZE + c] = prev; prev = position >= 0 ? position : prev;
+                    }
+                }
+            }
+
+            #pragma omp barrier
+        }
+        else
+#endif
+        {
+            fast_sint_t c; for (c = 0; c < ALPHABET_SIZE; c += 1) { thread_offsets[c] = bucket_start[c]; thread_last[c] = -1; }
+        }
+
+        sa_sint_t level;
+        for (level = 1; level < k; ++level)
+        {
+            memcpy(offsets, thread_offsets, 2 * ALPHABET_SIZE * sizeof(sa_sint_t));
+
+            sa_sint_t split = libsais_unstk_split_groups_8u(T, X, Y, offsets, last, omp_block_start, omp_block_size);
+
+#if defined(LIBSAIS_OPENMP)
+            if (omp_num_threads > 1)
+            {
+                thread_state[omp_thread_num].state.count    = split;
+
+                #pragma omp barrier
+
+                thread_state[omp_thread_num].state.position = libsais_unstk_fill_groups(Y, omp_block_start, omp_block_size);
+
+                #pragma omp barrier
+
+                #pragma omp master
+                {
+                    fast_sint_t t; sa_sint_t group = 0, total = 0;
+                    for (t = 0; t < omp_num_threads; ++t)
+                    {
+                        sa_sint_t block_group = (sa_sint_t)thread_state[t].state.position;
+
+                        thread_state[t].state.position = group; group = block_group > group ? block_group : group;
+                        total += (sa_sint_t)thread_state[t].state.count;
+                    }
+
+                    groups = groups != total ? total : -1;
+                }
+
+                #pragma omp barrier
+
+                libsais_unstk_carry_groups(Y, (sa_sint_t)thread_state[omp_thread_num].state.position, omp_block_start, omp_block_size);
+
+                #pragma omp barrier
+            }
+            else
+#endif
+            {
+                libsais_unstk_fill_groups(Y, omp_block_start, omp_block_size);
+
+                groups = groups != split ? split : -1;
+            }
+
+            { sa_sint_t * RESTRICT Z = X; X = Y; Y = Z; }
+
+            if (groups < 0 || groups == n) { break; }
+        }
+
+        memcpy(offsets, thread_offsets, ALPHABET_SIZE * sizeof(sa_sint_t));
+
+        libsais_unstk_gather_groups_8u(T, X, Y, offsets, omp_block_start, omp_block_size);
+
+        if (omp_thread_num == 0) { *G = X; *H = Y; }
+    }
+}
+
+static void libsais_unstk_decode_8u(const uint8_t * RESTRICT T, uint8_t * RESTRICT U, sa_sint_t * RESTRICT G, const sa_sint_t * RESTRICT H, sa_sint_t n, sa_sint_t i)
+{
+    fast_sint_t s, p;
+    for (s = 0; s < n; s += 1) { G[G[s]] = (sa_sint_t)s; }
+
+    for (p = (fast_sint_t)n - 1; p >= 0; p -= 1)
+    {
+        fast_sint_t g = H[i]; U[p] = T[i]; i = G[g]--;
+    }
+}
+
+static sa_sint_t libsais_unstk_main(const uint8_t * T, uint8_t * U, sa_sint_t * A, sa_sint_t n, sa_sint_t k, sa_sint_t fs, const sa_sint_t * freq, sa_sint_t i, sa_sint_t threads)
+{
+    LIBSAIS_THREAD_STATE *  RESTRICT thread_state   = threads > 1 ? libsais_alloc_thread_state(threads, NULL) : NULL;
+    sa_sint_t *             RESTRICT buffer         = fs < n ? (sa_sint_t *)libsais_alloc_aligned((size_t)n * sizeof(sa_sint_t), 4096) : NULL;
+    sa_sint_t *             RESTRICT B              = fs < n ? buffer : A + n;
+
+    sa_sint_t index = (threads <= 1 || thread_state != NULL) && B != NULL ? 0 : -2;
+    if (index == 0)
+    {
+        sa_sint_t bucket_start[ALPHABET_SIZE];
+
+        {
+            sa_sint_t counts[ALPHABET_SIZE];
+
+            if (freq != NULL) { memcpy(counts, freq, sizeof(counts)); }
+            else { fast_sint_t p; memset(counts, 0, sizeof(counts)); for (p = 0; p < n; p += 1) { counts[T[p]]++; } }
+
+            fast_sint_t c; sa_sint_t sum = 0;
+            for (c = 0; c < ALPHABET_SIZE; c += 1) { bucket_start[c] = sum; sum += counts[c]; }
+        }
+
+        sa_sint_t * G = A, * H = B;
+
+        libsais_unstk_build_groups_8u_omp(T, &G, &H, n, k, bucket_start, threads, thread_state);
+        libsais_unstk_decode_8u(T, U, G, H, n, i);
+    }
+
+    libsais_free_aligned(buffer);
+    libsais_free_thread_state(thread_state, NULL);
+
+    return index;
+}
+
+int32_t libsais_stk(const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, int32_t k, int32_t fs, int32_t * freq)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (k <= 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    return libsais_stk_main(T, U, A, n, k, fs, freq, 1);
+}
+
+int32_t libsais_unstk(const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, int32_t k, int32_t fs, const int32_t * freq, int32_t i)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (k <= 0) || (fs < 0) || (i < 0) || (i >= (n > 0 ? n : 1)))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    return libsais_unstk_main(T, U, A, n, k, fs, freq, i, 1);
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+int32_t libsais_stk_omp(const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, int32_t k, int32_t fs, int32_t * freq, int32_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (k <= 0) || (fs < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais_stk_main(T, U, A, n, k, fs, freq, threads);
+}
+
+int32_t libsais_unstk_omp(const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, int32_t k, int32_t fs, const int32_t * freq, int32_t i, int32_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (k <= 0) || (fs < 0) || (i < 0) || (i >= (n > 0 ? n : 1)) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais_unstk_main(T, U, A, n, k, fs, freq, i, threads);
+}
+
+#endif
+
+static void libsais_bwt_merge_count_superblock(const uint8_t * RESTRICT U, fast_sint_t n, sa_uint_t * RESTRICT super, uint16_t * RESTRICT block, fast_sint_t s)
+{
+    sa_sint_t counts[ALPHABET_SIZE]; memset(counts, 0, sizeof(counts));
+
+    fast_sint_t b, p, c;
+    for (b = s << 8; b < ((s + 1) << 8) && b <= (n >> 8); b += 1)
+    {
+        for (c = 0; c < ALPHABET_SIZE; c += 1) { block[b * ALPHABET_SIZE + c] = (uint16_t)counts[c]; }
+        for (p = b << 8; p < ((b + 1) << 8) && p < n; p += 1) { counts[U[p]]++; }
+    }
+
+    for (c = 0; c < ALPHABET_SIZE; c += 1) { super[(s + 1) * ALPHABET_SIZE + c] = (sa_uint_t)counts[c]; }
+}
+
+static void libsais_bwt_merge_build_occ_omp(const uint8_t * RESTRICT U, sa_sint_t n, sa_uint_t * RESTRICT super, uint16_t * RESTRICT block, sa_sint_t threads)
+{
+    fast_sint_t superblocks = ((fast_sint_t)n >> 16) + 1;
+
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = superblocks / omp_num_threads;
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : superblocks - omp_block_start;
+
+        fast_sint_t s; for (s = omp_block_start; s < omp_block_start + omp_block_size; s += 1) { libsais_bwt_merge_count_superblock(U, n, super, block, s); }
+    }
+
+    fast_sint_t s, c;
+    for (c = 0; c < ALPHABET_SIZE; c += 1) { super[c] = 0; }
+    for (s = 1; s <= superblocks; s += 1)
+    {
+        for (c = 0; c < ALPHABET_SIZE; c += 1) { super[s * ALPHABET_SIZE + c] += super[(s - 1) * ALPHABET_SIZE + c]; }
+    }
+}
+
+static fast_sint_t libsais_bwt_merge_occ(const uint8_t * RESTRICT U, const sa_uint_t * RESTRICT super, const uint16_t * RESTRICT block, fast_sint_t c, fast_sint_t r)
+{
+    fast_sint_t count = (fast_sint_t)super[(r >> 16) * ALPHABET_SIZE + c] + (fast_sint_t)block[(r >> 8) * ALPHABET_SIZE + c];
+
+    fast_sint_t p; for (p = r & (-256); p < r; p += 1) { count += U[p] == c; }
+
+    return count;
+}
+
+static fast_sint_t libsais_bwt_merge_count_sentinels(const sa_sint_t * RESTRICT I, fast_sint_t m, fast_sint_t r)
+{
+    fast_sint_t lo = 0, hi = m;
+    while (lo < hi) { fast_sint_t mid = lo + ((hi - lo) >> 1); if (I[mid] < r) { lo = mid + 1; } else { hi = mid; } }
+
+    return lo;
+}
+
+static void libsais_bwt_merge_compute_gaps(const uint8_t * RESTRICT U1, const sa_sint_t * RESTRICT I1, sa_sint_t n1, sa_sint_t m1, const uint8_t * RESTRICT T2, sa_sint_t n2, const sa_uint_t * RESTRICT super, const uint16_t * RESTRICT block, sa_sint_t * RESTRICT gap)
+{
+    fast_sint_t C[ALPHABET_SIZE];
+
+    {
+        fast_sint_t c, sum = m1;
+        for (c = 0; c < ALPHABET_SIZE; c += 1) { C[c] = sum; sum += (fast_sint_t)super[(((fast_sint_t)n1 >> 16) + 1) * ALPHABET_SIZE + c]; }
+    }
+
+    fast_sint_t j, r = m1; gap[r]++;
+    if (m1 == 1)
+    {
+        fast_sint_t i1 = I1[0];
+        for (j = (fast_sint_t)n2 - 1; j >= 0; j -= 1)
+        {
+            fast_sint_t c = T2[j]; r = C[c] + libsais_bwt_merge_occ(U1, super, block, c, r - (r > i1)); gap[r]++;
+        }
+    }
+    else
+    {
+        for (j = (fast_sint_t)n2 - 1; j >= 0; j -= 1)
+        {
+            fast_sint_t c = T2[j]; r = C[c] + libsais_bwt_merge_occ(U1, super, block, c, r - libsais_bwt_merge_count_sentinels(I1, m1, r)); gap[r]++;
+        }
+    }
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+static fast_sint_t libsais_bwt_merge_sum_gaps(const sa_sint_t * RESTRICT gap, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i, sum = 0;
+    for (i = omp_block_start; i < omp_block_start + omp_block_size; i += 1) { sum += gap[i]; }
+
+    return sum;
+}
+
+#endif
+
+static fast_sint_t libsais_bwt_merge_interleave(const uint8_t * RESTRICT U1, const sa_sint_t * RESTRICT I1, sa_sint_t n1, sa_sint_t m1, const uint8_t * RESTRICT U2, sa_sint_t i2, const sa_sint_t * RESTRICT gap, uint8_t * RESTRICT U, sa_sint_t * RESTRICT I, fast_sint_t omp_block_start, fast_sint_t omp_block_size, fast_sint_t b)
+{
+    fast_sint_t a = omp_block_start, n = (fast_sint_t)n1 + m1, sentinel = -1;
+    fast_sint_t t = libsais_bwt_merge_count_sentinels(I1, m1, a), q = a + b, u = q - t - (b > i2);
+
+    for (; a < omp_block_start + omp_block_size; a += 1)
+    {
+        fast_sint_t g;
+        for (g = gap[a]; g > 0; g -= 1, b += 1, q += 1)
+        {
+            if (b != i2) { U[u++] = U2[b - (b > i2)]; } else { sentinel = q; }
+        }
+
+        if (a < n)
+        {
+            if (t < m1 && I1[t] == a) { I[t++] = (sa_sint_t)q; } else { U[u++] = U1[a - t]; }
+            q += 1;
+        }
+    }
+
+    return sentinel;
+}
+
+static sa_sint_t libsais_bwt_merge_main(const uint8_t * U1, const sa_sint_t * I1, sa_sint_t n1, sa_sint_t m1, const uint8_t * T2, const uint8_t * U2, sa_sint_t n2, sa_sint_t i2, uint8_t * U, sa_sint_t * I, sa_sint_t threads)
+{
+    fast_sint_t superblocks = ((fast_sint_t)n1 >> 16) + 1, slots = (fast_sint_t)n1 + m1 + 1;
+
+    LIBSAIS_THREAD_STATE *  RESTRICT thread_state   = threads > 1 ? libsais_alloc_thread_state(threads, NULL) : NULL;
+    sa_uint_t *             RESTRICT super          = (sa_uint_t *)libsais_alloc_aligned((size_t)(superblocks + 1) * ALPHABET_SIZE * sizeof(sa_uint_t), 4096);
+    uint16_t *              RESTRICT block          = (uint16_t *)libsais_alloc_aligned((size_t)(((fast_sint_t)n1 >> 8) + 1) * ALPHABET_SIZE * sizeof(uint16_t), 4096);
+    sa_sint_t *             RESTRICT gap            = (sa_sint_t *)libsais_alloc_aligned((size_t)slots * sizeof(sa_sint_t), 4096);
+
+    sa_sint_t index = (threads <= 1 || thread_state != NULL) && super != NULL && block != NULL && gap != NULL ? 0 : -2;
+    if (index == 0)
+    {
+        fast_sint_t sentinel = -1;
+
+        memset(gap, 0, (size_t)slots * sizeof(sa_sint_t));
+
+        libsais_bwt_merge_build_occ_omp(U1, n1, super, block, threads);
+        libsais_bwt_merge_compute_gaps(U1, I1, n1, m1, T2, n2, super, block, gap);
+
+#if defined(LIBSAIS_OPENMP)
+        #pragma omp parallel num_threads(threads) if(threads > 1 && slots >= 65536 && omp_get_dynamic() == 0)
+#endif
+        {
+#if defined(LIBSAIS_OPENMP)
+            fast_sint_t omp_thread_num    = omp_get_thread_num();
+            fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+            UNUSED(threads); UNUSED(thread_state);
+
+            fast_sint_t omp_thread_num    = 0;
+            fast_sint_t omp_num_threads   = 1;
+#endif
+            fast_sint_t omp_block_stride  = (slots / omp_num_threads) & (-16);
+            fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+            fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : slots - omp_block_start;
+
+            if (omp_num_threads == 1)
+            {
+                sentinel = libsais_bwt_merge_interleave(U1, I1, n1, m1, U2, i2, gap, U, I, omp_block_start, omp_block_size, 0);
+            }
+#if defined(LIBSAIS_OPENMP)
+            else
+            {
+                thread_state[omp_thread_num].state.count = libsais_bwt_merge_sum_gaps(gap, omp_block_start, omp_block_size);
+
+                #pragma omp barrier
+
+                fast_sint_t t, b = 0; for (t = 0; t < omp_thread_num; ++t) { b += thread_state[t].state.count; }
+
+                fast_sint_t position = libsais_bwt_merge_interleave(U1, I1, n1, m1, U2, i2, gap, U, I, omp_block_start, omp_block_size, b);
+                if (position >= 0) { sentinel = position; }
+            }
+#endif
+        }
+
+        {
+            fast_sint_t t = m1;
+            while (t > 0 && I[t - 1] > sentinel) { I[t] = I[t - 1]; t -= 1; }
+            I[t] = (sa_sint_t)sentinel;
+        }
+    }
+
+    libsais_free_aligned(gap);
+    libsais_free_aligned(block);
+    libsais_free_aligned(super);
+    libsais_free_thread_state(thread_state, NULL);
+
+    return index;
+}
+
+static sa_sint_t libsais_bwt_merge_validate(const uint8_t * U1, const sa_sint_t * I1, sa_sint_t n1, sa_sint_t m1, const uint8_t * T2, const uint8_t * U2, sa_sint_t n2, sa_sint_t i2, const uint8_t * U, const sa_sint_t * I)
+{
+    if ((U1 == NULL) || (I1 == NULL) || (m1 <= 0) || (n1 < m1) || (T2 == NULL) || (U2 == NULL) || (n2 <= 0) || (i2 <= 0) || (i2 > n2) || (U == NULL) || (I == NULL))
+    {
+        return -1;
+    }
+
+    if (n1 > SAINT_MAX - 1 - n2 - m1)
+    {
+        return -1;
+    }
+
+    fast_sint_t t;
+    for (t = 0; t < m1; ++t)
+    {
+        if ((I1[t] < m1) || (I1[t] >= n1 + m1) || (t > 0 && I1[t] <= I1[t - 1])) { return -1; }
+    }
+
+    return 0;
+}
+
+int32_t libsais_bwt_merge(const uint8_t * U1, const int32_t * I1, int32_t n1, int32_t m1, const uint8_t * T2, const uint8_t * U2, int32_t n2, int32_t i2, uint8_t * U, int32_t * I)
+{
+    if (libsais_bwt_merge_validate(U1, I1, n1, m1, T2, U2, n2, i2, U, I) != 0)
+    {
+        return -1;
+    }
+
+    return libsais_bwt_merge_main(U1, I1, n1, m1, T2, U2, n2, i2, U, I, 1);
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+int32_t libsais_bwt_merge_omp(const uint8_t * U1, const int32_t * I1, int32_t n1, int32_t m1, const uint8_t * T2, const uint8_t * U2, int32_t n2, int32_t i2, uint8_t * U, int32_t * I, int32_t threads)
+{
+    if ((libsais_bwt_merge_validate(U1, I1, n1, m1, T2, U2, n2, i2, U, I) != 0) || (threads < 0))
+    {
+        return -1;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais_bwt_merge_main(U1, I1, n1, m1, T2, U2, n2, i2, U, I, threads);
+}
+
+#endif
+
+static void libsais_sa_slice_count_bigrams(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT counts, fast_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i, j = omp_block_start + omp_block_size;
+    if (j == n && n > 0) { j -= 1; counts[(fast_sint_t)T[j] << 8]++; }
+
+    for (i = omp_block_start; i < j; i += 1) { counts[((fast_sint_t)T[i] << 8) | T[i + 1]]++; }
+}
+
+static void libsais_sa_slice_count_bigrams_omp(const uint8_t * RESTRICT T, sa_sint_t n, sa_sint_t * RESTRICT counts, sa_sint_t * RESTRICT buffer, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads); UNUSED(buffer);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        if (omp_num_threads == 1)
+        {
+            memset(counts, 0, ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_sint_t));
+            libsais_sa_slice_count_bigrams(T, counts, n, omp_block_start, omp_block_size);
+        }
+#if defined(LIBSAIS_OPENMP)
+        else
+        {
+            {
+                sa_sint_t * RESTRICT local = buffer + omp_thread_num * ALPHABET_SIZE * ALPHABET_SIZE;
+
+                memset(local, 0, ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_sint_t));
+                libsais_sa_slice_count_bigrams(T, local, n, omp_block_start, omp_block_size);
+            }
+
+            #pragma omp barrier
+
+            {
+                fast_sint_t k, t;
+                fast_sint_t key_stride  = ((ALPHABET_SIZE * ALPHABET_SIZE) / omp_num_threads) & (-16);
+                fast_sint_t key_start   = omp_thread_num * key_stride;
+                fast_sint_t key_end     = omp_thread_num < omp_num_threads - 1 ? key_start + key_stride : ALPHABET_SIZE * ALPHABET_SIZE;
+
+                for (k = key_start; k < key_end; k += 1)
+                {
+                    sa_sint_t sum = 0; for (t = 0; t < omp_num_threads; t += 1) { sum += buffer[t * ALPHABET_SIZE * ALPHABET_SIZE + k]; }
+                    counts[k] = sum;
+                }
+            }
+        }
+#endif
+    }
+}
+
+static void libsais_sa_partition_bounds(const sa_sint_t * RESTRICT counts, sa_sint_t n, sa_sint_t parts, sa_sint_t * RESTRICT bounds, sa_sint_t * RESTRICT sizes)
+{
+    fast_sint_t p, k = 0, sum = 0, prev = 0;
+
+    bounds[0] = 0;
+    for (p = 1; p < parts; p += 1)
+    {
+        fast_sint_t target = p * ((fast_sint_t)n / parts) + (p * ((fast_sint_t)n % parts)) / parts;
+
+        while (k < ALPHABET_SIZE * ALPHABET_SIZE && sum + counts[k] <= target) { sum += counts[k]; k += 1; }
+        if (k < ALPHABET_SIZE * ALPHABET_SIZE && sum + counts[k] - target < target - sum) { sum += counts[k]; k += 1; }
+
+        bounds[p] = (sa_sint_t)k; if (sizes != NULL) { sizes[p - 1] = (sa_sint_t)(sum - prev); } prev = sum;
+    }
+
+    bounds[parts] = ALPHABET_SIZE * ALPHABET_SIZE; if (sizes != NULL) { sizes[parts - 1] = (sa_sint_t)(n - prev); }
+}
+
+static sa_sint_t libsais_sa_partition_main(const uint8_t * T, sa_sint_t n, sa_sint_t parts, sa_sint_t * bounds, sa_sint_t * sizes, sa_sint_t threads)
+{
+    sa_sint_t * RESTRICT counts = (sa_sint_t *)libsais_alloc_aligned(ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
+    sa_sint_t * RESTRICT buffer = threads > 1 ? (sa_sint_t *)libsais_alloc_aligned((size_t)threads * ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_sint_t), 4096) : NULL;
+
+    sa_sint_t index = counts != NULL && (threads <= 1 || buffer != NULL) ? 0 : -2;
+    if (index == 0)
+    {
+        libsais_sa_slice_count_bigrams_omp(T, n, counts, buffer, threads);
+        libsais_sa_partition_bounds(counts, n, parts, bounds, sizes);
+    }
+
+    libsais_free_aligned(buffer);
+    libsais_free_aligned(counts);
+
+    return index;
+}
+
+static fast_sint_t libsais_sa_slice_compare(const uint8_t * RESTRICT T, fast_sint_t n, fast_sint_t i, fast_sint_t j, fast_sint_t d, fast_sint_t * RESTRICT budget)
+{
+    const uint8_t * RESTRICT a = T + i + d;
+    const uint8_t * RESTRICT b = T + j + d;
+
+    fast_sint_t p = 0, l = n - (i > j ? i : j) - d;
+    while (p < l && a[p] == b[p]) { p += 1; }
+
+    *budget -= p;
+
+    return p < l ? (fast_sint_t)a[p] - (fast_sint_t)b[p] : (i > j ? -1 : 1);
+}
+
+static sa_sint_t libsais_sa_slice_insertion_sort(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, fast_sint_t n, fast_sint_t lo, fast_sint_t hi, fast_sint_t d, fast_sint_t * RESTRICT budget)
+{
+    fast_sint_t i, j;
+    for (i = lo + 1; i < hi && *budget >= 0; i += 1)
+    {
+        sa_sint_t s = SA[i];
+        for (j = i; j > lo && libsais_sa_slice_compare(T, n, SA[j - 1], s, d, budget) > 0; j -= 1) { SA[j] = SA[j - 1]; }
+        SA[j] = s;
+    }
+
+    return *budget >= 0 ? 0 : -1;
+}
+
+static fast_sint_t libsais_sa_slice_symbol(const uint8_t * RESTRICT T, fast_sint_t n, fast_sint_t p)
+{
+    return p < n ? (fast_sint_t)T[p] : -1;
+}
+
+static sa_sint_t libsais_sa_slice_sort(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, fast_sint_t n, fast_sint_t lo, fast_sint_t hi, fast_sint_t d, fast_sint_t * RESTRICT budget)
+{
+    while (hi - lo > 16)
+    {
+        if ((*budget -= hi - lo) < 0) { return -1; }
+
+        fast_sint_t p, lt = lo, gt = hi, i = lo;
+        {
+            fast_sint_t a = libsais_sa_slice_symbol(T, n, (fast_sint_t)SA[lo] + d);
+            fast_sint_t b = libsais_sa_slice_symbol(T, n, (fast_sint_t)SA[lo + ((hi - lo) >> 1)] + d);
+            fast_sint_t c = libsais_sa_slice_symbol(T, n, (fast_sint_t)SA[hi - 1] + d);
+
+            p = a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+        }
+
+        while (i < gt)
+        {
+            sa_sint_t s = SA[i]; fast_sint_t c = libsais_sa_slice_symbol(T, n, (fast_sint_t)s + d);
+
+            if (c < p)      { SA[i] = SA[lt]; SA[lt] = s; lt += 1; i += 1; }
+            else if (c > p) { gt -= 1; SA[i] = SA[gt]; SA[gt] = s; }
+            else            { i += 1; }
+        }
+
+        if (gt - lt >= lt - lo && gt - lt >= hi - gt)
+        {
+            if (libsais_sa_slice_sort(T, SA, n, lo, lt, d, budget) != 0 || libsais_sa_slice_sort(T, SA, n, gt, hi, d, budget) != 0) { return -1; }
+            lo = lt; hi = gt; d += 1;
+        }
+        else if (lt - lo >= hi - gt)
+        {
+            if (libsais_sa_slice_sort(T, SA, n, lt, gt, d + 1, budget) != 0 || libsais_sa_slice_sort(T, SA, n, gt, hi, d, budget) != 0) { return -1; }
+            hi = lt;
+        }
+        else
+        {
+            if (libsais_sa_slice_sort(T, SA, n, lo, lt, d, budget) != 0 || libsais_sa_slice_sort(T, SA, n, lt, gt, d + 1, budget) != 0) { return -1; }
+            lo = gt;
+        }
+    }
+
+    return libsais_sa_slice_insertion_sort(T, SA, n, lo, hi, d, budget);
+}
+
+static fast_sint_t libsais_sa_slice_find_bucket(const sa_sint_t * RESTRICT bucket, fast_sint_t buckets, fast_sint_t target)
+{
+    fast_sint_t lo = 0, hi = buckets;
+    while (lo < hi) { fast_sint_t mid = lo + ((hi - lo) >> 1); if (bucket[mid] < target) { lo = mid + 1; } else { hi = mid; } }
+
+    return lo;
+}
+
+static sa_sint_t libsais_sa_slice_sort_buckets(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, fast_sint_t n, const sa_sint_t * RESTRICT bucket, fast_sint_t bucket_start, fast_sint_t bucket_end, fast_sint_t budget)
+{
+    fast_sint_t k;
+    for (k = bucket_start; k < bucket_end; k += 1)
+    {
+        if (libsais_sa_slice_sort(T, SA, n, bucket[k], bucket[k + 1], 1, &budget) != 0) { return -1; }
+    }
+
+    return 0;
+}
+
+static sa_sint_t libsais_sa_slice_sort_buckets_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, const sa_sint_t * RESTRICT bucket, fast_sint_t buckets, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t threads)
+{
+    sa_sint_t index = 0; fast_sint_t m = bucket[buckets];
+
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && m >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads); UNUSED(thread_state);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t bucket_start      = libsais_sa_slice_find_bucket(bucket, buckets, (m / omp_num_threads) * omp_thread_num);
+        fast_sint_t bucket_end        = omp_thread_num < omp_num_threads - 1 ? libsais_sa_slice_find_bucket(bucket, buckets, (m / omp_num_threads) * (omp_thread_num + 1)) : buckets;
+        fast_sint_t budget            = (fast_sint_t)n / omp_num_threads + ((fast_sint_t)(bucket[bucket_end] - bucket[bucket_start]) << 6);
+
+        if (omp_num_threads == 1)
+        {
+            index = libsais_sa_slice_sort_buckets(T, SA, n, bucket, bucket_start, bucket_end, budget);
+        }
+#if defined(LIBSAIS_OPENMP)
+        else
+        {
+            thread_state[omp_thread_num].state.count = libsais_sa_slice_sort_buckets(T, SA, n, bucket, bucket_start, bucket_end, budget);
+
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                fast_sint_t t; for (t = 0; t < omp_num_threads; ++t) { if (thread_state[t].state.count != 0) { index = -1; } }
+            }
+        }
+#endif
+    }
+
+    return index;
+}
+
+static sa_sint_t libsais_sa_slice_fallback(const uint8_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t size, fast_sint_t first, fast_sint_t m, sa_sint_t threads)
+{
+    sa_sint_t * RESTRICT buffer = size >= n ? SA : (sa_sint_t *)libsais_alloc_aligned((size_t)n * sizeof(sa_sint_t), 4096);
+    if (buffer == NULL)
+    {
+        return -2;
+    }
+
+#if defined(LIBSAIS_OPENMP)
+    sa_sint_t index = threads > 1 ? libsais_omp(T, buffer, n, buffer == SA ? size - n : 0, NULL, threads) : libsais(T, buffer, n, buffer == SA ? size - n : 0, NULL);
+#else
+    UNUSED(threads);
+
+    sa_sint_t index = libsais(T, buffer, n, buffer == SA ? size - n : 0, NULL);
+#endif
+
+    if (index == 0)
+    {
+        memmove(SA, buffer + first, (size_t)m * sizeof(sa_sint_t));
+    }
+
+    if (buffer != SA) { libsais_free_aligned(buffer); }
+
+    return index;
+}
+
+static sa_sint_t libsais_sa_slice_main(const uint8_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t lo, sa_sint_t hi, sa_sint_t size, sa_sint_t threads)
+{
+    fast_sint_t buckets = (fast_sint_t)hi - lo;
+
+    LIBSAIS_THREAD_STATE *  RESTRICT thread_state   = threads > 1 ? libsais_alloc_thread_state(threads, NULL) : NULL;
+    sa_sint_t *             RESTRICT bucket         = (sa_sint_t *)libsais_alloc_aligned((size_t)(buckets + 1) * sizeof(sa_sint_t), 4096);
+
+    sa_sint_t index = (threads <= 1 || thread_state != NULL) && bucket != NULL ? 0 : -2;
+    if (index == 0)
+    {
+        fast_sint_t i, k, m = 0, first = 0;
+
+        memset(bucket, 0, (size_t)(buckets + 1) * sizeof(sa_sint_t));
+
+        for (i = 0; i < n; i += 1)
+        {
+            k = (i < n - 1 ? (((fast_sint_t)T[i] << 8) | T[i + 1]) : ((fast_sint_t)T[i] << 8)) - lo;
+            if (k < 0) { first += 1; } else if (k < buckets) { bucket[k + 1] += 1; }
+        }
+
+        for (k = 1; k <= buckets; k += 1) { sa_sint_t c = bucket[k]; bucket[k] = (sa_sint_t)m; m += c; }
+
+        if (m > size)
+        {
+            index = -3;
+        }
+        else if (m > 0)
+        {
+            for (i = 0; i < n; i += 1)
+            {
+                k = (i < n - 1 ? (((fast_sint_t)T[i] << 8) | T[i + 1]) : ((fast_sint_t)T[i] << 8)) - lo;
+                if (k >= 0 && k < buckets) { SA[bucket[k + 1]++] = (sa_sint_t)i; }
+            }
+
+            if (libsais_sa_slice_sort_buckets_omp(T, SA, n, bucket, buckets, thread_state, threads) != 0)
+            {
+                index = libsais_sa_slice_fallback(T, SA, n, size, first, m, threads);
+            }
+        }
+
+        if (index == 0) { index = (sa_sint_t)m; }
+    }
+
+    libsais_free_aligned(bucket);
+    libsais_free_thread_state(thread_state, NULL);
+
+    return index;
+}
+
+static sa_sint_t libsais_sa_slice_validate(const uint8_t * T, const sa_sint_t * SA, sa_sint_t n, sa_sint_t lo, sa_sint_t hi, sa_sint_t size)
+{
+    return (T == NULL) || (SA == NULL) || (n < 0) || (lo < 0) || (lo > hi) || (hi > ALPHABET_SIZE * ALPHABET_SIZE) || (size < 0) ? -1 : 0;
+}
+
+int32_t libsais_sa_partition(const uint8_t * T, int32_t n, int32_t parts, int32_t * bounds, int32_t * sizes)
+{
+    if ((T == NULL) || (n < 0) || (parts <= 0) || (parts > ALPHABET_SIZE * ALPHABET_SIZE) || (bounds == NULL))
+    {
+        return -1;
+    }
+
+    return libsais_sa_partition_main(T, n, parts, bounds, sizes, 1);
+}
+
+int32_t libsais_sa_slice(const uint8_t * T, int32_t * SA, int32_t n, int32_t lo, int32_t hi, int32_t size)
+{
+    if (libsais_sa_slice_validate(T, SA, n, lo, hi, size) != 0)
+    {
+        return -1;
+    }
+
+    return libsais_sa_slice_main(T, SA, n, lo, hi, size, 1);
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+int32_t libsais_sa_partition_omp(const uint8_t * T, int32_t n, int32_t parts, int32_t * bounds, int32_t * sizes, int32_t threads)
+{
+    if ((T == NULL) || (n < 0) || (parts <= 0) || (parts > ALPHABET_SIZE * ALPHABET_SIZE) || (bounds == NULL) || (threads < 0))
+    {
+        return -1;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais_sa_partition_main(T, n, parts, bounds, sizes, threads);
+}
+
+int32_t libsais_sa_slice_omp(const uint8_t * T, int32_t * SA, int32_t n, int32_t lo, int32_t hi, int32_t size, int32_t threads)
+{
+    if ((libsais_sa_slice_validate(T, SA, n, lo, hi, size) != 0) || (threads < 0))
+    {
+        return -1;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais_sa_slice_main(T, SA, n, lo, hi, size, threads);
+}
+
+#endif
+
+static void libsais_compute_phi(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j; sa_sint_t k = omp_block_start > 0 ? SA[omp_block_start - 1] : n;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
+    {
+        libsais_prefetchr(&SA[i + 2 * prefetch_distance]);
+
+        libsais_prefetchw(&PLCP[SA[i + prefetch_distance + 0]]);
+        libsais_prefetchw(&PLCP[SA[i + prefetch_distance + 1]]);
+
+        PLCP[SA[i + 0]] = k; k = SA[i + 0];
+        PLCP[SA[i + 1]] = k; k = SA[i + 1];
+
+        libsais_prefetchw(&PLCP[SA[i + prefetch_distance + 2]]);
+        libsais_prefetchw(&PLCP[SA[i + prefetch_distance + 3]]);
+
+        PLCP[SA[i + 2]] = k; k = SA[i + 2];
+        PLCP[SA[i + 3]] = k; k = SA[i + 3];
+    }
+
+    for (j += prefetch_distance + 3; i < j; i += 1)
+    {
+        PLCP[SA[i]] = k; k = SA[i];
+    }
+}
+
+static void libsais_compute_phi_omp(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais_compute_phi(SA, PLCP, n, omp_block_start, omp_block_size);
+    }
+}
+
+static void libsais_compute_plcp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, fast_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j, l = 0;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais_prefetchw(&PLCP[i + 2 * prefetch_distance]);
+        libsais_prefetchr(&T[PLCP[i + prefetch_distance] + l]);
+
+        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
+        while (l < m && T[i + l] == T[k + l]) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+    }
+
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
+        while (l < m && T[i + l] == T[k + l]) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+    }
+}
+
+static void libsais_compute_plcp_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais_compute_plcp(T, PLCP, n, omp_block_start, omp_block_size);
+    }
+}
+
+static void libsais_compute_plcp_gsa(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, fast_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j, l = 0;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais_prefetchw(&PLCP[i + 2 * prefetch_distance]);
+        libsais_prefetchr(&T[PLCP[i + prefetch_distance] + l]);
+
+        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
+        while (l < m && T[i + l] == T[k + l] && T[i + l] != 0) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+    }
+
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
+        while (l < m && T[i + l] == T[k + l] && T[i + l] != 0) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+    }
+}
+
+static void libsais_compute_plcp_gsa_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais_compute_plcp_gsa(T, PLCP, n, omp_block_start, omp_block_size);
+    }
+}
+
+static void libsais_compute_plcp_int(const int32_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, fast_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j, l = 0;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais_prefetchw(&PLCP[i + 2 * prefetch_distance]);
+        libsais_prefetchr(&T[PLCP[i + prefetch_distance] + l]);
+
+        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
+        while (l < m && T[i + l] == T[k + l]) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+    }
+
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
+        while (l < m && T[i + l] == T[k + l]) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+    }
+}
+
+static void libsais_compute_plcp_int_omp(const int32_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais_compute_plcp_int(T, PLCP, n, omp_block_start, omp_block_size);
+    }
+}
+
+static void libsais_compute_lcp(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    fast_uint_t sum, c;
-    for (sum = 1, c = 0; c < ALPHABET_SIZE; ++c)
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
     {
-        fast_uint_t prev = sum; sum += bucket1[c]; bucket1[c] = (sa_uint_t)prev;
-        if (prev != sum)
-        {
-            sa_uint_t * RESTRICT bucket2_p = &bucket2[c << 8];
+        libsais_prefetchr(&SA[i + 2 * prefetch_distance]);
+        libsais_prefetchw(&LCP[i + prefetch_distance]);
 
-            {
-                fast_uint_t hi = index; if (sum < hi) { hi = sum; }
-                libsais_unbwt_compute_histogram(&T[prev], (fast_sint_t)(hi - prev), bucket2_p);
-            }
+        libsais_prefetchr(&PLCP[SA[i + prefetch_distance + 0]]);
+        libsais_prefetchr(&PLCP[SA[i + prefetch_distance + 1]]);
 
-            {
-                fast_uint_t lo = index + 1; if (prev > lo) { lo = prev; }
-                libsais_unbwt_compute_histogram(&T[lo - 1], (fast_sint_t)(sum - lo), bucket2_p);
-            }
-        }
+        LCP[i + 0] = PLCP[SA[i + 0]];
+        LCP[i + 1] = PLCP[SA[i + 1]];
+
+        libsais_prefetchr(&PLCP[SA[i + prefetch_distance + 2]]);
+        libsais_prefetchr(&PLCP[SA[i + prefetch_distance + 3]]);
+
+        LCP[i + 2] = PLCP[SA[i + 2]];
+        LCP[i + 3] = PLCP[SA[i + 3]];
     }
 
-    libsais_unbwt_transpose_bucket2(bucket2);
+    for (j += prefetch_distance + 3; i < j; i += 1)
+    {
+        LCP[i] = PLCP[SA[i]];
+    }
 }
 
-static void libsais_unbwt_calculate_fastbits(sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t lastc, fast_uint_t shift)
+static void libsais_compute_lcp_omp(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, sa_sint_t n, sa_sint_t threads)
 {
-    fast_uint_t v, w, sum, c, d;
-    for (v = 0, w = 0, sum = 1, c = 0; c < ALPHABET_SIZE; ++c)
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
     {
-        if (c == lastc) { sum += 1; }
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
 
-        for (d = 0; d < ALPHABET_SIZE; ++d, ++w)
-        {
-            fast_uint_t prev = sum; sum += bucket2[w]; bucket2[w] = (sa_uint_t)prev;
-            if (prev != sum)
-            {
-                for (; v <= ((sum - 1) >> shift); ++v) { fastbits[v] = (uint16_t)w; }
-            }
-        }
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais_compute_lcp(PLCP, SA, LCP, omp_block_start, omp_block_size);
     }
 }
 
-static void libsais_unbwt_calculate_biPSI(const uint8_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket1, sa_uint_t * RESTRICT bucket2, fast_uint_t index, fast_sint_t omp_block_start, fast_sint_t omp_block_end)
+static void libsais_compute_isa(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT ISA, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    {
-        fast_sint_t i = omp_block_start, j = (fast_sint_t)index; if (omp_block_end < j) { j = omp_block_end; }
-        for (; i < j; ++i)
-        {
-            fast_uint_t c = T[i];
-            fast_uint_t p = bucket1[c]++;
-            fast_sint_t t = (fast_sint_t)(index - p);
-
-            if (t != 0)
-            {
-                fast_uint_t w = (((fast_uint_t)T[p + (fast_uint_t)(t >> ((sizeof(fast_sint_t) * 8) - 1))]) << 8) + c;
-                P[bucket2[w]++] = (sa_uint_t)i;
-            }
-        }
-    }
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
     {
-        fast_sint_t i = (fast_sint_t)index, j = omp_block_end; if (omp_block_start > i) { i = omp_block_start; }
-        for (i += 1; i <= j; ++i)
-        {
-            fast_uint_t c = T[i - 1];
-            fast_uint_t p = bucket1[c]++;
-            fast_sint_t t = (fast_sint_t)(index - p);
+        libsais_prefetchr(&SA[i + 2 * prefetch_distance]);
 
-            if (t != 0)
-            {
-                fast_uint_t w = (((fast_uint_t)T[p + (fast_uint_t)(t >> ((sizeof(fast_sint_t) * 8) - 1))]) << 8) + c;
-                P[bucket2[w]++] = (sa_uint_t)i;
-            }
-        }
-    }
-}
+        libsais_prefetchw(&ISA[SA[i + prefetch_distance + 0]]);
+        libsais_prefetchw(&ISA[SA[i + prefetch_distance + 1]]);
 
-static void libsais_unbwt_init_single(const uint8_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits)
-{
-    sa_uint_t bucket1[ALPHABET_SIZE];
+        ISA[SA[i + 0]] = (sa_sint_t)(i + 0);
+        ISA[SA[i + 1]] = (sa_sint_t)(i + 1);
 
-    fast_uint_t index = I[0];
-    fast_uint_t lastc = T[0];
-    fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+        libsais_prefetchw(&ISA[SA[i + prefetch_distance + 2]]);
+        libsais_prefetchw(&ISA[SA[i + prefetch_distance + 3]]);
 
-    if (freq != NULL)
-    {
-        memcpy(bucket1, freq, ALPHABET_SIZE * sizeof(sa_uint_t));
+        ISA[SA[i + 2]] = (sa_sint_t)(i + 2);
+        ISA[SA[i + 3]] = (sa_sint_t)(i + 3);
     }
-    else
+
+    for (j += prefetch_distance + 3; i < j; i += 1)
     {
-        memset(bucket1, 0, ALPHABET_SIZE * sizeof(sa_uint_t));
-        libsais_unbwt_compute_histogram(T, n, bucket1);
+        ISA[SA[i]] = (sa_sint_t)i;
     }
-
-    memset(bucket2, 0, ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_uint_t));
-    libsais_unbwt_compute_bigram_histogram_single(T, bucket1, bucket2, index);
-
-    libsais_unbwt_calculate_fastbits(bucket2, fastbits, lastc, shift);
-    libsais_unbwt_calculate_biPSI(T, P, bucket1, bucket2, index, 0, n);
 }
 
-#if defined(LIBSAIS_OPENMP)
-
-static void libsais_unbwt_compute_bigram_histogram_parallel(const uint8_t * RESTRICT T, fast_uint_t index, sa_uint_t * RESTRICT bucket1, sa_uint_t * RESTRICT bucket2, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+static void libsais_compute_isa_inplace(sa_sint_t * RESTRICT SA, sa_sint_t n)
 {
     fast_sint_t i;
-    for (i = omp_block_start; i < omp_block_start + omp_block_size; ++i)
+    for (i = 0; i < n; i += 1)
     {
-        fast_uint_t c = T[i];
-        fast_uint_t p = bucket1[c]++;
-        fast_sint_t t = (fast_sint_t)(index - p);
-
-        if (t != 0)
+        if (SA[i] >= 0)
         {
-            fast_uint_t w = (((fast_uint_t)T[p + (fast_uint_t)(t >> ((sizeof(fast_sint_t) * 8) - 1))]) << 8) + c;
-            bucket2[w]++;
+            sa_sint_t p = (sa_sint_t)i, q = SA[i];
+            while (q != (sa_sint_t)i) { sa_sint_t r = SA[q]; SA[q] = p | SAINT_MIN; p = q; q = r; }
+
+            SA[i] = p | SAINT_MIN;
         }
     }
 }
 
-static void libsais_unbwt_init_parallel(const uint8_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, sa_uint_t * RESTRICT buckets, sa_sint_t threads)
+static void libsais_unmark_array(sa_sint_t * RESTRICT A, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    sa_uint_t bucket1[ALPHABET_SIZE];
-
-    fast_uint_t index = I[0];
-    fast_uint_t lastc = T[0];
-    fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+    fast_sint_t i;
+    for (i = omp_block_start; i < omp_block_start + omp_block_size; i += 1)
+    {
+        A[i] &= SAINT_MAX;
+    }
+}
 
-    memset(bucket1, 0, ALPHABET_SIZE * sizeof(sa_uint_t));
-    memset(bucket2, 0, ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_uint_t));
+static void libsais_compute_isa_omp(const sa_sint_t * SA, sa_sint_t * ISA, sa_sint_t n, sa_sint_t threads)
+{
+    if (SA == ISA)
+    {
+        libsais_compute_isa_inplace(ISA, n);
+    }
 
+#if defined(LIBSAIS_OPENMP)
     #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
     {
-        fast_sint_t omp_thread_num  = omp_get_thread_num();
-        fast_sint_t omp_num_threads = omp_get_num_threads();
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
 
-        if (omp_num_threads == 1)
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        if (SA == ISA)
         {
-            libsais_unbwt_init_single(T, P, n, freq, I, bucket2, fastbits);
+            libsais_unmark_array(ISA, omp_block_start, omp_block_size);
         }
         else
         {
-            sa_uint_t * RESTRICT bucket1_local  = buckets + omp_thread_num * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE));
-            sa_uint_t * RESTRICT bucket2_local  = bucket1_local + ALPHABET_SIZE;
-
-            fast_sint_t omp_block_stride        = (n / omp_num_threads) & (-16);
-            fast_sint_t omp_block_start         = omp_thread_num * omp_block_stride;
-            fast_sint_t omp_block_size          = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
-
-            {
-                memset(bucket1_local, 0, ALPHABET_SIZE * sizeof(sa_uint_t));
-                libsais_unbwt_compute_histogram(T + omp_block_start, omp_block_size, bucket1_local);
-            }
-
-            #pragma omp barrier
-
-            #pragma omp master
-            {
-                {
-                    sa_uint_t * RESTRICT bucket1_temp = buckets;
-
-                    fast_sint_t t;
-                    for (t = 0; t < omp_num_threads; ++t, bucket1_temp += ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE))
-                    {
-                        fast_sint_t c; for (c = 0; c < ALPHABET_SIZE; c += 1) { sa_uint_t A = bucket1[c], B = bucket1_temp[c]; bucket1[c] = A + B; bucket1_temp[c] = A; }
-                    }
-                }
-
-                {
-                    fast_uint_t sum, c;
-                    for (sum = 1, c = 0; c < ALPHABET_SIZE; ++c) { fast_uint_t prev = sum; sum += bucket1[c]; bucket1[c] = (sa_uint_t)prev; }
-                }
-            }
-
-            #pragma omp barrier
-
-            {
-                fast_sint_t c; for (c = 0; c < ALPHABET_SIZE; c += 1) { sa_uint_t A = bucket1[c], B = bucket1_local[c]; bucket1_local[c] = A + B; }
-
-                memset(bucket2_local, 0, ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_uint_t));
-                libsais_unbwt_compute_bigram_histogram_parallel(T, index, bucket1_local, bucket2_local, omp_block_start, omp_block_size);
-            }
-
-            #pragma omp barrier
-
-            {
-                fast_sint_t omp_bucket2_stride  = ((ALPHABET_SIZE * ALPHABET_SIZE) / omp_num_threads) & (-16);
-                fast_sint_t omp_bucket2_start   = omp_thread_num * omp_bucket2_stride;
-                fast_sint_t omp_bucket2_size    = omp_thread_num < omp_num_threads - 1 ? omp_bucket2_stride : (ALPHABET_SIZE * ALPHABET_SIZE) - omp_bucket2_start;
-
-                sa_uint_t * RESTRICT bucket2_temp = buckets + ALPHABET_SIZE;
-
-                fast_sint_t t;
-                for (t = 0; t < omp_num_threads; ++t, bucket2_temp += ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE))
-                {
-                    fast_sint_t c; for (c = omp_bucket2_start; c < omp_bucket2_start + omp_bucket2_size; c += 1) { sa_uint_t A = bucket2[c], B = bucket2_temp[c]; bucket2[c] = A + B; bucket2_temp[c] = A; }
-                }
-            }
-
-            #pragma omp barrier
-
-            #pragma omp master
-            {
-
-                libsais_unbwt_calculate_fastbits(bucket2, fastbits, lastc, shift);
-
-                {
-                    fast_sint_t t;
-                    for (t = omp_num_threads - 1; t >= 1; --t) 
-                    { 
-                        sa_uint_t * RESTRICT dst_bucket1 = buckets + t * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE));
-                        sa_uint_t * RESTRICT src_bucket1 = dst_bucket1 - (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE));
-
-                        memcpy(dst_bucket1, src_bucket1, ALPHABET_SIZE * sizeof(sa_uint_t));
-                    }
+            libsais_compute_isa(SA, ISA, omp_block_start, omp_block_size);
+        }
+    }
+}
 
-                    memcpy(buckets, bucket1, ALPHABET_SIZE * sizeof(sa_uint_t));
-                }
-            }
+static void libsais_compute_lcp_inplace(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n)
+{
+    fast_sint_t i;
+    for (i = 0; i < n; i += 1)
+    {
+        if (PLCP[i] >= 0)
+        {
+            sa_sint_t l = PLCP[i]; fast_sint_t j = i, k;
+            while ((k = (fast_sint_t)SA[j]) != i) { PLCP[j] = PLCP[k] | SAINT_MIN; j = k; }
 
-            #pragma omp barrier
+            PLCP[j] = l | SAINT_MIN;
+        }
+    }
+}
 
-            {
-                fast_sint_t c; for (c = 0; c < ALPHABET_SIZE * ALPHABET_SIZE; c += 1) { sa_uint_t A = bucket2[c], B = bucket2_local[c]; bucket2_local[c] = A + B; }
+static void libsais_compute_lcp_inplace_omp(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+{
+    libsais_compute_lcp_inplace(SA, PLCP, n);
 
-                libsais_unbwt_calculate_biPSI(T, P, bucket1_local, bucket2_local, index, omp_block_start, omp_block_start + omp_block_size);
-            }
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
 
-            #pragma omp barrier
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
 
-            #pragma omp master
-            {
-                memcpy(bucket2, buckets + ALPHABET_SIZE + (omp_num_threads - 1) * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE)), ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_uint_t));
-            }
-        }
+        libsais_unmark_array(PLCP, omp_block_start, omp_block_size);
     }
 }
 
-#endif
+static void libsais_compute_sa_lcp_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, sa_sint_t n, sa_sint_t fs, sa_sint_t threads)
+{
+    if (fs >= n)
+    {
+        libsais_compute_phi_omp(SA, &SA[n], n, threads);
+        libsais_compute_plcp_omp(T, &SA[n], n, threads);
+        libsais_compute_lcp_omp(&SA[n], SA, LCP, n, threads);
+    }
+    else
+    {
+        libsais_compute_phi_omp(SA, LCP, n, threads);
+        libsais_compute_plcp_omp(T, LCP, n, threads);
+        libsais_compute_lcp_inplace_omp(SA, LCP, n, threads);
+    }
+}
 
-static void libsais_unbwt_decode_1(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t * i0, fast_uint_t k)
+static void libsais_compute_phi_sampled(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t r, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
-
-    fast_uint_t i, p0 = *i0;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
-    for (i = 0; i != k; ++i)
+    fast_sint_t i, j; sa_sint_t k = omp_block_start > 0 ? SA[omp_block_start - 1] : n, s;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - 3; i < j; i += 4)
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais_bswap16(c0);
+        libsais_prefetchr(&SA[i + prefetch_distance]);
+
+        s = SA[i + 0]; if ((s & (r - 1)) == 0) { PLCP[s / r] = k; } k = s;
+        s = SA[i + 1]; if ((s & (r - 1)) == 0) { PLCP[s / r] = k; } k = s;
+        s = SA[i + 2]; if ((s & (r - 1)) == 0) { PLCP[s / r] = k; } k = s;
+        s = SA[i + 3]; if ((s & (r - 1)) == 0) { PLCP[s / r] = k; } k = s;
     }
 
-    *i0 = p0;
+    for (j += 3; i < j; i += 1)
+    {
+        s = SA[i]; if ((s & (r - 1)) == 0) { PLCP[s / r] = k; } k = s;
+    }
 }
 
-static void libsais_unbwt_decode_2(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t k)
+static void libsais_compute_phi_sampled_omp(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t r, sa_sint_t threads)
 {
-    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
-    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
 
-    fast_uint_t i, p0 = *i0, p1 = *i1;
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
 
-    for (i = 0; i != k; ++i)
-    {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais_bswap16(c0);
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais_bswap16(c1);
+        libsais_compute_phi_sampled(SA, PLCP, n, r, omp_block_start, omp_block_size);
     }
-
-    *i0 = p0; *i1 = p1;
 }
 
-static void libsais_unbwt_decode_3(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t k)
+static void libsais_compute_plcp_sampled(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, fast_sint_t n, fast_sint_t r, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
-    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
-    uint16_t * RESTRICT U2 = (uint16_t *)(void *)(((uint8_t *)U1) + r);
-
-    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
-    for (i = 0; i != k; ++i)
+    fast_sint_t i, j, l = 0;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais_bswap16(c0);
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais_bswap16(c1);
-        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = libsais_bswap16(c2);
+        libsais_prefetchw(&PLCP[i + 2 * prefetch_distance]);
+        libsais_prefetchr(&T[(i + prefetch_distance) * r + l]);
+        libsais_prefetchr(&T[PLCP[i + prefetch_distance] + l]);
+
+        fast_sint_t p = i * r, k = PLCP[i], m = n - (p > k ? p : k);
+        while (l < m && T[p + l] == T[k + l]) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l = l > r ? l - r : 0;
     }
 
-    *i0 = p0; *i1 = p1; *i2 = p2;
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        fast_sint_t p = i * r, k = PLCP[i], m = n - (p > k ? p : k);
+        while (l < m && T[p + l] == T[k + l]) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l = l > r ? l - r : 0;
+    }
 }
 
-static void libsais_unbwt_decode_4(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t k)
+static void libsais_compute_plcp_sampled_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t r, sa_sint_t threads)
 {
-    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
-    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
-    uint16_t * RESTRICT U2 = (uint16_t *)(void *)(((uint8_t *)U1) + r);
-    uint16_t * RESTRICT U3 = (uint16_t *)(void *)(((uint8_t *)U2) + r);
+    fast_sint_t m = ((fast_sint_t)n - 1) / r + 1;
 
-    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3;
-
-    for (i = 0; i != k; ++i)
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais_bswap16(c0);
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais_bswap16(c1);
-        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = libsais_bswap16(c2);
-        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = libsais_bswap16(c3);
-    }
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
 
-    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3;
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (m / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : m - omp_block_start;
+
+        libsais_compute_plcp_sampled(T, PLCP, n, r, omp_block_start, omp_block_size);
+    }
 }
 
-static void libsais_unbwt_decode_5(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t k)
+static sa_sint_t libsais_compute_lcp_sample(const uint8_t * RESTRICT T, const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, fast_sint_t n, fast_sint_t r, fast_sint_t i)
 {
-    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
-    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
-    uint16_t * RESTRICT U2 = (uint16_t *)(void *)(((uint8_t *)U1) + r);
-    uint16_t * RESTRICT U3 = (uint16_t *)(void *)(((uint8_t *)U2) + r);
-    uint16_t * RESTRICT U4 = (uint16_t *)(void *)(((uint8_t *)U3) + r);
+    if (i == 0) { return 0; }
 
-    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4;
+    fast_sint_t p = SA[i], k = SA[i - 1], m = n - (p > k ? p : k);
+    fast_sint_t l = PLCP[p / r] - (p & (r - 1)); l = l > 0 ? l : 0;
+    while (l < m && T[p + l] == T[k + l]) { l++; }
 
-    for (i = 0; i != k; ++i)
+    return (sa_sint_t)l;
+}
+
+static void libsais_compute_lcp_sampled(const uint8_t * RESTRICT T, const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, fast_sint_t n, fast_sint_t r, fast_sint_t k, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais_bswap16(c0);
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais_bswap16(c1);
-        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = libsais_bswap16(c2);
-        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = libsais_bswap16(c3);
-        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = libsais_bswap16(c4);
+        libsais_prefetchr(&SA[(i + 2 * prefetch_distance) * k - 1]);
+        libsais_prefetchr(&PLCP[SA[(i + prefetch_distance) * k] / r]);
+
+        LCP[i] = libsais_compute_lcp_sample(T, PLCP, SA, n, r, i * k);
     }
 
-    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4;
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        LCP[i] = libsais_compute_lcp_sample(T, PLCP, SA, n, r, i * k);
+    }
 }
 
-static void libsais_unbwt_decode_6(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t * i5, fast_uint_t k)
+static void libsais_compute_lcp_sampled_omp(const uint8_t * RESTRICT T, const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, sa_sint_t n, sa_sint_t r, sa_sint_t k, sa_sint_t threads)
 {
-    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
-    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
-    uint16_t * RESTRICT U2 = (uint16_t *)(void *)(((uint8_t *)U1) + r);
-    uint16_t * RESTRICT U3 = (uint16_t *)(void *)(((uint8_t *)U2) + r);
-    uint16_t * RESTRICT U4 = (uint16_t *)(void *)(((uint8_t *)U3) + r);
-    uint16_t * RESTRICT U5 = (uint16_t *)(void *)(((uint8_t *)U4) + r);
+    fast_sint_t m = ((fast_sint_t)n - 1) / k + 1;
 
-    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4, p5 = *i5;
-
-    for (i = 0; i != k; ++i)
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && m >= 65536)
+#endif
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais_bswap16(c0);
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais_bswap16(c1);
-        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = libsais_bswap16(c2);
-        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = libsais_bswap16(c3);
-        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = libsais_bswap16(c4);
-        uint16_t c5 = fastbits[p5 >> shift]; if (bucket2[c5] <= p5) { do { c5++; } while (bucket2[c5] <= p5); } p5 = P[p5]; U5[i] = libsais_bswap16(c5);
-    }
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
 
-    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4; *i5 = p5;
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (m / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : m - omp_block_start;
+
+        libsais_compute_lcp_sampled(T, PLCP, SA, LCP, n, r, k, omp_block_start, omp_block_size);
+    }
 }
 
-static void libsais_unbwt_decode_7(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t * i5, fast_uint_t * i6, fast_uint_t k)
+#if defined(LIBSAIS_OPENMP)
+
+static fast_sint_t libsais_count_marked(const uint8_t * RESTRICT B, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
-    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
-    uint16_t * RESTRICT U2 = (uint16_t *)(void *)(((uint8_t *)U1) + r);
-    uint16_t * RESTRICT U3 = (uint16_t *)(void *)(((uint8_t *)U2) + r);
-    uint16_t * RESTRICT U4 = (uint16_t *)(void *)(((uint8_t *)U3) + r);
-    uint16_t * RESTRICT U5 = (uint16_t *)(void *)(((uint8_t *)U4) + r);
-    uint16_t * RESTRICT U6 = (uint16_t *)(void *)(((uint8_t *)U5) + r);
+    fast_sint_t i, j, c = 0;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - 7; i < j; i += 8)
+    {
+        fast_uint_t x = B[i >> 3];
 
-    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4, p5 = *i5, p6 = *i6;
+        x = x - ((x >> 1) & 0x55); x = (x & 0x33) + ((x >> 2) & 0x33); c += (fast_sint_t)((x + (x >> 4)) & 0x0f);
+    }
 
-    for (i = 0; i != k; ++i)
+    for (j += 7; i < j; i += 1)
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais_bswap16(c0);
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais_bswap16(c1);
-        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = libsais_bswap16(c2);
-        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = libsais_bswap16(c3);
-        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = libsais_bswap16(c4);
-        uint16_t c5 = fastbits[p5 >> shift]; if (bucket2[c5] <= p5) { do { c5++; } while (bucket2[c5] <= p5); } p5 = P[p5]; U5[i] = libsais_bswap16(c5);
-        uint16_t c6 = fastbits[p6 >> shift]; if (bucket2[c6] <= p6) { do { c6++; } while (bucket2[c6] <= p6); } p6 = P[p6]; U6[i] = libsais_bswap16(c6);
+        c += (B[i >> 3] >> (i & 7)) & 1;
     }
 
-    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4; *i5 = p5; *i6 = p6;
+    return c;
 }
 
-static void libsais_unbwt_decode_8(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t * i5, fast_uint_t * i6, fast_uint_t * i7, fast_uint_t k)
-{
-    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
-    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
-    uint16_t * RESTRICT U2 = (uint16_t *)(void *)(((uint8_t *)U1) + r);
-    uint16_t * RESTRICT U3 = (uint16_t *)(void *)(((uint8_t *)U2) + r);
-    uint16_t * RESTRICT U4 = (uint16_t *)(void *)(((uint8_t *)U3) + r);
-    uint16_t * RESTRICT U5 = (uint16_t *)(void *)(((uint8_t *)U4) + r);
-    uint16_t * RESTRICT U6 = (uint16_t *)(void *)(((uint8_t *)U5) + r);
-    uint16_t * RESTRICT U7 = (uint16_t *)(void *)(((uint8_t *)U6) + r);
-
-    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4, p5 = *i5, p6 = *i6, p7 = *i7;
+#endif
 
-    for (i = 0; i != k; ++i)
+static fast_sint_t libsais_compute_lcp_marked(const uint8_t * RESTRICT T, const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, const uint8_t * RESTRICT B, sa_sint_t * RESTRICT LCP, fast_sint_t n, fast_sint_t r, fast_sint_t c, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size; i < j; i += 1)
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais_bswap16(c0);
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais_bswap16(c1);
-        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = libsais_bswap16(c2);
-        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = libsais_bswap16(c3);
-        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = libsais_bswap16(c4);
-        uint16_t c5 = fastbits[p5 >> shift]; if (bucket2[c5] <= p5) { do { c5++; } while (bucket2[c5] <= p5); } p5 = P[p5]; U5[i] = libsais_bswap16(c5);
-        uint16_t c6 = fastbits[p6 >> shift]; if (bucket2[c6] <= p6) { do { c6++; } while (bucket2[c6] <= p6); } p6 = P[p6]; U6[i] = libsais_bswap16(c6);
-        uint16_t c7 = fastbits[p7 >> shift]; if (bucket2[c7] <= p7) { do { c7++; } while (bucket2[c7] <= p7); } p7 = P[p7]; U7[i] = libsais_bswap16(c7);
+        if ((B[i >> 3] >> (i & 7)) & 1)
+        {
+            LCP[c++] = libsais_compute_lcp_sample(T, PLCP, SA, n, r, i);
+        }
     }
 
-    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4; *i5 = p5; *i6 = p6; *i7 = p7;
+    return c;
 }
 
-static void libsais_unbwt_decode(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_sint_t blocks, fast_uint_t remainder)
+static sa_sint_t libsais_compute_lcp_marked_omp(const uint8_t * RESTRICT T, const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, const uint8_t * RESTRICT B, sa_sint_t * RESTRICT LCP, sa_sint_t n, sa_sint_t r, sa_sint_t threads)
 {
-    fast_uint_t shift       = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
-    fast_uint_t offset      = 0;
+    fast_sint_t count = 0;
 
-    while (blocks > 8)
-    {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5], i6 = I[6], i7 = I[7];
-        libsais_unbwt_decode_8(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, &i7, (fast_uint_t)r >> 1);
-        I += 8; blocks -= 8; offset += 8 * (fast_uint_t)r;
-    }
+#if defined(LIBSAIS_OPENMP)
+    fast_sint_t * RESTRICT counts = threads > 1 && n >= 65536 ? (fast_sint_t *)libsais_alloc_aligned((size_t)threads * sizeof(fast_sint_t), 64) : NULL;
+    if (threads > 1 && n >= 65536 && counts == NULL) { return -2; }
 
-    if (blocks == 1)
-    {
-        fast_uint_t i0 = I[0];
-        libsais_unbwt_decode_1(U + offset, P, bucket2, fastbits, shift, &i0, remainder >> 1);
-    }
-    else if (blocks == 2)
-    {
-        fast_uint_t i0 = I[0], i1 = I[1];
-        libsais_unbwt_decode_2(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, remainder >> 1);
-        libsais_unbwt_decode_1(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, &i0, ((fast_uint_t)r >> 1) - (remainder >> 1));
-    }
-    else if (blocks == 3)
-    {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2];
-        libsais_unbwt_decode_3(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, remainder >> 1);
-        libsais_unbwt_decode_2(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, ((fast_uint_t)r >> 1) - (remainder >> 1));
-    }
-    else if (blocks == 4)
-    {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3];
-        libsais_unbwt_decode_4(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, remainder >> 1);
-        libsais_unbwt_decode_3(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, ((fast_uint_t)r >> 1) - (remainder >> 1));
-    }
-    else if (blocks == 5)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
     {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4];
-        libsais_unbwt_decode_5(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, remainder >> 1);
-        libsais_unbwt_decode_4(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, ((fast_uint_t)r >> 1) - (remainder >> 1));
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        if (omp_num_threads == 1)
+        {
+            count = libsais_compute_lcp_marked(T, PLCP, SA, B, LCP, n, r, 0, omp_block_start, omp_block_size);
+        }
+#if defined(LIBSAIS_OPENMP)
+        else
+        {
+            counts[omp_thread_num] = libsais_count_marked(B, omp_block_start, omp_block_size);
+
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                fast_sint_t t, c = 0; for (t = 0; t < omp_num_threads; ++t) { fast_sint_t m = counts[t]; counts[t] = c; c += m; }
+
+                count = c;
+            }
+
+            #pragma omp barrier
+
+            libsais_compute_lcp_marked(T, PLCP, SA, B, LCP, n, r, counts[omp_thread_num], omp_block_start, omp_block_size);
+        }
+#endif
     }
-    else if (blocks == 6)
+
+#if defined(LIBSAIS_OPENMP)
+    libsais_free_aligned(counts);
+#endif
+
+    return (sa_sint_t)count;
+}
+
+static fast_sint_t libsais_compute_lcp_8u(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, uint8_t * RESTRICT LCP, sa_sint_t * RESTRICT X, fast_sint_t xs, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j, c = 0;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
     {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5];
-        libsais_unbwt_decode_6(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, remainder >> 1);
-        libsais_unbwt_decode_5(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, ((fast_uint_t)r >> 1) - (remainder >> 1));
+        libsais_prefetchr(&SA[i + 2 * prefetch_distance]);
+        libsais_prefetchr(&PLCP[SA[i + prefetch_distance]]);
+
+        sa_sint_t l = PLCP[SA[i]];
+        if (l < UINT8_MAX) { LCP[i] = (uint8_t)l; } else { LCP[i] = UINT8_MAX; if (c < xs) { X[2 * c + 0] = (sa_sint_t)i; X[2 * c + 1] = l; } c++; }
     }
-    else if (blocks == 7)
+
+    for (j += prefetch_distance; i < j; i += 1)
     {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5], i6 = I[6];
-        libsais_unbwt_decode_7(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, remainder >> 1);
-        libsais_unbwt_decode_6(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, ((fast_uint_t)r >> 1) - (remainder >> 1));
+        sa_sint_t l = PLCP[SA[i]];
+        if (l < UINT8_MAX) { LCP[i] = (uint8_t)l; } else { LCP[i] = UINT8_MAX; if (c < xs) { X[2 * c + 0] = (sa_sint_t)i; X[2 * c + 1] = l; } c++; }
     }
-    else
+
+    return c;
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+static void libsais_gather_lcp_8u_exceptions(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, const uint8_t * RESTRICT LCP, sa_sint_t * RESTRICT X, fast_sint_t xs, fast_sint_t c, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size; i < j && c < xs; i += 1)
     {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5], i6 = I[6], i7 = I[7];
-        libsais_unbwt_decode_8(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, &i7, remainder >> 1);
-        libsais_unbwt_decode_7(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, ((fast_uint_t)r >> 1) - (remainder >> 1));
+        if (LCP[i] == UINT8_MAX) { X[2 * c + 0] = (sa_sint_t)i; X[2 * c + 1] = PLCP[SA[i]]; c++; }
     }
 }
 
-static void libsais_unbwt_decode_omp(const uint8_t * RESTRICT T, uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, sa_sint_t threads)
+#endif
+
+static sa_sint_t libsais_compute_lcp_8u_omp(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, uint8_t * RESTRICT LCP, sa_sint_t n, sa_sint_t * RESTRICT X, sa_sint_t xs, sa_sint_t threads)
 {
-    fast_uint_t lastc       = T[0];
-    fast_sint_t blocks      = 1 + (((fast_sint_t)n - 1) / (fast_sint_t)r);
-    fast_uint_t remainder   = (fast_uint_t)n - ((fast_uint_t)r * ((fast_uint_t)blocks - 1));
+    fast_sint_t count = 0;
 
 #if defined(LIBSAIS_OPENMP)
-    fast_sint_t max_threads = blocks < threads ? blocks : threads;
-    #pragma omp parallel num_threads(max_threads) if(max_threads > 1 && n >= 65536)
+    fast_sint_t * RESTRICT counts = threads > 1 && n >= 65536 ? (fast_sint_t *)libsais_alloc_aligned((size_t)threads * sizeof(fast_sint_t), 64) : NULL;
+    if (threads > 1 && n >= 65536 && counts == NULL) { return -2; }
+
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
 #endif
     {
 #if defined(LIBSAIS_OPENMP)
-        fast_sint_t omp_thread_num      = omp_get_thread_num();
-        fast_sint_t omp_num_threads     = omp_get_num_threads();
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
 #else
         UNUSED(threads);
 
-        fast_sint_t omp_thread_num      = 0;
-        fast_sint_t omp_num_threads     = 1;
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
 #endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        if (omp_num_threads == 1)
+        {
+            count = libsais_compute_lcp_8u(PLCP, SA, LCP, X, xs, omp_block_start, omp_block_size);
+        }
+#if defined(LIBSAIS_OPENMP)
+        else
+        {
+            counts[omp_thread_num] = libsais_compute_lcp_8u(PLCP, SA, LCP, X, 0, omp_block_start, omp_block_size);
 
-        fast_sint_t omp_block_stride    = blocks / omp_num_threads;
-        fast_sint_t omp_block_remainder = blocks % omp_num_threads;
-        fast_sint_t omp_block_size      = omp_block_stride + (omp_thread_num < omp_block_remainder);
-        fast_sint_t omp_block_start     = omp_block_stride * omp_thread_num + (omp_thread_num < omp_block_remainder ? omp_thread_num : omp_block_remainder);
+            #pragma omp barrier
+
+            fast_sint_t t, c = 0; for (t = 0; t < omp_thread_num; ++t) { c += counts[t]; }
 
-        libsais_unbwt_decode(U + r * omp_block_start, P, n, r, I + omp_block_start, bucket2, fastbits, omp_block_size, omp_thread_num < omp_num_threads - 1 ? (fast_uint_t)r : remainder);
+            libsais_gather_lcp_8u_exceptions(PLCP, SA, LCP, X, xs, c, omp_block_start, omp_block_size);
+
+            if (omp_thread_num == omp_num_threads - 1) { count = c + counts[omp_thread_num]; }
+        }
+#endif
     }
 
-    U[n - 1] = (uint8_t)lastc;
+#if defined(LIBSAIS_OPENMP)
+    libsais_free_aligned(counts);
+#endif
+
+    return (sa_sint_t)count;
 }
 
-static sa_sint_t libsais_unbwt_core(const uint8_t * RESTRICT T, uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, sa_uint_t * RESTRICT buckets, sa_sint_t threads)
+static void libsais_compute_lz77_psv_nsv(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PSV, sa_sint_t * RESTRICT NSV, fast_sint_t n)
 {
-#if defined(LIBSAIS_OPENMP)
-    if (threads > 1 && n >= 262144)
-    {
-        libsais_unbwt_init_parallel(T, P, n, freq, I, bucket2, fastbits, buckets, threads);
-    }
-    else
-#else
-    UNUSED(buckets);
-#endif
+    fast_sint_t i, top = -1;
+    for (i = 0; i <= n; i += 1)
     {
-        libsais_unbwt_init_single(T, P, n, freq, I, bucket2, fastbits);
-    }
+        sa_sint_t p = i < n ? SA[i] : -1;
+        while (top >= 0 && SA[top] > p)
+        {
+            sa_sint_t q = SA[top]; NSV[q] = p; PSV[q] = top > 0 ? SA[top - 1] : -1; top -= 1;
+        }
 
-    libsais_unbwt_decode_omp(T, U, P, n, r, I, bucket2, fastbits, threads);
-    return 0;
+        if (i < n) { SA[++top] = p; }
+    }
 }
 
-static sa_sint_t libsais_unbwt_main(const uint8_t * T, uint8_t * U, sa_uint_t * P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * I, sa_sint_t threads)
+static sa_sint_t libsais_compute_lz77(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT P, sa_sint_t * RESTRICT L, fast_sint_t n)
 {
-    fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+    fast_sint_t i = 0, z = 0;
+    while (i < n)
+    {
+        fast_sint_t psv = P[i], nsv = L[i], lp = 0, ln = 0;
 
-    sa_uint_t *     RESTRICT bucket2        = (sa_uint_t *)libsais_alloc_aligned(ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_uint_t), 4096);
-    uint16_t *      RESTRICT fastbits       = (uint16_t *)libsais_alloc_aligned(((size_t)1 + (size_t)(n >> shift)) * sizeof(uint16_t), 4096);
-    sa_uint_t *     RESTRICT buckets        = threads > 1 && n >= 262144 ? (sa_uint_t *)libsais_alloc_aligned((size_t)threads * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE)) * sizeof(sa_uint_t), 4096) : NULL;
+        if (psv >= 0) { while (i + lp < n && T[psv + lp] == T[i + lp]) { lp += 1; } }
+        if (nsv >= 0) { while (i + ln < n && T[nsv + ln] == T[i + ln]) { ln += 1; } }
 
-    sa_sint_t index = bucket2 != NULL && fastbits != NULL && (buckets != NULL || threads == 1 || n < 262144)
-        ? libsais_unbwt_core(T, U, P, n, freq, r, I, bucket2, fastbits, buckets, threads)
-        : -2;
+        if (lp == 0 && ln == 0) { P[z] = (sa_sint_t)T[i]; L[z] = 0; i += 1; }
+        else if (lp >= ln)      { P[z] = (sa_sint_t)psv; L[z] = (sa_sint_t)lp; i += lp; }
+        else                    { P[z] = (sa_sint_t)nsv; L[z] = (sa_sint_t)ln; i += ln; }
 
-    libsais_free_aligned(buckets);
-    libsais_free_aligned(fastbits);
-    libsais_free_aligned(bucket2);
+        z += 1;
+    }
 
-    return index;
+    return (sa_sint_t)z;
 }
 
-static sa_sint_t libsais_unbwt_main_ctx(const LIBSAIS_UNBWT_CONTEXT * ctx, const uint8_t * T, uint8_t * U, sa_uint_t * P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * I)
+static sa_sint_t libsais_lz77_main(const uint8_t * T, sa_sint_t * P, sa_sint_t * L, sa_sint_t * A, sa_sint_t n, sa_sint_t fs, sa_sint_t * freq, sa_sint_t threads)
 {
-    return ctx != NULL && ctx->bucket2 != NULL && ctx->fastbits != NULL && (ctx->buckets != NULL || ctx->threads == 1)
-        ? libsais_unbwt_core(T, U, P, n, freq, r, I, ctx->bucket2, ctx->fastbits, ctx->buckets, (sa_sint_t)ctx->threads)
-        : -2;
-}
+    sa_sint_t index = libsais_main(T, A, n, 0, 0, NULL, NULL, fs, freq, threads);
+    if (index == 0)
+    {
+        libsais_compute_lz77_psv_nsv(A, P, L, n);
+        index = libsais_compute_lz77(T, P, L, n);
+    }
 
-void * libsais_unbwt_create_ctx(void)
-{
-    return (void *)libsais_unbwt_create_ctx_main(1);
+    return index;
 }
 
-void libsais_unbwt_free_ctx(void * ctx)
+static void libsais_compute_lyndon(const sa_sint_t * RESTRICT ISA, sa_sint_t * RESTRICT LA, fast_sint_t n)
 {
-    libsais_unbwt_free_ctx_main((LIBSAIS_UNBWT_CONTEXT *)ctx);
-}
+    fast_sint_t i;
+    for (i = n - 1; i >= 0; i -= 1)
+    {
+        fast_sint_t j = i + 1; sa_sint_t r = ISA[i];
+        while (j < n && ISA[j] > r) { j += LA[j]; }
 
-int32_t libsais_unbwt(const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t i)
-{
-    return libsais_unbwt_aux(T, U, A, n, freq, n, &i);
+        LA[i] = (sa_sint_t)(j - i);
+    }
 }
 
-int32_t libsais_unbwt_ctx(const void * ctx, const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t i)
+static sa_sint_t libsais_lyndon_main(const uint8_t * T, sa_sint_t * L, sa_sint_t * A, sa_sint_t n, sa_sint_t fs, sa_sint_t * freq, sa_sint_t threads)
 {
-    return libsais_unbwt_aux_ctx(ctx, T, U, A, n, freq, n, &i);
+    sa_sint_t index = libsais_main(T, A, n, 0, 0, NULL, NULL, fs, freq, threads);
+    if (index == 0)
+    {
+        libsais_compute_isa_omp(A, L, n, threads);
+        libsais_compute_lyndon(L, A, n);
+
+        memcpy(L, A, (size_t)n * sizeof(sa_sint_t));
+    }
+
+    return index;
 }
 
-int32_t libsais_unbwt_aux(const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t r, const int32_t * I)
+int32_t libsais_plcp(const uint8_t * T, const int32_t * SA, int32_t * PLCP, int32_t n)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL))
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0))
     {
         return -1;
     }
     else if (n <= 1)
     {
-        if (I[0] != n) { return -1; }
-        if (n == 1) { U[0] = T[0]; }
+        if (n == 1) { PLCP[0] = 0; }
         return 0;
     }
 
-    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+    libsais_compute_phi_omp(SA, PLCP, n, 1);
+    libsais_compute_plcp_omp(T, PLCP, n, 1);
 
-    return libsais_unbwt_main(T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, 1);
+    return 0;
 }
 
-int32_t libsais_unbwt_aux_ctx(const void * ctx, const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t r, const int32_t * I)
+int32_t libsais_plcp_int(const int32_t * T, const int32_t * SA, int32_t * PLCP, int32_t n)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL))
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0))
     {
         return -1;
     }
     else if (n <= 1)
     {
-        if (I[0] != n) { return -1; }
-        if (n == 1) { U[0] = T[0]; }
+        if (n == 1) { PLCP[0] = 0; }
         return 0;
     }
 
-    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+    libsais_compute_phi_omp(SA, PLCP, n, 1);
+    libsais_compute_plcp_int_omp(T, PLCP, n, 1);
 
-    return libsais_unbwt_main_ctx((const LIBSAIS_UNBWT_CONTEXT *)ctx, T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I);
+    return 0;
 }
 
-#if defined(LIBSAIS_OPENMP)
-
-void * libsais_unbwt_create_ctx_omp(int32_t threads)
+int32_t libsais_plcp_gsa(const uint8_t * T, const int32_t * SA, int32_t * PLCP, int32_t n)
 {
-    if (threads < 0) { return NULL; }
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { PLCP[0] = 0; }
+        return 0;
+    }
 
-    threads = threads > 0 ? threads : omp_get_max_threads();
-    return (void *)libsais_unbwt_create_ctx_main(threads);
-}
+    libsais_compute_phi_omp(SA, PLCP, n, 1);
+    libsais_compute_plcp_gsa_omp(T, PLCP, n, 1);
 
-int32_t libsais_unbwt_omp(const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t i, int32_t threads)
-{
-    return libsais_unbwt_aux_omp(T, U, A, n, freq, n, &i, threads);
+    return 0;
 }
 
-int32_t libsais_unbwt_aux_omp(const uint8_t * T, uint8_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t r, const int32_t * I, int32_t threads)
+int32_t libsais_lcp(const int32_t * PLCP, const int32_t * SA, int32_t * LCP, int32_t n)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (threads < 0))
+    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0))
     {
         return -1;
     }
     else if (n <= 1)
     {
-        if (I[0] != n) { return -1; }
-        if (n == 1) { U[0] = T[0]; }
+        if (n == 1) { LCP[0] = PLCP[SA[0]]; }
         return 0;
     }
 
-    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+    libsais_compute_lcp_omp(PLCP, SA, LCP, n, 1);
 
-    threads = threads > 0 ? threads : omp_get_max_threads();
-    return libsais_unbwt_main(T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, threads);
+    return 0;
 }
 
-#endif
-
-static void libsais_compute_phi(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+int32_t libsais_plcp_sampled(const uint8_t * T, const int32_t * SA, int32_t * PLCP, int32_t n, int32_t r)
 {
-    const fast_sint_t prefetch_distance = 32;
-
-    fast_sint_t i, j; sa_sint_t k = omp_block_start > 0 ? SA[omp_block_start - 1] : n;
-    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (r <= 0) || ((r & (r - 1)) != 0))
     {
-        libsais_prefetchr(&SA[i + 2 * prefetch_distance]);
-
-        libsais_prefetchw(&PLCP[SA[i + prefetch_distance + 0]]);
-        libsais_prefetchw(&PLCP[SA[i + prefetch_distance + 1]]);
-
-        PLCP[SA[i + 0]] = k; k = SA[i + 0];
-        PLCP[SA[i + 1]] = k; k = SA[i + 1];
-
-        libsais_prefetchw(&PLCP[SA[i + prefetch_distance + 2]]);
-        libsais_prefetchw(&PLCP[SA[i + prefetch_distance + 3]]);
-
-        PLCP[SA[i + 2]] = k; k = SA[i + 2];
-        PLCP[SA[i + 3]] = k; k = SA[i + 3];
+        return -1;
     }
-
-    for (j += prefetch_distance + 3; i < j; i += 1)
+    else if (n <= 1)
     {
-        PLCP[SA[i]] = k; k = SA[i];
+        if (n == 1) { PLCP[0] = 0; }
+        return 0;
     }
+
+    libsais_compute_phi_sampled_omp(SA, PLCP, n, r, 1);
+    libsais_compute_plcp_sampled_omp(T, PLCP, n, r, 1);
+
+    return 0;
 }
 
-static void libsais_compute_phi_omp(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+int32_t libsais_lcp_sampled(const uint8_t * T, const int32_t * PLCP, const int32_t * SA, int32_t * LCP, int32_t n, int32_t r, int32_t k)
 {
-#if defined(LIBSAIS_OPENMP)
-    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
-#endif
+    if ((T == NULL) || (PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (r <= 0) || ((r & (r - 1)) != 0) || (k <= 0))
     {
-#if defined(LIBSAIS_OPENMP)
-        fast_sint_t omp_thread_num    = omp_get_thread_num();
-        fast_sint_t omp_num_threads   = omp_get_num_threads();
-#else
-        UNUSED(threads);
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { LCP[0] = 0; }
+        return 0;
+    }
 
-        fast_sint_t omp_thread_num    = 0;
-        fast_sint_t omp_num_threads   = 1;
-#endif
-        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
-        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
-        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+    libsais_compute_lcp_sampled_omp(T, PLCP, SA, LCP, n, r, k, 1);
 
-        libsais_compute_phi(SA, PLCP, n, omp_block_start, omp_block_size);
-    }
+    return 0;
 }
 
-static void libsais_compute_plcp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, fast_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+int32_t libsais_lcp_marked(const uint8_t * T, const int32_t * PLCP, const int32_t * SA, const uint8_t * B, int32_t * LCP, int32_t n, int32_t r)
 {
-    const fast_sint_t prefetch_distance = 32;
-
-    fast_sint_t i, j, l = 0;
-    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    if ((T == NULL) || (PLCP == NULL) || (SA == NULL) || (B == NULL) || (LCP == NULL) || (n < 0) || (r <= 0) || ((r & (r - 1)) != 0))
     {
-        libsais_prefetchw(&PLCP[i + 2 * prefetch_distance]);
-        libsais_prefetchr(&T[PLCP[i + prefetch_distance] + l]);
-
-        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
-        while (l < m && T[i + l] == T[k + l]) { l++; }
-
-        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+        return -1;
     }
-
-    for (j += prefetch_distance; i < j; i += 1)
+    else if (n <= 1)
     {
-        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
-        while (l < m && T[i + l] == T[k + l]) { l++; }
+        if (n == 1 && (B[0] & 1)) { LCP[0] = 0; return 1; }
+        return 0;
+    }
 
-        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+    return libsais_compute_lcp_marked_omp(T, PLCP, SA, B, LCP, n, r, 1);
+}
+
+int32_t libsais_lcp_8u(const int32_t * PLCP, const int32_t * SA, uint8_t * LCP, int32_t n, int32_t * X, int32_t xs)
+{
+    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (xs < 0) || (X == NULL && xs > 0))
+    {
+        return -1;
     }
+
+    return libsais_compute_lcp_8u_omp(PLCP, SA, LCP, n, X, xs, 1);
 }
 
-static void libsais_compute_plcp_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+int32_t libsais_isa(const int32_t * SA, int32_t * ISA, int32_t n)
 {
-#if defined(LIBSAIS_OPENMP)
-    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
-#endif
+    if ((SA == NULL) || (ISA == NULL) || (n < 0))
     {
-#if defined(LIBSAIS_OPENMP)
-        fast_sint_t omp_thread_num    = omp_get_thread_num();
-        fast_sint_t omp_num_threads   = omp_get_num_threads();
-#else
-        UNUSED(threads);
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { ISA[0] = 0; }
+        return 0;
+    }
 
-        fast_sint_t omp_thread_num    = 0;
-        fast_sint_t omp_num_threads   = 1;
-#endif
-        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
-        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
-        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+    libsais_compute_isa_omp(SA, ISA, n, 1);
 
-        libsais_compute_plcp(T, PLCP, n, omp_block_start, omp_block_size);
-    }
+    return 0;
 }
 
-static void libsais_compute_plcp_int(const int32_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, fast_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+int32_t libsais_sa_lcp(const uint8_t * T, int32_t * SA, int32_t * LCP, int32_t n, int32_t fs, int32_t * freq)
 {
-    const fast_sint_t prefetch_distance = 32;
-
-    fast_sint_t i, j, l = 0;
-    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    if ((T == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (fs < 0))
     {
-        libsais_prefetchw(&PLCP[i + 2 * prefetch_distance]);
-        libsais_prefetchr(&T[PLCP[i + prefetch_distance] + l]);
-
-        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
-        while (l < m && T[i + l] == T[k + l]) { l++; }
-
-        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+        return -1;
     }
-
-    for (j += prefetch_distance; i < j; i += 1)
+    else if (n < 2)
     {
-        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
-        while (l < m && T[i + l] == T[k + l]) { l++; }
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { SA[0] = 0; LCP[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
 
-        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+    sa_sint_t index = libsais_main(T, SA, n, 0, 0, NULL, NULL, fs, freq, 1);
+    if (index == 0)
+    {
+        libsais_compute_sa_lcp_omp(T, SA, LCP, n, fs, 1);
     }
+
+    return index;
 }
 
-static void libsais_compute_plcp_int_omp(const int32_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+int32_t libsais_sa_lcp_ctx(const void * ctx, const uint8_t * T, int32_t * SA, int32_t * LCP, int32_t n, int32_t fs, int32_t * freq)
 {
-#if defined(LIBSAIS_OPENMP)
-    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
-#endif
+    if ((ctx == NULL) || (T == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (fs < 0))
     {
-#if defined(LIBSAIS_OPENMP)
-        fast_sint_t omp_thread_num    = omp_get_thread_num();
-        fast_sint_t omp_num_threads   = omp_get_num_threads();
-#else
-        UNUSED(threads);
-
-        fast_sint_t omp_thread_num    = 0;
-        fast_sint_t omp_num_threads   = 1;
-#endif
-        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
-        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
-        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { SA[0] = 0; LCP[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
 
-        libsais_compute_plcp_int(T, PLCP, n, omp_block_start, omp_block_size);
+    sa_sint_t index = libsais_main_ctx((const LIBSAIS_CONTEXT *)ctx, T, SA, n, 0, 0, NULL, NULL, fs, freq);
+    if (index == 0)
+    {
+        libsais_compute_sa_lcp_omp(T, SA, LCP, n, fs, (sa_sint_t)((const LIBSAIS_CONTEXT *)ctx)->threads);
     }
+
+    return index;
 }
 
-static void libsais_compute_lcp(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+int32_t libsais_lz77_factorize(const uint8_t * T, int32_t * P, int32_t * L, int32_t * A, int32_t n, int32_t fs, int32_t * freq)
 {
-    const fast_sint_t prefetch_distance = 32;
-
-    fast_sint_t i, j;
-    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
+    if ((T == NULL) || (P == NULL) || (L == NULL) || (A == NULL) || (n < 0) || (fs < 0))
     {
-        libsais_prefetchr(&SA[i + 2 * prefetch_distance]);
-        libsais_prefetchw(&LCP[i + prefetch_distance]);
-
-        libsais_prefetchr(&PLCP[SA[i + prefetch_distance + 0]]);
-        libsais_prefetchr(&PLCP[SA[i + prefetch_distance + 1]]);
-
-        LCP[i + 0] = PLCP[SA[i + 0]];
-        LCP[i + 1] = PLCP[SA[i + 1]];
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { P[0] = T[0]; L[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return n;
+    }
 
-        libsais_prefetchr(&PLCP[SA[i + prefetch_distance + 2]]);
-        libsais_prefetchr(&PLCP[SA[i + prefetch_distance + 3]]);
+    return libsais_lz77_main(T, P, L, A, n, fs, freq, 1);
+}
 
-        LCP[i + 2] = PLCP[SA[i + 2]];
-        LCP[i + 3] = PLCP[SA[i + 3]];
+int32_t libsais_lyndon_array(const uint8_t * T, int32_t * L, int32_t * A, int32_t n, int32_t fs, int32_t * freq)
+{
+    if ((T == NULL) || (L == NULL) || (A == NULL) || (n < 0) || (fs < 0))
+    {
+        return -1;
     }
-
-    for (j += prefetch_distance + 3; i < j; i += 1)
+    else if (n < 2)
     {
-        LCP[i] = PLCP[SA[i]];
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { L[0] = 1; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
     }
+
+    return libsais_lyndon_main(T, L, A, n, fs, freq, 1);
 }
 
-static void libsais_compute_lcp_omp(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, sa_sint_t n, sa_sint_t threads)
-{
 #if defined(LIBSAIS_OPENMP)
-    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
-#endif
+
+int32_t libsais_plcp_omp(const uint8_t * T, const int32_t * SA, int32_t * PLCP, int32_t n, int32_t threads)
+{
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (threads < 0))
     {
-#if defined(LIBSAIS_OPENMP)
-        fast_sint_t omp_thread_num    = omp_get_thread_num();
-        fast_sint_t omp_num_threads   = omp_get_num_threads();
-#else
-        UNUSED(threads);
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { PLCP[0] = 0; }
+        return 0;
+    }
+    
+    threads = threads > 0 ? threads : omp_get_max_threads();
 
-        fast_sint_t omp_thread_num    = 0;
-        fast_sint_t omp_num_threads   = 1;
-#endif
-        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
-        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
-        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+    libsais_compute_phi_omp(SA, PLCP, n, threads);
+    libsais_compute_plcp_omp(T, PLCP, n, threads);
 
-        libsais_compute_lcp(PLCP, SA, LCP, omp_block_start, omp_block_size);
-    }
+    return 0;
 }
 
-int32_t libsais_plcp(const uint8_t * T, const int32_t * SA, int32_t * PLCP, int32_t n)
+int32_t libsais_plcp_int_omp(const int32_t * T, const int32_t * SA, int32_t * PLCP, int32_t n, int32_t threads)
 {
-    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0))
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (threads < 0))
     {
         return -1;
     }
@@ -7877,16 +12470,18 @@ int32_t libsais_plcp(const uint8_t * T, const int32_t * SA, int32_t * PLCP, int3
         if (n == 1) { PLCP[0] = 0; }
         return 0;
     }
+    
+    threads = threads > 0 ? threads : omp_get_max_threads();
 
-    libsais_compute_phi_omp(SA, PLCP, n, 1);
-    libsais_compute_plcp_omp(T, PLCP, n, 1);
+    libsais_compute_phi_omp(SA, PLCP, n, threads);
+    libsais_compute_plcp_int_omp(T, PLCP, n, threads);
 
     return 0;
 }
 
-int32_t libsais_plcp_int(const int32_t * T, const int32_t * SA, int32_t * PLCP, int32_t n)
+int32_t libsais_plcp_gsa_omp(const uint8_t * T, const int32_t * SA, int32_t * PLCP, int32_t n, int32_t threads)
 {
-    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0))
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (threads < 0))
     {
         return -1;
     }
@@ -7895,16 +12490,18 @@ int32_t libsais_plcp_int(const int32_t * T, const int32_t * SA, int32_t * PLCP,
         if (n == 1) { PLCP[0] = 0; }
         return 0;
     }
+    
+    threads = threads > 0 ? threads : omp_get_max_threads();
 
-    libsais_compute_phi_omp(SA, PLCP, n, 1);
-    libsais_compute_plcp_int_omp(T, PLCP, n, 1);
+    libsais_compute_phi_omp(SA, PLCP, n, threads);
+    libsais_compute_plcp_gsa_omp(T, PLCP, n, threads);
 
     return 0;
 }
 
-int32_t libsais_lcp(const int32_t * PLCP, const int32_t * SA, int32_t * LCP, int32_t n)
+int32_t libsais_lcp_omp(const int32_t * PLCP, const int32_t * SA, int32_t * LCP, int32_t n, int32_t threads)
 {
-    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0))
+    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (threads < 0))
     {
         return -1;
     }
@@ -7914,16 +12511,16 @@ int32_t libsais_lcp(const int32_t * PLCP, const int32_t * SA, int32_t * LCP, int
         return 0;
     }
 
-    libsais_compute_lcp_omp(PLCP, SA, LCP, n, 1);
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    libsais_compute_lcp_omp(PLCP, SA, LCP, n, threads);
 
     return 0;
 }
 
-#if defined(LIBSAIS_OPENMP)
-
-int32_t libsais_plcp_omp(const uint8_t * T, const int32_t * SA, int32_t * PLCP, int32_t n, int32_t threads)
+int32_t libsais_plcp_sampled_omp(const uint8_t * T, const int32_t * SA, int32_t * PLCP, int32_t n, int32_t r, int32_t threads)
 {
-    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (threads < 0))
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (r <= 0) || ((r & (r - 1)) != 0) || (threads < 0))
     {
         return -1;
     }
@@ -7932,52 +12529,140 @@ int32_t libsais_plcp_omp(const uint8_t * T, const int32_t * SA, int32_t * PLCP,
         if (n == 1) { PLCP[0] = 0; }
         return 0;
     }
-    
+
     threads = threads > 0 ? threads : omp_get_max_threads();
 
-    libsais_compute_phi_omp(SA, PLCP, n, threads);
-    libsais_compute_plcp_omp(T, PLCP, n, threads);
+    libsais_compute_phi_sampled_omp(SA, PLCP, n, r, threads);
+    libsais_compute_plcp_sampled_omp(T, PLCP, n, r, threads);
 
     return 0;
 }
 
-int32_t libsais_plcp_int_omp(const int32_t * T, const int32_t * SA, int32_t * PLCP, int32_t n, int32_t threads)
+int32_t libsais_lcp_sampled_omp(const uint8_t * T, const int32_t * PLCP, const int32_t * SA, int32_t * LCP, int32_t n, int32_t r, int32_t k, int32_t threads)
 {
-    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (threads < 0))
+    if ((T == NULL) || (PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (r <= 0) || ((r & (r - 1)) != 0) || (k <= 0) || (threads < 0))
     {
         return -1;
     }
     else if (n <= 1)
     {
-        if (n == 1) { PLCP[0] = 0; }
+        if (n == 1) { LCP[0] = 0; }
         return 0;
     }
-    
+
     threads = threads > 0 ? threads : omp_get_max_threads();
 
-    libsais_compute_phi_omp(SA, PLCP, n, threads);
-    libsais_compute_plcp_int_omp(T, PLCP, n, threads);
+    libsais_compute_lcp_sampled_omp(T, PLCP, SA, LCP, n, r, k, threads);
 
     return 0;
 }
 
-int32_t libsais_lcp_omp(const int32_t * PLCP, const int32_t * SA, int32_t * LCP, int32_t n, int32_t threads)
+int32_t libsais_lcp_marked_omp(const uint8_t * T, const int32_t * PLCP, const int32_t * SA, const uint8_t * B, int32_t * LCP, int32_t n, int32_t r, int32_t threads)
 {
-    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (threads < 0))
+    if ((T == NULL) || (PLCP == NULL) || (SA == NULL) || (B == NULL) || (LCP == NULL) || (n < 0) || (r <= 0) || ((r & (r - 1)) != 0) || (threads < 0))
     {
         return -1;
     }
     else if (n <= 1)
     {
-        if (n == 1) { LCP[0] = PLCP[SA[0]]; }
+        if (n == 1 && (B[0] & 1)) { LCP[0] = 0; return 1; }
         return 0;
     }
 
     threads = threads > 0 ? threads : omp_get_max_threads();
 
-    libsais_compute_lcp_omp(PLCP, SA, LCP, n, threads);
+    return libsais_compute_lcp_marked_omp(T, PLCP, SA, B, LCP, n, r, threads);
+}
+
+int32_t libsais_lcp_8u_omp(const int32_t * PLCP, const int32_t * SA, uint8_t * LCP, int32_t n, int32_t * X, int32_t xs, int32_t threads)
+{
+    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (xs < 0) || (X == NULL && xs > 0) || (threads < 0))
+    {
+        return -1;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais_compute_lcp_8u_omp(PLCP, SA, LCP, n, X, xs, threads);
+}
+
+int32_t libsais_isa_omp(const int32_t * SA, int32_t * ISA, int32_t n, int32_t threads)
+{
+    if ((SA == NULL) || (ISA == NULL) || (n < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { ISA[0] = 0; }
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    libsais_compute_isa_omp(SA, ISA, n, threads);
 
     return 0;
 }
 
+int32_t libsais_sa_lcp_omp(const uint8_t * T, int32_t * SA, int32_t * LCP, int32_t n, int32_t fs, int32_t * freq, int32_t threads)
+{
+    if ((T == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (fs < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { SA[0] = 0; LCP[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    sa_sint_t index = libsais_main(T, SA, n, 0, 0, NULL, NULL, fs, freq, threads);
+    if (index == 0)
+    {
+        libsais_compute_sa_lcp_omp(T, SA, LCP, n, fs, threads);
+    }
+
+    return index;
+}
+
+int32_t libsais_lz77_factorize_omp(const uint8_t * T, int32_t * P, int32_t * L, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t threads)
+{
+    if ((T == NULL) || (P == NULL) || (L == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { P[0] = T[0]; L[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return n;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais_lz77_main(T, P, L, A, n, fs, freq, threads);
+}
+
+int32_t libsais_lyndon_array_omp(const uint8_t * T, int32_t * L, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t threads)
+{
+    if ((T == NULL) || (L == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { L[0] = 1; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais_lyndon_main(T, L, A, n, fs, freq, threads);
+}
+
 #endif
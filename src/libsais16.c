@@ -45,7 +45,21 @@ typedef size_t                          fast_uint_t;
 #define SAINT_MIN                       INT32_MIN
 
 #define ALPHABET_SIZE                   (1 << CHAR_BIT << CHAR_BIT)
-#define UNBWT_FASTBITS                  (17)
+
+#if !defined(UNBWT_FASTBITS)
+    #define UNBWT_FASTBITS                 (17)
+#endif
+
+#define UNBWT_FASTBITS_MIN             (8)
+#define UNBWT_FASTBITS_MAX             (24)
+
+#if !defined(UNBWT_SPLITTERS_MIN_THREADS)
+    #define UNBWT_SPLITTERS_MIN_THREADS    (4)
+#endif
+
+#if !defined(UNBWT_SPLITTERS_MIN_SIZE)
+    #define UNBWT_SPLITTERS_MIN_SIZE       (1 << 21)
+#endif
 
 #define SUFFIX_GROUP_BIT                (SAINT_BIT - 1)
 #define SUFFIX_GROUP_MARKER             (((sa_sint_t)1) << (SUFFIX_GROUP_BIT - 1))
@@ -53,8 +67,21 @@ typedef size_t                          fast_uint_t;
 #define BUCKETS_INDEX2(_c, _s)          (((_c) << 1) + (_s))
 #define BUCKETS_INDEX4(_c, _s)          (((_c) << 2) + (_s))
 
-#define LIBSAIS_LOCAL_BUFFER_SIZE       (1024)
-#define LIBSAIS_PER_THREAD_CACHE_SIZE   (2097184)
+#if !defined(LIBSAIS_LOCAL_BUFFER_SIZE)
+    #define LIBSAIS_LOCAL_BUFFER_SIZE      (1024)
+#endif
+
+#if !defined(LIBSAIS_PER_THREAD_CACHE_SIZE)
+    #define LIBSAIS_PER_THREAD_CACHE_SIZE  (2097184)
+#endif
+
+#if !defined(LIBSAIS_NUMA_PAGE_SIZE)
+    #define LIBSAIS_NUMA_PAGE_SIZE         (4096)
+#endif
+
+#if !defined(LIBSAIS_PREFETCH_DISTANCE)
+    #define LIBSAIS_PREFETCH_DISTANCE      (32)
+#endif
 
 typedef struct LIBSAIS_THREAD_CACHE
 {
@@ -74,16 +101,48 @@ typedef union LIBSAIS_THREAD_STATE
 
         sa_sint_t *                     buckets;
         LIBSAIS_THREAD_CACHE *          cache;
+        fast_sint_t                     cache_size;
+        struct LIBSAIS_MONITOR *        monitor;
     } state;
 
     uint8_t padding[64];
 } LIBSAIS_THREAD_STATE;
 
+typedef struct LIBSAIS_ALLOCATOR
+{
+    void *                              (* alloc)(size_t size, size_t alignment, void * opaque);
+    void                                (* free)(void * address, void * opaque);
+    void *                              opaque;
+} LIBSAIS_ALLOCATOR;
+
+typedef struct LIBSAIS_MONITOR
+{
+    void                                (* profile)(int32_t phase, int32_t end, int32_t depth, int64_t n, int64_t k, int32_t flags, void * opaque);
+    void *                              profile_opaque;
+    int32_t                             (* cancel)(void * opaque);
+    void *                              cancel_opaque;
+    sa_sint_t                           cancelled;
+    sa_sint_t                           thread_block_size;
+} LIBSAIS_MONITOR;
+
+typedef struct LIBSAIS_ARENA
+{
+    uint8_t *                           memory;
+    size_t                              size;
+    size_t                              used;
+    sa_sint_t                           exhausted;
+} LIBSAIS_ARENA;
+
 typedef struct LIBSAIS_CONTEXT
 {
     sa_sint_t *                         buckets;
     LIBSAIS_THREAD_STATE *              thread_state;
     fast_sint_t                         threads;
+    sa_sint_t *                         local_buffer;
+    fast_sint_t                         local_buffer_size;
+    fast_sint_t                         numa;
+    LIBSAIS_ALLOCATOR                   allocator;
+    LIBSAIS_MONITOR                     monitor;
 } LIBSAIS_CONTEXT;
 
 typedef struct LIBSAIS_UNBWT_CONTEXT
@@ -91,9 +150,22 @@ typedef struct LIBSAIS_UNBWT_CONTEXT
     sa_uint_t *                         bucket2;
     uint16_t *                          fastbits;
     sa_uint_t *                         buckets;
+    fast_sint_t                         fastbits_log;
     fast_sint_t                         threads;
+    LIBSAIS_ALLOCATOR                   allocator;
 } LIBSAIS_UNBWT_CONTEXT;
 
+#define LIBSAIS_UNBWT_INDEX_MAGIC           (0x323336314955534cULL)
+
+typedef struct LIBSAIS_UNBWT_INDEX
+{
+    uint64_t                    magic;
+    int64_t                     n;
+    int64_t                     r;
+    int64_t                     lastc;
+    int64_t                     reserved[4];
+} LIBSAIS_UNBWT_INDEX;
+
 #if defined(__GNUC__) || defined(__clang__)
     #define RESTRICT __restrict__
 #elif defined(_MSC_VER) || defined(__INTEL_COMPILER)
@@ -174,58 +246,104 @@ static void libsais16_free_aligned(void * aligned_address)
     }
 }
 
-static LIBSAIS_THREAD_STATE * libsais16_alloc_thread_state(sa_sint_t threads)
+static void * libsais16_alloc_memory(const LIBSAIS_ALLOCATOR * allocator, size_t size, size_t alignment)
+{
+    return allocator != NULL && allocator->alloc != NULL
+        ? allocator->alloc(size, alignment, allocator->opaque)
+        : libsais16_alloc_aligned(size, alignment);
+}
+
+static void libsais16_free_memory(const LIBSAIS_ALLOCATOR * allocator, void * address)
+{
+    if (allocator != NULL && allocator->alloc != NULL)
+    {
+        if (address != NULL) { allocator->free(address, allocator->opaque); }
+    }
+    else
+    {
+        libsais16_free_aligned(address);
+    }
+}
+
+static void * libsais16_arena_alloc(size_t size, size_t alignment, void * opaque)
+{
+    LIBSAIS_ARENA * RESTRICT arena = (LIBSAIS_ARENA *)opaque;
+
+    size_t offset = (size_t)((uint8_t *)libsais16_align_up(arena->memory + arena->used, alignment) - arena->memory);
+    if (offset > arena->size || size > arena->size - offset) { arena->exhausted = 1; return NULL; }
+
+    arena->used = offset + size;
+    return arena->memory + offset;
+}
+
+static void libsais16_arena_free(void * address, void * opaque)
+{
+    LIBSAIS_ARENA * RESTRICT arena = (LIBSAIS_ARENA *)opaque;
+
+    size_t offset = (size_t)((uint8_t *)address - arena->memory);
+    if (offset < arena->used) { arena->used = offset; }
+}
+
+static LIBSAIS_THREAD_STATE * libsais16_alloc_thread_state(sa_sint_t threads, const LIBSAIS_ALLOCATOR * allocator)
 {
-    LIBSAIS_THREAD_STATE *  RESTRICT thread_state    = (LIBSAIS_THREAD_STATE *)libsais16_alloc_aligned((size_t)threads * sizeof(LIBSAIS_THREAD_STATE), 4096);
-    sa_sint_t *             RESTRICT thread_buckets  = (sa_sint_t *)libsais16_alloc_aligned((size_t)threads * 4 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
-    LIBSAIS_THREAD_CACHE *  RESTRICT thread_cache    = (LIBSAIS_THREAD_CACHE *)libsais16_alloc_aligned((size_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE * sizeof(LIBSAIS_THREAD_CACHE), 4096);
+    LIBSAIS_THREAD_STATE *  RESTRICT thread_state    = (LIBSAIS_THREAD_STATE *)libsais16_alloc_memory(allocator, (size_t)threads * sizeof(LIBSAIS_THREAD_STATE), 4096);
+    sa_sint_t *             RESTRICT thread_buckets  = (sa_sint_t *)libsais16_alloc_memory(allocator, (size_t)threads * 4 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
+    LIBSAIS_THREAD_CACHE *  RESTRICT thread_cache    = (LIBSAIS_THREAD_CACHE *)libsais16_alloc_memory(allocator, (size_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE * sizeof(LIBSAIS_THREAD_CACHE), 4096);
 
     if (thread_state != NULL && thread_buckets != NULL && thread_cache != NULL)
     {
         fast_sint_t t;
         for (t = 0; t < threads; ++t)
         { 
-            thread_state[t].state.buckets   = thread_buckets;   thread_buckets  += 4 * ALPHABET_SIZE;
-            thread_state[t].state.cache     = thread_cache;     thread_cache    += LIBSAIS_PER_THREAD_CACHE_SIZE;
+            thread_state[t].state.buckets    = thread_buckets;   thread_buckets  += 4 * ALPHABET_SIZE;
+            thread_state[t].state.cache      = thread_cache;     thread_cache    += LIBSAIS_PER_THREAD_CACHE_SIZE;
+            thread_state[t].state.cache_size = LIBSAIS_PER_THREAD_CACHE_SIZE;
+            thread_state[t].state.monitor    = NULL;
         }
 
         return thread_state;
     }
 
-    libsais16_free_aligned(thread_cache);
-    libsais16_free_aligned(thread_buckets);
-    libsais16_free_aligned(thread_state);
+    libsais16_free_memory(allocator, thread_cache);
+    libsais16_free_memory(allocator, thread_buckets);
+    libsais16_free_memory(allocator, thread_state);
     return NULL;
 }
 
-static void libsais16_free_thread_state(LIBSAIS_THREAD_STATE * thread_state)
+static void libsais16_free_thread_state(LIBSAIS_THREAD_STATE * thread_state, const LIBSAIS_ALLOCATOR * allocator)
 {
     if (thread_state != NULL)
     {
-        libsais16_free_aligned(thread_state[0].state.cache);
-        libsais16_free_aligned(thread_state[0].state.buckets);
-        libsais16_free_aligned(thread_state);
+        libsais16_free_memory(allocator, thread_state[0].state.cache);
+        libsais16_free_memory(allocator, thread_state[0].state.buckets);
+        libsais16_free_memory(allocator, thread_state);
     }
 }
 
-static LIBSAIS_CONTEXT * libsais16_create_ctx_main(sa_sint_t threads)
+static LIBSAIS_CONTEXT * libsais16_create_ctx_main(sa_sint_t threads, const LIBSAIS_ALLOCATOR * allocator)
 {
-    LIBSAIS_CONTEXT *       RESTRICT ctx            = (LIBSAIS_CONTEXT *)libsais16_alloc_aligned(sizeof(LIBSAIS_CONTEXT), 64);
-    sa_sint_t *             RESTRICT buckets        = (sa_sint_t *)libsais16_alloc_aligned((size_t)8 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
-    LIBSAIS_THREAD_STATE *  RESTRICT thread_state   = threads > 1 ? libsais16_alloc_thread_state(threads) : NULL;
+    LIBSAIS_CONTEXT *       RESTRICT ctx            = (LIBSAIS_CONTEXT *)libsais16_alloc_memory(allocator, sizeof(LIBSAIS_CONTEXT), 64);
+    sa_sint_t *             RESTRICT buckets        = (sa_sint_t *)libsais16_alloc_memory(allocator, (size_t)8 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
+    LIBSAIS_THREAD_STATE *  RESTRICT thread_state   = threads > 1 ? libsais16_alloc_thread_state(threads, allocator) : NULL;
 
     if (ctx != NULL && buckets != NULL && (thread_state != NULL || threads == 1))
     {
         ctx->buckets = buckets;
         ctx->threads = threads;
         ctx->thread_state = thread_state;
+        ctx->numa = LIBSAIS16_NUMA_NONE;
+        ctx->local_buffer = NULL;
+        ctx->local_buffer_size = LIBSAIS_LOCAL_BUFFER_SIZE;
+
+        if (allocator != NULL) { ctx->allocator = *allocator; } else { memset(&ctx->allocator, 0, sizeof(LIBSAIS_ALLOCATOR)); }
+        memset(&ctx->monitor, 0, sizeof(LIBSAIS_MONITOR));
 
         return ctx;
     }
 
-    libsais16_free_thread_state(thread_state);
-    libsais16_free_aligned(buckets);
-    libsais16_free_aligned(ctx);
+    libsais16_free_thread_state(thread_state, allocator);
+    libsais16_free_memory(allocator, buckets);
+    libsais16_free_memory(allocator, ctx);
     return NULL;
 }
 
@@ -233,10 +351,219 @@ static void libsais16_free_ctx_main(LIBSAIS_CONTEXT * ctx)
 {
     if (ctx != NULL)
     {
-        libsais16_free_thread_state(ctx->thread_state);
-        libsais16_free_aligned(ctx->buckets);
-        libsais16_free_aligned(ctx);
+        LIBSAIS_ALLOCATOR allocator = ctx->allocator;
+
+        libsais16_free_thread_state(ctx->thread_state, &allocator);
+        libsais16_free_memory(&allocator, ctx->local_buffer);
+        libsais16_free_memory(&allocator, ctx->buckets);
+        libsais16_free_memory(&allocator, ctx);
+    }
+}
+
+static LIBSAIS_CONTEXT * libsais16_create_ctx_buffer_main(sa_sint_t threads, void * buffer, size_t size)
+{
+    LIBSAIS_ARENA * RESTRICT arena = (LIBSAIS_ARENA *)libsais16_align_up(buffer, 64);
+
+    if (buffer != NULL && (size_t)((uint8_t *)(arena + 1) - (uint8_t *)buffer) <= size)
+    {
+        arena->memory       = (uint8_t *)(arena + 1);
+        arena->size         = size - (size_t)(arena->memory - (uint8_t *)buffer);
+        arena->used         = 0;
+        arena->exhausted    = 0;
+
+        LIBSAIS_ALLOCATOR allocator = { libsais16_arena_alloc, libsais16_arena_free, arena };
+        return libsais16_create_ctx_main(threads, &allocator);
+    }
+
+    return NULL;
+}
+
+static sa_sint_t libsais16_ctx_status(const LIBSAIS_CONTEXT * ctx, sa_sint_t index)
+{
+    if (ctx->allocator.alloc == libsais16_arena_alloc)
+    {
+        LIBSAIS_ARENA * RESTRICT arena = (LIBSAIS_ARENA *)ctx->allocator.opaque;
+
+        if (index == -2 && arena->exhausted) { index = -3; }
+        arena->exhausted = 0;
+    }
+
+    return index;
+}
+
+static void libsais16_profile(const LIBSAIS_MONITOR * monitor, sa_sint_t phase, sa_sint_t end, sa_sint_t depth, sa_sint_t n, sa_sint_t k, sa_sint_t flags)
+{
+    if (monitor != NULL && monitor->profile != NULL)
+    {
+        monitor->profile((int32_t)phase, (int32_t)end, (int32_t)depth, (int64_t)n, (int64_t)k, (int32_t)flags, monitor->profile_opaque);
+    }
+}
+
+static sa_sint_t libsais16_cancelled(LIBSAIS_MONITOR * monitor)
+{
+    if (monitor != NULL && monitor->cancel != NULL && monitor->cancelled == 0)
+    {
+        monitor->cancelled = monitor->cancel(monitor->cancel_opaque) != 0;
+    }
+
+    return monitor != NULL && monitor->cancelled != 0;
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+static void libsais16_numa_touch_pages(void * memory, fast_sint_t size, fast_sint_t start, fast_sint_t end, fast_sint_t page_start, fast_sint_t page_step)
+{
+    uint8_t * RESTRICT bytes = (uint8_t *)memory;
+    ptrdiff_t base = ((ptrdiff_t)bytes) & (-((ptrdiff_t)LIBSAIS_NUMA_PAGE_SIZE));
+
+    if (start < end && end <= size)
+    {
+        fast_sint_t p = (((ptrdiff_t)(bytes + start) - base) / LIBSAIS_NUMA_PAGE_SIZE);
+        fast_sint_t last = (((ptrdiff_t)(bytes + end - 1) - base) / LIBSAIS_NUMA_PAGE_SIZE);
+
+        if (page_step > 1) { p += (page_start - p % page_step + page_step) % page_step; }
+
+        for (; p <= last; p += page_step)
+        {
+            fast_sint_t offset = (fast_sint_t)(base + p * LIBSAIS_NUMA_PAGE_SIZE - (ptrdiff_t)bytes);
+            bytes[offset > start ? offset : start] = 0;
+        }
+    }
+}
+
+#endif
+
+static void libsais16_numa_place_thread_state(LIBSAIS_THREAD_STATE * RESTRICT thread_state, fast_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    if (thread_state != NULL && threads > 1)
+    {
+        #pragma omp parallel num_threads(threads)
+        {
+            fast_sint_t omp_thread_num = omp_get_thread_num();
+            fast_sint_t cache_size = thread_state[0].state.cache_size * (fast_sint_t)sizeof(LIBSAIS_THREAD_CACHE);
+
+            if (omp_thread_num < threads)
+            {
+                memset(thread_state[omp_thread_num].state.buckets, 0, (size_t)4 * ALPHABET_SIZE * sizeof(sa_sint_t));
+                libsais16_numa_touch_pages(thread_state[omp_thread_num].state.cache, cache_size, 0, cache_size, 0, 1);
+            }
+        }
+    }
+#else
+    UNUSED(thread_state); UNUSED(threads);
+#endif
+}
+
+static void libsais16_numa_place_omp(const LIBSAIS_CONTEXT * ctx, sa_sint_t * SA, sa_sint_t n, sa_sint_t fs)
+{
+#if defined(LIBSAIS_OPENMP)
+    if (ctx->numa != LIBSAIS16_NUMA_NONE && ctx->threads > 1 && n >= 65536)
+    {
+        fast_sint_t mode = ctx->numa, size = ((fast_sint_t)n + (fast_sint_t)fs) * (fast_sint_t)sizeof(sa_sint_t);
+
+        #pragma omp parallel num_threads(ctx->threads)
+        {
+            fast_sint_t omp_thread_num    = omp_get_thread_num();
+            fast_sint_t omp_num_threads   = omp_get_num_threads();
+            fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+            fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+            fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n + fs - omp_block_start;
+
+            if (mode == LIBSAIS16_NUMA_INTERLEAVE)
+            {
+                libsais16_numa_touch_pages(SA, size, 0, size, omp_thread_num, omp_num_threads);
+            }
+            else
+            {
+                libsais16_numa_touch_pages(SA, size, omp_block_start * (fast_sint_t)sizeof(sa_sint_t), (omp_block_start + omp_block_size) * (fast_sint_t)sizeof(sa_sint_t), 0, 1);
+            }
+        }
+    }
+#else
+    UNUSED(ctx); UNUSED(SA); UNUSED(n); UNUSED(fs);
+#endif
+}
+
+static int64_t libsais16_padded_size(int64_t size, int64_t alignment, fast_sint_t flags)
+{
+    return size > 0 ? size + (alignment - 1) + (flags != LIBSAIS16_FLAGS_BUFFER ? (int64_t)sizeof(short) : 0) : 0;
+}
+
+static int64_t libsais16_thread_state_size(fast_sint_t threads, fast_sint_t flags)
+{
+    int64_t size = 0;
+
+    if (threads > 1)
+    {
+        size += libsais16_padded_size((int64_t)threads * (int64_t)sizeof(LIBSAIS_THREAD_STATE), 4096, flags);
+        size += libsais16_padded_size((int64_t)threads * 4 * ALPHABET_SIZE * (int64_t)sizeof(sa_sint_t), 4096, flags);
+        size += libsais16_padded_size((int64_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE * (int64_t)sizeof(LIBSAIS_THREAD_CACHE), 4096, flags);
     }
+
+    return size;
+}
+
+static int64_t libsais16_ctx_size_main(fast_sint_t threads)
+{
+    int64_t size = libsais16_padded_size((int64_t)sizeof(LIBSAIS_CONTEXT), 64, LIBSAIS16_FLAGS_CTX);
+
+    size += libsais16_padded_size((int64_t)8 * ALPHABET_SIZE * (int64_t)sizeof(sa_sint_t), 4096, LIBSAIS16_FLAGS_CTX);
+    size += libsais16_thread_state_size(threads, LIBSAIS16_FLAGS_CTX);
+
+    return size;
+}
+
+static fast_sint_t libsais16_recursion_buffer_size(fast_sint_t n, fast_sint_t k, fast_sint_t fs, fast_sint_t threads, fast_sint_t local_buffer_size)
+{
+    fast_sint_t size = 0;
+
+    fs = fs < (SAINT_MAX - n) ? fs : (SAINT_MAX - n);
+
+    if (fs < k && (threads > 1 || local_buffer_size / k < 2)) { size = k; }
+
+    {
+        fast_sint_t m = n / 2, names = m - 1;
+        if (names > fs + n - 2 * m && (threads > 1 || local_buffer_size / names < 2) && names > size) { size = names; }
+    }
+
+    return size;
+}
+
+static fast_sint_t libsais16_alphabet_buffer_size(fast_sint_t n, fast_sint_t k, fast_sint_t fs)
+{
+    fs = fs < (SAINT_MAX - n) ? fs : (SAINT_MAX - n);
+
+    return k > 0 && fs / k < 6 ? (k > n + fs ? k : k < n ? k : n) : 0;
+}
+
+static int64_t libsais16_scratch_size_main(fast_sint_t n, fast_sint_t k, fast_sint_t fs, fast_sint_t threads, fast_sint_t flags)
+{
+    int64_t size = 0;
+
+    if (n >= 2)
+    {
+        size += libsais16_padded_size((int64_t)libsais16_recursion_buffer_size(n, k, fs, threads, flags == LIBSAIS16_FLAGS_NONE ? LIBSAIS_LOCAL_BUFFER_SIZE : 0) * (int64_t)sizeof(sa_sint_t), 4096, flags);
+        size += libsais16_padded_size((int64_t)libsais16_alphabet_buffer_size(n, k, fs) * (int64_t)sizeof(sa_sint_t), 4096, flags);
+
+        if (flags == LIBSAIS16_FLAGS_NONE)
+        {
+            size += libsais16_thread_state_size(threads, flags);
+            if (k == 0) { size += libsais16_padded_size((int64_t)8 * ALPHABET_SIZE * (int64_t)sizeof(sa_sint_t), 4096, flags); }
+        }
+    }
+
+    if (flags == LIBSAIS16_FLAGS_BUFFER)
+    {
+        size += (int64_t)sizeof(LIBSAIS_ARENA) + 64 + libsais16_ctx_size_main(threads);
+    }
+
+    return size;
+}
+
+static int64_t libsais16_alloc_size_main(fast_sint_t n, fast_sint_t k, fast_sint_t threads)
+{
+    return libsais16_ctx_size_main(threads) + libsais16_scratch_size_main(n, k, 0, threads, LIBSAIS16_FLAGS_CTX);
 }
 
 #if defined(LIBSAIS_OPENMP)
@@ -261,7 +588,7 @@ static sa_sint_t libsais16_count_zero_marked_suffixes(sa_sint_t * RESTRICT SA, f
 
 static void libsais16_place_cached_suffixes(sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
@@ -287,7 +614,7 @@ static void libsais16_place_cached_suffixes(sa_sint_t * RESTRICT SA, LIBSAIS_THR
 
 static void libsais16_compact_and_place_cached_suffixes(sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j, l;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - 3, l = omp_block_start; i < j; i += 4)
@@ -480,7 +807,7 @@ static void libsais16_gather_lms_suffixes_16u_omp(const uint16_t * RESTRICT T, s
 
 static sa_sint_t libsais16_gather_lms_suffixes_32s(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t             i   = n - 2;
     sa_sint_t             m   = n - 1;
@@ -508,7 +835,7 @@ static sa_sint_t libsais16_gather_lms_suffixes_32s(const sa_sint_t * RESTRICT T,
 
 static sa_sint_t libsais16_gather_compacted_lms_suffixes_32s(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t             i   = n - 2;
     sa_sint_t             m   = n - 1;
@@ -538,7 +865,7 @@ static sa_sint_t libsais16_gather_compacted_lms_suffixes_32s(const sa_sint_t * R
 
 static void libsais16_count_lms_suffixes_32s_4k(const sa_sint_t * RESTRICT T, sa_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT buckets)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     memset(buckets, 0, 4 * (size_t)k * sizeof(sa_sint_t));
 
@@ -582,7 +909,7 @@ static void libsais16_count_lms_suffixes_32s_4k(const sa_sint_t * RESTRICT T, sa
 
 static void libsais16_count_lms_suffixes_32s_2k(const sa_sint_t * RESTRICT T, sa_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT buckets)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     memset(buckets, 0, 2 * (size_t)k * sizeof(sa_sint_t));
 
@@ -626,7 +953,7 @@ static void libsais16_count_lms_suffixes_32s_2k(const sa_sint_t * RESTRICT T, sa
 
 static void libsais16_count_compacted_lms_suffixes_32s_2k(const sa_sint_t * RESTRICT T, sa_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT buckets)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     memset(buckets, 0, 2 * (size_t)k * sizeof(sa_sint_t));
 
@@ -789,7 +1116,7 @@ static sa_sint_t libsais16_count_and_gather_lms_suffixes_32s_4k(const sa_sint_t
 
     if (omp_block_size > 0)
     {
-        const fast_sint_t prefetch_distance = 32;
+        const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
         fast_sint_t i, j = m + 1, c0 = T[m], c1 = -1;
 
@@ -840,7 +1167,7 @@ static sa_sint_t libsais16_count_and_gather_lms_suffixes_32s_2k(const sa_sint_t
 
     if (omp_block_size > 0)
     {
-        const fast_sint_t prefetch_distance = 32;
+        const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
         fast_sint_t i, j = m + 1, c0 = T[m], c1 = -1;
 
@@ -891,7 +1218,7 @@ static sa_sint_t libsais16_count_and_gather_compacted_lms_suffixes_32s_2k(const
 
     if (omp_block_size > 0)
     {
-        const fast_sint_t prefetch_distance = 32;
+        const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
         fast_sint_t i, j = m + 1, c0 = T[m], c1 = -1;
 
@@ -1306,7 +1633,7 @@ static void libsais16_count_and_gather_compacted_lms_suffixes_32s_2k_omp(const s
 
 static void libsais16_count_suffixes_32s(const sa_sint_t * RESTRICT T, sa_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT buckets)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     memset(buckets, 0, (size_t)k * sizeof(sa_sint_t));
 
@@ -1519,7 +1846,7 @@ static void libsais16_initialize_buckets_for_radix_and_partial_sorting_32s_4k(co
 
 static void libsais16_radix_sort_lms_suffixes_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 3; i >= j; i -= 4)
@@ -1593,7 +1920,7 @@ static void libsais16_radix_sort_lms_suffixes_16u_omp(const uint16_t * RESTRICT
 
 static void libsais16_radix_sort_lms_suffixes_32s_6k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + 2 * prefetch_distance + 3; i >= j; i -= 4)
@@ -1624,7 +1951,7 @@ static void libsais16_radix_sort_lms_suffixes_32s_6k(const sa_sint_t * RESTRICT
 
 static void libsais16_radix_sort_lms_suffixes_32s_2k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + 2 * prefetch_distance + 3; i >= j; i -= 4)
@@ -1657,7 +1984,7 @@ static void libsais16_radix_sort_lms_suffixes_32s_2k(const sa_sint_t * RESTRICT
 
 static void libsais16_radix_sort_lms_suffixes_32s_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
@@ -1685,7 +2012,7 @@ static void libsais16_radix_sort_lms_suffixes_32s_block_gather(const sa_sint_t *
 
 static void libsais16_radix_sort_lms_suffixes_32s_6k_block_sort(sa_sint_t * RESTRICT induction_bucket, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 3; i >= j; i -= 4)
@@ -1711,7 +2038,7 @@ static void libsais16_radix_sort_lms_suffixes_32s_6k_block_sort(sa_sint_t * REST
 
 static void libsais16_radix_sort_lms_suffixes_32s_2k_block_sort(sa_sint_t * RESTRICT induction_bucket, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 3; i >= j; i -= 4)
@@ -1847,7 +2174,9 @@ static void libsais16_radix_sort_lms_suffixes_32s_6k_omp(const sa_sint_t * RESTR
         fast_sint_t block_start, block_end;
         for (block_start = 0; block_start < (fast_sint_t)m - 1; block_start = block_end)
         {
-            block_end = block_start + (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end >= m) { block_end = (fast_sint_t)m - 1; }
+            if (libsais16_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start + (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end >= m) { block_end = (fast_sint_t)m - 1; }
 
             libsais16_radix_sort_lms_suffixes_32s_6k_block_omp(T, SA, induction_bucket, thread_state[0].state.cache, (fast_sint_t)n - block_end, block_end - block_start, threads);
         }
@@ -1869,7 +2198,9 @@ static void libsais16_radix_sort_lms_suffixes_32s_2k_omp(const sa_sint_t * RESTR
         fast_sint_t block_start, block_end;
         for (block_start = 0; block_start < (fast_sint_t)m - 1; block_start = block_end)
         {
-            block_end = block_start + (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end >= m) { block_end = (fast_sint_t)m - 1; }
+            if (libsais16_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start + (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end >= m) { block_end = (fast_sint_t)m - 1; }
 
             libsais16_radix_sort_lms_suffixes_32s_2k_block_omp(T, SA, induction_bucket, thread_state[0].state.cache, (fast_sint_t)n - block_end, block_end - block_start, threads);
         }
@@ -1881,7 +2212,7 @@ static void libsais16_radix_sort_lms_suffixes_32s_2k_omp(const sa_sint_t * RESTR
 
 static sa_sint_t libsais16_radix_sort_lms_suffixes_32s_1k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t * RESTRICT buckets)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t             i = n - 2;
     sa_sint_t             m = 0;
@@ -1928,7 +2259,7 @@ static sa_sint_t libsais16_radix_sort_lms_suffixes_32s_1k(const sa_sint_t * REST
 
 static void libsais16_radix_sort_set_markers_32s_6k(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
@@ -1954,7 +2285,7 @@ static void libsais16_radix_sort_set_markers_32s_6k(sa_sint_t * RESTRICT SA, sa_
 
 static void libsais16_radix_sort_set_markers_32s_4k(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
@@ -2087,7 +2418,7 @@ static void libsais16_initialize_buckets_for_partial_sorting_32s_6k(const sa_sin
 
 static sa_sint_t libsais16_partial_sorting_scan_left_to_right_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, sa_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[4 * ALPHABET_SIZE];
     sa_sint_t * RESTRICT distinct_names   = &buckets[2 * ALPHABET_SIZE];
@@ -2122,7 +2453,7 @@ static sa_sint_t libsais16_partial_sorting_scan_left_to_right_16u(const uint16_t
 
 static void libsais16_partial_sorting_scan_left_to_right_16u_block_prepare(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size, LIBSAIS_THREAD_STATE * RESTRICT state)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[0 * ALPHABET_SIZE];
     sa_sint_t * RESTRICT distinct_names   = &buckets[2 * ALPHABET_SIZE];
@@ -2155,7 +2486,7 @@ static void libsais16_partial_sorting_scan_left_to_right_16u_block_prepare(const
 
 static void libsais16_partial_sorting_scan_left_to_right_16u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count, sa_sint_t d)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[0 * ALPHABET_SIZE];
     sa_sint_t * RESTRICT distinct_names   = &buckets[2 * ALPHABET_SIZE];
@@ -2270,7 +2601,9 @@ static sa_sint_t libsais16_partial_sorting_scan_left_to_right_16u_omp(const uint
             }
             else
             {
-                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end > left_suffixes_count) { block_max_end = left_suffixes_count;}
+                if (libsais16_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end > left_suffixes_count) { block_max_end = left_suffixes_count;}
                 fast_sint_t block_end     = block_start + 1; while (block_end < block_max_end && SA[block_end] != 0) { block_end++; }
                 fast_sint_t block_size    = block_end - block_start;
 
@@ -2299,7 +2632,7 @@ static sa_sint_t libsais16_partial_sorting_scan_left_to_right_16u_omp(const uint
 
 static sa_sint_t libsais16_partial_sorting_scan_left_to_right_32s_6k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, sa_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - 2 * prefetch_distance - 1; i < j; i += 2)
@@ -2332,7 +2665,7 @@ static sa_sint_t libsais16_partial_sorting_scan_left_to_right_32s_6k(const sa_si
 
 static sa_sint_t libsais16_partial_sorting_scan_left_to_right_32s_4k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, sa_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[2 * (fast_sint_t)k];
     sa_sint_t * RESTRICT distinct_names   = &buckets[0 * (fast_sint_t)k];
@@ -2377,7 +2710,7 @@ static sa_sint_t libsais16_partial_sorting_scan_left_to_right_32s_4k(const sa_si
 
 static void libsais16_partial_sorting_scan_left_to_right_32s_1k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - 2 * prefetch_distance - 1; i < j; i += 2)
@@ -2403,7 +2736,7 @@ static void libsais16_partial_sorting_scan_left_to_right_32s_1k(const sa_sint_t
 
 static void libsais16_partial_sorting_scan_left_to_right_32s_6k_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -2429,7 +2762,7 @@ static void libsais16_partial_sorting_scan_left_to_right_32s_6k_block_gather(con
 
 static void libsais16_partial_sorting_scan_left_to_right_32s_4k_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -2453,7 +2786,7 @@ static void libsais16_partial_sorting_scan_left_to_right_32s_4k_block_gather(con
 
 static void libsais16_partial_sorting_scan_left_to_right_32s_1k_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -2477,7 +2810,7 @@ static void libsais16_partial_sorting_scan_left_to_right_32s_1k_block_gather(con
 
 static sa_sint_t libsais16_partial_sorting_scan_left_to_right_32s_6k_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT buckets, sa_sint_t d, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j, omp_block_end = omp_block_start + omp_block_size;
     for (i = omp_block_start, j = omp_block_end - prefetch_distance - 1; i < j; i += 2)
@@ -2505,7 +2838,7 @@ static sa_sint_t libsais16_partial_sorting_scan_left_to_right_32s_6k_block_sort(
 
 static sa_sint_t libsais16_partial_sorting_scan_left_to_right_32s_4k_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t k, sa_sint_t * RESTRICT buckets, sa_sint_t d, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[2 * (fast_sint_t)k];
     sa_sint_t * RESTRICT distinct_names   = &buckets[0 * (fast_sint_t)k];
@@ -2548,7 +2881,7 @@ static sa_sint_t libsais16_partial_sorting_scan_left_to_right_32s_4k_block_sort(
 
 static void libsais16_partial_sorting_scan_left_to_right_32s_1k_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT induction_bucket, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j, omp_block_end = omp_block_start + omp_block_size;
     for (i = omp_block_start, j = omp_block_end - prefetch_distance - 1; i < j; i += 2)
@@ -2752,7 +3085,9 @@ static sa_sint_t libsais16_partial_sorting_scan_left_to_right_32s_6k_omp(const s
         fast_sint_t block_start, block_end;
         for (block_start = 0; block_start < left_suffixes_count; block_start = block_end)
         {
-            block_end = block_start + (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end > left_suffixes_count) { block_end = left_suffixes_count; }
+            if (libsais16_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start + (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end > left_suffixes_count) { block_end = left_suffixes_count; }
 
             d = libsais16_partial_sorting_scan_left_to_right_32s_6k_block_omp(T, SA, buckets, d, thread_state[0].state.cache, block_start, block_end - block_start, threads);
         }
@@ -2782,7 +3117,9 @@ static sa_sint_t libsais16_partial_sorting_scan_left_to_right_32s_4k_omp(const s
         fast_sint_t block_start, block_end;
         for (block_start = 0; block_start < n; block_start = block_end)
         {
-            block_end = block_start + (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end > n) { block_end = n; }
+            if (libsais16_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start + (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end > n) { block_end = n; }
 
             d = libsais16_partial_sorting_scan_left_to_right_32s_4k_block_omp(T, SA, k, buckets, d, thread_state[0].state.cache, block_start, block_end - block_start, threads);
         }
@@ -2808,7 +3145,9 @@ static void libsais16_partial_sorting_scan_left_to_right_32s_1k_omp(const sa_sin
         fast_sint_t block_start, block_end;
         for (block_start = 0; block_start < n; block_start = block_end)
         {
-            block_end = block_start + (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end > n) { block_end = n; }
+            if (libsais16_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start + (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end > n) { block_end = n; }
 
             libsais16_partial_sorting_scan_left_to_right_32s_1k_block_omp(T, SA, buckets, thread_state[0].state.cache, block_start, block_end - block_start, threads);
         }
@@ -2820,7 +3159,7 @@ static void libsais16_partial_sorting_scan_left_to_right_32s_1k_omp(const sa_sin
 
 static void libsais16_partial_sorting_shift_markers_16u_omp(sa_sint_t * RESTRICT SA, sa_sint_t n, const sa_sint_t * RESTRICT buckets, sa_sint_t threads)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     const sa_sint_t * RESTRICT temp_bucket = &buckets[4 * ALPHABET_SIZE];
 
@@ -2853,7 +3192,7 @@ static void libsais16_partial_sorting_shift_markers_16u_omp(sa_sint_t * RESTRICT
 
 static void libsais16_partial_sorting_shift_markers_32s_6k_omp(sa_sint_t * RESTRICT SA, sa_sint_t k, const sa_sint_t * RESTRICT buckets, sa_sint_t threads)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     const sa_sint_t * RESTRICT temp_bucket = &buckets[4 * (fast_sint_t)k];
     
@@ -2886,7 +3225,7 @@ static void libsais16_partial_sorting_shift_markers_32s_6k_omp(sa_sint_t * RESTR
 
 static void libsais16_partial_sorting_shift_markers_32s_4k(sa_sint_t * RESTRICT SA, sa_sint_t n)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i; sa_sint_t s = SUFFIX_GROUP_MARKER;
     for (i = (fast_sint_t)n - 1; i >= 3; i -= 4)
@@ -2919,7 +3258,7 @@ static void libsais16_partial_sorting_shift_buckets_32s_6k(sa_sint_t k, sa_sint_
 
 static sa_sint_t libsais16_partial_sorting_scan_right_to_left_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, sa_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[0 * ALPHABET_SIZE];
     sa_sint_t * RESTRICT distinct_names   = &buckets[2 * ALPHABET_SIZE];
@@ -2954,7 +3293,7 @@ static sa_sint_t libsais16_partial_sorting_scan_right_to_left_16u(const uint16_t
 
 static void libsais16_partial_sorting_scan_right_to_left_16u_block_prepare(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size, LIBSAIS_THREAD_STATE * RESTRICT state)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[0 * ALPHABET_SIZE];
     sa_sint_t * RESTRICT distinct_names   = &buckets[2 * ALPHABET_SIZE];
@@ -2987,7 +3326,7 @@ static void libsais16_partial_sorting_scan_right_to_left_16u_block_prepare(const
 
 static void libsais16_partial_sorting_scan_right_to_left_16u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count, sa_sint_t d)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[0 * ALPHABET_SIZE];
     sa_sint_t * RESTRICT distinct_names   = &buckets[2 * ALPHABET_SIZE];
@@ -3102,7 +3441,9 @@ static void libsais16_partial_sorting_scan_right_to_left_16u_omp(const uint16_t
             }
             else
             {
-                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end < scan_start) { block_max_end = scan_start - 1; }
+                if (libsais16_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end < scan_start) { block_max_end = scan_start - 1; }
                 fast_sint_t block_end     = block_start - 1; while (block_end > block_max_end && SA[block_end] != 0) { block_end--; }
                 fast_sint_t block_size    = block_start - block_end;
 
@@ -3129,7 +3470,7 @@ static void libsais16_partial_sorting_scan_right_to_left_16u_omp(const uint16_t
 
 static sa_sint_t libsais16_partial_sorting_scan_right_to_left_32s_6k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, sa_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + 2 * prefetch_distance + 1; i >= j; i -= 2)
@@ -3162,7 +3503,7 @@ static sa_sint_t libsais16_partial_sorting_scan_right_to_left_32s_6k(const sa_si
 
 static sa_sint_t libsais16_partial_sorting_scan_right_to_left_32s_4k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, sa_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[3 * (fast_sint_t)k];
     sa_sint_t * RESTRICT distinct_names   = &buckets[0 * (fast_sint_t)k];
@@ -3207,7 +3548,7 @@ static sa_sint_t libsais16_partial_sorting_scan_right_to_left_32s_4k(const sa_si
 
 static void libsais16_partial_sorting_scan_right_to_left_32s_1k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + 2 * prefetch_distance + 1; i >= j; i -= 2)
@@ -3233,7 +3574,7 @@ static void libsais16_partial_sorting_scan_right_to_left_32s_1k(const sa_sint_t
 
 static void libsais16_partial_sorting_scan_right_to_left_32s_6k_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -3259,7 +3600,7 @@ static void libsais16_partial_sorting_scan_right_to_left_32s_6k_block_gather(con
 
 static void libsais16_partial_sorting_scan_right_to_left_32s_4k_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -3283,7 +3624,7 @@ static void libsais16_partial_sorting_scan_right_to_left_32s_4k_block_gather(con
 
 static void libsais16_partial_sorting_scan_right_to_left_32s_1k_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -3307,7 +3648,7 @@ static void libsais16_partial_sorting_scan_right_to_left_32s_1k_block_gather(con
 
 static sa_sint_t libsais16_partial_sorting_scan_right_to_left_32s_6k_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT buckets, sa_sint_t d, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
@@ -3335,7 +3676,7 @@ static sa_sint_t libsais16_partial_sorting_scan_right_to_left_32s_6k_block_sort(
 
 static sa_sint_t libsais16_partial_sorting_scan_right_to_left_32s_4k_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t k, sa_sint_t * RESTRICT buckets, sa_sint_t d, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[3 * (fast_sint_t)k];
     sa_sint_t * RESTRICT distinct_names   = &buckets[0 * (fast_sint_t)k];
@@ -3378,7 +3719,7 @@ static sa_sint_t libsais16_partial_sorting_scan_right_to_left_32s_4k_block_sort(
 
 static void libsais16_partial_sorting_scan_right_to_left_32s_1k_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT induction_bucket, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
@@ -3582,7 +3923,9 @@ static sa_sint_t libsais16_partial_sorting_scan_right_to_left_32s_6k_omp(const s
         fast_sint_t block_start, block_end;
         for (block_start = scan_end - 1; block_start >= scan_start; block_start = block_end)
         {
-            block_end = block_start - (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end < scan_start) { block_end = scan_start - 1; }
+            if (libsais16_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start - (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end < scan_start) { block_end = scan_start - 1; }
 
             d = libsais16_partial_sorting_scan_right_to_left_32s_6k_block_omp(T, SA, buckets, d, thread_state[0].state.cache, block_end + 1, block_start - block_end, threads);
         }
@@ -3606,7 +3949,9 @@ static sa_sint_t libsais16_partial_sorting_scan_right_to_left_32s_4k_omp(const s
         fast_sint_t block_start, block_end;
         for (block_start = (fast_sint_t)n - 1; block_start >= 0; block_start = block_end)
         {
-            block_end = block_start - (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end < 0) { block_end = -1; }
+            if (libsais16_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start - (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end < 0) { block_end = -1; }
 
             d = libsais16_partial_sorting_scan_right_to_left_32s_4k_block_omp(T, SA, k, buckets, d, thread_state[0].state.cache, block_end + 1, block_start - block_end, threads);
         }
@@ -3630,7 +3975,9 @@ static void libsais16_partial_sorting_scan_right_to_left_32s_1k_omp(const sa_sin
         fast_sint_t block_start, block_end;
         for (block_start = (fast_sint_t)n - 1; block_start >= 0; block_start = block_end)
         {
-            block_end = block_start - (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end < 0) { block_end = -1; }
+            if (libsais16_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start - (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end < 0) { block_end = -1; }
 
             libsais16_partial_sorting_scan_right_to_left_32s_1k_block_omp(T, SA, buckets, thread_state[0].state.cache, block_end + 1, block_start - block_end, threads);
         }
@@ -3642,7 +3989,7 @@ static void libsais16_partial_sorting_scan_right_to_left_32s_1k_omp(const sa_sin
 
 static fast_sint_t libsais16_partial_sorting_gather_lms_suffixes_32s_4k(sa_sint_t * RESTRICT SA, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j, l;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - 3, l = omp_block_start; i < j; i += 4)
@@ -3665,7 +4012,7 @@ static fast_sint_t libsais16_partial_sorting_gather_lms_suffixes_32s_4k(sa_sint_
 
 static fast_sint_t libsais16_partial_sorting_gather_lms_suffixes_32s_1k(sa_sint_t * RESTRICT SA, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j, l;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - 3, l = omp_block_start; i < j; i += 4)
@@ -3837,7 +4184,7 @@ static void libsais16_induce_partial_order_32s_1k_omp(const sa_sint_t * RESTRICT
 
 static sa_sint_t libsais16_renumber_lms_suffixes_16u(sa_sint_t * RESTRICT SA, sa_sint_t m, sa_sint_t name, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAm = &SA[m];
 
@@ -3867,7 +4214,7 @@ static sa_sint_t libsais16_renumber_lms_suffixes_16u(sa_sint_t * RESTRICT SA, sa
 
 static fast_sint_t libsais16_gather_marked_lms_suffixes(sa_sint_t * RESTRICT SA, sa_sint_t m, fast_sint_t l, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     l -= 1;
 
@@ -4021,7 +4368,7 @@ static sa_sint_t libsais16_renumber_and_gather_lms_suffixes_omp(sa_sint_t * REST
 
 static sa_sint_t libsais16_renumber_distinct_lms_suffixes_32s_4k(sa_sint_t * RESTRICT SA, sa_sint_t m, sa_sint_t name, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAm = &SA[m];
 
@@ -4051,7 +4398,7 @@ static sa_sint_t libsais16_renumber_distinct_lms_suffixes_32s_4k(sa_sint_t * RES
 
 static void libsais16_mark_distinct_lms_suffixes_32s(sa_sint_t * RESTRICT SA, sa_sint_t m, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j; sa_sint_t p0, p1, p2, p3 = 0;
     for (i = (fast_sint_t)m + omp_block_start, j = (fast_sint_t)m + omp_block_start + omp_block_size - 3; i < j; i += 4)
@@ -4072,7 +4419,7 @@ static void libsais16_mark_distinct_lms_suffixes_32s(sa_sint_t * RESTRICT SA, sa
 
 static void libsais16_clamp_lms_suffixes_length_32s(sa_sint_t * RESTRICT SA, sa_sint_t m, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAm = &SA[m];
 
@@ -4203,7 +4550,7 @@ static sa_sint_t libsais16_renumber_and_mark_distinct_lms_suffixes_32s_4k_omp(sa
 
 static sa_sint_t libsais16_renumber_and_mark_distinct_lms_suffixes_32s_1k_omp(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t m, sa_sint_t threads)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAm = &SA[m];
 
@@ -4282,7 +4629,7 @@ static sa_sint_t libsais16_renumber_and_mark_distinct_lms_suffixes_32s_1k_omp(sa
 
 static void libsais16_reconstruct_lms_suffixes(sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t m, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     const sa_sint_t * RESTRICT SAnm = &SA[n - m];
 
@@ -4405,7 +4752,7 @@ static void libsais16_place_lms_suffixes_interval_32s_2k(sa_sint_t * RESTRICT SA
 
 static void libsais16_place_lms_suffixes_interval_32s_1k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t m, sa_sint_t * RESTRICT buckets)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t c = k - 1; fast_sint_t i, l = buckets[c];
     for (i = (fast_sint_t)m - 1; i >= prefetch_distance + 3; i -= 4)
@@ -4505,7 +4852,7 @@ static void libsais16_place_lms_suffixes_histogram_32s_2k(sa_sint_t * RESTRICT S
 
 static void libsais16_final_bwt_scan_left_to_right_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -4527,7 +4874,7 @@ static void libsais16_final_bwt_scan_left_to_right_16u(const uint16_t * RESTRICT
 
 static void libsais16_final_bwt_aux_scan_left_to_right_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -4547,9 +4894,31 @@ static void libsais16_final_bwt_aux_scan_left_to_right_16u(const uint16_t * REST
     }
 }
 
+static void libsais16_final_bwt_aux_sa_scan_left_to_right_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
+    {
+        libsais16_prefetchw(&SA[i + 2 * prefetch_distance]);
+
+        sa_sint_t s0 = SA[i + prefetch_distance + 0]; const uint16_t * Ts0 = &T[s0] - 1; libsais16_prefetchr(s0 > 0 ? Ts0 : NULL); Ts0--; libsais16_prefetchr(s0 > 0 ? Ts0 : NULL);
+        sa_sint_t s1 = SA[i + prefetch_distance + 1]; const uint16_t * Ts1 = &T[s1] - 1; libsais16_prefetchr(s1 > 0 ? Ts1 : NULL); Ts1--; libsais16_prefetchr(s1 > 0 ? Ts1 : NULL);
+
+        sa_sint_t p0 = SA[i + 0]; SA[i + 0] = p0 & SAINT_MAX; if (p0 > 0) { p0--; SA[i + 0] = T[p0] | SAINT_MIN; sa_sint_t d0 = induction_bucket[T[p0]]++; SA[d0] = p0 | ((sa_sint_t)(T[p0 - (p0 > 0)] < T[p0]) << (SAINT_BIT - 1)); if ((p0 & rm) == 0) { I[p0 / (rm + 1)] = d0 + 1; } if ((d0 & rm) == 0) { S[d0 / (rm + 1)] = p0; } }
+        sa_sint_t p1 = SA[i + 1]; SA[i + 1] = p1 & SAINT_MAX; if (p1 > 0) { p1--; SA[i + 1] = T[p1] | SAINT_MIN; sa_sint_t d1 = induction_bucket[T[p1]]++; SA[d1] = p1 | ((sa_sint_t)(T[p1 - (p1 > 0)] < T[p1]) << (SAINT_BIT - 1)); if ((p1 & rm) == 0) { I[p1 / (rm + 1)] = d1 + 1; } if ((d1 & rm) == 0) { S[d1 / (rm + 1)] = p1; } }
+    }
+
+    for (j += prefetch_distance + 1; i < j; i += 1)
+    {
+        sa_sint_t p = SA[i]; SA[i] = p & SAINT_MAX; if (p > 0) { p--; SA[i] = T[p] | SAINT_MIN; sa_sint_t d = induction_bucket[T[p]]++; SA[d] = p | ((sa_sint_t)(T[p - (p > 0)] < T[p]) << (SAINT_BIT - 1)); if ((p & rm) == 0) { I[p / (rm + 1)] = d + 1; } if ((d & rm) == 0) { S[d / (rm + 1)] = p; } }
+    }
+}
+
 static void libsais16_final_sorting_scan_left_to_right_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -4571,7 +4940,7 @@ static void libsais16_final_sorting_scan_left_to_right_16u(const uint16_t * REST
 
 static void libsais16_final_sorting_scan_left_to_right_32s(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - 2 * prefetch_distance - 1; i < j; i += 2)
@@ -4597,7 +4966,7 @@ static void libsais16_final_sorting_scan_left_to_right_32s(const sa_sint_t * RES
 
 static fast_sint_t libsais16_final_bwt_scan_left_to_right_16u_block_prepare(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-   const fast_sint_t prefetch_distance = 32;
+   const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
    memset(buckets, 0, k * sizeof(sa_sint_t));
 
@@ -4623,7 +4992,7 @@ static fast_sint_t libsais16_final_bwt_scan_left_to_right_16u_block_prepare(cons
 
 static fast_sint_t libsais16_final_sorting_scan_left_to_right_16u_block_prepare(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-   const fast_sint_t prefetch_distance = 32;
+   const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
    memset(buckets, 0, k * sizeof(sa_sint_t));
 
@@ -4649,7 +5018,7 @@ static fast_sint_t libsais16_final_sorting_scan_left_to_right_16u_block_prepare(
 
 static void libsais16_final_order_scan_left_to_right_16u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = 0, j = count - 3; i < j; i += 4)
@@ -4670,7 +5039,7 @@ static void libsais16_final_order_scan_left_to_right_16u_block_place(sa_sint_t *
 
 static void libsais16_final_bwt_aux_scan_left_to_right_16u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = 0, j = count - 3; i < j; i += 4)
@@ -4689,9 +5058,28 @@ static void libsais16_final_bwt_aux_scan_left_to_right_16u_block_place(sa_sint_t
     }
 }
 
+static void libsais16_final_bwt_aux_sa_scan_left_to_right_16u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = 0, j = count - 1; i < j; i += 2)
+    {
+        libsais16_prefetchr(&cache[i + prefetch_distance]);
+
+        sa_sint_t d0 = buckets[cache[i + 0].symbol]++; sa_sint_t p0 = cache[i + 0].index; SA[d0] = p0; p0 &= SAINT_MAX; if ((p0 & rm) == 0) { I[p0 / (rm + 1)] = d0 + 1; } if ((d0 & rm) == 0) { S[d0 / (rm + 1)] = p0; }
+        sa_sint_t d1 = buckets[cache[i + 1].symbol]++; sa_sint_t p1 = cache[i + 1].index; SA[d1] = p1; p1 &= SAINT_MAX; if ((p1 & rm) == 0) { I[p1 / (rm + 1)] = d1 + 1; } if ((d1 & rm) == 0) { S[d1 / (rm + 1)] = p1; }
+    }
+
+    for (j += 1; i < j; i += 1)
+    {
+        sa_sint_t d = buckets[cache[i].symbol]++; sa_sint_t p = cache[i].index; SA[d] = p; p &= SAINT_MAX; if ((p & rm) == 0) { I[p / (rm + 1)] = d + 1; } if ((d & rm) == 0) { S[d / (rm + 1)] = p; }
+    }
+}
+
 static void libsais16_final_sorting_scan_left_to_right_32s_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -4715,7 +5103,7 @@ static void libsais16_final_sorting_scan_left_to_right_32s_block_gather(const sa
 
 static void libsais16_final_sorting_scan_left_to_right_32s_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT induction_bucket, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j, omp_block_end = omp_block_start + omp_block_size;
     for (i = omp_block_start, j = omp_block_end - prefetch_distance - 1; i < j; i += 2)
@@ -4859,7 +5247,7 @@ static void libsais16_final_bwt_aux_scan_left_to_right_16u_block_omp(const uint1
     }
 }
 
-static void libsais16_final_sorting_scan_left_to_right_16u_block_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT induction_bucket, fast_sint_t block_start, fast_sint_t block_size, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+static void libsais16_final_bwt_aux_sa_scan_left_to_right_16u_block_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT induction_bucket, fast_sint_t block_start, fast_sint_t block_size, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
 #if defined(LIBSAIS_OPENMP)
     #pragma omp parallel num_threads(threads) if(threads > 1 && block_size >= 64 * (k > 256 ? k : 256) && omp_get_dynamic() == 0)
@@ -4882,13 +5270,13 @@ static void libsais16_final_sorting_scan_left_to_right_16u_block_omp(const uint1
 
         if (omp_num_threads == 1)
         {
-            libsais16_final_sorting_scan_left_to_right_16u(T, SA, induction_bucket, omp_block_start, omp_block_size);
+            libsais16_final_bwt_aux_sa_scan_left_to_right_16u(T, SA, rm, I, S, induction_bucket, omp_block_start, omp_block_size);
         }
 #if defined(LIBSAIS_OPENMP)
         else
         {
             {
-                thread_state[omp_thread_num].state.count = libsais16_final_sorting_scan_left_to_right_16u_block_prepare(T, SA, k, thread_state[omp_thread_num].state.buckets, thread_state[omp_thread_num].state.cache, omp_block_start, omp_block_size);
+                thread_state[omp_thread_num].state.count = libsais16_final_bwt_scan_left_to_right_16u_block_prepare(T, SA, k, thread_state[omp_thread_num].state.buckets, thread_state[omp_thread_num].state.cache, omp_block_start, omp_block_size);
             }
 
             #pragma omp barrier
@@ -4906,24 +5294,24 @@ static void libsais16_final_sorting_scan_left_to_right_16u_block_omp(const uint1
             #pragma omp barrier
 
             {
-                libsais16_final_order_scan_left_to_right_16u_block_place(SA, thread_state[omp_thread_num].state.buckets, thread_state[omp_thread_num].state.cache, thread_state[omp_thread_num].state.count);
+                libsais16_final_bwt_aux_sa_scan_left_to_right_16u_block_place(SA, rm, I, S, thread_state[omp_thread_num].state.buckets, thread_state[omp_thread_num].state.cache, thread_state[omp_thread_num].state.count);
             }
         }
 #endif
     }
 }
 
-static void libsais16_final_sorting_scan_left_to_right_32s_block_omp(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t block_start, fast_sint_t block_size, sa_sint_t threads)
+static void libsais16_final_sorting_scan_left_to_right_16u_block_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT induction_bucket, fast_sint_t block_start, fast_sint_t block_size, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
 #if defined(LIBSAIS_OPENMP)
-    #pragma omp parallel num_threads(threads) if(threads > 1 && block_size >= 16384)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && block_size >= 64 * (k > 256 ? k : 256) && omp_get_dynamic() == 0)
 #endif
     {
 #if defined(LIBSAIS_OPENMP)
         fast_sint_t omp_thread_num    = omp_get_thread_num();
         fast_sint_t omp_num_threads   = omp_get_num_threads();
 #else
-        UNUSED(threads); UNUSED(cache);
+        UNUSED(k); UNUSED(threads); UNUSED(thread_state);
 
         fast_sint_t omp_thread_num    = 0;
         fast_sint_t omp_num_threads   = 1;
@@ -4936,59 +5324,115 @@ static void libsais16_final_sorting_scan_left_to_right_32s_block_omp(const sa_si
 
         if (omp_num_threads == 1)
         {
-            libsais16_final_sorting_scan_left_to_right_32s(T, SA, buckets, omp_block_start, omp_block_size);
+            libsais16_final_sorting_scan_left_to_right_16u(T, SA, induction_bucket, omp_block_start, omp_block_size);
         }
 #if defined(LIBSAIS_OPENMP)
         else
         {
             {
-                libsais16_final_sorting_scan_left_to_right_32s_block_gather(T, SA, cache - block_start, omp_block_start, omp_block_size);
+                thread_state[omp_thread_num].state.count = libsais16_final_sorting_scan_left_to_right_16u_block_prepare(T, SA, k, thread_state[omp_thread_num].state.buckets, thread_state[omp_thread_num].state.cache, omp_block_start, omp_block_size);
             }
 
             #pragma omp barrier
 
             #pragma omp master
             {
-                libsais16_final_sorting_scan_left_to_right_32s_block_sort(T, buckets, cache - block_start, block_start, block_size);
+                fast_sint_t t;
+                for (t = 0; t < omp_num_threads; ++t)
+                {
+                    sa_sint_t * RESTRICT temp_bucket = thread_state[t].state.buckets;
+                    fast_sint_t c; for (c = 0; c < k; c += 1) { sa_sint_t A = induction_bucket[c], B = temp_bucket[c]; induction_bucket[c] = A + B; temp_bucket[c] = A; }
+                }
             }
 
             #pragma omp barrier
 
             {
-                libsais16_compact_and_place_cached_suffixes(SA, cache - block_start, omp_block_start, omp_block_size);
+                libsais16_final_order_scan_left_to_right_16u_block_place(SA, thread_state[omp_thread_num].state.buckets, thread_state[omp_thread_num].state.cache, thread_state[omp_thread_num].state.count);
             }
         }
 #endif
     }
 }
 
-#endif
-
-static void libsais16_final_bwt_scan_left_to_right_16u_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, fast_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+static void libsais16_final_sorting_scan_left_to_right_32s_block_omp(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t block_start, fast_sint_t block_size, sa_sint_t threads)
 {
-    SA[induction_bucket[T[(sa_sint_t)n - 1]]++] = ((sa_sint_t)n - 1) | ((sa_sint_t)(T[(sa_sint_t)n - 2] < T[(sa_sint_t)n - 1]) << (SAINT_BIT - 1));
-
-    if (threads == 1 || n < 65536)
-    {
-        libsais16_final_bwt_scan_left_to_right_16u(T, SA, induction_bucket, 0, n);
-    }
 #if defined(LIBSAIS_OPENMP)
-    else
+    #pragma omp parallel num_threads(threads) if(threads > 1 && block_size >= 16384)
+#endif
     {
-        fast_sint_t block_start;
-        for (block_start = 0; block_start < n; )
-        {
-            if (SA[block_start] == 0)
-            {
-                block_start++;
-            }
-            else
-            {
-                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
-                fast_sint_t block_end     = block_start + 1; while (block_end < block_max_end && SA[block_end] != 0) { block_end++; }
-                fast_sint_t block_size    = block_end - block_start;
-
-                if (block_size < 32)
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads); UNUSED(cache);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (block_size / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : block_size - omp_block_start;
+
+        omp_block_start += block_start;
+
+        if (omp_num_threads == 1)
+        {
+            libsais16_final_sorting_scan_left_to_right_32s(T, SA, buckets, omp_block_start, omp_block_size);
+        }
+#if defined(LIBSAIS_OPENMP)
+        else
+        {
+            {
+                libsais16_final_sorting_scan_left_to_right_32s_block_gather(T, SA, cache - block_start, omp_block_start, omp_block_size);
+            }
+
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                libsais16_final_sorting_scan_left_to_right_32s_block_sort(T, buckets, cache - block_start, block_start, block_size);
+            }
+
+            #pragma omp barrier
+
+            {
+                libsais16_compact_and_place_cached_suffixes(SA, cache - block_start, omp_block_start, omp_block_size);
+            }
+        }
+#endif
+    }
+}
+
+#endif
+
+static void libsais16_final_bwt_scan_left_to_right_16u_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, fast_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+{
+    SA[induction_bucket[T[(sa_sint_t)n - 1]]++] = ((sa_sint_t)n - 1) | ((sa_sint_t)(T[(sa_sint_t)n - 2] < T[(sa_sint_t)n - 1]) << (SAINT_BIT - 1));
+
+    if (threads == 1 || n < 65536)
+    {
+        libsais16_final_bwt_scan_left_to_right_16u(T, SA, induction_bucket, 0, n);
+    }
+#if defined(LIBSAIS_OPENMP)
+    else
+    {
+        fast_sint_t block_start;
+        for (block_start = 0; block_start < n; )
+        {
+            if (SA[block_start] == 0)
+            {
+                block_start++;
+            }
+            else
+            {
+                if (libsais16_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
+                fast_sint_t block_end     = block_start + 1; while (block_end < block_max_end && SA[block_end] != 0) { block_end++; }
+                fast_sint_t block_size    = block_end - block_start;
+
+                if (block_size < 32)
                 {
                     for (; block_start < block_end; block_start += 1)
                     {
@@ -5030,7 +5474,9 @@ static void libsais16_final_bwt_aux_scan_left_to_right_16u_omp(const uint16_t *
             }
             else
             {
-                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
+                if (libsais16_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
                 fast_sint_t block_end     = block_start + 1; while (block_end < block_max_end && SA[block_end] != 0) { block_end++; }
                 fast_sint_t block_size    = block_end - block_start;
 
@@ -5054,6 +5500,55 @@ static void libsais16_final_bwt_aux_scan_left_to_right_16u_omp(const uint16_t *
 #endif
 }
 
+static void libsais16_final_bwt_aux_sa_scan_left_to_right_16u_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, fast_sint_t n, sa_sint_t k, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+{
+    SA[induction_bucket[T[(sa_sint_t)n - 1]]++] = ((sa_sint_t)n - 1) | ((sa_sint_t)(T[(sa_sint_t)n - 2] < T[(sa_sint_t)n - 1]) << (SAINT_BIT - 1));
+
+    if ((((sa_sint_t)n - 1) & rm) == 0) { I[((sa_sint_t)n - 1) / (rm + 1)] = induction_bucket[T[(sa_sint_t)n - 1]]; }
+    if (((induction_bucket[T[(sa_sint_t)n - 1]] - 1) & rm) == 0) { S[(induction_bucket[T[(sa_sint_t)n - 1]] - 1) / (rm + 1)] = (sa_sint_t)n - 1; }
+
+    if (threads == 1 || n < 65536)
+    {
+        libsais16_final_bwt_aux_sa_scan_left_to_right_16u(T, SA, rm, I, S, induction_bucket, 0, n);
+    }
+#if defined(LIBSAIS_OPENMP)
+    else
+    {
+        fast_sint_t block_start;
+        for (block_start = 0; block_start < n; )
+        {
+            if (SA[block_start] == 0)
+            {
+                block_start++;
+            }
+            else
+            {
+                if (libsais16_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
+                fast_sint_t block_end     = block_start + 1; while (block_end < block_max_end && SA[block_end] != 0) { block_end++; }
+                fast_sint_t block_size    = block_end - block_start;
+
+                if (block_size < 32)
+                {
+                    for (; block_start < block_end; block_start += 1)
+                    {
+                        sa_sint_t p = SA[block_start]; SA[block_start] = p & SAINT_MAX; if (p > 0) { p--; SA[block_start] = T[p] | SAINT_MIN; sa_sint_t d = induction_bucket[T[p]]++; SA[d] = p | ((sa_sint_t)(T[p - (p > 0)] < T[p]) << (SAINT_BIT - 1)); if ((p & rm) == 0) { I[p / (rm + 1)] = d + 1; } if ((d & rm) == 0) { S[d / (rm + 1)] = p; } }
+                    }
+                }
+                else
+                {
+                    libsais16_final_bwt_aux_sa_scan_left_to_right_16u_block_omp(T, SA, k, rm, I, S, induction_bucket, block_start, block_size, threads, thread_state);
+                    block_start = block_end;
+                }
+            }
+        }
+    }
+#else
+    UNUSED(k); UNUSED(thread_state);
+#endif
+}
+
 static void libsais16_final_sorting_scan_left_to_right_16u_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, fast_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
     SA[induction_bucket[T[(sa_sint_t)n - 1]]++] = ((sa_sint_t)n - 1) | ((sa_sint_t)(T[(sa_sint_t)n - 2] < T[(sa_sint_t)n - 1]) << (SAINT_BIT - 1));
@@ -5074,7 +5569,9 @@ static void libsais16_final_sorting_scan_left_to_right_16u_omp(const uint16_t *
             }
             else
             {
-                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
+                if (libsais16_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
                 fast_sint_t block_end     = block_start + 1; while (block_end < block_max_end && SA[block_end] != 0) { block_end++; }
                 fast_sint_t block_size    = block_end - block_start;
 
@@ -5112,7 +5609,9 @@ static void libsais16_final_sorting_scan_left_to_right_32s_omp(const sa_sint_t *
         fast_sint_t block_start, block_end;
         for (block_start = 0; block_start < n; block_start = block_end)
         {
-            block_end = block_start + (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end > n) { block_end = n; }
+            if (libsais16_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start + (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end > n) { block_end = n; }
 
             libsais16_final_sorting_scan_left_to_right_32s_block_omp(T, SA, induction_bucket, thread_state[0].state.cache, block_start, block_end - block_start, threads);
         }
@@ -5124,7 +5623,7 @@ static void libsais16_final_sorting_scan_left_to_right_32s_omp(const sa_sint_t *
 
 static sa_sint_t libsais16_final_bwt_scan_right_to_left_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j; sa_sint_t index = -1;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
@@ -5152,7 +5651,7 @@ static sa_sint_t libsais16_final_bwt_scan_right_to_left_16u(const uint16_t * RES
 
 static void libsais16_final_bwt_aux_scan_right_to_left_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
@@ -5176,9 +5675,35 @@ static void libsais16_final_bwt_aux_scan_right_to_left_16u(const uint16_t * REST
     }
 }
 
+static void libsais16_final_bwt_aux_sa_scan_right_to_left_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
+    {
+        libsais16_prefetchw(&SA[i - 2 * prefetch_distance]);
+
+        sa_sint_t s0 = SA[i - prefetch_distance - 0]; const uint16_t * Ts0 = &T[s0] - 1; libsais16_prefetchr(s0 > 0 ? Ts0 : NULL); Ts0--; libsais16_prefetchr(s0 > 0 ? Ts0 : NULL);
+        sa_sint_t s1 = SA[i - prefetch_distance - 1]; const uint16_t * Ts1 = &T[s1] - 1; libsais16_prefetchr(s1 > 0 ? Ts1 : NULL); Ts1--; libsais16_prefetchr(s1 > 0 ? Ts1 : NULL);
+
+        sa_sint_t p0 = SA[i - 0];
+        SA[i - 0] = p0 & SAINT_MAX; if (p0 > 0) { p0--; uint16_t c0 = T[p0 - (p0 > 0)], c1 = T[p0]; SA[i - 0] = c1; sa_sint_t t = c0 | SAINT_MIN; sa_sint_t d0 = --induction_bucket[c1]; SA[d0] = (c0 <= c1) ? p0 : t; if ((p0 & rm) == 0) { I[p0 / (rm + 1)] = d0 + 1; } if ((d0 & rm) == 0) { S[d0 / (rm + 1)] = p0; } }
+
+        sa_sint_t p1 = SA[i - 1];
+        SA[i - 1] = p1 & SAINT_MAX; if (p1 > 0) { p1--; uint16_t c0 = T[p1 - (p1 > 0)], c1 = T[p1]; SA[i - 1] = c1; sa_sint_t t = c0 | SAINT_MIN; sa_sint_t d1 = --induction_bucket[c1]; SA[d1] = (c0 <= c1) ? p1 : t; if ((p1 & rm) == 0) { I[p1 / (rm + 1)] = d1 + 1; } if ((d1 & rm) == 0) { S[d1 / (rm + 1)] = p1; } }
+    }
+
+    for (j -= prefetch_distance + 1; i >= j; i -= 1)
+    {
+        sa_sint_t p = SA[i];
+        SA[i] = p & SAINT_MAX; if (p > 0) { p--; uint16_t c0 = T[p - (p > 0)], c1 = T[p]; SA[i] = c1; sa_sint_t t = c0 | SAINT_MIN; sa_sint_t d = --induction_bucket[c1]; SA[d] = (c0 <= c1) ? p : t; if ((p & rm) == 0) { I[p / (rm + 1)] = d + 1; } if ((d & rm) == 0) { S[d / (rm + 1)] = p; } }
+    }
+}
+
 static void libsais16_final_sorting_scan_right_to_left_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
@@ -5200,7 +5725,7 @@ static void libsais16_final_sorting_scan_right_to_left_16u(const uint16_t * REST
 
 static void libsais16_final_sorting_scan_right_to_left_32s(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + 2 * prefetch_distance + 1; i >= j; i -= 2)
@@ -5226,7 +5751,7 @@ static void libsais16_final_sorting_scan_right_to_left_32s(const sa_sint_t * RES
 
 static fast_sint_t libsais16_final_bwt_scan_right_to_left_16u_block_prepare(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-   const fast_sint_t prefetch_distance = 32;
+   const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
    memset(buckets, 0, k * sizeof(sa_sint_t));
 
@@ -5252,7 +5777,7 @@ static fast_sint_t libsais16_final_bwt_scan_right_to_left_16u_block_prepare(cons
 
 static fast_sint_t libsais16_final_bwt_aux_scan_right_to_left_16u_block_prepare(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-   const fast_sint_t prefetch_distance = 32;
+   const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
    memset(buckets, 0, k * sizeof(sa_sint_t));
 
@@ -5278,7 +5803,7 @@ static fast_sint_t libsais16_final_bwt_aux_scan_right_to_left_16u_block_prepare(
 
 static fast_sint_t libsais16_final_sorting_scan_right_to_left_16u_block_prepare(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-   const fast_sint_t prefetch_distance = 32;
+   const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
    memset(buckets, 0, k * sizeof(sa_sint_t));
 
@@ -5304,7 +5829,7 @@ static fast_sint_t libsais16_final_sorting_scan_right_to_left_16u_block_prepare(
 
 static void libsais16_final_order_scan_right_to_left_16u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = 0, j = count - 3; i < j; i += 4)
@@ -5325,7 +5850,7 @@ static void libsais16_final_order_scan_right_to_left_16u_block_place(sa_sint_t *
 
 static void libsais16_final_bwt_aux_scan_right_to_left_16u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = 0, j = count - 6; i < j; i += 8)
@@ -5344,9 +5869,28 @@ static void libsais16_final_bwt_aux_scan_right_to_left_16u_block_place(sa_sint_t
     }
 }
 
+static void libsais16_final_bwt_aux_sa_scan_right_to_left_16u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = 0, j = count - 2; i < j; i += 4)
+    {
+        libsais16_prefetchr(&cache[i + prefetch_distance]);
+
+        sa_sint_t d0 = --buckets[cache[i + 0].symbol]; SA[d0] = cache[i + 0].index; sa_sint_t p0 = cache[i + 1].index; if ((p0 & rm) == 0) { I[p0 / (rm + 1)] = d0 + 1; } if ((d0 & rm) == 0) { S[d0 / (rm + 1)] = p0; }
+        sa_sint_t d1 = --buckets[cache[i + 2].symbol]; SA[d1] = cache[i + 2].index; sa_sint_t p1 = cache[i + 3].index; if ((p1 & rm) == 0) { I[p1 / (rm + 1)] = d1 + 1; } if ((d1 & rm) == 0) { S[d1 / (rm + 1)] = p1; }
+    }
+
+    for (j += 2; i < j; i += 2)
+    {
+        sa_sint_t d = --buckets[cache[i].symbol]; SA[d] = cache[i].index; sa_sint_t p = cache[i + 1].index; if ((p & rm) == 0) { I[p / (rm + 1)] = d + 1; } if ((d & rm) == 0) { S[d / (rm + 1)] = p; }
+    }
+}
+
 static void libsais16_final_sorting_scan_right_to_left_32s_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -5370,7 +5914,7 @@ static void libsais16_final_sorting_scan_right_to_left_32s_block_gather(const sa
 
 static void libsais16_final_sorting_scan_right_to_left_32s_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT induction_bucket, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
@@ -5514,6 +6058,60 @@ static void libsais16_final_bwt_aux_scan_right_to_left_16u_block_omp(const uint1
     }
 }
 
+static void libsais16_final_bwt_aux_sa_scan_right_to_left_16u_block_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT induction_bucket, fast_sint_t block_start, fast_sint_t block_size, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && block_size >= 64 * (k > 256 ? k : 256) && omp_get_dynamic() == 0)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(k); UNUSED(threads); UNUSED(thread_state);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (block_size / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : block_size - omp_block_start;
+
+        omp_block_start += block_start;
+
+        if (omp_num_threads == 1)
+        {
+            libsais16_final_bwt_aux_sa_scan_right_to_left_16u(T, SA, rm, I, S, induction_bucket, omp_block_start, omp_block_size);
+        }
+#if defined(LIBSAIS_OPENMP)
+        else
+        {
+            {
+                thread_state[omp_thread_num].state.count = libsais16_final_bwt_aux_scan_right_to_left_16u_block_prepare(T, SA, k, thread_state[omp_thread_num].state.buckets, thread_state[omp_thread_num].state.cache, omp_block_start, omp_block_size);
+            }
+
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                fast_sint_t t;
+                for (t = omp_num_threads - 1; t >= 0; --t)
+                {
+                    sa_sint_t * RESTRICT temp_bucket = thread_state[t].state.buckets;
+                    fast_sint_t c; for (c = 0; c < k; c += 1) { sa_sint_t A = induction_bucket[c], B = temp_bucket[c]; induction_bucket[c] = A - B; temp_bucket[c] = A; }
+                }
+            }
+
+            #pragma omp barrier
+
+            {
+                libsais16_final_bwt_aux_sa_scan_right_to_left_16u_block_place(SA, rm, I, S, thread_state[omp_thread_num].state.buckets, thread_state[omp_thread_num].state.cache, thread_state[omp_thread_num].state.count);
+            }
+        }
+#endif
+    }
+}
+
 static void libsais16_final_sorting_scan_right_to_left_16u_block_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT induction_bucket, fast_sint_t block_start, fast_sint_t block_size, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
 #if defined(LIBSAIS_OPENMP)
@@ -5639,7 +6237,9 @@ static sa_sint_t libsais16_final_bwt_scan_right_to_left_16u_omp(const uint16_t *
             }
             else
             {
-                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end < 0) { block_max_end = -1; }
+                if (libsais16_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end < 0) { block_max_end = -1; }
                 fast_sint_t block_end     = block_start - 1; while (block_end > block_max_end && SA[block_end] != 0) { block_end--; }
                 fast_sint_t block_size    = block_start - block_end;
 
@@ -5683,7 +6283,9 @@ static void libsais16_final_bwt_aux_scan_right_to_left_16u_omp(const uint16_t *
             }
             else
             {
-                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * ((LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads) / 2); if (block_max_end < 0) { block_max_end = -1; }
+                if (libsais16_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * ((thread_state[0].state.cache_size - 16 * (fast_sint_t)threads) / 2); if (block_max_end < 0) { block_max_end = -1; }
                 fast_sint_t block_end     = block_start - 1; while (block_end > block_max_end && SA[block_end] != 0) { block_end--; }
                 fast_sint_t block_size    = block_start - block_end;
 
@@ -5707,6 +6309,50 @@ static void libsais16_final_bwt_aux_scan_right_to_left_16u_omp(const uint16_t *
 #endif
 }
 
+static void libsais16_final_bwt_aux_sa_scan_right_to_left_16u_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+{
+    if (threads == 1 || n < 65536)
+    {
+        libsais16_final_bwt_aux_sa_scan_right_to_left_16u(T, SA, rm, I, S, induction_bucket, 0, n);
+    }
+#if defined(LIBSAIS_OPENMP)
+    else
+    {
+        fast_sint_t block_start;
+        for (block_start = (fast_sint_t)n - 1; block_start >= 0; )
+        {
+            if (SA[block_start] == 0)
+            {
+                block_start--;
+            }
+            else
+            {
+                if (libsais16_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * ((thread_state[0].state.cache_size - 16 * (fast_sint_t)threads) / 2); if (block_max_end < 0) { block_max_end = -1; }
+                fast_sint_t block_end     = block_start - 1; while (block_end > block_max_end && SA[block_end] != 0) { block_end--; }
+                fast_sint_t block_size    = block_start - block_end;
+
+                if (block_size < 32)
+                {
+                    for (; block_start > block_end; block_start -= 1)
+                    {
+                        sa_sint_t p = SA[block_start]; SA[block_start] = p & SAINT_MAX; if (p > 0) { p--; uint16_t c0 = T[p - (p > 0)], c1 = T[p]; SA[block_start] = c1; sa_sint_t t = c0 | SAINT_MIN; sa_sint_t d = --induction_bucket[c1]; SA[d] = (c0 <= c1) ? p : t; if ((p & rm) == 0) { I[p / (rm + 1)] = d + 1; } if ((d & rm) == 0) { S[d / (rm + 1)] = p; } }
+                    }
+                }
+                else
+                {
+                    libsais16_final_bwt_aux_sa_scan_right_to_left_16u_block_omp(T, SA, k, rm, I, S, induction_bucket, block_end + 1, block_size, threads, thread_state);
+                    block_start = block_end;
+                }
+            }
+        }
+    }
+#else
+    UNUSED(k); UNUSED(thread_state);
+#endif
+}
+
 static void libsais16_final_sorting_scan_right_to_left_16u_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
     if (threads == 1 || n < 65536)
@@ -5725,7 +6371,9 @@ static void libsais16_final_sorting_scan_right_to_left_16u_omp(const uint16_t *
             }
             else
             {
-                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end < -1) { block_max_end = -1; }
+                if (libsais16_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end < -1) { block_max_end = -1; }
                 fast_sint_t block_end     = block_start - 1; while (block_end > block_max_end && SA[block_end] != 0) { block_end--; }
                 fast_sint_t block_size    = block_start - block_end;
 
@@ -5761,7 +6409,9 @@ static void libsais16_final_sorting_scan_right_to_left_32s_omp(const sa_sint_t *
         fast_sint_t block_start, block_end;
         for (block_start = (fast_sint_t)n - 1; block_start >= 0; block_start = block_end)
         {
-            block_end = block_start - (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end < 0) { block_end = -1; }
+            if (libsais16_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start - (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end < 0) { block_end = -1; }
 
             libsais16_final_sorting_scan_right_to_left_32s_block_omp(T, SA, induction_bucket, thread_state[0].state.cache, block_end + 1, block_start - block_end, threads);
         }
@@ -5789,7 +6439,7 @@ static void libsais16_clear_lms_suffixes_omp(sa_sint_t * RESTRICT SA, sa_sint_t
     }
 }
 
-static sa_sint_t libsais16_induce_final_order_16u_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t bwt, sa_sint_t r, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT buckets, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+static sa_sint_t libsais16_induce_final_order_16u_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t bwt, sa_sint_t r, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT buckets, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
     if (!bwt)
     {
@@ -5798,6 +6448,13 @@ static sa_sint_t libsais16_induce_final_order_16u_omp(const uint16_t * RESTRICT
         libsais16_final_sorting_scan_right_to_left_16u_omp(T, SA, n, k, &buckets[7 * ALPHABET_SIZE], threads, thread_state);
         return 0;
     }
+    else if (S != NULL)
+    {
+        libsais16_final_bwt_aux_sa_scan_left_to_right_16u_omp(T, SA, n, k, r - 1, I, S, &buckets[6 * ALPHABET_SIZE], threads, thread_state);
+        if (threads > 1 && n >= 65536) { libsais16_clear_lms_suffixes_omp(SA, n, ALPHABET_SIZE, &buckets[6 * ALPHABET_SIZE], &buckets[7 * ALPHABET_SIZE], threads); }
+        libsais16_final_bwt_aux_sa_scan_right_to_left_16u_omp(T, SA, n, k, r - 1, I, S, &buckets[7 * ALPHABET_SIZE], threads, thread_state);
+        return 0;
+    }
     else if (I != NULL)
     {
         libsais16_final_bwt_aux_scan_left_to_right_16u_omp(T, SA, n, k, r - 1, I, &buckets[6 * ALPHABET_SIZE], threads, thread_state);
@@ -5844,7 +6501,7 @@ static void libsais16_induce_final_order_32s_1k(const sa_sint_t * RESTRICT T, sa
 
 static sa_sint_t libsais16_renumber_unique_and_nonunique_lms_suffixes_32s(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t m, sa_sint_t f, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAm = &SA[m];
 
@@ -5879,7 +6536,7 @@ static sa_sint_t libsais16_renumber_unique_and_nonunique_lms_suffixes_32s(sa_sin
 
 static void libsais16_compact_unique_and_nonunique_lms_suffixes_32s(sa_sint_t * RESTRICT SA, sa_sint_t m, fast_sint_t * pl, fast_sint_t * pr, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAl = &SA[0];
     sa_sint_t * RESTRICT SAr = &SA[0];
@@ -5908,7 +6565,7 @@ static void libsais16_compact_unique_and_nonunique_lms_suffixes_32s(sa_sint_t *
 
 static sa_sint_t libsais16_count_unique_suffixes(sa_sint_t * RESTRICT SA, sa_sint_t m, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAm = &SA[m];
 
@@ -6068,7 +6725,7 @@ static sa_sint_t libsais16_compact_lms_suffixes_32s_omp(sa_sint_t * RESTRICT T,
 
 static void libsais16_merge_unique_lms_suffixes_32s(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t m, fast_sint_t l, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     const sa_sint_t * RESTRICT SAnm = &SA[(fast_sint_t)n - (fast_sint_t)m - 1 + l];
 
@@ -6091,7 +6748,7 @@ static void libsais16_merge_unique_lms_suffixes_32s(sa_sint_t * RESTRICT T, sa_s
 
 static void libsais16_merge_nonunique_lms_suffixes_32s(sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t m, fast_sint_t l, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     const sa_sint_t * RESTRICT SAnm = &SA[(fast_sint_t)n - (fast_sint_t)m - 1 + l];
 
@@ -6244,32 +6901,58 @@ static void libsais16_reconstruct_compacted_lms_suffixes_32s_1k_omp(sa_sint_t *
     }
 }
 
-static sa_sint_t libsais16_main_32s_recursion(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t * RESTRICT local_buffer)
+static sa_sint_t libsais16_adaptive_threads(const LIBSAIS_MONITOR * monitor, sa_sint_t threads, sa_sint_t n, sa_sint_t k)
+{
+    if (monitor == NULL || monitor->thread_block_size <= 0) { return threads; }
+
+    fast_sint_t block_size  = (fast_sint_t)k * 16 > (fast_sint_t)monitor->thread_block_size ? (fast_sint_t)k * 16 : (fast_sint_t)monitor->thread_block_size;
+    fast_sint_t max_threads = (fast_sint_t)n / block_size;
+
+    return max_threads < (fast_sint_t)threads ? (max_threads > 1 ? (sa_sint_t)max_threads : 1) : threads;
+}
+
+static sa_sint_t libsais16_main_32s_recursion(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t * RESTRICT local_buffer, sa_sint_t local_buffer_size, const LIBSAIS_ALLOCATOR * allocator, LIBSAIS_MONITOR * monitor, sa_sint_t depth)
 {
     fs = fs < (SAINT_MAX - n) ? fs : (SAINT_MAX - n);
+    threads = libsais16_adaptive_threads(monitor, threads, n, k);
 
-    if (k > 0 && ((fs / k >= 6) || (LIBSAIS_LOCAL_BUFFER_SIZE / k >= 6 && threads == 1)))
+    if (libsais16_cancelled(monitor)) { return -5; }
+
+    if (k > 0 && ((fs / k >= 6) || (local_buffer_size / k >= 6 && threads == 1)))
     {
         sa_sint_t alignment = (fs - 1024) / k >= 6 ? (sa_sint_t)1024 : (sa_sint_t)16;
         sa_sint_t * RESTRICT buckets = (fs - alignment) / k >= 6 ? (sa_sint_t *)libsais16_align_up(&SA[n + fs - 6 * (fast_sint_t)k - alignment], (size_t)alignment * sizeof(sa_sint_t)) : &SA[n + fs - 6 * (fast_sint_t)k];
-        buckets = (LIBSAIS_LOCAL_BUFFER_SIZE / k >= 6 && threads == 1) ? local_buffer : buckets;
+        buckets = (local_buffer_size / k >= 6 && threads == 1) ? local_buffer : buckets;
+
+        sa_sint_t flags = LIBSAIS16_PROFILE_6K | (buckets == local_buffer ? LIBSAIS16_PROFILE_LOCAL_BUFFER : LIBSAIS16_PROFILE_FREE_SPACE);
+        libsais16_profile(monitor, LIBSAIS16_PHASE_LEVEL, 0, depth, n, k, flags);
 
+        libsais16_profile(monitor, LIBSAIS16_PHASE_GATHER, 0, depth, n, k, flags);
         sa_sint_t m = libsais16_count_and_gather_lms_suffixes_32s_4k_omp(T, SA, n, k, buckets, threads, thread_state);
+        libsais16_profile(monitor, LIBSAIS16_PHASE_GATHER, 1, depth, n, k, flags);
+
         if (m > 1)
         {
+            libsais16_profile(monitor, LIBSAIS16_PHASE_RADIX_SORT, 0, depth, n, k, flags);
             memset(SA, 0, ((size_t)n - (size_t)m) * sizeof(sa_sint_t));
 
             sa_sint_t first_lms_suffix    = SA[n - m];
             sa_sint_t left_suffixes_count = libsais16_initialize_buckets_for_lms_suffixes_radix_sort_32s_6k(T, k, buckets, first_lms_suffix);
 
-            libsais16_radix_sort_lms_suffixes_32s_6k_omp(T, SA, n, m, &buckets[4 * (fast_sint_t)k], threads, thread_state);
+            libsais16_radix_sort_lms_suffixes_32s_6k_omp(T, SA, n, m, &buckets[4 * (fast_sint_t)k], libsais16_adaptive_threads(monitor, threads, m, k), thread_state);
 
             if ((n / 8192) < k) { libsais16_radix_sort_set_markers_32s_6k_omp(SA, k, &buckets[4 * (fast_sint_t)k], threads); }
             if (threads > 1 && n >= 65536) { memset(&SA[(fast_sint_t)n - (fast_sint_t)m], 0, (size_t)m * sizeof(sa_sint_t)); }
+            libsais16_profile(monitor, LIBSAIS16_PHASE_RADIX_SORT, 1, depth, n, k, flags);
+            if (libsais16_cancelled(monitor)) { return -5; }
 
+            libsais16_profile(monitor, LIBSAIS16_PHASE_PARTIAL_SORT, 0, depth, n, k, flags);
             libsais16_initialize_buckets_for_partial_sorting_32s_6k(T, k, buckets, first_lms_suffix, left_suffixes_count);
             libsais16_induce_partial_order_32s_6k_omp(T, SA, n, k, buckets, first_lms_suffix, left_suffixes_count, threads, thread_state);
+            libsais16_profile(monitor, LIBSAIS16_PHASE_PARTIAL_SORT, 1, depth, n, k, flags);
+            if (libsais16_cancelled(monitor)) { return -5; }
 
+            libsais16_profile(monitor, LIBSAIS16_PHASE_RENUMBER, 0, depth, n, k, flags);
             sa_sint_t names = (n / 8192) < k
                 ? libsais16_renumber_and_mark_distinct_lms_suffixes_32s_4k_omp(SA, n, m, threads, thread_state)
                 : libsais16_renumber_and_gather_lms_suffixes_omp(SA, n, m, fs, threads, thread_state);
@@ -6279,65 +6962,95 @@ static sa_sint_t libsais16_main_32s_recursion(sa_sint_t * RESTRICT T, sa_sint_t
                 sa_sint_t f = (n / 8192) < k
                     ? libsais16_compact_lms_suffixes_32s_omp(T, SA, n, m, fs, threads, thread_state)
                     : 0;
+                libsais16_profile(monitor, LIBSAIS16_PHASE_RENUMBER, 1, depth, m, names, flags);
 
-                if (libsais16_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer) != 0)
+                sa_sint_t status = libsais16_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer, local_buffer_size, allocator, monitor, depth + 1);
+                if (status != 0)
                 {
-                    return -2;
+                    return status;
                 }
 
+                libsais16_profile(monitor, LIBSAIS16_PHASE_RECONSTRUCT, 0, depth, n, k, flags);
                 libsais16_reconstruct_compacted_lms_suffixes_32s_2k_omp(T, SA, n, k, m, fs, f, buckets, threads, thread_state);
+                libsais16_profile(monitor, LIBSAIS16_PHASE_RECONSTRUCT, 1, depth, n, k, flags);
             }
             else
             {
+                libsais16_profile(monitor, LIBSAIS16_PHASE_RENUMBER, 1, depth, m, names, flags);
                 libsais16_count_lms_suffixes_32s_2k(T, n, k, buckets);
             }
 
+            libsais16_profile(monitor, LIBSAIS16_PHASE_FINAL_SORT, 0, depth, n, k, flags);
             libsais16_initialize_buckets_start_and_end_32s_4k(k, buckets);
             libsais16_place_lms_suffixes_histogram_32s_4k(SA, n, k, m, buckets);
             libsais16_induce_final_order_32s_4k(T, SA, n, k, buckets, threads, thread_state);
+            libsais16_profile(monitor, LIBSAIS16_PHASE_FINAL_SORT, 1, depth, n, k, flags);
+            if (libsais16_cancelled(monitor)) { return -5; }
         }
         else
         {
+            libsais16_profile(monitor, LIBSAIS16_PHASE_FINAL_SORT, 0, depth, n, k, flags);
             SA[0] = SA[n - 1];
 
             libsais16_initialize_buckets_start_and_end_32s_6k(k, buckets);
             libsais16_place_lms_suffixes_histogram_32s_6k(SA, n, k, m, buckets);
             libsais16_induce_final_order_32s_6k(T, SA, n, k, buckets, threads, thread_state);
+            libsais16_profile(monitor, LIBSAIS16_PHASE_FINAL_SORT, 1, depth, n, k, flags);
+            if (libsais16_cancelled(monitor)) { return -5; }
         }
 
+        libsais16_profile(monitor, LIBSAIS16_PHASE_LEVEL, 1, depth, n, k, flags);
         return 0;
     }
-    else if (k > 0 && (n <= SAINT_MAX / 2) && ((fs / k >= 4) || (LIBSAIS_LOCAL_BUFFER_SIZE / k >= 4 && threads == 1)))
+    else if (k > 0 && (n <= SAINT_MAX / 2) && ((fs / k >= 4) || (local_buffer_size / k >= 4 && threads == 1)))
     {
         sa_sint_t alignment = (fs - 1024) / k >= 4 ? (sa_sint_t)1024 : (sa_sint_t)16;
         sa_sint_t * RESTRICT buckets = (fs - alignment) / k >= 4 ? (sa_sint_t *)libsais16_align_up(&SA[n + fs - 4 * (fast_sint_t)k - alignment], (size_t)alignment * sizeof(sa_sint_t)) : &SA[n + fs - 4 * (fast_sint_t)k];
-        buckets = (LIBSAIS_LOCAL_BUFFER_SIZE / k >= 4 && threads == 1) ? local_buffer : buckets;
+        buckets = (local_buffer_size / k >= 4 && threads == 1) ? local_buffer : buckets;
+
+        sa_sint_t flags = LIBSAIS16_PROFILE_4K | (buckets == local_buffer ? LIBSAIS16_PROFILE_LOCAL_BUFFER : LIBSAIS16_PROFILE_FREE_SPACE);
+        libsais16_profile(monitor, LIBSAIS16_PHASE_LEVEL, 0, depth, n, k, flags);
 
+        libsais16_profile(monitor, LIBSAIS16_PHASE_GATHER, 0, depth, n, k, flags);
         sa_sint_t m = libsais16_count_and_gather_lms_suffixes_32s_2k_omp(T, SA, n, k, buckets, threads, thread_state);
+        libsais16_profile(monitor, LIBSAIS16_PHASE_GATHER, 1, depth, n, k, flags);
+
         if (m > 1)
         {
+            libsais16_profile(monitor, LIBSAIS16_PHASE_RADIX_SORT, 0, depth, n, k, flags);
             libsais16_initialize_buckets_for_radix_and_partial_sorting_32s_4k(T, k, buckets, SA[n - m]);
 
-            libsais16_radix_sort_lms_suffixes_32s_2k_omp(T, SA, n, m, &buckets[1], threads, thread_state);
+            libsais16_radix_sort_lms_suffixes_32s_2k_omp(T, SA, n, m, &buckets[1], libsais16_adaptive_threads(monitor, threads, m, k), thread_state);
             libsais16_radix_sort_set_markers_32s_4k_omp(SA, k, &buckets[1], threads);
+            libsais16_profile(monitor, LIBSAIS16_PHASE_RADIX_SORT, 1, depth, n, k, flags);
+            if (libsais16_cancelled(monitor)) { return -5; }
             
+            libsais16_profile(monitor, LIBSAIS16_PHASE_PARTIAL_SORT, 0, depth, n, k, flags);
             libsais16_place_lms_suffixes_interval_32s_4k(SA, n, k, m - 1, buckets);
             libsais16_induce_partial_order_32s_4k_omp(T, SA, n, k, buckets, threads, thread_state);
+            libsais16_profile(monitor, LIBSAIS16_PHASE_PARTIAL_SORT, 1, depth, n, k, flags);
+            if (libsais16_cancelled(monitor)) { return -5; }
 
+            libsais16_profile(monitor, LIBSAIS16_PHASE_RENUMBER, 0, depth, n, k, flags);
             sa_sint_t names = libsais16_renumber_and_mark_distinct_lms_suffixes_32s_4k_omp(SA, n, m, threads, thread_state);
             if (names < m)
             {
                 sa_sint_t f = libsais16_compact_lms_suffixes_32s_omp(T, SA, n, m, fs, threads, thread_state);
+                libsais16_profile(monitor, LIBSAIS16_PHASE_RENUMBER, 1, depth, m, names, flags);
 
-                if (libsais16_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer) != 0)
+                sa_sint_t status = libsais16_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer, local_buffer_size, allocator, monitor, depth + 1);
+                if (status != 0)
                 {
-                    return -2;
+                    return status;
                 }
 
+                libsais16_profile(monitor, LIBSAIS16_PHASE_RECONSTRUCT, 0, depth, n, k, flags);
                 libsais16_reconstruct_compacted_lms_suffixes_32s_2k_omp(T, SA, n, k, m, fs, f, buckets, threads, thread_state);
+                libsais16_profile(monitor, LIBSAIS16_PHASE_RECONSTRUCT, 1, depth, n, k, flags);
             }
             else
             {
+                libsais16_profile(monitor, LIBSAIS16_PHASE_RENUMBER, 1, depth, m, names, flags);
                 libsais16_count_lms_suffixes_32s_2k(T, n, k, buckets);
             }
         }
@@ -6346,43 +7059,65 @@ static sa_sint_t libsais16_main_32s_recursion(sa_sint_t * RESTRICT T, sa_sint_t
             SA[0] = SA[n - 1];
         }
 
+        libsais16_profile(monitor, LIBSAIS16_PHASE_FINAL_SORT, 0, depth, n, k, flags);
         libsais16_initialize_buckets_start_and_end_32s_4k(k, buckets);
         libsais16_place_lms_suffixes_histogram_32s_4k(SA, n, k, m, buckets);
         libsais16_induce_final_order_32s_4k(T, SA, n, k, buckets, threads, thread_state);
+        libsais16_profile(monitor, LIBSAIS16_PHASE_FINAL_SORT, 1, depth, n, k, flags);
+        if (libsais16_cancelled(monitor)) { return -5; }
 
+        libsais16_profile(monitor, LIBSAIS16_PHASE_LEVEL, 1, depth, n, k, flags);
         return 0;
     }
-    else if (k > 0 && ((fs / k >= 2) || (LIBSAIS_LOCAL_BUFFER_SIZE / k >= 2 && threads == 1)))
+    else if (k > 0 && ((fs / k >= 2) || (local_buffer_size / k >= 2 && threads == 1)))
     {
         sa_sint_t alignment = (fs - 1024) / k >= 2 ? (sa_sint_t)1024 : (sa_sint_t)16;
         sa_sint_t * RESTRICT buckets = (fs - alignment) / k >= 2 ? (sa_sint_t *)libsais16_align_up(&SA[n + fs - 2 * (fast_sint_t)k - alignment], (size_t)alignment * sizeof(sa_sint_t)) : &SA[n + fs - 2 * (fast_sint_t)k];
-        buckets = (LIBSAIS_LOCAL_BUFFER_SIZE / k >= 2 && threads == 1) ? local_buffer : buckets;
+        buckets = (local_buffer_size / k >= 2 && threads == 1) ? local_buffer : buckets;
+
+        sa_sint_t flags = LIBSAIS16_PROFILE_2K | (buckets == local_buffer ? LIBSAIS16_PROFILE_LOCAL_BUFFER : LIBSAIS16_PROFILE_FREE_SPACE);
+        libsais16_profile(monitor, LIBSAIS16_PHASE_LEVEL, 0, depth, n, k, flags);
 
+        libsais16_profile(monitor, LIBSAIS16_PHASE_GATHER, 0, depth, n, k, flags);
         sa_sint_t m = libsais16_count_and_gather_lms_suffixes_32s_2k_omp(T, SA, n, k, buckets, threads, thread_state);
+        libsais16_profile(monitor, LIBSAIS16_PHASE_GATHER, 1, depth, n, k, flags);
+
         if (m > 1)
         {
+            libsais16_profile(monitor, LIBSAIS16_PHASE_RADIX_SORT, 0, depth, n, k, flags);
             libsais16_initialize_buckets_for_lms_suffixes_radix_sort_32s_2k(T, k, buckets, SA[n - m]);
 
-            libsais16_radix_sort_lms_suffixes_32s_2k_omp(T, SA, n, m, &buckets[1], threads, thread_state);
+            libsais16_radix_sort_lms_suffixes_32s_2k_omp(T, SA, n, m, &buckets[1], libsais16_adaptive_threads(monitor, threads, m, k), thread_state);
             libsais16_place_lms_suffixes_interval_32s_2k(SA, n, k, m - 1, buckets);
+            libsais16_profile(monitor, LIBSAIS16_PHASE_RADIX_SORT, 1, depth, n, k, flags);
+            if (libsais16_cancelled(monitor)) { return -5; }
 
+            libsais16_profile(monitor, LIBSAIS16_PHASE_PARTIAL_SORT, 0, depth, n, k, flags);
             libsais16_initialize_buckets_start_and_end_32s_2k(k, buckets);
             libsais16_induce_partial_order_32s_2k_omp(T, SA, n, k, buckets, threads, thread_state);
+            libsais16_profile(monitor, LIBSAIS16_PHASE_PARTIAL_SORT, 1, depth, n, k, flags);
+            if (libsais16_cancelled(monitor)) { return -5; }
 
+            libsais16_profile(monitor, LIBSAIS16_PHASE_RENUMBER, 0, depth, n, k, flags);
             sa_sint_t names = libsais16_renumber_and_mark_distinct_lms_suffixes_32s_1k_omp(T, SA, n, m, threads);
             if (names < m)
             {
                 sa_sint_t f = libsais16_compact_lms_suffixes_32s_omp(T, SA, n, m, fs, threads, thread_state);
+                libsais16_profile(monitor, LIBSAIS16_PHASE_RENUMBER, 1, depth, m, names, flags);
 
-                if (libsais16_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer) != 0)
+                sa_sint_t status = libsais16_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer, local_buffer_size, allocator, monitor, depth + 1);
+                if (status != 0)
                 {
-                    return -2;
+                    return status;
                 }
 
+                libsais16_profile(monitor, LIBSAIS16_PHASE_RECONSTRUCT, 0, depth, n, k, flags);
                 libsais16_reconstruct_compacted_lms_suffixes_32s_2k_omp(T, SA, n, k, m, fs, f, buckets, threads, thread_state);
+                libsais16_profile(monitor, LIBSAIS16_PHASE_RECONSTRUCT, 1, depth, n, k, flags);
             }
             else
             {
+                libsais16_profile(monitor, LIBSAIS16_PHASE_RENUMBER, 1, depth, m, names, flags);
                 libsais16_count_lms_suffixes_32s_2k(T, n, k, buckets);
             }
         }
@@ -6391,149 +7126,480 @@ static sa_sint_t libsais16_main_32s_recursion(sa_sint_t * RESTRICT T, sa_sint_t
             SA[0] = SA[n - 1];
         }
 
+        libsais16_profile(monitor, LIBSAIS16_PHASE_FINAL_SORT, 0, depth, n, k, flags);
         libsais16_initialize_buckets_end_32s_2k(k, buckets);
         libsais16_place_lms_suffixes_histogram_32s_2k(SA, n, k, m, buckets);
 
         libsais16_initialize_buckets_start_and_end_32s_2k(k, buckets);
         libsais16_induce_final_order_32s_2k(T, SA, n, k, buckets, threads, thread_state);
+        libsais16_profile(monitor, LIBSAIS16_PHASE_FINAL_SORT, 1, depth, n, k, flags);
+        if (libsais16_cancelled(monitor)) { return -5; }
 
+        libsais16_profile(monitor, LIBSAIS16_PHASE_LEVEL, 1, depth, n, k, flags);
         return 0;
     }
     else
     {
-        sa_sint_t * buffer = fs < k ? (sa_sint_t *)libsais16_alloc_aligned((size_t)k * sizeof(sa_sint_t), 4096) : (sa_sint_t *)NULL;
+        sa_sint_t * buffer = fs < k ? (sa_sint_t *)libsais16_alloc_memory(allocator, (size_t)k * sizeof(sa_sint_t), 4096) : (sa_sint_t *)NULL;
 
         sa_sint_t alignment = fs - 1024 >= k ? (sa_sint_t)1024 : (sa_sint_t)16;
         sa_sint_t * RESTRICT buckets = fs - alignment >= k ? (sa_sint_t *)libsais16_align_up(&SA[n + fs - k - alignment], (size_t)alignment * sizeof(sa_sint_t)) : fs >= k ? &SA[n + fs - k] : buffer;
 
         if (buckets == NULL) { return -2; }
 
+        sa_sint_t flags = LIBSAIS16_PROFILE_1K | (buffer != NULL ? LIBSAIS16_PROFILE_ALLOCATION : LIBSAIS16_PROFILE_FREE_SPACE);
+        libsais16_profile(monitor, LIBSAIS16_PHASE_LEVEL, 0, depth, n, k, flags);
+
+        libsais16_profile(monitor, LIBSAIS16_PHASE_GATHER, 0, depth, n, k, flags);
         memset(SA, 0, (size_t)n * sizeof(sa_sint_t));
 
         libsais16_count_suffixes_32s(T, n, k, buckets); 
         libsais16_initialize_buckets_end_32s_1k(k, buckets);
+        libsais16_profile(monitor, LIBSAIS16_PHASE_GATHER, 1, depth, n, k, flags);
 
+        libsais16_profile(monitor, LIBSAIS16_PHASE_RADIX_SORT, 0, depth, n, k, flags);
         sa_sint_t m = libsais16_radix_sort_lms_suffixes_32s_1k(T, SA, n, buckets);
+        libsais16_profile(monitor, LIBSAIS16_PHASE_RADIX_SORT, 1, depth, n, k, flags);
+        if (libsais16_cancelled(monitor)) { libsais16_free_memory(allocator, buffer); return -5; }
+
         if (m > 1)
         {
+            libsais16_profile(monitor, LIBSAIS16_PHASE_PARTIAL_SORT, 0, depth, n, k, flags);
             libsais16_induce_partial_order_32s_1k_omp(T, SA, n, k, buckets, threads, thread_state);
+            libsais16_profile(monitor, LIBSAIS16_PHASE_PARTIAL_SORT, 1, depth, n, k, flags);
+            if (libsais16_cancelled(monitor)) { libsais16_free_memory(allocator, buffer); return -5; }
 
+            libsais16_profile(monitor, LIBSAIS16_PHASE_RENUMBER, 0, depth, n, k, flags);
             sa_sint_t names = libsais16_renumber_and_mark_distinct_lms_suffixes_32s_1k_omp(T, SA, n, m, threads);
             if (names < m)
             {
-                if (buffer != NULL) { libsais16_free_aligned(buffer); buckets = NULL; }
+                if (buffer != NULL) { libsais16_free_memory(allocator, buffer); buckets = NULL; }
 
                 sa_sint_t f = libsais16_compact_lms_suffixes_32s_omp(T, SA, n, m, fs, threads, thread_state);
+                libsais16_profile(monitor, LIBSAIS16_PHASE_RENUMBER, 1, depth, m, names, flags);
 
-                if (libsais16_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer) != 0)
+                sa_sint_t status = libsais16_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer, local_buffer_size, allocator, monitor, depth + 1);
+                if (status != 0)
                 {
-                    return -2;
+                    return status;
                 }
 
+                libsais16_profile(monitor, LIBSAIS16_PHASE_RECONSTRUCT, 0, depth, n, k, flags);
                 libsais16_reconstruct_compacted_lms_suffixes_32s_1k_omp(T, SA, n, m, fs, f, threads, thread_state);
+                libsais16_profile(monitor, LIBSAIS16_PHASE_RECONSTRUCT, 1, depth, n, k, flags);
 
-                if (buckets == NULL) { buckets = buffer = (sa_sint_t *)libsais16_alloc_aligned((size_t)k * sizeof(sa_sint_t), 4096); }
+                if (buckets == NULL) { buckets = buffer = (sa_sint_t *)libsais16_alloc_memory(allocator, (size_t)k * sizeof(sa_sint_t), 4096); }
                 if (buckets == NULL) { return -2; }
             }
+            else
+            {
+                libsais16_profile(monitor, LIBSAIS16_PHASE_RENUMBER, 1, depth, m, names, flags);
+            }
             
+            libsais16_profile(monitor, LIBSAIS16_PHASE_FINAL_SORT, 0, depth, n, k, flags);
             libsais16_count_suffixes_32s(T, n, k, buckets);
             libsais16_initialize_buckets_end_32s_1k(k, buckets);
             libsais16_place_lms_suffixes_interval_32s_1k(T, SA, k, m, buckets);
         }
+        else
+        {
+            libsais16_profile(monitor, LIBSAIS16_PHASE_FINAL_SORT, 0, depth, n, k, flags);
+        }
 
         libsais16_induce_final_order_32s_1k(T, SA, n, k, buckets, threads, thread_state);
-        libsais16_free_aligned(buffer);
+        libsais16_free_memory(allocator, buffer);
+        libsais16_profile(monitor, LIBSAIS16_PHASE_FINAL_SORT, 1, depth, n, k, flags);
+        if (libsais16_cancelled(monitor)) { return -5; }
 
+        libsais16_profile(monitor, LIBSAIS16_PHASE_LEVEL, 1, depth, n, k, flags);
         return 0;
     }
 }
 
-static sa_sint_t libsais16_main_32s_entry(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+static sa_sint_t libsais16_main_32s_entry(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t * RESTRICT local_buffer, sa_sint_t local_buffer_size, const LIBSAIS_ALLOCATOR * allocator, LIBSAIS_MONITOR * monitor, sa_sint_t depth)
+{
+    sa_sint_t stack_buffer[LIBSAIS_LOCAL_BUFFER_SIZE];
+
+    if (thread_state != NULL) { thread_state[0].state.monitor = monitor; }
+
+    return libsais16_main_32s_recursion(T, SA, n, k, fs, threads, thread_state, local_buffer != NULL ? local_buffer : stack_buffer, local_buffer_size, allocator, monitor, depth);
+}
+
+static void libsais16_mark_alphabet_32s(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i; for (i = omp_block_start; i < omp_block_start + omp_block_size; i += 1) { SA[T[i]] = SAINT_MIN; }
+}
+
+static void libsais16_mark_alphabet_32s_omp(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_block_start   = 0;
+        fast_sint_t omp_block_size    = n;
+#endif
+
+        libsais16_mark_alphabet_32s(T, SA, omp_block_start, omp_block_size);
+    }
+}
+
+static sa_sint_t libsais16_rank_alphabet_32s(sa_sint_t * RESTRICT SA, sa_sint_t k)
+{
+    sa_sint_t d = 0;
+
+    fast_sint_t c; for (c = 0; c < (fast_sint_t)k; c += 1) { if (SA[c] < 0) { SA[c] = d++ | SAINT_MIN; } }
+
+    return d;
+}
+
+static void libsais16_unrank_alphabet_32s(const sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT alphabet)
+{
+    fast_sint_t c; for (c = 0; c < (fast_sint_t)k; c += 1) { if (SA[c] < 0) { alphabet[SA[c] & SAINT_MAX] = (sa_sint_t)c; } }
+}
+
+static void libsais16_remap_alphabet_32s(sa_sint_t * RESTRICT T, const sa_sint_t * RESTRICT map, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
+    {
+        libsais16_prefetchw(&T[i + 2 * prefetch_distance]);
+
+        libsais16_prefetchr(&map[T[i + prefetch_distance + 0]]);
+        libsais16_prefetchr(&map[T[i + prefetch_distance + 1]]);
+        libsais16_prefetchr(&map[T[i + prefetch_distance + 2]]);
+        libsais16_prefetchr(&map[T[i + prefetch_distance + 3]]);
+
+        T[i + 0] = map[T[i + 0]] & SAINT_MAX;
+        T[i + 1] = map[T[i + 1]] & SAINT_MAX;
+        T[i + 2] = map[T[i + 2]] & SAINT_MAX;
+        T[i + 3] = map[T[i + 3]] & SAINT_MAX;
+    }
+
+    for (j += prefetch_distance + 3; i < j; i += 1)
+    {
+        T[i] = map[T[i]] & SAINT_MAX;
+    }
+}
+
+static void libsais16_remap_alphabet_32s_omp(sa_sint_t * RESTRICT T, sa_sint_t n, const sa_sint_t * RESTRICT map, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_block_start   = 0;
+        fast_sint_t omp_block_size    = n;
+#endif
+
+        libsais16_remap_alphabet_32s(T, map, omp_block_start, omp_block_size);
+    }
+}
+
+static sa_sint_t libsais16_main_32s_compact(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t * RESTRICT local_buffer, sa_sint_t local_buffer_size, const LIBSAIS_ALLOCATOR * allocator, LIBSAIS_MONITOR * monitor)
+{
+    fs = fs < (SAINT_MAX - n) ? fs : (SAINT_MAX - n);
+
+    if (k > 0 && fs / k < 6)
+    {
+        sa_sint_t * RESTRICT buffer = k > n + fs ? (sa_sint_t *)libsais16_alloc_memory(allocator, (size_t)k * sizeof(sa_sint_t), 4096) : NULL;
+        sa_sint_t * RESTRICT ranks  = k > n + fs ? buffer : SA;
+
+        if (ranks != NULL)
+        {
+            memset(ranks, 0, (size_t)k * sizeof(sa_sint_t));
+            libsais16_mark_alphabet_32s_omp(T, ranks, n, threads);
+
+            sa_sint_t d = libsais16_rank_alphabet_32s(ranks, k);
+            if (d + d <= k || fs / d > fs / k)
+            {
+                sa_sint_t * RESTRICT alphabet = buffer != NULL ? buffer : (sa_sint_t *)libsais16_alloc_memory(allocator, (size_t)d * sizeof(sa_sint_t), 4096);
+                if (alphabet != NULL)
+                {
+                    libsais16_remap_alphabet_32s_omp(T, n, ranks, threads);
+                    libsais16_unrank_alphabet_32s(ranks, k, alphabet);
+
+                    sa_sint_t index = libsais16_main_32s_entry(T, SA, n, d, fs, threads, thread_state, local_buffer, local_buffer_size, allocator, monitor, 0);
+                    if (index == 0)
+                    {
+                        libsais16_remap_alphabet_32s_omp(T, n, alphabet, threads);
+                    }
+
+                    libsais16_free_memory(allocator, alphabet);
+                    return index;
+                }
+            }
+
+            libsais16_free_memory(allocator, buffer);
+        }
+    }
+
+    return libsais16_main_32s_entry(T, SA, n, k, fs, threads, thread_state, local_buffer, local_buffer_size, allocator, monitor, 0);
+}
+
+static void libsais16_gsa_rename_separator_lms_suffixes_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n)
+{
+    fast_sint_t i, j;
+    for (i = 1, j = 0; i < (fast_sint_t)n - 1; i += 1)
+    {
+        if (T[i] == 0 && T[i - 1] != 0) { SA[j++] = (sa_sint_t)i | SAINT_MIN; }
+    }
+}
+
+static void libsais16_gsa_split_last_lms_suffix_group_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t m)
+{
+    fast_sint_t l = (fast_sint_t)n - 2; while (l >= 0 && T[l] >= T[l + 1]) { l--; }
+    while (l > 0 && T[l - 1] <= T[l]) { l--; }
+
+    if (l <= 0 || T[l] == 0) { return; }
+
+    fast_sint_t i = 0; while ((SA[i] & SAINT_MAX) != (sa_sint_t)l) { i++; }
+    if (i + 1 >= (fast_sint_t)m) { return; }
+
+    fast_sint_t len = (fast_sint_t)n - 1 - l, p = (fast_sint_t)(SA[i + 1] & SAINT_MAX) + len, t = p;
+    while (t < (fast_sint_t)n - 1 && T[t] == T[t + 1]) { t++; }
+
+    if (T[p - 1] > T[p] && t < (fast_sint_t)n - 1 && T[t] < T[t + 1] && memcmp(&T[SA[i + 1] & SAINT_MAX], &T[l], (size_t)len * sizeof(uint16_t)) == 0)
+    {
+        fast_sint_t j = i + 1; while (SA[j] > 0) { j++; }
+
+        fast_sint_t k = i; SA[i] = (sa_sint_t)l;
+        for (t = i + 1; t <= j; t += 1)
+        {
+            sa_sint_t q = SA[t] & SAINT_MAX; SA[t] = q;
+            if (T[q + len] == 0) { SA[t] = SA[k]; SA[k++] = q; }
+        }
+
+        for (t = k; SA[t] != (sa_sint_t)l; t += 1) { }
+        SA[t] = SA[k]; SA[k] = (sa_sint_t)l | SAINT_MIN;
+
+        if (k > i) { SA[k - 1] |= SAINT_MIN; }
+        SA[j] |= SAINT_MIN;
+    }
+}
+
+static void libsais16_gsa_induce_separator_suffixes_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets)
 {
-    sa_sint_t local_buffer[LIBSAIS_LOCAL_BUFFER_SIZE];
+    sa_sint_t * RESTRICT induction_bucket = &buckets[6 * ALPHABET_SIZE];
+
+    fast_sint_t i;
+    for (i = 0; i < (fast_sint_t)buckets[7 * ALPHABET_SIZE]; i += 1)
+    {
+        sa_sint_t p = SA[i]; SA[i] = 0; if (p > 0) { p--; SA[induction_bucket[T[p]]++] = p | ((sa_sint_t)(T[p - (p > 0)] < T[p]) << (SAINT_BIT - 1)); }
+    }
+}
 
-    return libsais16_main_32s_recursion(T, SA, n, k, fs, threads, thread_state, local_buffer);
+static void libsais16_gsa_place_separator_suffixes_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n)
+{
+    fast_sint_t i, j;
+    for (i = 0, j = 0; i < (fast_sint_t)n; i += 1)
+    {
+        if (T[i] == 0) { SA[j++] = (sa_sint_t)i; }
+    }
 }
 
-static sa_sint_t libsais16_main_16u(const uint16_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t * RESTRICT buckets, sa_sint_t bwt, sa_sint_t r, sa_sint_t * RESTRICT I, sa_sint_t fs, sa_sint_t * freq, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+static sa_sint_t libsais16_main_16u(const uint16_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t * RESTRICT buckets, sa_sint_t bwt, sa_sint_t r, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t fs, sa_sint_t * freq, sa_sint_t gsa, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t * RESTRICT local_buffer, sa_sint_t local_buffer_size, const LIBSAIS_ALLOCATOR * allocator, LIBSAIS_MONITOR * monitor)
 {
     fs = fs < (SAINT_MAX - n) ? fs : (SAINT_MAX - n);
+    threads = libsais16_adaptive_threads(monitor, threads, n, ALPHABET_SIZE);
+
+    if (thread_state != NULL) { thread_state[0].state.monitor = monitor; }
+
+    libsais16_profile(monitor, LIBSAIS16_PHASE_LEVEL, 0, 0, n, ALPHABET_SIZE, LIBSAIS16_PROFILE_NONE);
 
+    libsais16_profile(monitor, LIBSAIS16_PHASE_GATHER, 0, 0, n, ALPHABET_SIZE, LIBSAIS16_PROFILE_NONE);
     sa_sint_t m = libsais16_count_and_gather_lms_suffixes_16u_omp(T, SA, n, buckets, threads, thread_state);
     sa_sint_t k = libsais16_initialize_buckets_start_and_end_16u(buckets, freq);
+    libsais16_profile(monitor, LIBSAIS16_PHASE_GATHER, 1, 0, n, ALPHABET_SIZE, LIBSAIS16_PROFILE_NONE);
 
     if (m > 0)
     {
+        libsais16_profile(monitor, LIBSAIS16_PHASE_RADIX_SORT, 0, 0, n, ALPHABET_SIZE, LIBSAIS16_PROFILE_NONE);
         sa_sint_t first_lms_suffix    = SA[n - m];
         sa_sint_t left_suffixes_count = libsais16_initialize_buckets_for_lms_suffixes_radix_sort_16u(T, buckets, first_lms_suffix);
 
         if (threads > 1 && n >= 65536) { memset(SA, 0, ((size_t)n - (size_t)m) * sizeof(sa_sint_t)); }
-        libsais16_radix_sort_lms_suffixes_16u_omp(T, SA, n, m, buckets, threads, thread_state);
+        libsais16_radix_sort_lms_suffixes_16u_omp(T, SA, n, m, buckets, libsais16_adaptive_threads(monitor, threads, m, ALPHABET_SIZE) == threads ? threads : 1, thread_state);
         if (threads > 1 && n >= 65536) { memset(&SA[(fast_sint_t)n - (fast_sint_t)m], 0, (size_t)m * sizeof(sa_sint_t)); }
+        libsais16_profile(monitor, LIBSAIS16_PHASE_RADIX_SORT, 1, 0, n, ALPHABET_SIZE, LIBSAIS16_PROFILE_NONE);
+        if (libsais16_cancelled(monitor)) { return -5; }
 
+        libsais16_profile(monitor, LIBSAIS16_PHASE_PARTIAL_SORT, 0, 0, n, ALPHABET_SIZE, LIBSAIS16_PROFILE_NONE);
         libsais16_initialize_buckets_for_partial_sorting_16u(T, buckets, first_lms_suffix, left_suffixes_count);
         libsais16_induce_partial_order_16u_omp(T, SA, n, k, buckets, first_lms_suffix, left_suffixes_count, threads, thread_state);
+        if (libsais16_cancelled(monitor)) { return -5; }
+        if (gsa) { libsais16_gsa_rename_separator_lms_suffixes_16u(T, SA, n); libsais16_gsa_split_last_lms_suffix_group_16u(T, SA, n, m); }
+        libsais16_profile(monitor, LIBSAIS16_PHASE_PARTIAL_SORT, 1, 0, n, ALPHABET_SIZE, LIBSAIS16_PROFILE_NONE);
 
+        libsais16_profile(monitor, LIBSAIS16_PHASE_RENUMBER, 0, 0, n, ALPHABET_SIZE, LIBSAIS16_PROFILE_NONE);
         sa_sint_t names = libsais16_renumber_and_gather_lms_suffixes_omp(SA, n, m, fs, threads, thread_state);
+        libsais16_profile(monitor, LIBSAIS16_PHASE_RENUMBER, 1, 0, m, names, LIBSAIS16_PROFILE_NONE);
+
         if (names < m)
         {
-            if (libsais16_main_32s_entry(SA + n + fs - m, SA, m, names, fs + n - 2 * m, threads, thread_state) != 0)
+            sa_sint_t status = libsais16_main_32s_entry(SA + n + fs - m, SA, m, names, fs + n - 2 * m, threads, thread_state, local_buffer, local_buffer_size, allocator, monitor, 1);
+            if (status != 0)
             {
-                return -2;
+                return status;
             }
 
+            libsais16_profile(monitor, LIBSAIS16_PHASE_RECONSTRUCT, 0, 0, n, ALPHABET_SIZE, LIBSAIS16_PROFILE_NONE);
             libsais16_gather_lms_suffixes_16u_omp(T, SA, n, threads, thread_state);
             libsais16_reconstruct_lms_suffixes_omp(SA, n, m, threads);
+            libsais16_profile(monitor, LIBSAIS16_PHASE_RECONSTRUCT, 1, 0, n, ALPHABET_SIZE, LIBSAIS16_PROFILE_NONE);
         }
 
+        libsais16_profile(monitor, LIBSAIS16_PHASE_FINAL_SORT, 0, 0, n, ALPHABET_SIZE, LIBSAIS16_PROFILE_NONE);
         libsais16_place_lms_suffixes_interval_16u(SA, n, m, buckets);
     }
     else
     {
+        libsais16_profile(monitor, LIBSAIS16_PHASE_FINAL_SORT, 0, 0, n, ALPHABET_SIZE, LIBSAIS16_PROFILE_NONE);
         memset(SA, 0, (size_t)n * sizeof(sa_sint_t));
     }
 
-    return libsais16_induce_final_order_16u_omp(T, SA, n, k, bwt, r, I, buckets, threads, thread_state);
+    if (gsa) { libsais16_gsa_induce_separator_suffixes_16u(T, SA, buckets); }
+
+    sa_sint_t index = libsais16_induce_final_order_16u_omp(T, SA, n, k, bwt, r, I, S, buckets, threads, thread_state);
+    libsais16_profile(monitor, LIBSAIS16_PHASE_FINAL_SORT, 1, 0, n, ALPHABET_SIZE, LIBSAIS16_PROFILE_NONE);
+    if (libsais16_cancelled(monitor)) { return -5; }
+
+    libsais16_profile(monitor, LIBSAIS16_PHASE_LEVEL, 1, 0, n, ALPHABET_SIZE, LIBSAIS16_PROFILE_NONE);
+    return index;
+}
+
+static sa_sint_t libsais16_main_gsa_16u(const uint16_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t * RESTRICT buckets, sa_sint_t fs, sa_sint_t * freq, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t * RESTRICT local_buffer, sa_sint_t local_buffer_size, const LIBSAIS_ALLOCATOR * allocator, LIBSAIS_MONITOR * monitor)
+{
+    sa_sint_t q = n - 1; while (q > 0 && T[q - 1] == 0) { q--; }
+
+    if (q > 0)
+    {
+        sa_sint_t status = libsais16_main_16u(T, SA + (n - 1 - q), q + 1, buckets, 0, 0, NULL, NULL, fs, freq, 1, threads, thread_state, local_buffer, local_buffer_size, allocator, monitor);
+        if (status != 0)
+        {
+            return status;
+        }
+
+        if (freq != NULL) { freq[0] += n - 1 - q; }
+    }
+    else if (freq != NULL)
+    {
+        memset(freq, 0, ALPHABET_SIZE * sizeof(sa_sint_t)); freq[0] = n;
+    }
+
+    libsais16_gsa_place_separator_suffixes_16u(T, SA, n);
+
+    return 0;
+}
+
+static sa_sint_t libsais16_main(const uint16_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t bwt, sa_sint_t r, sa_sint_t * I, sa_sint_t * S, sa_sint_t fs, sa_sint_t * freq, sa_sint_t threads)
+{
+    LIBSAIS_THREAD_STATE *  RESTRICT thread_state   = threads > 1 ? libsais16_alloc_thread_state(threads, NULL) : NULL;
+    sa_sint_t *             RESTRICT buckets        = (sa_sint_t *)libsais16_alloc_aligned((size_t)8 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
+
+    sa_sint_t index = buckets != NULL && (thread_state != NULL || threads == 1)
+        ? libsais16_main_16u(T, SA, n, buckets, bwt, r, I, S, fs, freq, 0, threads, thread_state, NULL, LIBSAIS_LOCAL_BUFFER_SIZE, NULL, NULL)
+        : -2;
+
+    libsais16_free_aligned(buckets);
+    libsais16_free_thread_state(thread_state, NULL);
+
+    return index;
 }
 
-static sa_sint_t libsais16_main(const uint16_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t bwt, sa_sint_t r, sa_sint_t * I, sa_sint_t fs, sa_sint_t * freq, sa_sint_t threads)
+static sa_sint_t libsais16_main_gsa(const uint16_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t fs, sa_sint_t * freq, sa_sint_t threads)
 {
-    LIBSAIS_THREAD_STATE *  RESTRICT thread_state   = threads > 1 ? libsais16_alloc_thread_state(threads) : NULL;
+    LIBSAIS_THREAD_STATE *  RESTRICT thread_state   = threads > 1 ? libsais16_alloc_thread_state(threads, NULL) : NULL;
     sa_sint_t *             RESTRICT buckets        = (sa_sint_t *)libsais16_alloc_aligned((size_t)8 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
 
     sa_sint_t index = buckets != NULL && (thread_state != NULL || threads == 1)
-        ? libsais16_main_16u(T, SA, n, buckets, bwt, r, I, fs, freq, threads, thread_state)
+        ? libsais16_main_gsa_16u(T, SA, n, buckets, fs, freq, threads, thread_state, NULL, LIBSAIS_LOCAL_BUFFER_SIZE, NULL, NULL)
         : -2;
 
     libsais16_free_aligned(buckets);
-    libsais16_free_thread_state(thread_state);
+    libsais16_free_thread_state(thread_state, NULL);
 
     return index;
 }
 
 static sa_sint_t libsais16_main_int(sa_sint_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads)
 {
-    LIBSAIS_THREAD_STATE * RESTRICT thread_state = threads > 1 ? libsais16_alloc_thread_state(threads) : NULL;
+    LIBSAIS_THREAD_STATE * RESTRICT thread_state = threads > 1 ? libsais16_alloc_thread_state(threads, NULL) : NULL;
 
     sa_sint_t index = thread_state != NULL || threads == 1
-        ? libsais16_main_32s_entry(T, SA, n, k, fs, threads, thread_state)
+        ? libsais16_main_32s_compact(T, SA, n, k, fs, threads, thread_state, NULL, LIBSAIS_LOCAL_BUFFER_SIZE, NULL, NULL)
         : -2;
 
-    libsais16_free_thread_state(thread_state);
+    libsais16_free_thread_state(thread_state, NULL);
 
     return index;
 }
 
-static sa_sint_t libsais16_main_ctx(const LIBSAIS_CONTEXT * ctx, const uint16_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t bwt, sa_sint_t r, sa_sint_t * I, sa_sint_t fs, sa_sint_t * freq)
+static sa_sint_t libsais16_main_ctx(const LIBSAIS_CONTEXT * ctx, const uint16_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t bwt, sa_sint_t r, sa_sint_t * I, sa_sint_t * S, sa_sint_t fs, sa_sint_t * freq)
 {
-    return ctx != NULL && (ctx->buckets != NULL && (ctx->thread_state != NULL || ctx->threads == 1))
-        ? libsais16_main_16u(T, SA, n, ctx->buckets, bwt, r, I, fs, freq, (sa_sint_t)ctx->threads, ctx->thread_state)
-        : -2;
+    if (ctx != NULL && (ctx->buckets != NULL && (ctx->thread_state != NULL || ctx->threads == 1)))
+    {
+        libsais16_numa_place_omp(ctx, SA, n, fs);
+
+        LIBSAIS_MONITOR monitor = ctx->monitor;
+        if (ctx->numa != LIBSAIS16_NUMA_NONE) { monitor.thread_block_size = 0; }
+        return libsais16_ctx_status(ctx, libsais16_main_16u(T, SA, n, ctx->buckets, bwt, r, I, S, fs, freq, 0, (sa_sint_t)ctx->threads, ctx->thread_state, ctx->local_buffer, (sa_sint_t)ctx->local_buffer_size, &ctx->allocator, &monitor));
+    }
+
+    return -2;
+}
+
+static sa_sint_t libsais16_main_gsa_ctx(const LIBSAIS_CONTEXT * ctx, const uint16_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t fs, sa_sint_t * freq)
+{
+    if (ctx != NULL && (ctx->buckets != NULL && (ctx->thread_state != NULL || ctx->threads == 1)))
+    {
+        libsais16_numa_place_omp(ctx, SA, n, fs);
+
+        LIBSAIS_MONITOR monitor = ctx->monitor;
+        if (ctx->numa != LIBSAIS16_NUMA_NONE) { monitor.thread_block_size = 0; }
+        return libsais16_ctx_status(ctx, libsais16_main_gsa_16u(T, SA, n, ctx->buckets, fs, freq, (sa_sint_t)ctx->threads, ctx->thread_state, ctx->local_buffer, (sa_sint_t)ctx->local_buffer_size, &ctx->allocator, &monitor));
+    }
+
+    return -2;
+}
+
+static sa_sint_t libsais16_main_int_ctx(const LIBSAIS_CONTEXT * ctx, sa_sint_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs)
+{
+    if (ctx != NULL && (ctx->thread_state != NULL || ctx->threads == 1))
+    {
+        libsais16_numa_place_omp(ctx, SA, n, fs);
+
+        LIBSAIS_MONITOR monitor = ctx->monitor;
+        if (ctx->numa != LIBSAIS16_NUMA_NONE) { monitor.thread_block_size = 0; }
+        return libsais16_ctx_status(ctx, libsais16_main_32s_compact(T, SA, n, k, fs, (sa_sint_t)ctx->threads, ctx->thread_state, ctx->local_buffer, (sa_sint_t)ctx->local_buffer_size, &ctx->allocator, &monitor));
+    }
+
+    return -2;
 }
 
 static void libsais16_bwt_copy_16u(uint16_t * RESTRICT U, sa_sint_t * RESTRICT A, sa_sint_t n)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = 0, j = (fast_sint_t)n - 7; i < j; i += 8)
@@ -6556,1092 +7622,3084 @@ static void libsais16_bwt_copy_16u(uint16_t * RESTRICT U, sa_sint_t * RESTRICT A
     }
 }
 
-#if defined(LIBSAIS_OPENMP)
-
-static void libsais16_bwt_copy_16u_omp(uint16_t * RESTRICT U, sa_sint_t * RESTRICT A, sa_sint_t n, sa_sint_t threads)
+static fast_sint_t libsais16_rlbwt_gather_range_16u(const sa_sint_t * RESTRICT A, uint16_t * RESTRICT C, sa_sint_t * RESTRICT L, fast_sint_t c, fast_sint_t count, fast_sint_t rs, fast_sint_t offset, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-#if defined(LIBSAIS_OPENMP)
-    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
-#endif
-    {
-#if defined(LIBSAIS_OPENMP)
-        fast_sint_t omp_thread_num    = omp_get_thread_num();
-        fast_sint_t omp_num_threads   = omp_get_num_threads();
-        fast_sint_t omp_block_stride  = ((fast_sint_t)n / omp_num_threads) & (-16);
-        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
-        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : (fast_sint_t)n - omp_block_start;
-#else
-        UNUSED(threads);
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
-        fast_sint_t omp_block_start   = 0;
-        fast_sint_t omp_block_size    = (fast_sint_t)n;
-#endif
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size; i < j; i += 1)
+    {
+        libsais16_prefetchr(&A[i + prefetch_distance]);
 
-        libsais16_bwt_copy_16u(U + omp_block_start, A + omp_block_start, (sa_sint_t)omp_block_size);
+        fast_sint_t s = (uint16_t)A[i];
+        if (s != c) { if (count < rs) { C[count] = (uint16_t)s; L[count] = (sa_sint_t)(i + offset); } count++; c = s; }
     }
-}
 
-#endif
-
-void * libsais16_create_ctx(void)
-{
-    return (void *)libsais16_create_ctx_main(1);
+    return count;
 }
 
-void libsais16_free_ctx(void * ctx)
+static fast_sint_t libsais16_rlbwt_gather_runs_16u(const sa_sint_t * RESTRICT A, uint16_t * RESTRICT C, sa_sint_t * RESTRICT L, fast_sint_t index, fast_sint_t count, fast_sint_t rs, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    libsais16_free_ctx_main((LIBSAIS_CONTEXT *)ctx);
-}
+    fast_sint_t p = index - 1, i = omp_block_start, j = omp_block_start + omp_block_size, c = -1;
 
-int32_t libsais16(const uint16_t * T, int32_t * SA, int32_t n, int32_t fs, int32_t * freq)
-{
-    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
-    {
-        return -1;
-    }
-    else if (n < 2)
+    if (i > 0) { c = (uint16_t)A[i - 1 == 0 ? p : i - 1 <= p ? i - 2 : i - 1]; }
+
+    if (i == 0 && i < j)
     {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
-        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
-        return 0;
+        c = (uint16_t)A[p]; if (count < rs) { C[count] = (uint16_t)c; L[count] = 0; } count++; i = 1;
     }
 
-    return libsais16_main(T, SA, n, 0, 0, NULL, fs, freq, 1);
-}
-
-int32_t libsais16_int(int32_t * T, int32_t * SA, int32_t n, int32_t k, int32_t fs)
-{
-    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
+    if (i <= p && i < j)
     {
-        return -1;
+        fast_sint_t e = j < p + 1 ? j : p + 1;
+        count = libsais16_rlbwt_gather_range_16u(A, C, L, c, count, rs, 1, i - 1, e - i);
+        c = (uint16_t)A[e - 2]; i = e;
     }
-    else if (n < 2)
+
+    if (i < j)
     {
-        if (n == 1) { SA[0] = 0; }
-        return 0;
+        count = libsais16_rlbwt_gather_range_16u(A, C, L, c, count, rs, 0, i, j - i);
     }
 
-    return libsais16_main_int(T, SA, n, k, fs, 1);
+    return count;
 }
 
-int32_t libsais16_ctx(const void * ctx, const uint16_t * T, int32_t * SA, int32_t n, int32_t fs, int32_t * freq)
+static void libsais16_rlbwt_convert_runs(sa_sint_t * RESTRICT L, fast_sint_t next, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    if ((ctx == NULL) || (T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
-    {
-        return -1;
-    }
-    else if (n < 2)
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - 1; i < j; i += 1)
     {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
-        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
-        return 0;
+        L[i] = L[i + 1] - L[i];
     }
 
-    return libsais16_main_ctx((const LIBSAIS_CONTEXT *)ctx, T, SA, n, 0, 0, NULL, fs, freq);
+    if (omp_block_size > 0) { L[j] = (sa_sint_t)next - L[j]; }
 }
 
-int32_t libsais16_bwt(const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq)
+static sa_sint_t libsais16_rlbwt_encode_16u_omp(const sa_sint_t * RESTRICT A, uint16_t * RESTRICT C, sa_sint_t * RESTRICT L, sa_sint_t n, sa_sint_t index, sa_sint_t rs, sa_sint_t threads)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0))
-    { 
-        return -1; 
-    }
-    else if (n <= 1) 
-    {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
-        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
-        return n; 
-    }
+    fast_sint_t count = 0;
 
-    sa_sint_t index = libsais16_main(T, A, n, 1, 0, NULL, fs, freq, 1);
-    if (index >= 0) 
-    { 
-        index++;
+#if defined(LIBSAIS_OPENMP)
+    fast_sint_t * RESTRICT counts = threads > 1 && n >= 65536 ? (fast_sint_t *)libsais16_alloc_aligned((size_t)threads * sizeof(fast_sint_t), 64) : NULL;
+    if (threads > 1 && n >= 65536 && counts == NULL) { return -2; }
 
-        U[0] = T[n - 1];
-        libsais16_bwt_copy_16u(U + 1, A, index - 1);
-        libsais16_bwt_copy_16u(U + index, A + index, n - index);
-    }
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
 
-    return index;
-}
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
 
-int32_t libsais16_bwt_aux(const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t r, int32_t * I)
-{
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL))
-    { 
-        return -1; 
-    }
-    else if (n <= 1) 
-    {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
-        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
-        I[0] = n;
-        return 0;
-    }
+        if (omp_num_threads == 1)
+        {
+            count = libsais16_rlbwt_gather_runs_16u(A, C, L, index, 0, rs, omp_block_start, omp_block_size);
+            if (count <= rs) { libsais16_rlbwt_convert_runs(L, n, 0, count); }
+        }
+#if defined(LIBSAIS_OPENMP)
+        else
+        {
+            counts[omp_thread_num] = libsais16_rlbwt_gather_runs_16u(A, C, L, index, 0, 0, omp_block_start, omp_block_size);
 
-    if (libsais16_main(T, A, n, 1, r, I, fs, freq, 1) != 0)
-    {
-        return -2;
-    }
+            #pragma omp barrier
 
-    U[0] = T[n - 1];
-    libsais16_bwt_copy_16u(U + 1, A, I[0] - 1);
-    libsais16_bwt_copy_16u(U + I[0], A + I[0], n - I[0]);
+            fast_sint_t t, c = 0, total = 0; for (t = 0; t < omp_num_threads; ++t) { c += t < omp_thread_num ? counts[t] : 0; total += counts[t]; }
 
-    return 0;
-}
+            if (total <= rs)
+            {
+                libsais16_rlbwt_gather_runs_16u(A, C, L, index, c, rs, omp_block_start, omp_block_size);
 
-int32_t libsais16_bwt_ctx(const void * ctx, const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq)
-{
-    if ((ctx == NULL) || (T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0))
-    { 
-        return -1; 
-    }
-    else if (n <= 1) 
-    {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
-        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
-        return n;
-    }
+                #pragma omp barrier
 
-    sa_sint_t index = libsais16_main_ctx((const LIBSAIS_CONTEXT *)ctx, T, A, n, 1, 0, NULL, fs, freq);
-    if (index >= 0) 
-    { 
-        index++;
+                fast_sint_t next = c + counts[omp_thread_num] < total ? L[c + counts[omp_thread_num]] : n;
 
-        U[0] = T[n - 1];
+                #pragma omp barrier
 
-#if defined(LIBSAIS_OPENMP)
-        libsais16_bwt_copy_16u_omp(U + 1, A, index - 1, (sa_sint_t)((const LIBSAIS_CONTEXT *)ctx)->threads);
-        libsais16_bwt_copy_16u_omp(U + index, A + index, n - index, (sa_sint_t)((const LIBSAIS_CONTEXT *)ctx)->threads);
-#else
-        libsais16_bwt_copy_16u(U + 1, A, index - 1);
-        libsais16_bwt_copy_16u(U + index, A + index, n - index);
+                libsais16_rlbwt_convert_runs(L, next, c, counts[omp_thread_num]);
+            }
+
+            if (omp_thread_num == omp_num_threads - 1) { count = total; }
+        }
 #endif
     }
 
-    return index;
+#if defined(LIBSAIS_OPENMP)
+    libsais16_free_aligned(counts);
+#endif
+
+    return (sa_sint_t)count;
 }
 
-int32_t libsais16_bwt_aux_ctx(const void * ctx, const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t r, int32_t * I)
+
+#if defined(LIBSAIS_OPENMP)
+
+static void libsais16_bwt_copy_16u_omp(uint16_t * RESTRICT U, sa_sint_t * RESTRICT A, sa_sint_t n, sa_sint_t threads)
 {
-    if ((ctx == NULL) || (T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL))
-    { 
-        return -1; 
-    }
-    else if (n <= 1) 
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
     {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
-        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
-        I[0] = n;
-        return 0;
-    }
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+        fast_sint_t omp_block_stride  = ((fast_sint_t)n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : (fast_sint_t)n - omp_block_start;
+#else
+        UNUSED(threads);
 
-    if (libsais16_main_ctx((const LIBSAIS_CONTEXT *)ctx, T, A, n, 1, r, I, fs, freq) != 0)
-    {
-        return -2;
-    }
+        fast_sint_t omp_block_start   = 0;
+        fast_sint_t omp_block_size    = (fast_sint_t)n;
+#endif
 
-    U[0] = T[n - 1];
+        libsais16_bwt_copy_16u(U + omp_block_start, A + omp_block_start, (sa_sint_t)omp_block_size);
+    }
+}
 
-#if defined(LIBSAIS_OPENMP)
-    libsais16_bwt_copy_16u_omp(U + 1, A, I[0] - 1, (sa_sint_t)((const LIBSAIS_CONTEXT *)ctx)->threads);
-    libsais16_bwt_copy_16u_omp(U + I[0], A + I[0], n - I[0], (sa_sint_t)((const LIBSAIS_CONTEXT *)ctx)->threads);
-#else
-    libsais16_bwt_copy_16u(U + 1, A, I[0] - 1);
-    libsais16_bwt_copy_16u(U + I[0], A + I[0], n - I[0]);
 #endif
 
-    return 0;
+void * libsais16_create_ctx(void)
+{
+    return (void *)libsais16_create_ctx_main(1, NULL);
 }
 
-#if defined(LIBSAIS_OPENMP)
+void * libsais16_create_ctx_alloc(void * (* alloc_fn)(size_t size, size_t alignment, void * opaque), void (* free_fn)(void * address, void * opaque), void * opaque)
+{
+    if ((alloc_fn == NULL) || (free_fn == NULL)) { return NULL; }
 
-void * libsais16_create_ctx_omp(int32_t threads)
+    LIBSAIS_ALLOCATOR allocator = { alloc_fn, free_fn, opaque };
+    return (void *)libsais16_create_ctx_main(1, &allocator);
+}
+
+void * libsais16_create_ctx_buffer(void * buffer, size_t size)
 {
-    if (threads < 0) { return NULL; }
+    return (void *)libsais16_create_ctx_buffer_main(1, buffer, size);
+}
 
-    threads = threads > 0 ? threads : omp_get_max_threads();
-    return (void *)libsais16_create_ctx_main(threads);
+void libsais16_free_ctx(void * ctx)
+{
+    libsais16_free_ctx_main((LIBSAIS_CONTEXT *)ctx);
 }
 
-int32_t libsais16_omp(const uint16_t * T, int32_t * SA, int32_t n, int32_t fs, int32_t * freq, int32_t threads)
+int64_t libsais16_alloc_size(int32_t n, int32_t k, int32_t threads)
 {
-    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0) || (threads < 0))
+    if ((n < 0) || (k < 0) || (threads < 0))
     {
         return -1;
     }
-    else if (n < 2)
-    {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
-        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
-        return 0;
-    }
 
+#if defined(LIBSAIS_OPENMP)
     threads = threads > 0 ? threads : omp_get_max_threads();
+#else
+    threads = 1;
+#endif
 
-    return libsais16_main(T, SA, n, 0, 0, NULL, fs, freq, threads);
+    return libsais16_alloc_size_main(n, k, threads);
 }
 
-int32_t libsais16_int_omp(int32_t * T, int32_t * SA, int32_t n, int32_t k, int32_t fs, int32_t threads)
+int64_t libsais16_scratch_size(int32_t n, int32_t k, int32_t fs, int32_t threads, int32_t flags)
 {
-    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0) || (threads < 0))
+    if ((n < 0) || (k < 0) || (fs < 0) || (threads < 0) || (flags < LIBSAIS16_FLAGS_NONE) || (flags > LIBSAIS16_FLAGS_BUFFER))
     {
         return -1;
     }
-    else if (n < 2)
-    {
-        if (n == 1) { SA[0] = 0; }
-        return 0;
-    }
 
+#if defined(LIBSAIS_OPENMP)
     threads = threads > 0 ? threads : omp_get_max_threads();
+#else
+    threads = 1;
+#endif
 
-    return libsais16_main_int(T, SA, n, k, fs, threads);
+    return libsais16_scratch_size_main(n, k, fs, threads, flags);
 }
 
-int32_t libsais16_bwt_omp(const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t threads)
+int32_t libsais16_set_profiler(void * ctx, void (* profile_fn)(int32_t phase, int32_t end, int32_t depth, int64_t n, int64_t k, int32_t flags, void * opaque), void * opaque)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (threads < 0))
+    if (ctx == NULL)
     {
         return -1;
     }
-    else if (n <= 1)
-    {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
-        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
-        return n;
-    }
 
-    threads = threads > 0 ? threads : omp_get_max_threads();
-
-    sa_sint_t index = libsais16_main(T, A, n, 1, 0, NULL, fs, freq, threads);
-    if (index >= 0)
-    {
-        index++;
+    LIBSAIS_CONTEXT * RESTRICT context = (LIBSAIS_CONTEXT *)ctx;
 
-        U[0] = T[n - 1];
-        libsais16_bwt_copy_16u_omp(U + 1, A, index - 1, threads);
-        libsais16_bwt_copy_16u_omp(U + index, A + index, n - index, threads);
-    }
+    context->monitor.profile        = profile_fn;
+    context->monitor.profile_opaque = opaque;
 
-    return index;
+    return 0;
 }
 
-int32_t libsais16_bwt_aux_omp(const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t r, int32_t * I, int32_t threads)
+int32_t libsais16_set_cancel(void * ctx, int32_t (* cancel_fn)(void * opaque), void * opaque)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL) || (threads < 0))
+    if (ctx == NULL)
     {
         return -1;
     }
-    else if (n <= 1)
-    {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
-        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
-        I[0] = n;
-        return 0;
-    }
 
-    threads = threads > 0 ? threads : omp_get_max_threads();
-
-    if (libsais16_main(T, A, n, 1, r, I, fs, freq, threads) != 0)
-    {
-        return -2;
-    }
+    LIBSAIS_CONTEXT * RESTRICT context = (LIBSAIS_CONTEXT *)ctx;
 
-    U[0] = T[n - 1];
-    libsais16_bwt_copy_16u_omp(U + 1, A, I[0] - 1, threads);
-    libsais16_bwt_copy_16u_omp(U + I[0], A + I[0], n - I[0], threads);
+    context->monitor.cancel         = cancel_fn;
+    context->monitor.cancel_opaque  = opaque;
 
     return 0;
 }
 
-#endif
-
-static LIBSAIS_UNBWT_CONTEXT * libsais16_unbwt_create_ctx_main(sa_sint_t threads)
+int32_t libsais16_set_numa(void * ctx, int32_t mode)
 {
-    LIBSAIS_UNBWT_CONTEXT *     RESTRICT ctx            = (LIBSAIS_UNBWT_CONTEXT *)libsais16_alloc_aligned(sizeof(LIBSAIS_UNBWT_CONTEXT), 64);
-    sa_uint_t *                 RESTRICT bucket2        = (sa_uint_t *)libsais16_alloc_aligned(ALPHABET_SIZE * sizeof(sa_uint_t), 4096);
-    uint16_t *                  RESTRICT fastbits       = (uint16_t *)libsais16_alloc_aligned((1 + (1 << UNBWT_FASTBITS)) * sizeof(uint16_t), 4096);
-    sa_uint_t *                 RESTRICT buckets        = threads > 1 ? (sa_uint_t *)libsais16_alloc_aligned((size_t)threads * ALPHABET_SIZE * sizeof(sa_uint_t), 4096) : NULL;
-
-    if (ctx != NULL && bucket2 != NULL && fastbits != NULL && (buckets != NULL || threads == 1))
+    if ((ctx == NULL) || (mode < LIBSAIS16_NUMA_NONE) || (mode > LIBSAIS16_NUMA_INTERLEAVE))
     {
-        ctx->bucket2    = bucket2;
-        ctx->fastbits   = fastbits;
-        ctx->buckets    = buckets;
-        ctx->threads    = threads;
-
-        return ctx;
+        return -1;
     }
 
-    libsais16_free_aligned(buckets);
-    libsais16_free_aligned(fastbits);
-    libsais16_free_aligned(bucket2);
-    libsais16_free_aligned(ctx);
+    LIBSAIS_CONTEXT * RESTRICT context = (LIBSAIS_CONTEXT *)ctx;
 
-    return NULL;
+    context->numa = mode;
+    if (mode != LIBSAIS16_NUMA_NONE) { libsais16_numa_place_thread_state(context->thread_state, context->threads); }
+
+    return 0;
 }
 
-static void libsais16_unbwt_free_ctx_main(LIBSAIS_UNBWT_CONTEXT * ctx)
+int32_t libsais16_set_cache_size(void * ctx, int32_t size)
 {
-    if (ctx != NULL)
+    LIBSAIS_CONTEXT * RESTRICT context = (LIBSAIS_CONTEXT *)ctx;
+
+    if ((context == NULL) || (size < 1024) || ((fast_sint_t)size <= 32 * context->threads))
     {
-        libsais16_free_aligned(ctx->buckets);
-        libsais16_free_aligned(ctx->fastbits);
-        libsais16_free_aligned(ctx->bucket2);
-        libsais16_free_aligned(ctx);
+        return -1;
     }
-}
-
-static void libsais16_unbwt_compute_histogram(const uint16_t * RESTRICT T, fast_sint_t n, sa_uint_t * RESTRICT count)
-{
-    fast_sint_t i; for (i = 0; i < n; i += 1) { count[T[i]]++; }
-}
 
-static void libsais16_unbwt_calculate_fastbits(sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift)
-{
-    fast_uint_t v, w, sum;
-    for (v = 0, sum = 1, w = 0; w < ALPHABET_SIZE; ++w)
+    if (context->thread_state != NULL)
     {
-        fast_uint_t prev = sum; sum += bucket2[w]; bucket2[w] = (sa_uint_t)prev;
-        if (prev != sum)
+        LIBSAIS_THREAD_CACHE * RESTRICT cache = (LIBSAIS_THREAD_CACHE *)libsais16_alloc_memory(&context->allocator, (size_t)context->threads * (size_t)size * sizeof(LIBSAIS_THREAD_CACHE), 4096);
+        if (cache == NULL)
         {
-            for (; v <= ((sum - 1) >> shift); ++v) { fastbits[v] = (uint16_t)w; }
+            return libsais16_ctx_status(context, -2);
+        }
+
+        libsais16_free_memory(&context->allocator, context->thread_state[0].state.cache);
+
+        fast_sint_t t;
+        for (t = 0; t < context->threads; ++t)
+        {
+            context->thread_state[t].state.cache      = cache + t * (fast_sint_t)size;
+            context->thread_state[t].state.cache_size = (fast_sint_t)size;
         }
+
+        if (context->numa != LIBSAIS16_NUMA_NONE) { libsais16_numa_place_thread_state(context->thread_state, context->threads); }
     }
+
+    return 0;
 }
 
-static void libsais16_unbwt_calculate_P(const uint16_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, fast_uint_t index, fast_sint_t omp_block_start, fast_sint_t omp_block_end)
+int32_t libsais16_set_local_buffer_size(void * ctx, int32_t size)
 {
+    LIBSAIS_CONTEXT * RESTRICT context = (LIBSAIS_CONTEXT *)ctx;
+
+    if ((context == NULL) || (size < 0))
     {
-        fast_sint_t i = omp_block_start, j = (fast_sint_t)index; if (omp_block_end < j) { j = omp_block_end; }
-        for (; i < j; ++i) { fast_uint_t c = T[i]; P[bucket2[c]++] = (sa_uint_t)i; }
+        return -1;
     }
 
+    sa_sint_t * RESTRICT local_buffer = NULL;
+    if (size > LIBSAIS_LOCAL_BUFFER_SIZE)
     {
-        fast_sint_t i = (fast_sint_t)index, j = omp_block_end; if (omp_block_start > i) { i = omp_block_start; }
-        for (T -= 1, i += 1; i <= j; ++i) { fast_uint_t c = T[i]; P[bucket2[c]++] = (sa_uint_t)i; }
+        local_buffer = (sa_sint_t *)libsais16_alloc_memory(&context->allocator, (size_t)size * sizeof(sa_sint_t), 4096);
+        if (local_buffer == NULL)
+        {
+            return libsais16_ctx_status(context, -2);
+        }
     }
+
+    libsais16_free_memory(&context->allocator, context->local_buffer);
+
+    context->local_buffer      = local_buffer;
+    context->local_buffer_size  = (fast_sint_t)size;
+
+    return 0;
 }
 
-static void libsais16_unbwt_init_single(const uint16_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits)
+int32_t libsais16_set_adaptive_threads(void * ctx, int32_t block_size)
 {
-    fast_uint_t index = I[0];
-    fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
-
-    if (freq != NULL)
+    if ((ctx == NULL) || (block_size < 0))
     {
-        memcpy(bucket2, freq, ALPHABET_SIZE * sizeof(sa_uint_t));
+        return -1;
     }
-    else
-    {
-        memset(bucket2, 0, ALPHABET_SIZE * sizeof(sa_uint_t));
+
+    LIBSAIS_CONTEXT * RESTRICT context = (LIBSAIS_CONTEXT *)ctx;
+
+    context->monitor.thread_block_size = (sa_sint_t)block_size;
+
+    return 0;
+}
+
+int32_t libsais16(const uint16_t * T, int32_t * SA, int32_t n, int32_t fs, int32_t * freq)
+{
+    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    return libsais16_main(T, SA, n, 0, 0, NULL, NULL, fs, freq, 1);
+}
+
+int32_t libsais16_int(int32_t * T, int32_t * SA, int32_t n, int32_t k, int32_t fs)
+{
+    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (n == 1) { SA[0] = 0; }
+        return 0;
+    }
+
+    return libsais16_main_int(T, SA, n, k, fs, 1);
+}
+
+int32_t libsais16_ctx(const void * ctx, const uint16_t * T, int32_t * SA, int32_t n, int32_t fs, int32_t * freq)
+{
+    if ((ctx == NULL) || (T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    return libsais16_main_ctx((const LIBSAIS_CONTEXT *)ctx, T, SA, n, 0, 0, NULL, NULL, fs, freq);
+}
+
+int32_t libsais16_int_ctx(const void * ctx, int32_t * T, int32_t * SA, int32_t n, int32_t k, int32_t fs)
+{
+    if ((ctx == NULL) || (T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (n == 1) { SA[0] = 0; }
+        return 0;
+    }
+
+    return libsais16_main_int_ctx((const LIBSAIS_CONTEXT *)ctx, T, SA, n, k, fs);
+}
+
+int32_t libsais16_gsa(const uint16_t * T, int32_t * SA, int32_t n, int32_t fs, int32_t * freq)
+{
+    if ((T == NULL) || (SA == NULL) || (n < 0) || (n > 0 && T[n - 1] != 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    return libsais16_main_gsa(T, SA, n, fs, freq, 1);
+}
+
+int32_t libsais16_gsa_ctx(const void * ctx, const uint16_t * T, int32_t * SA, int32_t n, int32_t fs, int32_t * freq)
+{
+    if ((ctx == NULL) || (T == NULL) || (SA == NULL) || (n < 0) || (n > 0 && T[n - 1] != 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    return libsais16_main_gsa_ctx((const LIBSAIS_CONTEXT *)ctx, T, SA, n, fs, freq);
+}
+
+int32_t libsais16_bwt(const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0))
+    { 
+        return -1; 
+    }
+    else if (n <= 1) 
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        return n; 
+    }
+
+    sa_sint_t index = libsais16_main(T, A, n, 1, 0, NULL, NULL, fs, freq, 1);
+    if (index >= 0) 
+    { 
+        index++;
+
+        U[0] = T[n - 1];
+        libsais16_bwt_copy_16u(U + 1, A, index - 1);
+        libsais16_bwt_copy_16u(U + index, A + index, n - index);
+    }
+
+    return index;
+}
+
+int32_t libsais16_bwt_aux(const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t r, int32_t * I)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL))
+    { 
+        return -1; 
+    }
+    else if (n <= 1) 
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        I[0] = n;
+        return 0;
+    }
+
+    if (libsais16_main(T, A, n, 1, r, I, NULL, fs, freq, 1) != 0)
+    {
+        return -2;
+    }
+
+    U[0] = T[n - 1];
+    libsais16_bwt_copy_16u(U + 1, A, I[0] - 1);
+    libsais16_bwt_copy_16u(U + I[0], A + I[0], n - I[0]);
+
+    return 0;
+}
+
+int32_t libsais16_bwt_aux_sa(const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t r, int32_t * I, int32_t * S)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL) || (S == NULL))
+    { 
+        return -1; 
+    }
+    else if (n <= 1) 
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        I[0] = n; S[0] = 0;
+        return 0;
+    }
+
+    if (libsais16_main(T, A, n, 1, r, I, S, fs, freq, 1) != 0)
+    {
+        return -2;
+    }
+
+    U[0] = T[n - 1];
+    libsais16_bwt_copy_16u(U + 1, A, I[0] - 1);
+    libsais16_bwt_copy_16u(U + I[0], A + I[0], n - I[0]);
+
+    return 0;
+}
+
+int32_t libsais16_bwt_ctx(const void * ctx, const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq)
+{
+    if ((ctx == NULL) || (T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0))
+    { 
+        return -1; 
+    }
+    else if (n <= 1) 
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        return n;
+    }
+
+    sa_sint_t index = libsais16_main_ctx((const LIBSAIS_CONTEXT *)ctx, T, A, n, 1, 0, NULL, NULL, fs, freq);
+    if (index >= 0) 
+    { 
+        index++;
+
+        U[0] = T[n - 1];
+
+#if defined(LIBSAIS_OPENMP)
+        libsais16_bwt_copy_16u_omp(U + 1, A, index - 1, (sa_sint_t)((const LIBSAIS_CONTEXT *)ctx)->threads);
+        libsais16_bwt_copy_16u_omp(U + index, A + index, n - index, (sa_sint_t)((const LIBSAIS_CONTEXT *)ctx)->threads);
+#else
+        libsais16_bwt_copy_16u(U + 1, A, index - 1);
+        libsais16_bwt_copy_16u(U + index, A + index, n - index);
+#endif
+    }
+
+    return index;
+}
+
+int32_t libsais16_bwt_aux_ctx(const void * ctx, const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t r, int32_t * I)
+{
+    if ((ctx == NULL) || (T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL))
+    { 
+        return -1; 
+    }
+    else if (n <= 1) 
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        I[0] = n;
+        return 0;
+    }
+
+    sa_sint_t index = libsais16_main_ctx((const LIBSAIS_CONTEXT *)ctx, T, A, n, 1, r, I, NULL, fs, freq);
+    if (index != 0)
+    {
+        return index;
+    }
+
+    U[0] = T[n - 1];
+
+#if defined(LIBSAIS_OPENMP)
+    libsais16_bwt_copy_16u_omp(U + 1, A, I[0] - 1, (sa_sint_t)((const LIBSAIS_CONTEXT *)ctx)->threads);
+    libsais16_bwt_copy_16u_omp(U + I[0], A + I[0], n - I[0], (sa_sint_t)((const LIBSAIS_CONTEXT *)ctx)->threads);
+#else
+    libsais16_bwt_copy_16u(U + 1, A, I[0] - 1);
+    libsais16_bwt_copy_16u(U + I[0], A + I[0], n - I[0]);
+#endif
+
+    return 0;
+}
+
+int32_t libsais16_bwt_aux_sa_ctx(const void * ctx, const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t r, int32_t * I, int32_t * S)
+{
+    if ((ctx == NULL) || (T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL) || (S == NULL))
+    { 
+        return -1; 
+    }
+    else if (n <= 1) 
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        I[0] = n; S[0] = 0;
+        return 0;
+    }
+
+    sa_sint_t index = libsais16_main_ctx((const LIBSAIS_CONTEXT *)ctx, T, A, n, 1, r, I, S, fs, freq);
+    if (index != 0)
+    {
+        return index;
+    }
+
+    U[0] = T[n - 1];
+
+#if defined(LIBSAIS_OPENMP)
+    libsais16_bwt_copy_16u_omp(U + 1, A, I[0] - 1, (sa_sint_t)((const LIBSAIS_CONTEXT *)ctx)->threads);
+    libsais16_bwt_copy_16u_omp(U + I[0], A + I[0], n - I[0], (sa_sint_t)((const LIBSAIS_CONTEXT *)ctx)->threads);
+#else
+    libsais16_bwt_copy_16u(U + 1, A, I[0] - 1);
+    libsais16_bwt_copy_16u(U + I[0], A + I[0], n - I[0]);
+#endif
+
+    return 0;
+}
+
+int32_t libsais16_rlbwt(const uint16_t * T, uint16_t * C, int32_t * L, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t rs, int32_t * runs)
+{
+    if ((T == NULL) || (C == NULL) || (L == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (rs < 0) || (runs == NULL))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { if (freq != NULL) { freq[T[0]]++; } A[0] = T[0]; if (rs >= 1) { C[0] = T[0]; L[0] = 1; } }
+        *runs = n;
+        return n;
+    }
+
+    sa_sint_t index = libsais16_main(T, A, n, 1, 0, NULL, NULL, fs, freq, 1);
+    if (index >= 0)
+    {
+        index++; A[index - 1] = T[n - 1];
+
+        sa_sint_t count = libsais16_rlbwt_encode_16u_omp(A, C, L, n, index, rs, 1);
+        if (count < 0) { return count; }
+
+        *runs = count;
+    }
+
+    return index;
+}
+
+int32_t libsais16_rlbwt_encode(const int32_t * A, uint16_t * C, int32_t * L, int32_t n, int32_t i, int32_t rs, int32_t * runs)
+{
+    if ((A == NULL) || (C == NULL) || (L == NULL) || (n < 0) || (i < (n > 0)) || (i > n) || (rs < 0) || (runs == NULL))
+    {
+        return -1;
+    }
+    else if (n == 0)
+    {
+        *runs = 0;
+        return 0;
+    }
+
+    sa_sint_t count = libsais16_rlbwt_encode_16u_omp(A, C, L, n, i, rs, 1);
+    if (count < 0) { return count; }
+
+    *runs = count;
+    return 0;
+}
+
+static sa_sint_t libsais16_batch_main(const uint16_t * const * T, uint16_t * const * U, sa_sint_t * const * SA, const sa_sint_t * n, const sa_sint_t * fs, sa_sint_t * const * freq, sa_sint_t * result, sa_sint_t count, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && count > 1)
+#else
+    UNUSED(threads);
+#endif
+    {
+        LIBSAIS_CONTEXT * ctx = libsais16_create_ctx_main(1, NULL);
+
+        fast_sint_t i;
+
+#if defined(LIBSAIS_OPENMP)
+        #pragma omp for schedule(dynamic, 1)
+#endif
+        for (i = 0; i < (fast_sint_t)count; ++i)
+        {
+            sa_sint_t   job_fs      = fs != NULL ? fs[i] : 0;
+            sa_sint_t * job_freq    = freq != NULL ? freq[i] : NULL;
+
+            result[i] = ctx == NULL ? -2 : U != NULL
+                ? libsais16_bwt_ctx(ctx, T[i], U[i], SA[i], n[i], job_fs, job_freq)
+                : libsais16_ctx(ctx, T[i], SA[i], n[i], job_fs, job_freq);
+        }
+
+        libsais16_free_ctx_main(ctx);
+    }
+
+    fast_sint_t i;
+    for (i = 0; i < (fast_sint_t)count; ++i)
+    {
+        if (result[i] < 0) { return result[i]; }
+    }
+
+    return 0;
+}
+
+int32_t libsais16_batch(const uint16_t * const * T, int32_t * const * SA, const int32_t * n, const int32_t * fs, int32_t * const * freq, int32_t * result, int32_t count)
+{
+    if ((T == NULL) || (SA == NULL) || (n == NULL) || (result == NULL) || (count < 0))
+    {
+        return -1;
+    }
+
+    return libsais16_batch_main(T, NULL, SA, n, fs, freq, result, count, 1);
+}
+
+int32_t libsais16_bwt_batch(const uint16_t * const * T, uint16_t * const * U, int32_t * const * A, const int32_t * n, const int32_t * fs, int32_t * const * freq, int32_t * result, int32_t count)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n == NULL) || (result == NULL) || (count < 0))
+    {
+        return -1;
+    }
+
+    return libsais16_batch_main(T, U, A, n, fs, freq, result, count, 1);
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+void * libsais16_create_ctx_omp(int32_t threads)
+{
+    if (threads < 0) { return NULL; }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return (void *)libsais16_create_ctx_main(threads, NULL);
+}
+
+void * libsais16_create_ctx_alloc_omp(int32_t threads, void * (* alloc_fn)(size_t size, size_t alignment, void * opaque), void (* free_fn)(void * address, void * opaque), void * opaque)
+{
+    if ((threads < 0) || (alloc_fn == NULL) || (free_fn == NULL)) { return NULL; }
+
+    LIBSAIS_ALLOCATOR allocator = { alloc_fn, free_fn, opaque };
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return (void *)libsais16_create_ctx_main(threads, &allocator);
+}
+
+void * libsais16_create_ctx_buffer_omp(int32_t threads, void * buffer, size_t size)
+{
+    if (threads < 0) { return NULL; }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return (void *)libsais16_create_ctx_buffer_main(threads, buffer, size);
+}
+
+int32_t libsais16_omp(const uint16_t * T, int32_t * SA, int32_t n, int32_t fs, int32_t * freq, int32_t threads)
+{
+    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais16_main(T, SA, n, 0, 0, NULL, NULL, fs, freq, threads);
+}
+
+int32_t libsais16_int_omp(int32_t * T, int32_t * SA, int32_t n, int32_t k, int32_t fs, int32_t threads)
+{
+    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (n == 1) { SA[0] = 0; }
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais16_main_int(T, SA, n, k, fs, threads);
+}
+
+int32_t libsais16_gsa_omp(const uint16_t * T, int32_t * SA, int32_t n, int32_t fs, int32_t * freq, int32_t threads)
+{
+    if ((T == NULL) || (SA == NULL) || (n < 0) || (n > 0 && T[n - 1] != 0) || (fs < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais16_main_gsa(T, SA, n, fs, freq, threads);
+}
+
+int32_t libsais16_bwt_omp(const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        return n;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    sa_sint_t index = libsais16_main(T, A, n, 1, 0, NULL, NULL, fs, freq, threads);
+    if (index >= 0)
+    {
+        index++;
+
+        U[0] = T[n - 1];
+        libsais16_bwt_copy_16u_omp(U + 1, A, index - 1, threads);
+        libsais16_bwt_copy_16u_omp(U + index, A + index, n - index, threads);
+    }
+
+    return index;
+}
+
+int32_t libsais16_bwt_aux_omp(const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t r, int32_t * I, int32_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        I[0] = n;
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    if (libsais16_main(T, A, n, 1, r, I, NULL, fs, freq, threads) != 0)
+    {
+        return -2;
+    }
+
+    U[0] = T[n - 1];
+    libsais16_bwt_copy_16u_omp(U + 1, A, I[0] - 1, threads);
+    libsais16_bwt_copy_16u_omp(U + I[0], A + I[0], n - I[0], threads);
+
+    return 0;
+}
+
+int32_t libsais16_bwt_aux_sa_omp(const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t r, int32_t * I, int32_t * S, int32_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL) || (S == NULL) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        I[0] = n; S[0] = 0;
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    if (libsais16_main(T, A, n, 1, r, I, S, fs, freq, threads) != 0)
+    {
+        return -2;
+    }
+
+    U[0] = T[n - 1];
+    libsais16_bwt_copy_16u_omp(U + 1, A, I[0] - 1, threads);
+    libsais16_bwt_copy_16u_omp(U + I[0], A + I[0], n - I[0], threads);
+
+    return 0;
+}
+
+int32_t libsais16_rlbwt_omp(const uint16_t * T, uint16_t * C, int32_t * L, int32_t * A, int32_t n, int32_t fs, int32_t * freq, int32_t rs, int32_t * runs, int32_t threads)
+{
+    if ((T == NULL) || (C == NULL) || (L == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (rs < 0) || (runs == NULL) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { if (freq != NULL) { freq[T[0]]++; } A[0] = T[0]; if (rs >= 1) { C[0] = T[0]; L[0] = 1; } }
+        *runs = n;
+        return n;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    sa_sint_t index = libsais16_main(T, A, n, 1, 0, NULL, NULL, fs, freq, threads);
+    if (index >= 0)
+    {
+        index++; A[index - 1] = T[n - 1];
+
+        sa_sint_t count = libsais16_rlbwt_encode_16u_omp(A, C, L, n, index, rs, threads);
+        if (count < 0) { return count; }
+
+        *runs = count;
+    }
+
+    return index;
+}
+
+int32_t libsais16_rlbwt_encode_omp(const int32_t * A, uint16_t * C, int32_t * L, int32_t n, int32_t i, int32_t rs, int32_t * runs, int32_t threads)
+{
+    if ((A == NULL) || (C == NULL) || (L == NULL) || (n < 0) || (i < (n > 0)) || (i > n) || (rs < 0) || (runs == NULL) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n == 0)
+    {
+        *runs = 0;
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    sa_sint_t count = libsais16_rlbwt_encode_16u_omp(A, C, L, n, i, rs, threads);
+    if (count < 0) { return count; }
+
+    *runs = count;
+    return 0;
+}
+
+int32_t libsais16_batch_omp(const uint16_t * const * T, int32_t * const * SA, const int32_t * n, const int32_t * fs, int32_t * const * freq, int32_t * result, int32_t count, int32_t threads)
+{
+    if ((T == NULL) || (SA == NULL) || (n == NULL) || (result == NULL) || (count < 0) || (threads < 0))
+    {
+        return -1;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais16_batch_main(T, NULL, SA, n, fs, freq, result, count, threads);
+}
+
+int32_t libsais16_bwt_batch_omp(const uint16_t * const * T, uint16_t * const * U, int32_t * const * A, const int32_t * n, const int32_t * fs, int32_t * const * freq, int32_t * result, int32_t count, int32_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n == NULL) || (result == NULL) || (count < 0) || (threads < 0))
+    {
+        return -1;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais16_batch_main(T, U, A, n, fs, freq, result, count, threads);
+}
+
+#endif
+
+static LIBSAIS_UNBWT_CONTEXT * libsais16_unbwt_create_ctx_main(sa_sint_t threads, const LIBSAIS_ALLOCATOR * allocator)
+{
+    LIBSAIS_UNBWT_CONTEXT *     RESTRICT ctx            = (LIBSAIS_UNBWT_CONTEXT *)libsais16_alloc_memory(allocator, sizeof(LIBSAIS_UNBWT_CONTEXT), 64);
+    sa_uint_t *                 RESTRICT bucket2        = (sa_uint_t *)libsais16_alloc_memory(allocator, ALPHABET_SIZE * sizeof(sa_uint_t), 4096);
+    uint16_t *                  RESTRICT fastbits       = (uint16_t *)libsais16_alloc_memory(allocator, (1 + (1 << UNBWT_FASTBITS)) * sizeof(uint16_t), 4096);
+    sa_uint_t *                 RESTRICT buckets        = threads > 1 ? (sa_uint_t *)libsais16_alloc_memory(allocator, (size_t)threads * ALPHABET_SIZE * sizeof(sa_uint_t), 4096) : NULL;
+
+    if (ctx != NULL && bucket2 != NULL && fastbits != NULL && (buckets != NULL || threads == 1))
+    {
+        ctx->bucket2      = bucket2;
+        ctx->fastbits     = fastbits;
+        ctx->buckets      = buckets;
+        ctx->fastbits_log = UNBWT_FASTBITS;
+        ctx->threads      = threads;
+
+        if (allocator != NULL) { ctx->allocator = *allocator; } else { memset(&ctx->allocator, 0, sizeof(LIBSAIS_ALLOCATOR)); }
+
+        return ctx;
+    }
+
+    libsais16_free_memory(allocator, buckets);
+    libsais16_free_memory(allocator, fastbits);
+    libsais16_free_memory(allocator, bucket2);
+    libsais16_free_memory(allocator, ctx);
+
+    return NULL;
+}
+
+static void libsais16_unbwt_free_ctx_main(LIBSAIS_UNBWT_CONTEXT * ctx)
+{
+    if (ctx != NULL)
+    {
+        LIBSAIS_ALLOCATOR allocator = ctx->allocator;
+
+        libsais16_free_memory(&allocator, ctx->buckets);
+        libsais16_free_memory(&allocator, ctx->fastbits);
+        libsais16_free_memory(&allocator, ctx->bucket2);
+        libsais16_free_memory(&allocator, ctx);
+    }
+}
+
+static int64_t libsais16_unbwt_alloc_size_main(fast_sint_t threads)
+{
+    int64_t size = (int64_t)sizeof(LIBSAIS_UNBWT_CONTEXT) + 64;
+
+    size += (int64_t)ALPHABET_SIZE * (int64_t)sizeof(sa_uint_t) + 4096;
+    size += ((int64_t)1 + ((int64_t)1 << UNBWT_FASTBITS)) * (int64_t)sizeof(uint16_t) + 4096;
+
+    if (threads > 1)
+    {
+        size += (int64_t)threads * ALPHABET_SIZE * (int64_t)sizeof(sa_uint_t) + 4096;
+    }
+
+    return size;
+}
+
+static void libsais16_unbwt_compute_histogram(const uint16_t * RESTRICT T, fast_sint_t n, sa_uint_t * RESTRICT count)
+{
+    fast_sint_t i; for (i = 0; i < n; i += 1) { count[T[i]]++; }
+}
+
+static void libsais16_unbwt_calculate_fastbits(sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift)
+{
+    fast_uint_t v, w, sum;
+    for (v = 0, sum = 1, w = 0; w < ALPHABET_SIZE; ++w)
+    {
+        fast_uint_t prev = sum; sum += bucket2[w]; bucket2[w] = (sa_uint_t)prev;
+        if (prev != sum)
+        {
+            for (; v <= ((sum - 1) >> shift); ++v) { fastbits[v] = (uint16_t)w; }
+        }
+    }
+}
+
+static void libsais16_unbwt_calculate_P(const uint16_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, fast_uint_t index, fast_sint_t omp_block_start, fast_sint_t omp_block_end)
+{
+    {
+        fast_sint_t i = omp_block_start, j = (fast_sint_t)index; if (omp_block_end < j) { j = omp_block_end; }
+        for (; i < j; ++i) { fast_uint_t c = T[i]; P[bucket2[c]++] = (sa_uint_t)i; }
+    }
+
+    {
+        fast_sint_t i = (fast_sint_t)index, j = omp_block_end; if (omp_block_start > i) { i = omp_block_start; }
+        for (T -= 1, i += 1; i <= j; ++i) { fast_uint_t c = T[i]; P[bucket2[c]++] = (sa_uint_t)i; }
+    }
+}
+
+static void libsais16_unbwt_init_single(const uint16_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift)
+{
+    fast_uint_t index = I[0];
+
+    if (freq != NULL)
+    {
+        memcpy(bucket2, freq, ALPHABET_SIZE * sizeof(sa_uint_t));
+    }
+    else
+    {
+        memset(bucket2, 0, ALPHABET_SIZE * sizeof(sa_uint_t));
         libsais16_unbwt_compute_histogram(T, n, bucket2);
     }
 
-    libsais16_unbwt_calculate_fastbits(bucket2, fastbits, shift);
-    libsais16_unbwt_calculate_P(T, P, bucket2, index, 0, n);
+    libsais16_unbwt_calculate_fastbits(bucket2, fastbits, shift);
+    libsais16_unbwt_calculate_P(T, P, bucket2, index, 0, n);
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+static void libsais16_unbwt_init_parallel_histogram(const uint16_t * RESTRICT T, sa_sint_t n, sa_uint_t * RESTRICT buckets, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    sa_uint_t * RESTRICT bucket2_local  = buckets + omp_thread_num * ALPHABET_SIZE;
+    fast_sint_t omp_block_stride        = (n / omp_num_threads) & (-16);
+    fast_sint_t omp_block_start         = omp_thread_num * omp_block_stride;
+    fast_sint_t omp_block_size          = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+    memset(bucket2_local, 0, ALPHABET_SIZE * sizeof(sa_uint_t));
+    libsais16_unbwt_compute_histogram(T + omp_block_start, omp_block_size, bucket2_local);
+}
+
+static void libsais16_unbwt_init_parallel_bucket2(sa_uint_t * RESTRICT bucket2, sa_uint_t * RESTRICT buckets, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    sa_uint_t * RESTRICT bucket2_temp   = buckets;
+    fast_sint_t omp_block_stride        = (ALPHABET_SIZE / omp_num_threads) & (-16);
+    fast_sint_t omp_block_start         = omp_thread_num * omp_block_stride;
+    fast_sint_t omp_block_size          = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : ALPHABET_SIZE - omp_block_start;
+
+    memset(bucket2 + omp_block_start, 0, (size_t)omp_block_size * sizeof(sa_uint_t));
+
+    fast_sint_t t;
+    for (t = 0; t < omp_num_threads; ++t, bucket2_temp += ALPHABET_SIZE)
+    {
+        fast_sint_t c; for (c = omp_block_start; c < omp_block_start + omp_block_size; c += 1) { sa_uint_t A = bucket2[c], B = bucket2_temp[c]; bucket2[c] = A + B; bucket2_temp[c] = A; }
+    }
+}
+
+static void libsais16_unbwt_init_parallel_P(const uint16_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_sint_t n, fast_uint_t index, const sa_uint_t * RESTRICT bucket2, sa_uint_t * RESTRICT buckets, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    sa_uint_t * RESTRICT bucket2_local  = buckets + omp_thread_num * ALPHABET_SIZE;
+    fast_sint_t omp_block_stride        = (n / omp_num_threads) & (-16);
+    fast_sint_t omp_block_start         = omp_thread_num * omp_block_stride;
+    fast_sint_t omp_block_size          = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+    fast_sint_t c; for (c = 0; c < ALPHABET_SIZE; c += 1) { sa_uint_t A = bucket2[c], B = bucket2_local[c]; bucket2_local[c] = A + B; }
+
+    libsais16_unbwt_calculate_P(T, P, bucket2_local, index, omp_block_start, omp_block_start + omp_block_size);
+}
+
+static void libsais16_unbwt_init_parallel(const uint16_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, sa_uint_t * RESTRICT buckets, sa_sint_t threads)
+{
+    fast_uint_t index = I[0];
+
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+    {
+        fast_sint_t omp_thread_num  = omp_get_thread_num();
+        fast_sint_t omp_num_threads = omp_get_num_threads();
+
+        if (omp_num_threads == 1)
+        {
+            libsais16_unbwt_init_single(T, P, n, freq, I, bucket2, fastbits, shift);
+        }
+        else
+        {
+            libsais16_unbwt_init_parallel_histogram(T, n, buckets, omp_thread_num, omp_num_threads);
+
+            #pragma omp barrier
+
+            libsais16_unbwt_init_parallel_bucket2(bucket2, buckets, omp_thread_num, omp_num_threads);
+
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                libsais16_unbwt_calculate_fastbits(bucket2, fastbits, shift);
+            }
+
+            #pragma omp barrier
+
+            libsais16_unbwt_init_parallel_P(T, P, n, index, bucket2, buckets, omp_thread_num, omp_num_threads);
+
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                memcpy(bucket2, buckets + (omp_num_threads - 1) * ALPHABET_SIZE, ALPHABET_SIZE * sizeof(sa_uint_t));
+            }
+        }
+    }
+}
+
+#endif
+
+static void libsais16_unbwt_decode_1(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t * i0, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = U;
+
+    fast_uint_t i, p0 = *i0;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
+    }
+
+    *i0 = p0;
+}
+
+static void libsais16_unbwt_decode_2(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = U;
+    uint16_t * RESTRICT U1 = U0 + r;
+
+    fast_uint_t i, p0 = *i0, p1 = *i1;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
+    }
+
+    *i0 = p0; *i1 = p1;
+}
+
+static void libsais16_unbwt_decode_3(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = U;
+    uint16_t * RESTRICT U1 = U0 + r;
+    uint16_t * RESTRICT U2 = U1 + r;
+
+    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
+        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = c2;
+    }
+
+    *i0 = p0; *i1 = p1; *i2 = p2;
+}
+
+static void libsais16_unbwt_decode_4(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = U;
+    uint16_t * RESTRICT U1 = U0 + r;
+    uint16_t * RESTRICT U2 = U1 + r;
+    uint16_t * RESTRICT U3 = U2 + r;
+
+    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
+        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = c2;
+        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = c3;
+    }
+
+    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3;
+}
+
+static void libsais16_unbwt_decode_5(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = U;
+    uint16_t * RESTRICT U1 = U0 + r;
+    uint16_t * RESTRICT U2 = U1 + r;
+    uint16_t * RESTRICT U3 = U2 + r;
+    uint16_t * RESTRICT U4 = U3 + r;
+
+    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
+        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = c2;
+        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = c3;
+        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = c4;
+    }
+
+    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4;
+}
+
+static void libsais16_unbwt_decode_6(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t * i5, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = U;
+    uint16_t * RESTRICT U1 = U0 + r;
+    uint16_t * RESTRICT U2 = U1 + r;
+    uint16_t * RESTRICT U3 = U2 + r;
+    uint16_t * RESTRICT U4 = U3 + r;
+    uint16_t * RESTRICT U5 = U4 + r;
+
+    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4, p5 = *i5;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
+        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = c2;
+        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = c3;
+        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = c4;
+        uint16_t c5 = fastbits[p5 >> shift]; if (bucket2[c5] <= p5) { do { c5++; } while (bucket2[c5] <= p5); } p5 = P[p5]; U5[i] = c5;
+    }
+
+    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4; *i5 = p5;
+}
+
+static void libsais16_unbwt_decode_7(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t * i5, fast_uint_t * i6, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = U;
+    uint16_t * RESTRICT U1 = U0 + r;
+    uint16_t * RESTRICT U2 = U1 + r;
+    uint16_t * RESTRICT U3 = U2 + r;
+    uint16_t * RESTRICT U4 = U3 + r;
+    uint16_t * RESTRICT U5 = U4 + r;
+    uint16_t * RESTRICT U6 = U5 + r;
+
+    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4, p5 = *i5, p6 = *i6;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
+        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = c2;
+        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = c3;
+        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = c4;
+        uint16_t c5 = fastbits[p5 >> shift]; if (bucket2[c5] <= p5) { do { c5++; } while (bucket2[c5] <= p5); } p5 = P[p5]; U5[i] = c5;
+        uint16_t c6 = fastbits[p6 >> shift]; if (bucket2[c6] <= p6) { do { c6++; } while (bucket2[c6] <= p6); } p6 = P[p6]; U6[i] = c6;
+    }
+
+    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4; *i5 = p5; *i6 = p6;
+}
+
+static void libsais16_unbwt_decode_8(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t * i5, fast_uint_t * i6, fast_uint_t * i7, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = U;
+    uint16_t * RESTRICT U1 = U0 + r;
+    uint16_t * RESTRICT U2 = U1 + r;
+    uint16_t * RESTRICT U3 = U2 + r;
+    uint16_t * RESTRICT U4 = U3 + r;
+    uint16_t * RESTRICT U5 = U4 + r;
+    uint16_t * RESTRICT U6 = U5 + r;
+    uint16_t * RESTRICT U7 = U6 + r;
+
+    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4, p5 = *i5, p6 = *i6, p7 = *i7;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
+        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = c2;
+        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = c3;
+        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = c4;
+        uint16_t c5 = fastbits[p5 >> shift]; if (bucket2[c5] <= p5) { do { c5++; } while (bucket2[c5] <= p5); } p5 = P[p5]; U5[i] = c5;
+        uint16_t c6 = fastbits[p6 >> shift]; if (bucket2[c6] <= p6) { do { c6++; } while (bucket2[c6] <= p6); } p6 = P[p6]; U6[i] = c6;
+        uint16_t c7 = fastbits[p7 >> shift]; if (bucket2[c7] <= p7) { do { c7++; } while (bucket2[c7] <= p7); } p7 = P[p7]; U7[i] = c7;
+    }
+
+    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4; *i5 = p5; *i6 = p6; *i7 = p7;
+}
+
+static void libsais16_unbwt_decode(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_sint_t blocks, fast_uint_t remainder)
+{
+    fast_uint_t offset      = 0;
+
+    while (blocks > 8)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5], i6 = I[6], i7 = I[7];
+        libsais16_unbwt_decode_8(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, &i7, (fast_uint_t)r);
+        I += 8; blocks -= 8; offset += 8 * (fast_uint_t)r;
+    }
+
+    if (blocks == 1)
+    {
+        fast_uint_t i0 = I[0];
+        libsais16_unbwt_decode_1(U + offset, P, bucket2, fastbits, shift, &i0, remainder);
+    }
+    else if (blocks == 2)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1];
+        libsais16_unbwt_decode_2(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, remainder);
+        libsais16_unbwt_decode_1(U + offset + remainder, P, bucket2, fastbits, shift, &i0, ((fast_uint_t)r) - remainder);
+    }
+    else if (blocks == 3)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2];
+        libsais16_unbwt_decode_3(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, remainder);
+        libsais16_unbwt_decode_2(U + offset + remainder, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, ((fast_uint_t)r) - remainder);
+    }
+    else if (blocks == 4)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3];
+        libsais16_unbwt_decode_4(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, remainder);
+        libsais16_unbwt_decode_3(U + offset + remainder, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, ((fast_uint_t)r) - remainder);
+    }
+    else if (blocks == 5)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4];
+        libsais16_unbwt_decode_5(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, remainder);
+        libsais16_unbwt_decode_4(U + offset + remainder, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, ((fast_uint_t)r) - remainder);
+    }
+    else if (blocks == 6)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5];
+        libsais16_unbwt_decode_6(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, remainder);
+        libsais16_unbwt_decode_5(U + offset + remainder, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, ((fast_uint_t)r) - remainder);
+    }
+    else if (blocks == 7)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5], i6 = I[6];
+        libsais16_unbwt_decode_7(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, remainder);
+        libsais16_unbwt_decode_6(U + offset + remainder, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, ((fast_uint_t)r) - remainder);
+    }
+    else
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5], i6 = I[6], i7 = I[7];
+        libsais16_unbwt_decode_8(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, &i7, remainder);
+        libsais16_unbwt_decode_7(U + offset + remainder, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, ((fast_uint_t)r) - remainder);
+    }
+}
+
+static void libsais16_unbwt_decode_parallel(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_sint_t blocks, fast_uint_t remainder, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    fast_sint_t omp_block_stride    = blocks / omp_num_threads;
+    fast_sint_t omp_block_remainder = blocks % omp_num_threads;
+    fast_sint_t omp_block_size      = omp_block_stride + (omp_thread_num < omp_block_remainder);
+    fast_sint_t omp_block_start     = omp_block_stride * omp_thread_num + (omp_thread_num < omp_block_remainder ? omp_thread_num : omp_block_remainder);
+
+    libsais16_unbwt_decode(U + r * omp_block_start, P, r, I + omp_block_start, bucket2, fastbits, shift, omp_block_size, omp_thread_num < omp_num_threads - 1 ? (fast_uint_t)r : remainder);
+}
+
+static void libsais16_unbwt_decode_omp(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, sa_sint_t threads)
+{
+    fast_sint_t blocks      = 1 + (((fast_sint_t)n - 1) / (fast_sint_t)r);
+    fast_uint_t remainder   = (fast_uint_t)n - ((fast_uint_t)r * ((fast_uint_t)blocks - 1));
+
+#if defined(LIBSAIS_OPENMP)
+    fast_sint_t max_threads = blocks < threads ? blocks : threads;
+    #pragma omp parallel num_threads(max_threads) if(max_threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num      = omp_get_thread_num();
+        fast_sint_t omp_num_threads     = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num      = 0;
+        fast_sint_t omp_num_threads     = 1;
+#endif
+
+        libsais16_unbwt_decode_parallel(U, P, r, I, bucket2, fastbits, shift, blocks, remainder, omp_thread_num, omp_num_threads);
+    }
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+static void libsais16_unbwt_mark_splitters(sa_uint_t * RESTRICT P, fast_uint_t index, fast_uint_t step, fast_sint_t splitters, sa_uint_t mark)
+{
+    fast_sint_t k;
+    for (k = 0; k <= splitters; ++k)
+    {
+        fast_uint_t q = k < splitters ? (fast_uint_t)k * step : index;
+        if (P[q] != (sa_uint_t)-1) { P[q] = (P[q] & (sa_uint_t)SAINT_MAX) | mark; }
+    }
+}
+
+static void libsais16_unbwt_walk_splitters(const sa_uint_t * RESTRICT P, fast_uint_t index, fast_uint_t step, fast_sint_t splitters, sa_uint_t * RESTRICT buckets, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    sa_uint_t * RESTRICT next   = buckets;
+    sa_uint_t * RESTRICT length = buckets + splitters + 1;
+
+    fast_sint_t omp_block_stride    = (splitters + 1) / omp_num_threads;
+    fast_sint_t omp_block_remainder = (splitters + 1) % omp_num_threads;
+    fast_sint_t omp_block_size      = omp_block_stride + (omp_thread_num < omp_block_remainder);
+    fast_sint_t omp_block_start     = omp_block_stride * omp_thread_num + (omp_thread_num < omp_block_remainder ? omp_thread_num : omp_block_remainder);
+
+    fast_sint_t k;
+    for (k = omp_block_start; k < omp_block_start + omp_block_size; ++k)
+    {
+        fast_uint_t q = k < splitters ? (fast_uint_t)k * step : index;
+        fast_uint_t s = 0;
+
+        if (k < splitters && q == index) { next[k] = (sa_uint_t)-1; length[k] = 0; continue; }
+
+        for (;;)
+        {
+            sa_uint_t p = P[q];
+
+            if (p == (sa_uint_t)-1) { next[k] = (sa_uint_t)-1; length[k] = (sa_uint_t)(s + 1); break; }
+            if (s > 0 && (p & (sa_uint_t)SAINT_MIN) != 0) { next[k] = (sa_uint_t)(q == index ? (fast_uint_t)splitters : q / step); length[k] = (sa_uint_t)s; break; }
+
+            q = p & (sa_uint_t)SAINT_MAX; s++;
+        }
+    }
+}
+
+static fast_sint_t libsais16_unbwt_rank_splitters(fast_uint_t index, fast_uint_t step, fast_sint_t splitters, fast_uint_t steps, sa_uint_t * RESTRICT buckets)
+{
+    const sa_uint_t * RESTRICT next     = buckets;
+    const sa_uint_t * RESTRICT length   = buckets + 1 * (splitters + 1);
+    sa_uint_t *       RESTRICT rows     = buckets + 2 * (splitters + 1);
+    sa_uint_t *       RESTRICT offsets  = buckets + 3 * (splitters + 1);
+    sa_uint_t *       RESTRICT lengths  = buckets + 4 * (splitters + 1);
+
+    fast_sint_t segments = 0; fast_uint_t offset = 0, k = (fast_uint_t)splitters;
+    while (offset < steps && segments <= splitters)
+    {
+        rows[segments]      = (sa_uint_t)(k < (fast_uint_t)splitters ? k * step : index);
+        offsets[segments]   = (sa_uint_t)offset;
+        lengths[segments]   = (sa_uint_t)(length[k] < steps - offset ? length[k] : steps - offset);
+
+        offset += length[k]; segments++; if (next[k] == (sa_uint_t)-1) { break; } k = next[k];
+    }
+
+    return segments;
+}
+
+static void libsais16_unbwt_decode_splitters(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_sint_t splitters, fast_sint_t segments, fast_uint_t steps, const sa_uint_t * RESTRICT buckets, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    const sa_uint_t * RESTRICT rows     = buckets + 2 * (splitters + 1);
+    const sa_uint_t * RESTRICT offsets  = buckets + 3 * (splitters + 1);
+    const sa_uint_t * RESTRICT lengths  = buckets + 4 * (splitters + 1);
+
+    fast_uint_t omp_block_stride    = steps / (fast_uint_t)omp_num_threads;
+    fast_uint_t omp_block_start     = omp_block_stride * (fast_uint_t)omp_thread_num;
+    fast_uint_t omp_block_end       = omp_thread_num < omp_num_threads - 1 ? omp_block_start + omp_block_stride : steps;
+
+    fast_sint_t l = 0, h = segments;
+    while (l < h) { fast_sint_t m = l + ((h - l) >> 1); if (offsets[m] < omp_block_start) { l = m + 1; } else { h = m; } }
+
+    for (; l < segments && offsets[l] < omp_block_end; ++l)
+    {
+        fast_uint_t i0 = rows[l];
+        libsais16_unbwt_decode_1(U + (fast_uint_t)offsets[l], P, bucket2, fastbits, shift, &i0, lengths[l]);
+    }
+}
+
+static sa_sint_t libsais16_unbwt_use_splitters(sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    sa_sint_t cores = (sa_sint_t)omp_get_num_procs(); threads = threads < cores ? threads : cores;
+#endif
+
+    return threads >= UNBWT_SPLITTERS_MIN_THREADS && n >= UNBWT_SPLITTERS_MIN_SIZE;
+}
+
+static fast_sint_t libsais16_unbwt_count_splitters(sa_sint_t n, sa_sint_t threads)
+{
+    fast_sint_t splitters = (fast_sint_t)threads * 1024;
+    return splitters < ((fast_sint_t)n + 1) / 16 ? splitters : ((fast_sint_t)n + 1) / 16;
+}
+
+static void libsais16_unbwt_decode_splitters_omp(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, fast_uint_t index, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, sa_uint_t * RESTRICT buckets, sa_sint_t threads)
+{
+    fast_sint_t splitters   = libsais16_unbwt_count_splitters(n, threads);
+    fast_uint_t step        = ((fast_uint_t)n + 1) / (fast_uint_t)splitters;
+    fast_uint_t steps       = (fast_uint_t)n;
+    fast_sint_t segments    = 0;
+
+    libsais16_unbwt_mark_splitters(P, index, step, splitters, (sa_uint_t)SAINT_MIN);
+
+    #pragma omp parallel num_threads(threads) if(threads > 1)
+    {
+        fast_sint_t omp_thread_num      = omp_get_thread_num();
+        fast_sint_t omp_num_threads     = omp_get_num_threads();
+
+        libsais16_unbwt_walk_splitters(P, index, step, splitters, buckets, omp_thread_num, omp_num_threads);
+
+        #pragma omp barrier
+
+        #pragma omp master
+        {
+            libsais16_unbwt_mark_splitters(P, index, step, splitters, 0);
+            segments = libsais16_unbwt_rank_splitters(index, step, splitters, steps, buckets);
+        }
+
+        #pragma omp barrier
+
+        libsais16_unbwt_decode_splitters(U, P, bucket2, fastbits, shift, splitters, segments, steps, buckets, omp_thread_num, omp_num_threads);
+    }
+}
+
+#endif
+
+static sa_sint_t libsais16_unbwt_decode_range(uint16_t * RESTRICT U, const sa_uint_t * RESTRICT P, sa_sint_t n, sa_sint_t r, const sa_uint_t * RESTRICT I, const sa_uint_t * RESTRICT bucket2, const uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t start, fast_uint_t len)
+{
+    fast_uint_t end     = start + len;
+
+    fast_uint_t i = start;
+    while (i < end)
+    {
+        fast_uint_t b = i / (fast_uint_t)r, block_end = (b + 1) * (fast_uint_t)r < end ? (b + 1) * (fast_uint_t)r : end;
+        fast_uint_t j = b * (fast_uint_t)r, p = I[b]; if (p > (fast_uint_t)n) { return -1; }
+
+        for (; j < i; ++j) { p = P[p]; if (p > (fast_uint_t)n) { return -1; } }
+
+        for (; j < block_end; ++j)
+        {
+            uint16_t c = fastbits[p >> shift]; if (bucket2[c] <= p) { do { c++; } while (bucket2[c] <= p); } p = P[p]; if (p > (fast_uint_t)n) { return -1; } U[j - start] = c;
+        }
+
+        i = block_end;
+    }
+
+    return 0;
+}
+
+static sa_sint_t libsais16_unbwt_range_core(const uint16_t * RESTRICT T, uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_sint_t start, sa_sint_t len, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, sa_uint_t * RESTRICT buckets, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    if (threads > 1 && n >= 262144)
+    {
+        libsais16_unbwt_init_parallel(T, P, n, freq, I, bucket2, fastbits, shift, buckets, threads);
+    }
+    else
+#else
+    UNUSED(buckets); UNUSED(threads);
+#endif
+    {
+        libsais16_unbwt_init_single(T, P, n, freq, I, bucket2, fastbits, shift);
+    }
+
+    libsais16_unbwt_decode_range(U, P, n, r, I, bucket2, fastbits, shift, (fast_uint_t)start, (fast_uint_t)len);
+    return 0;
+}
+
+static sa_sint_t libsais16_unbwt_core(const uint16_t * RESTRICT T, uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_sint_t start, sa_sint_t len, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, sa_uint_t * RESTRICT buckets, sa_sint_t threads)
+{
+    if (len < n)
+    {
+        return libsais16_unbwt_range_core(T, U, P, n, freq, r, I, start, len, bucket2, fastbits, shift, buckets, threads);
+    }
+
+#if defined(LIBSAIS_OPENMP)
+    if (threads > 1 && n >= 262144)
+    {
+        if (r >= n && libsais16_unbwt_use_splitters(n, threads)) { memset(P, 0xff, ((size_t)n + 1) * sizeof(sa_uint_t)); }
+
+        libsais16_unbwt_init_parallel(T, P, n, freq, I, bucket2, fastbits, shift, buckets, threads);
+
+        if (r >= n && libsais16_unbwt_use_splitters(n, threads)) { libsais16_unbwt_decode_splitters_omp(U, P, n, I[0], bucket2, fastbits, shift, buckets, threads); return 0; }
+    }
+    else
+#else
+    UNUSED(buckets);
+#endif
+    {
+        libsais16_unbwt_init_single(T, P, n, freq, I, bucket2, fastbits, shift);
+    }
+
+    libsais16_unbwt_decode_omp(U, P, n, r, I, bucket2, fastbits, shift, threads);
+    return 0;
+}
+
+static sa_sint_t libsais16_unbwt_main(const uint16_t * T, uint16_t * U, sa_uint_t * P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * I, sa_sint_t start, sa_sint_t len, sa_sint_t threads)
+{
+    fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+
+    sa_uint_t *     RESTRICT bucket2        = (sa_uint_t *)libsais16_alloc_aligned(ALPHABET_SIZE * sizeof(sa_uint_t), 4096);
+    uint16_t *      RESTRICT fastbits       = (uint16_t *)libsais16_alloc_aligned(((size_t)1 + (size_t)(n >> shift)) * sizeof(uint16_t), 4096);
+    sa_uint_t *     RESTRICT buckets        = threads > 1 && n >= 262144 ? (sa_uint_t *)libsais16_alloc_aligned((size_t)threads * ALPHABET_SIZE * sizeof(sa_uint_t), 4096) : NULL;
+
+    sa_sint_t index = bucket2 != NULL && fastbits != NULL && (buckets != NULL || threads == 1 || n < 262144)
+        ? libsais16_unbwt_core(T, U, P, n, freq, r, I, start, len, bucket2, fastbits, shift, buckets, threads)
+        : -2;
+
+    libsais16_free_aligned(buckets);
+    libsais16_free_aligned(fastbits);
+    libsais16_free_aligned(bucket2);
+
+    return index;
+}
+
+static sa_sint_t libsais16_unbwt_main_ctx(const LIBSAIS_UNBWT_CONTEXT * ctx, const uint16_t * T, uint16_t * U, sa_uint_t * P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * I, sa_sint_t start, sa_sint_t len)
+{
+    if (ctx != NULL && ctx->bucket2 != NULL && ctx->fastbits != NULL && (ctx->buckets != NULL || ctx->threads == 1))
+    {
+        fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << ctx->fastbits_log)) { shift++; }
+        return libsais16_unbwt_core(T, U, P, n, freq, r, I, start, len, ctx->bucket2, ctx->fastbits, shift, ctx->buckets, (sa_sint_t)ctx->threads);
+    }
+
+    return -2;
+}
+
+void * libsais16_unbwt_create_ctx(void)
+{
+    return (void *)libsais16_unbwt_create_ctx_main(1, NULL);
+}
+
+void * libsais16_unbwt_create_ctx_alloc(void * (* alloc_fn)(size_t size, size_t alignment, void * opaque), void (* free_fn)(void * address, void * opaque), void * opaque)
+{
+    if ((alloc_fn == NULL) || (free_fn == NULL)) { return NULL; }
+
+    LIBSAIS_ALLOCATOR allocator = { alloc_fn, free_fn, opaque };
+    return (void *)libsais16_unbwt_create_ctx_main(1, &allocator);
+}
+
+void libsais16_unbwt_free_ctx(void * ctx)
+{
+    libsais16_unbwt_free_ctx_main((LIBSAIS_UNBWT_CONTEXT *)ctx);
+}
+
+int32_t libsais16_unbwt_set_fastbits(void * ctx, int32_t bits)
+{
+    if ((ctx == NULL) || (bits < UNBWT_FASTBITS_MIN) || (bits > UNBWT_FASTBITS_MAX))
+    {
+        return -1;
+    }
+
+    LIBSAIS_UNBWT_CONTEXT * RESTRICT context = (LIBSAIS_UNBWT_CONTEXT *)ctx;
+
+    uint16_t * RESTRICT fastbits = (uint16_t *)libsais16_alloc_memory(&context->allocator, ((size_t)1 + ((size_t)1 << bits)) * sizeof(uint16_t), 4096);
+    if (fastbits == NULL)
+    {
+        return -2;
+    }
+
+    libsais16_free_memory(&context->allocator, context->fastbits);
+
+    context->fastbits       = fastbits;
+    context->fastbits_log   = bits;
+
+    return 0;
+}
+
+int64_t libsais16_unbwt_alloc_size(int32_t threads)
+{
+    if (threads < 0)
+    {
+        return -1;
+    }
+
+#if defined(LIBSAIS_OPENMP)
+    threads = threads > 0 ? threads : omp_get_max_threads();
+#else
+    threads = 1;
+#endif
+
+    return libsais16_unbwt_alloc_size_main(threads);
+}
+
+int32_t libsais16_unbwt_recommend_r(int32_t n, int32_t threads)
+{
+    if ((n < 0) || (threads < 0))
+    {
+        return -1;
+    }
+
+#if defined(LIBSAIS_OPENMP)
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    threads = threads < omp_get_num_procs() ? threads : omp_get_num_procs();
+#else
+    threads = threads > 0 ? threads : 1;
+#endif
+
+    if (threads == 1) { return n; }
+
+    fast_sint_t r = 2; while (r <= (fast_sint_t)n / ((fast_sint_t)threads * 16)) { r <<= 1; }
+    return (int32_t)r;
+}
+
+int32_t libsais16_unbwt(const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t i)
+{
+    return libsais16_unbwt_aux(T, U, A, n, freq, n, &i);
+}
+
+int32_t libsais16_unbwt_ctx(const void * ctx, const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t i)
+{
+    return libsais16_unbwt_aux_ctx(ctx, T, U, A, n, freq, n, &i);
+}
+
+int32_t libsais16_unbwt_aux(const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t r, const int32_t * I)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+        if (n == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+
+    return libsais16_unbwt_main(T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, 0, n, 1);
+}
+
+int32_t libsais16_unbwt_range(const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t r, const int32_t * I, int32_t start, int32_t len)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (start < 0) || (len < 0) || (start > n - len))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+        if (len == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+
+    if (len == 0) { return 0; }
+
+    return libsais16_unbwt_main(T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, start, len, 1);
+}
+
+int32_t libsais16_unbwt_aux_ctx(const void * ctx, const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t r, const int32_t * I)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+        if (n == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+
+    return libsais16_unbwt_main_ctx((const LIBSAIS_UNBWT_CONTEXT *)ctx, T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, 0, n);
+}
+
+int32_t libsais16_unbwt_range_ctx(const void * ctx, const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t r, const int32_t * I, int32_t start, int32_t len)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (start < 0) || (len < 0) || (start > n - len))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+        if (len == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+
+    if (len == 0) { return 0; }
+
+    return libsais16_unbwt_main_ctx((const LIBSAIS_UNBWT_CONTEXT *)ctx, T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, start, len);
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+void * libsais16_unbwt_create_ctx_omp(int32_t threads)
+{
+    if (threads < 0) { return NULL; }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return (void *)libsais16_unbwt_create_ctx_main(threads, NULL);
+}
+
+void * libsais16_unbwt_create_ctx_alloc_omp(int32_t threads, void * (* alloc_fn)(size_t size, size_t alignment, void * opaque), void (* free_fn)(void * address, void * opaque), void * opaque)
+{
+    if ((threads < 0) || (alloc_fn == NULL) || (free_fn == NULL)) { return NULL; }
+
+    LIBSAIS_ALLOCATOR allocator = { alloc_fn, free_fn, opaque };
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return (void *)libsais16_unbwt_create_ctx_main(threads, &allocator);
+}
+
+int32_t libsais16_unbwt_omp(const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t i, int32_t threads)
+{
+    return libsais16_unbwt_aux_omp(T, U, A, n, freq, n, &i, threads);
+}
+
+int32_t libsais16_unbwt_aux_omp(const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t r, const int32_t * I, int32_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+        if (n == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return libsais16_unbwt_main(T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, 0, n, threads);
+}
+
+int32_t libsais16_unbwt_range_omp(const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t r, const int32_t * I, int32_t start, int32_t len, int32_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (start < 0) || (len < 0) || (start > n - len) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+        if (len == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+
+    if (len == 0) { return 0; }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return libsais16_unbwt_main(T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, start, len, threads);
+}
+
+#endif
+
+static int64_t libsais16_unbwt_index_layout(sa_sint_t n, sa_sint_t r, int64_t * RESTRICT offsets)
+{
+    fast_uint_t shift   = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+    int64_t     samples = n > 1 ? (int64_t)1 + (int64_t)((n - 1) / r) : 1;
+
+    offsets[0] = (int64_t)sizeof(LIBSAIS_UNBWT_INDEX);
+    offsets[1] = offsets[0] + (int64_t)(ALPHABET_SIZE) * (int64_t)sizeof(sa_uint_t);
+    offsets[2] = offsets[1] + ((((int64_t)1 + (int64_t)(n >> shift)) * (int64_t)sizeof(uint16_t) + 63) & (-64));
+    offsets[3] = offsets[2] + ((samples * (int64_t)sizeof(sa_uint_t) + 63) & (-64));
+
+    return offsets[3] + ((int64_t)n + 1) * (int64_t)sizeof(sa_uint_t);
+}
+
+static sa_sint_t libsais16_unbwt_index_validate(const void * index, size_t size)
+{
+    const LIBSAIS_UNBWT_INDEX * RESTRICT header = (const LIBSAIS_UNBWT_INDEX *)index;
+
+    if ((index == NULL) || (((size_t)index & 7) != 0) || (size < sizeof(LIBSAIS_UNBWT_INDEX)) || (header->magic != LIBSAIS_UNBWT_INDEX_MAGIC))
+    {
+        return -1;
+    }
+
+    int64_t n = header->n, r = header->r;
+    if ((n < 0) || ((int64_t)(sa_sint_t)n != n) || ((r != n) && ((r < 2) || ((int64_t)(sa_sint_t)r != r) || ((r & (r - 1)) != 0))))
+    {
+        return -1;
+    }
+
+    int64_t offsets[4];
+    if ((uint64_t)libsais16_unbwt_index_layout((sa_sint_t)n, (sa_sint_t)r, offsets) > (uint64_t)size)
+    {
+        return -1;
+    }
+
+    if ((n > 1) && (((const sa_uint_t *)(const void *)((const uint8_t *)index + offsets[0]))[ALPHABET_SIZE - 1] <= (sa_uint_t)n))
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+static sa_sint_t libsais16_unbwt_index_build_main(const uint16_t * T, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * I, void * index, size_t size, sa_sint_t threads)
+{
+    int64_t offsets[4];
+    if ((uint64_t)libsais16_unbwt_index_layout(n, r, offsets) > (uint64_t)size)
+    {
+        return -3;
+    }
+
+    LIBSAIS_UNBWT_INDEX *   RESTRICT header     = (LIBSAIS_UNBWT_INDEX *)index;
+    sa_uint_t *             RESTRICT bucket2    = (sa_uint_t *)(void *)((uint8_t *)index + offsets[0]);
+    uint16_t *              RESTRICT fastbits   = (uint16_t *)(void *)((uint8_t *)index + offsets[1]);
+    sa_uint_t *             RESTRICT samples    = (sa_uint_t *)(void *)((uint8_t *)index + offsets[2]);
+    sa_uint_t *             RESTRICT P          = (sa_uint_t *)(void *)((uint8_t *)index + offsets[3]);
+
+    fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+
+    memset(header, 0, sizeof(LIBSAIS_UNBWT_INDEX));
+    memcpy(samples, I, (n > 1 ? (size_t)1 + (size_t)((n - 1) / r) : 1) * sizeof(sa_uint_t));
+
+    if (n > 1)
+    {
+#if defined(LIBSAIS_OPENMP)
+        if (threads > 1 && n >= 262144)
+        {
+            sa_uint_t * RESTRICT buckets = (sa_uint_t *)libsais16_alloc_aligned((size_t)threads * ALPHABET_SIZE * sizeof(sa_uint_t), 4096);
+            if (buckets == NULL)
+            {
+                return -2;
+            }
+
+            libsais16_unbwt_init_parallel(T, P, n, freq, samples, bucket2, fastbits, shift, buckets, threads);
+            libsais16_free_aligned(buckets);
+        }
+        else
+#else
+        UNUSED(threads);
+#endif
+        {
+            libsais16_unbwt_init_single(T, P, n, freq, samples, bucket2, fastbits, shift);
+        }
+    }
+
+    header->n       = (int64_t)n;
+    header->r       = (int64_t)r;
+    header->lastc   = n > 0 ? (int64_t)T[0] : 0;
+    header->magic   = LIBSAIS_UNBWT_INDEX_MAGIC;
+
+    return 0;
+}
+
+static sa_sint_t libsais16_unbwt_index_decode_main(const void * index, uint16_t * U, sa_sint_t start, sa_sint_t len, sa_sint_t threads)
+{
+    const LIBSAIS_UNBWT_INDEX * RESTRICT header = (const LIBSAIS_UNBWT_INDEX *)index;
+
+    sa_sint_t n = (sa_sint_t)header->n;
+    sa_sint_t r = (sa_sint_t)header->r;
+
+    if (n <= 1)
+    {
+        if (len == 1) { U[0] = (uint16_t)header->lastc; }
+        return 0;
+    }
+
+    int64_t offsets[4]; libsais16_unbwt_index_layout(n, r, offsets);
+
+    const sa_uint_t *   RESTRICT bucket2    = (const sa_uint_t *)(const void *)((const uint8_t *)index + offsets[0]);
+    const uint16_t *    RESTRICT fastbits   = (const uint16_t *)(const void *)((const uint8_t *)index + offsets[1]);
+    const sa_uint_t *   RESTRICT samples    = (const sa_uint_t *)(const void *)((const uint8_t *)index + offsets[2]);
+    const sa_uint_t *   RESTRICT P          = (const sa_uint_t *)(const void *)((const uint8_t *)index + offsets[3]);
+
+    fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+    sa_sint_t corrupted = 0;
+
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && len >= 65536) reduction(|:corrupted)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num      = omp_get_thread_num();
+        fast_sint_t omp_num_threads     = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num      = 0;
+        fast_sint_t omp_num_threads     = 1;
+#endif
+        fast_sint_t omp_block_stride    = ((fast_sint_t)len / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start     = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size      = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : (fast_sint_t)len - omp_block_start;
+
+        corrupted |= libsais16_unbwt_decode_range(U + omp_block_start, P, n, r, samples, bucket2, fastbits, shift, (fast_uint_t)start + (fast_uint_t)omp_block_start, (fast_uint_t)omp_block_size) != 0;
+    }
+
+    return corrupted ? -1 : 0;
+}
+
+int64_t libsais16_unbwt_index_size(int32_t n, int32_t r)
+{
+    if ((n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))))
+    {
+        return -1;
+    }
+
+    int64_t offsets[4]; return libsais16_unbwt_index_layout(n, r, offsets);
+}
+
+int32_t libsais16_unbwt_index_build(const uint16_t * T, int32_t n, const int32_t * freq, int32_t r, const int32_t * I, void * index, size_t size)
+{
+    if ((T == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (index == NULL) || (((size_t)index & 7) != 0))
+    {
+        return -1;
+    }
+
+    fast_sint_t t;
+    if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+    }
+    else
+    {
+        for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+    }
+
+    return libsais16_unbwt_index_build_main(T, n, freq, r, (const sa_uint_t *)I, index, size, 1);
+}
+
+int32_t libsais16_unbwt_index_decode(const void * index, size_t size, uint16_t * U, int32_t start, int32_t len)
+{
+    if ((U == NULL) || (libsais16_unbwt_index_validate(index, size) != 0) || (start < 0) || (len < 0) || (start > ((const LIBSAIS_UNBWT_INDEX *)index)->n - len))
+    {
+        return -1;
+    }
+
+    if (len == 0) { return 0; }
+
+    return libsais16_unbwt_index_decode_main(index, U, start, len, 1);
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+int32_t libsais16_unbwt_index_build_omp(const uint16_t * T, int32_t n, const int32_t * freq, int32_t r, const int32_t * I, void * index, size_t size, int32_t threads)
+{
+    if ((T == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (index == NULL) || (((size_t)index & 7) != 0) || (threads < 0))
+    {
+        return -1;
+    }
+
+    fast_sint_t t;
+    if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+    }
+    else
+    {
+        for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return libsais16_unbwt_index_build_main(T, n, freq, r, (const sa_uint_t *)I, index, size, threads);
+}
+
+int32_t libsais16_unbwt_index_decode_omp(const void * index, size_t size, uint16_t * U, int32_t start, int32_t len, int32_t threads)
+{
+    if ((U == NULL) || (libsais16_unbwt_index_validate(index, size) != 0) || (start < 0) || (len < 0) || (start > ((const LIBSAIS_UNBWT_INDEX *)index)->n - len) || (threads < 0))
+    {
+        return -1;
+    }
+
+    if (len == 0) { return 0; }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return libsais16_unbwt_index_decode_main(index, U, start, len, threads);
+}
+
+#endif
+
+static void libsais16_compute_phi(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j; sa_sint_t k = omp_block_start > 0 ? SA[omp_block_start - 1] : n;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
+    {
+        libsais16_prefetchr(&SA[i + 2 * prefetch_distance]);
+
+        libsais16_prefetchw(&PLCP[SA[i + prefetch_distance + 0]]);
+        libsais16_prefetchw(&PLCP[SA[i + prefetch_distance + 1]]);
+
+        PLCP[SA[i + 0]] = k; k = SA[i + 0];
+        PLCP[SA[i + 1]] = k; k = SA[i + 1];
+
+        libsais16_prefetchw(&PLCP[SA[i + prefetch_distance + 2]]);
+        libsais16_prefetchw(&PLCP[SA[i + prefetch_distance + 3]]);
+
+        PLCP[SA[i + 2]] = k; k = SA[i + 2];
+        PLCP[SA[i + 3]] = k; k = SA[i + 3];
+    }
+
+    for (j += prefetch_distance + 3; i < j; i += 1)
+    {
+        PLCP[SA[i]] = k; k = SA[i];
+    }
+}
+
+static void libsais16_compute_phi_omp(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais16_compute_phi(SA, PLCP, n, omp_block_start, omp_block_size);
+    }
+}
+
+static void libsais16_compute_plcp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, fast_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j, l = 0;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais16_prefetchw(&PLCP[i + 2 * prefetch_distance]);
+        libsais16_prefetchr(&T[PLCP[i + prefetch_distance] + l]);
+
+        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
+        while (l < m && T[i + l] == T[k + l]) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+    }
+
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
+        while (l < m && T[i + l] == T[k + l]) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+    }
+}
+
+static void libsais16_compute_plcp_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais16_compute_plcp(T, PLCP, n, omp_block_start, omp_block_size);
+    }
+}
+
+static void libsais16_compute_plcp_gsa(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, fast_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j, l = 0;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais16_prefetchw(&PLCP[i + 2 * prefetch_distance]);
+        libsais16_prefetchr(&T[PLCP[i + prefetch_distance] + l]);
+
+        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
+        while (l < m && T[i + l] == T[k + l] && T[i + l] != 0) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+    }
+
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
+        while (l < m && T[i + l] == T[k + l] && T[i + l] != 0) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+    }
+}
+
+static void libsais16_compute_plcp_gsa_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais16_compute_plcp_gsa(T, PLCP, n, omp_block_start, omp_block_size);
+    }
+}
+
+static void libsais16_compute_lcp(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
+    {
+        libsais16_prefetchr(&SA[i + 2 * prefetch_distance]);
+        libsais16_prefetchw(&LCP[i + prefetch_distance]);
+
+        libsais16_prefetchr(&PLCP[SA[i + prefetch_distance + 0]]);
+        libsais16_prefetchr(&PLCP[SA[i + prefetch_distance + 1]]);
+
+        LCP[i + 0] = PLCP[SA[i + 0]];
+        LCP[i + 1] = PLCP[SA[i + 1]];
+
+        libsais16_prefetchr(&PLCP[SA[i + prefetch_distance + 2]]);
+        libsais16_prefetchr(&PLCP[SA[i + prefetch_distance + 3]]);
+
+        LCP[i + 2] = PLCP[SA[i + 2]];
+        LCP[i + 3] = PLCP[SA[i + 3]];
+    }
+
+    for (j += prefetch_distance + 3; i < j; i += 1)
+    {
+        LCP[i] = PLCP[SA[i]];
+    }
+}
+
+static void libsais16_compute_lcp_omp(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais16_compute_lcp(PLCP, SA, LCP, omp_block_start, omp_block_size);
+    }
 }
 
-#if defined(LIBSAIS_OPENMP)
-
-static void libsais16_unbwt_init_parallel(const uint16_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, sa_uint_t * RESTRICT buckets, sa_sint_t threads)
+static void libsais16_compute_isa(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT ISA, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    fast_uint_t index = I[0];
-    fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
-    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
     {
-        fast_sint_t omp_thread_num  = omp_get_thread_num();
-        fast_sint_t omp_num_threads = omp_get_num_threads();
+        libsais16_prefetchr(&SA[i + 2 * prefetch_distance]);
 
-        if (omp_num_threads == 1)
-        {
-            libsais16_unbwt_init_single(T, P, n, freq, I, bucket2, fastbits);
-        }
-        else
-        {
-            {
-                sa_uint_t * RESTRICT bucket2_local  = buckets + omp_thread_num * ALPHABET_SIZE;
-                fast_sint_t omp_block_stride        = (n / omp_num_threads) & (-16);
-                fast_sint_t omp_block_start         = omp_thread_num * omp_block_stride;
-                fast_sint_t omp_block_size          = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+        libsais16_prefetchw(&ISA[SA[i + prefetch_distance + 0]]);
+        libsais16_prefetchw(&ISA[SA[i + prefetch_distance + 1]]);
 
-                memset(bucket2_local, 0, ALPHABET_SIZE * sizeof(sa_uint_t));
-                libsais16_unbwt_compute_histogram(T + omp_block_start, omp_block_size, bucket2_local);
-            }
+        ISA[SA[i + 0]] = (sa_sint_t)(i + 0);
+        ISA[SA[i + 1]] = (sa_sint_t)(i + 1);
 
-            #pragma omp barrier
+        libsais16_prefetchw(&ISA[SA[i + prefetch_distance + 2]]);
+        libsais16_prefetchw(&ISA[SA[i + prefetch_distance + 3]]);
 
-            {
-                sa_uint_t * RESTRICT bucket2_temp   = buckets;
-                fast_sint_t omp_block_stride        = (ALPHABET_SIZE / omp_num_threads) & (-16);
-                fast_sint_t omp_block_start         = omp_thread_num * omp_block_stride;
-                fast_sint_t omp_block_size          = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : ALPHABET_SIZE - omp_block_start;
+        ISA[SA[i + 2]] = (sa_sint_t)(i + 2);
+        ISA[SA[i + 3]] = (sa_sint_t)(i + 3);
+    }
 
-                memset(bucket2 + omp_block_start, 0, (size_t)omp_block_size * sizeof(sa_uint_t));
+    for (j += prefetch_distance + 3; i < j; i += 1)
+    {
+        ISA[SA[i]] = (sa_sint_t)i;
+    }
+}
 
-                fast_sint_t t;
-                for (t = 0; t < omp_num_threads; ++t, bucket2_temp += ALPHABET_SIZE)
-                {
-                    fast_sint_t c; for (c = omp_block_start; c < omp_block_start + omp_block_size; c += 1) { sa_uint_t A = bucket2[c], B = bucket2_temp[c]; bucket2[c] = A + B; bucket2_temp[c] = A; }
-                }
-            }
+static void libsais16_compute_isa_inplace(sa_sint_t * RESTRICT SA, sa_sint_t n)
+{
+    fast_sint_t i;
+    for (i = 0; i < n; i += 1)
+    {
+        if (SA[i] >= 0)
+        {
+            sa_sint_t p = (sa_sint_t)i, q = SA[i];
+            while (q != (sa_sint_t)i) { sa_sint_t r = SA[q]; SA[q] = p | SAINT_MIN; p = q; q = r; }
 
-            #pragma omp barrier
+            SA[i] = p | SAINT_MIN;
+        }
+    }
+}
 
-            #pragma omp master
-            {
-                libsais16_unbwt_calculate_fastbits(bucket2, fastbits, shift);
-            }
+static void libsais16_unmark_array(sa_sint_t * RESTRICT A, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i;
+    for (i = omp_block_start; i < omp_block_start + omp_block_size; i += 1)
+    {
+        A[i] &= SAINT_MAX;
+    }
+}
 
-            #pragma omp barrier
+static void libsais16_compute_isa_omp(const sa_sint_t * SA, sa_sint_t * ISA, sa_sint_t n, sa_sint_t threads)
+{
+    if (SA == ISA)
+    {
+        libsais16_compute_isa_inplace(ISA, n);
+    }
 
-            {
-                sa_uint_t * RESTRICT bucket2_local  = buckets + omp_thread_num * ALPHABET_SIZE;
-                fast_sint_t omp_block_stride        = (n / omp_num_threads) & (-16);
-                fast_sint_t omp_block_start         = omp_thread_num * omp_block_stride;
-                fast_sint_t omp_block_size          = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
 
-                fast_sint_t c; for (c = 0; c < ALPHABET_SIZE; c += 1) { sa_uint_t A = bucket2[c], B = bucket2_local[c]; bucket2_local[c] = A + B; }
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
 
-                libsais16_unbwt_calculate_P(T, P, bucket2_local, index, omp_block_start, omp_block_start + omp_block_size);
-            }
+        if (SA == ISA)
+        {
+            libsais16_unmark_array(ISA, omp_block_start, omp_block_size);
+        }
+        else
+        {
+            libsais16_compute_isa(SA, ISA, omp_block_start, omp_block_size);
+        }
+    }
+}
 
-            #pragma omp barrier
+static void libsais16_compute_lcp_inplace(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n)
+{
+    fast_sint_t i;
+    for (i = 0; i < n; i += 1)
+    {
+        if (PLCP[i] >= 0)
+        {
+            sa_sint_t l = PLCP[i]; fast_sint_t j = i, k;
+            while ((k = (fast_sint_t)SA[j]) != i) { PLCP[j] = PLCP[k] | SAINT_MIN; j = k; }
 
-            #pragma omp master
-            {
-                memcpy(bucket2, buckets + (omp_num_threads - 1) * ALPHABET_SIZE, ALPHABET_SIZE * sizeof(sa_uint_t));
-            }
+            PLCP[j] = l | SAINT_MIN;
         }
     }
 }
 
+static void libsais16_compute_lcp_inplace_omp(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+{
+    libsais16_compute_lcp_inplace(SA, PLCP, n);
+
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
 #endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
 
-static void libsais16_unbwt_decode_1(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t * i0, fast_uint_t k)
-{
-    uint16_t * RESTRICT U0 = U;
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
 
-    fast_uint_t i, p0 = *i0;
+        libsais16_unmark_array(PLCP, omp_block_start, omp_block_size);
+    }
+}
 
-    for (i = 0; i != k; ++i)
+static void libsais16_compute_sa_lcp_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, sa_sint_t n, sa_sint_t fs, sa_sint_t threads)
+{
+    if (fs >= n)
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
+        libsais16_compute_phi_omp(SA, &SA[n], n, threads);
+        libsais16_compute_plcp_omp(T, &SA[n], n, threads);
+        libsais16_compute_lcp_omp(&SA[n], SA, LCP, n, threads);
+    }
+    else
+    {
+        libsais16_compute_phi_omp(SA, LCP, n, threads);
+        libsais16_compute_plcp_omp(T, LCP, n, threads);
+        libsais16_compute_lcp_inplace_omp(SA, LCP, n, threads);
     }
-
-    *i0 = p0;
 }
 
-static void libsais16_unbwt_decode_2(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t k)
+static void libsais16_compute_phi_sampled(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t r, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    uint16_t * RESTRICT U0 = U;
-    uint16_t * RESTRICT U1 = U0 + r;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
-    fast_uint_t i, p0 = *i0, p1 = *i1;
-
-    for (i = 0; i != k; ++i)
+    fast_sint_t i, j; sa_sint_t k = omp_block_start > 0 ? SA[omp_block_start - 1] : n, s;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - 3; i < j; i += 4)
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
+        libsais16_prefetchr(&SA[i + prefetch_distance]);
+
+        s = SA[i + 0]; if ((s & (r - 1)) == 0) { PLCP[s / r] = k; } k = s;
+        s = SA[i + 1]; if ((s & (r - 1)) == 0) { PLCP[s / r] = k; } k = s;
+        s = SA[i + 2]; if ((s & (r - 1)) == 0) { PLCP[s / r] = k; } k = s;
+        s = SA[i + 3]; if ((s & (r - 1)) == 0) { PLCP[s / r] = k; } k = s;
     }
 
-    *i0 = p0; *i1 = p1;
+    for (j += 3; i < j; i += 1)
+    {
+        s = SA[i]; if ((s & (r - 1)) == 0) { PLCP[s / r] = k; } k = s;
+    }
 }
 
-static void libsais16_unbwt_decode_3(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t k)
+static void libsais16_compute_phi_sampled_omp(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t r, sa_sint_t threads)
 {
-    uint16_t * RESTRICT U0 = U;
-    uint16_t * RESTRICT U1 = U0 + r;
-    uint16_t * RESTRICT U2 = U1 + r;
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
 
-    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2;
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
 
-    for (i = 0; i != k; ++i)
-    {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
-        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = c2;
+        libsais16_compute_phi_sampled(SA, PLCP, n, r, omp_block_start, omp_block_size);
     }
-
-    *i0 = p0; *i1 = p1; *i2 = p2;
 }
 
-static void libsais16_unbwt_decode_4(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t k)
+static void libsais16_compute_plcp_sampled(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, fast_sint_t n, fast_sint_t r, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    uint16_t * RESTRICT U0 = U;
-    uint16_t * RESTRICT U1 = U0 + r;
-    uint16_t * RESTRICT U2 = U1 + r;
-    uint16_t * RESTRICT U3 = U2 + r;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
-    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3;
+    fast_sint_t i, j, l = 0;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais16_prefetchw(&PLCP[i + 2 * prefetch_distance]);
+        libsais16_prefetchr(&T[(i + prefetch_distance) * r + l]);
+        libsais16_prefetchr(&T[PLCP[i + prefetch_distance] + l]);
 
-    for (i = 0; i != k; ++i)
+        fast_sint_t p = i * r, k = PLCP[i], m = n - (p > k ? p : k);
+        while (l < m && T[p + l] == T[k + l]) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l = l > r ? l - r : 0;
+    }
+
+    for (j += prefetch_distance; i < j; i += 1)
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
-        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = c2;
-        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = c3;
+        fast_sint_t p = i * r, k = PLCP[i], m = n - (p > k ? p : k);
+        while (l < m && T[p + l] == T[k + l]) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l = l > r ? l - r : 0;
     }
+}
 
-    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3;
+static void libsais16_compute_plcp_sampled_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t r, sa_sint_t threads)
+{
+    fast_sint_t m = ((fast_sint_t)n - 1) / r + 1;
+
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (m / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : m - omp_block_start;
+
+        libsais16_compute_plcp_sampled(T, PLCP, n, r, omp_block_start, omp_block_size);
+    }
 }
 
-static void libsais16_unbwt_decode_5(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t k)
+static sa_sint_t libsais16_compute_lcp_sample(const uint16_t * RESTRICT T, const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, fast_sint_t n, fast_sint_t r, fast_sint_t i)
 {
-    uint16_t * RESTRICT U0 = U;
-    uint16_t * RESTRICT U1 = U0 + r;
-    uint16_t * RESTRICT U2 = U1 + r;
-    uint16_t * RESTRICT U3 = U2 + r;
-    uint16_t * RESTRICT U4 = U3 + r;
+    if (i == 0) { return 0; }
 
-    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4;
+    fast_sint_t p = SA[i], k = SA[i - 1], m = n - (p > k ? p : k);
+    fast_sint_t l = PLCP[p / r] - (p & (r - 1)); l = l > 0 ? l : 0;
+    while (l < m && T[p + l] == T[k + l]) { l++; }
 
-    for (i = 0; i != k; ++i)
+    return (sa_sint_t)l;
+}
+
+static void libsais16_compute_lcp_sampled(const uint16_t * RESTRICT T, const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, fast_sint_t n, fast_sint_t r, fast_sint_t k, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
-        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = c2;
-        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = c3;
-        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = c4;
+        libsais16_prefetchr(&SA[(i + 2 * prefetch_distance) * k - 1]);
+        libsais16_prefetchr(&PLCP[SA[(i + prefetch_distance) * k] / r]);
+
+        LCP[i] = libsais16_compute_lcp_sample(T, PLCP, SA, n, r, i * k);
     }
 
-    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4;
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        LCP[i] = libsais16_compute_lcp_sample(T, PLCP, SA, n, r, i * k);
+    }
 }
 
-static void libsais16_unbwt_decode_6(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t * i5, fast_uint_t k)
+static void libsais16_compute_lcp_sampled_omp(const uint16_t * RESTRICT T, const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, sa_sint_t n, sa_sint_t r, sa_sint_t k, sa_sint_t threads)
 {
-    uint16_t * RESTRICT U0 = U;
-    uint16_t * RESTRICT U1 = U0 + r;
-    uint16_t * RESTRICT U2 = U1 + r;
-    uint16_t * RESTRICT U3 = U2 + r;
-    uint16_t * RESTRICT U4 = U3 + r;
-    uint16_t * RESTRICT U5 = U4 + r;
+    fast_sint_t m = ((fast_sint_t)n - 1) / k + 1;
+
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && m >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (m / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : m - omp_block_start;
+
+        libsais16_compute_lcp_sampled(T, PLCP, SA, LCP, n, r, k, omp_block_start, omp_block_size);
+    }
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+static fast_sint_t libsais16_count_marked(const uint8_t * RESTRICT B, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i, j, c = 0;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - 7; i < j; i += 8)
+    {
+        fast_uint_t x = B[i >> 3];
 
-    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4, p5 = *i5;
+        x = x - ((x >> 1) & 0x55); x = (x & 0x33) + ((x >> 2) & 0x33); c += (fast_sint_t)((x + (x >> 4)) & 0x0f);
+    }
 
-    for (i = 0; i != k; ++i)
+    for (j += 7; i < j; i += 1)
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
-        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = c2;
-        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = c3;
-        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = c4;
-        uint16_t c5 = fastbits[p5 >> shift]; if (bucket2[c5] <= p5) { do { c5++; } while (bucket2[c5] <= p5); } p5 = P[p5]; U5[i] = c5;
+        c += (B[i >> 3] >> (i & 7)) & 1;
     }
 
-    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4; *i5 = p5;
+    return c;
 }
 
-static void libsais16_unbwt_decode_7(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t * i5, fast_uint_t * i6, fast_uint_t k)
-{
-    uint16_t * RESTRICT U0 = U;
-    uint16_t * RESTRICT U1 = U0 + r;
-    uint16_t * RESTRICT U2 = U1 + r;
-    uint16_t * RESTRICT U3 = U2 + r;
-    uint16_t * RESTRICT U4 = U3 + r;
-    uint16_t * RESTRICT U5 = U4 + r;
-    uint16_t * RESTRICT U6 = U5 + r;
-
-    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4, p5 = *i5, p6 = *i6;
+#endif
 
-    for (i = 0; i != k; ++i)
+static fast_sint_t libsais16_compute_lcp_marked(const uint16_t * RESTRICT T, const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, const uint8_t * RESTRICT B, sa_sint_t * RESTRICT LCP, fast_sint_t n, fast_sint_t r, fast_sint_t c, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size; i < j; i += 1)
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
-        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = c2;
-        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = c3;
-        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = c4;
-        uint16_t c5 = fastbits[p5 >> shift]; if (bucket2[c5] <= p5) { do { c5++; } while (bucket2[c5] <= p5); } p5 = P[p5]; U5[i] = c5;
-        uint16_t c6 = fastbits[p6 >> shift]; if (bucket2[c6] <= p6) { do { c6++; } while (bucket2[c6] <= p6); } p6 = P[p6]; U6[i] = c6;
+        if ((B[i >> 3] >> (i & 7)) & 1)
+        {
+            LCP[c++] = libsais16_compute_lcp_sample(T, PLCP, SA, n, r, i);
+        }
     }
 
-    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4; *i5 = p5; *i6 = p6;
+    return c;
 }
 
-static void libsais16_unbwt_decode_8(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t * i5, fast_uint_t * i6, fast_uint_t * i7, fast_uint_t k)
+static sa_sint_t libsais16_compute_lcp_marked_omp(const uint16_t * RESTRICT T, const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, const uint8_t * RESTRICT B, sa_sint_t * RESTRICT LCP, sa_sint_t n, sa_sint_t r, sa_sint_t threads)
 {
-    uint16_t * RESTRICT U0 = U;
-    uint16_t * RESTRICT U1 = U0 + r;
-    uint16_t * RESTRICT U2 = U1 + r;
-    uint16_t * RESTRICT U3 = U2 + r;
-    uint16_t * RESTRICT U4 = U3 + r;
-    uint16_t * RESTRICT U5 = U4 + r;
-    uint16_t * RESTRICT U6 = U5 + r;
-    uint16_t * RESTRICT U7 = U6 + r;
+    fast_sint_t count = 0;
 
-    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4, p5 = *i5, p6 = *i6, p7 = *i7;
+#if defined(LIBSAIS_OPENMP)
+    fast_sint_t * RESTRICT counts = threads > 1 && n >= 65536 ? (fast_sint_t *)libsais16_alloc_aligned((size_t)threads * sizeof(fast_sint_t), 64) : NULL;
+    if (threads > 1 && n >= 65536 && counts == NULL) { return -2; }
 
-    for (i = 0; i != k; ++i)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
-        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = c2;
-        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = c3;
-        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = c4;
-        uint16_t c5 = fastbits[p5 >> shift]; if (bucket2[c5] <= p5) { do { c5++; } while (bucket2[c5] <= p5); } p5 = P[p5]; U5[i] = c5;
-        uint16_t c6 = fastbits[p6 >> shift]; if (bucket2[c6] <= p6) { do { c6++; } while (bucket2[c6] <= p6); } p6 = P[p6]; U6[i] = c6;
-        uint16_t c7 = fastbits[p7 >> shift]; if (bucket2[c7] <= p7) { do { c7++; } while (bucket2[c7] <= p7); } p7 = P[p7]; U7[i] = c7;
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        if (omp_num_threads == 1)
+        {
+            count = libsais16_compute_lcp_marked(T, PLCP, SA, B, LCP, n, r, 0, omp_block_start, omp_block_size);
+        }
+#if defined(LIBSAIS_OPENMP)
+        else
+        {
+            counts[omp_thread_num] = libsais16_count_marked(B, omp_block_start, omp_block_size);
+
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                fast_sint_t t, c = 0; for (t = 0; t < omp_num_threads; ++t) { fast_sint_t m = counts[t]; counts[t] = c; c += m; }
+
+                count = c;
+            }
+
+            #pragma omp barrier
+
+            libsais16_compute_lcp_marked(T, PLCP, SA, B, LCP, n, r, counts[omp_thread_num], omp_block_start, omp_block_size);
+        }
+#endif
     }
 
-    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4; *i5 = p5; *i6 = p6; *i7 = p7;
+#if defined(LIBSAIS_OPENMP)
+    libsais16_free_aligned(counts);
+#endif
+
+    return (sa_sint_t)count;
 }
 
-static void libsais16_unbwt_decode(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_sint_t blocks, fast_uint_t remainder)
+static fast_sint_t libsais16_compute_lcp_8u(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, uint8_t * RESTRICT LCP, sa_sint_t * RESTRICT X, fast_sint_t xs, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    fast_uint_t shift       = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
-    fast_uint_t offset      = 0;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
-    while (blocks > 8)
+    fast_sint_t i, j, c = 0;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
     {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5], i6 = I[6], i7 = I[7];
-        libsais16_unbwt_decode_8(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, &i7, (fast_uint_t)r);
-        I += 8; blocks -= 8; offset += 8 * (fast_uint_t)r;
-    }
+        libsais16_prefetchr(&SA[i + 2 * prefetch_distance]);
+        libsais16_prefetchr(&PLCP[SA[i + prefetch_distance]]);
 
-    if (blocks == 1)
-    {
-        fast_uint_t i0 = I[0];
-        libsais16_unbwt_decode_1(U + offset, P, bucket2, fastbits, shift, &i0, remainder);
-    }
-    else if (blocks == 2)
-    {
-        fast_uint_t i0 = I[0], i1 = I[1];
-        libsais16_unbwt_decode_2(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, remainder);
-        libsais16_unbwt_decode_1(U + offset + remainder, P, bucket2, fastbits, shift, &i0, ((fast_uint_t)r) - remainder);
-    }
-    else if (blocks == 3)
-    {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2];
-        libsais16_unbwt_decode_3(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, remainder);
-        libsais16_unbwt_decode_2(U + offset + remainder, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, ((fast_uint_t)r) - remainder);
-    }
-    else if (blocks == 4)
-    {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3];
-        libsais16_unbwt_decode_4(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, remainder);
-        libsais16_unbwt_decode_3(U + offset + remainder, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, ((fast_uint_t)r) - remainder);
-    }
-    else if (blocks == 5)
-    {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4];
-        libsais16_unbwt_decode_5(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, remainder);
-        libsais16_unbwt_decode_4(U + offset + remainder, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, ((fast_uint_t)r) - remainder);
-    }
-    else if (blocks == 6)
-    {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5];
-        libsais16_unbwt_decode_6(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, remainder);
-        libsais16_unbwt_decode_5(U + offset + remainder, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, ((fast_uint_t)r) - remainder);
+        sa_sint_t l = PLCP[SA[i]];
+        if (l < UINT8_MAX) { LCP[i] = (uint8_t)l; } else { LCP[i] = UINT8_MAX; if (c < xs) { X[2 * c + 0] = (sa_sint_t)i; X[2 * c + 1] = l; } c++; }
     }
-    else if (blocks == 7)
+
+    for (j += prefetch_distance; i < j; i += 1)
     {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5], i6 = I[6];
-        libsais16_unbwt_decode_7(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, remainder);
-        libsais16_unbwt_decode_6(U + offset + remainder, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, ((fast_uint_t)r) - remainder);
+        sa_sint_t l = PLCP[SA[i]];
+        if (l < UINT8_MAX) { LCP[i] = (uint8_t)l; } else { LCP[i] = UINT8_MAX; if (c < xs) { X[2 * c + 0] = (sa_sint_t)i; X[2 * c + 1] = l; } c++; }
     }
-    else
+
+    return c;
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+static void libsais16_gather_lcp_8u_exceptions(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, const uint8_t * RESTRICT LCP, sa_sint_t * RESTRICT X, fast_sint_t xs, fast_sint_t c, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size; i < j && c < xs; i += 1)
     {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5], i6 = I[6], i7 = I[7];
-        libsais16_unbwt_decode_8(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, &i7, remainder);
-        libsais16_unbwt_decode_7(U + offset + remainder, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, ((fast_uint_t)r) - remainder);
+        if (LCP[i] == UINT8_MAX) { X[2 * c + 0] = (sa_sint_t)i; X[2 * c + 1] = PLCP[SA[i]]; c++; }
     }
 }
 
-static void libsais16_unbwt_decode_omp(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, sa_sint_t threads)
+#endif
+
+static sa_sint_t libsais16_compute_lcp_8u_omp(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, uint8_t * RESTRICT LCP, sa_sint_t n, sa_sint_t * RESTRICT X, sa_sint_t xs, sa_sint_t threads)
 {
-    fast_sint_t blocks      = 1 + (((fast_sint_t)n - 1) / (fast_sint_t)r);
-    fast_uint_t remainder   = (fast_uint_t)n - ((fast_uint_t)r * ((fast_uint_t)blocks - 1));
+    fast_sint_t count = 0;
 
 #if defined(LIBSAIS_OPENMP)
-    fast_sint_t max_threads = blocks < threads ? blocks : threads;
-    #pragma omp parallel num_threads(max_threads) if(max_threads > 1 && n >= 65536)
+    fast_sint_t * RESTRICT counts = threads > 1 && n >= 65536 ? (fast_sint_t *)libsais16_alloc_aligned((size_t)threads * sizeof(fast_sint_t), 64) : NULL;
+    if (threads > 1 && n >= 65536 && counts == NULL) { return -2; }
+
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
 #endif
     {
 #if defined(LIBSAIS_OPENMP)
-        fast_sint_t omp_thread_num      = omp_get_thread_num();
-        fast_sint_t omp_num_threads     = omp_get_num_threads();
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
 #else
         UNUSED(threads);
 
-        fast_sint_t omp_thread_num      = 0;
-        fast_sint_t omp_num_threads     = 1;
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
 #endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        if (omp_num_threads == 1)
+        {
+            count = libsais16_compute_lcp_8u(PLCP, SA, LCP, X, xs, omp_block_start, omp_block_size);
+        }
+#if defined(LIBSAIS_OPENMP)
+        else
+        {
+            counts[omp_thread_num] = libsais16_compute_lcp_8u(PLCP, SA, LCP, X, 0, omp_block_start, omp_block_size);
 
-        fast_sint_t omp_block_stride    = blocks / omp_num_threads;
-        fast_sint_t omp_block_remainder = blocks % omp_num_threads;
-        fast_sint_t omp_block_size      = omp_block_stride + (omp_thread_num < omp_block_remainder);
-        fast_sint_t omp_block_start     = omp_block_stride * omp_thread_num + (omp_thread_num < omp_block_remainder ? omp_thread_num : omp_block_remainder);
+            #pragma omp barrier
+
+            fast_sint_t t, c = 0; for (t = 0; t < omp_thread_num; ++t) { c += counts[t]; }
 
-        libsais16_unbwt_decode(U + r * omp_block_start, P, n, r, I + omp_block_start, bucket2, fastbits, omp_block_size, omp_thread_num < omp_num_threads - 1 ? (fast_uint_t)r : remainder);
+            libsais16_gather_lcp_8u_exceptions(PLCP, SA, LCP, X, xs, c, omp_block_start, omp_block_size);
+
+            if (omp_thread_num == omp_num_threads - 1) { count = c + counts[omp_thread_num]; }
+        }
+#endif
     }
-}
 
-static sa_sint_t libsais16_unbwt_core(const uint16_t * RESTRICT T, uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, sa_uint_t * RESTRICT buckets, sa_sint_t threads)
-{
 #if defined(LIBSAIS_OPENMP)
-    if (threads > 1 && n >= 262144)
-    {
-        libsais16_unbwt_init_parallel(T, P, n, freq, I, bucket2, fastbits, buckets, threads);
-    }
-    else
-#else
-    UNUSED(buckets);
+    libsais16_free_aligned(counts);
 #endif
-    {
-        libsais16_unbwt_init_single(T, P, n, freq, I, bucket2, fastbits);
-    }
 
-    libsais16_unbwt_decode_omp(U, P, n, r, I, bucket2, fastbits, threads);
-    return 0;
+    return (sa_sint_t)count;
 }
 
-static sa_sint_t libsais16_unbwt_main(const uint16_t * T, uint16_t * U, sa_uint_t * P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * I, sa_sint_t threads)
+int32_t libsais16_plcp(const uint16_t * T, const int32_t * SA, int32_t * PLCP, int32_t n)
 {
-    fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
-
-    sa_uint_t *     RESTRICT bucket2        = (sa_uint_t *)libsais16_alloc_aligned(ALPHABET_SIZE * sizeof(sa_uint_t), 4096);
-    uint16_t *      RESTRICT fastbits       = (uint16_t *)libsais16_alloc_aligned(((size_t)1 + (size_t)(n >> shift)) * sizeof(uint16_t), 4096);
-    sa_uint_t *     RESTRICT buckets        = threads > 1 && n >= 262144 ? (sa_uint_t *)libsais16_alloc_aligned((size_t)threads * ALPHABET_SIZE * sizeof(sa_uint_t), 4096) : NULL;
-
-    sa_sint_t index = bucket2 != NULL && fastbits != NULL && (buckets != NULL || threads == 1 || n < 262144)
-        ? libsais16_unbwt_core(T, U, P, n, freq, r, I, bucket2, fastbits, buckets, threads)
-        : -2;
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { PLCP[0] = 0; }
+        return 0;
+    }
 
-    libsais16_free_aligned(buckets);
-    libsais16_free_aligned(fastbits);
-    libsais16_free_aligned(bucket2);
+    libsais16_compute_phi_omp(SA, PLCP, n, 1);
+    libsais16_compute_plcp_omp(T, PLCP, n, 1);
 
-    return index;
+    return 0;
 }
 
-static sa_sint_t libsais16_unbwt_main_ctx(const LIBSAIS_UNBWT_CONTEXT * ctx, const uint16_t * T, uint16_t * U, sa_uint_t * P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * I)
+int32_t libsais16_plcp_gsa(const uint16_t * T, const int32_t * SA, int32_t * PLCP, int32_t n)
 {
-    return ctx != NULL && ctx->bucket2 != NULL && ctx->fastbits != NULL && (ctx->buckets != NULL || ctx->threads == 1)
-        ? libsais16_unbwt_core(T, U, P, n, freq, r, I, ctx->bucket2, ctx->fastbits, ctx->buckets, (sa_sint_t)ctx->threads)
-        : -2;
-}
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { PLCP[0] = 0; }
+        return 0;
+    }
 
-void * libsais16_unbwt_create_ctx(void)
-{
-    return (void *)libsais16_unbwt_create_ctx_main(1);
-}
+    libsais16_compute_phi_omp(SA, PLCP, n, 1);
+    libsais16_compute_plcp_gsa_omp(T, PLCP, n, 1);
 
-void libsais16_unbwt_free_ctx(void * ctx)
-{
-    libsais16_unbwt_free_ctx_main((LIBSAIS_UNBWT_CONTEXT *)ctx);
+    return 0;
 }
 
-int32_t libsais16_unbwt(const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t i)
+int32_t libsais16_lcp(const int32_t * PLCP, const int32_t * SA, int32_t * LCP, int32_t n)
 {
-    return libsais16_unbwt_aux(T, U, A, n, freq, n, &i);
-}
+    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { LCP[0] = PLCP[SA[0]]; }
+        return 0;
+    }
 
-int32_t libsais16_unbwt_ctx(const void * ctx, const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t i)
-{
-    return libsais16_unbwt_aux_ctx(ctx, T, U, A, n, freq, n, &i);
+    libsais16_compute_lcp_omp(PLCP, SA, LCP, n, 1);
+
+    return 0;
 }
 
-int32_t libsais16_unbwt_aux(const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t r, const int32_t * I)
+int32_t libsais16_plcp_sampled(const uint16_t * T, const int32_t * SA, int32_t * PLCP, int32_t n, int32_t r)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL))
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (r <= 0) || ((r & (r - 1)) != 0))
     {
         return -1;
     }
     else if (n <= 1)
     {
-        if (I[0] != n) { return -1; }
-        if (n == 1) { U[0] = T[0]; }
+        if (n == 1) { PLCP[0] = 0; }
         return 0;
     }
 
-    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+    libsais16_compute_phi_sampled_omp(SA, PLCP, n, r, 1);
+    libsais16_compute_plcp_sampled_omp(T, PLCP, n, r, 1);
 
-    return libsais16_unbwt_main(T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, 1);
+    return 0;
 }
 
-int32_t libsais16_unbwt_aux_ctx(const void * ctx, const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t r, const int32_t * I)
+int32_t libsais16_lcp_sampled(const uint16_t * T, const int32_t * PLCP, const int32_t * SA, int32_t * LCP, int32_t n, int32_t r, int32_t k)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL))
+    if ((T == NULL) || (PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (r <= 0) || ((r & (r - 1)) != 0) || (k <= 0))
     {
         return -1;
     }
     else if (n <= 1)
     {
-        if (I[0] != n) { return -1; }
-        if (n == 1) { U[0] = T[0]; }
+        if (n == 1) { LCP[0] = 0; }
         return 0;
     }
 
-    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+    libsais16_compute_lcp_sampled_omp(T, PLCP, SA, LCP, n, r, k, 1);
 
-    return libsais16_unbwt_main_ctx((const LIBSAIS_UNBWT_CONTEXT *)ctx, T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I);
+    return 0;
 }
 
-#if defined(LIBSAIS_OPENMP)
-
-void * libsais16_unbwt_create_ctx_omp(int32_t threads)
+int32_t libsais16_lcp_marked(const uint16_t * T, const int32_t * PLCP, const int32_t * SA, const uint8_t * B, int32_t * LCP, int32_t n, int32_t r)
 {
-    if (threads < 0) { return NULL; }
+    if ((T == NULL) || (PLCP == NULL) || (SA == NULL) || (B == NULL) || (LCP == NULL) || (n < 0) || (r <= 0) || ((r & (r - 1)) != 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1 && (B[0] & 1)) { LCP[0] = 0; return 1; }
+        return 0;
+    }
 
-    threads = threads > 0 ? threads : omp_get_max_threads();
-    return (void *)libsais16_unbwt_create_ctx_main(threads);
+    return libsais16_compute_lcp_marked_omp(T, PLCP, SA, B, LCP, n, r, 1);
 }
 
-int32_t libsais16_unbwt_omp(const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t i, int32_t threads)
+int32_t libsais16_lcp_8u(const int32_t * PLCP, const int32_t * SA, uint8_t * LCP, int32_t n, int32_t * X, int32_t xs)
 {
-    return libsais16_unbwt_aux_omp(T, U, A, n, freq, n, &i, threads);
+    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (xs < 0) || (X == NULL && xs > 0))
+    {
+        return -1;
+    }
+
+    return libsais16_compute_lcp_8u_omp(PLCP, SA, LCP, n, X, xs, 1);
 }
 
-int32_t libsais16_unbwt_aux_omp(const uint16_t * T, uint16_t * U, int32_t * A, int32_t n, const int32_t * freq, int32_t r, const int32_t * I, int32_t threads)
+int32_t libsais16_isa(const int32_t * SA, int32_t * ISA, int32_t n)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (threads < 0))
+    if ((SA == NULL) || (ISA == NULL) || (n < 0))
     {
         return -1;
     }
     else if (n <= 1)
     {
-        if (I[0] != n) { return -1; }
-        if (n == 1) { U[0] = T[0]; }
+        if (n == 1) { ISA[0] = 0; }
         return 0;
     }
 
-    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+    libsais16_compute_isa_omp(SA, ISA, n, 1);
 
-    threads = threads > 0 ? threads : omp_get_max_threads();
-    return libsais16_unbwt_main(T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, threads);
+    return 0;
 }
 
-#endif
-
-static void libsais16_compute_phi(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+int32_t libsais16_sa_lcp(const uint16_t * T, int32_t * SA, int32_t * LCP, int32_t n, int32_t fs, int32_t * freq)
 {
-    const fast_sint_t prefetch_distance = 32;
-
-    fast_sint_t i, j; sa_sint_t k = omp_block_start > 0 ? SA[omp_block_start - 1] : n;
-    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
+    if ((T == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (fs < 0))
     {
-        libsais16_prefetchr(&SA[i + 2 * prefetch_distance]);
-
-        libsais16_prefetchw(&PLCP[SA[i + prefetch_distance + 0]]);
-        libsais16_prefetchw(&PLCP[SA[i + prefetch_distance + 1]]);
-
-        PLCP[SA[i + 0]] = k; k = SA[i + 0];
-        PLCP[SA[i + 1]] = k; k = SA[i + 1];
-
-        libsais16_prefetchw(&PLCP[SA[i + prefetch_distance + 2]]);
-        libsais16_prefetchw(&PLCP[SA[i + prefetch_distance + 3]]);
-
-        PLCP[SA[i + 2]] = k; k = SA[i + 2];
-        PLCP[SA[i + 3]] = k; k = SA[i + 3];
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { SA[0] = 0; LCP[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
     }
 
-    for (j += prefetch_distance + 3; i < j; i += 1)
+    sa_sint_t index = libsais16_main(T, SA, n, 0, 0, NULL, NULL, fs, freq, 1);
+    if (index == 0)
     {
-        PLCP[SA[i]] = k; k = SA[i];
+        libsais16_compute_sa_lcp_omp(T, SA, LCP, n, fs, 1);
     }
+
+    return index;
 }
 
-static void libsais16_compute_phi_omp(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+int32_t libsais16_sa_lcp_ctx(const void * ctx, const uint16_t * T, int32_t * SA, int32_t * LCP, int32_t n, int32_t fs, int32_t * freq)
 {
-#if defined(LIBSAIS_OPENMP)
-    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
-#endif
+    if ((ctx == NULL) || (T == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (fs < 0))
     {
-#if defined(LIBSAIS_OPENMP)
-        fast_sint_t omp_thread_num    = omp_get_thread_num();
-        fast_sint_t omp_num_threads   = omp_get_num_threads();
-#else
-        UNUSED(threads);
-
-        fast_sint_t omp_thread_num    = 0;
-        fast_sint_t omp_num_threads   = 1;
-#endif
-        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
-        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
-        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { SA[0] = 0; LCP[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
 
-        libsais16_compute_phi(SA, PLCP, n, omp_block_start, omp_block_size);
+    sa_sint_t index = libsais16_main_ctx((const LIBSAIS_CONTEXT *)ctx, T, SA, n, 0, 0, NULL, NULL, fs, freq);
+    if (index == 0)
+    {
+        libsais16_compute_sa_lcp_omp(T, SA, LCP, n, fs, (sa_sint_t)((const LIBSAIS_CONTEXT *)ctx)->threads);
     }
+
+    return index;
 }
 
-static void libsais16_compute_plcp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, fast_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
-{
-    const fast_sint_t prefetch_distance = 32;
+#if defined(LIBSAIS_OPENMP)
 
-    fast_sint_t i, j, l = 0;
-    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+int32_t libsais16_plcp_omp(const uint16_t * T, const int32_t * SA, int32_t * PLCP, int32_t n, int32_t threads)
+{
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (threads < 0))
     {
-        libsais16_prefetchw(&PLCP[i + 2 * prefetch_distance]);
-        libsais16_prefetchr(&T[PLCP[i + prefetch_distance] + l]);
-
-        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
-        while (l < m && T[i + l] == T[k + l]) { l++; }
-
-        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+        return -1;
     }
-
-    for (j += prefetch_distance; i < j; i += 1)
+    else if (n <= 1)
     {
-        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
-        while (l < m && T[i + l] == T[k + l]) { l++; }
-
-        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+        if (n == 1) { PLCP[0] = 0; }
+        return 0;
     }
+    
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    libsais16_compute_phi_omp(SA, PLCP, n, threads);
+    libsais16_compute_plcp_omp(T, PLCP, n, threads);
+
+    return 0;
 }
 
-static void libsais16_compute_plcp_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+int32_t libsais16_plcp_gsa_omp(const uint16_t * T, const int32_t * SA, int32_t * PLCP, int32_t n, int32_t threads)
 {
-#if defined(LIBSAIS_OPENMP)
-    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
-#endif
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (threads < 0))
     {
-#if defined(LIBSAIS_OPENMP)
-        fast_sint_t omp_thread_num    = omp_get_thread_num();
-        fast_sint_t omp_num_threads   = omp_get_num_threads();
-#else
-        UNUSED(threads);
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { PLCP[0] = 0; }
+        return 0;
+    }
+    
+    threads = threads > 0 ? threads : omp_get_max_threads();
 
-        fast_sint_t omp_thread_num    = 0;
-        fast_sint_t omp_num_threads   = 1;
-#endif
-        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
-        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
-        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+    libsais16_compute_phi_omp(SA, PLCP, n, threads);
+    libsais16_compute_plcp_gsa_omp(T, PLCP, n, threads);
 
-        libsais16_compute_plcp(T, PLCP, n, omp_block_start, omp_block_size);
-    }
+    return 0;
 }
 
-static void libsais16_compute_lcp(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+int32_t libsais16_lcp_omp(const int32_t * PLCP, const int32_t * SA, int32_t * LCP, int32_t n, int32_t threads)
 {
-    const fast_sint_t prefetch_distance = 32;
-
-    fast_sint_t i, j;
-    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
+    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (threads < 0))
     {
-        libsais16_prefetchr(&SA[i + 2 * prefetch_distance]);
-        libsais16_prefetchw(&LCP[i + prefetch_distance]);
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { LCP[0] = PLCP[SA[0]]; }
+        return 0;
+    }
 
-        libsais16_prefetchr(&PLCP[SA[i + prefetch_distance + 0]]);
-        libsais16_prefetchr(&PLCP[SA[i + prefetch_distance + 1]]);
+    threads = threads > 0 ? threads : omp_get_max_threads();
 
-        LCP[i + 0] = PLCP[SA[i + 0]];
-        LCP[i + 1] = PLCP[SA[i + 1]];
+    libsais16_compute_lcp_omp(PLCP, SA, LCP, n, threads);
 
-        libsais16_prefetchr(&PLCP[SA[i + prefetch_distance + 2]]);
-        libsais16_prefetchr(&PLCP[SA[i + prefetch_distance + 3]]);
+    return 0;
+}
 
-        LCP[i + 2] = PLCP[SA[i + 2]];
-        LCP[i + 3] = PLCP[SA[i + 3]];
+int32_t libsais16_plcp_sampled_omp(const uint16_t * T, const int32_t * SA, int32_t * PLCP, int32_t n, int32_t r, int32_t threads)
+{
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (r <= 0) || ((r & (r - 1)) != 0) || (threads < 0))
+    {
+        return -1;
     }
-
-    for (j += prefetch_distance + 3; i < j; i += 1)
+    else if (n <= 1)
     {
-        LCP[i] = PLCP[SA[i]];
+        if (n == 1) { PLCP[0] = 0; }
+        return 0;
     }
-}
 
-static void libsais16_compute_lcp_omp(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, sa_sint_t n, sa_sint_t threads)
-{
-#if defined(LIBSAIS_OPENMP)
-    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
-#endif
-    {
-#if defined(LIBSAIS_OPENMP)
-        fast_sint_t omp_thread_num    = omp_get_thread_num();
-        fast_sint_t omp_num_threads   = omp_get_num_threads();
-#else
-        UNUSED(threads);
+    threads = threads > 0 ? threads : omp_get_max_threads();
 
-        fast_sint_t omp_thread_num    = 0;
-        fast_sint_t omp_num_threads   = 1;
-#endif
-        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
-        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
-        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+    libsais16_compute_phi_sampled_omp(SA, PLCP, n, r, threads);
+    libsais16_compute_plcp_sampled_omp(T, PLCP, n, r, threads);
 
-        libsais16_compute_lcp(PLCP, SA, LCP, omp_block_start, omp_block_size);
-    }
+    return 0;
 }
 
-int32_t libsais16_plcp(const uint16_t * T, const int32_t * SA, int32_t * PLCP, int32_t n)
+int32_t libsais16_lcp_sampled_omp(const uint16_t * T, const int32_t * PLCP, const int32_t * SA, int32_t * LCP, int32_t n, int32_t r, int32_t k, int32_t threads)
 {
-    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0))
+    if ((T == NULL) || (PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (r <= 0) || ((r & (r - 1)) != 0) || (k <= 0) || (threads < 0))
     {
         return -1;
     }
     else if (n <= 1)
     {
-        if (n == 1) { PLCP[0] = 0; }
+        if (n == 1) { LCP[0] = 0; }
         return 0;
     }
 
-    libsais16_compute_phi_omp(SA, PLCP, n, 1);
-    libsais16_compute_plcp_omp(T, PLCP, n, 1);
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    libsais16_compute_lcp_sampled_omp(T, PLCP, SA, LCP, n, r, k, threads);
 
     return 0;
 }
 
-int32_t libsais16_lcp(const int32_t * PLCP, const int32_t * SA, int32_t * LCP, int32_t n)
+int32_t libsais16_lcp_marked_omp(const uint16_t * T, const int32_t * PLCP, const int32_t * SA, const uint8_t * B, int32_t * LCP, int32_t n, int32_t r, int32_t threads)
 {
-    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0))
+    if ((T == NULL) || (PLCP == NULL) || (SA == NULL) || (B == NULL) || (LCP == NULL) || (n < 0) || (r <= 0) || ((r & (r - 1)) != 0) || (threads < 0))
     {
         return -1;
     }
     else if (n <= 1)
     {
-        if (n == 1) { LCP[0] = PLCP[SA[0]]; }
+        if (n == 1 && (B[0] & 1)) { LCP[0] = 0; return 1; }
         return 0;
     }
 
-    libsais16_compute_lcp_omp(PLCP, SA, LCP, n, 1);
+    threads = threads > 0 ? threads : omp_get_max_threads();
 
-    return 0;
+    return libsais16_compute_lcp_marked_omp(T, PLCP, SA, B, LCP, n, r, threads);
 }
 
-#if defined(LIBSAIS_OPENMP)
+int32_t libsais16_lcp_8u_omp(const int32_t * PLCP, const int32_t * SA, uint8_t * LCP, int32_t n, int32_t * X, int32_t xs, int32_t threads)
+{
+    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (xs < 0) || (X == NULL && xs > 0) || (threads < 0))
+    {
+        return -1;
+    }
 
-int32_t libsais16_plcp_omp(const uint16_t * T, const int32_t * SA, int32_t * PLCP, int32_t n, int32_t threads)
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais16_compute_lcp_8u_omp(PLCP, SA, LCP, n, X, xs, threads);
+}
+
+int32_t libsais16_isa_omp(const int32_t * SA, int32_t * ISA, int32_t n, int32_t threads)
 {
-    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (threads < 0))
+    if ((SA == NULL) || (ISA == NULL) || (n < 0) || (threads < 0))
     {
         return -1;
     }
     else if (n <= 1)
     {
-        if (n == 1) { PLCP[0] = 0; }
+        if (n == 1) { ISA[0] = 0; }
         return 0;
     }
-    
+
     threads = threads > 0 ? threads : omp_get_max_threads();
 
-    libsais16_compute_phi_omp(SA, PLCP, n, threads);
-    libsais16_compute_plcp_omp(T, PLCP, n, threads);
+    libsais16_compute_isa_omp(SA, ISA, n, threads);
 
     return 0;
 }
 
-int32_t libsais16_lcp_omp(const int32_t * PLCP, const int32_t * SA, int32_t * LCP, int32_t n, int32_t threads)
+int32_t libsais16_sa_lcp_omp(const uint16_t * T, int32_t * SA, int32_t * LCP, int32_t n, int32_t fs, int32_t * freq, int32_t threads)
 {
-    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (threads < 0))
+    if ((T == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (fs < 0) || (threads < 0))
     {
         return -1;
     }
-    else if (n <= 1)
+    else if (n < 2)
     {
-        if (n == 1) { LCP[0] = PLCP[SA[0]]; }
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int32_t)); }
+        if (n == 1) { SA[0] = 0; LCP[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
         return 0;
     }
 
     threads = threads > 0 ? threads : omp_get_max_threads();
 
-    libsais16_compute_lcp_omp(PLCP, SA, LCP, n, threads);
+    sa_sint_t index = libsais16_main(T, SA, n, 0, 0, NULL, NULL, fs, freq, threads);
+    if (index == 0)
+    {
+        libsais16_compute_sa_lcp_omp(T, SA, LCP, n, fs, threads);
+    }
 
-    return 0;
+    return index;
 }
 
 #endif
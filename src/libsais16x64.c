@@ -46,16 +46,45 @@ typedef uint64_t                        fast_uint_t;
 #define SAINT_MIN                       INT64_MIN
 
 #define ALPHABET_SIZE                   (1 << CHAR_BIT << CHAR_BIT)
-#define UNBWT_FASTBITS                  (17)
+
+#if !defined(UNBWT_FASTBITS)
+    #define UNBWT_FASTBITS                 (17)
+#endif
+
+#define UNBWT_FASTBITS_MIN             (8)
+#define UNBWT_FASTBITS_MAX             (24)
+
+#if !defined(UNBWT_SPLITTERS_MIN_THREADS)
+    #define UNBWT_SPLITTERS_MIN_THREADS    (4)
+#endif
+
+#if !defined(UNBWT_SPLITTERS_MIN_SIZE)
+    #define UNBWT_SPLITTERS_MIN_SIZE       (1 << 21)
+#endif
 
 #define SUFFIX_GROUP_BIT                (SAINT_BIT - 1)
 #define SUFFIX_GROUP_MARKER             (((sa_sint_t)1) << (SUFFIX_GROUP_BIT - 1))
 
+#define LIBSAIS_40U_MAX                 (((sa_sint_t)1) << 40)
+
 #define BUCKETS_INDEX2(_c, _s)          ((((fast_sint_t)_c) << 1) + (fast_sint_t)(_s))
 #define BUCKETS_INDEX4(_c, _s)          ((((fast_sint_t)_c) << 2) + (fast_sint_t)(_s))
 
-#define LIBSAIS_LOCAL_BUFFER_SIZE       (1024)
-#define LIBSAIS_PER_THREAD_CACHE_SIZE   (2097184)
+#if !defined(LIBSAIS_LOCAL_BUFFER_SIZE)
+    #define LIBSAIS_LOCAL_BUFFER_SIZE      (1024)
+#endif
+
+#if !defined(LIBSAIS_PER_THREAD_CACHE_SIZE)
+    #define LIBSAIS_PER_THREAD_CACHE_SIZE  (2097184)
+#endif
+
+#if !defined(LIBSAIS_NUMA_PAGE_SIZE)
+    #define LIBSAIS_NUMA_PAGE_SIZE         (4096)
+#endif
+
+#if !defined(LIBSAIS_PREFETCH_DISTANCE)
+    #define LIBSAIS_PREFETCH_DISTANCE      (32)
+#endif
 
 typedef struct LIBSAIS_THREAD_CACHE
 {
@@ -75,16 +104,49 @@ typedef union LIBSAIS_THREAD_STATE
 
         sa_sint_t *                     buckets;
         LIBSAIS_THREAD_CACHE *          cache;
+        fast_sint_t                     cache_size;
+        struct LIBSAIS_MONITOR *        monitor;
     } state;
 
     uint8_t padding[64];
 } LIBSAIS_THREAD_STATE;
 
+typedef struct LIBSAIS_ALLOCATOR
+{
+    void *                              (* alloc)(size_t size, size_t alignment, void * opaque);
+    void                                (* free)(void * address, void * opaque);
+    void *                              opaque;
+} LIBSAIS_ALLOCATOR;
+
+typedef struct LIBSAIS_MONITOR
+{
+    void                                (* profile)(int32_t phase, int32_t end, int32_t depth, int64_t n, int64_t k, int32_t flags, void * opaque);
+    void *                              profile_opaque;
+    int32_t                             (* cancel)(void * opaque);
+    void *                              cancel_opaque;
+    sa_sint_t                           cancelled;
+    sa_sint_t                           thread_block_size;
+} LIBSAIS_MONITOR;
+
+typedef struct LIBSAIS_ARENA
+{
+    uint8_t *                           memory;
+    size_t                              size;
+    size_t                              used;
+    sa_sint_t                           exhausted;
+} LIBSAIS_ARENA;
+
 typedef struct LIBSAIS_CONTEXT
 {
     sa_sint_t *                         buckets;
     LIBSAIS_THREAD_STATE *              thread_state;
     fast_sint_t                         threads;
+    sa_sint_t *                         local_buffer;
+    fast_sint_t                         local_buffer_size;
+    fast_sint_t                         numa;
+    void *                              ctx32;
+    LIBSAIS_ALLOCATOR                   allocator;
+    LIBSAIS_MONITOR                     monitor;
 } LIBSAIS_CONTEXT;
 
 typedef struct LIBSAIS_UNBWT_CONTEXT
@@ -92,9 +154,23 @@ typedef struct LIBSAIS_UNBWT_CONTEXT
     sa_uint_t *                         bucket2;
     uint16_t *                          fastbits;
     sa_uint_t *                         buckets;
+    fast_sint_t                         fastbits_log;
     fast_sint_t                         threads;
+    void *                              ctx32;
+    LIBSAIS_ALLOCATOR                   allocator;
 } LIBSAIS_UNBWT_CONTEXT;
 
+#define LIBSAIS_UNBWT_INDEX_MAGIC           (0x343636314955534cULL)
+
+typedef struct LIBSAIS_UNBWT_INDEX
+{
+    uint64_t                    magic;
+    int64_t                     n;
+    int64_t                     r;
+    int64_t                     lastc;
+    int64_t                     reserved[4];
+} LIBSAIS_UNBWT_INDEX;
+
 #if defined(__GNUC__) || defined(__clang__)
     #define RESTRICT __restrict__
 #elif defined(_MSC_VER) || defined(__INTEL_COMPILER)
@@ -175,38 +251,353 @@ static void libsais16x64_free_aligned(void * aligned_address)
     }
 }
 
-static LIBSAIS_THREAD_STATE * libsais16x64_alloc_thread_state(sa_sint_t threads)
+static void * libsais16x64_alloc_memory(const LIBSAIS_ALLOCATOR * allocator, size_t size, size_t alignment)
+{
+    return allocator != NULL && allocator->alloc != NULL
+        ? allocator->alloc(size, alignment, allocator->opaque)
+        : libsais16x64_alloc_aligned(size, alignment);
+}
+
+static void libsais16x64_free_memory(const LIBSAIS_ALLOCATOR * allocator, void * address)
+{
+    if (allocator != NULL && allocator->alloc != NULL)
+    {
+        if (address != NULL) { allocator->free(address, allocator->opaque); }
+    }
+    else
+    {
+        libsais16x64_free_aligned(address);
+    }
+}
+
+static void * libsais16x64_arena_alloc(size_t size, size_t alignment, void * opaque)
+{
+    LIBSAIS_ARENA * RESTRICT arena = (LIBSAIS_ARENA *)opaque;
+
+    size_t offset = (size_t)((uint8_t *)libsais16x64_align_up(arena->memory + arena->used, alignment) - arena->memory);
+    if (offset > arena->size || size > arena->size - offset) { arena->exhausted = 1; return NULL; }
+
+    arena->used = offset + size;
+    return arena->memory + offset;
+}
+
+static void libsais16x64_arena_free(void * address, void * opaque)
 {
-    LIBSAIS_THREAD_STATE *  RESTRICT thread_state    = (LIBSAIS_THREAD_STATE *)libsais16x64_alloc_aligned((size_t)threads * sizeof(LIBSAIS_THREAD_STATE), 4096);
-    sa_sint_t *             RESTRICT thread_buckets  = (sa_sint_t *)libsais16x64_alloc_aligned((size_t)threads * 4 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
-    LIBSAIS_THREAD_CACHE *  RESTRICT thread_cache    = (LIBSAIS_THREAD_CACHE *)libsais16x64_alloc_aligned((size_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE * sizeof(LIBSAIS_THREAD_CACHE), 4096);
+    LIBSAIS_ARENA * RESTRICT arena = (LIBSAIS_ARENA *)opaque;
+
+    size_t offset = (size_t)((uint8_t *)address - arena->memory);
+    if (offset < arena->used) { arena->used = offset; }
+}
+
+static LIBSAIS_THREAD_STATE * libsais16x64_alloc_thread_state(sa_sint_t threads, const LIBSAIS_ALLOCATOR * allocator)
+{
+    LIBSAIS_THREAD_STATE *  RESTRICT thread_state    = (LIBSAIS_THREAD_STATE *)libsais16x64_alloc_memory(allocator, (size_t)threads * sizeof(LIBSAIS_THREAD_STATE), 4096);
+    sa_sint_t *             RESTRICT thread_buckets  = (sa_sint_t *)libsais16x64_alloc_memory(allocator, (size_t)threads * 4 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
+    LIBSAIS_THREAD_CACHE *  RESTRICT thread_cache    = (LIBSAIS_THREAD_CACHE *)libsais16x64_alloc_memory(allocator, (size_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE * sizeof(LIBSAIS_THREAD_CACHE), 4096);
 
     if (thread_state != NULL && thread_buckets != NULL && thread_cache != NULL)
     {
         fast_sint_t t;
         for (t = 0; t < threads; ++t)
         { 
-            thread_state[t].state.buckets   = thread_buckets;   thread_buckets  += 4 * ALPHABET_SIZE;
-            thread_state[t].state.cache     = thread_cache;     thread_cache    += LIBSAIS_PER_THREAD_CACHE_SIZE;
+            thread_state[t].state.buckets    = thread_buckets;   thread_buckets  += 4 * ALPHABET_SIZE;
+            thread_state[t].state.cache      = thread_cache;     thread_cache    += LIBSAIS_PER_THREAD_CACHE_SIZE;
+            thread_state[t].state.cache_size = LIBSAIS_PER_THREAD_CACHE_SIZE;
+            thread_state[t].state.monitor    = NULL;
         }
 
         return thread_state;
     }
 
-    libsais16x64_free_aligned(thread_cache);
-    libsais16x64_free_aligned(thread_buckets);
-    libsais16x64_free_aligned(thread_state);
+    libsais16x64_free_memory(allocator, thread_cache);
+    libsais16x64_free_memory(allocator, thread_buckets);
+    libsais16x64_free_memory(allocator, thread_state);
     return NULL;
 }
 
-static void libsais16x64_free_thread_state(LIBSAIS_THREAD_STATE * thread_state)
+static void libsais16x64_free_thread_state(LIBSAIS_THREAD_STATE * thread_state, const LIBSAIS_ALLOCATOR * allocator)
 {
     if (thread_state != NULL)
     {
-        libsais16x64_free_aligned(thread_state[0].state.cache);
-        libsais16x64_free_aligned(thread_state[0].state.buckets);
-        libsais16x64_free_aligned(thread_state);
+        libsais16x64_free_memory(allocator, thread_state[0].state.cache);
+        libsais16x64_free_memory(allocator, thread_state[0].state.buckets);
+        libsais16x64_free_memory(allocator, thread_state);
+    }
+}
+
+static LIBSAIS_CONTEXT * libsais16x64_create_ctx_main(sa_sint_t threads, const LIBSAIS_ALLOCATOR * allocator)
+{
+    LIBSAIS_CONTEXT *       RESTRICT ctx            = (LIBSAIS_CONTEXT *)libsais16x64_alloc_memory(allocator, sizeof(LIBSAIS_CONTEXT), 64);
+    sa_sint_t *             RESTRICT buckets        = (sa_sint_t *)libsais16x64_alloc_memory(allocator, (size_t)8 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
+    LIBSAIS_THREAD_STATE *  RESTRICT thread_state   = threads > 1 ? libsais16x64_alloc_thread_state(threads, allocator) : NULL;
+#if defined(LIBSAIS_OPENMP)
+    void *                           ctx32          = allocator != NULL && allocator->alloc != NULL
+        ? libsais16_create_ctx_alloc_omp((int32_t)threads, allocator->alloc, allocator->free, allocator->opaque)
+        : libsais16_create_ctx_omp((int32_t)threads);
+#else
+    void *                           ctx32          = allocator != NULL && allocator->alloc != NULL
+        ? libsais16_create_ctx_alloc(allocator->alloc, allocator->free, allocator->opaque)
+        : libsais16_create_ctx();
+#endif
+
+    if (ctx != NULL && buckets != NULL && (thread_state != NULL || threads == 1) && ctx32 != NULL)
+    {
+        ctx->buckets = buckets;
+        ctx->threads = threads;
+        ctx->thread_state = thread_state;
+        ctx->numa = LIBSAIS16X64_NUMA_NONE;
+        ctx->local_buffer = NULL;
+        ctx->local_buffer_size = LIBSAIS_LOCAL_BUFFER_SIZE;
+        ctx->ctx32 = ctx32;
+
+        if (allocator != NULL) { ctx->allocator = *allocator; } else { memset(&ctx->allocator, 0, sizeof(LIBSAIS_ALLOCATOR)); }
+        memset(&ctx->monitor, 0, sizeof(LIBSAIS_MONITOR));
+
+        return ctx;
+    }
+
+    libsais16_free_ctx(ctx32);
+    libsais16x64_free_thread_state(thread_state, allocator);
+    libsais16x64_free_memory(allocator, buckets);
+    libsais16x64_free_memory(allocator, ctx);
+    return NULL;
+}
+
+static void libsais16x64_free_ctx_main(LIBSAIS_CONTEXT * ctx)
+{
+    if (ctx != NULL)
+    {
+        LIBSAIS_ALLOCATOR allocator = ctx->allocator;
+
+        libsais16_free_ctx(ctx->ctx32);
+        libsais16x64_free_thread_state(ctx->thread_state, &allocator);
+        libsais16x64_free_memory(&allocator, ctx->local_buffer);
+        libsais16x64_free_memory(&allocator, ctx->buckets);
+        libsais16x64_free_memory(&allocator, ctx);
+    }
+}
+
+static LIBSAIS_CONTEXT * libsais16x64_create_ctx_buffer_main(sa_sint_t threads, void * buffer, size_t size)
+{
+    LIBSAIS_ARENA * RESTRICT arena = (LIBSAIS_ARENA *)libsais16x64_align_up(buffer, 64);
+
+    if (buffer != NULL && (size_t)((uint8_t *)(arena + 1) - (uint8_t *)buffer) <= size)
+    {
+        arena->memory       = (uint8_t *)(arena + 1);
+        arena->size         = size - (size_t)(arena->memory - (uint8_t *)buffer);
+        arena->used         = 0;
+        arena->exhausted    = 0;
+
+        LIBSAIS_ALLOCATOR allocator = { libsais16x64_arena_alloc, libsais16x64_arena_free, arena };
+        return libsais16x64_create_ctx_main(threads, &allocator);
+    }
+
+    return NULL;
+}
+
+static sa_sint_t libsais16x64_ctx_status(const LIBSAIS_CONTEXT * ctx, sa_sint_t index)
+{
+    if (ctx->allocator.alloc == libsais16x64_arena_alloc)
+    {
+        LIBSAIS_ARENA * RESTRICT arena = (LIBSAIS_ARENA *)ctx->allocator.opaque;
+
+        if (index == -2 && arena->exhausted) { index = -3; }
+        arena->exhausted = 0;
+    }
+
+    return index;
+}
+
+static void libsais16x64_profile(const LIBSAIS_MONITOR * monitor, sa_sint_t phase, sa_sint_t end, sa_sint_t depth, sa_sint_t n, sa_sint_t k, sa_sint_t flags)
+{
+    if (monitor != NULL && monitor->profile != NULL)
+    {
+        monitor->profile((int32_t)phase, (int32_t)end, (int32_t)depth, (int64_t)n, (int64_t)k, (int32_t)flags, monitor->profile_opaque);
+    }
+}
+
+static sa_sint_t libsais16x64_cancelled(LIBSAIS_MONITOR * monitor)
+{
+    if (monitor != NULL && monitor->cancel != NULL && monitor->cancelled == 0)
+    {
+        monitor->cancelled = monitor->cancel(monitor->cancel_opaque) != 0;
+    }
+
+    return monitor != NULL && monitor->cancelled != 0;
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+static void libsais16x64_numa_touch_pages(void * memory, fast_sint_t size, fast_sint_t start, fast_sint_t end, fast_sint_t page_start, fast_sint_t page_step)
+{
+    uint8_t * RESTRICT bytes = (uint8_t *)memory;
+    ptrdiff_t base = ((ptrdiff_t)bytes) & (-((ptrdiff_t)LIBSAIS_NUMA_PAGE_SIZE));
+
+    if (start < end && end <= size)
+    {
+        fast_sint_t p = (((ptrdiff_t)(bytes + start) - base) / LIBSAIS_NUMA_PAGE_SIZE);
+        fast_sint_t last = (((ptrdiff_t)(bytes + end - 1) - base) / LIBSAIS_NUMA_PAGE_SIZE);
+
+        if (page_step > 1) { p += (page_start - p % page_step + page_step) % page_step; }
+
+        for (; p <= last; p += page_step)
+        {
+            fast_sint_t offset = (fast_sint_t)(base + p * LIBSAIS_NUMA_PAGE_SIZE - (ptrdiff_t)bytes);
+            bytes[offset > start ? offset : start] = 0;
+        }
+    }
+}
+
+#endif
+
+static void libsais16x64_numa_place_thread_state(LIBSAIS_THREAD_STATE * RESTRICT thread_state, fast_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    if (thread_state != NULL && threads > 1)
+    {
+        #pragma omp parallel num_threads(threads)
+        {
+            fast_sint_t omp_thread_num = omp_get_thread_num();
+            fast_sint_t cache_size = thread_state[0].state.cache_size * (fast_sint_t)sizeof(LIBSAIS_THREAD_CACHE);
+
+            if (omp_thread_num < threads)
+            {
+                memset(thread_state[omp_thread_num].state.buckets, 0, (size_t)4 * ALPHABET_SIZE * sizeof(sa_sint_t));
+                libsais16x64_numa_touch_pages(thread_state[omp_thread_num].state.cache, cache_size, 0, cache_size, 0, 1);
+            }
+        }
+    }
+#else
+    UNUSED(thread_state); UNUSED(threads);
+#endif
+}
+
+static void libsais16x64_numa_place_omp(const LIBSAIS_CONTEXT * ctx, sa_sint_t * SA, sa_sint_t n, sa_sint_t fs)
+{
+#if defined(LIBSAIS_OPENMP)
+    if (ctx->numa != LIBSAIS16X64_NUMA_NONE && ctx->threads > 1 && n >= 65536)
+    {
+        fast_sint_t mode = ctx->numa, size = ((fast_sint_t)n + (fast_sint_t)fs) * (fast_sint_t)sizeof(sa_sint_t);
+
+        #pragma omp parallel num_threads(ctx->threads)
+        {
+            fast_sint_t omp_thread_num    = omp_get_thread_num();
+            fast_sint_t omp_num_threads   = omp_get_num_threads();
+            fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+            fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+            fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n + fs - omp_block_start;
+
+            if (mode == LIBSAIS16X64_NUMA_INTERLEAVE)
+            {
+                libsais16x64_numa_touch_pages(SA, size, 0, size, omp_thread_num, omp_num_threads);
+            }
+            else
+            {
+                libsais16x64_numa_touch_pages(SA, size, omp_block_start * (fast_sint_t)sizeof(sa_sint_t), (omp_block_start + omp_block_size) * (fast_sint_t)sizeof(sa_sint_t), 0, 1);
+            }
+        }
+    }
+#else
+    UNUSED(ctx); UNUSED(SA); UNUSED(n); UNUSED(fs);
+#endif
+}
+
+static int64_t libsais16x64_padded_size(int64_t size, int64_t alignment, fast_sint_t flags)
+{
+    return size > 0 ? size + (alignment - 1) + (flags != LIBSAIS16X64_FLAGS_BUFFER ? (int64_t)sizeof(short) : 0) : 0;
+}
+
+static int64_t libsais16x64_thread_state_size(fast_sint_t threads, fast_sint_t flags)
+{
+    int64_t size = 0;
+
+    if (threads > 1)
+    {
+        size += libsais16x64_padded_size((int64_t)threads * (int64_t)sizeof(LIBSAIS_THREAD_STATE), 4096, flags);
+        size += libsais16x64_padded_size((int64_t)threads * 4 * ALPHABET_SIZE * (int64_t)sizeof(sa_sint_t), 4096, flags);
+        size += libsais16x64_padded_size((int64_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE * (int64_t)sizeof(LIBSAIS_THREAD_CACHE), 4096, flags);
+    }
+
+    return size;
+}
+
+static int64_t libsais16x64_ctx_size_main(fast_sint_t threads)
+{
+    int64_t size = libsais16x64_padded_size((int64_t)sizeof(LIBSAIS_CONTEXT), 64, LIBSAIS16X64_FLAGS_CTX);
+
+    size += libsais16x64_padded_size((int64_t)8 * ALPHABET_SIZE * (int64_t)sizeof(sa_sint_t), 4096, LIBSAIS16X64_FLAGS_CTX);
+    size += libsais16x64_thread_state_size(threads, LIBSAIS16X64_FLAGS_CTX);
+    size += libsais16_alloc_size(0, 0, (int32_t)threads);
+
+    return size;
+}
+
+static fast_sint_t libsais16x64_recursion_buffer_size(fast_sint_t n, fast_sint_t k, fast_sint_t fs, fast_sint_t threads, fast_sint_t local_buffer_size)
+{
+    fast_sint_t size = 0;
+
+    fs = fs < (SAINT_MAX - n) ? fs : (SAINT_MAX - n);
+
+    if (fs < k && (threads > 1 || local_buffer_size / k < 2)) { size = k; }
+
+    {
+        fast_sint_t m = n / 2, names = m - 1;
+        if (names > fs + n - 2 * m && (threads > 1 || local_buffer_size / names < 2) && names > size) { size = names; }
+    }
+
+    return size;
+}
+
+static fast_sint_t libsais16x64_alphabet_buffer_size(fast_sint_t n, fast_sint_t k, fast_sint_t fs)
+{
+    fs = fs < (SAINT_MAX - n) ? fs : (SAINT_MAX - n);
+
+    return k > 0 && fs / k < 6 ? (k > n + fs ? k : k < n ? k : n) : 0;
+}
+
+static int64_t libsais16x64_scratch_size_main(fast_sint_t n, fast_sint_t k, fast_sint_t fs, fast_sint_t threads, fast_sint_t flags)
+{
+    int64_t size = 0;
+
+    if (n >= 2)
+    {
+        int32_t flags32 = flags == LIBSAIS16X64_FLAGS_NONE ? LIBSAIS16_FLAGS_NONE : LIBSAIS16_FLAGS_CTX;
+
+        if (k == 0 && n <= INT32_MAX)
+        {
+            fast_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+            size += libsais16_scratch_size((int32_t)n, 0, (int32_t)new_fs, (int32_t)threads, flags32);
+        }
+        else
+        {
+            fast_sint_t n32 = k > 0 ? n : n / 2; n32 = n32 < INT32_MAX ? n32 : INT32_MAX;
+            fast_sint_t k32 = k > n32 - 1 ? k : n32 - 1; k32 = k32 < INT32_MAX ? k32 : INT32_MAX;
+
+            int64_t buffer_size     = libsais16x64_padded_size((int64_t)libsais16x64_recursion_buffer_size(n, k, fs, threads, flags == LIBSAIS16X64_FLAGS_NONE ? LIBSAIS_LOCAL_BUFFER_SIZE : 0) * (int64_t)sizeof(sa_sint_t), 4096, flags);
+            int64_t delegated_size  = libsais16_scratch_size((int32_t)n32, (int32_t)k32, 0, (int32_t)threads, flags32);
+
+            size += buffer_size > delegated_size ? buffer_size : delegated_size;
+            size += libsais16x64_padded_size((int64_t)libsais16x64_alphabet_buffer_size(n, k, fs) * (int64_t)sizeof(sa_sint_t), 4096, flags);
+
+            if (flags == LIBSAIS16X64_FLAGS_NONE)
+            {
+                size += libsais16x64_thread_state_size(threads, flags);
+                if (k == 0) { size += libsais16x64_padded_size((int64_t)8 * ALPHABET_SIZE * (int64_t)sizeof(sa_sint_t), 4096, flags); }
+            }
+        }
+    }
+
+    if (flags == LIBSAIS16X64_FLAGS_BUFFER)
+    {
+        size += (int64_t)sizeof(LIBSAIS_ARENA) + 64 + libsais16x64_ctx_size_main(threads);
     }
+
+    return size;
+}
+
+static int64_t libsais16x64_alloc_size_main(fast_sint_t n, fast_sint_t k, fast_sint_t threads)
+{
+    return libsais16x64_ctx_size_main(threads) + libsais16x64_scratch_size_main(n, k, 0, threads, LIBSAIS16X64_FLAGS_CTX);
 }
 
 #if defined(LIBSAIS_OPENMP)
@@ -231,7 +622,7 @@ static sa_sint_t libsais16x64_count_zero_marked_suffixes(sa_sint_t * RESTRICT SA
 
 static void libsais16x64_place_cached_suffixes(sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
@@ -257,7 +648,7 @@ static void libsais16x64_place_cached_suffixes(sa_sint_t * RESTRICT SA, LIBSAIS_
 
 static void libsais16x64_compact_and_place_cached_suffixes(sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j, l;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - 3, l = omp_block_start; i < j; i += 4)
@@ -450,7 +841,7 @@ static void libsais16x64_gather_lms_suffixes_16u_omp(const uint16_t * RESTRICT T
 
 static sa_sint_t libsais16x64_gather_lms_suffixes_32s(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t             i   = n - 2;
     sa_sint_t             m   = n - 1;
@@ -478,7 +869,7 @@ static sa_sint_t libsais16x64_gather_lms_suffixes_32s(const sa_sint_t * RESTRICT
 
 static sa_sint_t libsais16x64_gather_compacted_lms_suffixes_32s(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t             i   = n - 2;
     sa_sint_t             m   = n - 1;
@@ -508,7 +899,7 @@ static sa_sint_t libsais16x64_gather_compacted_lms_suffixes_32s(const sa_sint_t
 
 static void libsais16x64_count_lms_suffixes_32s_4k(const sa_sint_t * RESTRICT T, sa_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT buckets)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     memset(buckets, 0, 4 * (size_t)k * sizeof(sa_sint_t));
 
@@ -552,7 +943,7 @@ static void libsais16x64_count_lms_suffixes_32s_4k(const sa_sint_t * RESTRICT T,
 
 static void libsais16x64_count_lms_suffixes_32s_2k(const sa_sint_t * RESTRICT T, sa_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT buckets)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     memset(buckets, 0, 2 * (size_t)k * sizeof(sa_sint_t));
 
@@ -596,7 +987,7 @@ static void libsais16x64_count_lms_suffixes_32s_2k(const sa_sint_t * RESTRICT T,
 
 static void libsais16x64_count_compacted_lms_suffixes_32s_2k(const sa_sint_t * RESTRICT T, sa_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT buckets)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     memset(buckets, 0, 2 * (size_t)k * sizeof(sa_sint_t));
 
@@ -759,7 +1150,7 @@ static sa_sint_t libsais16x64_count_and_gather_lms_suffixes_32s_4k(const sa_sint
 
     if (omp_block_size > 0)
     {
-        const fast_sint_t prefetch_distance = 32;
+        const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
         fast_sint_t i, j = m + 1, c0 = T[m], c1 = -1;
 
@@ -810,7 +1201,7 @@ static sa_sint_t libsais16x64_count_and_gather_lms_suffixes_32s_2k(const sa_sint
 
     if (omp_block_size > 0)
     {
-        const fast_sint_t prefetch_distance = 32;
+        const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
         fast_sint_t i, j = m + 1, c0 = T[m], c1 = -1;
 
@@ -861,7 +1252,7 @@ static sa_sint_t libsais16x64_count_and_gather_compacted_lms_suffixes_32s_2k(con
 
     if (omp_block_size > 0)
     {
-        const fast_sint_t prefetch_distance = 32;
+        const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
         fast_sint_t i, j = m + 1, c0 = T[m], c1 = -1;
 
@@ -1276,7 +1667,7 @@ static void libsais16x64_count_and_gather_compacted_lms_suffixes_32s_2k_omp(cons
 
 static void libsais16x64_count_suffixes_32s(const sa_sint_t * RESTRICT T, sa_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT buckets)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     memset(buckets, 0, (size_t)k * sizeof(sa_sint_t));
 
@@ -1489,7 +1880,7 @@ static void libsais16x64_initialize_buckets_for_radix_and_partial_sorting_32s_4k
 
 static void libsais16x64_radix_sort_lms_suffixes_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 3; i >= j; i -= 4)
@@ -1563,7 +1954,7 @@ static void libsais16x64_radix_sort_lms_suffixes_16u_omp(const uint16_t * RESTRI
 
 static void libsais16x64_radix_sort_lms_suffixes_32s_6k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + 2 * prefetch_distance + 3; i >= j; i -= 4)
@@ -1594,7 +1985,7 @@ static void libsais16x64_radix_sort_lms_suffixes_32s_6k(const sa_sint_t * RESTRI
 
 static void libsais16x64_radix_sort_lms_suffixes_32s_2k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + 2 * prefetch_distance + 3; i >= j; i -= 4)
@@ -1627,7 +2018,7 @@ static void libsais16x64_radix_sort_lms_suffixes_32s_2k(const sa_sint_t * RESTRI
 
 static void libsais16x64_radix_sort_lms_suffixes_32s_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
@@ -1655,7 +2046,7 @@ static void libsais16x64_radix_sort_lms_suffixes_32s_block_gather(const sa_sint_
 
 static void libsais16x64_radix_sort_lms_suffixes_32s_6k_block_sort(sa_sint_t * RESTRICT induction_bucket, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 3; i >= j; i -= 4)
@@ -1681,7 +2072,7 @@ static void libsais16x64_radix_sort_lms_suffixes_32s_6k_block_sort(sa_sint_t * R
 
 static void libsais16x64_radix_sort_lms_suffixes_32s_2k_block_sort(sa_sint_t * RESTRICT induction_bucket, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 3; i >= j; i -= 4)
@@ -1817,7 +2208,9 @@ static void libsais16x64_radix_sort_lms_suffixes_32s_6k_omp(const sa_sint_t * RE
         fast_sint_t block_start, block_end;
         for (block_start = 0; block_start < (fast_sint_t)m - 1; block_start = block_end)
         {
-            block_end = block_start + (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end >= m) { block_end = (fast_sint_t)m - 1; }
+            if (libsais16x64_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start + (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end >= m) { block_end = (fast_sint_t)m - 1; }
 
             libsais16x64_radix_sort_lms_suffixes_32s_6k_block_omp(T, SA, induction_bucket, thread_state[0].state.cache, (fast_sint_t)n - block_end, block_end - block_start, threads);
         }
@@ -1839,7 +2232,9 @@ static void libsais16x64_radix_sort_lms_suffixes_32s_2k_omp(const sa_sint_t * RE
         fast_sint_t block_start, block_end;
         for (block_start = 0; block_start < (fast_sint_t)m - 1; block_start = block_end)
         {
-            block_end = block_start + (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end >= m) { block_end = (fast_sint_t)m - 1; }
+            if (libsais16x64_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start + (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end >= m) { block_end = (fast_sint_t)m - 1; }
 
             libsais16x64_radix_sort_lms_suffixes_32s_2k_block_omp(T, SA, induction_bucket, thread_state[0].state.cache, (fast_sint_t)n - block_end, block_end - block_start, threads);
         }
@@ -1851,7 +2246,7 @@ static void libsais16x64_radix_sort_lms_suffixes_32s_2k_omp(const sa_sint_t * RE
 
 static sa_sint_t libsais16x64_radix_sort_lms_suffixes_32s_1k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t * RESTRICT buckets)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t             i = n - 2;
     sa_sint_t             m = 0;
@@ -1898,7 +2293,7 @@ static sa_sint_t libsais16x64_radix_sort_lms_suffixes_32s_1k(const sa_sint_t * R
 
 static void libsais16x64_radix_sort_set_markers_32s_6k(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
@@ -1924,7 +2319,7 @@ static void libsais16x64_radix_sort_set_markers_32s_6k(sa_sint_t * RESTRICT SA,
 
 static void libsais16x64_radix_sort_set_markers_32s_4k(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
@@ -2057,7 +2452,7 @@ static void libsais16x64_initialize_buckets_for_partial_sorting_32s_6k(const sa_
 
 static sa_sint_t libsais16x64_partial_sorting_scan_left_to_right_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, sa_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[4 * ALPHABET_SIZE];
     sa_sint_t * RESTRICT distinct_names   = &buckets[2 * ALPHABET_SIZE];
@@ -2092,7 +2487,7 @@ static sa_sint_t libsais16x64_partial_sorting_scan_left_to_right_16u(const uint1
 
 static void libsais16x64_partial_sorting_scan_left_to_right_16u_block_prepare(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size, LIBSAIS_THREAD_STATE * RESTRICT state)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[0 * ALPHABET_SIZE];
     sa_sint_t * RESTRICT distinct_names   = &buckets[2 * ALPHABET_SIZE];
@@ -2125,7 +2520,7 @@ static void libsais16x64_partial_sorting_scan_left_to_right_16u_block_prepare(co
 
 static void libsais16x64_partial_sorting_scan_left_to_right_16u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count, sa_sint_t d)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[0 * ALPHABET_SIZE];
     sa_sint_t * RESTRICT distinct_names   = &buckets[2 * ALPHABET_SIZE];
@@ -2240,7 +2635,9 @@ static sa_sint_t libsais16x64_partial_sorting_scan_left_to_right_16u_omp(const u
             }
             else
             {
-                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end > left_suffixes_count) { block_max_end = left_suffixes_count;}
+                if (libsais16x64_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end > left_suffixes_count) { block_max_end = left_suffixes_count;}
                 fast_sint_t block_end     = block_start + 1; while (block_end < block_max_end && SA[block_end] != 0) { block_end++; }
                 fast_sint_t block_size    = block_end - block_start;
 
@@ -2269,7 +2666,7 @@ static sa_sint_t libsais16x64_partial_sorting_scan_left_to_right_16u_omp(const u
 
 static sa_sint_t libsais16x64_partial_sorting_scan_left_to_right_32s_6k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, sa_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - 2 * prefetch_distance - 1; i < j; i += 2)
@@ -2302,7 +2699,7 @@ static sa_sint_t libsais16x64_partial_sorting_scan_left_to_right_32s_6k(const sa
 
 static sa_sint_t libsais16x64_partial_sorting_scan_left_to_right_32s_4k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, sa_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[2 * (fast_sint_t)k];
     sa_sint_t * RESTRICT distinct_names   = &buckets[0 * (fast_sint_t)k];
@@ -2347,7 +2744,7 @@ static sa_sint_t libsais16x64_partial_sorting_scan_left_to_right_32s_4k(const sa
 
 static void libsais16x64_partial_sorting_scan_left_to_right_32s_1k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - 2 * prefetch_distance - 1; i < j; i += 2)
@@ -2373,7 +2770,7 @@ static void libsais16x64_partial_sorting_scan_left_to_right_32s_1k(const sa_sint
 
 static void libsais16x64_partial_sorting_scan_left_to_right_32s_6k_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -2399,7 +2796,7 @@ static void libsais16x64_partial_sorting_scan_left_to_right_32s_6k_block_gather(
 
 static void libsais16x64_partial_sorting_scan_left_to_right_32s_4k_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -2423,7 +2820,7 @@ static void libsais16x64_partial_sorting_scan_left_to_right_32s_4k_block_gather(
 
 static void libsais16x64_partial_sorting_scan_left_to_right_32s_1k_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -2447,7 +2844,7 @@ static void libsais16x64_partial_sorting_scan_left_to_right_32s_1k_block_gather(
 
 static sa_sint_t libsais16x64_partial_sorting_scan_left_to_right_32s_6k_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT buckets, sa_sint_t d, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j, omp_block_end = omp_block_start + omp_block_size;
     for (i = omp_block_start, j = omp_block_end - prefetch_distance - 1; i < j; i += 2)
@@ -2475,7 +2872,7 @@ static sa_sint_t libsais16x64_partial_sorting_scan_left_to_right_32s_6k_block_so
 
 static sa_sint_t libsais16x64_partial_sorting_scan_left_to_right_32s_4k_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t k, sa_sint_t * RESTRICT buckets, sa_sint_t d, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[2 * (fast_sint_t)k];
     sa_sint_t * RESTRICT distinct_names   = &buckets[0 * (fast_sint_t)k];
@@ -2518,7 +2915,7 @@ static sa_sint_t libsais16x64_partial_sorting_scan_left_to_right_32s_4k_block_so
 
 static void libsais16x64_partial_sorting_scan_left_to_right_32s_1k_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT induction_bucket, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j, omp_block_end = omp_block_start + omp_block_size;
     for (i = omp_block_start, j = omp_block_end - prefetch_distance - 1; i < j; i += 2)
@@ -2722,7 +3119,9 @@ static sa_sint_t libsais16x64_partial_sorting_scan_left_to_right_32s_6k_omp(cons
         fast_sint_t block_start, block_end;
         for (block_start = 0; block_start < left_suffixes_count; block_start = block_end)
         {
-            block_end = block_start + (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end > left_suffixes_count) { block_end = left_suffixes_count; }
+            if (libsais16x64_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start + (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end > left_suffixes_count) { block_end = left_suffixes_count; }
 
             d = libsais16x64_partial_sorting_scan_left_to_right_32s_6k_block_omp(T, SA, buckets, d, thread_state[0].state.cache, block_start, block_end - block_start, threads);
         }
@@ -2752,7 +3151,9 @@ static sa_sint_t libsais16x64_partial_sorting_scan_left_to_right_32s_4k_omp(cons
         fast_sint_t block_start, block_end;
         for (block_start = 0; block_start < n; block_start = block_end)
         {
-            block_end = block_start + (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end > n) { block_end = n; }
+            if (libsais16x64_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start + (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end > n) { block_end = n; }
 
             d = libsais16x64_partial_sorting_scan_left_to_right_32s_4k_block_omp(T, SA, k, buckets, d, thread_state[0].state.cache, block_start, block_end - block_start, threads);
         }
@@ -2778,7 +3179,9 @@ static void libsais16x64_partial_sorting_scan_left_to_right_32s_1k_omp(const sa_
         fast_sint_t block_start, block_end;
         for (block_start = 0; block_start < n; block_start = block_end)
         {
-            block_end = block_start + (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end > n) { block_end = n; }
+            if (libsais16x64_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start + (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end > n) { block_end = n; }
 
             libsais16x64_partial_sorting_scan_left_to_right_32s_1k_block_omp(T, SA, buckets, thread_state[0].state.cache, block_start, block_end - block_start, threads);
         }
@@ -2790,7 +3193,7 @@ static void libsais16x64_partial_sorting_scan_left_to_right_32s_1k_omp(const sa_
 
 static void libsais16x64_partial_sorting_shift_markers_16u_omp(sa_sint_t * RESTRICT SA, sa_sint_t n, const sa_sint_t * RESTRICT buckets, sa_sint_t threads)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     const sa_sint_t * RESTRICT temp_bucket = &buckets[4 * ALPHABET_SIZE];
 
@@ -2823,7 +3226,7 @@ static void libsais16x64_partial_sorting_shift_markers_16u_omp(sa_sint_t * RESTR
 
 static void libsais16x64_partial_sorting_shift_markers_32s_6k_omp(sa_sint_t * RESTRICT SA, sa_sint_t k, const sa_sint_t * RESTRICT buckets, sa_sint_t threads)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     const sa_sint_t * RESTRICT temp_bucket = &buckets[4 * (fast_sint_t)k];
     
@@ -2856,7 +3259,7 @@ static void libsais16x64_partial_sorting_shift_markers_32s_6k_omp(sa_sint_t * RE
 
 static void libsais16x64_partial_sorting_shift_markers_32s_4k(sa_sint_t * RESTRICT SA, sa_sint_t n)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i; sa_sint_t s = SUFFIX_GROUP_MARKER;
     for (i = (fast_sint_t)n - 1; i >= 3; i -= 4)
@@ -2889,7 +3292,7 @@ static void libsais16x64_partial_sorting_shift_buckets_32s_6k(sa_sint_t k, sa_si
 
 static sa_sint_t libsais16x64_partial_sorting_scan_right_to_left_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, sa_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[0 * ALPHABET_SIZE];
     sa_sint_t * RESTRICT distinct_names   = &buckets[2 * ALPHABET_SIZE];
@@ -2924,7 +3327,7 @@ static sa_sint_t libsais16x64_partial_sorting_scan_right_to_left_16u(const uint1
 
 static void libsais16x64_partial_sorting_scan_right_to_left_16u_block_prepare(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size, LIBSAIS_THREAD_STATE * RESTRICT state)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[0 * ALPHABET_SIZE];
     sa_sint_t * RESTRICT distinct_names   = &buckets[2 * ALPHABET_SIZE];
@@ -2957,7 +3360,7 @@ static void libsais16x64_partial_sorting_scan_right_to_left_16u_block_prepare(co
 
 static void libsais16x64_partial_sorting_scan_right_to_left_16u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count, sa_sint_t d)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[0 * ALPHABET_SIZE];
     sa_sint_t * RESTRICT distinct_names   = &buckets[2 * ALPHABET_SIZE];
@@ -3072,7 +3475,9 @@ static void libsais16x64_partial_sorting_scan_right_to_left_16u_omp(const uint16
             }
             else
             {
-                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end < scan_start) { block_max_end = scan_start - 1; }
+                if (libsais16x64_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end < scan_start) { block_max_end = scan_start - 1; }
                 fast_sint_t block_end     = block_start - 1; while (block_end > block_max_end && SA[block_end] != 0) { block_end--; }
                 fast_sint_t block_size    = block_start - block_end;
 
@@ -3099,7 +3504,7 @@ static void libsais16x64_partial_sorting_scan_right_to_left_16u_omp(const uint16
 
 static sa_sint_t libsais16x64_partial_sorting_scan_right_to_left_32s_6k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, sa_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + 2 * prefetch_distance + 1; i >= j; i -= 2)
@@ -3132,7 +3537,7 @@ static sa_sint_t libsais16x64_partial_sorting_scan_right_to_left_32s_6k(const sa
 
 static sa_sint_t libsais16x64_partial_sorting_scan_right_to_left_32s_4k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, sa_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[3 * (fast_sint_t)k];
     sa_sint_t * RESTRICT distinct_names   = &buckets[0 * (fast_sint_t)k];
@@ -3177,7 +3582,7 @@ static sa_sint_t libsais16x64_partial_sorting_scan_right_to_left_32s_4k(const sa
 
 static void libsais16x64_partial_sorting_scan_right_to_left_32s_1k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + 2 * prefetch_distance + 1; i >= j; i -= 2)
@@ -3203,7 +3608,7 @@ static void libsais16x64_partial_sorting_scan_right_to_left_32s_1k(const sa_sint
 
 static void libsais16x64_partial_sorting_scan_right_to_left_32s_6k_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -3229,7 +3634,7 @@ static void libsais16x64_partial_sorting_scan_right_to_left_32s_6k_block_gather(
 
 static void libsais16x64_partial_sorting_scan_right_to_left_32s_4k_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -3253,7 +3658,7 @@ static void libsais16x64_partial_sorting_scan_right_to_left_32s_4k_block_gather(
 
 static void libsais16x64_partial_sorting_scan_right_to_left_32s_1k_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -3277,7 +3682,7 @@ static void libsais16x64_partial_sorting_scan_right_to_left_32s_1k_block_gather(
 
 static sa_sint_t libsais16x64_partial_sorting_scan_right_to_left_32s_6k_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT buckets, sa_sint_t d, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
@@ -3305,7 +3710,7 @@ static sa_sint_t libsais16x64_partial_sorting_scan_right_to_left_32s_6k_block_so
 
 static sa_sint_t libsais16x64_partial_sorting_scan_right_to_left_32s_4k_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t k, sa_sint_t * RESTRICT buckets, sa_sint_t d, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[3 * (fast_sint_t)k];
     sa_sint_t * RESTRICT distinct_names   = &buckets[0 * (fast_sint_t)k];
@@ -3348,7 +3753,7 @@ static sa_sint_t libsais16x64_partial_sorting_scan_right_to_left_32s_4k_block_so
 
 static void libsais16x64_partial_sorting_scan_right_to_left_32s_1k_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT induction_bucket, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
@@ -3552,7 +3957,9 @@ static sa_sint_t libsais16x64_partial_sorting_scan_right_to_left_32s_6k_omp(cons
         fast_sint_t block_start, block_end;
         for (block_start = scan_end - 1; block_start >= scan_start; block_start = block_end)
         {
-            block_end = block_start - (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end < scan_start) { block_end = scan_start - 1; }
+            if (libsais16x64_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start - (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end < scan_start) { block_end = scan_start - 1; }
 
             d = libsais16x64_partial_sorting_scan_right_to_left_32s_6k_block_omp(T, SA, buckets, d, thread_state[0].state.cache, block_end + 1, block_start - block_end, threads);
         }
@@ -3576,7 +3983,9 @@ static sa_sint_t libsais16x64_partial_sorting_scan_right_to_left_32s_4k_omp(cons
         fast_sint_t block_start, block_end;
         for (block_start = (fast_sint_t)n - 1; block_start >= 0; block_start = block_end)
         {
-            block_end = block_start - (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end < 0) { block_end = -1; }
+            if (libsais16x64_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start - (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end < 0) { block_end = -1; }
 
             d = libsais16x64_partial_sorting_scan_right_to_left_32s_4k_block_omp(T, SA, k, buckets, d, thread_state[0].state.cache, block_end + 1, block_start - block_end, threads);
         }
@@ -3600,7 +4009,9 @@ static void libsais16x64_partial_sorting_scan_right_to_left_32s_1k_omp(const sa_
         fast_sint_t block_start, block_end;
         for (block_start = (fast_sint_t)n - 1; block_start >= 0; block_start = block_end)
         {
-            block_end = block_start - (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end < 0) { block_end = -1; }
+            if (libsais16x64_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start - (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end < 0) { block_end = -1; }
 
             libsais16x64_partial_sorting_scan_right_to_left_32s_1k_block_omp(T, SA, buckets, thread_state[0].state.cache, block_end + 1, block_start - block_end, threads);
         }
@@ -3612,7 +4023,7 @@ static void libsais16x64_partial_sorting_scan_right_to_left_32s_1k_omp(const sa_
 
 static fast_sint_t libsais16x64_partial_sorting_gather_lms_suffixes_32s_4k(sa_sint_t * RESTRICT SA, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j, l;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - 3, l = omp_block_start; i < j; i += 4)
@@ -3635,7 +4046,7 @@ static fast_sint_t libsais16x64_partial_sorting_gather_lms_suffixes_32s_4k(sa_si
 
 static fast_sint_t libsais16x64_partial_sorting_gather_lms_suffixes_32s_1k(sa_sint_t * RESTRICT SA, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j, l;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - 3, l = omp_block_start; i < j; i += 4)
@@ -3807,7 +4218,7 @@ static void libsais16x64_induce_partial_order_32s_1k_omp(const sa_sint_t * RESTR
 
 static sa_sint_t libsais16x64_renumber_lms_suffixes_16u(sa_sint_t * RESTRICT SA, sa_sint_t m, sa_sint_t name, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAm = &SA[m];
 
@@ -3837,7 +4248,7 @@ static sa_sint_t libsais16x64_renumber_lms_suffixes_16u(sa_sint_t * RESTRICT SA,
 
 static fast_sint_t libsais16x64_gather_marked_lms_suffixes(sa_sint_t * RESTRICT SA, sa_sint_t m, fast_sint_t l, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     l -= 1;
 
@@ -3991,7 +4402,7 @@ static sa_sint_t libsais16x64_renumber_and_gather_lms_suffixes_omp(sa_sint_t * R
 
 static sa_sint_t libsais16x64_renumber_distinct_lms_suffixes_32s_4k(sa_sint_t * RESTRICT SA, sa_sint_t m, sa_sint_t name, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAm = &SA[m];
 
@@ -4021,7 +4432,7 @@ static sa_sint_t libsais16x64_renumber_distinct_lms_suffixes_32s_4k(sa_sint_t *
 
 static void libsais16x64_mark_distinct_lms_suffixes_32s(sa_sint_t * RESTRICT SA, sa_sint_t m, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j; sa_sint_t p0, p1, p2, p3 = 0;
     for (i = (fast_sint_t)m + omp_block_start, j = (fast_sint_t)m + omp_block_start + omp_block_size - 3; i < j; i += 4)
@@ -4042,7 +4453,7 @@ static void libsais16x64_mark_distinct_lms_suffixes_32s(sa_sint_t * RESTRICT SA,
 
 static void libsais16x64_clamp_lms_suffixes_length_32s(sa_sint_t * RESTRICT SA, sa_sint_t m, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAm = &SA[m];
 
@@ -4173,7 +4584,7 @@ static sa_sint_t libsais16x64_renumber_and_mark_distinct_lms_suffixes_32s_4k_omp
 
 static sa_sint_t libsais16x64_renumber_and_mark_distinct_lms_suffixes_32s_1k_omp(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t m, sa_sint_t threads)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAm = &SA[m];
 
@@ -4252,7 +4663,7 @@ static sa_sint_t libsais16x64_renumber_and_mark_distinct_lms_suffixes_32s_1k_omp
 
 static void libsais16x64_reconstruct_lms_suffixes(sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t m, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     const sa_sint_t * RESTRICT SAnm = &SA[n - m];
 
@@ -4375,7 +4786,7 @@ static void libsais16x64_place_lms_suffixes_interval_32s_2k(sa_sint_t * RESTRICT
 
 static void libsais16x64_place_lms_suffixes_interval_32s_1k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t m, sa_sint_t * RESTRICT buckets)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t c = k - 1; fast_sint_t i, l = buckets[c];
     for (i = (fast_sint_t)m - 1; i >= prefetch_distance + 3; i -= 4)
@@ -4475,7 +4886,7 @@ static void libsais16x64_place_lms_suffixes_histogram_32s_2k(sa_sint_t * RESTRIC
 
 static void libsais16x64_final_bwt_scan_left_to_right_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -4497,7 +4908,7 @@ static void libsais16x64_final_bwt_scan_left_to_right_16u(const uint16_t * RESTR
 
 static void libsais16x64_final_bwt_aux_scan_left_to_right_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -4517,9 +4928,31 @@ static void libsais16x64_final_bwt_aux_scan_left_to_right_16u(const uint16_t * R
     }
 }
 
+static void libsais16x64_final_bwt_aux_sa_scan_left_to_right_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
+    {
+        libsais16x64_prefetchw(&SA[i + 2 * prefetch_distance]);
+
+        sa_sint_t s0 = SA[i + prefetch_distance + 0]; const uint16_t * Ts0 = &T[s0] - 1; libsais16x64_prefetchr(s0 > 0 ? Ts0 : NULL); Ts0--; libsais16x64_prefetchr(s0 > 0 ? Ts0 : NULL);
+        sa_sint_t s1 = SA[i + prefetch_distance + 1]; const uint16_t * Ts1 = &T[s1] - 1; libsais16x64_prefetchr(s1 > 0 ? Ts1 : NULL); Ts1--; libsais16x64_prefetchr(s1 > 0 ? Ts1 : NULL);
+
+        sa_sint_t p0 = SA[i + 0]; SA[i + 0] = p0 & SAINT_MAX; if (p0 > 0) { p0--; SA[i + 0] = T[p0] | SAINT_MIN; sa_sint_t d0 = induction_bucket[T[p0]]++; SA[d0] = p0 | ((sa_sint_t)(T[p0 - (p0 > 0)] < T[p0]) << (SAINT_BIT - 1)); if ((p0 & rm) == 0) { I[p0 / (rm + 1)] = d0 + 1; } if ((d0 & rm) == 0) { S[d0 / (rm + 1)] = p0; } }
+        sa_sint_t p1 = SA[i + 1]; SA[i + 1] = p1 & SAINT_MAX; if (p1 > 0) { p1--; SA[i + 1] = T[p1] | SAINT_MIN; sa_sint_t d1 = induction_bucket[T[p1]]++; SA[d1] = p1 | ((sa_sint_t)(T[p1 - (p1 > 0)] < T[p1]) << (SAINT_BIT - 1)); if ((p1 & rm) == 0) { I[p1 / (rm + 1)] = d1 + 1; } if ((d1 & rm) == 0) { S[d1 / (rm + 1)] = p1; } }
+    }
+
+    for (j += prefetch_distance + 1; i < j; i += 1)
+    {
+        sa_sint_t p = SA[i]; SA[i] = p & SAINT_MAX; if (p > 0) { p--; SA[i] = T[p] | SAINT_MIN; sa_sint_t d = induction_bucket[T[p]]++; SA[d] = p | ((sa_sint_t)(T[p - (p > 0)] < T[p]) << (SAINT_BIT - 1)); if ((p & rm) == 0) { I[p / (rm + 1)] = d + 1; } if ((d & rm) == 0) { S[d / (rm + 1)] = p; } }
+    }
+}
+
 static void libsais16x64_final_sorting_scan_left_to_right_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -4541,7 +4974,7 @@ static void libsais16x64_final_sorting_scan_left_to_right_16u(const uint16_t * R
 
 static void libsais16x64_final_sorting_scan_left_to_right_32s(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - 2 * prefetch_distance - 1; i < j; i += 2)
@@ -4567,7 +5000,7 @@ static void libsais16x64_final_sorting_scan_left_to_right_32s(const sa_sint_t *
 
 static fast_sint_t libsais16x64_final_bwt_scan_left_to_right_16u_block_prepare(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-   const fast_sint_t prefetch_distance = 32;
+   const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
    memset(buckets, 0, k * sizeof(sa_sint_t));
 
@@ -4593,7 +5026,7 @@ static fast_sint_t libsais16x64_final_bwt_scan_left_to_right_16u_block_prepare(c
 
 static fast_sint_t libsais16x64_final_sorting_scan_left_to_right_16u_block_prepare(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-   const fast_sint_t prefetch_distance = 32;
+   const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
    memset(buckets, 0, k * sizeof(sa_sint_t));
 
@@ -4619,7 +5052,7 @@ static fast_sint_t libsais16x64_final_sorting_scan_left_to_right_16u_block_prepa
 
 static void libsais16x64_final_order_scan_left_to_right_16u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = 0, j = count - 3; i < j; i += 4)
@@ -4640,7 +5073,7 @@ static void libsais16x64_final_order_scan_left_to_right_16u_block_place(sa_sint_
 
 static void libsais16x64_final_bwt_aux_scan_left_to_right_16u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = 0, j = count - 3; i < j; i += 4)
@@ -4659,9 +5092,28 @@ static void libsais16x64_final_bwt_aux_scan_left_to_right_16u_block_place(sa_sin
     }
 }
 
+static void libsais16x64_final_bwt_aux_sa_scan_left_to_right_16u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = 0, j = count - 1; i < j; i += 2)
+    {
+        libsais16x64_prefetchr(&cache[i + prefetch_distance]);
+
+        sa_sint_t d0 = buckets[cache[i + 0].symbol]++; sa_sint_t p0 = cache[i + 0].index; SA[d0] = p0; p0 &= SAINT_MAX; if ((p0 & rm) == 0) { I[p0 / (rm + 1)] = d0 + 1; } if ((d0 & rm) == 0) { S[d0 / (rm + 1)] = p0; }
+        sa_sint_t d1 = buckets[cache[i + 1].symbol]++; sa_sint_t p1 = cache[i + 1].index; SA[d1] = p1; p1 &= SAINT_MAX; if ((p1 & rm) == 0) { I[p1 / (rm + 1)] = d1 + 1; } if ((d1 & rm) == 0) { S[d1 / (rm + 1)] = p1; }
+    }
+
+    for (j += 1; i < j; i += 1)
+    {
+        sa_sint_t d = buckets[cache[i].symbol]++; sa_sint_t p = cache[i].index; SA[d] = p; p &= SAINT_MAX; if ((p & rm) == 0) { I[p / (rm + 1)] = d + 1; } if ((d & rm) == 0) { S[d / (rm + 1)] = p; }
+    }
+}
+
 static void libsais16x64_final_sorting_scan_left_to_right_32s_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -4685,7 +5137,7 @@ static void libsais16x64_final_sorting_scan_left_to_right_32s_block_gather(const
 
 static void libsais16x64_final_sorting_scan_left_to_right_32s_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT induction_bucket, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j, omp_block_end = omp_block_start + omp_block_size;
     for (i = omp_block_start, j = omp_block_end - prefetch_distance - 1; i < j; i += 2)
@@ -4829,7 +5281,7 @@ static void libsais16x64_final_bwt_aux_scan_left_to_right_16u_block_omp(const ui
     }
 }
 
-static void libsais16x64_final_sorting_scan_left_to_right_16u_block_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT induction_bucket, fast_sint_t block_start, fast_sint_t block_size, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+static void libsais16x64_final_bwt_aux_sa_scan_left_to_right_16u_block_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT induction_bucket, fast_sint_t block_start, fast_sint_t block_size, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
 #if defined(LIBSAIS_OPENMP)
     #pragma omp parallel num_threads(threads) if(threads > 1 && block_size >= 64 * (k > 256 ? k : 256) && omp_get_dynamic() == 0)
@@ -4852,13 +5304,13 @@ static void libsais16x64_final_sorting_scan_left_to_right_16u_block_omp(const ui
 
         if (omp_num_threads == 1)
         {
-            libsais16x64_final_sorting_scan_left_to_right_16u(T, SA, induction_bucket, omp_block_start, omp_block_size);
+            libsais16x64_final_bwt_aux_sa_scan_left_to_right_16u(T, SA, rm, I, S, induction_bucket, omp_block_start, omp_block_size);
         }
 #if defined(LIBSAIS_OPENMP)
         else
         {
             {
-                thread_state[omp_thread_num].state.count = libsais16x64_final_sorting_scan_left_to_right_16u_block_prepare(T, SA, k, thread_state[omp_thread_num].state.buckets, thread_state[omp_thread_num].state.cache, omp_block_start, omp_block_size);
+                thread_state[omp_thread_num].state.count = libsais16x64_final_bwt_scan_left_to_right_16u_block_prepare(T, SA, k, thread_state[omp_thread_num].state.buckets, thread_state[omp_thread_num].state.cache, omp_block_start, omp_block_size);
             }
 
             #pragma omp barrier
@@ -4876,24 +5328,24 @@ static void libsais16x64_final_sorting_scan_left_to_right_16u_block_omp(const ui
             #pragma omp barrier
 
             {
-                libsais16x64_final_order_scan_left_to_right_16u_block_place(SA, thread_state[omp_thread_num].state.buckets, thread_state[omp_thread_num].state.cache, thread_state[omp_thread_num].state.count);
+                libsais16x64_final_bwt_aux_sa_scan_left_to_right_16u_block_place(SA, rm, I, S, thread_state[omp_thread_num].state.buckets, thread_state[omp_thread_num].state.cache, thread_state[omp_thread_num].state.count);
             }
         }
 #endif
     }
 }
 
-static void libsais16x64_final_sorting_scan_left_to_right_32s_block_omp(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t block_start, fast_sint_t block_size, sa_sint_t threads)
+static void libsais16x64_final_sorting_scan_left_to_right_16u_block_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT induction_bucket, fast_sint_t block_start, fast_sint_t block_size, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
 #if defined(LIBSAIS_OPENMP)
-    #pragma omp parallel num_threads(threads) if(threads > 1 && block_size >= 16384)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && block_size >= 64 * (k > 256 ? k : 256) && omp_get_dynamic() == 0)
 #endif
     {
 #if defined(LIBSAIS_OPENMP)
         fast_sint_t omp_thread_num    = omp_get_thread_num();
         fast_sint_t omp_num_threads   = omp_get_num_threads();
 #else
-        UNUSED(threads); UNUSED(cache);
+        UNUSED(k); UNUSED(threads); UNUSED(thread_state);
 
         fast_sint_t omp_thread_num    = 0;
         fast_sint_t omp_num_threads   = 1;
@@ -4906,34 +5358,88 @@ static void libsais16x64_final_sorting_scan_left_to_right_32s_block_omp(const sa
 
         if (omp_num_threads == 1)
         {
-            libsais16x64_final_sorting_scan_left_to_right_32s(T, SA, buckets, omp_block_start, omp_block_size);
+            libsais16x64_final_sorting_scan_left_to_right_16u(T, SA, induction_bucket, omp_block_start, omp_block_size);
         }
 #if defined(LIBSAIS_OPENMP)
         else
         {
             {
-                libsais16x64_final_sorting_scan_left_to_right_32s_block_gather(T, SA, cache - block_start, omp_block_start, omp_block_size);
+                thread_state[omp_thread_num].state.count = libsais16x64_final_sorting_scan_left_to_right_16u_block_prepare(T, SA, k, thread_state[omp_thread_num].state.buckets, thread_state[omp_thread_num].state.cache, omp_block_start, omp_block_size);
             }
 
             #pragma omp barrier
 
             #pragma omp master
             {
-                libsais16x64_final_sorting_scan_left_to_right_32s_block_sort(T, buckets, cache - block_start, block_start, block_size);
+                fast_sint_t t;
+                for (t = 0; t < omp_num_threads; ++t)
+                {
+                    sa_sint_t * RESTRICT temp_bucket = thread_state[t].state.buckets;
+                    fast_sint_t c; for (c = 0; c < k; c += 1) { sa_sint_t A = induction_bucket[c], B = temp_bucket[c]; induction_bucket[c] = A + B; temp_bucket[c] = A; }
+                }
             }
 
             #pragma omp barrier
 
             {
-                libsais16x64_compact_and_place_cached_suffixes(SA, cache - block_start, omp_block_start, omp_block_size);
+                libsais16x64_final_order_scan_left_to_right_16u_block_place(SA, thread_state[omp_thread_num].state.buckets, thread_state[omp_thread_num].state.cache, thread_state[omp_thread_num].state.count);
             }
         }
 #endif
     }
 }
 
-#endif
-
+static void libsais16x64_final_sorting_scan_left_to_right_32s_block_omp(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t block_start, fast_sint_t block_size, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && block_size >= 16384)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads); UNUSED(cache);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (block_size / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : block_size - omp_block_start;
+
+        omp_block_start += block_start;
+
+        if (omp_num_threads == 1)
+        {
+            libsais16x64_final_sorting_scan_left_to_right_32s(T, SA, buckets, omp_block_start, omp_block_size);
+        }
+#if defined(LIBSAIS_OPENMP)
+        else
+        {
+            {
+                libsais16x64_final_sorting_scan_left_to_right_32s_block_gather(T, SA, cache - block_start, omp_block_start, omp_block_size);
+            }
+
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                libsais16x64_final_sorting_scan_left_to_right_32s_block_sort(T, buckets, cache - block_start, block_start, block_size);
+            }
+
+            #pragma omp barrier
+
+            {
+                libsais16x64_compact_and_place_cached_suffixes(SA, cache - block_start, omp_block_start, omp_block_size);
+            }
+        }
+#endif
+    }
+}
+
+#endif
+
 static void libsais16x64_final_bwt_scan_left_to_right_16u_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, fast_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
     SA[induction_bucket[T[(sa_sint_t)n - 1]]++] = ((sa_sint_t)n - 1) | ((sa_sint_t)(T[(sa_sint_t)n - 2] < T[(sa_sint_t)n - 1]) << (SAINT_BIT - 1));
@@ -4954,7 +5460,9 @@ static void libsais16x64_final_bwt_scan_left_to_right_16u_omp(const uint16_t * R
             }
             else
             {
-                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
+                if (libsais16x64_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
                 fast_sint_t block_end     = block_start + 1; while (block_end < block_max_end && SA[block_end] != 0) { block_end++; }
                 fast_sint_t block_size    = block_end - block_start;
 
@@ -5000,7 +5508,9 @@ static void libsais16x64_final_bwt_aux_scan_left_to_right_16u_omp(const uint16_t
             }
             else
             {
-                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
+                if (libsais16x64_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
                 fast_sint_t block_end     = block_start + 1; while (block_end < block_max_end && SA[block_end] != 0) { block_end++; }
                 fast_sint_t block_size    = block_end - block_start;
 
@@ -5024,6 +5534,55 @@ static void libsais16x64_final_bwt_aux_scan_left_to_right_16u_omp(const uint16_t
 #endif
 }
 
+static void libsais16x64_final_bwt_aux_sa_scan_left_to_right_16u_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, fast_sint_t n, sa_sint_t k, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+{
+    SA[induction_bucket[T[(sa_sint_t)n - 1]]++] = ((sa_sint_t)n - 1) | ((sa_sint_t)(T[(sa_sint_t)n - 2] < T[(sa_sint_t)n - 1]) << (SAINT_BIT - 1));
+
+    if ((((sa_sint_t)n - 1) & rm) == 0) { I[((sa_sint_t)n - 1) / (rm + 1)] = induction_bucket[T[(sa_sint_t)n - 1]]; }
+    if (((induction_bucket[T[(sa_sint_t)n - 1]] - 1) & rm) == 0) { S[(induction_bucket[T[(sa_sint_t)n - 1]] - 1) / (rm + 1)] = (sa_sint_t)n - 1; }
+
+    if (threads == 1 || n < 65536)
+    {
+        libsais16x64_final_bwt_aux_sa_scan_left_to_right_16u(T, SA, rm, I, S, induction_bucket, 0, n);
+    }
+#if defined(LIBSAIS_OPENMP)
+    else
+    {
+        fast_sint_t block_start;
+        for (block_start = 0; block_start < n; )
+        {
+            if (SA[block_start] == 0)
+            {
+                block_start++;
+            }
+            else
+            {
+                if (libsais16x64_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
+                fast_sint_t block_end     = block_start + 1; while (block_end < block_max_end && SA[block_end] != 0) { block_end++; }
+                fast_sint_t block_size    = block_end - block_start;
+
+                if (block_size < 32)
+                {
+                    for (; block_start < block_end; block_start += 1)
+                    {
+                        sa_sint_t p = SA[block_start]; SA[block_start] = p & SAINT_MAX; if (p > 0) { p--; SA[block_start] = T[p] | SAINT_MIN; sa_sint_t d = induction_bucket[T[p]]++; SA[d] = p | ((sa_sint_t)(T[p - (p > 0)] < T[p]) << (SAINT_BIT - 1)); if ((p & rm) == 0) { I[p / (rm + 1)] = d + 1; } if ((d & rm) == 0) { S[d / (rm + 1)] = p; } }
+                    }
+                }
+                else
+                {
+                    libsais16x64_final_bwt_aux_sa_scan_left_to_right_16u_block_omp(T, SA, k, rm, I, S, induction_bucket, block_start, block_size, threads, thread_state);
+                    block_start = block_end;
+                }
+            }
+        }
+    }
+#else
+    UNUSED(k); UNUSED(thread_state);
+#endif
+}
+
 static void libsais16x64_final_sorting_scan_left_to_right_16u_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, fast_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
     SA[induction_bucket[T[(sa_sint_t)n - 1]]++] = ((sa_sint_t)n - 1) | ((sa_sint_t)(T[(sa_sint_t)n - 2] < T[(sa_sint_t)n - 1]) << (SAINT_BIT - 1));
@@ -5044,7 +5603,9 @@ static void libsais16x64_final_sorting_scan_left_to_right_16u_omp(const uint16_t
             }
             else
             {
-                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
+                if (libsais16x64_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
                 fast_sint_t block_end     = block_start + 1; while (block_end < block_max_end && SA[block_end] != 0) { block_end++; }
                 fast_sint_t block_size    = block_end - block_start;
 
@@ -5082,7 +5643,9 @@ static void libsais16x64_final_sorting_scan_left_to_right_32s_omp(const sa_sint_
         fast_sint_t block_start, block_end;
         for (block_start = 0; block_start < n; block_start = block_end)
         {
-            block_end = block_start + (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end > n) { block_end = n; }
+            if (libsais16x64_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start + (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end > n) { block_end = n; }
 
             libsais16x64_final_sorting_scan_left_to_right_32s_block_omp(T, SA, induction_bucket, thread_state[0].state.cache, block_start, block_end - block_start, threads);
         }
@@ -5094,7 +5657,7 @@ static void libsais16x64_final_sorting_scan_left_to_right_32s_omp(const sa_sint_
 
 static sa_sint_t libsais16x64_final_bwt_scan_right_to_left_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j; sa_sint_t index = -1;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
@@ -5122,7 +5685,7 @@ static sa_sint_t libsais16x64_final_bwt_scan_right_to_left_16u(const uint16_t *
 
 static void libsais16x64_final_bwt_aux_scan_right_to_left_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
@@ -5146,9 +5709,35 @@ static void libsais16x64_final_bwt_aux_scan_right_to_left_16u(const uint16_t * R
     }
 }
 
+static void libsais16x64_final_bwt_aux_sa_scan_right_to_left_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
+    {
+        libsais16x64_prefetchw(&SA[i - 2 * prefetch_distance]);
+
+        sa_sint_t s0 = SA[i - prefetch_distance - 0]; const uint16_t * Ts0 = &T[s0] - 1; libsais16x64_prefetchr(s0 > 0 ? Ts0 : NULL); Ts0--; libsais16x64_prefetchr(s0 > 0 ? Ts0 : NULL);
+        sa_sint_t s1 = SA[i - prefetch_distance - 1]; const uint16_t * Ts1 = &T[s1] - 1; libsais16x64_prefetchr(s1 > 0 ? Ts1 : NULL); Ts1--; libsais16x64_prefetchr(s1 > 0 ? Ts1 : NULL);
+
+        sa_sint_t p0 = SA[i - 0];
+        SA[i - 0] = p0 & SAINT_MAX; if (p0 > 0) { p0--; uint16_t c0 = T[p0 - (p0 > 0)], c1 = T[p0]; SA[i - 0] = c1; sa_sint_t t = c0 | SAINT_MIN; sa_sint_t d0 = --induction_bucket[c1]; SA[d0] = (c0 <= c1) ? p0 : t; if ((p0 & rm) == 0) { I[p0 / (rm + 1)] = d0 + 1; } if ((d0 & rm) == 0) { S[d0 / (rm + 1)] = p0; } }
+
+        sa_sint_t p1 = SA[i - 1];
+        SA[i - 1] = p1 & SAINT_MAX; if (p1 > 0) { p1--; uint16_t c0 = T[p1 - (p1 > 0)], c1 = T[p1]; SA[i - 1] = c1; sa_sint_t t = c0 | SAINT_MIN; sa_sint_t d1 = --induction_bucket[c1]; SA[d1] = (c0 <= c1) ? p1 : t; if ((p1 & rm) == 0) { I[p1 / (rm + 1)] = d1 + 1; } if ((d1 & rm) == 0) { S[d1 / (rm + 1)] = p1; } }
+    }
+
+    for (j -= prefetch_distance + 1; i >= j; i -= 1)
+    {
+        sa_sint_t p = SA[i];
+        SA[i] = p & SAINT_MAX; if (p > 0) { p--; uint16_t c0 = T[p - (p > 0)], c1 = T[p]; SA[i] = c1; sa_sint_t t = c0 | SAINT_MIN; sa_sint_t d = --induction_bucket[c1]; SA[d] = (c0 <= c1) ? p : t; if ((p & rm) == 0) { I[p / (rm + 1)] = d + 1; } if ((d & rm) == 0) { S[d / (rm + 1)] = p; } }
+    }
+}
+
 static void libsais16x64_final_sorting_scan_right_to_left_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
@@ -5170,7 +5759,7 @@ static void libsais16x64_final_sorting_scan_right_to_left_16u(const uint16_t * R
 
 static void libsais16x64_final_sorting_scan_right_to_left_32s(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + 2 * prefetch_distance + 1; i >= j; i -= 2)
@@ -5196,7 +5785,7 @@ static void libsais16x64_final_sorting_scan_right_to_left_32s(const sa_sint_t *
 
 static fast_sint_t libsais16x64_final_bwt_scan_right_to_left_16u_block_prepare(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-   const fast_sint_t prefetch_distance = 32;
+   const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
    memset(buckets, 0, k * sizeof(sa_sint_t));
 
@@ -5222,7 +5811,7 @@ static fast_sint_t libsais16x64_final_bwt_scan_right_to_left_16u_block_prepare(c
 
 static fast_sint_t libsais16x64_final_bwt_aux_scan_right_to_left_16u_block_prepare(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-   const fast_sint_t prefetch_distance = 32;
+   const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
    memset(buckets, 0, k * sizeof(sa_sint_t));
 
@@ -5248,7 +5837,7 @@ static fast_sint_t libsais16x64_final_bwt_aux_scan_right_to_left_16u_block_prepa
 
 static fast_sint_t libsais16x64_final_sorting_scan_right_to_left_16u_block_prepare(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-   const fast_sint_t prefetch_distance = 32;
+   const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
    memset(buckets, 0, k * sizeof(sa_sint_t));
 
@@ -5274,7 +5863,7 @@ static fast_sint_t libsais16x64_final_sorting_scan_right_to_left_16u_block_prepa
 
 static void libsais16x64_final_order_scan_right_to_left_16u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = 0, j = count - 3; i < j; i += 4)
@@ -5295,7 +5884,7 @@ static void libsais16x64_final_order_scan_right_to_left_16u_block_place(sa_sint_
 
 static void libsais16x64_final_bwt_aux_scan_right_to_left_16u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = 0, j = count - 6; i < j; i += 8)
@@ -5314,9 +5903,28 @@ static void libsais16x64_final_bwt_aux_scan_right_to_left_16u_block_place(sa_sin
     }
 }
 
+static void libsais16x64_final_bwt_aux_sa_scan_right_to_left_16u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = 0, j = count - 2; i < j; i += 4)
+    {
+        libsais16x64_prefetchr(&cache[i + prefetch_distance]);
+
+        sa_sint_t d0 = --buckets[cache[i + 0].symbol]; SA[d0] = cache[i + 0].index; sa_sint_t p0 = cache[i + 1].index; if ((p0 & rm) == 0) { I[p0 / (rm + 1)] = d0 + 1; } if ((d0 & rm) == 0) { S[d0 / (rm + 1)] = p0; }
+        sa_sint_t d1 = --buckets[cache[i + 2].symbol]; SA[d1] = cache[i + 2].index; sa_sint_t p1 = cache[i + 3].index; if ((p1 & rm) == 0) { I[p1 / (rm + 1)] = d1 + 1; } if ((d1 & rm) == 0) { S[d1 / (rm + 1)] = p1; }
+    }
+
+    for (j += 2; i < j; i += 2)
+    {
+        sa_sint_t d = --buckets[cache[i].symbol]; SA[d] = cache[i].index; sa_sint_t p = cache[i + 1].index; if ((p & rm) == 0) { I[p / (rm + 1)] = d + 1; } if ((d & rm) == 0) { S[d / (rm + 1)] = p; }
+    }
+}
+
 static void libsais16x64_final_sorting_scan_right_to_left_32s_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -5340,7 +5948,7 @@ static void libsais16x64_final_sorting_scan_right_to_left_32s_block_gather(const
 
 static void libsais16x64_final_sorting_scan_right_to_left_32s_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT induction_bucket, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
@@ -5484,6 +6092,60 @@ static void libsais16x64_final_bwt_aux_scan_right_to_left_16u_block_omp(const ui
     }
 }
 
+static void libsais16x64_final_bwt_aux_sa_scan_right_to_left_16u_block_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT induction_bucket, fast_sint_t block_start, fast_sint_t block_size, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && block_size >= 64 * (k > 256 ? k : 256) && omp_get_dynamic() == 0)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(k); UNUSED(threads); UNUSED(thread_state);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (block_size / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : block_size - omp_block_start;
+
+        omp_block_start += block_start;
+
+        if (omp_num_threads == 1)
+        {
+            libsais16x64_final_bwt_aux_sa_scan_right_to_left_16u(T, SA, rm, I, S, induction_bucket, omp_block_start, omp_block_size);
+        }
+#if defined(LIBSAIS_OPENMP)
+        else
+        {
+            {
+                thread_state[omp_thread_num].state.count = libsais16x64_final_bwt_aux_scan_right_to_left_16u_block_prepare(T, SA, k, thread_state[omp_thread_num].state.buckets, thread_state[omp_thread_num].state.cache, omp_block_start, omp_block_size);
+            }
+
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                fast_sint_t t;
+                for (t = omp_num_threads - 1; t >= 0; --t)
+                {
+                    sa_sint_t * RESTRICT temp_bucket = thread_state[t].state.buckets;
+                    fast_sint_t c; for (c = 0; c < k; c += 1) { sa_sint_t A = induction_bucket[c], B = temp_bucket[c]; induction_bucket[c] = A - B; temp_bucket[c] = A; }
+                }
+            }
+
+            #pragma omp barrier
+
+            {
+                libsais16x64_final_bwt_aux_sa_scan_right_to_left_16u_block_place(SA, rm, I, S, thread_state[omp_thread_num].state.buckets, thread_state[omp_thread_num].state.cache, thread_state[omp_thread_num].state.count);
+            }
+        }
+#endif
+    }
+}
+
 static void libsais16x64_final_sorting_scan_right_to_left_16u_block_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT induction_bucket, fast_sint_t block_start, fast_sint_t block_size, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
 #if defined(LIBSAIS_OPENMP)
@@ -5609,7 +6271,9 @@ static sa_sint_t libsais16x64_final_bwt_scan_right_to_left_16u_omp(const uint16_
             }
             else
             {
-                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end < 0) { block_max_end = -1; }
+                if (libsais16x64_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end < 0) { block_max_end = -1; }
                 fast_sint_t block_end     = block_start - 1; while (block_end > block_max_end && SA[block_end] != 0) { block_end--; }
                 fast_sint_t block_size    = block_start - block_end;
 
@@ -5653,7 +6317,9 @@ static void libsais16x64_final_bwt_aux_scan_right_to_left_16u_omp(const uint16_t
             }
             else
             {
-                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * ((LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads) / 2); if (block_max_end < 0) { block_max_end = -1; }
+                if (libsais16x64_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * ((thread_state[0].state.cache_size - 16 * (fast_sint_t)threads) / 2); if (block_max_end < 0) { block_max_end = -1; }
                 fast_sint_t block_end     = block_start - 1; while (block_end > block_max_end && SA[block_end] != 0) { block_end--; }
                 fast_sint_t block_size    = block_start - block_end;
 
@@ -5677,6 +6343,50 @@ static void libsais16x64_final_bwt_aux_scan_right_to_left_16u_omp(const uint16_t
 #endif
 }
 
+static void libsais16x64_final_bwt_aux_sa_scan_right_to_left_16u_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+{
+    if (threads == 1 || n < 65536)
+    {
+        libsais16x64_final_bwt_aux_sa_scan_right_to_left_16u(T, SA, rm, I, S, induction_bucket, 0, n);
+    }
+#if defined(LIBSAIS_OPENMP)
+    else
+    {
+        fast_sint_t block_start;
+        for (block_start = (fast_sint_t)n - 1; block_start >= 0; )
+        {
+            if (SA[block_start] == 0)
+            {
+                block_start--;
+            }
+            else
+            {
+                if (libsais16x64_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * ((thread_state[0].state.cache_size - 16 * (fast_sint_t)threads) / 2); if (block_max_end < 0) { block_max_end = -1; }
+                fast_sint_t block_end     = block_start - 1; while (block_end > block_max_end && SA[block_end] != 0) { block_end--; }
+                fast_sint_t block_size    = block_start - block_end;
+
+                if (block_size < 32)
+                {
+                    for (; block_start > block_end; block_start -= 1)
+                    {
+                        sa_sint_t p = SA[block_start]; SA[block_start] = p & SAINT_MAX; if (p > 0) { p--; uint16_t c0 = T[p - (p > 0)], c1 = T[p]; SA[block_start] = c1; sa_sint_t t = c0 | SAINT_MIN; sa_sint_t d = --induction_bucket[c1]; SA[d] = (c0 <= c1) ? p : t; if ((p & rm) == 0) { I[p / (rm + 1)] = d + 1; } if ((d & rm) == 0) { S[d / (rm + 1)] = p; } }
+                    }
+                }
+                else
+                {
+                    libsais16x64_final_bwt_aux_sa_scan_right_to_left_16u_block_omp(T, SA, k, rm, I, S, induction_bucket, block_end + 1, block_size, threads, thread_state);
+                    block_start = block_end;
+                }
+            }
+        }
+    }
+#else
+    UNUSED(k); UNUSED(thread_state);
+#endif
+}
+
 static void libsais16x64_final_sorting_scan_right_to_left_16u_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
     if (threads == 1 || n < 65536)
@@ -5695,7 +6405,9 @@ static void libsais16x64_final_sorting_scan_right_to_left_16u_omp(const uint16_t
             }
             else
             {
-                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end < -1) { block_max_end = -1; }
+                if (libsais16x64_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end < -1) { block_max_end = -1; }
                 fast_sint_t block_end     = block_start - 1; while (block_end > block_max_end && SA[block_end] != 0) { block_end--; }
                 fast_sint_t block_size    = block_start - block_end;
 
@@ -5731,7 +6443,9 @@ static void libsais16x64_final_sorting_scan_right_to_left_32s_omp(const sa_sint_
         fast_sint_t block_start, block_end;
         for (block_start = (fast_sint_t)n - 1; block_start >= 0; block_start = block_end)
         {
-            block_end = block_start - (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end < 0) { block_end = -1; }
+            if (libsais16x64_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start - (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end < 0) { block_end = -1; }
 
             libsais16x64_final_sorting_scan_right_to_left_32s_block_omp(T, SA, induction_bucket, thread_state[0].state.cache, block_end + 1, block_start - block_end, threads);
         }
@@ -5759,7 +6473,7 @@ static void libsais16x64_clear_lms_suffixes_omp(sa_sint_t * RESTRICT SA, sa_sint
     }
 }
 
-static sa_sint_t libsais16x64_induce_final_order_16u_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t bwt, sa_sint_t r, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT buckets, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+static sa_sint_t libsais16x64_induce_final_order_16u_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t bwt, sa_sint_t r, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT buckets, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
     if (!bwt)
     {
@@ -5768,6 +6482,13 @@ static sa_sint_t libsais16x64_induce_final_order_16u_omp(const uint16_t * RESTRI
         libsais16x64_final_sorting_scan_right_to_left_16u_omp(T, SA, n, k, &buckets[7 * ALPHABET_SIZE], threads, thread_state);
         return 0;
     }
+    else if (S != NULL)
+    {
+        libsais16x64_final_bwt_aux_sa_scan_left_to_right_16u_omp(T, SA, n, k, r - 1, I, S, &buckets[6 * ALPHABET_SIZE], threads, thread_state);
+        if (threads > 1 && n >= 65536) { libsais16x64_clear_lms_suffixes_omp(SA, n, ALPHABET_SIZE, &buckets[6 * ALPHABET_SIZE], &buckets[7 * ALPHABET_SIZE], threads); }
+        libsais16x64_final_bwt_aux_sa_scan_right_to_left_16u_omp(T, SA, n, k, r - 1, I, S, &buckets[7 * ALPHABET_SIZE], threads, thread_state);
+        return 0;
+    }
     else if (I != NULL)
     {
         libsais16x64_final_bwt_aux_scan_left_to_right_16u_omp(T, SA, n, k, r - 1, I, &buckets[6 * ALPHABET_SIZE], threads, thread_state);
@@ -5814,7 +6535,7 @@ static void libsais16x64_induce_final_order_32s_1k(const sa_sint_t * RESTRICT T,
 
 static sa_sint_t libsais16x64_renumber_unique_and_nonunique_lms_suffixes_32s(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t m, sa_sint_t f, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAm = &SA[m];
 
@@ -5849,7 +6570,7 @@ static sa_sint_t libsais16x64_renumber_unique_and_nonunique_lms_suffixes_32s(sa_
 
 static void libsais16x64_compact_unique_and_nonunique_lms_suffixes_32s(sa_sint_t * RESTRICT SA, sa_sint_t m, fast_sint_t * pl, fast_sint_t * pr, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAl = &SA[0];
     sa_sint_t * RESTRICT SAr = &SA[0];
@@ -5878,7 +6599,7 @@ static void libsais16x64_compact_unique_and_nonunique_lms_suffixes_32s(sa_sint_t
 
 static sa_sint_t libsais16x64_count_unique_suffixes(sa_sint_t * RESTRICT SA, sa_sint_t m, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAm = &SA[m];
 
@@ -6038,7 +6759,7 @@ static sa_sint_t libsais16x64_compact_lms_suffixes_32s_omp(sa_sint_t * RESTRICT
 
 static void libsais16x64_merge_unique_lms_suffixes_32s(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t m, fast_sint_t l, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     const sa_sint_t * RESTRICT SAnm = &SA[(fast_sint_t)n - (fast_sint_t)m - 1 + l];
 
@@ -6061,7 +6782,7 @@ static void libsais16x64_merge_unique_lms_suffixes_32s(sa_sint_t * RESTRICT T, s
 
 static void libsais16x64_merge_nonunique_lms_suffixes_32s(sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t m, fast_sint_t l, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     const sa_sint_t * RESTRICT SAnm = &SA[(fast_sint_t)n - (fast_sint_t)m - 1 + l];
 
@@ -6279,53 +7000,86 @@ static void libsais16x64_convert_inplace_32u_to_64u_omp(uint32_t * V, sa_sint_t
     libsais16x64_convert_inplace_32u_to_64u(V, 0, n);
 }
 
-static sa_sint_t libsais16x64_main_32s_recursion(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t * RESTRICT local_buffer)
+static sa_sint_t libsais16x64_adaptive_threads(const LIBSAIS_MONITOR * monitor, sa_sint_t threads, sa_sint_t n, sa_sint_t k)
+{
+    if (monitor == NULL || monitor->thread_block_size <= 0) { return threads; }
+
+    fast_sint_t block_size  = (fast_sint_t)k * 16 > (fast_sint_t)monitor->thread_block_size ? (fast_sint_t)k * 16 : (fast_sint_t)monitor->thread_block_size;
+    fast_sint_t max_threads = (fast_sint_t)n / block_size;
+
+    return max_threads < (fast_sint_t)threads ? (max_threads > 1 ? (sa_sint_t)max_threads : 1) : threads;
+}
+
+static sa_sint_t libsais16x64_main_32s_recursion(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t * RESTRICT local_buffer, sa_sint_t local_buffer_size, const LIBSAIS_ALLOCATOR * allocator, const void * ctx32, LIBSAIS_MONITOR * monitor, sa_sint_t depth)
 {
     fs = fs < (SAINT_MAX - n) ? fs : (SAINT_MAX - n);
+    threads = libsais16x64_adaptive_threads(monitor, threads, n, k);
+
+    if (libsais16x64_cancelled(monitor)) { return -5; }
 
     if (n <= INT32_MAX)
     {
         sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
         if ((new_fs / k >= 6) || (new_fs / k >= 4 && n <= INT32_MAX / 2) || (new_fs / k < 4 && new_fs >= fs))
         {
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_LEVEL, 0, depth, n, k, LIBSAIS16X64_PROFILE_DELEGATED);
             libsais16x64_convert_inplace_64u_to_32u((uint32_t *)(void *)T, 0, n);
 
 #if defined(LIBSAIS_OPENMP)
-            sa_sint_t index = libsais16_int_omp((int32_t *)T, (int32_t *)SA, (int32_t)n, (int32_t)k, (int32_t)new_fs, (int32_t)threads);
+            sa_sint_t index = ctx32 != NULL
+                ? libsais16_int_ctx(ctx32, (int32_t *)T, (int32_t *)SA, (int32_t)n, (int32_t)k, (int32_t)new_fs)
+                : libsais16_int_omp((int32_t *)T, (int32_t *)SA, (int32_t)n, (int32_t)k, (int32_t)new_fs, (int32_t)threads);
 #else
-            sa_sint_t index = libsais16_int((int32_t *)T, (int32_t *)SA, (int32_t)n, (int32_t)k, (int32_t)new_fs);
+            sa_sint_t index = ctx32 != NULL
+                ? libsais16_int_ctx(ctx32, (int32_t *)T, (int32_t *)SA, (int32_t)n, (int32_t)k, (int32_t)new_fs)
+                : libsais16_int((int32_t *)T, (int32_t *)SA, (int32_t)n, (int32_t)k, (int32_t)new_fs);
 #endif
             if (index >= 0)
             {
                 libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)SA, n, threads);
+                if (depth == 0) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)T, n, threads); }
             }
 
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_LEVEL, 1, depth, n, k, LIBSAIS16X64_PROFILE_DELEGATED);
             return index;
         }
     }
 
-    if (k > 0 && ((fs / k >= 6) || (LIBSAIS_LOCAL_BUFFER_SIZE / k >= 6 && threads == 1)))
+    if (k > 0 && ((fs / k >= 6) || (local_buffer_size / k >= 6 && threads == 1)))
     {
         sa_sint_t alignment = (fs - 1024) / k >= 6 ? (sa_sint_t)1024 : (sa_sint_t)16;
         sa_sint_t * RESTRICT buckets = (fs - alignment) / k >= 6 ? (sa_sint_t *)libsais16x64_align_up(&SA[n + fs - 6 * (fast_sint_t)k - alignment], (size_t)alignment * sizeof(sa_sint_t)) : &SA[n + fs - 6 * (fast_sint_t)k];
-        buckets = (LIBSAIS_LOCAL_BUFFER_SIZE / k >= 6 && threads == 1) ? local_buffer : buckets;
+        buckets = (local_buffer_size / k >= 6 && threads == 1) ? local_buffer : buckets;
+
+        sa_sint_t flags = LIBSAIS16X64_PROFILE_6K | (buckets == local_buffer ? LIBSAIS16X64_PROFILE_LOCAL_BUFFER : LIBSAIS16X64_PROFILE_FREE_SPACE);
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_LEVEL, 0, depth, n, k, flags);
 
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_GATHER, 0, depth, n, k, flags);
         sa_sint_t m = libsais16x64_count_and_gather_lms_suffixes_32s_4k_omp(T, SA, n, k, buckets, threads, thread_state);
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_GATHER, 1, depth, n, k, flags);
+
         if (m > 1)
         {
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RADIX_SORT, 0, depth, n, k, flags);
             memset(SA, 0, ((size_t)n - (size_t)m) * sizeof(sa_sint_t));
 
             sa_sint_t first_lms_suffix    = SA[n - m];
             sa_sint_t left_suffixes_count = libsais16x64_initialize_buckets_for_lms_suffixes_radix_sort_32s_6k(T, k, buckets, first_lms_suffix);
 
-            libsais16x64_radix_sort_lms_suffixes_32s_6k_omp(T, SA, n, m, &buckets[4 * (fast_sint_t)k], threads, thread_state);
+            libsais16x64_radix_sort_lms_suffixes_32s_6k_omp(T, SA, n, m, &buckets[4 * (fast_sint_t)k], libsais16x64_adaptive_threads(monitor, threads, m, k), thread_state);
 
             if ((n / 8192) < k) { libsais16x64_radix_sort_set_markers_32s_6k_omp(SA, k, &buckets[4 * (fast_sint_t)k], threads); }
             if (threads > 1 && n >= 65536) { memset(&SA[(fast_sint_t)n - (fast_sint_t)m], 0, (size_t)m * sizeof(sa_sint_t)); }
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RADIX_SORT, 1, depth, n, k, flags);
+            if (libsais16x64_cancelled(monitor)) { return -5; }
 
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_PARTIAL_SORT, 0, depth, n, k, flags);
             libsais16x64_initialize_buckets_for_partial_sorting_32s_6k(T, k, buckets, first_lms_suffix, left_suffixes_count);
             libsais16x64_induce_partial_order_32s_6k_omp(T, SA, n, k, buckets, first_lms_suffix, left_suffixes_count, threads, thread_state);
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_PARTIAL_SORT, 1, depth, n, k, flags);
+            if (libsais16x64_cancelled(monitor)) { return -5; }
 
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RENUMBER, 0, depth, n, k, flags);
             sa_sint_t names = (n / 8192) < k
                 ? libsais16x64_renumber_and_mark_distinct_lms_suffixes_32s_4k_omp(SA, n, m, threads, thread_state)
                 : libsais16x64_renumber_and_gather_lms_suffixes_omp(SA, n, m, fs, threads, thread_state);
@@ -6335,65 +7089,95 @@ static sa_sint_t libsais16x64_main_32s_recursion(sa_sint_t * RESTRICT T, sa_sint
                 sa_sint_t f = (n / 8192) < k
                     ? libsais16x64_compact_lms_suffixes_32s_omp(T, SA, n, m, fs, threads, thread_state)
                     : 0;
+                libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RENUMBER, 1, depth, m, names, flags);
 
-                if (libsais16x64_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer) != 0)
+                sa_sint_t status = libsais16x64_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer, local_buffer_size, allocator, ctx32, monitor, depth + 1);
+                if (status != 0)
                 {
-                    return -2;
+                    return status;
                 }
 
+                libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RECONSTRUCT, 0, depth, n, k, flags);
                 libsais16x64_reconstruct_compacted_lms_suffixes_32s_2k_omp(T, SA, n, k, m, fs, f, buckets, threads, thread_state);
+                libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RECONSTRUCT, 1, depth, n, k, flags);
             }
             else
             {
+                libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RENUMBER, 1, depth, m, names, flags);
                 libsais16x64_count_lms_suffixes_32s_2k(T, n, k, buckets);
             }
 
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_FINAL_SORT, 0, depth, n, k, flags);
             libsais16x64_initialize_buckets_start_and_end_32s_4k(k, buckets);
             libsais16x64_place_lms_suffixes_histogram_32s_4k(SA, n, k, m, buckets);
             libsais16x64_induce_final_order_32s_4k(T, SA, n, k, buckets, threads, thread_state);
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_FINAL_SORT, 1, depth, n, k, flags);
+            if (libsais16x64_cancelled(monitor)) { return -5; }
         }
         else
         {
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_FINAL_SORT, 0, depth, n, k, flags);
             SA[0] = SA[n - 1];
 
             libsais16x64_initialize_buckets_start_and_end_32s_6k(k, buckets);
             libsais16x64_place_lms_suffixes_histogram_32s_6k(SA, n, k, m, buckets);
             libsais16x64_induce_final_order_32s_6k(T, SA, n, k, buckets, threads, thread_state);
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_FINAL_SORT, 1, depth, n, k, flags);
+            if (libsais16x64_cancelled(monitor)) { return -5; }
         }
 
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_LEVEL, 1, depth, n, k, flags);
         return 0;
     }
-    else if (k > 0 && (n <= SAINT_MAX / 2) && ((fs / k >= 4) || (LIBSAIS_LOCAL_BUFFER_SIZE / k >= 4 && threads == 1)))
+    else if (k > 0 && (n <= SAINT_MAX / 2) && ((fs / k >= 4) || (local_buffer_size / k >= 4 && threads == 1)))
     {
         sa_sint_t alignment = (fs - 1024) / k >= 4 ? (sa_sint_t)1024 : (sa_sint_t)16;
         sa_sint_t * RESTRICT buckets = (fs - alignment) / k >= 4 ? (sa_sint_t *)libsais16x64_align_up(&SA[n + fs - 4 * (fast_sint_t)k - alignment], (size_t)alignment * sizeof(sa_sint_t)) : &SA[n + fs - 4 * (fast_sint_t)k];
-        buckets = (LIBSAIS_LOCAL_BUFFER_SIZE / k >= 4 && threads == 1) ? local_buffer : buckets;
+        buckets = (local_buffer_size / k >= 4 && threads == 1) ? local_buffer : buckets;
+
+        sa_sint_t flags = LIBSAIS16X64_PROFILE_4K | (buckets == local_buffer ? LIBSAIS16X64_PROFILE_LOCAL_BUFFER : LIBSAIS16X64_PROFILE_FREE_SPACE);
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_LEVEL, 0, depth, n, k, flags);
 
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_GATHER, 0, depth, n, k, flags);
         sa_sint_t m = libsais16x64_count_and_gather_lms_suffixes_32s_2k_omp(T, SA, n, k, buckets, threads, thread_state);
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_GATHER, 1, depth, n, k, flags);
+
         if (m > 1)
         {
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RADIX_SORT, 0, depth, n, k, flags);
             libsais16x64_initialize_buckets_for_radix_and_partial_sorting_32s_4k(T, k, buckets, SA[n - m]);
 
-            libsais16x64_radix_sort_lms_suffixes_32s_2k_omp(T, SA, n, m, &buckets[1], threads, thread_state);
+            libsais16x64_radix_sort_lms_suffixes_32s_2k_omp(T, SA, n, m, &buckets[1], libsais16x64_adaptive_threads(monitor, threads, m, k), thread_state);
             libsais16x64_radix_sort_set_markers_32s_4k_omp(SA, k, &buckets[1], threads);
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RADIX_SORT, 1, depth, n, k, flags);
+            if (libsais16x64_cancelled(monitor)) { return -5; }
             
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_PARTIAL_SORT, 0, depth, n, k, flags);
             libsais16x64_place_lms_suffixes_interval_32s_4k(SA, n, k, m - 1, buckets);
             libsais16x64_induce_partial_order_32s_4k_omp(T, SA, n, k, buckets, threads, thread_state);
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_PARTIAL_SORT, 1, depth, n, k, flags);
+            if (libsais16x64_cancelled(monitor)) { return -5; }
 
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RENUMBER, 0, depth, n, k, flags);
             sa_sint_t names = libsais16x64_renumber_and_mark_distinct_lms_suffixes_32s_4k_omp(SA, n, m, threads, thread_state);
             if (names < m)
             {
                 sa_sint_t f = libsais16x64_compact_lms_suffixes_32s_omp(T, SA, n, m, fs, threads, thread_state);
+                libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RENUMBER, 1, depth, m, names, flags);
 
-                if (libsais16x64_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer) != 0)
+                sa_sint_t status = libsais16x64_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer, local_buffer_size, allocator, ctx32, monitor, depth + 1);
+                if (status != 0)
                 {
-                    return -2;
+                    return status;
                 }
 
+                libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RECONSTRUCT, 0, depth, n, k, flags);
                 libsais16x64_reconstruct_compacted_lms_suffixes_32s_2k_omp(T, SA, n, k, m, fs, f, buckets, threads, thread_state);
+                libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RECONSTRUCT, 1, depth, n, k, flags);
             }
             else
             {
+                libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RENUMBER, 1, depth, m, names, flags);
                 libsais16x64_count_lms_suffixes_32s_2k(T, n, k, buckets);
             }
         }
@@ -6402,43 +7186,65 @@ static sa_sint_t libsais16x64_main_32s_recursion(sa_sint_t * RESTRICT T, sa_sint
             SA[0] = SA[n - 1];
         }
 
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_FINAL_SORT, 0, depth, n, k, flags);
         libsais16x64_initialize_buckets_start_and_end_32s_4k(k, buckets);
         libsais16x64_place_lms_suffixes_histogram_32s_4k(SA, n, k, m, buckets);
         libsais16x64_induce_final_order_32s_4k(T, SA, n, k, buckets, threads, thread_state);
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_FINAL_SORT, 1, depth, n, k, flags);
+        if (libsais16x64_cancelled(monitor)) { return -5; }
 
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_LEVEL, 1, depth, n, k, flags);
         return 0;
     }
-    else if (k > 0 && ((fs / k >= 2) || (LIBSAIS_LOCAL_BUFFER_SIZE / k >= 2 && threads == 1)))
+    else if (k > 0 && ((fs / k >= 2) || (local_buffer_size / k >= 2 && threads == 1)))
     {
         sa_sint_t alignment = (fs - 1024) / k >= 2 ? (sa_sint_t)1024 : (sa_sint_t)16;
         sa_sint_t * RESTRICT buckets = (fs - alignment) / k >= 2 ? (sa_sint_t *)libsais16x64_align_up(&SA[n + fs - 2 * (fast_sint_t)k - alignment], (size_t)alignment * sizeof(sa_sint_t)) : &SA[n + fs - 2 * (fast_sint_t)k];
-        buckets = (LIBSAIS_LOCAL_BUFFER_SIZE / k >= 2 && threads == 1) ? local_buffer : buckets;
+        buckets = (local_buffer_size / k >= 2 && threads == 1) ? local_buffer : buckets;
+
+        sa_sint_t flags = LIBSAIS16X64_PROFILE_2K | (buckets == local_buffer ? LIBSAIS16X64_PROFILE_LOCAL_BUFFER : LIBSAIS16X64_PROFILE_FREE_SPACE);
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_LEVEL, 0, depth, n, k, flags);
 
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_GATHER, 0, depth, n, k, flags);
         sa_sint_t m = libsais16x64_count_and_gather_lms_suffixes_32s_2k_omp(T, SA, n, k, buckets, threads, thread_state);
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_GATHER, 1, depth, n, k, flags);
+
         if (m > 1)
         {
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RADIX_SORT, 0, depth, n, k, flags);
             libsais16x64_initialize_buckets_for_lms_suffixes_radix_sort_32s_2k(T, k, buckets, SA[n - m]);
 
-            libsais16x64_radix_sort_lms_suffixes_32s_2k_omp(T, SA, n, m, &buckets[1], threads, thread_state);
+            libsais16x64_radix_sort_lms_suffixes_32s_2k_omp(T, SA, n, m, &buckets[1], libsais16x64_adaptive_threads(monitor, threads, m, k), thread_state);
             libsais16x64_place_lms_suffixes_interval_32s_2k(SA, n, k, m - 1, buckets);
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RADIX_SORT, 1, depth, n, k, flags);
+            if (libsais16x64_cancelled(monitor)) { return -5; }
 
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_PARTIAL_SORT, 0, depth, n, k, flags);
             libsais16x64_initialize_buckets_start_and_end_32s_2k(k, buckets);
             libsais16x64_induce_partial_order_32s_2k_omp(T, SA, n, k, buckets, threads, thread_state);
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_PARTIAL_SORT, 1, depth, n, k, flags);
+            if (libsais16x64_cancelled(monitor)) { return -5; }
 
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RENUMBER, 0, depth, n, k, flags);
             sa_sint_t names = libsais16x64_renumber_and_mark_distinct_lms_suffixes_32s_1k_omp(T, SA, n, m, threads);
             if (names < m)
             {
                 sa_sint_t f = libsais16x64_compact_lms_suffixes_32s_omp(T, SA, n, m, fs, threads, thread_state);
+                libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RENUMBER, 1, depth, m, names, flags);
 
-                if (libsais16x64_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer) != 0)
+                sa_sint_t status = libsais16x64_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer, local_buffer_size, allocator, ctx32, monitor, depth + 1);
+                if (status != 0)
                 {
-                    return -2;
+                    return status;
                 }
 
+                libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RECONSTRUCT, 0, depth, n, k, flags);
                 libsais16x64_reconstruct_compacted_lms_suffixes_32s_2k_omp(T, SA, n, k, m, fs, f, buckets, threads, thread_state);
+                libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RECONSTRUCT, 1, depth, n, k, flags);
             }
             else
             {
+                libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RENUMBER, 1, depth, m, names, flags);
                 libsais16x64_count_lms_suffixes_32s_2k(T, n, k, buckets);
             }
         }
@@ -6447,167 +7253,174 @@ static sa_sint_t libsais16x64_main_32s_recursion(sa_sint_t * RESTRICT T, sa_sint
             SA[0] = SA[n - 1];
         }
 
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_FINAL_SORT, 0, depth, n, k, flags);
         libsais16x64_initialize_buckets_end_32s_2k(k, buckets);
         libsais16x64_place_lms_suffixes_histogram_32s_2k(SA, n, k, m, buckets);
 
         libsais16x64_initialize_buckets_start_and_end_32s_2k(k, buckets);
         libsais16x64_induce_final_order_32s_2k(T, SA, n, k, buckets, threads, thread_state);
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_FINAL_SORT, 1, depth, n, k, flags);
+        if (libsais16x64_cancelled(monitor)) { return -5; }
 
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_LEVEL, 1, depth, n, k, flags);
         return 0;
     }
     else
     {
-        sa_sint_t * buffer = fs < k ? (sa_sint_t *)libsais16x64_alloc_aligned((size_t)k * sizeof(sa_sint_t), 4096) : (sa_sint_t *)NULL;
+        sa_sint_t * buffer = fs < k ? (sa_sint_t *)libsais16x64_alloc_memory(allocator, (size_t)k * sizeof(sa_sint_t), 4096) : (sa_sint_t *)NULL;
 
         sa_sint_t alignment = fs - 1024 >= k ? (sa_sint_t)1024 : (sa_sint_t)16;
         sa_sint_t * RESTRICT buckets = fs - alignment >= k ? (sa_sint_t *)libsais16x64_align_up(&SA[n + fs - k - alignment], (size_t)alignment * sizeof(sa_sint_t)) : fs >= k ? &SA[n + fs - k] : buffer;
 
         if (buckets == NULL) { return -2; }
 
+        sa_sint_t flags = LIBSAIS16X64_PROFILE_1K | (buffer != NULL ? LIBSAIS16X64_PROFILE_ALLOCATION : LIBSAIS16X64_PROFILE_FREE_SPACE);
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_LEVEL, 0, depth, n, k, flags);
+
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_GATHER, 0, depth, n, k, flags);
         memset(SA, 0, (size_t)n * sizeof(sa_sint_t));
 
         libsais16x64_count_suffixes_32s(T, n, k, buckets); 
         libsais16x64_initialize_buckets_end_32s_1k(k, buckets);
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_GATHER, 1, depth, n, k, flags);
 
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RADIX_SORT, 0, depth, n, k, flags);
         sa_sint_t m = libsais16x64_radix_sort_lms_suffixes_32s_1k(T, SA, n, buckets);
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RADIX_SORT, 1, depth, n, k, flags);
+        if (libsais16x64_cancelled(monitor)) { libsais16x64_free_memory(allocator, buffer); return -5; }
+
         if (m > 1)
         {
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_PARTIAL_SORT, 0, depth, n, k, flags);
             libsais16x64_induce_partial_order_32s_1k_omp(T, SA, n, k, buckets, threads, thread_state);
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_PARTIAL_SORT, 1, depth, n, k, flags);
+            if (libsais16x64_cancelled(monitor)) { libsais16x64_free_memory(allocator, buffer); return -5; }
 
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RENUMBER, 0, depth, n, k, flags);
             sa_sint_t names = libsais16x64_renumber_and_mark_distinct_lms_suffixes_32s_1k_omp(T, SA, n, m, threads);
             if (names < m)
             {
-                if (buffer != NULL) { libsais16x64_free_aligned(buffer); buckets = NULL; }
+                if (buffer != NULL) { libsais16x64_free_memory(allocator, buffer); buckets = NULL; }
 
                 sa_sint_t f = libsais16x64_compact_lms_suffixes_32s_omp(T, SA, n, m, fs, threads, thread_state);
+                libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RENUMBER, 1, depth, m, names, flags);
 
-                if (libsais16x64_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer) != 0)
+                sa_sint_t status = libsais16x64_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer, local_buffer_size, allocator, ctx32, monitor, depth + 1);
+                if (status != 0)
                 {
-                    return -2;
+                    return status;
                 }
 
+                libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RECONSTRUCT, 0, depth, n, k, flags);
                 libsais16x64_reconstruct_compacted_lms_suffixes_32s_1k_omp(T, SA, n, m, fs, f, threads, thread_state);
+                libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RECONSTRUCT, 1, depth, n, k, flags);
 
-                if (buckets == NULL) { buckets = buffer = (sa_sint_t *)libsais16x64_alloc_aligned((size_t)k * sizeof(sa_sint_t), 4096); }
+                if (buckets == NULL) { buckets = buffer = (sa_sint_t *)libsais16x64_alloc_memory(allocator, (size_t)k * sizeof(sa_sint_t), 4096); }
                 if (buckets == NULL) { return -2; }
             }
+            else
+            {
+                libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RENUMBER, 1, depth, m, names, flags);
+            }
             
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_FINAL_SORT, 0, depth, n, k, flags);
             libsais16x64_count_suffixes_32s(T, n, k, buckets);
             libsais16x64_initialize_buckets_end_32s_1k(k, buckets);
             libsais16x64_place_lms_suffixes_interval_32s_1k(T, SA, k, m, buckets);
         }
+        else
+        {
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_FINAL_SORT, 0, depth, n, k, flags);
+        }
 
         libsais16x64_induce_final_order_32s_1k(T, SA, n, k, buckets, threads, thread_state);
-        libsais16x64_free_aligned(buffer);
+        libsais16x64_free_memory(allocator, buffer);
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_FINAL_SORT, 1, depth, n, k, flags);
+        if (libsais16x64_cancelled(monitor)) { return -5; }
 
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_LEVEL, 1, depth, n, k, flags);
         return 0;
     }
 }
 
-static sa_sint_t libsais16x64_main_32s_entry(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+static sa_sint_t libsais16x64_main_32s_entry(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t * RESTRICT local_buffer, sa_sint_t local_buffer_size, const LIBSAIS_ALLOCATOR * allocator, const void * ctx32, LIBSAIS_MONITOR * monitor, sa_sint_t depth)
 {
-    sa_sint_t local_buffer[LIBSAIS_LOCAL_BUFFER_SIZE];
+    sa_sint_t stack_buffer[LIBSAIS_LOCAL_BUFFER_SIZE];
+
+    if (thread_state != NULL) { thread_state[0].state.monitor = monitor; }
 
-    return libsais16x64_main_32s_recursion(T, SA, n, k, fs, threads, thread_state, local_buffer);
+    return libsais16x64_main_32s_recursion(T, SA, n, k, fs, threads, thread_state, local_buffer != NULL ? local_buffer : stack_buffer, local_buffer_size, allocator, ctx32, monitor, depth);
 }
 
-static sa_sint_t libsais16x64_main_16u(const uint16_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t * RESTRICT buckets, sa_sint_t bwt, sa_sint_t r, sa_sint_t * RESTRICT I, sa_sint_t fs, sa_sint_t * freq, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+static void libsais16x64_mark_alphabet_32s(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    fs = fs < (SAINT_MAX - n) ? fs : (SAINT_MAX - n);
-
-    sa_sint_t m = libsais16x64_count_and_gather_lms_suffixes_16u_omp(T, SA, n, buckets, threads, thread_state);
-    sa_sint_t k = libsais16x64_initialize_buckets_start_and_end_16u(buckets, freq);
+    fast_sint_t i; for (i = omp_block_start; i < omp_block_start + omp_block_size; i += 1) { SA[T[i]] = SAINT_MIN; }
+}
 
-    if (m > 0)
-    {
-        sa_sint_t first_lms_suffix    = SA[n - m];
-        sa_sint_t left_suffixes_count = libsais16x64_initialize_buckets_for_lms_suffixes_radix_sort_16u(T, buckets, first_lms_suffix);
-
-        if (threads > 1 && n >= 65536) { memset(SA, 0, ((size_t)n - (size_t)m) * sizeof(sa_sint_t)); }
-        libsais16x64_radix_sort_lms_suffixes_16u_omp(T, SA, n, m, buckets, threads, thread_state);
-        if (threads > 1 && n >= 65536) { memset(&SA[(fast_sint_t)n - (fast_sint_t)m], 0, (size_t)m * sizeof(sa_sint_t)); }
-
-        libsais16x64_initialize_buckets_for_partial_sorting_16u(T, buckets, first_lms_suffix, left_suffixes_count);
-        libsais16x64_induce_partial_order_16u_omp(T, SA, n, k, buckets, first_lms_suffix, left_suffixes_count, threads, thread_state);
-
-        sa_sint_t names = libsais16x64_renumber_and_gather_lms_suffixes_omp(SA, n, m, fs, threads, thread_state);
-        if (names < m)
-        {
-            if (libsais16x64_main_32s_entry(SA + n + fs - m, SA, m, names, fs + n - 2 * m, threads, thread_state) != 0)
-            {
-                return -2;
-            }
+static void libsais16x64_mark_alphabet_32s_omp(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+#else
+        UNUSED(threads);
 
-            libsais16x64_gather_lms_suffixes_16u_omp(T, SA, n, threads, thread_state);
-            libsais16x64_reconstruct_lms_suffixes_omp(SA, n, m, threads);
-        }
+        fast_sint_t omp_block_start   = 0;
+        fast_sint_t omp_block_size    = n;
+#endif
 
-        libsais16x64_place_lms_suffixes_interval_16u(SA, n, m, buckets);
-    }
-    else
-    {
-        memset(SA, 0, (size_t)n * sizeof(sa_sint_t));
+        libsais16x64_mark_alphabet_32s(T, SA, omp_block_start, omp_block_size);
     }
-
-    return libsais16x64_induce_final_order_16u_omp(T, SA, n, k, bwt, r, I, buckets, threads, thread_state);
 }
 
-static sa_sint_t libsais16x64_main(const uint16_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t bwt, sa_sint_t r, sa_sint_t * I, sa_sint_t fs, sa_sint_t * freq, sa_sint_t threads)
+static sa_sint_t libsais16x64_rank_alphabet_32s(sa_sint_t * RESTRICT SA, sa_sint_t k)
 {
-    LIBSAIS_THREAD_STATE *  RESTRICT thread_state   = threads > 1 ? libsais16x64_alloc_thread_state(threads) : NULL;
-    sa_sint_t *             RESTRICT buckets        = (sa_sint_t *)libsais16x64_alloc_aligned((size_t)8 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
-
-    sa_sint_t index = buckets != NULL && (thread_state != NULL || threads == 1)
-        ? libsais16x64_main_16u(T, SA, n, buckets, bwt, r, I, fs, freq, threads, thread_state)
-        : -2;
+    sa_sint_t d = 0;
 
-    libsais16x64_free_aligned(buckets);
-    libsais16x64_free_thread_state(thread_state);
+    fast_sint_t c; for (c = 0; c < (fast_sint_t)k; c += 1) { if (SA[c] < 0) { SA[c] = d++ | SAINT_MIN; } }
 
-    return index;
+    return d;
 }
 
-static sa_sint_t libsais16x64_main_long(sa_sint_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads)
+static void libsais16x64_unrank_alphabet_32s(const sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT alphabet)
 {
-    LIBSAIS_THREAD_STATE * RESTRICT thread_state = threads > 1 ? libsais16x64_alloc_thread_state(threads) : NULL;
-
-    sa_sint_t index = thread_state != NULL || threads == 1
-        ? libsais16x64_main_32s_entry(T, SA, n, k, fs, threads, thread_state)
-        : -2;
-
-    libsais16x64_free_thread_state(thread_state);
-
-    return index;
+    fast_sint_t c; for (c = 0; c < (fast_sint_t)k; c += 1) { if (SA[c] < 0) { alphabet[SA[c] & SAINT_MAX] = (sa_sint_t)c; } }
 }
 
-static void libsais16x64_bwt_copy_16u(uint16_t * RESTRICT U, sa_sint_t * RESTRICT A, sa_sint_t n)
+static void libsais16x64_remap_alphabet_32s(sa_sint_t * RESTRICT T, const sa_sint_t * RESTRICT map, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
-    for (i = 0, j = (fast_sint_t)n - 7; i < j; i += 8)
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
     {
-        libsais16x64_prefetchr(&A[i + prefetch_distance]);
+        libsais16x64_prefetchw(&T[i + 2 * prefetch_distance]);
 
-        U[i + 0] = (uint16_t)A[i + 0];
-        U[i + 1] = (uint16_t)A[i + 1];
-        U[i + 2] = (uint16_t)A[i + 2];
-        U[i + 3] = (uint16_t)A[i + 3];
-        U[i + 4] = (uint16_t)A[i + 4];
-        U[i + 5] = (uint16_t)A[i + 5];
-        U[i + 6] = (uint16_t)A[i + 6];
-        U[i + 7] = (uint16_t)A[i + 7];
+        libsais16x64_prefetchr(&map[T[i + prefetch_distance + 0]]);
+        libsais16x64_prefetchr(&map[T[i + prefetch_distance + 1]]);
+        libsais16x64_prefetchr(&map[T[i + prefetch_distance + 2]]);
+        libsais16x64_prefetchr(&map[T[i + prefetch_distance + 3]]);
+
+        T[i + 0] = map[T[i + 0]] & SAINT_MAX;
+        T[i + 1] = map[T[i + 1]] & SAINT_MAX;
+        T[i + 2] = map[T[i + 2]] & SAINT_MAX;
+        T[i + 3] = map[T[i + 3]] & SAINT_MAX;
     }
 
-    for (j += 7; i < j; i += 1)
+    for (j += prefetch_distance + 3; i < j; i += 1)
     {
-        U[i] = (uint16_t)A[i];
+        T[i] = map[T[i]] & SAINT_MAX;
     }
 }
 
-#if defined(LIBSAIS_OPENMP)
-
-static void libsais16x64_bwt_copy_16u_omp(uint16_t * RESTRICT U, sa_sint_t * RESTRICT A, sa_sint_t n, sa_sint_t threads)
+static void libsais16x64_remap_alphabet_32s_omp(sa_sint_t * RESTRICT T, sa_sint_t n, const sa_sint_t * RESTRICT map, sa_sint_t threads)
 {
 #if defined(LIBSAIS_OPENMP)
     #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
@@ -6616,993 +7429,4205 @@ static void libsais16x64_bwt_copy_16u_omp(uint16_t * RESTRICT U, sa_sint_t * RES
 #if defined(LIBSAIS_OPENMP)
         fast_sint_t omp_thread_num    = omp_get_thread_num();
         fast_sint_t omp_num_threads   = omp_get_num_threads();
-        fast_sint_t omp_block_stride  = ((fast_sint_t)n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
         fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
-        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : (fast_sint_t)n - omp_block_start;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
 #else
         UNUSED(threads);
 
         fast_sint_t omp_block_start   = 0;
-        fast_sint_t omp_block_size    = (fast_sint_t)n;
+        fast_sint_t omp_block_size    = n;
 #endif
 
-        libsais16x64_bwt_copy_16u(U + omp_block_start, A + omp_block_start, (sa_sint_t)omp_block_size);
+        libsais16x64_remap_alphabet_32s(T, map, omp_block_start, omp_block_size);
     }
 }
 
-#endif
-
-int64_t libsais16x64(const uint16_t * T, int64_t * SA, int64_t n, int64_t fs, int64_t * freq)
+static sa_sint_t libsais16x64_main_32s_compact(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t * RESTRICT local_buffer, sa_sint_t local_buffer_size, const LIBSAIS_ALLOCATOR * allocator, const void * ctx32, LIBSAIS_MONITOR * monitor)
 {
-    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
-    {
-        return -1;
-    }
-    else if (n < 2)
-    {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
-        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
-        return 0;
-    }
+    fs = fs < (SAINT_MAX - n) ? fs : (SAINT_MAX - n);
 
-    if (n <= INT32_MAX)
+    if (k > 0 && fs / k < 6)
     {
-        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
-        sa_sint_t index = libsais16(T, (int32_t *)SA, (int32_t)n, (int32_t)new_fs, (int32_t *)freq);
+        sa_sint_t * RESTRICT buffer = k > n + fs ? (sa_sint_t *)libsais16x64_alloc_memory(allocator, (size_t)k * sizeof(sa_sint_t), 4096) : NULL;
+        sa_sint_t * RESTRICT ranks  = k > n + fs ? buffer : SA;
 
-        if (index >= 0)
+        if (ranks != NULL)
         {
-            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)SA, n, 1);
-            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, 1); }
-        }
+            memset(ranks, 0, (size_t)k * sizeof(sa_sint_t));
+            libsais16x64_mark_alphabet_32s_omp(T, ranks, n, threads);
 
-        return index;
+            sa_sint_t d = libsais16x64_rank_alphabet_32s(ranks, k);
+            if (d + d <= k || fs / d > fs / k)
+            {
+                sa_sint_t * RESTRICT alphabet = buffer != NULL ? buffer : (sa_sint_t *)libsais16x64_alloc_memory(allocator, (size_t)d * sizeof(sa_sint_t), 4096);
+                if (alphabet != NULL)
+                {
+                    libsais16x64_remap_alphabet_32s_omp(T, n, ranks, threads);
+                    libsais16x64_unrank_alphabet_32s(ranks, k, alphabet);
+
+                    sa_sint_t index = libsais16x64_main_32s_entry(T, SA, n, d, fs, threads, thread_state, local_buffer, local_buffer_size, allocator, ctx32, monitor, 0);
+                    if (index == 0)
+                    {
+                        libsais16x64_remap_alphabet_32s_omp(T, n, alphabet, threads);
+                    }
+
+                    libsais16x64_free_memory(allocator, alphabet);
+                    return index;
+                }
+            }
+
+            libsais16x64_free_memory(allocator, buffer);
+        }
     }
 
-    return libsais16x64_main(T, SA, n, 0, 0, NULL, fs, freq, 1);
+    return libsais16x64_main_32s_entry(T, SA, n, k, fs, threads, thread_state, local_buffer, local_buffer_size, allocator, ctx32, monitor, 0);
 }
 
-int64_t libsais16x64_long(int64_t * T, int64_t * SA, int64_t n, int64_t k, int64_t fs)
+static void libsais16x64_gsa_rename_separator_lms_suffixes_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n)
 {
-    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
-    {
-        return -1;
-    }
-    else if (n < 2)
+    fast_sint_t i, j;
+    for (i = 1, j = 0; i < (fast_sint_t)n - 1; i += 1)
     {
-        if (n == 1) { SA[0] = 0; }
-        return 0;
+        if (T[i] == 0 && T[i - 1] != 0) { SA[j++] = (sa_sint_t)i | SAINT_MIN; }
     }
-
-    return libsais16x64_main_long(T, SA, n, k, fs, 1);
 }
 
-int64_t libsais16x64_bwt(const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq)
+static void libsais16x64_gsa_split_last_lms_suffix_group_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t m)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0))
-    { 
-        return -1; 
-    }
-    else if (n <= 1) 
-    {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
-        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
-        return n; 
-    }
+    fast_sint_t l = (fast_sint_t)n - 2; while (l >= 0 && T[l] >= T[l + 1]) { l--; }
+    while (l > 0 && T[l - 1] <= T[l]) { l--; }
 
-    if (n <= INT32_MAX)
+    if (l <= 0 || T[l] == 0) { return; }
+
+    fast_sint_t i = 0; while ((SA[i] & SAINT_MAX) != (sa_sint_t)l) { i++; }
+    if (i + 1 >= (fast_sint_t)m) { return; }
+
+    fast_sint_t len = (fast_sint_t)n - 1 - l, p = (fast_sint_t)(SA[i + 1] & SAINT_MAX) + len, t = p;
+    while (t < (fast_sint_t)n - 1 && T[t] == T[t + 1]) { t++; }
+
+    if (T[p - 1] > T[p] && t < (fast_sint_t)n - 1 && T[t] < T[t + 1] && memcmp(&T[SA[i + 1] & SAINT_MAX], &T[l], (size_t)len * sizeof(uint16_t)) == 0)
     {
-        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
-        sa_sint_t index = libsais16_bwt(T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq);
+        fast_sint_t j = i + 1; while (SA[j] > 0) { j++; }
 
-        if (index >= 0)
+        fast_sint_t k = i; SA[i] = (sa_sint_t)l;
+        for (t = i + 1; t <= j; t += 1)
         {
-            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, 1); }
+            sa_sint_t q = SA[t] & SAINT_MAX; SA[t] = q;
+            if (T[q + len] == 0) { SA[t] = SA[k]; SA[k++] = q; }
         }
 
-        return index;
+        for (t = k; SA[t] != (sa_sint_t)l; t += 1) { }
+        SA[t] = SA[k]; SA[k] = (sa_sint_t)l | SAINT_MIN;
+
+        if (k > i) { SA[k - 1] |= SAINT_MIN; }
+        SA[j] |= SAINT_MIN;
     }
+}
 
-    sa_sint_t index = libsais16x64_main(T, A, n, 1, 0, NULL, fs, freq, 1);
-    if (index >= 0) 
-    { 
-        index++;
+static void libsais16x64_gsa_induce_separator_suffixes_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets)
+{
+    sa_sint_t * RESTRICT induction_bucket = &buckets[6 * ALPHABET_SIZE];
 
-        U[0] = T[n - 1];
-        libsais16x64_bwt_copy_16u(U + 1, A, index - 1);
-        libsais16x64_bwt_copy_16u(U + index, A + index, n - index);
+    fast_sint_t i;
+    for (i = 0; i < (fast_sint_t)buckets[7 * ALPHABET_SIZE]; i += 1)
+    {
+        sa_sint_t p = SA[i]; SA[i] = 0; if (p > 0) { p--; SA[induction_bucket[T[p]]++] = p | ((sa_sint_t)(T[p - (p > 0)] < T[p]) << (SAINT_BIT - 1)); }
     }
-
-    return index;
 }
 
-int64_t libsais16x64_bwt_aux(const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t r, int64_t * I)
+static void libsais16x64_gsa_place_separator_suffixes_16u(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL))
-    { 
-        return -1; 
-    }
-    else if (n <= 1) 
+    fast_sint_t i, j;
+    for (i = 0, j = 0; i < (fast_sint_t)n; i += 1)
     {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
-        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
-        I[0] = n;
-        return 0;
+        if (T[i] == 0) { SA[j++] = (sa_sint_t)i; }
     }
+}
 
-    if (n <= INT32_MAX && r <= INT32_MAX)
+static sa_sint_t libsais16x64_main_16u(const uint16_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t * RESTRICT buckets, sa_sint_t bwt, sa_sint_t r, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t fs, sa_sint_t * freq, sa_sint_t gsa, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t * RESTRICT local_buffer, sa_sint_t local_buffer_size, const LIBSAIS_ALLOCATOR * allocator, const void * ctx32, LIBSAIS_MONITOR * monitor)
+{
+    fs = fs < (SAINT_MAX - n) ? fs : (SAINT_MAX - n);
+    threads = libsais16x64_adaptive_threads(monitor, threads, n, ALPHABET_SIZE);
+
+    if (thread_state != NULL) { thread_state[0].state.monitor = monitor; }
+
+    libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_LEVEL, 0, 0, n, ALPHABET_SIZE, LIBSAIS16X64_PROFILE_NONE);
+
+    libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_GATHER, 0, 0, n, ALPHABET_SIZE, LIBSAIS16X64_PROFILE_NONE);
+    sa_sint_t m = libsais16x64_count_and_gather_lms_suffixes_16u_omp(T, SA, n, buckets, threads, thread_state);
+    sa_sint_t k = libsais16x64_initialize_buckets_start_and_end_16u(buckets, freq);
+    libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_GATHER, 1, 0, n, ALPHABET_SIZE, LIBSAIS16X64_PROFILE_NONE);
+
+    if (m > 0)
     {
-        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
-        sa_sint_t index = libsais16_bwt_aux(T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)r, (int32_t *)I);
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RADIX_SORT, 0, 0, n, ALPHABET_SIZE, LIBSAIS16X64_PROFILE_NONE);
+        sa_sint_t first_lms_suffix    = SA[n - m];
+        sa_sint_t left_suffixes_count = libsais16x64_initialize_buckets_for_lms_suffixes_radix_sort_16u(T, buckets, first_lms_suffix);
 
-        if (index >= 0)
+        if (threads > 1 && n >= 65536) { memset(SA, 0, ((size_t)n - (size_t)m) * sizeof(sa_sint_t)); }
+        libsais16x64_radix_sort_lms_suffixes_16u_omp(T, SA, n, m, buckets, libsais16x64_adaptive_threads(monitor, threads, m, ALPHABET_SIZE) == threads ? threads : 1, thread_state);
+        if (threads > 1 && n >= 65536) { memset(&SA[(fast_sint_t)n - (fast_sint_t)m], 0, (size_t)m * sizeof(sa_sint_t)); }
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RADIX_SORT, 1, 0, n, ALPHABET_SIZE, LIBSAIS16X64_PROFILE_NONE);
+        if (libsais16x64_cancelled(monitor)) { return -5; }
+
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_PARTIAL_SORT, 0, 0, n, ALPHABET_SIZE, LIBSAIS16X64_PROFILE_NONE);
+        libsais16x64_initialize_buckets_for_partial_sorting_16u(T, buckets, first_lms_suffix, left_suffixes_count);
+        libsais16x64_induce_partial_order_16u_omp(T, SA, n, k, buckets, first_lms_suffix, left_suffixes_count, threads, thread_state);
+        if (libsais16x64_cancelled(monitor)) { return -5; }
+        if (gsa) { libsais16x64_gsa_rename_separator_lms_suffixes_16u(T, SA, n); libsais16x64_gsa_split_last_lms_suffix_group_16u(T, SA, n, m); }
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_PARTIAL_SORT, 1, 0, n, ALPHABET_SIZE, LIBSAIS16X64_PROFILE_NONE);
+
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RENUMBER, 0, 0, n, ALPHABET_SIZE, LIBSAIS16X64_PROFILE_NONE);
+        sa_sint_t names = libsais16x64_renumber_and_gather_lms_suffixes_omp(SA, n, m, fs, threads, thread_state);
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RENUMBER, 1, 0, m, names, LIBSAIS16X64_PROFILE_NONE);
+
+        if (names < m)
         {
-            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)I, 1 + ((n - 1) / r), 1);
-            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, 1); }
+            sa_sint_t status = libsais16x64_main_32s_entry(SA + n + fs - m, SA, m, names, fs + n - 2 * m, threads, thread_state, local_buffer, local_buffer_size, allocator, ctx32, monitor, 1);
+            if (status != 0)
+            {
+                return status;
+            }
+
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RECONSTRUCT, 0, 0, n, ALPHABET_SIZE, LIBSAIS16X64_PROFILE_NONE);
+            libsais16x64_gather_lms_suffixes_16u_omp(T, SA, n, threads, thread_state);
+            libsais16x64_reconstruct_lms_suffixes_omp(SA, n, m, threads);
+            libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_RECONSTRUCT, 1, 0, n, ALPHABET_SIZE, LIBSAIS16X64_PROFILE_NONE);
         }
 
-        return index;
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_FINAL_SORT, 0, 0, n, ALPHABET_SIZE, LIBSAIS16X64_PROFILE_NONE);
+        libsais16x64_place_lms_suffixes_interval_16u(SA, n, m, buckets);
     }
-
-    if (libsais16x64_main(T, A, n, 1, r, I, fs, freq, 1) != 0)
+    else
     {
-        return -2;
+        libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_FINAL_SORT, 0, 0, n, ALPHABET_SIZE, LIBSAIS16X64_PROFILE_NONE);
+        memset(SA, 0, (size_t)n * sizeof(sa_sint_t));
     }
 
-    U[0] = T[n - 1];
-    libsais16x64_bwt_copy_16u(U + 1, A, I[0] - 1);
-    libsais16x64_bwt_copy_16u(U + I[0], A + I[0], n - I[0]);
+    if (gsa) { libsais16x64_gsa_induce_separator_suffixes_16u(T, SA, buckets); }
 
-    return 0;
-}
+    sa_sint_t index = libsais16x64_induce_final_order_16u_omp(T, SA, n, k, bwt, r, I, S, buckets, threads, thread_state);
+    libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_FINAL_SORT, 1, 0, n, ALPHABET_SIZE, LIBSAIS16X64_PROFILE_NONE);
+    if (libsais16x64_cancelled(monitor)) { return -5; }
 
-#if defined(LIBSAIS_OPENMP)
+    libsais16x64_profile(monitor, LIBSAIS16X64_PHASE_LEVEL, 1, 0, n, ALPHABET_SIZE, LIBSAIS16X64_PROFILE_NONE);
+    return index;
+}
 
-int64_t libsais16x64_omp(const uint16_t * T, int64_t * SA, int64_t n, int64_t fs, int64_t * freq, int64_t threads)
+static sa_sint_t libsais16x64_main_gsa_16u(const uint16_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t * RESTRICT buckets, sa_sint_t fs, sa_sint_t * freq, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t * RESTRICT local_buffer, sa_sint_t local_buffer_size, const LIBSAIS_ALLOCATOR * allocator, const void * ctx32, LIBSAIS_MONITOR * monitor)
 {
-    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0) || (threads < 0))
-    {
-        return -1;
-    }
-    else if (n < 2)
-    {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
-        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
-        return 0;
-    }
-
-    threads = threads > 0 ? threads : omp_get_max_threads();
+    sa_sint_t q = n - 1; while (q > 0 && T[q - 1] == 0) { q--; }
 
-    if (n <= INT32_MAX)
+    if (q > 0)
     {
-        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
-        sa_sint_t index = libsais16_omp(T, (int32_t *)SA, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)threads);
-
-        if (index >= 0)
+        sa_sint_t status = libsais16x64_main_16u(T, SA + (n - 1 - q), q + 1, buckets, 0, 0, NULL, NULL, fs, freq, 1, threads, thread_state, local_buffer, local_buffer_size, allocator, ctx32, monitor);
+        if (status != 0)
         {
-            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)SA, n, threads);
-            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, threads); }
+            return status;
         }
 
-        return index;
+        if (freq != NULL) { freq[0] += n - 1 - q; }
+    }
+    else if (freq != NULL)
+    {
+        memset(freq, 0, ALPHABET_SIZE * sizeof(sa_sint_t)); freq[0] = n;
     }
 
-    return libsais16x64_main(T, SA, n, 0, 0, NULL, fs, freq, threads);
+    libsais16x64_gsa_place_separator_suffixes_16u(T, SA, n);
+
+    return 0;
 }
 
-int64_t libsais16x64_long_omp(int64_t * T, int64_t * SA, int64_t n, int64_t k, int64_t fs, int64_t threads)
+static sa_sint_t libsais16x64_main(const uint16_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t bwt, sa_sint_t r, sa_sint_t * I, sa_sint_t * S, sa_sint_t fs, sa_sint_t * freq, sa_sint_t threads)
 {
-    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0) || (threads < 0))
-    {
-        return -1;
-    }
-    else if (n < 2)
-    {
-        if (n == 1) { SA[0] = 0; }
-        return 0;
-    }
+    LIBSAIS_THREAD_STATE *  RESTRICT thread_state   = threads > 1 ? libsais16x64_alloc_thread_state(threads, NULL) : NULL;
+    sa_sint_t *             RESTRICT buckets        = (sa_sint_t *)libsais16x64_alloc_aligned((size_t)8 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
 
-    threads = threads > 0 ? threads : omp_get_max_threads();
+    sa_sint_t index = buckets != NULL && (thread_state != NULL || threads == 1)
+        ? libsais16x64_main_16u(T, SA, n, buckets, bwt, r, I, S, fs, freq, 0, threads, thread_state, NULL, LIBSAIS_LOCAL_BUFFER_SIZE, NULL, NULL, NULL)
+        : -2;
 
-    return libsais16x64_main_long(T, SA, n, k, fs, threads);
+    libsais16x64_free_aligned(buckets);
+    libsais16x64_free_thread_state(thread_state, NULL);
+
+    return index;
 }
 
-int64_t libsais16x64_bwt_omp(const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t threads)
+static sa_sint_t libsais16x64_main_gsa(const uint16_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t fs, sa_sint_t * freq, sa_sint_t threads)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (threads < 0))
-    {
-        return -1;
-    }
-    else if (n <= 1)
-    {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
-        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
-        return n;
-    }
+    LIBSAIS_THREAD_STATE *  RESTRICT thread_state   = threads > 1 ? libsais16x64_alloc_thread_state(threads, NULL) : NULL;
+    sa_sint_t *             RESTRICT buckets        = (sa_sint_t *)libsais16x64_alloc_aligned((size_t)8 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
 
-    threads = threads > 0 ? threads : omp_get_max_threads();
+    sa_sint_t index = buckets != NULL && (thread_state != NULL || threads == 1)
+        ? libsais16x64_main_gsa_16u(T, SA, n, buckets, fs, freq, threads, thread_state, NULL, LIBSAIS_LOCAL_BUFFER_SIZE, NULL, NULL, NULL)
+        : -2;
 
-    if (n <= INT32_MAX)
-    {
-        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
-        sa_sint_t index = libsais16_bwt_omp(T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)threads);
+    libsais16x64_free_aligned(buckets);
+    libsais16x64_free_thread_state(thread_state, NULL);
 
-        if (index >= 0)
-        {
-            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, threads); }
-        }
+    return index;
+}
 
-        return index;
-    }
+static sa_sint_t libsais16x64_main_long(sa_sint_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads)
+{
+    LIBSAIS_THREAD_STATE * RESTRICT thread_state = threads > 1 ? libsais16x64_alloc_thread_state(threads, NULL) : NULL;
 
-    sa_sint_t index = libsais16x64_main(T, A, n, 1, 0, NULL, fs, freq, threads);
-    if (index >= 0)
-    {
-        index++;
+    sa_sint_t index = thread_state != NULL || threads == 1
+        ? libsais16x64_main_32s_compact(T, SA, n, k, fs, threads, thread_state, NULL, LIBSAIS_LOCAL_BUFFER_SIZE, NULL, NULL, NULL)
+        : -2;
 
-        U[0] = T[n - 1];
-        libsais16x64_bwt_copy_16u_omp(U + 1, A, index - 1, threads);
-        libsais16x64_bwt_copy_16u_omp(U + index, A + index, n - index, threads);
-    }
+    libsais16x64_free_thread_state(thread_state, NULL);
 
     return index;
 }
 
-int64_t libsais16x64_bwt_aux_omp(const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t r, int64_t * I, int64_t threads)
+static sa_sint_t libsais16x64_main_ctx(const LIBSAIS_CONTEXT * ctx, const uint16_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t bwt, sa_sint_t r, sa_sint_t * I, sa_sint_t * S, sa_sint_t fs, sa_sint_t * freq)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL) || (threads < 0))
+    if (ctx != NULL && (ctx->buckets != NULL && (ctx->thread_state != NULL || ctx->threads == 1)))
     {
-        return -1;
+        libsais16x64_numa_place_omp(ctx, SA, n, fs);
+
+        LIBSAIS_MONITOR monitor = ctx->monitor;
+        if (ctx->numa != LIBSAIS16X64_NUMA_NONE) { monitor.thread_block_size = 0; }
+        return libsais16x64_ctx_status(ctx, libsais16x64_main_16u(T, SA, n, ctx->buckets, bwt, r, I, S, fs, freq, 0, (sa_sint_t)ctx->threads, ctx->thread_state, ctx->local_buffer, (sa_sint_t)ctx->local_buffer_size, &ctx->allocator, ctx->ctx32, &monitor));
     }
-    else if (n <= 1)
+
+    return -2;
+}
+
+static sa_sint_t libsais16x64_main_gsa_ctx(const LIBSAIS_CONTEXT * ctx, const uint16_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t fs, sa_sint_t * freq)
+{
+    if (ctx != NULL && (ctx->buckets != NULL && (ctx->thread_state != NULL || ctx->threads == 1)))
     {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
-        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
-        I[0] = n;
-        return 0;
+        libsais16x64_numa_place_omp(ctx, SA, n, fs);
+
+        LIBSAIS_MONITOR monitor = ctx->monitor;
+        if (ctx->numa != LIBSAIS16X64_NUMA_NONE) { monitor.thread_block_size = 0; }
+        return libsais16x64_ctx_status(ctx, libsais16x64_main_gsa_16u(T, SA, n, ctx->buckets, fs, freq, (sa_sint_t)ctx->threads, ctx->thread_state, ctx->local_buffer, (sa_sint_t)ctx->local_buffer_size, &ctx->allocator, ctx->ctx32, &monitor));
     }
 
-    threads = threads > 0 ? threads : omp_get_max_threads();
+    return -2;
+}
 
-    if (n <= INT32_MAX && r <= INT32_MAX)
+static sa_sint_t libsais16x64_main_long_ctx(const LIBSAIS_CONTEXT * ctx, sa_sint_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs)
+{
+    if (ctx != NULL && (ctx->thread_state != NULL || ctx->threads == 1))
     {
-        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
-        sa_sint_t index = libsais16_bwt_aux_omp(T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)r, (int32_t *)I, (int32_t)threads);
+        libsais16x64_numa_place_omp(ctx, SA, n, fs);
 
-        if (index >= 0)
-        {
-            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)I, 1 + ((n - 1) / r), threads);
-            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, threads); }
-        }
+        LIBSAIS_MONITOR monitor = ctx->monitor;
+        if (ctx->numa != LIBSAIS16X64_NUMA_NONE) { monitor.thread_block_size = 0; }
+        return libsais16x64_ctx_status(ctx, libsais16x64_main_32s_compact(T, SA, n, k, fs, (sa_sint_t)ctx->threads, ctx->thread_state, ctx->local_buffer, (sa_sint_t)ctx->local_buffer_size, &ctx->allocator, ctx->ctx32, &monitor));
+    }
 
-        return index;
+    return -2;
+}
+
+static void libsais16x64_bwt_copy_16u(uint16_t * RESTRICT U, sa_sint_t * RESTRICT A, sa_sint_t n)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = 0, j = (fast_sint_t)n - 7; i < j; i += 8)
+    {
+        libsais16x64_prefetchr(&A[i + prefetch_distance]);
+
+        U[i + 0] = (uint16_t)A[i + 0];
+        U[i + 1] = (uint16_t)A[i + 1];
+        U[i + 2] = (uint16_t)A[i + 2];
+        U[i + 3] = (uint16_t)A[i + 3];
+        U[i + 4] = (uint16_t)A[i + 4];
+        U[i + 5] = (uint16_t)A[i + 5];
+        U[i + 6] = (uint16_t)A[i + 6];
+        U[i + 7] = (uint16_t)A[i + 7];
     }
 
-    if (libsais16x64_main(T, A, n, 1, r, I, fs, freq, threads) != 0)
+    for (j += 7; i < j; i += 1)
     {
-        return -2;
+        U[i] = (uint16_t)A[i];
     }
+}
 
-    U[0] = T[n - 1];
-    libsais16x64_bwt_copy_16u_omp(U + 1, A, I[0] - 1, threads);
-    libsais16x64_bwt_copy_16u_omp(U + I[0], A + I[0], n - I[0], threads);
+static fast_sint_t libsais16x64_rlbwt_gather_range_16u(const sa_sint_t * RESTRICT A, uint16_t * RESTRICT C, sa_sint_t * RESTRICT L, fast_sint_t c, fast_sint_t count, fast_sint_t rs, fast_sint_t offset, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
-    return 0;
-}
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size; i < j; i += 1)
+    {
+        libsais16x64_prefetchr(&A[i + prefetch_distance]);
 
-#endif
+        fast_sint_t s = (uint16_t)A[i];
+        if (s != c) { if (count < rs) { C[count] = (uint16_t)s; L[count] = (sa_sint_t)(i + offset); } count++; c = s; }
+    }
 
-static void libsais16x64_unbwt_compute_histogram(const uint16_t * RESTRICT T, fast_sint_t n, sa_uint_t * RESTRICT count)
-{
-    fast_sint_t i; for (i = 0; i < n; i += 1) { count[T[i]]++; }
+    return count;
 }
 
-static void libsais16x64_unbwt_calculate_fastbits(sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift)
+static fast_sint_t libsais16x64_rlbwt_gather_runs_16u(const sa_sint_t * RESTRICT A, uint16_t * RESTRICT C, sa_sint_t * RESTRICT L, fast_sint_t index, fast_sint_t count, fast_sint_t rs, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    fast_uint_t v, w, sum;
-    for (v = 0, sum = 1, w = 0; w < ALPHABET_SIZE; ++w)
+    fast_sint_t p = index - 1, i = omp_block_start, j = omp_block_start + omp_block_size, c = -1;
+
+    if (i > 0) { c = (uint16_t)A[i - 1 == 0 ? p : i - 1 <= p ? i - 2 : i - 1]; }
+
+    if (i == 0 && i < j)
     {
-        fast_uint_t prev = sum; sum += bucket2[w]; bucket2[w] = (sa_uint_t)prev;
-        if (prev != sum)
-        {
-            for (; v <= ((sum - 1) >> shift); ++v) { fastbits[v] = (uint16_t)w; }
-        }
+        c = (uint16_t)A[p]; if (count < rs) { C[count] = (uint16_t)c; L[count] = 0; } count++; i = 1;
     }
-}
 
-static void libsais16x64_unbwt_calculate_P(const uint16_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, fast_uint_t index, fast_sint_t omp_block_start, fast_sint_t omp_block_end)
-{
+    if (i <= p && i < j)
     {
-        fast_sint_t i = omp_block_start, j = (fast_sint_t)index; if (omp_block_end < j) { j = omp_block_end; }
-        for (; i < j; ++i) { fast_uint_t c = T[i]; P[bucket2[c]++] = (sa_uint_t)i; }
+        fast_sint_t e = j < p + 1 ? j : p + 1;
+        count = libsais16x64_rlbwt_gather_range_16u(A, C, L, c, count, rs, 1, i - 1, e - i);
+        c = (uint16_t)A[e - 2]; i = e;
     }
 
+    if (i < j)
     {
-        fast_sint_t i = (fast_sint_t)index, j = omp_block_end; if (omp_block_start > i) { i = omp_block_start; }
-        for (T -= 1, i += 1; i <= j; ++i) { fast_uint_t c = T[i]; P[bucket2[c]++] = (sa_uint_t)i; }
+        count = libsais16x64_rlbwt_gather_range_16u(A, C, L, c, count, rs, 0, i, j - i);
     }
+
+    return count;
 }
 
-static void libsais16x64_unbwt_init_single(const uint16_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits)
+static void libsais16x64_rlbwt_convert_runs(sa_sint_t * RESTRICT L, fast_sint_t next, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    fast_uint_t index = I[0];
-    fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
-
-    if (freq != NULL)
-    {
-        memcpy(bucket2, freq, ALPHABET_SIZE * sizeof(sa_uint_t));
-    }
-    else
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - 1; i < j; i += 1)
     {
-        memset(bucket2, 0, ALPHABET_SIZE * sizeof(sa_uint_t));
-        libsais16x64_unbwt_compute_histogram(T, n, bucket2);
+        L[i] = L[i + 1] - L[i];
     }
 
-    libsais16x64_unbwt_calculate_fastbits(bucket2, fastbits, shift);
-    libsais16x64_unbwt_calculate_P(T, P, bucket2, index, 0, n);
+    if (omp_block_size > 0) { L[j] = (sa_sint_t)next - L[j]; }
 }
 
-#if defined(LIBSAIS_OPENMP)
-
-static void libsais16x64_unbwt_init_parallel(const uint16_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, sa_uint_t * RESTRICT buckets, sa_sint_t threads)
+static sa_sint_t libsais16x64_rlbwt_encode_16u_omp(const sa_sint_t * RESTRICT A, uint16_t * RESTRICT C, sa_sint_t * RESTRICT L, sa_sint_t n, sa_sint_t index, sa_sint_t rs, sa_sint_t threads)
 {
-    fast_uint_t index = I[0];
-    fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+    fast_sint_t count = 0;
+
+#if defined(LIBSAIS_OPENMP)
+    fast_sint_t * RESTRICT counts = threads > 1 && n >= 65536 ? (fast_sint_t *)libsais16x64_alloc_aligned((size_t)threads * sizeof(fast_sint_t), 64) : NULL;
+    if (threads > 1 && n >= 65536 && counts == NULL) { return -2; }
 
     #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
     {
-        fast_sint_t omp_thread_num  = omp_get_thread_num();
-        fast_sint_t omp_num_threads = omp_get_num_threads();
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
 
         if (omp_num_threads == 1)
         {
-            libsais16x64_unbwt_init_single(T, P, n, freq, I, bucket2, fastbits);
+            count = libsais16x64_rlbwt_gather_runs_16u(A, C, L, index, 0, rs, omp_block_start, omp_block_size);
+            if (count <= rs) { libsais16x64_rlbwt_convert_runs(L, n, 0, count); }
         }
+#if defined(LIBSAIS_OPENMP)
         else
         {
-            {
-                sa_uint_t * RESTRICT bucket2_local  = buckets + omp_thread_num * ALPHABET_SIZE;
-                fast_sint_t omp_block_stride        = (n / omp_num_threads) & (-16);
-                fast_sint_t omp_block_start         = omp_thread_num * omp_block_stride;
-                fast_sint_t omp_block_size          = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
-
-                memset(bucket2_local, 0, ALPHABET_SIZE * sizeof(sa_uint_t));
-                libsais16x64_unbwt_compute_histogram(T + omp_block_start, omp_block_size, bucket2_local);
-            }
+            counts[omp_thread_num] = libsais16x64_rlbwt_gather_runs_16u(A, C, L, index, 0, 0, omp_block_start, omp_block_size);
 
             #pragma omp barrier
 
+            fast_sint_t t, c = 0, total = 0; for (t = 0; t < omp_num_threads; ++t) { c += t < omp_thread_num ? counts[t] : 0; total += counts[t]; }
+
+            if (total <= rs)
             {
-                sa_uint_t * RESTRICT bucket2_temp   = buckets;
-                fast_sint_t omp_block_stride        = (ALPHABET_SIZE / omp_num_threads) & (-16);
-                fast_sint_t omp_block_start         = omp_thread_num * omp_block_stride;
-                fast_sint_t omp_block_size          = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : ALPHABET_SIZE - omp_block_start;
+                libsais16x64_rlbwt_gather_runs_16u(A, C, L, index, c, rs, omp_block_start, omp_block_size);
 
-                memset(bucket2 + omp_block_start, 0, (size_t)omp_block_size * sizeof(sa_uint_t));
+                #pragma omp barrier
 
-                fast_sint_t t;
-                for (t = 0; t < omp_num_threads; ++t, bucket2_temp += ALPHABET_SIZE)
-                {
-                    fast_sint_t c; for (c = omp_block_start; c < omp_block_start + omp_block_size; c += 1) { sa_uint_t A = bucket2[c], B = bucket2_temp[c]; bucket2[c] = A + B; bucket2_temp[c] = A; }
-                }
-            }
+                fast_sint_t next = c + counts[omp_thread_num] < total ? L[c + counts[omp_thread_num]] : n;
 
-            #pragma omp barrier
+                #pragma omp barrier
 
-            #pragma omp master
-            {
-                libsais16x64_unbwt_calculate_fastbits(bucket2, fastbits, shift);
+                libsais16x64_rlbwt_convert_runs(L, next, c, counts[omp_thread_num]);
             }
 
-            #pragma omp barrier
+            if (omp_thread_num == omp_num_threads - 1) { count = total; }
+        }
+#endif
+    }
 
-            {
-                sa_uint_t * RESTRICT bucket2_local  = buckets + omp_thread_num * ALPHABET_SIZE;
-                fast_sint_t omp_block_stride        = (n / omp_num_threads) & (-16);
-                fast_sint_t omp_block_start         = omp_thread_num * omp_block_stride;
-                fast_sint_t omp_block_size          = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+#if defined(LIBSAIS_OPENMP)
+    libsais16x64_free_aligned(counts);
+#endif
 
-                fast_sint_t c; for (c = 0; c < ALPHABET_SIZE; c += 1) { sa_uint_t A = bucket2[c], B = bucket2_local[c]; bucket2_local[c] = A + B; }
+    return (sa_sint_t)count;
+}
 
-                libsais16x64_unbwt_calculate_P(T, P, bucket2_local, index, omp_block_start, omp_block_start + omp_block_size);
-            }
 
-            #pragma omp barrier
+#if defined(LIBSAIS_OPENMP)
 
-            #pragma omp master
-            {
-                memcpy(bucket2, buckets + (omp_num_threads - 1) * ALPHABET_SIZE, ALPHABET_SIZE * sizeof(sa_uint_t));
-            }
-        }
+static void libsais16x64_bwt_copy_16u_omp(uint16_t * RESTRICT U, sa_sint_t * RESTRICT A, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+        fast_sint_t omp_block_stride  = ((fast_sint_t)n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : (fast_sint_t)n - omp_block_start;
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_block_start   = 0;
+        fast_sint_t omp_block_size    = (fast_sint_t)n;
+#endif
+
+        libsais16x64_bwt_copy_16u(U + omp_block_start, A + omp_block_start, (sa_sint_t)omp_block_size);
     }
 }
 
 #endif
 
-static void libsais16x64_unbwt_decode_1(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t * i0, fast_uint_t k)
+void * libsais16x64_create_ctx(void)
 {
-    uint16_t * RESTRICT U0 = U;
+    return (void *)libsais16x64_create_ctx_main(1, NULL);
+}
 
-    fast_uint_t i, p0 = *i0;
+void * libsais16x64_create_ctx_alloc(void * (* alloc_fn)(size_t size, size_t alignment, void * opaque), void (* free_fn)(void * address, void * opaque), void * opaque)
+{
+    if ((alloc_fn == NULL) || (free_fn == NULL)) { return NULL; }
 
-    for (i = 0; i != k; ++i)
-    {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
-    }
+    LIBSAIS_ALLOCATOR allocator = { alloc_fn, free_fn, opaque };
+    return (void *)libsais16x64_create_ctx_main(1, &allocator);
+}
 
-    *i0 = p0;
+void * libsais16x64_create_ctx_buffer(void * buffer, size_t size)
+{
+    return (void *)libsais16x64_create_ctx_buffer_main(1, buffer, size);
 }
 
-static void libsais16x64_unbwt_decode_2(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t k)
+void libsais16x64_free_ctx(void * ctx)
 {
-    uint16_t * RESTRICT U0 = U;
-    uint16_t * RESTRICT U1 = U0 + r;
+    libsais16x64_free_ctx_main((LIBSAIS_CONTEXT *)ctx);
+}
 
-    fast_uint_t i, p0 = *i0, p1 = *i1;
+int64_t libsais16x64_alloc_size(int64_t n, int64_t k, int64_t threads)
+{
+    if ((n < 0) || (k < 0) || (threads < 0))
+    {
+        return -1;
+    }
 
-    for (i = 0; i != k; ++i)
+#if defined(LIBSAIS_OPENMP)
+    threads = threads > 0 ? threads : omp_get_max_threads();
+#else
+    threads = 1;
+#endif
+
+    return libsais16x64_alloc_size_main(n, k, threads);
+}
+
+int64_t libsais16x64_scratch_size(int64_t n, int64_t k, int64_t fs, int64_t threads, int64_t flags)
+{
+    if ((n < 0) || (k < 0) || (fs < 0) || (threads < 0) || (flags < LIBSAIS16X64_FLAGS_NONE) || (flags > LIBSAIS16X64_FLAGS_BUFFER))
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
+        return -1;
     }
 
-    *i0 = p0; *i1 = p1;
+#if defined(LIBSAIS_OPENMP)
+    threads = threads > 0 ? threads : omp_get_max_threads();
+#else
+    threads = 1;
+#endif
+
+    return libsais16x64_scratch_size_main(n, k, fs, threads, flags);
 }
 
-static void libsais16x64_unbwt_decode_3(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t k)
+int32_t libsais16x64_set_profiler(void * ctx, void (* profile_fn)(int32_t phase, int32_t end, int32_t depth, int64_t n, int64_t k, int32_t flags, void * opaque), void * opaque)
 {
-    uint16_t * RESTRICT U0 = U;
-    uint16_t * RESTRICT U1 = U0 + r;
-    uint16_t * RESTRICT U2 = U1 + r;
+    if (ctx == NULL)
+    {
+        return -1;
+    }
 
-    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2;
+    LIBSAIS_CONTEXT * RESTRICT context = (LIBSAIS_CONTEXT *)ctx;
 
-    for (i = 0; i != k; ++i)
+    if (libsais16_set_profiler(context->ctx32, profile_fn, opaque) != 0)
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
-        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = c2;
+        return -1;
     }
 
-    *i0 = p0; *i1 = p1; *i2 = p2;
-}
+    context->monitor.profile        = profile_fn;
+    context->monitor.profile_opaque = opaque;
 
-static void libsais16x64_unbwt_decode_4(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t k)
+    return 0;
+}
+
+int32_t libsais16x64_set_cancel(void * ctx, int32_t (* cancel_fn)(void * opaque), void * opaque)
 {
-    uint16_t * RESTRICT U0 = U;
-    uint16_t * RESTRICT U1 = U0 + r;
-    uint16_t * RESTRICT U2 = U1 + r;
-    uint16_t * RESTRICT U3 = U2 + r;
+    if (ctx == NULL)
+    {
+        return -1;
+    }
 
-    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3;
+    LIBSAIS_CONTEXT * RESTRICT context = (LIBSAIS_CONTEXT *)ctx;
 
-    for (i = 0; i != k; ++i)
+    if (libsais16_set_cancel(context->ctx32, cancel_fn, opaque) != 0)
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
-        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = c2;
-        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = c3;
+        return -1;
     }
 
-    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3;
+    context->monitor.cancel         = cancel_fn;
+    context->monitor.cancel_opaque  = opaque;
+
+    return 0;
 }
 
-static void libsais16x64_unbwt_decode_5(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t k)
+int32_t libsais16x64_set_numa(void * ctx, int32_t mode)
 {
-    uint16_t * RESTRICT U0 = U;
-    uint16_t * RESTRICT U1 = U0 + r;
-    uint16_t * RESTRICT U2 = U1 + r;
-    uint16_t * RESTRICT U3 = U2 + r;
-    uint16_t * RESTRICT U4 = U3 + r;
+    if ((ctx == NULL) || (mode < LIBSAIS16X64_NUMA_NONE) || (mode > LIBSAIS16X64_NUMA_INTERLEAVE))
+    {
+        return -1;
+    }
 
-    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4;
+    LIBSAIS_CONTEXT * RESTRICT context = (LIBSAIS_CONTEXT *)ctx;
 
-    for (i = 0; i != k; ++i)
+    if (libsais16_set_numa(context->ctx32, mode) != 0)
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
-        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = c2;
-        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = c3;
-        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = c4;
+        return -1;
     }
 
-    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4;
+    context->numa = mode;
+    if (mode != LIBSAIS16X64_NUMA_NONE) { libsais16x64_numa_place_thread_state(context->thread_state, context->threads); }
+
+    return 0;
 }
 
-static void libsais16x64_unbwt_decode_6(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t * i5, fast_uint_t k)
+int32_t libsais16x64_set_cache_size(void * ctx, int64_t size)
 {
-    uint16_t * RESTRICT U0 = U;
-    uint16_t * RESTRICT U1 = U0 + r;
-    uint16_t * RESTRICT U2 = U1 + r;
-    uint16_t * RESTRICT U3 = U2 + r;
-    uint16_t * RESTRICT U4 = U3 + r;
-    uint16_t * RESTRICT U5 = U4 + r;
+    LIBSAIS_CONTEXT * RESTRICT context = (LIBSAIS_CONTEXT *)ctx;
 
-    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4, p5 = *i5;
+    if ((context == NULL) || (size < 1024) || (size > INT32_MAX) || ((fast_sint_t)size <= 32 * context->threads))
+    {
+        return -1;
+    }
 
-    for (i = 0; i != k; ++i)
+    sa_sint_t status = libsais16_set_cache_size(context->ctx32, (int32_t)size);
+    if (status != 0)
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
-        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = c2;
-        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = c3;
-        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = c4;
-        uint16_t c5 = fastbits[p5 >> shift]; if (bucket2[c5] <= p5) { do { c5++; } while (bucket2[c5] <= p5); } p5 = P[p5]; U5[i] = c5;
+        return libsais16x64_ctx_status(context, status);
     }
 
-    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4; *i5 = p5;
-}
+    if (context->thread_state != NULL)
+    {
+        LIBSAIS_THREAD_CACHE * RESTRICT cache = (LIBSAIS_THREAD_CACHE *)libsais16x64_alloc_memory(&context->allocator, (size_t)context->threads * (size_t)size * sizeof(LIBSAIS_THREAD_CACHE), 4096);
+        if (cache == NULL)
+        {
+            return libsais16x64_ctx_status(context, -2);
+        }
 
-static void libsais16x64_unbwt_decode_7(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t * i5, fast_uint_t * i6, fast_uint_t k)
-{
-    uint16_t * RESTRICT U0 = U;
-    uint16_t * RESTRICT U1 = U0 + r;
-    uint16_t * RESTRICT U2 = U1 + r;
-    uint16_t * RESTRICT U3 = U2 + r;
-    uint16_t * RESTRICT U4 = U3 + r;
-    uint16_t * RESTRICT U5 = U4 + r;
-    uint16_t * RESTRICT U6 = U5 + r;
+        libsais16x64_free_memory(&context->allocator, context->thread_state[0].state.cache);
 
-    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4, p5 = *i5, p6 = *i6;
+        fast_sint_t t;
+        for (t = 0; t < context->threads; ++t)
+        {
+            context->thread_state[t].state.cache      = cache + t * (fast_sint_t)size;
+            context->thread_state[t].state.cache_size = (fast_sint_t)size;
+        }
 
-    for (i = 0; i != k; ++i)
-    {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
-        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = c2;
-        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = c3;
-        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = c4;
-        uint16_t c5 = fastbits[p5 >> shift]; if (bucket2[c5] <= p5) { do { c5++; } while (bucket2[c5] <= p5); } p5 = P[p5]; U5[i] = c5;
-        uint16_t c6 = fastbits[p6 >> shift]; if (bucket2[c6] <= p6) { do { c6++; } while (bucket2[c6] <= p6); } p6 = P[p6]; U6[i] = c6;
+        if (context->numa != LIBSAIS16X64_NUMA_NONE) { libsais16x64_numa_place_thread_state(context->thread_state, context->threads); }
     }
 
-    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4; *i5 = p5; *i6 = p6;
+    return 0;
 }
 
-static void libsais16x64_unbwt_decode_8(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t * i5, fast_uint_t * i6, fast_uint_t * i7, fast_uint_t k)
+int32_t libsais16x64_set_local_buffer_size(void * ctx, int64_t size)
 {
-    uint16_t * RESTRICT U0 = U;
-    uint16_t * RESTRICT U1 = U0 + r;
-    uint16_t * RESTRICT U2 = U1 + r;
-    uint16_t * RESTRICT U3 = U2 + r;
-    uint16_t * RESTRICT U4 = U3 + r;
-    uint16_t * RESTRICT U5 = U4 + r;
-    uint16_t * RESTRICT U6 = U5 + r;
-    uint16_t * RESTRICT U7 = U6 + r;
+    LIBSAIS_CONTEXT * RESTRICT context = (LIBSAIS_CONTEXT *)ctx;
 
-    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4, p5 = *i5, p6 = *i6, p7 = *i7;
+    if ((context == NULL) || (size < 0) || (size > INT32_MAX))
+    {
+        return -1;
+    }
 
-    for (i = 0; i != k; ++i)
+    sa_sint_t status = libsais16_set_local_buffer_size(context->ctx32, (int32_t)size);
+    if (status != 0)
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
-        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = c2;
-        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = c3;
-        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = c4;
-        uint16_t c5 = fastbits[p5 >> shift]; if (bucket2[c5] <= p5) { do { c5++; } while (bucket2[c5] <= p5); } p5 = P[p5]; U5[i] = c5;
-        uint16_t c6 = fastbits[p6 >> shift]; if (bucket2[c6] <= p6) { do { c6++; } while (bucket2[c6] <= p6); } p6 = P[p6]; U6[i] = c6;
-        uint16_t c7 = fastbits[p7 >> shift]; if (bucket2[c7] <= p7) { do { c7++; } while (bucket2[c7] <= p7); } p7 = P[p7]; U7[i] = c7;
+        return libsais16x64_ctx_status(context, status);
     }
 
-    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4; *i5 = p5; *i6 = p6; *i7 = p7;
+    sa_sint_t * RESTRICT local_buffer = NULL;
+    if (size > LIBSAIS_LOCAL_BUFFER_SIZE)
+    {
+        local_buffer = (sa_sint_t *)libsais16x64_alloc_memory(&context->allocator, (size_t)size * sizeof(sa_sint_t), 4096);
+        if (local_buffer == NULL)
+        {
+            return libsais16x64_ctx_status(context, -2);
+        }
+    }
+
+    libsais16x64_free_memory(&context->allocator, context->local_buffer);
+
+    context->local_buffer      = local_buffer;
+    context->local_buffer_size  = (fast_sint_t)size;
+
+    return 0;
 }
 
-static void libsais16x64_unbwt_decode(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_sint_t blocks, fast_uint_t remainder)
+int32_t libsais16x64_set_adaptive_threads(void * ctx, int64_t block_size)
 {
-    fast_uint_t shift       = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
-    fast_uint_t offset      = 0;
-
-    while (blocks > 8)
+    if ((ctx == NULL) || (block_size < 0))
     {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5], i6 = I[6], i7 = I[7];
-        libsais16x64_unbwt_decode_8(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, &i7, (fast_uint_t)r);
-        I += 8; blocks -= 8; offset += 8 * (fast_uint_t)r;
+        return -1;
     }
 
-    if (blocks == 1)
+    LIBSAIS_CONTEXT * RESTRICT context = (LIBSAIS_CONTEXT *)ctx;
+
+    if (libsais16_set_adaptive_threads(context->ctx32, block_size < INT32_MAX ? (int32_t)block_size : INT32_MAX) != 0)
     {
-        fast_uint_t i0 = I[0];
-        libsais16x64_unbwt_decode_1(U + offset, P, bucket2, fastbits, shift, &i0, remainder);
+        return -1;
     }
-    else if (blocks == 2)
+
+    context->monitor.thread_block_size = (sa_sint_t)block_size;
+
+    return 0;
+}
+
+int64_t libsais16x64(const uint16_t * T, int64_t * SA, int64_t n, int64_t fs, int64_t * freq)
+{
+    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
     {
-        fast_uint_t i0 = I[0], i1 = I[1];
-        libsais16x64_unbwt_decode_2(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, remainder);
-        libsais16x64_unbwt_decode_1(U + offset + remainder, P, bucket2, fastbits, shift, &i0, ((fast_uint_t)r) - remainder);
+        return -1;
     }
-    else if (blocks == 3)
+    else if (n < 2)
     {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2];
-        libsais16x64_unbwt_decode_3(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, remainder);
-        libsais16x64_unbwt_decode_2(U + offset + remainder, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, ((fast_uint_t)r) - remainder);
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
     }
-    else if (blocks == 4)
+
+    if (n <= INT32_MAX)
     {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3];
-        libsais16x64_unbwt_decode_4(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, remainder);
-        libsais16x64_unbwt_decode_3(U + offset + remainder, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, ((fast_uint_t)r) - remainder);
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        sa_sint_t index = libsais16(T, (int32_t *)SA, (int32_t)n, (int32_t)new_fs, (int32_t *)freq);
+
+        if (index >= 0)
+        {
+            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)SA, n, 1);
+            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, 1); }
+        }
+
+        return index;
     }
-    else if (blocks == 5)
+
+    return libsais16x64_main(T, SA, n, 0, 0, NULL, NULL, fs, freq, 1);
+}
+
+int64_t libsais16x64_long(int64_t * T, int64_t * SA, int64_t n, int64_t k, int64_t fs)
+{
+    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
     {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4];
-        libsais16x64_unbwt_decode_5(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, remainder);
-        libsais16x64_unbwt_decode_4(U + offset + remainder, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, ((fast_uint_t)r) - remainder);
+        return -1;
     }
-    else if (blocks == 6)
+    else if (n < 2)
     {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5];
-        libsais16x64_unbwt_decode_6(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, remainder);
-        libsais16x64_unbwt_decode_5(U + offset + remainder, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, ((fast_uint_t)r) - remainder);
+        if (n == 1) { SA[0] = 0; }
+        return 0;
     }
-    else if (blocks == 7)
+
+    return libsais16x64_main_long(T, SA, n, k, fs, 1);
+}
+
+int64_t libsais16x64_ctx(const void * ctx, const uint16_t * T, int64_t * SA, int64_t n, int64_t fs, int64_t * freq)
+{
+    if ((ctx == NULL) || (T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
     {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5], i6 = I[6];
-        libsais16x64_unbwt_decode_7(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, remainder);
-        libsais16x64_unbwt_decode_6(U + offset + remainder, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, ((fast_uint_t)r) - remainder);
+        return -1;
     }
-    else
+    else if (n < 2)
     {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5], i6 = I[6], i7 = I[7];
-        libsais16x64_unbwt_decode_8(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, &i7, remainder);
-        libsais16x64_unbwt_decode_7(U + offset + remainder, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, ((fast_uint_t)r) - remainder);
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
     }
-}
 
-static void libsais16x64_unbwt_decode_omp(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, sa_sint_t threads)
-{
-    fast_sint_t blocks      = 1 + (((fast_sint_t)n - 1) / (fast_sint_t)r);
-    fast_uint_t remainder   = (fast_uint_t)n - ((fast_uint_t)r * ((fast_uint_t)blocks - 1));
+    const LIBSAIS_CONTEXT * RESTRICT context = (const LIBSAIS_CONTEXT *)ctx;
 
-#if defined(LIBSAIS_OPENMP)
-    fast_sint_t max_threads = blocks < threads ? blocks : threads;
-    #pragma omp parallel num_threads(max_threads) if(max_threads > 1 && n >= 65536)
-#endif
+    if (n <= INT32_MAX)
     {
-#if defined(LIBSAIS_OPENMP)
-        fast_sint_t omp_thread_num      = omp_get_thread_num();
-        fast_sint_t omp_num_threads     = omp_get_num_threads();
-#else
-        UNUSED(threads);
-
-        fast_sint_t omp_thread_num      = 0;
-        fast_sint_t omp_num_threads     = 1;
-#endif
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        libsais16x64_numa_place_omp(context, SA, n, fs);
+        sa_sint_t index = libsais16_ctx(context->ctx32, T, (int32_t *)SA, (int32_t)n, (int32_t)new_fs, (int32_t *)freq);
 
-        fast_sint_t omp_block_stride    = blocks / omp_num_threads;
-        fast_sint_t omp_block_remainder = blocks % omp_num_threads;
-        fast_sint_t omp_block_size      = omp_block_stride + (omp_thread_num < omp_block_remainder);
-        fast_sint_t omp_block_start     = omp_block_stride * omp_thread_num + (omp_thread_num < omp_block_remainder ? omp_thread_num : omp_block_remainder);
+        if (index >= 0)
+        {
+            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)SA, n, (sa_sint_t)context->threads);
+            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, (sa_sint_t)context->threads); }
+        }
 
-        libsais16x64_unbwt_decode(U + r * omp_block_start, P, n, r, I + omp_block_start, bucket2, fastbits, omp_block_size, omp_thread_num < omp_num_threads - 1 ? (fast_uint_t)r : remainder);
+        return libsais16x64_ctx_status(context, index);
     }
+
+    return libsais16x64_main_ctx(context, T, SA, n, 0, 0, NULL, NULL, fs, freq);
 }
 
-static sa_sint_t libsais16x64_unbwt_core(const uint16_t * RESTRICT T, uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, sa_uint_t * RESTRICT buckets, sa_sint_t threads)
+int64_t libsais16x64_long_ctx(const void * ctx, int64_t * T, int64_t * SA, int64_t n, int64_t k, int64_t fs)
 {
-#if defined(LIBSAIS_OPENMP)
-    if (threads > 1 && n >= 262144)
+    if ((ctx == NULL) || (T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
     {
-        libsais16x64_unbwt_init_parallel(T, P, n, freq, I, bucket2, fastbits, buckets, threads);
+        return -1;
     }
-    else
-#else
-    UNUSED(buckets);
-#endif
+    else if (n < 2)
     {
-        libsais16x64_unbwt_init_single(T, P, n, freq, I, bucket2, fastbits);
+        if (n == 1) { SA[0] = 0; }
+        return 0;
     }
 
-    libsais16x64_unbwt_decode_omp(U, P, n, r, I, bucket2, fastbits, threads);
-    return 0;
+    return libsais16x64_main_long_ctx((const LIBSAIS_CONTEXT *)ctx, T, SA, n, k, fs);
 }
 
-static sa_sint_t libsais16x64_unbwt_main(const uint16_t * T, uint16_t * U, sa_uint_t * P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * I, sa_sint_t threads)
+int64_t libsais16x64_gsa(const uint16_t * T, int64_t * SA, int64_t n, int64_t fs, int64_t * freq)
 {
-    fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+    if ((T == NULL) || (SA == NULL) || (n < 0) || (n > 0 && T[n - 1] != 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
 
-    sa_uint_t *     RESTRICT bucket2        = (sa_uint_t *)libsais16x64_alloc_aligned(ALPHABET_SIZE * sizeof(sa_uint_t), 4096);
-    uint16_t *      RESTRICT fastbits       = (uint16_t *)libsais16x64_alloc_aligned(((size_t)1 + (size_t)(n >> shift)) * sizeof(uint16_t), 4096);
-    sa_uint_t *     RESTRICT buckets        = threads > 1 && n >= 262144 ? (sa_uint_t *)libsais16x64_alloc_aligned((size_t)threads * ALPHABET_SIZE * sizeof(sa_uint_t), 4096) : NULL;
+    if (n <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        sa_sint_t index = libsais16_gsa(T, (int32_t *)SA, (int32_t)n, (int32_t)new_fs, (int32_t *)freq);
 
-    sa_sint_t index = bucket2 != NULL && fastbits != NULL && (buckets != NULL || threads == 1 || n < 262144)
-        ? libsais16x64_unbwt_core(T, U, P, n, freq, r, I, bucket2, fastbits, buckets, threads)
-        : -2;
+        if (index >= 0)
+        {
+            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)SA, n, 1);
+            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, 1); }
+        }
+
+        return index;
+    }
+
+    return libsais16x64_main_gsa(T, SA, n, fs, freq, 1);
+}
+
+int64_t libsais16x64_gsa_ctx(const void * ctx, const uint16_t * T, int64_t * SA, int64_t n, int64_t fs, int64_t * freq)
+{
+    if ((ctx == NULL) || (T == NULL) || (SA == NULL) || (n < 0) || (n > 0 && T[n - 1] != 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    const LIBSAIS_CONTEXT * RESTRICT context = (const LIBSAIS_CONTEXT *)ctx;
+
+    if (n <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        libsais16x64_numa_place_omp(context, SA, n, fs);
+        sa_sint_t index = libsais16_gsa_ctx(context->ctx32, T, (int32_t *)SA, (int32_t)n, (int32_t)new_fs, (int32_t *)freq);
+
+        if (index >= 0)
+        {
+            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)SA, n, (sa_sint_t)context->threads);
+            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, (sa_sint_t)context->threads); }
+        }
+
+        return libsais16x64_ctx_status(context, index);
+    }
+
+    return libsais16x64_main_gsa_ctx(context, T, SA, n, fs, freq);
+}
+
+int64_t libsais16x64_bwt(const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0))
+    { 
+        return -1; 
+    }
+    else if (n <= 1) 
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        return n; 
+    }
+
+    if (n <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        sa_sint_t index = libsais16_bwt(T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq);
+
+        if (index >= 0)
+        {
+            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, 1); }
+        }
+
+        return index;
+    }
+
+    sa_sint_t index = libsais16x64_main(T, A, n, 1, 0, NULL, NULL, fs, freq, 1);
+    if (index >= 0) 
+    { 
+        index++;
+
+        U[0] = T[n - 1];
+        libsais16x64_bwt_copy_16u(U + 1, A, index - 1);
+        libsais16x64_bwt_copy_16u(U + index, A + index, n - index);
+    }
+
+    return index;
+}
+
+int64_t libsais16x64_bwt_aux(const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t r, int64_t * I)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL))
+    { 
+        return -1; 
+    }
+    else if (n <= 1) 
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        I[0] = n;
+        return 0;
+    }
+
+    if (n <= INT32_MAX && r <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        sa_sint_t index = libsais16_bwt_aux(T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)r, (int32_t *)I);
+
+        if (index >= 0)
+        {
+            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)I, 1 + ((n - 1) / r), 1);
+            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, 1); }
+        }
+
+        return index;
+    }
+
+    if (libsais16x64_main(T, A, n, 1, r, I, NULL, fs, freq, 1) != 0)
+    {
+        return -2;
+    }
+
+    U[0] = T[n - 1];
+    libsais16x64_bwt_copy_16u(U + 1, A, I[0] - 1);
+    libsais16x64_bwt_copy_16u(U + I[0], A + I[0], n - I[0]);
+
+    return 0;
+}
+
+int64_t libsais16x64_bwt_aux_sa(const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t r, int64_t * I, int64_t * S)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL) || (S == NULL))
+    { 
+        return -1; 
+    }
+    else if (n <= 1) 
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        I[0] = n; S[0] = 0;
+        return 0;
+    }
+
+    if (n <= INT32_MAX && r <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        sa_sint_t index = libsais16_bwt_aux_sa(T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)r, (int32_t *)I, (int32_t *)S);
+
+        if (index >= 0)
+        {
+            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)I, 1 + ((n - 1) / r), 1);
+            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)S, 1 + ((n - 1) / r), 1);
+            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, 1); }
+        }
+
+        return index;
+    }
+
+    if (libsais16x64_main(T, A, n, 1, r, I, S, fs, freq, 1) != 0)
+    {
+        return -2;
+    }
+
+    U[0] = T[n - 1];
+    libsais16x64_bwt_copy_16u(U + 1, A, I[0] - 1);
+    libsais16x64_bwt_copy_16u(U + I[0], A + I[0], n - I[0]);
+
+    return 0;
+}
+
+int64_t libsais16x64_bwt_ctx(const void * ctx, const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq)
+{
+    if ((ctx == NULL) || (T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        return n;
+    }
+
+    const LIBSAIS_CONTEXT * RESTRICT context = (const LIBSAIS_CONTEXT *)ctx;
+
+    if (n <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        libsais16x64_numa_place_omp(context, A, n, fs);
+        sa_sint_t index = libsais16_bwt_ctx(context->ctx32, T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq);
+
+        if (index >= 0)
+        {
+            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, (sa_sint_t)context->threads); }
+        }
+
+        return libsais16x64_ctx_status(context, index);
+    }
+
+    sa_sint_t index = libsais16x64_main_ctx(context, T, A, n, 1, 0, NULL, NULL, fs, freq);
+    if (index >= 0)
+    {
+        index++;
+
+        U[0] = T[n - 1];
+
+#if defined(LIBSAIS_OPENMP)
+        libsais16x64_bwt_copy_16u_omp(U + 1, A, index - 1, (sa_sint_t)context->threads);
+        libsais16x64_bwt_copy_16u_omp(U + index, A + index, n - index, (sa_sint_t)context->threads);
+#else
+        libsais16x64_bwt_copy_16u(U + 1, A, index - 1);
+        libsais16x64_bwt_copy_16u(U + index, A + index, n - index);
+#endif
+    }
+
+    return index;
+}
+
+int64_t libsais16x64_bwt_aux_ctx(const void * ctx, const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t r, int64_t * I)
+{
+    if ((ctx == NULL) || (T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        I[0] = n;
+        return 0;
+    }
+
+    const LIBSAIS_CONTEXT * RESTRICT context = (const LIBSAIS_CONTEXT *)ctx;
+
+    if (n <= INT32_MAX && r <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        libsais16x64_numa_place_omp(context, A, n, fs);
+        sa_sint_t index = libsais16_bwt_aux_ctx(context->ctx32, T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)r, (int32_t *)I);
+
+        if (index >= 0)
+        {
+            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)I, 1 + ((n - 1) / r), (sa_sint_t)context->threads);
+            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, (sa_sint_t)context->threads); }
+        }
+
+        return libsais16x64_ctx_status(context, index);
+    }
+
+    sa_sint_t index = libsais16x64_main_ctx(context, T, A, n, 1, r, I, NULL, fs, freq);
+    if (index != 0)
+    {
+        return index;
+    }
+
+    U[0] = T[n - 1];
+
+#if defined(LIBSAIS_OPENMP)
+    libsais16x64_bwt_copy_16u_omp(U + 1, A, I[0] - 1, (sa_sint_t)context->threads);
+    libsais16x64_bwt_copy_16u_omp(U + I[0], A + I[0], n - I[0], (sa_sint_t)context->threads);
+#else
+    libsais16x64_bwt_copy_16u(U + 1, A, I[0] - 1);
+    libsais16x64_bwt_copy_16u(U + I[0], A + I[0], n - I[0]);
+#endif
+
+    return 0;
+}
+
+int64_t libsais16x64_bwt_aux_sa_ctx(const void * ctx, const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t r, int64_t * I, int64_t * S)
+{
+    if ((ctx == NULL) || (T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL) || (S == NULL))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        I[0] = n; S[0] = 0;
+        return 0;
+    }
+
+    const LIBSAIS_CONTEXT * RESTRICT context = (const LIBSAIS_CONTEXT *)ctx;
+
+    if (n <= INT32_MAX && r <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        libsais16x64_numa_place_omp(context, A, n, fs);
+        sa_sint_t index = libsais16_bwt_aux_sa_ctx(context->ctx32, T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)r, (int32_t *)I, (int32_t *)S);
+
+        if (index >= 0)
+        {
+            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)I, 1 + ((n - 1) / r), (sa_sint_t)context->threads);
+            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)S, 1 + ((n - 1) / r), (sa_sint_t)context->threads);
+            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, (sa_sint_t)context->threads); }
+        }
+
+        return libsais16x64_ctx_status(context, index);
+    }
+
+    sa_sint_t index = libsais16x64_main_ctx(context, T, A, n, 1, r, I, S, fs, freq);
+    if (index != 0)
+    {
+        return index;
+    }
+
+    U[0] = T[n - 1];
+
+#if defined(LIBSAIS_OPENMP)
+    libsais16x64_bwt_copy_16u_omp(U + 1, A, I[0] - 1, (sa_sint_t)context->threads);
+    libsais16x64_bwt_copy_16u_omp(U + I[0], A + I[0], n - I[0], (sa_sint_t)context->threads);
+#else
+    libsais16x64_bwt_copy_16u(U + 1, A, I[0] - 1);
+    libsais16x64_bwt_copy_16u(U + I[0], A + I[0], n - I[0]);
+#endif
+
+    return 0;
+}
+
+int64_t libsais16x64_rlbwt(const uint16_t * T, uint16_t * C, int64_t * L, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t rs, int64_t * runs)
+{
+    if ((T == NULL) || (C == NULL) || (L == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (rs < 0) || (runs == NULL))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { if (freq != NULL) { freq[T[0]]++; } A[0] = T[0]; if (rs >= 1) { C[0] = T[0]; L[0] = 1; } }
+        *runs = n;
+        return n;
+    }
+
+    if (n <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        int32_t count = 0;
+        sa_sint_t index = libsais16_rlbwt(T, C, (int32_t *)L, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)(rs < INT32_MAX ? rs : INT32_MAX), &count);
+
+        if (index >= 0)
+        {
+            *runs = count;
+            if (count <= rs) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)L, count, 1); }
+            else { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)A, n, 1); }
+            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, 1); }
+        }
+
+        return index;
+    }
+
+    sa_sint_t index = libsais16x64_main(T, A, n, 1, 0, NULL, NULL, fs, freq, 1);
+    if (index >= 0)
+    {
+        index++; A[index - 1] = T[n - 1];
+
+        sa_sint_t count = libsais16x64_rlbwt_encode_16u_omp(A, C, L, n, index, rs, 1);
+        if (count < 0) { return count; }
+
+        *runs = count;
+    }
+
+    return index;
+}
+
+int64_t libsais16x64_rlbwt_encode(const int64_t * A, uint16_t * C, int64_t * L, int64_t n, int64_t i, int64_t rs, int64_t * runs)
+{
+    if ((A == NULL) || (C == NULL) || (L == NULL) || (n < 0) || (i < (n > 0)) || (i > n) || (rs < 0) || (runs == NULL))
+    {
+        return -1;
+    }
+    else if (n == 0)
+    {
+        *runs = 0;
+        return 0;
+    }
+
+    sa_sint_t count = libsais16x64_rlbwt_encode_16u_omp(A, C, L, n, i, rs, 1);
+    if (count < 0) { return count; }
+
+    *runs = count;
+    return 0;
+}
+
+static sa_sint_t libsais16x64_batch_main(const uint16_t * const * T, uint16_t * const * U, sa_sint_t * const * SA, const sa_sint_t * n, const sa_sint_t * fs, sa_sint_t * const * freq, sa_sint_t * result, sa_sint_t count, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && count > 1)
+#else
+    UNUSED(threads);
+#endif
+    {
+        LIBSAIS_CONTEXT * ctx = libsais16x64_create_ctx_main(1, NULL);
+
+        fast_sint_t i;
+
+#if defined(LIBSAIS_OPENMP)
+        #pragma omp for schedule(dynamic, 1)
+#endif
+        for (i = 0; i < (fast_sint_t)count; ++i)
+        {
+            sa_sint_t   job_fs      = fs != NULL ? fs[i] : 0;
+            sa_sint_t * job_freq    = freq != NULL ? freq[i] : NULL;
+
+            result[i] = ctx == NULL ? -2 : U != NULL
+                ? libsais16x64_bwt_ctx(ctx, T[i], U[i], SA[i], n[i], job_fs, job_freq)
+                : libsais16x64_ctx(ctx, T[i], SA[i], n[i], job_fs, job_freq);
+        }
+
+        libsais16x64_free_ctx_main(ctx);
+    }
+
+    fast_sint_t i;
+    for (i = 0; i < (fast_sint_t)count; ++i)
+    {
+        if (result[i] < 0) { return result[i]; }
+    }
+
+    return 0;
+}
+
+int64_t libsais16x64_batch(const uint16_t * const * T, int64_t * const * SA, const int64_t * n, const int64_t * fs, int64_t * const * freq, int64_t * result, int64_t count)
+{
+    if ((T == NULL) || (SA == NULL) || (n == NULL) || (result == NULL) || (count < 0))
+    {
+        return -1;
+    }
+
+    return libsais16x64_batch_main(T, NULL, SA, n, fs, freq, result, count, 1);
+}
+
+int64_t libsais16x64_bwt_batch(const uint16_t * const * T, uint16_t * const * U, int64_t * const * A, const int64_t * n, const int64_t * fs, int64_t * const * freq, int64_t * result, int64_t count)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n == NULL) || (result == NULL) || (count < 0))
+    {
+        return -1;
+    }
+
+    return libsais16x64_batch_main(T, U, A, n, fs, freq, result, count, 1);
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+void * libsais16x64_create_ctx_omp(int64_t threads)
+{
+    if (threads < 0) { return NULL; }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return (void *)libsais16x64_create_ctx_main(threads, NULL);
+}
+
+void * libsais16x64_create_ctx_alloc_omp(int64_t threads, void * (* alloc_fn)(size_t size, size_t alignment, void * opaque), void (* free_fn)(void * address, void * opaque), void * opaque)
+{
+    if ((threads < 0) || (alloc_fn == NULL) || (free_fn == NULL)) { return NULL; }
+
+    LIBSAIS_ALLOCATOR allocator = { alloc_fn, free_fn, opaque };
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return (void *)libsais16x64_create_ctx_main(threads, &allocator);
+}
+
+void * libsais16x64_create_ctx_buffer_omp(int64_t threads, void * buffer, size_t size)
+{
+    if (threads < 0) { return NULL; }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return (void *)libsais16x64_create_ctx_buffer_main(threads, buffer, size);
+}
+
+int64_t libsais16x64_omp(const uint16_t * T, int64_t * SA, int64_t n, int64_t fs, int64_t * freq, int64_t threads)
+{
+    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    if (n <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        sa_sint_t index = libsais16_omp(T, (int32_t *)SA, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)threads);
+
+        if (index >= 0)
+        {
+            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)SA, n, threads);
+            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, threads); }
+        }
+
+        return index;
+    }
+
+    return libsais16x64_main(T, SA, n, 0, 0, NULL, NULL, fs, freq, threads);
+}
+
+int64_t libsais16x64_long_omp(int64_t * T, int64_t * SA, int64_t n, int64_t k, int64_t fs, int64_t threads)
+{
+    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (n == 1) { SA[0] = 0; }
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais16x64_main_long(T, SA, n, k, fs, threads);
+}
+
+int64_t libsais16x64_gsa_omp(const uint16_t * T, int64_t * SA, int64_t n, int64_t fs, int64_t * freq, int64_t threads)
+{
+    if ((T == NULL) || (SA == NULL) || (n < 0) || (n > 0 && T[n - 1] != 0) || (fs < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    if (n <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        sa_sint_t index = libsais16_gsa_omp(T, (int32_t *)SA, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)threads);
+
+        if (index >= 0)
+        {
+            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)SA, n, threads);
+            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, threads); }
+        }
+
+        return index;
+    }
+
+    return libsais16x64_main_gsa(T, SA, n, fs, freq, threads);
+}
+
+int64_t libsais16x64_bwt_omp(const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        return n;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    if (n <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        sa_sint_t index = libsais16_bwt_omp(T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)threads);
+
+        if (index >= 0)
+        {
+            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, threads); }
+        }
+
+        return index;
+    }
+
+    sa_sint_t index = libsais16x64_main(T, A, n, 1, 0, NULL, NULL, fs, freq, threads);
+    if (index >= 0)
+    {
+        index++;
+
+        U[0] = T[n - 1];
+        libsais16x64_bwt_copy_16u_omp(U + 1, A, index - 1, threads);
+        libsais16x64_bwt_copy_16u_omp(U + index, A + index, n - index, threads);
+    }
+
+    return index;
+}
+
+int64_t libsais16x64_bwt_aux_omp(const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t r, int64_t * I, int64_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        I[0] = n;
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    if (n <= INT32_MAX && r <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        sa_sint_t index = libsais16_bwt_aux_omp(T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)r, (int32_t *)I, (int32_t)threads);
+
+        if (index >= 0)
+        {
+            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)I, 1 + ((n - 1) / r), threads);
+            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, threads); }
+        }
+
+        return index;
+    }
+
+    if (libsais16x64_main(T, A, n, 1, r, I, NULL, fs, freq, threads) != 0)
+    {
+        return -2;
+    }
+
+    U[0] = T[n - 1];
+    libsais16x64_bwt_copy_16u_omp(U + 1, A, I[0] - 1, threads);
+    libsais16x64_bwt_copy_16u_omp(U + I[0], A + I[0], n - I[0], threads);
+
+    return 0;
+}
+
+int64_t libsais16x64_bwt_aux_sa_omp(const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t r, int64_t * I, int64_t * S, int64_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL) || (S == NULL) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        I[0] = n; S[0] = 0;
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    if (n <= INT32_MAX && r <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        sa_sint_t index = libsais16_bwt_aux_sa_omp(T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)r, (int32_t *)I, (int32_t *)S, (int32_t)threads);
+
+        if (index >= 0)
+        {
+            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)I, 1 + ((n - 1) / r), threads);
+            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)S, 1 + ((n - 1) / r), threads);
+            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, threads); }
+        }
+
+        return index;
+    }
+
+    if (libsais16x64_main(T, A, n, 1, r, I, S, fs, freq, threads) != 0)
+    {
+        return -2;
+    }
+
+    U[0] = T[n - 1];
+    libsais16x64_bwt_copy_16u_omp(U + 1, A, I[0] - 1, threads);
+    libsais16x64_bwt_copy_16u_omp(U + I[0], A + I[0], n - I[0], threads);
+
+    return 0;
+}
+
+int64_t libsais16x64_rlbwt_omp(const uint16_t * T, uint16_t * C, int64_t * L, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t rs, int64_t * runs, int64_t threads)
+{
+    if ((T == NULL) || (C == NULL) || (L == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (rs < 0) || (runs == NULL) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { if (freq != NULL) { freq[T[0]]++; } A[0] = T[0]; if (rs >= 1) { C[0] = T[0]; L[0] = 1; } }
+        *runs = n;
+        return n;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    if (n <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        int32_t count = 0;
+        sa_sint_t index = libsais16_rlbwt_omp(T, C, (int32_t *)L, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)(rs < INT32_MAX ? rs : INT32_MAX), &count, (int32_t)threads);
+
+        if (index >= 0)
+        {
+            *runs = count;
+            if (count <= rs) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)L, count, threads); }
+            else { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)A, n, threads); }
+            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, threads); }
+        }
+
+        return index;
+    }
+
+    sa_sint_t index = libsais16x64_main(T, A, n, 1, 0, NULL, NULL, fs, freq, threads);
+    if (index >= 0)
+    {
+        index++; A[index - 1] = T[n - 1];
+
+        sa_sint_t count = libsais16x64_rlbwt_encode_16u_omp(A, C, L, n, index, rs, threads);
+        if (count < 0) { return count; }
+
+        *runs = count;
+    }
+
+    return index;
+}
+
+int64_t libsais16x64_rlbwt_encode_omp(const int64_t * A, uint16_t * C, int64_t * L, int64_t n, int64_t i, int64_t rs, int64_t * runs, int64_t threads)
+{
+    if ((A == NULL) || (C == NULL) || (L == NULL) || (n < 0) || (i < (n > 0)) || (i > n) || (rs < 0) || (runs == NULL) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n == 0)
+    {
+        *runs = 0;
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    sa_sint_t count = libsais16x64_rlbwt_encode_16u_omp(A, C, L, n, i, rs, threads);
+    if (count < 0) { return count; }
+
+    *runs = count;
+    return 0;
+}
+
+int64_t libsais16x64_batch_omp(const uint16_t * const * T, int64_t * const * SA, const int64_t * n, const int64_t * fs, int64_t * const * freq, int64_t * result, int64_t count, int64_t threads)
+{
+    if ((T == NULL) || (SA == NULL) || (n == NULL) || (result == NULL) || (count < 0) || (threads < 0))
+    {
+        return -1;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais16x64_batch_main(T, NULL, SA, n, fs, freq, result, count, threads);
+}
+
+int64_t libsais16x64_bwt_batch_omp(const uint16_t * const * T, uint16_t * const * U, int64_t * const * A, const int64_t * n, const int64_t * fs, int64_t * const * freq, int64_t * result, int64_t count, int64_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n == NULL) || (result == NULL) || (count < 0) || (threads < 0))
+    {
+        return -1;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais16x64_batch_main(T, U, A, n, fs, freq, result, count, threads);
+}
+
+#endif
+
+static LIBSAIS_UNBWT_CONTEXT * libsais16x64_unbwt_create_ctx_main(sa_sint_t threads, const LIBSAIS_ALLOCATOR * allocator)
+{
+    LIBSAIS_UNBWT_CONTEXT *     RESTRICT ctx            = (LIBSAIS_UNBWT_CONTEXT *)libsais16x64_alloc_memory(allocator, sizeof(LIBSAIS_UNBWT_CONTEXT), 64);
+    sa_uint_t *                 RESTRICT bucket2        = (sa_uint_t *)libsais16x64_alloc_memory(allocator, ALPHABET_SIZE * sizeof(sa_uint_t), 4096);
+    uint16_t *                  RESTRICT fastbits       = (uint16_t *)libsais16x64_alloc_memory(allocator, (1 + (1 << UNBWT_FASTBITS)) * sizeof(uint16_t), 4096);
+    sa_uint_t *                 RESTRICT buckets        = threads > 1 ? (sa_uint_t *)libsais16x64_alloc_memory(allocator, (size_t)threads * ALPHABET_SIZE * sizeof(sa_uint_t), 4096) : NULL;
+#if defined(LIBSAIS_OPENMP)
+    void *                               ctx32          = allocator != NULL && allocator->alloc != NULL
+        ? libsais16_unbwt_create_ctx_alloc_omp((int32_t)threads, allocator->alloc, allocator->free, allocator->opaque)
+        : libsais16_unbwt_create_ctx_omp((int32_t)threads);
+#else
+    void *                               ctx32          = allocator != NULL && allocator->alloc != NULL
+        ? libsais16_unbwt_create_ctx_alloc(allocator->alloc, allocator->free, allocator->opaque)
+        : libsais16_unbwt_create_ctx();
+#endif
+
+    if (ctx != NULL && bucket2 != NULL && fastbits != NULL && (buckets != NULL || threads == 1) && ctx32 != NULL)
+    {
+        ctx->bucket2      = bucket2;
+        ctx->fastbits     = fastbits;
+        ctx->buckets      = buckets;
+        ctx->fastbits_log = UNBWT_FASTBITS;
+        ctx->threads      = threads;
+        ctx->ctx32        = ctx32;
+
+        if (allocator != NULL) { ctx->allocator = *allocator; } else { memset(&ctx->allocator, 0, sizeof(LIBSAIS_ALLOCATOR)); }
+
+        return ctx;
+    }
+
+    libsais16_unbwt_free_ctx(ctx32);
+    libsais16x64_free_memory(allocator, buckets);
+    libsais16x64_free_memory(allocator, fastbits);
+    libsais16x64_free_memory(allocator, bucket2);
+    libsais16x64_free_memory(allocator, ctx);
+
+    return NULL;
+}
+
+static void libsais16x64_unbwt_free_ctx_main(LIBSAIS_UNBWT_CONTEXT * ctx)
+{
+    if (ctx != NULL)
+    {
+        LIBSAIS_ALLOCATOR allocator = ctx->allocator;
+
+        libsais16_unbwt_free_ctx(ctx->ctx32);
+        libsais16x64_free_memory(&allocator, ctx->buckets);
+        libsais16x64_free_memory(&allocator, ctx->fastbits);
+        libsais16x64_free_memory(&allocator, ctx->bucket2);
+        libsais16x64_free_memory(&allocator, ctx);
+    }
+}
+
+static int64_t libsais16x64_unbwt_alloc_size_main(fast_sint_t threads)
+{
+    int64_t size = (int64_t)sizeof(LIBSAIS_UNBWT_CONTEXT) + 64;
+
+    size += (int64_t)ALPHABET_SIZE * (int64_t)sizeof(sa_uint_t) + 4096;
+    size += ((int64_t)1 + ((int64_t)1 << UNBWT_FASTBITS)) * (int64_t)sizeof(uint16_t) + 4096;
+
+    if (threads > 1)
+    {
+        size += (int64_t)threads * ALPHABET_SIZE * (int64_t)sizeof(sa_uint_t) + 4096;
+    }
+
+    size += libsais16_unbwt_alloc_size((int32_t)threads);
+
+    return size;
+}
+
+static void libsais16x64_unbwt_compute_histogram(const uint16_t * RESTRICT T, fast_sint_t n, sa_uint_t * RESTRICT count)
+{
+    fast_sint_t i; for (i = 0; i < n; i += 1) { count[T[i]]++; }
+}
+
+static void libsais16x64_unbwt_calculate_fastbits(sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift)
+{
+    fast_uint_t v, w, sum;
+    for (v = 0, sum = 1, w = 0; w < ALPHABET_SIZE; ++w)
+    {
+        fast_uint_t prev = sum; sum += bucket2[w]; bucket2[w] = (sa_uint_t)prev;
+        if (prev != sum)
+        {
+            for (; v <= ((sum - 1) >> shift); ++v) { fastbits[v] = (uint16_t)w; }
+        }
+    }
+}
+
+static void libsais16x64_unbwt_calculate_P(const uint16_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, fast_uint_t index, fast_sint_t omp_block_start, fast_sint_t omp_block_end)
+{
+    {
+        fast_sint_t i = omp_block_start, j = (fast_sint_t)index; if (omp_block_end < j) { j = omp_block_end; }
+        for (; i < j; ++i) { fast_uint_t c = T[i]; P[bucket2[c]++] = (sa_uint_t)i; }
+    }
+
+    {
+        fast_sint_t i = (fast_sint_t)index, j = omp_block_end; if (omp_block_start > i) { i = omp_block_start; }
+        for (T -= 1, i += 1; i <= j; ++i) { fast_uint_t c = T[i]; P[bucket2[c]++] = (sa_uint_t)i; }
+    }
+}
+
+static void libsais16x64_unbwt_init_single(const uint16_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift)
+{
+    fast_uint_t index = I[0];
+
+    if (freq != NULL)
+    {
+        memcpy(bucket2, freq, ALPHABET_SIZE * sizeof(sa_uint_t));
+    }
+    else
+    {
+        memset(bucket2, 0, ALPHABET_SIZE * sizeof(sa_uint_t));
+        libsais16x64_unbwt_compute_histogram(T, n, bucket2);
+    }
+
+    libsais16x64_unbwt_calculate_fastbits(bucket2, fastbits, shift);
+    libsais16x64_unbwt_calculate_P(T, P, bucket2, index, 0, n);
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+static void libsais16x64_unbwt_init_parallel_histogram(const uint16_t * RESTRICT T, sa_sint_t n, sa_uint_t * RESTRICT buckets, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    sa_uint_t * RESTRICT bucket2_local  = buckets + omp_thread_num * ALPHABET_SIZE;
+    fast_sint_t omp_block_stride        = (n / omp_num_threads) & (-16);
+    fast_sint_t omp_block_start         = omp_thread_num * omp_block_stride;
+    fast_sint_t omp_block_size          = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+    memset(bucket2_local, 0, ALPHABET_SIZE * sizeof(sa_uint_t));
+    libsais16x64_unbwt_compute_histogram(T + omp_block_start, omp_block_size, bucket2_local);
+}
+
+static void libsais16x64_unbwt_init_parallel_bucket2(sa_uint_t * RESTRICT bucket2, sa_uint_t * RESTRICT buckets, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    sa_uint_t * RESTRICT bucket2_temp   = buckets;
+    fast_sint_t omp_block_stride        = (ALPHABET_SIZE / omp_num_threads) & (-16);
+    fast_sint_t omp_block_start         = omp_thread_num * omp_block_stride;
+    fast_sint_t omp_block_size          = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : ALPHABET_SIZE - omp_block_start;
+
+    memset(bucket2 + omp_block_start, 0, (size_t)omp_block_size * sizeof(sa_uint_t));
+
+    fast_sint_t t;
+    for (t = 0; t < omp_num_threads; ++t, bucket2_temp += ALPHABET_SIZE)
+    {
+        fast_sint_t c; for (c = omp_block_start; c < omp_block_start + omp_block_size; c += 1) { sa_uint_t A = bucket2[c], B = bucket2_temp[c]; bucket2[c] = A + B; bucket2_temp[c] = A; }
+    }
+}
+
+static void libsais16x64_unbwt_init_parallel_P(const uint16_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_sint_t n, fast_uint_t index, const sa_uint_t * RESTRICT bucket2, sa_uint_t * RESTRICT buckets, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    sa_uint_t * RESTRICT bucket2_local  = buckets + omp_thread_num * ALPHABET_SIZE;
+    fast_sint_t omp_block_stride        = (n / omp_num_threads) & (-16);
+    fast_sint_t omp_block_start         = omp_thread_num * omp_block_stride;
+    fast_sint_t omp_block_size          = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+    fast_sint_t c; for (c = 0; c < ALPHABET_SIZE; c += 1) { sa_uint_t A = bucket2[c], B = bucket2_local[c]; bucket2_local[c] = A + B; }
+
+    libsais16x64_unbwt_calculate_P(T, P, bucket2_local, index, omp_block_start, omp_block_start + omp_block_size);
+}
+
+static void libsais16x64_unbwt_init_parallel(const uint16_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, sa_uint_t * RESTRICT buckets, sa_sint_t threads)
+{
+    fast_uint_t index = I[0];
+
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+    {
+        fast_sint_t omp_thread_num  = omp_get_thread_num();
+        fast_sint_t omp_num_threads = omp_get_num_threads();
+
+        if (omp_num_threads == 1)
+        {
+            libsais16x64_unbwt_init_single(T, P, n, freq, I, bucket2, fastbits, shift);
+        }
+        else
+        {
+            libsais16x64_unbwt_init_parallel_histogram(T, n, buckets, omp_thread_num, omp_num_threads);
+
+            #pragma omp barrier
+
+            libsais16x64_unbwt_init_parallel_bucket2(bucket2, buckets, omp_thread_num, omp_num_threads);
+
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                libsais16x64_unbwt_calculate_fastbits(bucket2, fastbits, shift);
+            }
+
+            #pragma omp barrier
+
+            libsais16x64_unbwt_init_parallel_P(T, P, n, index, bucket2, buckets, omp_thread_num, omp_num_threads);
+
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                memcpy(bucket2, buckets + (omp_num_threads - 1) * ALPHABET_SIZE, ALPHABET_SIZE * sizeof(sa_uint_t));
+            }
+        }
+    }
+}
+
+#endif
+
+static void libsais16x64_unbwt_decode_1(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t * i0, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = U;
+
+    fast_uint_t i, p0 = *i0;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
+    }
+
+    *i0 = p0;
+}
+
+static void libsais16x64_unbwt_decode_2(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = U;
+    uint16_t * RESTRICT U1 = U0 + r;
+
+    fast_uint_t i, p0 = *i0, p1 = *i1;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
+    }
+
+    *i0 = p0; *i1 = p1;
+}
+
+static void libsais16x64_unbwt_decode_3(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = U;
+    uint16_t * RESTRICT U1 = U0 + r;
+    uint16_t * RESTRICT U2 = U1 + r;
+
+    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
+        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = c2;
+    }
+
+    *i0 = p0; *i1 = p1; *i2 = p2;
+}
+
+static void libsais16x64_unbwt_decode_4(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = U;
+    uint16_t * RESTRICT U1 = U0 + r;
+    uint16_t * RESTRICT U2 = U1 + r;
+    uint16_t * RESTRICT U3 = U2 + r;
+
+    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
+        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = c2;
+        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = c3;
+    }
+
+    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3;
+}
+
+static void libsais16x64_unbwt_decode_5(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = U;
+    uint16_t * RESTRICT U1 = U0 + r;
+    uint16_t * RESTRICT U2 = U1 + r;
+    uint16_t * RESTRICT U3 = U2 + r;
+    uint16_t * RESTRICT U4 = U3 + r;
+
+    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
+        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = c2;
+        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = c3;
+        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = c4;
+    }
+
+    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4;
+}
+
+static void libsais16x64_unbwt_decode_6(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t * i5, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = U;
+    uint16_t * RESTRICT U1 = U0 + r;
+    uint16_t * RESTRICT U2 = U1 + r;
+    uint16_t * RESTRICT U3 = U2 + r;
+    uint16_t * RESTRICT U4 = U3 + r;
+    uint16_t * RESTRICT U5 = U4 + r;
+
+    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4, p5 = *i5;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
+        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = c2;
+        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = c3;
+        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = c4;
+        uint16_t c5 = fastbits[p5 >> shift]; if (bucket2[c5] <= p5) { do { c5++; } while (bucket2[c5] <= p5); } p5 = P[p5]; U5[i] = c5;
+    }
+
+    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4; *i5 = p5;
+}
+
+static void libsais16x64_unbwt_decode_7(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t * i5, fast_uint_t * i6, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = U;
+    uint16_t * RESTRICT U1 = U0 + r;
+    uint16_t * RESTRICT U2 = U1 + r;
+    uint16_t * RESTRICT U3 = U2 + r;
+    uint16_t * RESTRICT U4 = U3 + r;
+    uint16_t * RESTRICT U5 = U4 + r;
+    uint16_t * RESTRICT U6 = U5 + r;
+
+    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4, p5 = *i5, p6 = *i6;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
+        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = c2;
+        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = c3;
+        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = c4;
+        uint16_t c5 = fastbits[p5 >> shift]; if (bucket2[c5] <= p5) { do { c5++; } while (bucket2[c5] <= p5); } p5 = P[p5]; U5[i] = c5;
+        uint16_t c6 = fastbits[p6 >> shift]; if (bucket2[c6] <= p6) { do { c6++; } while (bucket2[c6] <= p6); } p6 = P[p6]; U6[i] = c6;
+    }
+
+    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4; *i5 = p5; *i6 = p6;
+}
+
+static void libsais16x64_unbwt_decode_8(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t * i5, fast_uint_t * i6, fast_uint_t * i7, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = U;
+    uint16_t * RESTRICT U1 = U0 + r;
+    uint16_t * RESTRICT U2 = U1 + r;
+    uint16_t * RESTRICT U3 = U2 + r;
+    uint16_t * RESTRICT U4 = U3 + r;
+    uint16_t * RESTRICT U5 = U4 + r;
+    uint16_t * RESTRICT U6 = U5 + r;
+    uint16_t * RESTRICT U7 = U6 + r;
+
+    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4, p5 = *i5, p6 = *i6, p7 = *i7;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = c0;
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = c1;
+        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = c2;
+        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = c3;
+        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = c4;
+        uint16_t c5 = fastbits[p5 >> shift]; if (bucket2[c5] <= p5) { do { c5++; } while (bucket2[c5] <= p5); } p5 = P[p5]; U5[i] = c5;
+        uint16_t c6 = fastbits[p6 >> shift]; if (bucket2[c6] <= p6) { do { c6++; } while (bucket2[c6] <= p6); } p6 = P[p6]; U6[i] = c6;
+        uint16_t c7 = fastbits[p7 >> shift]; if (bucket2[c7] <= p7) { do { c7++; } while (bucket2[c7] <= p7); } p7 = P[p7]; U7[i] = c7;
+    }
+
+    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4; *i5 = p5; *i6 = p6; *i7 = p7;
+}
+
+static void libsais16x64_unbwt_decode(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_sint_t blocks, fast_uint_t remainder)
+{
+    fast_uint_t offset      = 0;
+
+    while (blocks > 8)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5], i6 = I[6], i7 = I[7];
+        libsais16x64_unbwt_decode_8(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, &i7, (fast_uint_t)r);
+        I += 8; blocks -= 8; offset += 8 * (fast_uint_t)r;
+    }
+
+    if (blocks == 1)
+    {
+        fast_uint_t i0 = I[0];
+        libsais16x64_unbwt_decode_1(U + offset, P, bucket2, fastbits, shift, &i0, remainder);
+    }
+    else if (blocks == 2)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1];
+        libsais16x64_unbwt_decode_2(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, remainder);
+        libsais16x64_unbwt_decode_1(U + offset + remainder, P, bucket2, fastbits, shift, &i0, ((fast_uint_t)r) - remainder);
+    }
+    else if (blocks == 3)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2];
+        libsais16x64_unbwt_decode_3(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, remainder);
+        libsais16x64_unbwt_decode_2(U + offset + remainder, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, ((fast_uint_t)r) - remainder);
+    }
+    else if (blocks == 4)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3];
+        libsais16x64_unbwt_decode_4(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, remainder);
+        libsais16x64_unbwt_decode_3(U + offset + remainder, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, ((fast_uint_t)r) - remainder);
+    }
+    else if (blocks == 5)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4];
+        libsais16x64_unbwt_decode_5(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, remainder);
+        libsais16x64_unbwt_decode_4(U + offset + remainder, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, ((fast_uint_t)r) - remainder);
+    }
+    else if (blocks == 6)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5];
+        libsais16x64_unbwt_decode_6(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, remainder);
+        libsais16x64_unbwt_decode_5(U + offset + remainder, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, ((fast_uint_t)r) - remainder);
+    }
+    else if (blocks == 7)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5], i6 = I[6];
+        libsais16x64_unbwt_decode_7(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, remainder);
+        libsais16x64_unbwt_decode_6(U + offset + remainder, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, ((fast_uint_t)r) - remainder);
+    }
+    else
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5], i6 = I[6], i7 = I[7];
+        libsais16x64_unbwt_decode_8(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, &i7, remainder);
+        libsais16x64_unbwt_decode_7(U + offset + remainder, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, ((fast_uint_t)r) - remainder);
+    }
+}
+
+static void libsais16x64_unbwt_decode_parallel(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_sint_t blocks, fast_uint_t remainder, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    fast_sint_t omp_block_stride    = blocks / omp_num_threads;
+    fast_sint_t omp_block_remainder = blocks % omp_num_threads;
+    fast_sint_t omp_block_size      = omp_block_stride + (omp_thread_num < omp_block_remainder);
+    fast_sint_t omp_block_start     = omp_block_stride * omp_thread_num + (omp_thread_num < omp_block_remainder ? omp_thread_num : omp_block_remainder);
+
+    libsais16x64_unbwt_decode(U + r * omp_block_start, P, r, I + omp_block_start, bucket2, fastbits, shift, omp_block_size, omp_thread_num < omp_num_threads - 1 ? (fast_uint_t)r : remainder);
+}
+
+static void libsais16x64_unbwt_decode_omp(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, sa_sint_t threads)
+{
+    fast_sint_t blocks      = 1 + (((fast_sint_t)n - 1) / (fast_sint_t)r);
+    fast_uint_t remainder   = (fast_uint_t)n - ((fast_uint_t)r * ((fast_uint_t)blocks - 1));
+
+#if defined(LIBSAIS_OPENMP)
+    fast_sint_t max_threads = blocks < threads ? blocks : threads;
+    #pragma omp parallel num_threads(max_threads) if(max_threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num      = omp_get_thread_num();
+        fast_sint_t omp_num_threads     = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num      = 0;
+        fast_sint_t omp_num_threads     = 1;
+#endif
+
+        libsais16x64_unbwt_decode_parallel(U, P, r, I, bucket2, fastbits, shift, blocks, remainder, omp_thread_num, omp_num_threads);
+    }
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+static void libsais16x64_unbwt_mark_splitters(sa_uint_t * RESTRICT P, fast_uint_t index, fast_uint_t step, fast_sint_t splitters, sa_uint_t mark)
+{
+    fast_sint_t k;
+    for (k = 0; k <= splitters; ++k)
+    {
+        fast_uint_t q = k < splitters ? (fast_uint_t)k * step : index;
+        if (P[q] != (sa_uint_t)-1) { P[q] = (P[q] & (sa_uint_t)SAINT_MAX) | mark; }
+    }
+}
+
+static void libsais16x64_unbwt_walk_splitters(const sa_uint_t * RESTRICT P, fast_uint_t index, fast_uint_t step, fast_sint_t splitters, sa_uint_t * RESTRICT buckets, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    sa_uint_t * RESTRICT next   = buckets;
+    sa_uint_t * RESTRICT length = buckets + splitters + 1;
+
+    fast_sint_t omp_block_stride    = (splitters + 1) / omp_num_threads;
+    fast_sint_t omp_block_remainder = (splitters + 1) % omp_num_threads;
+    fast_sint_t omp_block_size      = omp_block_stride + (omp_thread_num < omp_block_remainder);
+    fast_sint_t omp_block_start     = omp_block_stride * omp_thread_num + (omp_thread_num < omp_block_remainder ? omp_thread_num : omp_block_remainder);
+
+    fast_sint_t k;
+    for (k = omp_block_start; k < omp_block_start + omp_block_size; ++k)
+    {
+        fast_uint_t q = k < splitters ? (fast_uint_t)k * step : index;
+        fast_uint_t s = 0;
+
+        if (k < splitters && q == index) { next[k] = (sa_uint_t)-1; length[k] = 0; continue; }
+
+        for (;;)
+        {
+            sa_uint_t p = P[q];
+
+            if (p == (sa_uint_t)-1) { next[k] = (sa_uint_t)-1; length[k] = (sa_uint_t)(s + 1); break; }
+            if (s > 0 && (p & (sa_uint_t)SAINT_MIN) != 0) { next[k] = (sa_uint_t)(q == index ? (fast_uint_t)splitters : q / step); length[k] = (sa_uint_t)s; break; }
+
+            q = p & (sa_uint_t)SAINT_MAX; s++;
+        }
+    }
+}
+
+static fast_sint_t libsais16x64_unbwt_rank_splitters(fast_uint_t index, fast_uint_t step, fast_sint_t splitters, fast_uint_t steps, sa_uint_t * RESTRICT buckets)
+{
+    const sa_uint_t * RESTRICT next     = buckets;
+    const sa_uint_t * RESTRICT length   = buckets + 1 * (splitters + 1);
+    sa_uint_t *       RESTRICT rows     = buckets + 2 * (splitters + 1);
+    sa_uint_t *       RESTRICT offsets  = buckets + 3 * (splitters + 1);
+    sa_uint_t *       RESTRICT lengths  = buckets + 4 * (splitters + 1);
+
+    fast_sint_t segments = 0; fast_uint_t offset = 0, k = (fast_uint_t)splitters;
+    while (offset < steps && segments <= splitters)
+    {
+        rows[segments]      = (sa_uint_t)(k < (fast_uint_t)splitters ? k * step : index);
+        offsets[segments]   = (sa_uint_t)offset;
+        lengths[segments]   = (sa_uint_t)(length[k] < steps - offset ? length[k] : steps - offset);
+
+        offset += length[k]; segments++; if (next[k] == (sa_uint_t)-1) { break; } k = next[k];
+    }
+
+    return segments;
+}
+
+static void libsais16x64_unbwt_decode_splitters(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_sint_t splitters, fast_sint_t segments, fast_uint_t steps, const sa_uint_t * RESTRICT buckets, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    const sa_uint_t * RESTRICT rows     = buckets + 2 * (splitters + 1);
+    const sa_uint_t * RESTRICT offsets  = buckets + 3 * (splitters + 1);
+    const sa_uint_t * RESTRICT lengths  = buckets + 4 * (splitters + 1);
+
+    fast_uint_t omp_block_stride    = steps / (fast_uint_t)omp_num_threads;
+    fast_uint_t omp_block_start     = omp_block_stride * (fast_uint_t)omp_thread_num;
+    fast_uint_t omp_block_end       = omp_thread_num < omp_num_threads - 1 ? omp_block_start + omp_block_stride : steps;
+
+    fast_sint_t l = 0, h = segments;
+    while (l < h) { fast_sint_t m = l + ((h - l) >> 1); if (offsets[m] < omp_block_start) { l = m + 1; } else { h = m; } }
+
+    for (; l < segments && offsets[l] < omp_block_end; ++l)
+    {
+        fast_uint_t i0 = rows[l];
+        libsais16x64_unbwt_decode_1(U + (fast_uint_t)offsets[l], P, bucket2, fastbits, shift, &i0, lengths[l]);
+    }
+}
+
+static sa_sint_t libsais16x64_unbwt_use_splitters(sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    sa_sint_t cores = (sa_sint_t)omp_get_num_procs(); threads = threads < cores ? threads : cores;
+#endif
+
+    return threads >= UNBWT_SPLITTERS_MIN_THREADS && n >= UNBWT_SPLITTERS_MIN_SIZE;
+}
+
+static fast_sint_t libsais16x64_unbwt_count_splitters(sa_sint_t n, sa_sint_t threads)
+{
+    fast_sint_t splitters = (fast_sint_t)threads * 1024;
+    return splitters < ((fast_sint_t)n + 1) / 16 ? splitters : ((fast_sint_t)n + 1) / 16;
+}
+
+static void libsais16x64_unbwt_decode_splitters_omp(uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, fast_uint_t index, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, sa_uint_t * RESTRICT buckets, sa_sint_t threads)
+{
+    fast_sint_t splitters   = libsais16x64_unbwt_count_splitters(n, threads);
+    fast_uint_t step        = ((fast_uint_t)n + 1) / (fast_uint_t)splitters;
+    fast_uint_t steps       = (fast_uint_t)n;
+    fast_sint_t segments    = 0;
+
+    libsais16x64_unbwt_mark_splitters(P, index, step, splitters, (sa_uint_t)SAINT_MIN);
+
+    #pragma omp parallel num_threads(threads) if(threads > 1)
+    {
+        fast_sint_t omp_thread_num      = omp_get_thread_num();
+        fast_sint_t omp_num_threads     = omp_get_num_threads();
+
+        libsais16x64_unbwt_walk_splitters(P, index, step, splitters, buckets, omp_thread_num, omp_num_threads);
+
+        #pragma omp barrier
+
+        #pragma omp master
+        {
+            libsais16x64_unbwt_mark_splitters(P, index, step, splitters, 0);
+            segments = libsais16x64_unbwt_rank_splitters(index, step, splitters, steps, buckets);
+        }
+
+        #pragma omp barrier
+
+        libsais16x64_unbwt_decode_splitters(U, P, bucket2, fastbits, shift, splitters, segments, steps, buckets, omp_thread_num, omp_num_threads);
+    }
+}
+
+#endif
+
+static sa_sint_t libsais16x64_unbwt_decode_range(uint16_t * RESTRICT U, const sa_uint_t * RESTRICT P, sa_sint_t n, sa_sint_t r, const sa_uint_t * RESTRICT I, const sa_uint_t * RESTRICT bucket2, const uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t start, fast_uint_t len)
+{
+    fast_uint_t end     = start + len;
+
+    fast_uint_t i = start;
+    while (i < end)
+    {
+        fast_uint_t b = i / (fast_uint_t)r, block_end = (b + 1) * (fast_uint_t)r < end ? (b + 1) * (fast_uint_t)r : end;
+        fast_uint_t j = b * (fast_uint_t)r, p = I[b]; if (p > (fast_uint_t)n) { return -1; }
+
+        for (; j < i; ++j) { p = P[p]; if (p > (fast_uint_t)n) { return -1; } }
+
+        for (; j < block_end; ++j)
+        {
+            uint16_t c = fastbits[p >> shift]; if (bucket2[c] <= p) { do { c++; } while (bucket2[c] <= p); } p = P[p]; if (p > (fast_uint_t)n) { return -1; } U[j - start] = c;
+        }
+
+        i = block_end;
+    }
+
+    return 0;
+}
+
+static sa_sint_t libsais16x64_unbwt_range_core(const uint16_t * RESTRICT T, uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_sint_t start, sa_sint_t len, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, sa_uint_t * RESTRICT buckets, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    if (threads > 1 && n >= 262144)
+    {
+        libsais16x64_unbwt_init_parallel(T, P, n, freq, I, bucket2, fastbits, shift, buckets, threads);
+    }
+    else
+#else
+    UNUSED(buckets); UNUSED(threads);
+#endif
+    {
+        libsais16x64_unbwt_init_single(T, P, n, freq, I, bucket2, fastbits, shift);
+    }
+
+    libsais16x64_unbwt_decode_range(U, P, n, r, I, bucket2, fastbits, shift, (fast_uint_t)start, (fast_uint_t)len);
+    return 0;
+}
+
+static sa_sint_t libsais16x64_unbwt_core(const uint16_t * RESTRICT T, uint16_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_sint_t start, sa_sint_t len, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, sa_uint_t * RESTRICT buckets, sa_sint_t threads)
+{
+    if (len < n)
+    {
+        return libsais16x64_unbwt_range_core(T, U, P, n, freq, r, I, start, len, bucket2, fastbits, shift, buckets, threads);
+    }
+
+#if defined(LIBSAIS_OPENMP)
+    if (threads > 1 && n >= 262144)
+    {
+        if (r >= n && libsais16x64_unbwt_use_splitters(n, threads)) { memset(P, 0xff, ((size_t)n + 1) * sizeof(sa_uint_t)); }
+
+        libsais16x64_unbwt_init_parallel(T, P, n, freq, I, bucket2, fastbits, shift, buckets, threads);
+
+        if (r >= n && libsais16x64_unbwt_use_splitters(n, threads)) { libsais16x64_unbwt_decode_splitters_omp(U, P, n, I[0], bucket2, fastbits, shift, buckets, threads); return 0; }
+    }
+    else
+#else
+    UNUSED(buckets);
+#endif
+    {
+        libsais16x64_unbwt_init_single(T, P, n, freq, I, bucket2, fastbits, shift);
+    }
+
+    libsais16x64_unbwt_decode_omp(U, P, n, r, I, bucket2, fastbits, shift, threads);
+    return 0;
+}
+
+static sa_sint_t libsais16x64_unbwt_main(const uint16_t * T, uint16_t * U, sa_uint_t * P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * I, sa_sint_t start, sa_sint_t len, sa_sint_t threads)
+{
+    fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+
+    sa_uint_t *     RESTRICT bucket2        = (sa_uint_t *)libsais16x64_alloc_aligned(ALPHABET_SIZE * sizeof(sa_uint_t), 4096);
+    uint16_t *      RESTRICT fastbits       = (uint16_t *)libsais16x64_alloc_aligned(((size_t)1 + (size_t)(n >> shift)) * sizeof(uint16_t), 4096);
+    sa_uint_t *     RESTRICT buckets        = threads > 1 && n >= 262144 ? (sa_uint_t *)libsais16x64_alloc_aligned((size_t)threads * ALPHABET_SIZE * sizeof(sa_uint_t), 4096) : NULL;
+
+    sa_sint_t index = bucket2 != NULL && fastbits != NULL && (buckets != NULL || threads == 1 || n < 262144)
+        ? libsais16x64_unbwt_core(T, U, P, n, freq, r, I, start, len, bucket2, fastbits, shift, buckets, threads)
+        : -2;
+
+    libsais16x64_free_aligned(buckets);
+    libsais16x64_free_aligned(fastbits);
+    libsais16x64_free_aligned(bucket2);
+
+    return index;
+}
+
+static sa_sint_t libsais16x64_unbwt_main_ctx(const LIBSAIS_UNBWT_CONTEXT * ctx, const uint16_t * T, uint16_t * U, sa_uint_t * P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * I, sa_sint_t start, sa_sint_t len)
+{
+    if (ctx != NULL && ctx->bucket2 != NULL && ctx->fastbits != NULL && (ctx->buckets != NULL || ctx->threads == 1))
+    {
+        fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << ctx->fastbits_log)) { shift++; }
+        return libsais16x64_unbwt_core(T, U, P, n, freq, r, I, start, len, ctx->bucket2, ctx->fastbits, shift, ctx->buckets, (sa_sint_t)ctx->threads);
+    }
+
+    return -2;
+}
+
+void * libsais16x64_unbwt_create_ctx(void)
+{
+    return (void *)libsais16x64_unbwt_create_ctx_main(1, NULL);
+}
+
+void * libsais16x64_unbwt_create_ctx_alloc(void * (* alloc_fn)(size_t size, size_t alignment, void * opaque), void (* free_fn)(void * address, void * opaque), void * opaque)
+{
+    if ((alloc_fn == NULL) || (free_fn == NULL)) { return NULL; }
+
+    LIBSAIS_ALLOCATOR allocator = { alloc_fn, free_fn, opaque };
+    return (void *)libsais16x64_unbwt_create_ctx_main(1, &allocator);
+}
+
+void libsais16x64_unbwt_free_ctx(void * ctx)
+{
+    libsais16x64_unbwt_free_ctx_main((LIBSAIS_UNBWT_CONTEXT *)ctx);
+}
+
+int32_t libsais16x64_unbwt_set_fastbits(void * ctx, int32_t bits)
+{
+    if ((ctx == NULL) || (bits < UNBWT_FASTBITS_MIN) || (bits > UNBWT_FASTBITS_MAX))
+    {
+        return -1;
+    }
+
+    LIBSAIS_UNBWT_CONTEXT * RESTRICT context = (LIBSAIS_UNBWT_CONTEXT *)ctx;
+
+    sa_sint_t status = libsais16_unbwt_set_fastbits(context->ctx32, bits);
+    if (status != 0)
+    {
+        return status;
+    }
+
+    uint16_t * RESTRICT fastbits = (uint16_t *)libsais16x64_alloc_memory(&context->allocator, ((size_t)1 + ((size_t)1 << bits)) * sizeof(uint16_t), 4096);
+    if (fastbits == NULL)
+    {
+        return -2;
+    }
+
+    libsais16x64_free_memory(&context->allocator, context->fastbits);
+
+    context->fastbits       = fastbits;
+    context->fastbits_log   = bits;
+
+    return 0;
+}
+
+int64_t libsais16x64_unbwt_alloc_size(int64_t threads)
+{
+    if (threads < 0)
+    {
+        return -1;
+    }
+
+#if defined(LIBSAIS_OPENMP)
+    threads = threads > 0 ? threads : omp_get_max_threads();
+#else
+    threads = 1;
+#endif
+
+    return libsais16x64_unbwt_alloc_size_main(threads);
+}
+
+int64_t libsais16x64_unbwt_recommend_r(int64_t n, int64_t threads)
+{
+    if ((n < 0) || (threads < 0))
+    {
+        return -1;
+    }
+
+#if defined(LIBSAIS_OPENMP)
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    threads = threads < omp_get_num_procs() ? threads : omp_get_num_procs();
+#else
+    threads = threads > 0 ? threads : 1;
+#endif
+
+    if (threads == 1) { return n; }
+
+    fast_sint_t r = 2; while (r <= (fast_sint_t)n / ((fast_sint_t)threads * 16)) { r <<= 1; }
+    return (int64_t)r;
+}
+
+int64_t libsais16x64_unbwt(const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t i)
+{
+    return libsais16x64_unbwt_aux(T, U, A, n, freq, n, &i);
+}
+
+int64_t libsais16x64_unbwt_ctx(const void * ctx, const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t i)
+{
+    return libsais16x64_unbwt_aux_ctx(ctx, T, U, A, n, freq, n, &i);
+}
+
+int64_t libsais16x64_unbwt_aux(const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t r, const int64_t * I)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+        if (n == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+
+    if (n <= INT32_MAX && r <= INT32_MAX && (n - 1) / r < 1024)
+    {
+        int32_t indexes[1024]; for (t = 0; t <= (n - 1) / r; ++t) { indexes[t] = (int32_t)I[t]; }
+
+        return libsais16_unbwt_aux(T, U, (int32_t *)A, (int32_t)n, NULL, (int32_t)r, indexes);
+    }
+
+    return libsais16x64_unbwt_main(T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, 0, n, 1);
+}
+
+int64_t libsais16x64_unbwt_range(const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t r, const int64_t * I, int64_t start, int64_t len)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (start < 0) || (len < 0) || (start > n - len))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+        if (len == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+
+    if (len == 0) { return 0; }
+
+    if (n <= INT32_MAX && r <= INT32_MAX && (n - 1) / r < 1024)
+    {
+        int32_t indexes[1024]; for (t = 0; t <= (n - 1) / r; ++t) { indexes[t] = (int32_t)I[t]; }
+
+        return libsais16_unbwt_range(T, U, (int32_t *)A, (int32_t)n, NULL, (int32_t)r, indexes, (int32_t)start, (int32_t)len);
+    }
+
+    return libsais16x64_unbwt_main(T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, start, len, 1);
+}
+
+int64_t libsais16x64_unbwt_aux_ctx(const void * ctx, const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t r, const int64_t * I)
+{
+    if ((ctx == NULL) || (T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+        if (n == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+
+    const LIBSAIS_UNBWT_CONTEXT * RESTRICT context = (const LIBSAIS_UNBWT_CONTEXT *)ctx;
+
+    if (n <= INT32_MAX && r <= INT32_MAX && (n - 1) / r < 1024)
+    {
+        int32_t indexes[1024]; for (t = 0; t <= (n - 1) / r; ++t) { indexes[t] = (int32_t)I[t]; }
+
+        return libsais16_unbwt_aux_ctx(context->ctx32, T, U, (int32_t *)A, (int32_t)n, NULL, (int32_t)r, indexes);
+    }
+
+    return libsais16x64_unbwt_main_ctx(context, T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, 0, n);
+}
+
+int64_t libsais16x64_unbwt_range_ctx(const void * ctx, const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t r, const int64_t * I, int64_t start, int64_t len)
+{
+    if ((ctx == NULL) || (T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (start < 0) || (len < 0) || (start > n - len))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+        if (len == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+
+    if (len == 0) { return 0; }
+
+    const LIBSAIS_UNBWT_CONTEXT * RESTRICT context = (const LIBSAIS_UNBWT_CONTEXT *)ctx;
+
+    if (n <= INT32_MAX && r <= INT32_MAX && (n - 1) / r < 1024)
+    {
+        int32_t indexes[1024]; for (t = 0; t <= (n - 1) / r; ++t) { indexes[t] = (int32_t)I[t]; }
+
+        return libsais16_unbwt_range_ctx(context->ctx32, T, U, (int32_t *)A, (int32_t)n, NULL, (int32_t)r, indexes, (int32_t)start, (int32_t)len);
+    }
+
+    return libsais16x64_unbwt_main_ctx(context, T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, start, len);
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+void * libsais16x64_unbwt_create_ctx_omp(int64_t threads)
+{
+    if (threads < 0) { return NULL; }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return (void *)libsais16x64_unbwt_create_ctx_main(threads, NULL);
+}
+
+void * libsais16x64_unbwt_create_ctx_alloc_omp(int64_t threads, void * (* alloc_fn)(size_t size, size_t alignment, void * opaque), void (* free_fn)(void * address, void * opaque), void * opaque)
+{
+    if ((threads < 0) || (alloc_fn == NULL) || (free_fn == NULL)) { return NULL; }
+
+    LIBSAIS_ALLOCATOR allocator = { alloc_fn, free_fn, opaque };
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return (void *)libsais16x64_unbwt_create_ctx_main(threads, &allocator);
+}
+
+int64_t libsais16x64_unbwt_omp(const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t i, int64_t threads)
+{
+    return libsais16x64_unbwt_aux_omp(T, U, A, n, freq, n, &i, threads);
+}
+
+int64_t libsais16x64_unbwt_aux_omp(const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t r, const int64_t * I, int64_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+        if (n == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+
+    if (n <= INT32_MAX && r <= INT32_MAX && (n - 1) / r < 1024)
+    {
+        int32_t indexes[1024]; for (t = 0; t <= (n - 1) / r; ++t) { indexes[t] = (int32_t)I[t]; }
+
+        return libsais16_unbwt_aux_omp(T, U, (int32_t *)A, (int32_t)n, NULL,(int32_t)r, indexes, (int32_t)threads);
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return libsais16x64_unbwt_main(T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, 0, n, threads);
+}
+
+int64_t libsais16x64_unbwt_range_omp(const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t r, const int64_t * I, int64_t start, int64_t len, int64_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (start < 0) || (len < 0) || (start > n - len) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+        if (len == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+
+    if (len == 0) { return 0; }
+
+    if (n <= INT32_MAX && r <= INT32_MAX && (n - 1) / r < 1024)
+    {
+        int32_t indexes[1024]; for (t = 0; t <= (n - 1) / r; ++t) { indexes[t] = (int32_t)I[t]; }
+
+        return libsais16_unbwt_range_omp(T, U, (int32_t *)A, (int32_t)n, NULL,(int32_t)r, indexes, (int32_t)start, (int32_t)len, (int32_t)threads);
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return libsais16x64_unbwt_main(T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, start, len, threads);
+}
+
+#endif
+
+static int64_t libsais16x64_unbwt_index_layout(sa_sint_t n, sa_sint_t r, int64_t * RESTRICT offsets)
+{
+    fast_uint_t shift   = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+    int64_t     samples = n > 1 ? (int64_t)1 + (int64_t)((n - 1) / r) : 1;
+
+    offsets[0] = (int64_t)sizeof(LIBSAIS_UNBWT_INDEX);
+    offsets[1] = offsets[0] + (int64_t)(ALPHABET_SIZE) * (int64_t)sizeof(sa_uint_t);
+    offsets[2] = offsets[1] + ((((int64_t)1 + (int64_t)(n >> shift)) * (int64_t)sizeof(uint16_t) + 63) & (-64));
+    offsets[3] = offsets[2] + ((samples * (int64_t)sizeof(sa_uint_t) + 63) & (-64));
+
+    return offsets[3] + ((int64_t)n + 1) * (int64_t)sizeof(sa_uint_t);
+}
+
+static sa_sint_t libsais16x64_unbwt_index_validate(const void * index, size_t size)
+{
+    const LIBSAIS_UNBWT_INDEX * RESTRICT header = (const LIBSAIS_UNBWT_INDEX *)index;
+
+    if ((index == NULL) || (((size_t)index & 7) != 0) || (size < sizeof(LIBSAIS_UNBWT_INDEX)) || (header->magic != LIBSAIS_UNBWT_INDEX_MAGIC))
+    {
+        return -1;
+    }
+
+    int64_t n = header->n, r = header->r;
+    if ((n < 0) || ((int64_t)(sa_sint_t)n != n) || ((r != n) && ((r < 2) || ((int64_t)(sa_sint_t)r != r) || ((r & (r - 1)) != 0))))
+    {
+        return -1;
+    }
+
+    int64_t offsets[4];
+    if ((uint64_t)libsais16x64_unbwt_index_layout((sa_sint_t)n, (sa_sint_t)r, offsets) > (uint64_t)size)
+    {
+        return -1;
+    }
+
+    if ((n > 1) && (((const sa_uint_t *)(const void *)((const uint8_t *)index + offsets[0]))[ALPHABET_SIZE - 1] <= (sa_uint_t)n))
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+static sa_sint_t libsais16x64_unbwt_index_build_main(const uint16_t * T, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * I, void * index, size_t size, sa_sint_t threads)
+{
+    int64_t offsets[4];
+    if ((uint64_t)libsais16x64_unbwt_index_layout(n, r, offsets) > (uint64_t)size)
+    {
+        return -3;
+    }
+
+    LIBSAIS_UNBWT_INDEX *   RESTRICT header     = (LIBSAIS_UNBWT_INDEX *)index;
+    sa_uint_t *             RESTRICT bucket2    = (sa_uint_t *)(void *)((uint8_t *)index + offsets[0]);
+    uint16_t *              RESTRICT fastbits   = (uint16_t *)(void *)((uint8_t *)index + offsets[1]);
+    sa_uint_t *             RESTRICT samples    = (sa_uint_t *)(void *)((uint8_t *)index + offsets[2]);
+    sa_uint_t *             RESTRICT P          = (sa_uint_t *)(void *)((uint8_t *)index + offsets[3]);
+
+    fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+
+    memset(header, 0, sizeof(LIBSAIS_UNBWT_INDEX));
+    memcpy(samples, I, (n > 1 ? (size_t)1 + (size_t)((n - 1) / r) : 1) * sizeof(sa_uint_t));
+
+    if (n > 1)
+    {
+#if defined(LIBSAIS_OPENMP)
+        if (threads > 1 && n >= 262144)
+        {
+            sa_uint_t * RESTRICT buckets = (sa_uint_t *)libsais16x64_alloc_aligned((size_t)threads * ALPHABET_SIZE * sizeof(sa_uint_t), 4096);
+            if (buckets == NULL)
+            {
+                return -2;
+            }
+
+            libsais16x64_unbwt_init_parallel(T, P, n, freq, samples, bucket2, fastbits, shift, buckets, threads);
+            libsais16x64_free_aligned(buckets);
+        }
+        else
+#else
+        UNUSED(threads);
+#endif
+        {
+            libsais16x64_unbwt_init_single(T, P, n, freq, samples, bucket2, fastbits, shift);
+        }
+    }
+
+    header->n       = (int64_t)n;
+    header->r       = (int64_t)r;
+    header->lastc   = n > 0 ? (int64_t)T[0] : 0;
+    header->magic   = LIBSAIS_UNBWT_INDEX_MAGIC;
+
+    return 0;
+}
+
+static sa_sint_t libsais16x64_unbwt_index_decode_main(const void * index, uint16_t * U, sa_sint_t start, sa_sint_t len, sa_sint_t threads)
+{
+    const LIBSAIS_UNBWT_INDEX * RESTRICT header = (const LIBSAIS_UNBWT_INDEX *)index;
+
+    sa_sint_t n = (sa_sint_t)header->n;
+    sa_sint_t r = (sa_sint_t)header->r;
+
+    if (n <= 1)
+    {
+        if (len == 1) { U[0] = (uint16_t)header->lastc; }
+        return 0;
+    }
+
+    int64_t offsets[4]; libsais16x64_unbwt_index_layout(n, r, offsets);
+
+    const sa_uint_t *   RESTRICT bucket2    = (const sa_uint_t *)(const void *)((const uint8_t *)index + offsets[0]);
+    const uint16_t *    RESTRICT fastbits   = (const uint16_t *)(const void *)((const uint8_t *)index + offsets[1]);
+    const sa_uint_t *   RESTRICT samples    = (const sa_uint_t *)(const void *)((const uint8_t *)index + offsets[2]);
+    const sa_uint_t *   RESTRICT P          = (const sa_uint_t *)(const void *)((const uint8_t *)index + offsets[3]);
+
+    fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+    sa_sint_t corrupted = 0;
+
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && len >= 65536) reduction(|:corrupted)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num      = omp_get_thread_num();
+        fast_sint_t omp_num_threads     = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num      = 0;
+        fast_sint_t omp_num_threads     = 1;
+#endif
+        fast_sint_t omp_block_stride    = ((fast_sint_t)len / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start     = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size      = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : (fast_sint_t)len - omp_block_start;
+
+        corrupted |= libsais16x64_unbwt_decode_range(U + omp_block_start, P, n, r, samples, bucket2, fastbits, shift, (fast_uint_t)start + (fast_uint_t)omp_block_start, (fast_uint_t)omp_block_size) != 0;
+    }
+
+    return corrupted ? -1 : 0;
+}
+
+int64_t libsais16x64_unbwt_index_size(int64_t n, int64_t r)
+{
+    if ((n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))))
+    {
+        return -1;
+    }
+
+    if (n <= INT32_MAX && r <= INT32_MAX && (n <= 1 || (n - 1) / r < 1024))
+    {
+        return libsais16_unbwt_index_size((int32_t)n, (int32_t)r);
+    }
+
+    int64_t offsets[4]; return libsais16x64_unbwt_index_layout(n, r, offsets);
+}
+
+int64_t libsais16x64_unbwt_index_build(const uint16_t * T, int64_t n, const int64_t * freq, int64_t r, const int64_t * I, void * index, size_t size)
+{
+    if ((T == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (index == NULL) || (((size_t)index & 7) != 0))
+    {
+        return -1;
+    }
+
+    fast_sint_t t;
+    if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+    }
+    else
+    {
+        for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+    }
+
+    if (n <= INT32_MAX && r <= INT32_MAX && (n <= 1 || (n - 1) / r < 1024))
+    {
+        int32_t indexes[1024]; for (t = 0; t <= (n > 1 ? (n - 1) / r : 0); ++t) { indexes[t] = (int32_t)I[t]; }
+
+        return libsais16_unbwt_index_build(T, (int32_t)n, NULL, (int32_t)r, indexes, index, size);
+    }
+
+    return libsais16x64_unbwt_index_build_main(T, n, freq, r, (const sa_uint_t *)I, index, size, 1);
+}
+
+int64_t libsais16x64_unbwt_index_decode(const void * index, size_t size, uint16_t * U, int64_t start, int64_t len)
+{
+    if ((index != NULL) && (((size_t)index & 7) == 0) && (size >= sizeof(LIBSAIS_UNBWT_INDEX)) && (((const LIBSAIS_UNBWT_INDEX *)index)->magic != LIBSAIS_UNBWT_INDEX_MAGIC))
+    {
+        return (start >= 0) && (start <= INT32_MAX) && (len >= 0) && (len <= INT32_MAX) ? libsais16_unbwt_index_decode(index, size, U, (int32_t)start, (int32_t)len) : -1;
+    }
+
+    if ((U == NULL) || (libsais16x64_unbwt_index_validate(index, size) != 0) || (start < 0) || (len < 0) || (start > ((const LIBSAIS_UNBWT_INDEX *)index)->n - len))
+    {
+        return -1;
+    }
+
+    if (len == 0) { return 0; }
+
+    return libsais16x64_unbwt_index_decode_main(index, U, start, len, 1);
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+int64_t libsais16x64_unbwt_index_build_omp(const uint16_t * T, int64_t n, const int64_t * freq, int64_t r, const int64_t * I, void * index, size_t size, int64_t threads)
+{
+    if ((T == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (index == NULL) || (((size_t)index & 7) != 0) || (threads < 0))
+    {
+        return -1;
+    }
+
+    fast_sint_t t;
+    if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+    }
+    else
+    {
+        for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    if (n <= INT32_MAX && r <= INT32_MAX && (n <= 1 || (n - 1) / r < 1024))
+    {
+        int32_t indexes[1024]; for (t = 0; t <= (n > 1 ? (n - 1) / r : 0); ++t) { indexes[t] = (int32_t)I[t]; }
+
+        return libsais16_unbwt_index_build_omp(T, (int32_t)n, NULL, (int32_t)r, indexes, index, size, (int32_t)threads);
+    }
+
+    return libsais16x64_unbwt_index_build_main(T, n, freq, r, (const sa_uint_t *)I, index, size, threads);
+}
+
+int64_t libsais16x64_unbwt_index_decode_omp(const void * index, size_t size, uint16_t * U, int64_t start, int64_t len, int64_t threads)
+{
+    if ((index != NULL) && (((size_t)index & 7) == 0) && (size >= sizeof(LIBSAIS_UNBWT_INDEX)) && (((const LIBSAIS_UNBWT_INDEX *)index)->magic != LIBSAIS_UNBWT_INDEX_MAGIC))
+    {
+        return (start >= 0) && (start <= INT32_MAX) && (len >= 0) && (len <= INT32_MAX) ? libsais16_unbwt_index_decode_omp(index, size, U, (int32_t)start, (int32_t)len, (int32_t)threads) : -1;
+    }
+
+    if ((U == NULL) || (libsais16x64_unbwt_index_validate(index, size) != 0) || (start < 0) || (len < 0) || (start > ((const LIBSAIS_UNBWT_INDEX *)index)->n - len) || (threads < 0))
+    {
+        return -1;
+    }
+
+    if (len == 0) { return 0; }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return libsais16x64_unbwt_index_decode_main(index, U, start, len, threads);
+}
+
+#endif
+
+static void libsais16x64_compute_phi(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j; sa_sint_t k = omp_block_start > 0 ? SA[omp_block_start - 1] : n;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
+    {
+        libsais16x64_prefetchr(&SA[i + 2 * prefetch_distance]);
+
+        libsais16x64_prefetchw(&PLCP[SA[i + prefetch_distance + 0]]);
+        libsais16x64_prefetchw(&PLCP[SA[i + prefetch_distance + 1]]);
+
+        PLCP[SA[i + 0]] = k; k = SA[i + 0];
+        PLCP[SA[i + 1]] = k; k = SA[i + 1];
+
+        libsais16x64_prefetchw(&PLCP[SA[i + prefetch_distance + 2]]);
+        libsais16x64_prefetchw(&PLCP[SA[i + prefetch_distance + 3]]);
+
+        PLCP[SA[i + 2]] = k; k = SA[i + 2];
+        PLCP[SA[i + 3]] = k; k = SA[i + 3];
+    }
+
+    for (j += prefetch_distance + 3; i < j; i += 1)
+    {
+        PLCP[SA[i]] = k; k = SA[i];
+    }
+}
+
+static void libsais16x64_compute_phi_omp(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais16x64_compute_phi(SA, PLCP, n, omp_block_start, omp_block_size);
+    }
+}
+
+static void libsais16x64_compute_plcp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, fast_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j, l = 0;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais16x64_prefetchw(&PLCP[i + 2 * prefetch_distance]);
+        libsais16x64_prefetchr(&T[PLCP[i + prefetch_distance] + l]);
+
+        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
+        while (l < m && T[i + l] == T[k + l]) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+    }
+
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
+        while (l < m && T[i + l] == T[k + l]) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+    }
+}
+
+static void libsais16x64_compute_plcp_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais16x64_compute_plcp(T, PLCP, n, omp_block_start, omp_block_size);
+    }
+}
+
+static void libsais16x64_compute_plcp_gsa(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, fast_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j, l = 0;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais16x64_prefetchw(&PLCP[i + 2 * prefetch_distance]);
+        libsais16x64_prefetchr(&T[PLCP[i + prefetch_distance] + l]);
+
+        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
+        while (l < m && T[i + l] == T[k + l] && T[i + l] != 0) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+    }
+
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
+        while (l < m && T[i + l] == T[k + l] && T[i + l] != 0) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+    }
+}
+
+static void libsais16x64_compute_plcp_gsa_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais16x64_compute_plcp_gsa(T, PLCP, n, omp_block_start, omp_block_size);
+    }
+}
+
+static void libsais16x64_compute_lcp(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
+    {
+        libsais16x64_prefetchr(&SA[i + 2 * prefetch_distance]);
+        libsais16x64_prefetchw(&LCP[i + prefetch_distance]);
+
+        libsais16x64_prefetchr(&PLCP[SA[i + prefetch_distance + 0]]);
+        libsais16x64_prefetchr(&PLCP[SA[i + prefetch_distance + 1]]);
+
+        LCP[i + 0] = PLCP[SA[i + 0]];
+        LCP[i + 1] = PLCP[SA[i + 1]];
+
+        libsais16x64_prefetchr(&PLCP[SA[i + prefetch_distance + 2]]);
+        libsais16x64_prefetchr(&PLCP[SA[i + prefetch_distance + 3]]);
+
+        LCP[i + 2] = PLCP[SA[i + 2]];
+        LCP[i + 3] = PLCP[SA[i + 3]];
+    }
+
+    for (j += prefetch_distance + 3; i < j; i += 1)
+    {
+        LCP[i] = PLCP[SA[i]];
+    }
+}
+
+static void libsais16x64_compute_lcp_omp(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais16x64_compute_lcp(PLCP, SA, LCP, omp_block_start, omp_block_size);
+    }
+}
+
+static sa_sint_t libsais16x64_load_40u(const uint8_t * RESTRICT A, fast_sint_t i)
+{
+    const uint8_t * RESTRICT p = &A[i * 5];
+    return (sa_sint_t)((uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24) | ((uint64_t)p[4] << 32));
+}
+
+static void libsais16x64_store_40u(uint8_t * RESTRICT A, fast_sint_t i, sa_sint_t v)
+{
+    uint8_t * RESTRICT p = &A[i * 5];
+    p[0] = (uint8_t)((uint64_t)v >> 0); p[1] = (uint8_t)((uint64_t)v >> 8); p[2] = (uint8_t)((uint64_t)v >> 16); p[3] = (uint8_t)((uint64_t)v >> 24); p[4] = (uint8_t)((uint64_t)v >> 32);
+}
+
+static void libsais16x64_convert_64u_to_40u(const sa_sint_t * RESTRICT S, uint8_t * RESTRICT D, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size; i < j; i += 1)
+    {
+        libsais16x64_store_40u(D, i, S[i]);
+    }
+}
+
+static void libsais16x64_convert_40u_to_64u(const uint8_t * RESTRICT S, sa_sint_t * RESTRICT D, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size; i < j; i += 1)
+    {
+        D[i] = libsais16x64_load_40u(S, i);
+    }
+}
+
+static void libsais16x64_convert_inplace_64u_to_40u(sa_sint_t * V, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    uint8_t * D = (uint8_t *)(void *)V;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size; i < j; i += 1)
+    {
+        uint64_t v = (uint64_t)V[i];
+        D[i * 5 + 0] = (uint8_t)(v >> 0); D[i * 5 + 1] = (uint8_t)(v >> 8); D[i * 5 + 2] = (uint8_t)(v >> 16); D[i * 5 + 3] = (uint8_t)(v >> 24); D[i * 5 + 4] = (uint8_t)(v >> 32);
+    }
+}
+
+static void libsais16x64_convert_inplace_40u_to_64u(sa_sint_t * V, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const uint8_t * S = (const uint8_t *)(void *)V;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start + omp_block_size - 1, j = omp_block_start; i >= j; i -= 1)
+    {
+        uint64_t v = (uint64_t)S[i * 5 + 0] | ((uint64_t)S[i * 5 + 1] << 8) | ((uint64_t)S[i * 5 + 2] << 16) | ((uint64_t)S[i * 5 + 3] << 24) | ((uint64_t)S[i * 5 + 4] << 32);
+        V[i] = (sa_sint_t)v;
+    }
+}
+
+static void libsais16x64_convert_inplace_64u_to_40u_omp(sa_sint_t * V, sa_sint_t n, sa_sint_t threads)
+{
+    fast_sint_t m = n < 65536 ? n : 65536;
+
+    libsais16x64_convert_inplace_64u_to_40u(V, 0, m);
+
+    while (m < n)
+    {
+        fast_sint_t block_size = (m >> 1) < (n - m) ? (m >> 1) : (n - m);
+
+#if defined(LIBSAIS_OPENMP)
+        #pragma omp parallel num_threads(threads) if(threads > 1)
+#endif
+        {
+#if defined(LIBSAIS_OPENMP)
+            fast_sint_t omp_thread_num      = omp_get_thread_num();
+            fast_sint_t omp_num_threads     = omp_get_num_threads();
+#else
+            UNUSED(threads);
+
+            fast_sint_t omp_thread_num      = 0;
+            fast_sint_t omp_num_threads     = 1;
+#endif
+            fast_sint_t omp_block_stride    = (block_size / omp_num_threads) & (-16);
+            fast_sint_t omp_block_start     = omp_thread_num * omp_block_stride;
+            fast_sint_t omp_block_size      = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : block_size - omp_block_start;
+
+            libsais16x64_convert_64u_to_40u(V + m, ((uint8_t *)(void *)V) + m * 5, omp_block_start, omp_block_size);
+        }
+
+        m += block_size;
+    }
+}
+
+static void libsais16x64_convert_inplace_40u_to_64u_omp(sa_sint_t * V, sa_sint_t n, sa_sint_t threads)
+{
+    while (n >= 65536)
+    {
+        fast_sint_t block_size = n >> 2; n -= block_size;
+
+#if defined(LIBSAIS_OPENMP)
+        #pragma omp parallel num_threads(threads) if(threads > 1)
+#endif
+        {
+#if defined(LIBSAIS_OPENMP)
+            fast_sint_t omp_thread_num      = omp_get_thread_num();
+            fast_sint_t omp_num_threads     = omp_get_num_threads();
+#else
+            UNUSED(threads);
+
+            fast_sint_t omp_thread_num      = 0;
+            fast_sint_t omp_num_threads     = 1;
+#endif
+            fast_sint_t omp_block_stride    = (block_size / omp_num_threads) & (-16);
+            fast_sint_t omp_block_start     = omp_thread_num * omp_block_stride;
+            fast_sint_t omp_block_size      = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : block_size - omp_block_start;
+
+            libsais16x64_convert_40u_to_64u(((uint8_t *)(void *)V) + (fast_sint_t)n * 5, V + n, omp_block_start, omp_block_size);
+        }
+    }
+
+    libsais16x64_convert_inplace_40u_to_64u(V, 0, n);
+}
+
+static void libsais16x64_compute_phi_40u(const uint8_t * RESTRICT SA, uint8_t * RESTRICT PLCP, sa_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j; sa_sint_t k = omp_block_start > 0 ? libsais16x64_load_40u(SA, omp_block_start - 1) : n;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais16x64_prefetchr(&SA[(i + 2 * prefetch_distance) * 5]);
+        libsais16x64_prefetchw(&PLCP[libsais16x64_load_40u(SA, i + prefetch_distance) * 5]);
+
+        sa_sint_t s = libsais16x64_load_40u(SA, i); libsais16x64_store_40u(PLCP, s, k); k = s;
+    }
+
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        sa_sint_t s = libsais16x64_load_40u(SA, i); libsais16x64_store_40u(PLCP, s, k); k = s;
+    }
+}
+
+static void libsais16x64_compute_phi_40u_omp(const uint8_t * RESTRICT SA, uint8_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais16x64_compute_phi_40u(SA, PLCP, n, omp_block_start, omp_block_size);
+    }
+}
+
+static void libsais16x64_compute_plcp_40u(const uint16_t * RESTRICT T, uint8_t * RESTRICT PLCP, fast_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j, l = 0;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais16x64_prefetchw(&PLCP[(i + 2 * prefetch_distance) * 5]);
+        libsais16x64_prefetchr(&T[libsais16x64_load_40u(PLCP, i + prefetch_distance) + l]);
+
+        fast_sint_t k = libsais16x64_load_40u(PLCP, i), m = n - (i > k ? i : k);
+        while (l < m && T[i + l] == T[k + l]) { l++; }
+
+        libsais16x64_store_40u(PLCP, i, (sa_sint_t)l); l -= (l != 0);
+    }
+
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        fast_sint_t k = libsais16x64_load_40u(PLCP, i), m = n - (i > k ? i : k);
+        while (l < m && T[i + l] == T[k + l]) { l++; }
+
+        libsais16x64_store_40u(PLCP, i, (sa_sint_t)l); l -= (l != 0);
+    }
+}
+
+static void libsais16x64_compute_plcp_40u_omp(const uint16_t * RESTRICT T, uint8_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais16x64_compute_plcp_40u(T, PLCP, n, omp_block_start, omp_block_size);
+    }
+}
+
+static void libsais16x64_compute_lcp_40u(const uint8_t * RESTRICT PLCP, const uint8_t * RESTRICT SA, uint8_t * RESTRICT LCP, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais16x64_prefetchr(&SA[(i + 2 * prefetch_distance) * 5]);
+        libsais16x64_prefetchw(&LCP[(i + prefetch_distance) * 5]);
+
+        libsais16x64_prefetchr(&PLCP[libsais16x64_load_40u(SA, i + prefetch_distance) * 5]);
+
+        libsais16x64_store_40u(LCP, i, libsais16x64_load_40u(PLCP, libsais16x64_load_40u(SA, i)));
+    }
+
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        libsais16x64_store_40u(LCP, i, libsais16x64_load_40u(PLCP, libsais16x64_load_40u(SA, i)));
+    }
+}
+
+static void libsais16x64_compute_lcp_40u_omp(const uint8_t * RESTRICT PLCP, const uint8_t * RESTRICT SA, uint8_t * RESTRICT LCP, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais16x64_compute_lcp_40u(PLCP, SA, LCP, omp_block_start, omp_block_size);
+    }
+}
+
+static void libsais16x64_compute_isa(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT ISA, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
+    {
+        libsais16x64_prefetchr(&SA[i + 2 * prefetch_distance]);
+
+        libsais16x64_prefetchw(&ISA[SA[i + prefetch_distance + 0]]);
+        libsais16x64_prefetchw(&ISA[SA[i + prefetch_distance + 1]]);
+
+        ISA[SA[i + 0]] = (sa_sint_t)(i + 0);
+        ISA[SA[i + 1]] = (sa_sint_t)(i + 1);
+
+        libsais16x64_prefetchw(&ISA[SA[i + prefetch_distance + 2]]);
+        libsais16x64_prefetchw(&ISA[SA[i + prefetch_distance + 3]]);
+
+        ISA[SA[i + 2]] = (sa_sint_t)(i + 2);
+        ISA[SA[i + 3]] = (sa_sint_t)(i + 3);
+    }
+
+    for (j += prefetch_distance + 3; i < j; i += 1)
+    {
+        ISA[SA[i]] = (sa_sint_t)i;
+    }
+}
+
+static void libsais16x64_compute_isa_inplace(sa_sint_t * RESTRICT SA, sa_sint_t n)
+{
+    fast_sint_t i;
+    for (i = 0; i < n; i += 1)
+    {
+        if (SA[i] >= 0)
+        {
+            sa_sint_t p = (sa_sint_t)i, q = SA[i];
+            while (q != (sa_sint_t)i) { sa_sint_t r = SA[q]; SA[q] = p | SAINT_MIN; p = q; q = r; }
+
+            SA[i] = p | SAINT_MIN;
+        }
+    }
+}
+
+static void libsais16x64_unmark_array(sa_sint_t * RESTRICT A, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i;
+    for (i = omp_block_start; i < omp_block_start + omp_block_size; i += 1)
+    {
+        A[i] &= SAINT_MAX;
+    }
+}
+
+static void libsais16x64_compute_isa_omp(const sa_sint_t * SA, sa_sint_t * ISA, sa_sint_t n, sa_sint_t threads)
+{
+    if (SA == ISA)
+    {
+        libsais16x64_compute_isa_inplace(ISA, n);
+    }
+
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        if (SA == ISA)
+        {
+            libsais16x64_unmark_array(ISA, omp_block_start, omp_block_size);
+        }
+        else
+        {
+            libsais16x64_compute_isa(SA, ISA, omp_block_start, omp_block_size);
+        }
+    }
+}
+
+static void libsais16x64_compute_lcp_inplace(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n)
+{
+    fast_sint_t i;
+    for (i = 0; i < n; i += 1)
+    {
+        if (PLCP[i] >= 0)
+        {
+            sa_sint_t l = PLCP[i]; fast_sint_t j = i, k;
+            while ((k = (fast_sint_t)SA[j]) != i) { PLCP[j] = PLCP[k] | SAINT_MIN; j = k; }
+
+            PLCP[j] = l | SAINT_MIN;
+        }
+    }
+}
+
+static void libsais16x64_compute_lcp_inplace_omp(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+{
+    libsais16x64_compute_lcp_inplace(SA, PLCP, n);
+
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais16x64_unmark_array(PLCP, omp_block_start, omp_block_size);
+    }
+}
+
+static void libsais16x64_compute_sa_lcp_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, sa_sint_t n, sa_sint_t fs, sa_sint_t threads)
+{
+    if (fs >= n)
+    {
+        libsais16x64_compute_phi_omp(SA, &SA[n], n, threads);
+        libsais16x64_compute_plcp_omp(T, &SA[n], n, threads);
+        libsais16x64_compute_lcp_omp(&SA[n], SA, LCP, n, threads);
+    }
+    else
+    {
+        libsais16x64_compute_phi_omp(SA, LCP, n, threads);
+        libsais16x64_compute_plcp_omp(T, LCP, n, threads);
+        libsais16x64_compute_lcp_inplace_omp(SA, LCP, n, threads);
+    }
+}
+
+static void libsais16x64_compute_phi_sampled(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t r, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j; sa_sint_t k = omp_block_start > 0 ? SA[omp_block_start - 1] : n, s;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - 3; i < j; i += 4)
+    {
+        libsais16x64_prefetchr(&SA[i + prefetch_distance]);
+
+        s = SA[i + 0]; if ((s & (r - 1)) == 0) { PLCP[s / r] = k; } k = s;
+        s = SA[i + 1]; if ((s & (r - 1)) == 0) { PLCP[s / r] = k; } k = s;
+        s = SA[i + 2]; if ((s & (r - 1)) == 0) { PLCP[s / r] = k; } k = s;
+        s = SA[i + 3]; if ((s & (r - 1)) == 0) { PLCP[s / r] = k; } k = s;
+    }
+
+    for (j += 3; i < j; i += 1)
+    {
+        s = SA[i]; if ((s & (r - 1)) == 0) { PLCP[s / r] = k; } k = s;
+    }
+}
+
+static void libsais16x64_compute_phi_sampled_omp(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t r, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais16x64_compute_phi_sampled(SA, PLCP, n, r, omp_block_start, omp_block_size);
+    }
+}
+
+static void libsais16x64_compute_plcp_sampled(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, fast_sint_t n, fast_sint_t r, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j, l = 0;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais16x64_prefetchw(&PLCP[i + 2 * prefetch_distance]);
+        libsais16x64_prefetchr(&T[(i + prefetch_distance) * r + l]);
+        libsais16x64_prefetchr(&T[PLCP[i + prefetch_distance] + l]);
+
+        fast_sint_t p = i * r, k = PLCP[i], m = n - (p > k ? p : k);
+        while (l < m && T[p + l] == T[k + l]) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l = l > r ? l - r : 0;
+    }
+
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        fast_sint_t p = i * r, k = PLCP[i], m = n - (p > k ? p : k);
+        while (l < m && T[p + l] == T[k + l]) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l = l > r ? l - r : 0;
+    }
+}
+
+static void libsais16x64_compute_plcp_sampled_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t r, sa_sint_t threads)
+{
+    fast_sint_t m = ((fast_sint_t)n - 1) / r + 1;
+
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (m / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : m - omp_block_start;
+
+        libsais16x64_compute_plcp_sampled(T, PLCP, n, r, omp_block_start, omp_block_size);
+    }
+}
+
+static sa_sint_t libsais16x64_compute_lcp_sample(const uint16_t * RESTRICT T, const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, fast_sint_t n, fast_sint_t r, fast_sint_t i)
+{
+    if (i == 0) { return 0; }
+
+    fast_sint_t p = SA[i], k = SA[i - 1], m = n - (p > k ? p : k);
+    fast_sint_t l = PLCP[p / r] - (p & (r - 1)); l = l > 0 ? l : 0;
+    while (l < m && T[p + l] == T[k + l]) { l++; }
+
+    return (sa_sint_t)l;
+}
+
+static void libsais16x64_compute_lcp_sampled(const uint16_t * RESTRICT T, const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, fast_sint_t n, fast_sint_t r, fast_sint_t k, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais16x64_prefetchr(&SA[(i + 2 * prefetch_distance) * k - 1]);
+        libsais16x64_prefetchr(&PLCP[SA[(i + prefetch_distance) * k] / r]);
+
+        LCP[i] = libsais16x64_compute_lcp_sample(T, PLCP, SA, n, r, i * k);
+    }
+
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        LCP[i] = libsais16x64_compute_lcp_sample(T, PLCP, SA, n, r, i * k);
+    }
+}
+
+static void libsais16x64_compute_lcp_sampled_omp(const uint16_t * RESTRICT T, const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, sa_sint_t n, sa_sint_t r, sa_sint_t k, sa_sint_t threads)
+{
+    fast_sint_t m = ((fast_sint_t)n - 1) / k + 1;
+
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && m >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (m / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : m - omp_block_start;
+
+        libsais16x64_compute_lcp_sampled(T, PLCP, SA, LCP, n, r, k, omp_block_start, omp_block_size);
+    }
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+static fast_sint_t libsais16x64_count_marked(const uint8_t * RESTRICT B, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i, j, c = 0;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - 7; i < j; i += 8)
+    {
+        fast_uint_t x = B[i >> 3];
+
+        x = x - ((x >> 1) & 0x55); x = (x & 0x33) + ((x >> 2) & 0x33); c += (fast_sint_t)((x + (x >> 4)) & 0x0f);
+    }
+
+    for (j += 7; i < j; i += 1)
+    {
+        c += (B[i >> 3] >> (i & 7)) & 1;
+    }
+
+    return c;
+}
+
+#endif
+
+static fast_sint_t libsais16x64_compute_lcp_marked(const uint16_t * RESTRICT T, const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, const uint8_t * RESTRICT B, sa_sint_t * RESTRICT LCP, fast_sint_t n, fast_sint_t r, fast_sint_t c, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size; i < j; i += 1)
+    {
+        if ((B[i >> 3] >> (i & 7)) & 1)
+        {
+            LCP[c++] = libsais16x64_compute_lcp_sample(T, PLCP, SA, n, r, i);
+        }
+    }
+
+    return c;
+}
+
+static sa_sint_t libsais16x64_compute_lcp_marked_omp(const uint16_t * RESTRICT T, const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, const uint8_t * RESTRICT B, sa_sint_t * RESTRICT LCP, sa_sint_t n, sa_sint_t r, sa_sint_t threads)
+{
+    fast_sint_t count = 0;
+
+#if defined(LIBSAIS_OPENMP)
+    fast_sint_t * RESTRICT counts = threads > 1 && n >= 65536 ? (fast_sint_t *)libsais16x64_alloc_aligned((size_t)threads * sizeof(fast_sint_t), 64) : NULL;
+    if (threads > 1 && n >= 65536 && counts == NULL) { return -2; }
+
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        if (omp_num_threads == 1)
+        {
+            count = libsais16x64_compute_lcp_marked(T, PLCP, SA, B, LCP, n, r, 0, omp_block_start, omp_block_size);
+        }
+#if defined(LIBSAIS_OPENMP)
+        else
+        {
+            counts[omp_thread_num] = libsais16x64_count_marked(B, omp_block_start, omp_block_size);
+
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                fast_sint_t t, c = 0; for (t = 0; t < omp_num_threads; ++t) { fast_sint_t m = counts[t]; counts[t] = c; c += m; }
+
+                count = c;
+            }
+
+            #pragma omp barrier
+
+            libsais16x64_compute_lcp_marked(T, PLCP, SA, B, LCP, n, r, counts[omp_thread_num], omp_block_start, omp_block_size);
+        }
+#endif
+    }
+
+#if defined(LIBSAIS_OPENMP)
+    libsais16x64_free_aligned(counts);
+#endif
+
+    return (sa_sint_t)count;
+}
+
+static fast_sint_t libsais16x64_compute_lcp_8u(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, uint8_t * RESTRICT LCP, sa_sint_t * RESTRICT X, fast_sint_t xs, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j, c = 0;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais16x64_prefetchr(&SA[i + 2 * prefetch_distance]);
+        libsais16x64_prefetchr(&PLCP[SA[i + prefetch_distance]]);
+
+        sa_sint_t l = PLCP[SA[i]];
+        if (l < UINT8_MAX) { LCP[i] = (uint8_t)l; } else { LCP[i] = UINT8_MAX; if (c < xs) { X[2 * c + 0] = (sa_sint_t)i; X[2 * c + 1] = l; } c++; }
+    }
+
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        sa_sint_t l = PLCP[SA[i]];
+        if (l < UINT8_MAX) { LCP[i] = (uint8_t)l; } else { LCP[i] = UINT8_MAX; if (c < xs) { X[2 * c + 0] = (sa_sint_t)i; X[2 * c + 1] = l; } c++; }
+    }
+
+    return c;
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+static void libsais16x64_gather_lcp_8u_exceptions(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, const uint8_t * RESTRICT LCP, sa_sint_t * RESTRICT X, fast_sint_t xs, fast_sint_t c, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size; i < j && c < xs; i += 1)
+    {
+        if (LCP[i] == UINT8_MAX) { X[2 * c + 0] = (sa_sint_t)i; X[2 * c + 1] = PLCP[SA[i]]; c++; }
+    }
+}
+
+#endif
 
-    libsais16x64_free_aligned(buckets);
-    libsais16x64_free_aligned(fastbits);
-    libsais16x64_free_aligned(bucket2);
+static sa_sint_t libsais16x64_compute_lcp_8u_omp(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, uint8_t * RESTRICT LCP, sa_sint_t n, sa_sint_t * RESTRICT X, sa_sint_t xs, sa_sint_t threads)
+{
+    fast_sint_t count = 0;
+
+#if defined(LIBSAIS_OPENMP)
+    fast_sint_t * RESTRICT counts = threads > 1 && n >= 65536 ? (fast_sint_t *)libsais16x64_alloc_aligned((size_t)threads * sizeof(fast_sint_t), 64) : NULL;
+    if (threads > 1 && n >= 65536 && counts == NULL) { return -2; }
+
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        if (omp_num_threads == 1)
+        {
+            count = libsais16x64_compute_lcp_8u(PLCP, SA, LCP, X, xs, omp_block_start, omp_block_size);
+        }
+#if defined(LIBSAIS_OPENMP)
+        else
+        {
+            counts[omp_thread_num] = libsais16x64_compute_lcp_8u(PLCP, SA, LCP, X, 0, omp_block_start, omp_block_size);
+
+            #pragma omp barrier
+
+            fast_sint_t t, c = 0; for (t = 0; t < omp_thread_num; ++t) { c += counts[t]; }
+
+            libsais16x64_gather_lcp_8u_exceptions(PLCP, SA, LCP, X, xs, c, omp_block_start, omp_block_size);
+
+            if (omp_thread_num == omp_num_threads - 1) { count = c + counts[omp_thread_num]; }
+        }
+#endif
+    }
+
+#if defined(LIBSAIS_OPENMP)
+    libsais16x64_free_aligned(counts);
+#endif
+
+    return (sa_sint_t)count;
+}
+
+int64_t libsais16x64_plcp(const uint16_t * T, const int64_t * SA, int64_t * PLCP, int64_t n)
+{
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { PLCP[0] = 0; }
+        return 0;
+    }
+
+    libsais16x64_compute_phi_omp(SA, PLCP, n, 1);
+    libsais16x64_compute_plcp_omp(T, PLCP, n, 1);
+
+    return 0;
+}
+
+int64_t libsais16x64_plcp_gsa(const uint16_t * T, const int64_t * SA, int64_t * PLCP, int64_t n)
+{
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { PLCP[0] = 0; }
+        return 0;
+    }
+
+    libsais16x64_compute_phi_omp(SA, PLCP, n, 1);
+    libsais16x64_compute_plcp_gsa_omp(T, PLCP, n, 1);
+
+    return 0;
+}
+
+int64_t libsais16x64_lcp(const int64_t * PLCP, const int64_t * SA, int64_t * LCP, int64_t n)
+{
+    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { LCP[0] = PLCP[SA[0]]; }
+        return 0;
+    }
+
+    libsais16x64_compute_lcp_omp(PLCP, SA, LCP, n, 1);
+
+    return 0;
+}
+
+int64_t libsais16x64_plcp_sampled(const uint16_t * T, const int64_t * SA, int64_t * PLCP, int64_t n, int64_t r)
+{
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (r <= 0) || ((r & (r - 1)) != 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { PLCP[0] = 0; }
+        return 0;
+    }
+
+    libsais16x64_compute_phi_sampled_omp(SA, PLCP, n, r, 1);
+    libsais16x64_compute_plcp_sampled_omp(T, PLCP, n, r, 1);
+
+    return 0;
+}
+
+int64_t libsais16x64_lcp_sampled(const uint16_t * T, const int64_t * PLCP, const int64_t * SA, int64_t * LCP, int64_t n, int64_t r, int64_t k)
+{
+    if ((T == NULL) || (PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (r <= 0) || ((r & (r - 1)) != 0) || (k <= 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { LCP[0] = 0; }
+        return 0;
+    }
+
+    libsais16x64_compute_lcp_sampled_omp(T, PLCP, SA, LCP, n, r, k, 1);
+
+    return 0;
+}
+
+int64_t libsais16x64_lcp_marked(const uint16_t * T, const int64_t * PLCP, const int64_t * SA, const uint8_t * B, int64_t * LCP, int64_t n, int64_t r)
+{
+    if ((T == NULL) || (PLCP == NULL) || (SA == NULL) || (B == NULL) || (LCP == NULL) || (n < 0) || (r <= 0) || ((r & (r - 1)) != 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1 && (B[0] & 1)) { LCP[0] = 0; return 1; }
+        return 0;
+    }
+
+    return libsais16x64_compute_lcp_marked_omp(T, PLCP, SA, B, LCP, n, r, 1);
+}
+
+int64_t libsais16x64_lcp_8u(const int64_t * PLCP, const int64_t * SA, uint8_t * LCP, int64_t n, int64_t * X, int64_t xs)
+{
+    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (xs < 0) || (X == NULL && xs > 0))
+    {
+        return -1;
+    }
+
+    return libsais16x64_compute_lcp_8u_omp(PLCP, SA, LCP, n, X, xs, 1);
+}
+
+int64_t libsais16x64_isa(const int64_t * SA, int64_t * ISA, int64_t n)
+{
+    if ((SA == NULL) || (ISA == NULL) || (n < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { ISA[0] = 0; }
+        return 0;
+    }
+
+    libsais16x64_compute_isa_omp(SA, ISA, n, 1);
+
+    return 0;
+}
+
+int64_t libsais16x64_sa_lcp(const uint16_t * T, int64_t * SA, int64_t * LCP, int64_t n, int64_t fs, int64_t * freq)
+{
+    if ((T == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { SA[0] = 0; LCP[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    if (n <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        sa_sint_t index = libsais16_sa_lcp(T, (int32_t *)SA, (int32_t *)LCP, (int32_t)n, (int32_t)new_fs, (int32_t *)freq);
+
+        if (index >= 0)
+        {
+            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)SA, n, 1);
+            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)LCP, n, 1);
+            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, 1); }
+        }
+
+        return index;
+    }
+
+    sa_sint_t index = libsais16x64_main(T, SA, n, 0, 0, NULL, NULL, fs, freq, 1);
+    if (index == 0)
+    {
+        libsais16x64_compute_sa_lcp_omp(T, SA, LCP, n, fs, 1);
+    }
+
+    return index;
+}
+
+int64_t libsais16x64_sa_lcp_ctx(const void * ctx, const uint16_t * T, int64_t * SA, int64_t * LCP, int64_t n, int64_t fs, int64_t * freq)
+{
+    if ((ctx == NULL) || (T == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { SA[0] = 0; LCP[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    const LIBSAIS_CONTEXT * RESTRICT context = (const LIBSAIS_CONTEXT *)ctx;
+
+    if (n <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        libsais16x64_numa_place_omp(context, SA, n, fs);
+        sa_sint_t index = libsais16_sa_lcp_ctx(context->ctx32, T, (int32_t *)SA, (int32_t *)LCP, (int32_t)n, (int32_t)new_fs, (int32_t *)freq);
+
+        if (index >= 0)
+        {
+            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)SA, n, (sa_sint_t)context->threads);
+            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)LCP, n, (sa_sint_t)context->threads);
+            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, (sa_sint_t)context->threads); }
+        }
+
+        return libsais16x64_ctx_status(context, index);
+    }
+
+    sa_sint_t index = libsais16x64_main_ctx(context, T, SA, n, 0, 0, NULL, NULL, fs, freq);
+    if (index == 0)
+    {
+        libsais16x64_compute_sa_lcp_omp(T, SA, LCP, n, fs, (sa_sint_t)context->threads);
+    }
+
+    return index;
+}
+
+int64_t libsais16x64_pack_40u(int64_t * A, int64_t n)
+{
+    if ((A == NULL) || (n < 0) || (n > LIBSAIS_40U_MAX))
+    {
+        return -1;
+    }
+
+    libsais16x64_convert_inplace_64u_to_40u_omp(A, n, 1);
+
+    return 0;
+}
+
+int64_t libsais16x64_unpack_40u(int64_t * A, int64_t n)
+{
+    if ((A == NULL) || (n < 0) || (n > LIBSAIS_40U_MAX))
+    {
+        return -1;
+    }
+
+    libsais16x64_convert_inplace_40u_to_64u_omp(A, n, 1);
+
+    return 0;
+}
+
+int64_t libsais16x64_plcp_40u(const uint16_t * T, const uint8_t * SA, uint8_t * PLCP, int64_t n)
+{
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (n >= LIBSAIS_40U_MAX))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { libsais16x64_store_40u(PLCP, 0, 0); }
+        return 0;
+    }
+
+    libsais16x64_compute_phi_40u_omp(SA, PLCP, n, 1);
+    libsais16x64_compute_plcp_40u_omp(T, PLCP, n, 1);
+
+    return 0;
+}
+
+int64_t libsais16x64_lcp_40u(const uint8_t * PLCP, const uint8_t * SA, uint8_t * LCP, int64_t n)
+{
+    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (n > LIBSAIS_40U_MAX))
+    {
+        return -1;
+    }
+
+    libsais16x64_compute_lcp_40u_omp(PLCP, SA, LCP, n, 1);
+
+    return 0;
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+int64_t libsais16x64_plcp_omp(const uint16_t * T, const int64_t * SA, int64_t * PLCP, int64_t n, int64_t threads)
+{
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { PLCP[0] = 0; }
+        return 0;
+    }
+    
+    threads = threads > 0 ? threads : omp_get_max_threads();
 
-    return index;
-}
+    libsais16x64_compute_phi_omp(SA, PLCP, n, threads);
+    libsais16x64_compute_plcp_omp(T, PLCP, n, threads);
 
-int64_t libsais16x64_unbwt(const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t i)
-{
-    return libsais16x64_unbwt_aux(T, U, A, n, freq, n, &i);
+    return 0;
 }
 
-int64_t libsais16x64_unbwt_aux(const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t r, const int64_t * I)
+int64_t libsais16x64_plcp_gsa_omp(const uint16_t * T, const int64_t * SA, int64_t * PLCP, int64_t n, int64_t threads)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL))
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (threads < 0))
     {
         return -1;
     }
     else if (n <= 1)
     {
-        if (I[0] != n) { return -1; }
-        if (n == 1) { U[0] = T[0]; }
+        if (n == 1) { PLCP[0] = 0; }
         return 0;
     }
+    
+    threads = threads > 0 ? threads : omp_get_max_threads();
 
-    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+    libsais16x64_compute_phi_omp(SA, PLCP, n, threads);
+    libsais16x64_compute_plcp_gsa_omp(T, PLCP, n, threads);
 
-    if (n <= INT32_MAX && r <= INT32_MAX && (n - 1) / r < 1024)
-    {
-        int32_t indexes[1024]; for (t = 0; t <= (n - 1) / r; ++t) { indexes[t] = (int32_t)I[t]; }
+    return 0;
+}
 
-        return libsais16_unbwt_aux(T, U, (int32_t *)A, (int32_t)n, NULL, (int32_t)r, indexes);
+int64_t libsais16x64_lcp_omp(const int64_t * PLCP, const int64_t * SA, int64_t * LCP, int64_t n, int64_t threads)
+{
+    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { LCP[0] = PLCP[SA[0]]; }
+        return 0;
     }
 
-    return libsais16x64_unbwt_main(T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, 1);
-}
+    threads = threads > 0 ? threads : omp_get_max_threads();
 
-#if defined(LIBSAIS_OPENMP)
+    libsais16x64_compute_lcp_omp(PLCP, SA, LCP, n, threads);
 
-int64_t libsais16x64_unbwt_omp(const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t i, int64_t threads)
-{
-    return libsais16x64_unbwt_aux_omp(T, U, A, n, freq, n, &i, threads);
+    return 0;
 }
 
-int64_t libsais16x64_unbwt_aux_omp(const uint16_t * T, uint16_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t r, const int64_t * I, int64_t threads)
+int64_t libsais16x64_plcp_sampled_omp(const uint16_t * T, const int64_t * SA, int64_t * PLCP, int64_t n, int64_t r, int64_t threads)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (threads < 0))
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (r <= 0) || ((r & (r - 1)) != 0) || (threads < 0))
     {
         return -1;
     }
     else if (n <= 1)
     {
-        if (I[0] != n) { return -1; }
-        if (n == 1) { U[0] = T[0]; }
+        if (n == 1) { PLCP[0] = 0; }
         return 0;
     }
 
-    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
-
-    if (n <= INT32_MAX && r <= INT32_MAX && (n - 1) / r < 1024)
-    {
-        int32_t indexes[1024]; for (t = 0; t <= (n - 1) / r; ++t) { indexes[t] = (int32_t)I[t]; }
+    threads = threads > 0 ? threads : omp_get_max_threads();
 
-        return libsais16_unbwt_aux_omp(T, U, (int32_t *)A, (int32_t)n, NULL,(int32_t)r, indexes, (int32_t)threads);
-    }
+    libsais16x64_compute_phi_sampled_omp(SA, PLCP, n, r, threads);
+    libsais16x64_compute_plcp_sampled_omp(T, PLCP, n, r, threads);
 
-    threads = threads > 0 ? threads : omp_get_max_threads();
-    return libsais16x64_unbwt_main(T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, threads);
+    return 0;
 }
 
-#endif
-
-static void libsais16x64_compute_phi(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+int64_t libsais16x64_lcp_sampled_omp(const uint16_t * T, const int64_t * PLCP, const int64_t * SA, int64_t * LCP, int64_t n, int64_t r, int64_t k, int64_t threads)
 {
-    const fast_sint_t prefetch_distance = 32;
-
-    fast_sint_t i, j; sa_sint_t k = omp_block_start > 0 ? SA[omp_block_start - 1] : n;
-    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
+    if ((T == NULL) || (PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (r <= 0) || ((r & (r - 1)) != 0) || (k <= 0) || (threads < 0))
     {
-        libsais16x64_prefetchr(&SA[i + 2 * prefetch_distance]);
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { LCP[0] = 0; }
+        return 0;
+    }
 
-        libsais16x64_prefetchw(&PLCP[SA[i + prefetch_distance + 0]]);
-        libsais16x64_prefetchw(&PLCP[SA[i + prefetch_distance + 1]]);
+    threads = threads > 0 ? threads : omp_get_max_threads();
 
-        PLCP[SA[i + 0]] = k; k = SA[i + 0];
-        PLCP[SA[i + 1]] = k; k = SA[i + 1];
+    libsais16x64_compute_lcp_sampled_omp(T, PLCP, SA, LCP, n, r, k, threads);
 
-        libsais16x64_prefetchw(&PLCP[SA[i + prefetch_distance + 2]]);
-        libsais16x64_prefetchw(&PLCP[SA[i + prefetch_distance + 3]]);
+    return 0;
+}
 
-        PLCP[SA[i + 2]] = k; k = SA[i + 2];
-        PLCP[SA[i + 3]] = k; k = SA[i + 3];
+int64_t libsais16x64_lcp_marked_omp(const uint16_t * T, const int64_t * PLCP, const int64_t * SA, const uint8_t * B, int64_t * LCP, int64_t n, int64_t r, int64_t threads)
+{
+    if ((T == NULL) || (PLCP == NULL) || (SA == NULL) || (B == NULL) || (LCP == NULL) || (n < 0) || (r <= 0) || ((r & (r - 1)) != 0) || (threads < 0))
+    {
+        return -1;
     }
-
-    for (j += prefetch_distance + 3; i < j; i += 1)
+    else if (n <= 1)
     {
-        PLCP[SA[i]] = k; k = SA[i];
+        if (n == 1 && (B[0] & 1)) { LCP[0] = 0; return 1; }
+        return 0;
     }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais16x64_compute_lcp_marked_omp(T, PLCP, SA, B, LCP, n, r, threads);
 }
 
-static void libsais16x64_compute_phi_omp(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+int64_t libsais16x64_lcp_8u_omp(const int64_t * PLCP, const int64_t * SA, uint8_t * LCP, int64_t n, int64_t * X, int64_t xs, int64_t threads)
 {
-#if defined(LIBSAIS_OPENMP)
-    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
-#endif
+    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (xs < 0) || (X == NULL && xs > 0) || (threads < 0))
     {
-#if defined(LIBSAIS_OPENMP)
-        fast_sint_t omp_thread_num    = omp_get_thread_num();
-        fast_sint_t omp_num_threads   = omp_get_num_threads();
-#else
-        UNUSED(threads);
+        return -1;
+    }
 
-        fast_sint_t omp_thread_num    = 0;
-        fast_sint_t omp_num_threads   = 1;
-#endif
-        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
-        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
-        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+    threads = threads > 0 ? threads : omp_get_max_threads();
 
-        libsais16x64_compute_phi(SA, PLCP, n, omp_block_start, omp_block_size);
-    }
+    return libsais16x64_compute_lcp_8u_omp(PLCP, SA, LCP, n, X, xs, threads);
 }
 
-static void libsais16x64_compute_plcp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, fast_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+int64_t libsais16x64_isa_omp(const int64_t * SA, int64_t * ISA, int64_t n, int64_t threads)
 {
-    const fast_sint_t prefetch_distance = 32;
-
-    fast_sint_t i, j, l = 0;
-    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    if ((SA == NULL) || (ISA == NULL) || (n < 0) || (threads < 0))
     {
-        libsais16x64_prefetchw(&PLCP[i + 2 * prefetch_distance]);
-        libsais16x64_prefetchr(&T[PLCP[i + prefetch_distance] + l]);
-
-        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
-        while (l < m && T[i + l] == T[k + l]) { l++; }
-
-        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+        return -1;
     }
-
-    for (j += prefetch_distance; i < j; i += 1)
+    else if (n <= 1)
     {
-        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
-        while (l < m && T[i + l] == T[k + l]) { l++; }
-
-        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+        if (n == 1) { ISA[0] = 0; }
+        return 0;
     }
-}
 
-static void libsais16x64_compute_plcp_omp(const uint16_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
-{
-#if defined(LIBSAIS_OPENMP)
-    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
-#endif
-    {
-#if defined(LIBSAIS_OPENMP)
-        fast_sint_t omp_thread_num    = omp_get_thread_num();
-        fast_sint_t omp_num_threads   = omp_get_num_threads();
-#else
-        UNUSED(threads);
+    threads = threads > 0 ? threads : omp_get_max_threads();
 
-        fast_sint_t omp_thread_num    = 0;
-        fast_sint_t omp_num_threads   = 1;
-#endif
-        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
-        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
-        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+    libsais16x64_compute_isa_omp(SA, ISA, n, threads);
 
-        libsais16x64_compute_plcp(T, PLCP, n, omp_block_start, omp_block_size);
-    }
+    return 0;
 }
 
-static void libsais16x64_compute_lcp(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+int64_t libsais16x64_sa_lcp_omp(const uint16_t * T, int64_t * SA, int64_t * LCP, int64_t n, int64_t fs, int64_t * freq, int64_t threads)
 {
-    const fast_sint_t prefetch_distance = 32;
-
-    fast_sint_t i, j;
-    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
+    if ((T == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (fs < 0) || (threads < 0))
     {
-        libsais16x64_prefetchr(&SA[i + 2 * prefetch_distance]);
-        libsais16x64_prefetchw(&LCP[i + prefetch_distance]);
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { SA[0] = 0; LCP[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
 
-        libsais16x64_prefetchr(&PLCP[SA[i + prefetch_distance + 0]]);
-        libsais16x64_prefetchr(&PLCP[SA[i + prefetch_distance + 1]]);
+    threads = threads > 0 ? threads : omp_get_max_threads();
 
-        LCP[i + 0] = PLCP[SA[i + 0]];
-        LCP[i + 1] = PLCP[SA[i + 1]];
+    if (n <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        sa_sint_t index = libsais16_sa_lcp_omp(T, (int32_t *)SA, (int32_t *)LCP, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)threads);
 
-        libsais16x64_prefetchr(&PLCP[SA[i + prefetch_distance + 2]]);
-        libsais16x64_prefetchr(&PLCP[SA[i + prefetch_distance + 3]]);
+        if (index >= 0)
+        {
+            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)SA, n, threads);
+            libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)LCP, n, threads);
+            if (freq != NULL) { libsais16x64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, threads); }
+        }
 
-        LCP[i + 2] = PLCP[SA[i + 2]];
-        LCP[i + 3] = PLCP[SA[i + 3]];
+        return index;
     }
 
-    for (j += prefetch_distance + 3; i < j; i += 1)
+    sa_sint_t index = libsais16x64_main(T, SA, n, 0, 0, NULL, NULL, fs, freq, threads);
+    if (index == 0)
     {
-        LCP[i] = PLCP[SA[i]];
+        libsais16x64_compute_sa_lcp_omp(T, SA, LCP, n, fs, threads);
     }
-}
-
-static void libsais16x64_compute_lcp_omp(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, sa_sint_t n, sa_sint_t threads)
-{
-#if defined(LIBSAIS_OPENMP)
-    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
-#endif
-    {
-#if defined(LIBSAIS_OPENMP)
-        fast_sint_t omp_thread_num    = omp_get_thread_num();
-        fast_sint_t omp_num_threads   = omp_get_num_threads();
-#else
-        UNUSED(threads);
 
-        fast_sint_t omp_thread_num    = 0;
-        fast_sint_t omp_num_threads   = 1;
-#endif
-        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
-        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
-        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
-
-        libsais16x64_compute_lcp(PLCP, SA, LCP, omp_block_start, omp_block_size);
-    }
+    return index;
 }
 
-int64_t libsais16x64_plcp(const uint16_t * T, const int64_t * SA, int64_t * PLCP, int64_t n)
+int64_t libsais16x64_pack_40u_omp(int64_t * A, int64_t n, int64_t threads)
 {
-    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0))
+    if ((A == NULL) || (n < 0) || (n > LIBSAIS_40U_MAX) || (threads < 0))
     {
         return -1;
     }
-    else if (n <= 1)
-    {
-        if (n == 1) { PLCP[0] = 0; }
-        return 0;
-    }
 
-    libsais16x64_compute_phi_omp(SA, PLCP, n, 1);
-    libsais16x64_compute_plcp_omp(T, PLCP, n, 1);
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    libsais16x64_convert_inplace_64u_to_40u_omp(A, n, threads);
 
     return 0;
 }
 
-int64_t libsais16x64_lcp(const int64_t * PLCP, const int64_t * SA, int64_t * LCP, int64_t n)
+int64_t libsais16x64_unpack_40u_omp(int64_t * A, int64_t n, int64_t threads)
 {
-    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0))
+    if ((A == NULL) || (n < 0) || (n > LIBSAIS_40U_MAX) || (threads < 0))
     {
         return -1;
     }
-    else if (n <= 1)
-    {
-        if (n == 1) { LCP[0] = PLCP[SA[0]]; }
-        return 0;
-    }
 
-    libsais16x64_compute_lcp_omp(PLCP, SA, LCP, n, 1);
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    libsais16x64_convert_inplace_40u_to_64u_omp(A, n, threads);
 
     return 0;
 }
 
-#if defined(LIBSAIS_OPENMP)
-
-int64_t libsais16x64_plcp_omp(const uint16_t * T, const int64_t * SA, int64_t * PLCP, int64_t n, int64_t threads)
+int64_t libsais16x64_plcp_40u_omp(const uint16_t * T, const uint8_t * SA, uint8_t * PLCP, int64_t n, int64_t threads)
 {
-    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (threads < 0))
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (n >= LIBSAIS_40U_MAX) || (threads < 0))
     {
         return -1;
     }
     else if (n <= 1)
     {
-        if (n == 1) { PLCP[0] = 0; }
+        if (n == 1) { libsais16x64_store_40u(PLCP, 0, 0); }
         return 0;
     }
-    
+
     threads = threads > 0 ? threads : omp_get_max_threads();
 
-    libsais16x64_compute_phi_omp(SA, PLCP, n, threads);
-    libsais16x64_compute_plcp_omp(T, PLCP, n, threads);
+    libsais16x64_compute_phi_40u_omp(SA, PLCP, n, threads);
+    libsais16x64_compute_plcp_40u_omp(T, PLCP, n, threads);
 
     return 0;
 }
 
-int64_t libsais16x64_lcp_omp(const int64_t * PLCP, const int64_t * SA, int64_t * LCP, int64_t n, int64_t threads)
+int64_t libsais16x64_lcp_40u_omp(const uint8_t * PLCP, const uint8_t * SA, uint8_t * LCP, int64_t n, int64_t threads)
 {
-    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (threads < 0))
+    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (n > LIBSAIS_40U_MAX) || (threads < 0))
     {
         return -1;
     }
-    else if (n <= 1)
-    {
-        if (n == 1) { LCP[0] = PLCP[SA[0]]; }
-        return 0;
-    }
 
     threads = threads > 0 ? threads : omp_get_max_threads();
 
-    libsais16x64_compute_lcp_omp(PLCP, SA, LCP, n, threads);
+    libsais16x64_compute_lcp_40u_omp(PLCP, SA, LCP, n, threads);
 
     return 0;
 }
@@ -46,16 +46,45 @@ typedef uint64_t                        fast_uint_t;
 #define SAINT_MIN                       INT64_MIN
 
 #define ALPHABET_SIZE                   (1 << CHAR_BIT)
-#define UNBWT_FASTBITS                  (17)
+
+#if !defined(UNBWT_FASTBITS)
+    #define UNBWT_FASTBITS                 (17)
+#endif
+
+#define UNBWT_FASTBITS_MIN             (8)
+#define UNBWT_FASTBITS_MAX             (24)
+
+#if !defined(UNBWT_SPLITTERS_MIN_THREADS)
+    #define UNBWT_SPLITTERS_MIN_THREADS    (4)
+#endif
+
+#if !defined(UNBWT_SPLITTERS_MIN_SIZE)
+    #define UNBWT_SPLITTERS_MIN_SIZE       (1 << 21)
+#endif
 
 #define SUFFIX_GROUP_BIT                (SAINT_BIT - 1)
 #define SUFFIX_GROUP_MARKER             (((sa_sint_t)1) << (SUFFIX_GROUP_BIT - 1))
 
+#define LIBSAIS_40U_MAX                 (((sa_sint_t)1) << 40)
+
 #define BUCKETS_INDEX2(_c, _s)          ((((fast_sint_t)_c) << 1) + (fast_sint_t)(_s))
 #define BUCKETS_INDEX4(_c, _s)          ((((fast_sint_t)_c) << 2) + (fast_sint_t)(_s))
 
-#define LIBSAIS_LOCAL_BUFFER_SIZE       (1024)
-#define LIBSAIS_PER_THREAD_CACHE_SIZE   (24576)
+#if !defined(LIBSAIS_LOCAL_BUFFER_SIZE)
+    #define LIBSAIS_LOCAL_BUFFER_SIZE      (1024)
+#endif
+
+#if !defined(LIBSAIS_PER_THREAD_CACHE_SIZE)
+    #define LIBSAIS_PER_THREAD_CACHE_SIZE  (24576)
+#endif
+
+#if !defined(LIBSAIS_NUMA_PAGE_SIZE)
+    #define LIBSAIS_NUMA_PAGE_SIZE         (4096)
+#endif
+
+#if !defined(LIBSAIS_PREFETCH_DISTANCE)
+    #define LIBSAIS_PREFETCH_DISTANCE      (32)
+#endif
 
 typedef struct LIBSAIS_THREAD_CACHE
 {
@@ -75,16 +104,49 @@ typedef union LIBSAIS_THREAD_STATE
 
         sa_sint_t *                     buckets;
         LIBSAIS_THREAD_CACHE *          cache;
+        fast_sint_t                     cache_size;
+        struct LIBSAIS_MONITOR *        monitor;
     } state;
 
     uint8_t padding[64];
 } LIBSAIS_THREAD_STATE;
 
+typedef struct LIBSAIS_ALLOCATOR
+{
+    void *                              (* alloc)(size_t size, size_t alignment, void * opaque);
+    void                                (* free)(void * address, void * opaque);
+    void *                              opaque;
+} LIBSAIS_ALLOCATOR;
+
+typedef struct LIBSAIS_MONITOR
+{
+    void                                (* profile)(int32_t phase, int32_t end, int32_t depth, int64_t n, int64_t k, int32_t flags, void * opaque);
+    void *                              profile_opaque;
+    int32_t                             (* cancel)(void * opaque);
+    void *                              cancel_opaque;
+    sa_sint_t                           cancelled;
+    sa_sint_t                           thread_block_size;
+} LIBSAIS_MONITOR;
+
+typedef struct LIBSAIS_ARENA
+{
+    uint8_t *                           memory;
+    size_t                              size;
+    size_t                              used;
+    sa_sint_t                           exhausted;
+} LIBSAIS_ARENA;
+
 typedef struct LIBSAIS_CONTEXT
 {
     sa_sint_t *                         buckets;
     LIBSAIS_THREAD_STATE *              thread_state;
     fast_sint_t                         threads;
+    sa_sint_t *                         local_buffer;
+    fast_sint_t                         local_buffer_size;
+    fast_sint_t                         numa;
+    void *                              ctx32;
+    LIBSAIS_ALLOCATOR                   allocator;
+    LIBSAIS_MONITOR                     monitor;
 } LIBSAIS_CONTEXT;
 
 typedef struct LIBSAIS_UNBWT_CONTEXT
@@ -92,9 +154,46 @@ typedef struct LIBSAIS_UNBWT_CONTEXT
     sa_uint_t *                         bucket2;
     uint16_t *                          fastbits;
     sa_uint_t *                         buckets;
+    fast_sint_t                         fastbits_log;
     fast_sint_t                         threads;
+    void *                              ctx32;
+    LIBSAIS_ALLOCATOR                   allocator;
 } LIBSAIS_UNBWT_CONTEXT;
 
+#define LIBSAIS_UNBWT_INDEX_MAGIC           (0x343638304955534cULL)
+
+typedef struct LIBSAIS_UNBWT_INDEX
+{
+    uint64_t                    magic;
+    int64_t                     n;
+    int64_t                     r;
+    int64_t                     lastc;
+    int64_t                     reserved[4];
+} LIBSAIS_UNBWT_INDEX;
+
+#define LIBSAIS_STREAM_MIN_COVER            (64)
+#define LIBSAIS_STREAM_MAX_COVER            (4096)
+
+typedef struct LIBSAIS_STREAM
+{
+    const uint8_t *             T;
+    fast_sint_t                 n;
+    fast_sint_t                 v;
+    fast_sint_t                 shift;
+    sa_sint_t *                 rank;
+    sa_sint_t *                 names;
+    sa_sint_t *                 block;
+    fast_sint_t                 block_size;
+    fast_sint_t                 emitted;
+    sa_sint_t                   index;
+    uint64_t                    seed;
+    int32_t                     (* write_sa)(const int64_t * SA, int64_t count, void * opaque);
+    int32_t                     (* write_bwt)(const uint8_t * U, int64_t count, void * opaque);
+    void *                      opaque;
+    fast_sint_t                 delta[LIBSAIS_STREAM_MAX_COVER];
+    fast_sint_t                 offset[LIBSAIS_STREAM_MAX_COVER];
+} LIBSAIS_STREAM;
+
 #if defined(__GNUC__) || defined(__clang__)
     #define RESTRICT __restrict__
 #elif defined(_MSC_VER) || defined(__INTEL_COMPILER)
@@ -115,8 +214,12 @@ typedef struct LIBSAIS_UNBWT_CONTEXT
     #if __has_builtin(__builtin_bswap16)
         #define HAS_BUILTIN_BSWAP16
     #endif
+    #if __has_builtin(__builtin_bswap64)
+        #define HAS_BUILTIN_BSWAP64
+    #endif
 #elif defined(__GNUC__) && (((__GNUC__ == 4) && (__GNUC_MINOR__ >= 8)) || (__GNUC__ >= 5))
     #define HAS_BUILTIN_BSWAP16
+    #define HAS_BUILTIN_BSWAP64
 #endif
 
 #if defined(HAS_BUILTIN_PREFETCH)
@@ -164,12 +267,62 @@ typedef struct LIBSAIS_UNBWT_CONTEXT
     #else
         #define libsais64_bswap16(x) ((uint16_t)(x >> 8) | (uint16_t)(x << 8))
     #endif
+    #if defined(HAS_BUILTIN_BSWAP64)
+        #define libsais64_bswap64(x) (__builtin_bswap64(x))
+    #elif defined(_MSC_VER) && !defined(__INTEL_COMPILER)
+        #define libsais64_bswap64(x) (_byteswap_uint64(x))
+    #else
+        #define libsais64_bswap64(x) (((uint64_t)libsais64_bswap16((uint16_t)(x)) << 48) | ((uint64_t)libsais64_bswap16((uint16_t)((x) >> 16)) << 32) | ((uint64_t)libsais64_bswap16((uint16_t)((x) >> 32)) << 16) | (uint64_t)libsais64_bswap16((uint16_t)((x) >> 48)))
+    #endif
 #elif !defined(__LITTLE_ENDIAN__) && defined(__BIG_ENDIAN__)
     #define libsais64_bswap16(x) (x)
+    #define libsais64_bswap64(x) (x)
 #else
     #error Your compiler, configuration or platform is not supported.
 #endif
 
+#if defined(LIBSAIS_SIMD)
+    #if defined(__x86_64__) || defined(__i386__) || defined(_M_AMD64) || defined(_M_IX86)
+        #if defined(__GNUC__) || defined(__clang__)
+            #include <immintrin.h>
+            #define LIBSAIS_SIMD_AVX2
+            #define LIBSAIS_SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+            #define LIBSAIS_SIMD_AVX512
+            #define LIBSAIS_SIMD_TARGET_AVX512 __attribute__((target("avx512f")))
+            #define LIBSAIS_SIMD_DETECT
+            #define libsais64_cpu_supports_avx2() (libsais64_avx2_supported)
+            #define libsais64_cpu_supports_avx512() (libsais64_avx512_supported)
+        #elif defined(_MSC_VER) && defined(__AVX2__)
+            #include <immintrin.h>
+            #define LIBSAIS_SIMD_AVX2
+            #define LIBSAIS_SIMD_TARGET_AVX2
+            #define libsais64_cpu_supports_avx2() (1)
+            #if defined(__AVX512F__)
+                #define LIBSAIS_SIMD_AVX512
+                #define LIBSAIS_SIMD_TARGET_AVX512
+                #define libsais64_cpu_supports_avx512() (1)
+            #endif
+        #endif
+    #elif defined(__aarch64__) || defined(_M_ARM64)
+        #include <arm_neon.h>
+        #define LIBSAIS_SIMD_NEON
+    #endif
+#endif
+
+#if defined(LIBSAIS_SIMD_DETECT)
+
+static int libsais64_avx2_supported = 0;
+static int libsais64_avx512_supported = 0;
+
+static void __attribute__((constructor)) libsais64_detect_simd(void)
+{
+    __builtin_cpu_init();
+    libsais64_avx2_supported = __builtin_cpu_supports("avx2") != 0;
+    libsais64_avx512_supported = __builtin_cpu_supports("avx512f") != 0;
+}
+
+#endif
+
 static void * libsais64_align_up(const void * address, size_t alignment)
 {
     return (void *)((((ptrdiff_t)address) + ((ptrdiff_t)alignment) - 1) & (-((ptrdiff_t)alignment)));
@@ -197,38 +350,353 @@ static void libsais64_free_aligned(void * aligned_address)
     }
 }
 
-static LIBSAIS_THREAD_STATE * libsais64_alloc_thread_state(sa_sint_t threads)
+static void * libsais64_alloc_memory(const LIBSAIS_ALLOCATOR * allocator, size_t size, size_t alignment)
+{
+    return allocator != NULL && allocator->alloc != NULL
+        ? allocator->alloc(size, alignment, allocator->opaque)
+        : libsais64_alloc_aligned(size, alignment);
+}
+
+static void libsais64_free_memory(const LIBSAIS_ALLOCATOR * allocator, void * address)
+{
+    if (allocator != NULL && allocator->alloc != NULL)
+    {
+        if (address != NULL) { allocator->free(address, allocator->opaque); }
+    }
+    else
+    {
+        libsais64_free_aligned(address);
+    }
+}
+
+static void * libsais64_arena_alloc(size_t size, size_t alignment, void * opaque)
+{
+    LIBSAIS_ARENA * RESTRICT arena = (LIBSAIS_ARENA *)opaque;
+
+    size_t offset = (size_t)((uint8_t *)libsais64_align_up(arena->memory + arena->used, alignment) - arena->memory);
+    if (offset > arena->size || size > arena->size - offset) { arena->exhausted = 1; return NULL; }
+
+    arena->used = offset + size;
+    return arena->memory + offset;
+}
+
+static void libsais64_arena_free(void * address, void * opaque)
+{
+    LIBSAIS_ARENA * RESTRICT arena = (LIBSAIS_ARENA *)opaque;
+
+    size_t offset = (size_t)((uint8_t *)address - arena->memory);
+    if (offset < arena->used) { arena->used = offset; }
+}
+
+static LIBSAIS_THREAD_STATE * libsais64_alloc_thread_state(sa_sint_t threads, const LIBSAIS_ALLOCATOR * allocator)
 {
-    LIBSAIS_THREAD_STATE *  RESTRICT thread_state    = (LIBSAIS_THREAD_STATE *)libsais64_alloc_aligned((size_t)threads * sizeof(LIBSAIS_THREAD_STATE), 4096);
-    sa_sint_t *             RESTRICT thread_buckets  = (sa_sint_t *)libsais64_alloc_aligned((size_t)threads * 4 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
-    LIBSAIS_THREAD_CACHE *  RESTRICT thread_cache    = (LIBSAIS_THREAD_CACHE *)libsais64_alloc_aligned((size_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE * sizeof(LIBSAIS_THREAD_CACHE), 4096);
+    LIBSAIS_THREAD_STATE *  RESTRICT thread_state    = (LIBSAIS_THREAD_STATE *)libsais64_alloc_memory(allocator, (size_t)threads * sizeof(LIBSAIS_THREAD_STATE), 4096);
+    sa_sint_t *             RESTRICT thread_buckets  = (sa_sint_t *)libsais64_alloc_memory(allocator, (size_t)threads * 4 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
+    LIBSAIS_THREAD_CACHE *  RESTRICT thread_cache    = (LIBSAIS_THREAD_CACHE *)libsais64_alloc_memory(allocator, (size_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE * sizeof(LIBSAIS_THREAD_CACHE), 4096);
 
     if (thread_state != NULL && thread_buckets != NULL && thread_cache != NULL)
     {
         fast_sint_t t;
         for (t = 0; t < threads; ++t)
         { 
-            thread_state[t].state.buckets   = thread_buckets;   thread_buckets  += 4 * ALPHABET_SIZE;
-            thread_state[t].state.cache     = thread_cache;     thread_cache    += LIBSAIS_PER_THREAD_CACHE_SIZE;
+            thread_state[t].state.buckets    = thread_buckets;   thread_buckets  += 4 * ALPHABET_SIZE;
+            thread_state[t].state.cache      = thread_cache;     thread_cache    += LIBSAIS_PER_THREAD_CACHE_SIZE;
+            thread_state[t].state.cache_size = LIBSAIS_PER_THREAD_CACHE_SIZE;
+            thread_state[t].state.monitor    = NULL;
         }
 
         return thread_state;
     }
 
-    libsais64_free_aligned(thread_cache);
-    libsais64_free_aligned(thread_buckets);
-    libsais64_free_aligned(thread_state);
+    libsais64_free_memory(allocator, thread_cache);
+    libsais64_free_memory(allocator, thread_buckets);
+    libsais64_free_memory(allocator, thread_state);
     return NULL;
 }
 
-static void libsais64_free_thread_state(LIBSAIS_THREAD_STATE * thread_state)
+static void libsais64_free_thread_state(LIBSAIS_THREAD_STATE * thread_state, const LIBSAIS_ALLOCATOR * allocator)
 {
     if (thread_state != NULL)
     {
-        libsais64_free_aligned(thread_state[0].state.cache);
-        libsais64_free_aligned(thread_state[0].state.buckets);
-        libsais64_free_aligned(thread_state);
+        libsais64_free_memory(allocator, thread_state[0].state.cache);
+        libsais64_free_memory(allocator, thread_state[0].state.buckets);
+        libsais64_free_memory(allocator, thread_state);
+    }
+}
+
+static LIBSAIS_CONTEXT * libsais64_create_ctx_main(sa_sint_t threads, const LIBSAIS_ALLOCATOR * allocator)
+{
+    LIBSAIS_CONTEXT *       RESTRICT ctx            = (LIBSAIS_CONTEXT *)libsais64_alloc_memory(allocator, sizeof(LIBSAIS_CONTEXT), 64);
+    sa_sint_t *             RESTRICT buckets        = (sa_sint_t *)libsais64_alloc_memory(allocator, (size_t)8 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
+    LIBSAIS_THREAD_STATE *  RESTRICT thread_state   = threads > 1 ? libsais64_alloc_thread_state(threads, allocator) : NULL;
+#if defined(LIBSAIS_OPENMP)
+    void *                           ctx32          = allocator != NULL && allocator->alloc != NULL
+        ? libsais_create_ctx_alloc_omp((int32_t)threads, allocator->alloc, allocator->free, allocator->opaque)
+        : libsais_create_ctx_omp((int32_t)threads);
+#else
+    void *                           ctx32          = allocator != NULL && allocator->alloc != NULL
+        ? libsais_create_ctx_alloc(allocator->alloc, allocator->free, allocator->opaque)
+        : libsais_create_ctx();
+#endif
+
+    if (ctx != NULL && buckets != NULL && (thread_state != NULL || threads == 1) && ctx32 != NULL)
+    {
+        ctx->buckets = buckets;
+        ctx->threads = threads;
+        ctx->thread_state = thread_state;
+        ctx->numa = LIBSAIS64_NUMA_NONE;
+        ctx->local_buffer = NULL;
+        ctx->local_buffer_size = LIBSAIS_LOCAL_BUFFER_SIZE;
+        ctx->ctx32 = ctx32;
+
+        if (allocator != NULL) { ctx->allocator = *allocator; } else { memset(&ctx->allocator, 0, sizeof(LIBSAIS_ALLOCATOR)); }
+        memset(&ctx->monitor, 0, sizeof(LIBSAIS_MONITOR));
+
+        return ctx;
+    }
+
+    libsais_free_ctx(ctx32);
+    libsais64_free_thread_state(thread_state, allocator);
+    libsais64_free_memory(allocator, buckets);
+    libsais64_free_memory(allocator, ctx);
+    return NULL;
+}
+
+static void libsais64_free_ctx_main(LIBSAIS_CONTEXT * ctx)
+{
+    if (ctx != NULL)
+    {
+        LIBSAIS_ALLOCATOR allocator = ctx->allocator;
+
+        libsais_free_ctx(ctx->ctx32);
+        libsais64_free_thread_state(ctx->thread_state, &allocator);
+        libsais64_free_memory(&allocator, ctx->local_buffer);
+        libsais64_free_memory(&allocator, ctx->buckets);
+        libsais64_free_memory(&allocator, ctx);
+    }
+}
+
+static LIBSAIS_CONTEXT * libsais64_create_ctx_buffer_main(sa_sint_t threads, void * buffer, size_t size)
+{
+    LIBSAIS_ARENA * RESTRICT arena = (LIBSAIS_ARENA *)libsais64_align_up(buffer, 64);
+
+    if (buffer != NULL && (size_t)((uint8_t *)(arena + 1) - (uint8_t *)buffer) <= size)
+    {
+        arena->memory       = (uint8_t *)(arena + 1);
+        arena->size         = size - (size_t)(arena->memory - (uint8_t *)buffer);
+        arena->used         = 0;
+        arena->exhausted    = 0;
+
+        LIBSAIS_ALLOCATOR allocator = { libsais64_arena_alloc, libsais64_arena_free, arena };
+        return libsais64_create_ctx_main(threads, &allocator);
+    }
+
+    return NULL;
+}
+
+static sa_sint_t libsais64_ctx_status(const LIBSAIS_CONTEXT * ctx, sa_sint_t index)
+{
+    if (ctx->allocator.alloc == libsais64_arena_alloc)
+    {
+        LIBSAIS_ARENA * RESTRICT arena = (LIBSAIS_ARENA *)ctx->allocator.opaque;
+
+        if (index == -2 && arena->exhausted) { index = -3; }
+        arena->exhausted = 0;
+    }
+
+    return index;
+}
+
+static void libsais64_profile(const LIBSAIS_MONITOR * monitor, sa_sint_t phase, sa_sint_t end, sa_sint_t depth, sa_sint_t n, sa_sint_t k, sa_sint_t flags)
+{
+    if (monitor != NULL && monitor->profile != NULL)
+    {
+        monitor->profile((int32_t)phase, (int32_t)end, (int32_t)depth, (int64_t)n, (int64_t)k, (int32_t)flags, monitor->profile_opaque);
+    }
+}
+
+static sa_sint_t libsais64_cancelled(LIBSAIS_MONITOR * monitor)
+{
+    if (monitor != NULL && monitor->cancel != NULL && monitor->cancelled == 0)
+    {
+        monitor->cancelled = monitor->cancel(monitor->cancel_opaque) != 0;
+    }
+
+    return monitor != NULL && monitor->cancelled != 0;
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+static void libsais64_numa_touch_pages(void * memory, fast_sint_t size, fast_sint_t start, fast_sint_t end, fast_sint_t page_start, fast_sint_t page_step)
+{
+    uint8_t * RESTRICT bytes = (uint8_t *)memory;
+    ptrdiff_t base = ((ptrdiff_t)bytes) & (-((ptrdiff_t)LIBSAIS_NUMA_PAGE_SIZE));
+
+    if (start < end && end <= size)
+    {
+        fast_sint_t p = (((ptrdiff_t)(bytes + start) - base) / LIBSAIS_NUMA_PAGE_SIZE);
+        fast_sint_t last = (((ptrdiff_t)(bytes + end - 1) - base) / LIBSAIS_NUMA_PAGE_SIZE);
+
+        if (page_step > 1) { p += (page_start - p % page_step + page_step) % page_step; }
+
+        for (; p <= last; p += page_step)
+        {
+            fast_sint_t offset = (fast_sint_t)(base + p * LIBSAIS_NUMA_PAGE_SIZE - (ptrdiff_t)bytes);
+            bytes[offset > start ? offset : start] = 0;
+        }
+    }
+}
+
+#endif
+
+static void libsais64_numa_place_thread_state(LIBSAIS_THREAD_STATE * RESTRICT thread_state, fast_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    if (thread_state != NULL && threads > 1)
+    {
+        #pragma omp parallel num_threads(threads)
+        {
+            fast_sint_t omp_thread_num = omp_get_thread_num();
+            fast_sint_t cache_size = thread_state[0].state.cache_size * (fast_sint_t)sizeof(LIBSAIS_THREAD_CACHE);
+
+            if (omp_thread_num < threads)
+            {
+                memset(thread_state[omp_thread_num].state.buckets, 0, (size_t)4 * ALPHABET_SIZE * sizeof(sa_sint_t));
+                libsais64_numa_touch_pages(thread_state[omp_thread_num].state.cache, cache_size, 0, cache_size, 0, 1);
+            }
+        }
+    }
+#else
+    UNUSED(thread_state); UNUSED(threads);
+#endif
+}
+
+static void libsais64_numa_place_omp(const LIBSAIS_CONTEXT * ctx, sa_sint_t * SA, sa_sint_t n, sa_sint_t fs)
+{
+#if defined(LIBSAIS_OPENMP)
+    if (ctx->numa != LIBSAIS64_NUMA_NONE && ctx->threads > 1 && n >= 65536)
+    {
+        fast_sint_t mode = ctx->numa, size = ((fast_sint_t)n + (fast_sint_t)fs) * (fast_sint_t)sizeof(sa_sint_t);
+
+        #pragma omp parallel num_threads(ctx->threads)
+        {
+            fast_sint_t omp_thread_num    = omp_get_thread_num();
+            fast_sint_t omp_num_threads   = omp_get_num_threads();
+            fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+            fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+            fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n + fs - omp_block_start;
+
+            if (mode == LIBSAIS64_NUMA_INTERLEAVE)
+            {
+                libsais64_numa_touch_pages(SA, size, 0, size, omp_thread_num, omp_num_threads);
+            }
+            else
+            {
+                libsais64_numa_touch_pages(SA, size, omp_block_start * (fast_sint_t)sizeof(sa_sint_t), (omp_block_start + omp_block_size) * (fast_sint_t)sizeof(sa_sint_t), 0, 1);
+            }
+        }
+    }
+#else
+    UNUSED(ctx); UNUSED(SA); UNUSED(n); UNUSED(fs);
+#endif
+}
+
+static int64_t libsais64_padded_size(int64_t size, int64_t alignment, fast_sint_t flags)
+{
+    return size > 0 ? size + (alignment - 1) + (flags != LIBSAIS64_FLAGS_BUFFER ? (int64_t)sizeof(short) : 0) : 0;
+}
+
+static int64_t libsais64_thread_state_size(fast_sint_t threads, fast_sint_t flags)
+{
+    int64_t size = 0;
+
+    if (threads > 1)
+    {
+        size += libsais64_padded_size((int64_t)threads * (int64_t)sizeof(LIBSAIS_THREAD_STATE), 4096, flags);
+        size += libsais64_padded_size((int64_t)threads * 4 * ALPHABET_SIZE * (int64_t)sizeof(sa_sint_t), 4096, flags);
+        size += libsais64_padded_size((int64_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE * (int64_t)sizeof(LIBSAIS_THREAD_CACHE), 4096, flags);
+    }
+
+    return size;
+}
+
+static int64_t libsais64_ctx_size_main(fast_sint_t threads)
+{
+    int64_t size = libsais64_padded_size((int64_t)sizeof(LIBSAIS_CONTEXT), 64, LIBSAIS64_FLAGS_CTX);
+
+    size += libsais64_padded_size((int64_t)8 * ALPHABET_SIZE * (int64_t)sizeof(sa_sint_t), 4096, LIBSAIS64_FLAGS_CTX);
+    size += libsais64_thread_state_size(threads, LIBSAIS64_FLAGS_CTX);
+    size += libsais_alloc_size(0, 0, (int32_t)threads);
+
+    return size;
+}
+
+static fast_sint_t libsais64_recursion_buffer_size(fast_sint_t n, fast_sint_t k, fast_sint_t fs, fast_sint_t threads, fast_sint_t local_buffer_size)
+{
+    fast_sint_t size = 0;
+
+    fs = fs < (SAINT_MAX - n) ? fs : (SAINT_MAX - n);
+
+    if (fs < k && (threads > 1 || local_buffer_size / k < 2)) { size = k; }
+
+    {
+        fast_sint_t m = n / 2, names = m - 1;
+        if (names > fs + n - 2 * m && (threads > 1 || local_buffer_size / names < 2) && names > size) { size = names; }
+    }
+
+    return size;
+}
+
+static fast_sint_t libsais64_alphabet_buffer_size(fast_sint_t n, fast_sint_t k, fast_sint_t fs)
+{
+    fs = fs < (SAINT_MAX - n) ? fs : (SAINT_MAX - n);
+
+    return k > 0 && fs / k < 6 ? (k > n + fs ? k : k < n ? k : n) : 0;
+}
+
+static int64_t libsais64_scratch_size_main(fast_sint_t n, fast_sint_t k, fast_sint_t fs, fast_sint_t threads, fast_sint_t flags)
+{
+    int64_t size = 0;
+
+    if (n >= 2)
+    {
+        int32_t flags32 = flags == LIBSAIS64_FLAGS_NONE ? LIBSAIS_FLAGS_NONE : LIBSAIS_FLAGS_CTX;
+
+        if (k == 0 && n <= INT32_MAX)
+        {
+            fast_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+            size += libsais_scratch_size((int32_t)n, 0, (int32_t)new_fs, (int32_t)threads, flags32);
+        }
+        else
+        {
+            fast_sint_t n32 = k > 0 ? n : n / 2; n32 = n32 < INT32_MAX ? n32 : INT32_MAX;
+            fast_sint_t k32 = k > n32 - 1 ? k : n32 - 1; k32 = k32 < INT32_MAX ? k32 : INT32_MAX;
+
+            int64_t buffer_size     = libsais64_padded_size((int64_t)libsais64_recursion_buffer_size(n, k, fs, threads, flags == LIBSAIS64_FLAGS_NONE ? LIBSAIS_LOCAL_BUFFER_SIZE : 0) * (int64_t)sizeof(sa_sint_t), 4096, flags);
+            int64_t delegated_size  = libsais_scratch_size((int32_t)n32, (int32_t)k32, 0, (int32_t)threads, flags32);
+
+            size += buffer_size > delegated_size ? buffer_size : delegated_size;
+            size += libsais64_padded_size((int64_t)libsais64_alphabet_buffer_size(n, k, fs) * (int64_t)sizeof(sa_sint_t), 4096, flags);
+
+            if (flags == LIBSAIS64_FLAGS_NONE)
+            {
+                size += libsais64_thread_state_size(threads, flags);
+                if (k == 0) { size += libsais64_padded_size((int64_t)8 * ALPHABET_SIZE * (int64_t)sizeof(sa_sint_t), 4096, flags); }
+            }
+        }
+    }
+
+    if (flags == LIBSAIS64_FLAGS_BUFFER)
+    {
+        size += (int64_t)sizeof(LIBSAIS_ARENA) + 64 + libsais64_ctx_size_main(threads);
     }
+
+    return size;
+}
+
+static int64_t libsais64_alloc_size_main(fast_sint_t n, fast_sint_t k, fast_sint_t threads)
+{
+    return libsais64_ctx_size_main(threads) + libsais64_scratch_size_main(n, k, 0, threads, LIBSAIS64_FLAGS_CTX);
 }
 
 #if defined(LIBSAIS_OPENMP)
@@ -253,7 +721,7 @@ static sa_sint_t libsais64_count_zero_marked_suffixes(sa_sint_t * RESTRICT SA, f
 
 static void libsais64_place_cached_suffixes(sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
@@ -279,7 +747,7 @@ static void libsais64_place_cached_suffixes(sa_sint_t * RESTRICT SA, LIBSAIS_THR
 
 static void libsais64_compact_and_place_cached_suffixes(sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j, l;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - 3, l = omp_block_start; i < j; i += 4)
@@ -376,8 +844,87 @@ static void libsais64_accumulate_counts_s32_9(sa_sint_t * RESTRICT bucket00, fas
     fast_sint_t s; for (s = 0; s < bucket_size; s += 1) { bucket00[s] = bucket00[s] + bucket01[s] + bucket02[s] + bucket03[s] + bucket04[s] + bucket05[s] + bucket06[s] + bucket07[s] + bucket08[s]; }
 }
 
+#if defined(LIBSAIS_SIMD_AVX512)
+
+static LIBSAIS_SIMD_TARGET_AVX512 void libsais64_accumulate_counts_s32_avx512(sa_sint_t * RESTRICT buckets, fast_sint_t bucket_size, fast_sint_t bucket_stride, fast_sint_t num_buckets)
+{
+    fast_sint_t s, b;
+    for (s = 0; s < bucket_size - 7; s += 8)
+    {
+        __m512i sum = _mm512_loadu_si512((const void *)&buckets[s]);
+        for (b = 1; b < num_buckets; b += 1) { sum = _mm512_add_epi64(sum, _mm512_loadu_si512((const void *)&buckets[s - b * bucket_stride])); }
+        _mm512_storeu_si512((void *)&buckets[s], sum);
+    }
+
+    for (; s < bucket_size; s += 1)
+    {
+        sa_sint_t sum = buckets[s];
+        for (b = 1; b < num_buckets; b += 1) { sum += buckets[s - b * bucket_stride]; }
+        buckets[s] = sum;
+    }
+}
+
+#endif
+
+#if defined(LIBSAIS_SIMD_AVX2)
+
+static LIBSAIS_SIMD_TARGET_AVX2 void libsais64_accumulate_counts_s32_avx2(sa_sint_t * RESTRICT buckets, fast_sint_t bucket_size, fast_sint_t bucket_stride, fast_sint_t num_buckets)
+{
+    fast_sint_t s, b;
+    for (s = 0; s < bucket_size - 3; s += 4)
+    {
+        __m256i sum = _mm256_loadu_si256((const __m256i *)(const void *)&buckets[s]);
+        for (b = 1; b < num_buckets; b += 1) { sum = _mm256_add_epi64(sum, _mm256_loadu_si256((const __m256i *)(const void *)&buckets[s - b * bucket_stride])); }
+        _mm256_storeu_si256((__m256i *)(void *)&buckets[s], sum);
+    }
+
+    for (; s < bucket_size; s += 1)
+    {
+        sa_sint_t sum = buckets[s];
+        for (b = 1; b < num_buckets; b += 1) { sum += buckets[s - b * bucket_stride]; }
+        buckets[s] = sum;
+    }
+}
+
+#elif defined(LIBSAIS_SIMD_NEON)
+
+static void libsais64_accumulate_counts_s32_neon(sa_sint_t * RESTRICT buckets, fast_sint_t bucket_size, fast_sint_t bucket_stride, fast_sint_t num_buckets)
+{
+    fast_sint_t s, b;
+    for (s = 0; s < bucket_size - 1; s += 2)
+    {
+        int64x2_t sum = vld1q_s64(&buckets[s]);
+        for (b = 1; b < num_buckets; b += 1) { sum = vaddq_s64(sum, vld1q_s64(&buckets[s - b * bucket_stride])); }
+        vst1q_s64(&buckets[s], sum);
+    }
+
+    for (; s < bucket_size; s += 1)
+    {
+        sa_sint_t sum = buckets[s];
+        for (b = 1; b < num_buckets; b += 1) { sum += buckets[s - b * bucket_stride]; }
+        buckets[s] = sum;
+    }
+}
+
+#endif
+
 static void libsais64_accumulate_counts_s32(sa_sint_t * RESTRICT buckets, fast_sint_t bucket_size, fast_sint_t bucket_stride, fast_sint_t num_buckets)
 {
+#if defined(LIBSAIS_SIMD_AVX512)
+    if (libsais64_cpu_supports_avx512())
+    {
+        libsais64_accumulate_counts_s32_avx512(buckets, bucket_size, bucket_stride, num_buckets); return;
+    }
+#endif
+#if defined(LIBSAIS_SIMD_AVX2)
+    if (libsais64_cpu_supports_avx2())
+    {
+        libsais64_accumulate_counts_s32_avx2(buckets, bucket_size, bucket_stride, num_buckets); return;
+    }
+#elif defined(LIBSAIS_SIMD_NEON)
+    libsais64_accumulate_counts_s32_neon(buckets, bucket_size, bucket_stride, num_buckets); return;
+#endif
+
     while (num_buckets >= 9)
     {
         libsais64_accumulate_counts_s32_9(buckets - (num_buckets - 9) * bucket_stride, bucket_size, bucket_stride); num_buckets -= 8;
@@ -472,7 +1019,7 @@ static void libsais64_gather_lms_suffixes_8u_omp(const uint8_t * RESTRICT T, sa_
 
 static sa_sint_t libsais64_gather_lms_suffixes_32s(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t             i   = n - 2;
     sa_sint_t             m   = n - 1;
@@ -500,7 +1047,7 @@ static sa_sint_t libsais64_gather_lms_suffixes_32s(const sa_sint_t * RESTRICT T,
 
 static sa_sint_t libsais64_gather_compacted_lms_suffixes_32s(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t             i   = n - 2;
     sa_sint_t             m   = n - 1;
@@ -530,7 +1077,7 @@ static sa_sint_t libsais64_gather_compacted_lms_suffixes_32s(const sa_sint_t * R
 
 static void libsais64_count_lms_suffixes_32s_4k(const sa_sint_t * RESTRICT T, sa_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT buckets)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     memset(buckets, 0, 4 * (size_t)k * sizeof(sa_sint_t));
 
@@ -574,7 +1121,7 @@ static void libsais64_count_lms_suffixes_32s_4k(const sa_sint_t * RESTRICT T, sa
 
 static void libsais64_count_lms_suffixes_32s_2k(const sa_sint_t * RESTRICT T, sa_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT buckets)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     memset(buckets, 0, 2 * (size_t)k * sizeof(sa_sint_t));
 
@@ -618,7 +1165,7 @@ static void libsais64_count_lms_suffixes_32s_2k(const sa_sint_t * RESTRICT T, sa
 
 static void libsais64_count_compacted_lms_suffixes_32s_2k(const sa_sint_t * RESTRICT T, sa_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT buckets)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     memset(buckets, 0, 2 * (size_t)k * sizeof(sa_sint_t));
 
@@ -781,7 +1328,7 @@ static sa_sint_t libsais64_count_and_gather_lms_suffixes_32s_4k(const sa_sint_t
 
     if (omp_block_size > 0)
     {
-        const fast_sint_t prefetch_distance = 32;
+        const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
         fast_sint_t i, j = m + 1, c0 = T[m], c1 = -1;
 
@@ -832,7 +1379,7 @@ static sa_sint_t libsais64_count_and_gather_lms_suffixes_32s_2k(const sa_sint_t
 
     if (omp_block_size > 0)
     {
-        const fast_sint_t prefetch_distance = 32;
+        const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
         fast_sint_t i, j = m + 1, c0 = T[m], c1 = -1;
 
@@ -883,7 +1430,7 @@ static sa_sint_t libsais64_count_and_gather_compacted_lms_suffixes_32s_2k(const
 
     if (omp_block_size > 0)
     {
-        const fast_sint_t prefetch_distance = 32;
+        const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
         fast_sint_t i, j = m + 1, c0 = T[m], c1 = -1;
 
@@ -1298,7 +1845,7 @@ static void libsais64_count_and_gather_compacted_lms_suffixes_32s_2k_omp(const s
 
 static void libsais64_count_suffixes_32s(const sa_sint_t * RESTRICT T, sa_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT buckets)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     memset(buckets, 0, (size_t)k * sizeof(sa_sint_t));
 
@@ -1354,27 +1901,208 @@ static sa_sint_t libsais64_initialize_buckets_start_and_end_8u(sa_sint_t * RESTR
     return (sa_sint_t)(k + 1);
 }
 
-static void libsais64_initialize_buckets_start_and_end_32s_6k(sa_sint_t k, sa_sint_t * RESTRICT buckets)
+#if defined(LIBSAIS_SIMD_AVX512)
+
+static LIBSAIS_SIMD_TARGET_AVX512 __m512i libsais64_inclusive_scan_s64_avx512(__m512i x)
 {
-    sa_sint_t * RESTRICT bucket_start = &buckets[4 * (fast_sint_t)k];
-    sa_sint_t * RESTRICT bucket_end   = &buckets[5 * (fast_sint_t)k];
+    const __m512i zero = _mm512_setzero_si512();
 
-    fast_sint_t i, j; sa_sint_t sum = 0;
-    for (i = BUCKETS_INDEX4(0, 0), j = 0; i <= BUCKETS_INDEX4((fast_sint_t)k - 1, 0); i += BUCKETS_INDEX4(1, 0), j += 1)
-    {
-        bucket_start[j] = sum;
-        sum += buckets[i + BUCKETS_INDEX4(0, 0)] + buckets[i + BUCKETS_INDEX4(0, 1)] + buckets[i + BUCKETS_INDEX4(0, 2)] + buckets[i + BUCKETS_INDEX4(0, 3)];
-        bucket_end[j] = sum;
-    }
+    x = _mm512_add_epi64(x, _mm512_alignr_epi64(x, zero, 7));
+    x = _mm512_add_epi64(x, _mm512_alignr_epi64(x, zero, 6));
+    return _mm512_add_epi64(x, _mm512_alignr_epi64(x, zero, 4));
 }
 
-static void libsais64_initialize_buckets_start_and_end_32s_4k(sa_sint_t k, sa_sint_t * RESTRICT buckets)
+static LIBSAIS_SIMD_TARGET_AVX512 sa_sint_t libsais64_extract_s64_avx512(__m512i x)
 {
-    sa_sint_t * RESTRICT bucket_start = &buckets[2 * (fast_sint_t)k];
-    sa_sint_t * RESTRICT bucket_end   = &buckets[3 * (fast_sint_t)k];
+    return (sa_sint_t)_mm_cvtsi128_si64(_mm512_castsi512_si128(x));
+}
 
-    fast_sint_t i, j; sa_sint_t sum = 0;
-    for (i = BUCKETS_INDEX2(0, 0), j = 0; i <= BUCKETS_INDEX2((fast_sint_t)k - 1, 0); i += BUCKETS_INDEX2(1, 0), j += 1)
+static LIBSAIS_SIMD_TARGET_AVX512 void libsais64_initialize_buckets_start_32s_1k_avx512(sa_sint_t k, sa_sint_t * RESTRICT buckets)
+{
+    const __m512i last = _mm512_set1_epi64(7);
+
+    fast_sint_t i; __m512i vsum = _mm512_setzero_si512();
+    for (i = 0; i < (fast_sint_t)k - 7; i += 8)
+    {
+        __m512i count = _mm512_loadu_si512((const void *)&buckets[i]);
+        __m512i end   = _mm512_add_epi64(vsum, libsais64_inclusive_scan_s64_avx512(count));
+
+        _mm512_storeu_si512((void *)&buckets[i], _mm512_sub_epi64(end, count));
+
+        vsum = _mm512_permutexvar_epi64(last, end);
+    }
+
+    sa_sint_t sum = libsais64_extract_s64_avx512(vsum);
+    for (; i < (fast_sint_t)k; i += 1) { sa_sint_t tmp = buckets[i]; buckets[i] = sum; sum += tmp; }
+}
+
+static LIBSAIS_SIMD_TARGET_AVX512 void libsais64_initialize_buckets_end_32s_1k_avx512(sa_sint_t k, sa_sint_t * RESTRICT buckets)
+{
+    const __m512i last = _mm512_set1_epi64(7);
+
+    fast_sint_t i; __m512i vsum = _mm512_setzero_si512();
+    for (i = 0; i < (fast_sint_t)k - 7; i += 8)
+    {
+        __m512i end = _mm512_add_epi64(vsum, libsais64_inclusive_scan_s64_avx512(_mm512_loadu_si512((const void *)&buckets[i])));
+
+        _mm512_storeu_si512((void *)&buckets[i], end);
+
+        vsum = _mm512_permutexvar_epi64(last, end);
+    }
+
+    sa_sint_t sum = libsais64_extract_s64_avx512(vsum);
+    for (; i < (fast_sint_t)k; i += 1) { sum += buckets[i]; buckets[i] = sum; }
+}
+
+#endif
+
+#if defined(LIBSAIS_SIMD_AVX2)
+
+static LIBSAIS_SIMD_TARGET_AVX2 __m256i libsais64_inclusive_scan_s64_avx2(__m256i x)
+{
+    x = _mm256_add_epi64(x, _mm256_slli_si256(x, 8));
+
+    __m256i carry = _mm256_permute4x64_epi64(x, 0x55);
+    return _mm256_add_epi64(x, _mm256_blend_epi32(_mm256_setzero_si256(), carry, 0xf0));
+}
+
+static LIBSAIS_SIMD_TARGET_AVX2 sa_sint_t libsais64_extract_s64_avx2(__m256i x)
+{
+    return (sa_sint_t)_mm_cvtsi128_si64(_mm256_castsi256_si128(x));
+}
+
+static LIBSAIS_SIMD_TARGET_AVX2 void libsais64_initialize_buckets_start_and_end_32s_6k_avx2(sa_sint_t k, sa_sint_t * RESTRICT buckets)
+{
+    sa_sint_t * RESTRICT bucket_start = &buckets[4 * (fast_sint_t)k];
+    sa_sint_t * RESTRICT bucket_end   = &buckets[5 * (fast_sint_t)k];
+
+    fast_sint_t i, j; __m256i vsum = _mm256_setzero_si256();
+    for (i = BUCKETS_INDEX4(0, 0), j = 0; j < (fast_sint_t)k - 3; i += BUCKETS_INDEX4(4, 0), j += 4)
+    {
+        __m256i c0 = _mm256_loadu_si256((const __m256i *)(const void *)&buckets[i + BUCKETS_INDEX4(0, 0)]);
+        __m256i c1 = _mm256_loadu_si256((const __m256i *)(const void *)&buckets[i + BUCKETS_INDEX4(1, 0)]);
+        __m256i c2 = _mm256_loadu_si256((const __m256i *)(const void *)&buckets[i + BUCKETS_INDEX4(2, 0)]);
+        __m256i c3 = _mm256_loadu_si256((const __m256i *)(const void *)&buckets[i + BUCKETS_INDEX4(3, 0)]);
+
+        __m256i p01   = _mm256_add_epi64(_mm256_unpacklo_epi64(c0, c1), _mm256_unpackhi_epi64(c0, c1));
+        __m256i p23   = _mm256_add_epi64(_mm256_unpacklo_epi64(c2, c3), _mm256_unpackhi_epi64(c2, c3));
+        __m256i total = _mm256_add_epi64(_mm256_permute2x128_si256(p01, p23, 0x20), _mm256_permute2x128_si256(p01, p23, 0x31));
+        __m256i end   = _mm256_add_epi64(vsum, libsais64_inclusive_scan_s64_avx2(total));
+
+        _mm256_storeu_si256((__m256i *)(void *)&bucket_start[j], _mm256_sub_epi64(end, total));
+        _mm256_storeu_si256((__m256i *)(void *)&bucket_end[j], end);
+
+        vsum = _mm256_permute4x64_epi64(end, 0xff);
+    }
+
+    sa_sint_t sum = libsais64_extract_s64_avx2(vsum);
+    for (; j < (fast_sint_t)k; i += BUCKETS_INDEX4(1, 0), j += 1)
+    {
+        bucket_start[j] = sum;
+        sum += buckets[i + BUCKETS_INDEX4(0, 0)] + buckets[i + BUCKETS_INDEX4(0, 1)] + buckets[i + BUCKETS_INDEX4(0, 2)] + buckets[i + BUCKETS_INDEX4(0, 3)];
+        bucket_end[j] = sum;
+    }
+}
+
+static LIBSAIS_SIMD_TARGET_AVX2 void libsais64_initialize_buckets_start_and_end_32s_4k_avx2(sa_sint_t k, sa_sint_t * RESTRICT buckets)
+{
+    sa_sint_t * RESTRICT bucket_start = &buckets[2 * (fast_sint_t)k];
+    sa_sint_t * RESTRICT bucket_end   = &buckets[3 * (fast_sint_t)k];
+
+    fast_sint_t i, j; __m256i vsum = _mm256_setzero_si256();
+    for (i = BUCKETS_INDEX2(0, 0), j = 0; j < (fast_sint_t)k - 3; i += BUCKETS_INDEX2(4, 0), j += 4)
+    {
+        __m256i c0 = _mm256_loadu_si256((const __m256i *)(const void *)&buckets[i + BUCKETS_INDEX2(0, 0)]);
+        __m256i c1 = _mm256_loadu_si256((const __m256i *)(const void *)&buckets[i + BUCKETS_INDEX2(2, 0)]);
+
+        __m256i total = _mm256_permute4x64_epi64(_mm256_add_epi64(_mm256_unpacklo_epi64(c0, c1), _mm256_unpackhi_epi64(c0, c1)), 0xd8);
+        __m256i end   = _mm256_add_epi64(vsum, libsais64_inclusive_scan_s64_avx2(total));
+
+        _mm256_storeu_si256((__m256i *)(void *)&bucket_start[j], _mm256_sub_epi64(end, total));
+        _mm256_storeu_si256((__m256i *)(void *)&bucket_end[j], end);
+
+        vsum = _mm256_permute4x64_epi64(end, 0xff);
+    }
+
+    sa_sint_t sum = libsais64_extract_s64_avx2(vsum);
+    for (; j < (fast_sint_t)k; i += BUCKETS_INDEX2(1, 0), j += 1)
+    {
+        bucket_start[j] = sum;
+        sum += buckets[i + BUCKETS_INDEX2(0, 0)] + buckets[i + BUCKETS_INDEX2(0, 1)];
+        bucket_end[j] = sum;
+    }
+}
+
+static LIBSAIS_SIMD_TARGET_AVX2 void libsais64_initialize_buckets_start_32s_1k_avx2(sa_sint_t k, sa_sint_t * RESTRICT buckets)
+{
+    fast_sint_t i; __m256i vsum = _mm256_setzero_si256();
+    for (i = 0; i < (fast_sint_t)k - 3; i += 4)
+    {
+        __m256i count = _mm256_loadu_si256((const __m256i *)(const void *)&buckets[i]);
+        __m256i end   = _mm256_add_epi64(vsum, libsais64_inclusive_scan_s64_avx2(count));
+
+        _mm256_storeu_si256((__m256i *)(void *)&buckets[i], _mm256_sub_epi64(end, count));
+
+        vsum = _mm256_permute4x64_epi64(end, 0xff);
+    }
+
+    sa_sint_t sum = libsais64_extract_s64_avx2(vsum);
+    for (; i < (fast_sint_t)k; i += 1) { sa_sint_t tmp = buckets[i]; buckets[i] = sum; sum += tmp; }
+}
+
+static LIBSAIS_SIMD_TARGET_AVX2 void libsais64_initialize_buckets_end_32s_1k_avx2(sa_sint_t k, sa_sint_t * RESTRICT buckets)
+{
+    fast_sint_t i; __m256i vsum = _mm256_setzero_si256();
+    for (i = 0; i < (fast_sint_t)k - 3; i += 4)
+    {
+        __m256i end = _mm256_add_epi64(vsum, libsais64_inclusive_scan_s64_avx2(_mm256_loadu_si256((const __m256i *)(const void *)&buckets[i])));
+
+        _mm256_storeu_si256((__m256i *)(void *)&buckets[i], end);
+
+        vsum = _mm256_permute4x64_epi64(end, 0xff);
+    }
+
+    sa_sint_t sum = libsais64_extract_s64_avx2(vsum);
+    for (; i < (fast_sint_t)k; i += 1) { sum += buckets[i]; buckets[i] = sum; }
+}
+
+#endif
+
+static void libsais64_initialize_buckets_start_and_end_32s_6k(sa_sint_t k, sa_sint_t * RESTRICT buckets)
+{
+#if defined(LIBSAIS_SIMD_AVX2)
+    if (libsais64_cpu_supports_avx2())
+    {
+        libsais64_initialize_buckets_start_and_end_32s_6k_avx2(k, buckets); return;
+    }
+#endif
+
+    sa_sint_t * RESTRICT bucket_start = &buckets[4 * (fast_sint_t)k];
+    sa_sint_t * RESTRICT bucket_end   = &buckets[5 * (fast_sint_t)k];
+
+    fast_sint_t i, j; sa_sint_t sum = 0;
+    for (i = BUCKETS_INDEX4(0, 0), j = 0; i <= BUCKETS_INDEX4((fast_sint_t)k - 1, 0); i += BUCKETS_INDEX4(1, 0), j += 1)
+    {
+        bucket_start[j] = sum;
+        sum += buckets[i + BUCKETS_INDEX4(0, 0)] + buckets[i + BUCKETS_INDEX4(0, 1)] + buckets[i + BUCKETS_INDEX4(0, 2)] + buckets[i + BUCKETS_INDEX4(0, 3)];
+        bucket_end[j] = sum;
+    }
+}
+
+static void libsais64_initialize_buckets_start_and_end_32s_4k(sa_sint_t k, sa_sint_t * RESTRICT buckets)
+{
+#if defined(LIBSAIS_SIMD_AVX2)
+    if (libsais64_cpu_supports_avx2())
+    {
+        libsais64_initialize_buckets_start_and_end_32s_4k_avx2(k, buckets); return;
+    }
+#endif
+
+    sa_sint_t * RESTRICT bucket_start = &buckets[2 * (fast_sint_t)k];
+    sa_sint_t * RESTRICT bucket_end   = &buckets[3 * (fast_sint_t)k];
+
+    fast_sint_t i, j; sa_sint_t sum = 0;
+    for (i = BUCKETS_INDEX2(0, 0), j = 0; i <= BUCKETS_INDEX2((fast_sint_t)k - 1, 0); i += BUCKETS_INDEX2(1, 0), j += 1)
     { 
         bucket_start[j] = sum;
         sum += buckets[i + BUCKETS_INDEX2(0, 0)] + buckets[i + BUCKETS_INDEX2(0, 1)];
@@ -1404,12 +2132,38 @@ static void libsais64_initialize_buckets_start_and_end_32s_2k(sa_sint_t k, sa_si
 
 static void libsais64_initialize_buckets_start_32s_1k(sa_sint_t k, sa_sint_t * RESTRICT buckets)
 {
+#if defined(LIBSAIS_SIMD_AVX512)
+    if (libsais64_cpu_supports_avx512())
+    {
+        libsais64_initialize_buckets_start_32s_1k_avx512(k, buckets); return;
+    }
+#endif
+#if defined(LIBSAIS_SIMD_AVX2)
+    if (libsais64_cpu_supports_avx2())
+    {
+        libsais64_initialize_buckets_start_32s_1k_avx2(k, buckets); return;
+    }
+#endif
+
     fast_sint_t i; sa_sint_t sum = 0;
     for (i = 0; i <= (fast_sint_t)k - 1; i += 1) { sa_sint_t tmp = buckets[i]; buckets[i] = sum; sum += tmp; }
 }
 
 static void libsais64_initialize_buckets_end_32s_1k(sa_sint_t k, sa_sint_t * RESTRICT buckets)
 {
+#if defined(LIBSAIS_SIMD_AVX512)
+    if (libsais64_cpu_supports_avx512())
+    {
+        libsais64_initialize_buckets_end_32s_1k_avx512(k, buckets); return;
+    }
+#endif
+#if defined(LIBSAIS_SIMD_AVX2)
+    if (libsais64_cpu_supports_avx2())
+    {
+        libsais64_initialize_buckets_end_32s_1k_avx2(k, buckets); return;
+    }
+#endif
+
     fast_sint_t i; sa_sint_t sum = 0;
     for (i = 0; i <= (fast_sint_t)k - 1; i += 1) { sum += buckets[i]; buckets[i] = sum; }
 }
@@ -1511,7 +2265,7 @@ static void libsais64_initialize_buckets_for_radix_and_partial_sorting_32s_4k(co
 
 static void libsais64_radix_sort_lms_suffixes_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 3; i >= j; i -= 4)
@@ -1585,7 +2339,7 @@ static void libsais64_radix_sort_lms_suffixes_8u_omp(const uint8_t * RESTRICT T,
 
 static void libsais64_radix_sort_lms_suffixes_32s_6k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + 2 * prefetch_distance + 3; i >= j; i -= 4)
@@ -1616,7 +2370,7 @@ static void libsais64_radix_sort_lms_suffixes_32s_6k(const sa_sint_t * RESTRICT
 
 static void libsais64_radix_sort_lms_suffixes_32s_2k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + 2 * prefetch_distance + 3; i >= j; i -= 4)
@@ -1649,7 +2403,7 @@ static void libsais64_radix_sort_lms_suffixes_32s_2k(const sa_sint_t * RESTRICT
 
 static void libsais64_radix_sort_lms_suffixes_32s_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
@@ -1677,7 +2431,7 @@ static void libsais64_radix_sort_lms_suffixes_32s_block_gather(const sa_sint_t *
 
 static void libsais64_radix_sort_lms_suffixes_32s_6k_block_sort(sa_sint_t * RESTRICT induction_bucket, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 3; i >= j; i -= 4)
@@ -1703,7 +2457,7 @@ static void libsais64_radix_sort_lms_suffixes_32s_6k_block_sort(sa_sint_t * REST
 
 static void libsais64_radix_sort_lms_suffixes_32s_2k_block_sort(sa_sint_t * RESTRICT induction_bucket, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 3; i >= j; i -= 4)
@@ -1839,7 +2593,9 @@ static void libsais64_radix_sort_lms_suffixes_32s_6k_omp(const sa_sint_t * RESTR
         fast_sint_t block_start, block_end;
         for (block_start = 0; block_start < (fast_sint_t)m - 1; block_start = block_end)
         {
-            block_end = block_start + (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end >= m) { block_end = (fast_sint_t)m - 1; }
+            if (libsais64_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start + (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end >= m) { block_end = (fast_sint_t)m - 1; }
 
             libsais64_radix_sort_lms_suffixes_32s_6k_block_omp(T, SA, induction_bucket, thread_state[0].state.cache, (fast_sint_t)n - block_end, block_end - block_start, threads);
         }
@@ -1861,7 +2617,9 @@ static void libsais64_radix_sort_lms_suffixes_32s_2k_omp(const sa_sint_t * RESTR
         fast_sint_t block_start, block_end;
         for (block_start = 0; block_start < (fast_sint_t)m - 1; block_start = block_end)
         {
-            block_end = block_start + (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end >= m) { block_end = (fast_sint_t)m - 1; }
+            if (libsais64_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start + (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end >= m) { block_end = (fast_sint_t)m - 1; }
 
             libsais64_radix_sort_lms_suffixes_32s_2k_block_omp(T, SA, induction_bucket, thread_state[0].state.cache, (fast_sint_t)n - block_end, block_end - block_start, threads);
         }
@@ -1873,7 +2631,7 @@ static void libsais64_radix_sort_lms_suffixes_32s_2k_omp(const sa_sint_t * RESTR
 
 static sa_sint_t libsais64_radix_sort_lms_suffixes_32s_1k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t * RESTRICT buckets)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t             i = n - 2;
     sa_sint_t             m = 0;
@@ -1920,7 +2678,7 @@ static sa_sint_t libsais64_radix_sort_lms_suffixes_32s_1k(const sa_sint_t * REST
 
 static void libsais64_radix_sort_set_markers_32s_6k(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
@@ -1946,7 +2704,7 @@ static void libsais64_radix_sort_set_markers_32s_6k(sa_sint_t * RESTRICT SA, sa_
 
 static void libsais64_radix_sort_set_markers_32s_4k(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
@@ -2079,7 +2837,7 @@ static void libsais64_initialize_buckets_for_partial_sorting_32s_6k(const sa_sin
 
 static sa_sint_t libsais64_partial_sorting_scan_left_to_right_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, sa_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[4 * ALPHABET_SIZE];
     sa_sint_t * RESTRICT distinct_names   = &buckets[2 * ALPHABET_SIZE];
@@ -2114,7 +2872,7 @@ static sa_sint_t libsais64_partial_sorting_scan_left_to_right_8u(const uint8_t *
 
 static void libsais64_partial_sorting_scan_left_to_right_8u_block_prepare(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size, LIBSAIS_THREAD_STATE * RESTRICT state)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[0 * ALPHABET_SIZE];
     sa_sint_t * RESTRICT distinct_names   = &buckets[2 * ALPHABET_SIZE];
@@ -2147,7 +2905,7 @@ static void libsais64_partial_sorting_scan_left_to_right_8u_block_prepare(const
 
 static void libsais64_partial_sorting_scan_left_to_right_8u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count, sa_sint_t d)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[0 * ALPHABET_SIZE];
     sa_sint_t * RESTRICT distinct_names   = &buckets[2 * ALPHABET_SIZE];
@@ -2262,7 +3020,9 @@ static sa_sint_t libsais64_partial_sorting_scan_left_to_right_8u_omp(const uint8
             }
             else
             {
-                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end > left_suffixes_count) { block_max_end = left_suffixes_count;}
+                if (libsais64_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end > left_suffixes_count) { block_max_end = left_suffixes_count;}
                 fast_sint_t block_end     = block_start + 1; while (block_end < block_max_end && SA[block_end] != 0) { block_end++; }
                 fast_sint_t block_size    = block_end - block_start;
 
@@ -2291,7 +3051,7 @@ static sa_sint_t libsais64_partial_sorting_scan_left_to_right_8u_omp(const uint8
 
 static sa_sint_t libsais64_partial_sorting_scan_left_to_right_32s_6k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, sa_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - 2 * prefetch_distance - 1; i < j; i += 2)
@@ -2324,7 +3084,7 @@ static sa_sint_t libsais64_partial_sorting_scan_left_to_right_32s_6k(const sa_si
 
 static sa_sint_t libsais64_partial_sorting_scan_left_to_right_32s_4k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, sa_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[2 * (fast_sint_t)k];
     sa_sint_t * RESTRICT distinct_names   = &buckets[0 * (fast_sint_t)k];
@@ -2369,7 +3129,7 @@ static sa_sint_t libsais64_partial_sorting_scan_left_to_right_32s_4k(const sa_si
 
 static void libsais64_partial_sorting_scan_left_to_right_32s_1k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - 2 * prefetch_distance - 1; i < j; i += 2)
@@ -2395,7 +3155,7 @@ static void libsais64_partial_sorting_scan_left_to_right_32s_1k(const sa_sint_t
 
 static void libsais64_partial_sorting_scan_left_to_right_32s_6k_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -2421,7 +3181,7 @@ static void libsais64_partial_sorting_scan_left_to_right_32s_6k_block_gather(con
 
 static void libsais64_partial_sorting_scan_left_to_right_32s_4k_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -2445,7 +3205,7 @@ static void libsais64_partial_sorting_scan_left_to_right_32s_4k_block_gather(con
 
 static void libsais64_partial_sorting_scan_left_to_right_32s_1k_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -2469,7 +3229,7 @@ static void libsais64_partial_sorting_scan_left_to_right_32s_1k_block_gather(con
 
 static sa_sint_t libsais64_partial_sorting_scan_left_to_right_32s_6k_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT buckets, sa_sint_t d, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j, omp_block_end = omp_block_start + omp_block_size;
     for (i = omp_block_start, j = omp_block_end - prefetch_distance - 1; i < j; i += 2)
@@ -2497,7 +3257,7 @@ static sa_sint_t libsais64_partial_sorting_scan_left_to_right_32s_6k_block_sort(
 
 static sa_sint_t libsais64_partial_sorting_scan_left_to_right_32s_4k_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t k, sa_sint_t * RESTRICT buckets, sa_sint_t d, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[2 * (fast_sint_t)k];
     sa_sint_t * RESTRICT distinct_names   = &buckets[0 * (fast_sint_t)k];
@@ -2540,7 +3300,7 @@ static sa_sint_t libsais64_partial_sorting_scan_left_to_right_32s_4k_block_sort(
 
 static void libsais64_partial_sorting_scan_left_to_right_32s_1k_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT induction_bucket, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j, omp_block_end = omp_block_start + omp_block_size;
     for (i = omp_block_start, j = omp_block_end - prefetch_distance - 1; i < j; i += 2)
@@ -2744,7 +3504,9 @@ static sa_sint_t libsais64_partial_sorting_scan_left_to_right_32s_6k_omp(const s
         fast_sint_t block_start, block_end;
         for (block_start = 0; block_start < left_suffixes_count; block_start = block_end)
         {
-            block_end = block_start + (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end > left_suffixes_count) { block_end = left_suffixes_count; }
+            if (libsais64_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start + (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end > left_suffixes_count) { block_end = left_suffixes_count; }
 
             d = libsais64_partial_sorting_scan_left_to_right_32s_6k_block_omp(T, SA, buckets, d, thread_state[0].state.cache, block_start, block_end - block_start, threads);
         }
@@ -2774,7 +3536,9 @@ static sa_sint_t libsais64_partial_sorting_scan_left_to_right_32s_4k_omp(const s
         fast_sint_t block_start, block_end;
         for (block_start = 0; block_start < n; block_start = block_end)
         {
-            block_end = block_start + (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end > n) { block_end = n; }
+            if (libsais64_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start + (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end > n) { block_end = n; }
 
             d = libsais64_partial_sorting_scan_left_to_right_32s_4k_block_omp(T, SA, k, buckets, d, thread_state[0].state.cache, block_start, block_end - block_start, threads);
         }
@@ -2800,7 +3564,9 @@ static void libsais64_partial_sorting_scan_left_to_right_32s_1k_omp(const sa_sin
         fast_sint_t block_start, block_end;
         for (block_start = 0; block_start < n; block_start = block_end)
         {
-            block_end = block_start + (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end > n) { block_end = n; }
+            if (libsais64_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start + (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end > n) { block_end = n; }
 
             libsais64_partial_sorting_scan_left_to_right_32s_1k_block_omp(T, SA, buckets, thread_state[0].state.cache, block_start, block_end - block_start, threads);
         }
@@ -2812,7 +3578,7 @@ static void libsais64_partial_sorting_scan_left_to_right_32s_1k_omp(const sa_sin
 
 static void libsais64_partial_sorting_shift_markers_8u_omp(sa_sint_t * RESTRICT SA, sa_sint_t n, const sa_sint_t * RESTRICT buckets, sa_sint_t threads)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     const sa_sint_t * RESTRICT temp_bucket = &buckets[4 * ALPHABET_SIZE];
 
@@ -2845,7 +3611,7 @@ static void libsais64_partial_sorting_shift_markers_8u_omp(sa_sint_t * RESTRICT
 
 static void libsais64_partial_sorting_shift_markers_32s_6k_omp(sa_sint_t * RESTRICT SA, sa_sint_t k, const sa_sint_t * RESTRICT buckets, sa_sint_t threads)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     const sa_sint_t * RESTRICT temp_bucket = &buckets[4 * (fast_sint_t)k];
     
@@ -2878,7 +3644,7 @@ static void libsais64_partial_sorting_shift_markers_32s_6k_omp(sa_sint_t * RESTR
 
 static void libsais64_partial_sorting_shift_markers_32s_4k(sa_sint_t * RESTRICT SA, sa_sint_t n)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i; sa_sint_t s = SUFFIX_GROUP_MARKER;
     for (i = (fast_sint_t)n - 1; i >= 3; i -= 4)
@@ -2911,7 +3677,7 @@ static void libsais64_partial_sorting_shift_buckets_32s_6k(sa_sint_t k, sa_sint_
 
 static sa_sint_t libsais64_partial_sorting_scan_right_to_left_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, sa_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[0 * ALPHABET_SIZE];
     sa_sint_t * RESTRICT distinct_names   = &buckets[2 * ALPHABET_SIZE];
@@ -2946,7 +3712,7 @@ static sa_sint_t libsais64_partial_sorting_scan_right_to_left_8u(const uint8_t *
 
 static void libsais64_partial_sorting_scan_right_to_left_8u_block_prepare(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size, LIBSAIS_THREAD_STATE * RESTRICT state)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[0 * ALPHABET_SIZE];
     sa_sint_t * RESTRICT distinct_names   = &buckets[2 * ALPHABET_SIZE];
@@ -2979,7 +3745,7 @@ static void libsais64_partial_sorting_scan_right_to_left_8u_block_prepare(const
 
 static void libsais64_partial_sorting_scan_right_to_left_8u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count, sa_sint_t d)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[0 * ALPHABET_SIZE];
     sa_sint_t * RESTRICT distinct_names   = &buckets[2 * ALPHABET_SIZE];
@@ -3094,7 +3860,9 @@ static void libsais64_partial_sorting_scan_right_to_left_8u_omp(const uint8_t *
             }
             else
             {
-                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end < scan_start) { block_max_end = scan_start - 1; }
+                if (libsais64_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end < scan_start) { block_max_end = scan_start - 1; }
                 fast_sint_t block_end     = block_start - 1; while (block_end > block_max_end && SA[block_end] != 0) { block_end--; }
                 fast_sint_t block_size    = block_start - block_end;
 
@@ -3121,7 +3889,7 @@ static void libsais64_partial_sorting_scan_right_to_left_8u_omp(const uint8_t *
 
 static sa_sint_t libsais64_partial_sorting_scan_right_to_left_32s_6k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, sa_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + 2 * prefetch_distance + 1; i >= j; i -= 2)
@@ -3154,7 +3922,7 @@ static sa_sint_t libsais64_partial_sorting_scan_right_to_left_32s_6k(const sa_si
 
 static sa_sint_t libsais64_partial_sorting_scan_right_to_left_32s_4k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, sa_sint_t d, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[3 * (fast_sint_t)k];
     sa_sint_t * RESTRICT distinct_names   = &buckets[0 * (fast_sint_t)k];
@@ -3199,7 +3967,7 @@ static sa_sint_t libsais64_partial_sorting_scan_right_to_left_32s_4k(const sa_si
 
 static void libsais64_partial_sorting_scan_right_to_left_32s_1k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + 2 * prefetch_distance + 1; i >= j; i -= 2)
@@ -3225,7 +3993,7 @@ static void libsais64_partial_sorting_scan_right_to_left_32s_1k(const sa_sint_t
 
 static void libsais64_partial_sorting_scan_right_to_left_32s_6k_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -3251,7 +4019,7 @@ static void libsais64_partial_sorting_scan_right_to_left_32s_6k_block_gather(con
 
 static void libsais64_partial_sorting_scan_right_to_left_32s_4k_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -3275,7 +4043,7 @@ static void libsais64_partial_sorting_scan_right_to_left_32s_4k_block_gather(con
 
 static void libsais64_partial_sorting_scan_right_to_left_32s_1k_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -3299,7 +4067,7 @@ static void libsais64_partial_sorting_scan_right_to_left_32s_1k_block_gather(con
 
 static sa_sint_t libsais64_partial_sorting_scan_right_to_left_32s_6k_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT buckets, sa_sint_t d, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
@@ -3327,7 +4095,7 @@ static sa_sint_t libsais64_partial_sorting_scan_right_to_left_32s_6k_block_sort(
 
 static sa_sint_t libsais64_partial_sorting_scan_right_to_left_32s_4k_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t k, sa_sint_t * RESTRICT buckets, sa_sint_t d, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT induction_bucket = &buckets[3 * (fast_sint_t)k];
     sa_sint_t * RESTRICT distinct_names   = &buckets[0 * (fast_sint_t)k];
@@ -3370,7 +4138,7 @@ static sa_sint_t libsais64_partial_sorting_scan_right_to_left_32s_4k_block_sort(
 
 static void libsais64_partial_sorting_scan_right_to_left_32s_1k_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT induction_bucket, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
@@ -3574,7 +4342,9 @@ static sa_sint_t libsais64_partial_sorting_scan_right_to_left_32s_6k_omp(const s
         fast_sint_t block_start, block_end;
         for (block_start = scan_end - 1; block_start >= scan_start; block_start = block_end)
         {
-            block_end = block_start - (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end < scan_start) { block_end = scan_start - 1; }
+            if (libsais64_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start - (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end < scan_start) { block_end = scan_start - 1; }
 
             d = libsais64_partial_sorting_scan_right_to_left_32s_6k_block_omp(T, SA, buckets, d, thread_state[0].state.cache, block_end + 1, block_start - block_end, threads);
         }
@@ -3598,7 +4368,9 @@ static sa_sint_t libsais64_partial_sorting_scan_right_to_left_32s_4k_omp(const s
         fast_sint_t block_start, block_end;
         for (block_start = (fast_sint_t)n - 1; block_start >= 0; block_start = block_end)
         {
-            block_end = block_start - (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end < 0) { block_end = -1; }
+            if (libsais64_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start - (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end < 0) { block_end = -1; }
 
             d = libsais64_partial_sorting_scan_right_to_left_32s_4k_block_omp(T, SA, k, buckets, d, thread_state[0].state.cache, block_end + 1, block_start - block_end, threads);
         }
@@ -3622,7 +4394,9 @@ static void libsais64_partial_sorting_scan_right_to_left_32s_1k_omp(const sa_sin
         fast_sint_t block_start, block_end;
         for (block_start = (fast_sint_t)n - 1; block_start >= 0; block_start = block_end)
         {
-            block_end = block_start - (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end < 0) { block_end = -1; }
+            if (libsais64_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start - (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end < 0) { block_end = -1; }
 
             libsais64_partial_sorting_scan_right_to_left_32s_1k_block_omp(T, SA, buckets, thread_state[0].state.cache, block_end + 1, block_start - block_end, threads);
         }
@@ -3634,7 +4408,7 @@ static void libsais64_partial_sorting_scan_right_to_left_32s_1k_omp(const sa_sin
 
 static fast_sint_t libsais64_partial_sorting_gather_lms_suffixes_32s_4k(sa_sint_t * RESTRICT SA, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j, l;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - 3, l = omp_block_start; i < j; i += 4)
@@ -3657,7 +4431,7 @@ static fast_sint_t libsais64_partial_sorting_gather_lms_suffixes_32s_4k(sa_sint_
 
 static fast_sint_t libsais64_partial_sorting_gather_lms_suffixes_32s_1k(sa_sint_t * RESTRICT SA, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j, l;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - 3, l = omp_block_start; i < j; i += 4)
@@ -3829,7 +4603,7 @@ static void libsais64_induce_partial_order_32s_1k_omp(const sa_sint_t * RESTRICT
 
 static sa_sint_t libsais64_renumber_lms_suffixes_8u(sa_sint_t * RESTRICT SA, sa_sint_t m, sa_sint_t name, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAm = &SA[m];
 
@@ -3859,7 +4633,7 @@ static sa_sint_t libsais64_renumber_lms_suffixes_8u(sa_sint_t * RESTRICT SA, sa_
 
 static fast_sint_t libsais64_gather_marked_lms_suffixes(sa_sint_t * RESTRICT SA, sa_sint_t m, fast_sint_t l, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     l -= 1;
 
@@ -4013,7 +4787,7 @@ static sa_sint_t libsais64_renumber_and_gather_lms_suffixes_omp(sa_sint_t * REST
 
 static sa_sint_t libsais64_renumber_distinct_lms_suffixes_32s_4k(sa_sint_t * RESTRICT SA, sa_sint_t m, sa_sint_t name, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAm = &SA[m];
 
@@ -4043,7 +4817,7 @@ static sa_sint_t libsais64_renumber_distinct_lms_suffixes_32s_4k(sa_sint_t * RES
 
 static void libsais64_mark_distinct_lms_suffixes_32s(sa_sint_t * RESTRICT SA, sa_sint_t m, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j; sa_sint_t p0, p1, p2, p3 = 0;
     for (i = (fast_sint_t)m + omp_block_start, j = (fast_sint_t)m + omp_block_start + omp_block_size - 3; i < j; i += 4)
@@ -4064,7 +4838,7 @@ static void libsais64_mark_distinct_lms_suffixes_32s(sa_sint_t * RESTRICT SA, sa
 
 static void libsais64_clamp_lms_suffixes_length_32s(sa_sint_t * RESTRICT SA, sa_sint_t m, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAm = &SA[m];
 
@@ -4195,7 +4969,7 @@ static sa_sint_t libsais64_renumber_and_mark_distinct_lms_suffixes_32s_4k_omp(sa
 
 static sa_sint_t libsais64_renumber_and_mark_distinct_lms_suffixes_32s_1k_omp(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t m, sa_sint_t threads)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAm = &SA[m];
 
@@ -4274,7 +5048,7 @@ static sa_sint_t libsais64_renumber_and_mark_distinct_lms_suffixes_32s_1k_omp(sa
 
 static void libsais64_reconstruct_lms_suffixes(sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t m, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     const sa_sint_t * RESTRICT SAnm = &SA[n - m];
 
@@ -4397,7 +5171,7 @@ static void libsais64_place_lms_suffixes_interval_32s_2k(sa_sint_t * RESTRICT SA
 
 static void libsais64_place_lms_suffixes_interval_32s_1k(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t m, sa_sint_t * RESTRICT buckets)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t c = k - 1; fast_sint_t i, l = buckets[c];
     for (i = (fast_sint_t)m - 1; i >= prefetch_distance + 3; i -= 4)
@@ -4497,7 +5271,7 @@ static void libsais64_place_lms_suffixes_histogram_32s_2k(sa_sint_t * RESTRICT S
 
 static void libsais64_final_bwt_scan_left_to_right_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -4519,7 +5293,7 @@ static void libsais64_final_bwt_scan_left_to_right_8u(const uint8_t * RESTRICT T
 
 static void libsais64_final_bwt_aux_scan_left_to_right_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -4539,9 +5313,31 @@ static void libsais64_final_bwt_aux_scan_left_to_right_8u(const uint8_t * RESTRI
     }
 }
 
+static void libsais64_final_bwt_aux_sa_scan_left_to_right_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
+    {
+        libsais64_prefetchw(&SA[i + 2 * prefetch_distance]);
+
+        sa_sint_t s0 = SA[i + prefetch_distance + 0]; const uint8_t * Ts0 = &T[s0] - 1; libsais64_prefetchr(s0 > 0 ? Ts0 : NULL); Ts0--; libsais64_prefetchr(s0 > 0 ? Ts0 : NULL);
+        sa_sint_t s1 = SA[i + prefetch_distance + 1]; const uint8_t * Ts1 = &T[s1] - 1; libsais64_prefetchr(s1 > 0 ? Ts1 : NULL); Ts1--; libsais64_prefetchr(s1 > 0 ? Ts1 : NULL);
+
+        sa_sint_t p0 = SA[i + 0]; SA[i + 0] = p0 & SAINT_MAX; if (p0 > 0) { p0--; SA[i + 0] = T[p0] | SAINT_MIN; sa_sint_t d0 = induction_bucket[T[p0]]++; SA[d0] = p0 | ((sa_sint_t)(T[p0 - (p0 > 0)] < T[p0]) << (SAINT_BIT - 1)); if ((p0 & rm) == 0) { I[p0 / (rm + 1)] = d0 + 1; } if ((d0 & rm) == 0) { S[d0 / (rm + 1)] = p0; } }
+        sa_sint_t p1 = SA[i + 1]; SA[i + 1] = p1 & SAINT_MAX; if (p1 > 0) { p1--; SA[i + 1] = T[p1] | SAINT_MIN; sa_sint_t d1 = induction_bucket[T[p1]]++; SA[d1] = p1 | ((sa_sint_t)(T[p1 - (p1 > 0)] < T[p1]) << (SAINT_BIT - 1)); if ((p1 & rm) == 0) { I[p1 / (rm + 1)] = d1 + 1; } if ((d1 & rm) == 0) { S[d1 / (rm + 1)] = p1; } }
+    }
+
+    for (j += prefetch_distance + 1; i < j; i += 1)
+    {
+        sa_sint_t p = SA[i]; SA[i] = p & SAINT_MAX; if (p > 0) { p--; SA[i] = T[p] | SAINT_MIN; sa_sint_t d = induction_bucket[T[p]]++; SA[d] = p | ((sa_sint_t)(T[p - (p > 0)] < T[p]) << (SAINT_BIT - 1)); if ((p & rm) == 0) { I[p / (rm + 1)] = d + 1; } if ((d & rm) == 0) { S[d / (rm + 1)] = p; } }
+    }
+}
+
 static void libsais64_final_sorting_scan_left_to_right_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -4563,7 +5359,7 @@ static void libsais64_final_sorting_scan_left_to_right_8u(const uint8_t * RESTRI
 
 static void libsais64_final_sorting_scan_left_to_right_32s(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - 2 * prefetch_distance - 1; i < j; i += 2)
@@ -4589,7 +5385,7 @@ static void libsais64_final_sorting_scan_left_to_right_32s(const sa_sint_t * RES
 
 static fast_sint_t libsais64_final_bwt_scan_left_to_right_8u_block_prepare(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-   const fast_sint_t prefetch_distance = 32;
+   const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
    memset(buckets, 0, k * sizeof(sa_sint_t));
 
@@ -4615,7 +5411,7 @@ static fast_sint_t libsais64_final_bwt_scan_left_to_right_8u_block_prepare(const
 
 static fast_sint_t libsais64_final_sorting_scan_left_to_right_8u_block_prepare(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-   const fast_sint_t prefetch_distance = 32;
+   const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
    memset(buckets, 0, k * sizeof(sa_sint_t));
 
@@ -4641,7 +5437,7 @@ static fast_sint_t libsais64_final_sorting_scan_left_to_right_8u_block_prepare(c
 
 static void libsais64_final_order_scan_left_to_right_8u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = 0, j = count - 3; i < j; i += 4)
@@ -4662,7 +5458,7 @@ static void libsais64_final_order_scan_left_to_right_8u_block_place(sa_sint_t *
 
 static void libsais64_final_bwt_aux_scan_left_to_right_8u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = 0, j = count - 3; i < j; i += 4)
@@ -4681,9 +5477,28 @@ static void libsais64_final_bwt_aux_scan_left_to_right_8u_block_place(sa_sint_t
     }
 }
 
+static void libsais64_final_bwt_aux_sa_scan_left_to_right_8u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = 0, j = count - 1; i < j; i += 2)
+    {
+        libsais64_prefetchr(&cache[i + prefetch_distance]);
+
+        sa_sint_t d0 = buckets[cache[i + 0].symbol]++; sa_sint_t p0 = cache[i + 0].index; SA[d0] = p0; p0 &= SAINT_MAX; if ((p0 & rm) == 0) { I[p0 / (rm + 1)] = d0 + 1; } if ((d0 & rm) == 0) { S[d0 / (rm + 1)] = p0; }
+        sa_sint_t d1 = buckets[cache[i + 1].symbol]++; sa_sint_t p1 = cache[i + 1].index; SA[d1] = p1; p1 &= SAINT_MAX; if ((p1 & rm) == 0) { I[p1 / (rm + 1)] = d1 + 1; } if ((d1 & rm) == 0) { S[d1 / (rm + 1)] = p1; }
+    }
+
+    for (j += 1; i < j; i += 1)
+    {
+        sa_sint_t d = buckets[cache[i].symbol]++; sa_sint_t p = cache[i].index; SA[d] = p; p &= SAINT_MAX; if ((p & rm) == 0) { I[p / (rm + 1)] = d + 1; } if ((d & rm) == 0) { S[d / (rm + 1)] = p; }
+    }
+}
+
 static void libsais64_final_sorting_scan_left_to_right_32s_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -4707,7 +5522,7 @@ static void libsais64_final_sorting_scan_left_to_right_32s_block_gather(const sa
 
 static void libsais64_final_sorting_scan_left_to_right_32s_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT induction_bucket, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j, omp_block_end = omp_block_start + omp_block_size;
     for (i = omp_block_start, j = omp_block_end - prefetch_distance - 1; i < j; i += 2)
@@ -4851,6 +5666,60 @@ static void libsais64_final_bwt_aux_scan_left_to_right_8u_block_omp(const uint8_
     }
 }
 
+static void libsais64_final_bwt_aux_sa_scan_left_to_right_8u_block_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT induction_bucket, fast_sint_t block_start, fast_sint_t block_size, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && block_size >= 64 * (k > 256 ? k : 256) && omp_get_dynamic() == 0)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(k); UNUSED(threads); UNUSED(thread_state);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (block_size / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : block_size - omp_block_start;
+
+        omp_block_start += block_start;
+
+        if (omp_num_threads == 1)
+        {
+            libsais64_final_bwt_aux_sa_scan_left_to_right_8u(T, SA, rm, I, S, induction_bucket, omp_block_start, omp_block_size);
+        }
+#if defined(LIBSAIS_OPENMP)
+        else
+        {
+            {
+                thread_state[omp_thread_num].state.count = libsais64_final_bwt_scan_left_to_right_8u_block_prepare(T, SA, k, thread_state[omp_thread_num].state.buckets, thread_state[omp_thread_num].state.cache, omp_block_start, omp_block_size);
+            }
+
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                fast_sint_t t;
+                for (t = 0; t < omp_num_threads; ++t)
+                {
+                    sa_sint_t * RESTRICT temp_bucket = thread_state[t].state.buckets;
+                    fast_sint_t c; for (c = 0; c < k; c += 1) { sa_sint_t A = induction_bucket[c], B = temp_bucket[c]; induction_bucket[c] = A + B; temp_bucket[c] = A; }
+                }
+            }
+
+            #pragma omp barrier
+
+            {
+                libsais64_final_bwt_aux_sa_scan_left_to_right_8u_block_place(SA, rm, I, S, thread_state[omp_thread_num].state.buckets, thread_state[omp_thread_num].state.cache, thread_state[omp_thread_num].state.count);
+            }
+        }
+#endif
+    }
+}
+
 static void libsais64_final_sorting_scan_left_to_right_8u_block_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT induction_bucket, fast_sint_t block_start, fast_sint_t block_size, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
 #if defined(LIBSAIS_OPENMP)
@@ -4976,7 +5845,9 @@ static void libsais64_final_bwt_scan_left_to_right_8u_omp(const uint8_t * RESTRI
             }
             else
             {
-                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
+                if (libsais64_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
                 fast_sint_t block_end     = block_start + 1; while (block_end < block_max_end && SA[block_end] != 0) { block_end++; }
                 fast_sint_t block_size    = block_end - block_start;
 
@@ -5022,7 +5893,9 @@ static void libsais64_final_bwt_aux_scan_left_to_right_8u_omp(const uint8_t * RE
             }
             else
             {
-                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
+                if (libsais64_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
                 fast_sint_t block_end     = block_start + 1; while (block_end < block_max_end && SA[block_end] != 0) { block_end++; }
                 fast_sint_t block_size    = block_end - block_start;
 
@@ -5046,13 +5919,16 @@ static void libsais64_final_bwt_aux_scan_left_to_right_8u_omp(const uint8_t * RE
 #endif
 }
 
-static void libsais64_final_sorting_scan_left_to_right_8u_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, fast_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+static void libsais64_final_bwt_aux_sa_scan_left_to_right_8u_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, fast_sint_t n, sa_sint_t k, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
     SA[induction_bucket[T[(sa_sint_t)n - 1]]++] = ((sa_sint_t)n - 1) | ((sa_sint_t)(T[(sa_sint_t)n - 2] < T[(sa_sint_t)n - 1]) << (SAINT_BIT - 1));
 
+    if ((((sa_sint_t)n - 1) & rm) == 0) { I[((sa_sint_t)n - 1) / (rm + 1)] = induction_bucket[T[(sa_sint_t)n - 1]]; }
+    if (((induction_bucket[T[(sa_sint_t)n - 1]] - 1) & rm) == 0) { S[(induction_bucket[T[(sa_sint_t)n - 1]] - 1) / (rm + 1)] = (sa_sint_t)n - 1; }
+
     if (threads == 1 || n < 65536)
     {
-        libsais64_final_sorting_scan_left_to_right_8u(T, SA, induction_bucket, 0, n);
+        libsais64_final_bwt_aux_sa_scan_left_to_right_8u(T, SA, rm, I, S, induction_bucket, 0, n);
     }
 #if defined(LIBSAIS_OPENMP)
     else
@@ -5066,7 +5942,9 @@ static void libsais64_final_sorting_scan_left_to_right_8u_omp(const uint8_t * RE
             }
             else
             {
-                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
+                if (libsais64_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
                 fast_sint_t block_end     = block_start + 1; while (block_end < block_max_end && SA[block_end] != 0) { block_end++; }
                 fast_sint_t block_size    = block_end - block_start;
 
@@ -5074,12 +5952,12 @@ static void libsais64_final_sorting_scan_left_to_right_8u_omp(const uint8_t * RE
                 {
                     for (; block_start < block_end; block_start += 1)
                     {
-                        sa_sint_t p = SA[block_start]; SA[block_start] = p ^ SAINT_MIN; if (p > 0) { p--; SA[induction_bucket[T[p]]++] = p | ((sa_sint_t)(T[p - (p > 0)] < T[p]) << (SAINT_BIT - 1)); }
+                        sa_sint_t p = SA[block_start]; SA[block_start] = p & SAINT_MAX; if (p > 0) { p--; SA[block_start] = T[p] | SAINT_MIN; sa_sint_t d = induction_bucket[T[p]]++; SA[d] = p | ((sa_sint_t)(T[p - (p > 0)] < T[p]) << (SAINT_BIT - 1)); if ((p & rm) == 0) { I[p / (rm + 1)] = d + 1; } if ((d & rm) == 0) { S[d / (rm + 1)] = p; } }
                     }
                 }
                 else
                 {
-                    libsais64_final_sorting_scan_left_to_right_8u_block_omp(T, SA, k, induction_bucket, block_start, block_size, threads, thread_state);
+                    libsais64_final_bwt_aux_sa_scan_left_to_right_8u_block_omp(T, SA, k, rm, I, S, induction_bucket, block_start, block_size, threads, thread_state);
                     block_start = block_end;
                 }
             }
@@ -5090,38 +5968,86 @@ static void libsais64_final_sorting_scan_left_to_right_8u_omp(const uint8_t * RE
 #endif
 }
 
-static void libsais64_final_sorting_scan_left_to_right_32s_omp(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+static void libsais64_final_sorting_scan_left_to_right_8u_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, fast_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
-    SA[induction_bucket[T[n - 1]]++] = (n - 1) | ((sa_sint_t)(T[n - 2] < T[n - 1]) << (SAINT_BIT - 1));
+    SA[induction_bucket[T[(sa_sint_t)n - 1]]++] = ((sa_sint_t)n - 1) | ((sa_sint_t)(T[(sa_sint_t)n - 2] < T[(sa_sint_t)n - 1]) << (SAINT_BIT - 1));
 
     if (threads == 1 || n < 65536)
     {
-        libsais64_final_sorting_scan_left_to_right_32s(T, SA, induction_bucket, 0, n);
+        libsais64_final_sorting_scan_left_to_right_8u(T, SA, induction_bucket, 0, n);
     }
 #if defined(LIBSAIS_OPENMP)
     else
     {
-        fast_sint_t block_start, block_end;
-        for (block_start = 0; block_start < n; block_start = block_end)
+        fast_sint_t block_start;
+        for (block_start = 0; block_start < n; )
         {
-            block_end = block_start + (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end > n) { block_end = n; }
-
-            libsais64_final_sorting_scan_left_to_right_32s_block_omp(T, SA, induction_bucket, thread_state[0].state.cache, block_start, block_end - block_start, threads);
-        }
-    }
-#else
-    UNUSED(thread_state);
-#endif
-}
+            if (SA[block_start] == 0)
+            {
+                block_start++;
+            }
+            else
+            {
+                if (libsais64_cancelled(thread_state[0].state.monitor)) { break; }
 
-static sa_sint_t libsais64_final_bwt_scan_right_to_left_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
-{
-    const fast_sint_t prefetch_distance = 32;
+                fast_sint_t block_max_end = block_start + ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end > n) { block_max_end = n;}
+                fast_sint_t block_end     = block_start + 1; while (block_end < block_max_end && SA[block_end] != 0) { block_end++; }
+                fast_sint_t block_size    = block_end - block_start;
 
-    fast_sint_t i, j; sa_sint_t index = -1;
-    for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
-    {
-        libsais64_prefetchw(&SA[i - 2 * prefetch_distance]);
+                if (block_size < 32)
+                {
+                    for (; block_start < block_end; block_start += 1)
+                    {
+                        sa_sint_t p = SA[block_start]; SA[block_start] = p ^ SAINT_MIN; if (p > 0) { p--; SA[induction_bucket[T[p]]++] = p | ((sa_sint_t)(T[p - (p > 0)] < T[p]) << (SAINT_BIT - 1)); }
+                    }
+                }
+                else
+                {
+                    libsais64_final_sorting_scan_left_to_right_8u_block_omp(T, SA, k, induction_bucket, block_start, block_size, threads, thread_state);
+                    block_start = block_end;
+                }
+            }
+        }
+    }
+#else
+    UNUSED(k); UNUSED(thread_state);
+#endif
+}
+
+static void libsais64_final_sorting_scan_left_to_right_32s_omp(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+{
+    SA[induction_bucket[T[n - 1]]++] = (n - 1) | ((sa_sint_t)(T[n - 2] < T[n - 1]) << (SAINT_BIT - 1));
+
+    if (threads == 1 || n < 65536)
+    {
+        libsais64_final_sorting_scan_left_to_right_32s(T, SA, induction_bucket, 0, n);
+    }
+#if defined(LIBSAIS_OPENMP)
+    else
+    {
+        fast_sint_t block_start, block_end;
+        for (block_start = 0; block_start < n; block_start = block_end)
+        {
+            if (libsais64_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start + (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end > n) { block_end = n; }
+
+            libsais64_final_sorting_scan_left_to_right_32s_block_omp(T, SA, induction_bucket, thread_state[0].state.cache, block_start, block_end - block_start, threads);
+        }
+    }
+#else
+    UNUSED(thread_state);
+#endif
+}
+
+static sa_sint_t libsais64_final_bwt_scan_right_to_left_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j; sa_sint_t index = -1;
+    for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
+    {
+        libsais64_prefetchw(&SA[i - 2 * prefetch_distance]);
 
         sa_sint_t s0 = SA[i - prefetch_distance - 0]; const uint8_t * Ts0 = &T[s0] - 1; libsais64_prefetchr(s0 > 0 ? Ts0 : NULL); Ts0--; libsais64_prefetchr(s0 > 0 ? Ts0 : NULL);
         sa_sint_t s1 = SA[i - prefetch_distance - 1]; const uint8_t * Ts1 = &T[s1] - 1; libsais64_prefetchr(s1 > 0 ? Ts1 : NULL); Ts1--; libsais64_prefetchr(s1 > 0 ? Ts1 : NULL);
@@ -5144,7 +6070,7 @@ static sa_sint_t libsais64_final_bwt_scan_right_to_left_8u(const uint8_t * RESTR
 
 static void libsais64_final_bwt_aux_scan_right_to_left_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
@@ -5168,9 +6094,35 @@ static void libsais64_final_bwt_aux_scan_right_to_left_8u(const uint8_t * RESTRI
     }
 }
 
+static void libsais64_final_bwt_aux_sa_scan_right_to_left_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
+    {
+        libsais64_prefetchw(&SA[i - 2 * prefetch_distance]);
+
+        sa_sint_t s0 = SA[i - prefetch_distance - 0]; const uint8_t * Ts0 = &T[s0] - 1; libsais64_prefetchr(s0 > 0 ? Ts0 : NULL); Ts0--; libsais64_prefetchr(s0 > 0 ? Ts0 : NULL);
+        sa_sint_t s1 = SA[i - prefetch_distance - 1]; const uint8_t * Ts1 = &T[s1] - 1; libsais64_prefetchr(s1 > 0 ? Ts1 : NULL); Ts1--; libsais64_prefetchr(s1 > 0 ? Ts1 : NULL);
+
+        sa_sint_t p0 = SA[i - 0];
+        SA[i - 0] = p0 & SAINT_MAX; if (p0 > 0) { p0--; uint8_t c0 = T[p0 - (p0 > 0)], c1 = T[p0]; SA[i - 0] = c1; sa_sint_t t = c0 | SAINT_MIN; sa_sint_t d0 = --induction_bucket[c1]; SA[d0] = (c0 <= c1) ? p0 : t; if ((p0 & rm) == 0) { I[p0 / (rm + 1)] = d0 + 1; } if ((d0 & rm) == 0) { S[d0 / (rm + 1)] = p0; } }
+
+        sa_sint_t p1 = SA[i - 1];
+        SA[i - 1] = p1 & SAINT_MAX; if (p1 > 0) { p1--; uint8_t c0 = T[p1 - (p1 > 0)], c1 = T[p1]; SA[i - 1] = c1; sa_sint_t t = c0 | SAINT_MIN; sa_sint_t d1 = --induction_bucket[c1]; SA[d1] = (c0 <= c1) ? p1 : t; if ((p1 & rm) == 0) { I[p1 / (rm + 1)] = d1 + 1; } if ((d1 & rm) == 0) { S[d1 / (rm + 1)] = p1; } }
+    }
+
+    for (j -= prefetch_distance + 1; i >= j; i -= 1)
+    {
+        sa_sint_t p = SA[i];
+        SA[i] = p & SAINT_MAX; if (p > 0) { p--; uint8_t c0 = T[p - (p > 0)], c1 = T[p]; SA[i] = c1; sa_sint_t t = c0 | SAINT_MIN; sa_sint_t d = --induction_bucket[c1]; SA[d] = (c0 <= c1) ? p : t; if ((p & rm) == 0) { I[p / (rm + 1)] = d + 1; } if ((d & rm) == 0) { S[d / (rm + 1)] = p; } }
+    }
+}
+
 static void libsais64_final_sorting_scan_right_to_left_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
@@ -5192,7 +6144,7 @@ static void libsais64_final_sorting_scan_right_to_left_8u(const uint8_t * RESTRI
 
 static void libsais64_final_sorting_scan_right_to_left_32s(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT induction_bucket, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + 2 * prefetch_distance + 1; i >= j; i -= 2)
@@ -5218,7 +6170,7 @@ static void libsais64_final_sorting_scan_right_to_left_32s(const sa_sint_t * RES
 
 static fast_sint_t libsais64_final_bwt_scan_right_to_left_8u_block_prepare(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-   const fast_sint_t prefetch_distance = 32;
+   const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
    memset(buckets, 0, k * sizeof(sa_sint_t));
 
@@ -5244,7 +6196,7 @@ static fast_sint_t libsais64_final_bwt_scan_right_to_left_8u_block_prepare(const
 
 static fast_sint_t libsais64_final_bwt_aux_scan_right_to_left_8u_block_prepare(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-   const fast_sint_t prefetch_distance = 32;
+   const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
    memset(buckets, 0, k * sizeof(sa_sint_t));
 
@@ -5270,7 +6222,7 @@ static fast_sint_t libsais64_final_bwt_aux_scan_right_to_left_8u_block_prepare(c
 
 static fast_sint_t libsais64_final_sorting_scan_right_to_left_8u_block_prepare(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-   const fast_sint_t prefetch_distance = 32;
+   const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
    memset(buckets, 0, k * sizeof(sa_sint_t));
 
@@ -5296,7 +6248,7 @@ static fast_sint_t libsais64_final_sorting_scan_right_to_left_8u_block_prepare(c
 
 static void libsais64_final_order_scan_right_to_left_8u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = 0, j = count - 3; i < j; i += 4)
@@ -5317,7 +6269,7 @@ static void libsais64_final_order_scan_right_to_left_8u_block_place(sa_sint_t *
 
 static void libsais64_final_bwt_aux_scan_right_to_left_8u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = 0, j = count - 6; i < j; i += 8)
@@ -5336,9 +6288,28 @@ static void libsais64_final_bwt_aux_scan_right_to_left_8u_block_place(sa_sint_t
     }
 }
 
+static void libsais64_final_bwt_aux_sa_scan_right_to_left_8u_block_place(sa_sint_t * RESTRICT SA, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT buckets, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t count)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = 0, j = count - 2; i < j; i += 4)
+    {
+        libsais64_prefetchr(&cache[i + prefetch_distance]);
+
+        sa_sint_t d0 = --buckets[cache[i + 0].symbol]; SA[d0] = cache[i + 0].index; sa_sint_t p0 = cache[i + 1].index; if ((p0 & rm) == 0) { I[p0 / (rm + 1)] = d0 + 1; } if ((d0 & rm) == 0) { S[d0 / (rm + 1)] = p0; }
+        sa_sint_t d1 = --buckets[cache[i + 2].symbol]; SA[d1] = cache[i + 2].index; sa_sint_t p1 = cache[i + 3].index; if ((p1 & rm) == 0) { I[p1 / (rm + 1)] = d1 + 1; } if ((d1 & rm) == 0) { S[d1 / (rm + 1)] = p1; }
+    }
+
+    for (j += 2; i < j; i += 2)
+    {
+        sa_sint_t d = --buckets[cache[i].symbol]; SA[d] = cache[i].index; sa_sint_t p = cache[i + 1].index; if ((p & rm) == 0) { I[p / (rm + 1)] = d + 1; } if ((d & rm) == 0) { S[d / (rm + 1)] = p; }
+    }
+}
+
 static void libsais64_final_sorting_scan_right_to_left_32s_block_gather(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 1; i < j; i += 2)
@@ -5362,7 +6333,7 @@ static void libsais64_final_sorting_scan_right_to_left_32s_block_gather(const sa
 
 static void libsais64_final_sorting_scan_right_to_left_32s_block_sort(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT induction_bucket, LIBSAIS_THREAD_CACHE * RESTRICT cache, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
     for (i = omp_block_start + omp_block_size - 1, j = omp_block_start + prefetch_distance + 1; i >= j; i -= 2)
@@ -5506,6 +6477,60 @@ static void libsais64_final_bwt_aux_scan_right_to_left_8u_block_omp(const uint8_
     }
 }
 
+static void libsais64_final_bwt_aux_sa_scan_right_to_left_8u_block_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT induction_bucket, fast_sint_t block_start, fast_sint_t block_size, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && block_size >= 64 * (k > 256 ? k : 256) && omp_get_dynamic() == 0)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(k); UNUSED(threads); UNUSED(thread_state);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (block_size / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : block_size - omp_block_start;
+
+        omp_block_start += block_start;
+
+        if (omp_num_threads == 1)
+        {
+            libsais64_final_bwt_aux_sa_scan_right_to_left_8u(T, SA, rm, I, S, induction_bucket, omp_block_start, omp_block_size);
+        }
+#if defined(LIBSAIS_OPENMP)
+        else
+        {
+            {
+                thread_state[omp_thread_num].state.count = libsais64_final_bwt_aux_scan_right_to_left_8u_block_prepare(T, SA, k, thread_state[omp_thread_num].state.buckets, thread_state[omp_thread_num].state.cache, omp_block_start, omp_block_size);
+            }
+
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                fast_sint_t t;
+                for (t = omp_num_threads - 1; t >= 0; --t)
+                {
+                    sa_sint_t * RESTRICT temp_bucket = thread_state[t].state.buckets;
+                    fast_sint_t c; for (c = 0; c < k; c += 1) { sa_sint_t A = induction_bucket[c], B = temp_bucket[c]; induction_bucket[c] = A - B; temp_bucket[c] = A; }
+                }
+            }
+
+            #pragma omp barrier
+
+            {
+                libsais64_final_bwt_aux_sa_scan_right_to_left_8u_block_place(SA, rm, I, S, thread_state[omp_thread_num].state.buckets, thread_state[omp_thread_num].state.cache, thread_state[omp_thread_num].state.count);
+            }
+        }
+#endif
+    }
+}
+
 static void libsais64_final_sorting_scan_right_to_left_8u_block_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT induction_bucket, fast_sint_t block_start, fast_sint_t block_size, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
 #if defined(LIBSAIS_OPENMP)
@@ -5631,7 +6656,9 @@ static sa_sint_t libsais64_final_bwt_scan_right_to_left_8u_omp(const uint8_t * R
             }
             else
             {
-                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end < 0) { block_max_end = -1; }
+                if (libsais64_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end < 0) { block_max_end = -1; }
                 fast_sint_t block_end     = block_start - 1; while (block_end > block_max_end && SA[block_end] != 0) { block_end--; }
                 fast_sint_t block_size    = block_start - block_end;
 
@@ -5675,7 +6702,9 @@ static void libsais64_final_bwt_aux_scan_right_to_left_8u_omp(const uint8_t * RE
             }
             else
             {
-                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * ((LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads) / 2); if (block_max_end < 0) { block_max_end = -1; }
+                if (libsais64_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * ((thread_state[0].state.cache_size - 16 * (fast_sint_t)threads) / 2); if (block_max_end < 0) { block_max_end = -1; }
                 fast_sint_t block_end     = block_start - 1; while (block_end > block_max_end && SA[block_end] != 0) { block_end--; }
                 fast_sint_t block_size    = block_start - block_end;
 
@@ -5699,6 +6728,50 @@ static void libsais64_final_bwt_aux_scan_right_to_left_8u_omp(const uint8_t * RE
 #endif
 }
 
+static void libsais64_final_bwt_aux_sa_scan_right_to_left_8u_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t rm, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+{
+    if (threads == 1 || n < 65536)
+    {
+        libsais64_final_bwt_aux_sa_scan_right_to_left_8u(T, SA, rm, I, S, induction_bucket, 0, n);
+    }
+#if defined(LIBSAIS_OPENMP)
+    else
+    {
+        fast_sint_t block_start;
+        for (block_start = (fast_sint_t)n - 1; block_start >= 0; )
+        {
+            if (SA[block_start] == 0)
+            {
+                block_start--;
+            }
+            else
+            {
+                if (libsais64_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * ((thread_state[0].state.cache_size - 16 * (fast_sint_t)threads) / 2); if (block_max_end < 0) { block_max_end = -1; }
+                fast_sint_t block_end     = block_start - 1; while (block_end > block_max_end && SA[block_end] != 0) { block_end--; }
+                fast_sint_t block_size    = block_start - block_end;
+
+                if (block_size < 32)
+                {
+                    for (; block_start > block_end; block_start -= 1)
+                    {
+                        sa_sint_t p = SA[block_start]; SA[block_start] = p & SAINT_MAX; if (p > 0) { p--; uint8_t c0 = T[p - (p > 0)], c1 = T[p]; SA[block_start] = c1; sa_sint_t t = c0 | SAINT_MIN; sa_sint_t d = --induction_bucket[c1]; SA[d] = (c0 <= c1) ? p : t; if ((p & rm) == 0) { I[p / (rm + 1)] = d + 1; } if ((d & rm) == 0) { S[d / (rm + 1)] = p; } }
+                    }
+                }
+                else
+                {
+                    libsais64_final_bwt_aux_sa_scan_right_to_left_8u_block_omp(T, SA, k, rm, I, S, induction_bucket, block_end + 1, block_size, threads, thread_state);
+                    block_start = block_end;
+                }
+            }
+        }
+    }
+#else
+    UNUSED(k); UNUSED(thread_state);
+#endif
+}
+
 static void libsais64_final_sorting_scan_right_to_left_8u_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t * RESTRICT induction_bucket, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
     if (threads == 1 || n < 65536)
@@ -5717,7 +6790,9 @@ static void libsais64_final_sorting_scan_right_to_left_8u_omp(const uint8_t * RE
             }
             else
             {
-                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * (LIBSAIS_PER_THREAD_CACHE_SIZE - 16 * (fast_sint_t)threads); if (block_max_end < -1) { block_max_end = -1; }
+                if (libsais64_cancelled(thread_state[0].state.monitor)) { break; }
+
+                fast_sint_t block_max_end = block_start - ((fast_sint_t)threads) * (thread_state[0].state.cache_size - 16 * (fast_sint_t)threads); if (block_max_end < -1) { block_max_end = -1; }
                 fast_sint_t block_end     = block_start - 1; while (block_end > block_max_end && SA[block_end] != 0) { block_end--; }
                 fast_sint_t block_size    = block_start - block_end;
 
@@ -5753,7 +6828,9 @@ static void libsais64_final_sorting_scan_right_to_left_32s_omp(const sa_sint_t *
         fast_sint_t block_start, block_end;
         for (block_start = (fast_sint_t)n - 1; block_start >= 0; block_start = block_end)
         {
-            block_end = block_start - (fast_sint_t)threads * LIBSAIS_PER_THREAD_CACHE_SIZE; if (block_end < 0) { block_end = -1; }
+            if (libsais64_cancelled(thread_state[0].state.monitor)) { break; }
+
+            block_end = block_start - (fast_sint_t)threads * thread_state[0].state.cache_size; if (block_end < 0) { block_end = -1; }
 
             libsais64_final_sorting_scan_right_to_left_32s_block_omp(T, SA, induction_bucket, thread_state[0].state.cache, block_end + 1, block_start - block_end, threads);
         }
@@ -5781,7 +6858,7 @@ static void libsais64_clear_lms_suffixes_omp(sa_sint_t * RESTRICT SA, sa_sint_t
     }
 }
 
-static sa_sint_t libsais64_induce_final_order_8u_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t bwt, sa_sint_t r, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT buckets, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+static sa_sint_t libsais64_induce_final_order_8u_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t bwt, sa_sint_t r, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t * RESTRICT buckets, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
 {
     if (!bwt)
     {
@@ -5790,6 +6867,13 @@ static sa_sint_t libsais64_induce_final_order_8u_omp(const uint8_t * RESTRICT T,
         libsais64_final_sorting_scan_right_to_left_8u_omp(T, SA, n, k, &buckets[7 * ALPHABET_SIZE], threads, thread_state);
         return 0;
     }
+    else if (S != NULL)
+    {
+        libsais64_final_bwt_aux_sa_scan_left_to_right_8u_omp(T, SA, n, k, r - 1, I, S, &buckets[6 * ALPHABET_SIZE], threads, thread_state);
+        if (threads > 1 && n >= 65536) { libsais64_clear_lms_suffixes_omp(SA, n, ALPHABET_SIZE, &buckets[6 * ALPHABET_SIZE], &buckets[7 * ALPHABET_SIZE], threads); }
+        libsais64_final_bwt_aux_sa_scan_right_to_left_8u_omp(T, SA, n, k, r - 1, I, S, &buckets[7 * ALPHABET_SIZE], threads, thread_state);
+        return 0;
+    }
     else if (I != NULL)
     {
         libsais64_final_bwt_aux_scan_left_to_right_8u_omp(T, SA, n, k, r - 1, I, &buckets[6 * ALPHABET_SIZE], threads, thread_state);
@@ -5836,7 +6920,7 @@ static void libsais64_induce_final_order_32s_1k(const sa_sint_t * RESTRICT T, sa
 
 static sa_sint_t libsais64_renumber_unique_and_nonunique_lms_suffixes_32s(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t m, sa_sint_t f, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAm = &SA[m];
 
@@ -5871,7 +6955,7 @@ static sa_sint_t libsais64_renumber_unique_and_nonunique_lms_suffixes_32s(sa_sin
 
 static void libsais64_compact_unique_and_nonunique_lms_suffixes_32s(sa_sint_t * RESTRICT SA, sa_sint_t m, fast_sint_t * pl, fast_sint_t * pr, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAl = &SA[0];
     sa_sint_t * RESTRICT SAr = &SA[0];
@@ -5900,7 +6984,7 @@ static void libsais64_compact_unique_and_nonunique_lms_suffixes_32s(sa_sint_t *
 
 static sa_sint_t libsais64_count_unique_suffixes(sa_sint_t * RESTRICT SA, sa_sint_t m, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     sa_sint_t * RESTRICT SAm = &SA[m];
 
@@ -6060,7 +7144,7 @@ static sa_sint_t libsais64_compact_lms_suffixes_32s_omp(sa_sint_t * RESTRICT T,
 
 static void libsais64_merge_unique_lms_suffixes_32s(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t m, fast_sint_t l, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     const sa_sint_t * RESTRICT SAnm = &SA[(fast_sint_t)n - (fast_sint_t)m - 1 + l];
 
@@ -6083,7 +7167,7 @@ static void libsais64_merge_unique_lms_suffixes_32s(sa_sint_t * RESTRICT T, sa_s
 
 static void libsais64_merge_nonunique_lms_suffixes_32s(sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t m, fast_sint_t l, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     const sa_sint_t * RESTRICT SAnm = &SA[(fast_sint_t)n - (fast_sint_t)m - 1 + l];
 
@@ -6301,53 +7385,86 @@ static void libsais64_convert_inplace_32u_to_64u_omp(uint32_t * V, sa_sint_t n,
     libsais64_convert_inplace_32u_to_64u(V, 0, n);
 }
 
-static sa_sint_t libsais64_main_32s_recursion(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t * RESTRICT local_buffer)
+static sa_sint_t libsais64_adaptive_threads(const LIBSAIS_MONITOR * monitor, sa_sint_t threads, sa_sint_t n, sa_sint_t k)
+{
+    if (monitor == NULL || monitor->thread_block_size <= 0) { return threads; }
+
+    fast_sint_t block_size  = (fast_sint_t)k * 16 > (fast_sint_t)monitor->thread_block_size ? (fast_sint_t)k * 16 : (fast_sint_t)monitor->thread_block_size;
+    fast_sint_t max_threads = (fast_sint_t)n / block_size;
+
+    return max_threads < (fast_sint_t)threads ? (max_threads > 1 ? (sa_sint_t)max_threads : 1) : threads;
+}
+
+static sa_sint_t libsais64_main_32s_recursion(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t * RESTRICT local_buffer, sa_sint_t local_buffer_size, const LIBSAIS_ALLOCATOR * allocator, const void * ctx32, LIBSAIS_MONITOR * monitor, sa_sint_t depth)
 {
     fs = fs < (SAINT_MAX - n) ? fs : (SAINT_MAX - n);
+    threads = libsais64_adaptive_threads(monitor, threads, n, k);
+
+    if (libsais64_cancelled(monitor)) { return -5; }
 
     if (n <= INT32_MAX)
     {
         sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
         if ((new_fs / k >= 6) || (new_fs / k >= 4 && n <= INT32_MAX / 2) || (new_fs / k < 4 && new_fs >= fs))
         {
+            libsais64_profile(monitor, LIBSAIS64_PHASE_LEVEL, 0, depth, n, k, LIBSAIS64_PROFILE_DELEGATED);
             libsais64_convert_inplace_64u_to_32u((uint32_t *)(void *)T, 0, n);
 
 #if defined(LIBSAIS_OPENMP)
-            sa_sint_t index = libsais_int_omp((int32_t *)T, (int32_t *)SA, (int32_t)n, (int32_t)k, (int32_t)new_fs, (int32_t)threads);
+            sa_sint_t index = ctx32 != NULL
+                ? libsais_int_ctx(ctx32, (int32_t *)T, (int32_t *)SA, (int32_t)n, (int32_t)k, (int32_t)new_fs)
+                : libsais_int_omp((int32_t *)T, (int32_t *)SA, (int32_t)n, (int32_t)k, (int32_t)new_fs, (int32_t)threads);
 #else
-            sa_sint_t index = libsais_int((int32_t *)T, (int32_t *)SA, (int32_t)n, (int32_t)k, (int32_t)new_fs);
+            sa_sint_t index = ctx32 != NULL
+                ? libsais_int_ctx(ctx32, (int32_t *)T, (int32_t *)SA, (int32_t)n, (int32_t)k, (int32_t)new_fs)
+                : libsais_int((int32_t *)T, (int32_t *)SA, (int32_t)n, (int32_t)k, (int32_t)new_fs);
 #endif
             if (index >= 0)
             {
                 libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)SA, n, threads);
+                if (depth == 0) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)T, n, threads); }
             }
 
+            libsais64_profile(monitor, LIBSAIS64_PHASE_LEVEL, 1, depth, n, k, LIBSAIS64_PROFILE_DELEGATED);
             return index;
         }
     }
 
-    if (k > 0 && ((fs / k >= 6) || (LIBSAIS_LOCAL_BUFFER_SIZE / k >= 6 && threads == 1)))
+    if (k > 0 && ((fs / k >= 6) || (local_buffer_size / k >= 6 && threads == 1)))
     {
         sa_sint_t alignment = (fs - 1024) / k >= 6 ? (sa_sint_t)1024 : (sa_sint_t)16;
         sa_sint_t * RESTRICT buckets = (fs - alignment) / k >= 6 ? (sa_sint_t *)libsais64_align_up(&SA[n + fs - 6 * (fast_sint_t)k - alignment], (size_t)alignment * sizeof(sa_sint_t)) : &SA[n + fs - 6 * (fast_sint_t)k];
-        buckets = (LIBSAIS_LOCAL_BUFFER_SIZE / k >= 6 && threads == 1) ? local_buffer : buckets;
+        buckets = (local_buffer_size / k >= 6 && threads == 1) ? local_buffer : buckets;
+
+        sa_sint_t flags = LIBSAIS64_PROFILE_6K | (buckets == local_buffer ? LIBSAIS64_PROFILE_LOCAL_BUFFER : LIBSAIS64_PROFILE_FREE_SPACE);
+        libsais64_profile(monitor, LIBSAIS64_PHASE_LEVEL, 0, depth, n, k, flags);
 
+        libsais64_profile(monitor, LIBSAIS64_PHASE_GATHER, 0, depth, n, k, flags);
         sa_sint_t m = libsais64_count_and_gather_lms_suffixes_32s_4k_omp(T, SA, n, k, buckets, threads, thread_state);
+        libsais64_profile(monitor, LIBSAIS64_PHASE_GATHER, 1, depth, n, k, flags);
+
         if (m > 1)
         {
+            libsais64_profile(monitor, LIBSAIS64_PHASE_RADIX_SORT, 0, depth, n, k, flags);
             memset(SA, 0, ((size_t)n - (size_t)m) * sizeof(sa_sint_t));
 
             sa_sint_t first_lms_suffix    = SA[n - m];
             sa_sint_t left_suffixes_count = libsais64_initialize_buckets_for_lms_suffixes_radix_sort_32s_6k(T, k, buckets, first_lms_suffix);
 
-            libsais64_radix_sort_lms_suffixes_32s_6k_omp(T, SA, n, m, &buckets[4 * (fast_sint_t)k], threads, thread_state);
+            libsais64_radix_sort_lms_suffixes_32s_6k_omp(T, SA, n, m, &buckets[4 * (fast_sint_t)k], libsais64_adaptive_threads(monitor, threads, m, k), thread_state);
 
             if ((n / 8192) < k) { libsais64_radix_sort_set_markers_32s_6k_omp(SA, k, &buckets[4 * (fast_sint_t)k], threads); }
             if (threads > 1 && n >= 65536) { memset(&SA[(fast_sint_t)n - (fast_sint_t)m], 0, (size_t)m * sizeof(sa_sint_t)); }
+            libsais64_profile(monitor, LIBSAIS64_PHASE_RADIX_SORT, 1, depth, n, k, flags);
+            if (libsais64_cancelled(monitor)) { return -5; }
 
+            libsais64_profile(monitor, LIBSAIS64_PHASE_PARTIAL_SORT, 0, depth, n, k, flags);
             libsais64_initialize_buckets_for_partial_sorting_32s_6k(T, k, buckets, first_lms_suffix, left_suffixes_count);
             libsais64_induce_partial_order_32s_6k_omp(T, SA, n, k, buckets, first_lms_suffix, left_suffixes_count, threads, thread_state);
+            libsais64_profile(monitor, LIBSAIS64_PHASE_PARTIAL_SORT, 1, depth, n, k, flags);
+            if (libsais64_cancelled(monitor)) { return -5; }
 
+            libsais64_profile(monitor, LIBSAIS64_PHASE_RENUMBER, 0, depth, n, k, flags);
             sa_sint_t names = (n / 8192) < k
                 ? libsais64_renumber_and_mark_distinct_lms_suffixes_32s_4k_omp(SA, n, m, threads, thread_state)
                 : libsais64_renumber_and_gather_lms_suffixes_omp(SA, n, m, fs, threads, thread_state);
@@ -6357,65 +7474,95 @@ static sa_sint_t libsais64_main_32s_recursion(sa_sint_t * RESTRICT T, sa_sint_t
                 sa_sint_t f = (n / 8192) < k
                     ? libsais64_compact_lms_suffixes_32s_omp(T, SA, n, m, fs, threads, thread_state)
                     : 0;
+                libsais64_profile(monitor, LIBSAIS64_PHASE_RENUMBER, 1, depth, m, names, flags);
 
-                if (libsais64_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer) != 0)
+                sa_sint_t status = libsais64_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer, local_buffer_size, allocator, ctx32, monitor, depth + 1);
+                if (status != 0)
                 {
-                    return -2;
+                    return status;
                 }
 
+                libsais64_profile(monitor, LIBSAIS64_PHASE_RECONSTRUCT, 0, depth, n, k, flags);
                 libsais64_reconstruct_compacted_lms_suffixes_32s_2k_omp(T, SA, n, k, m, fs, f, buckets, threads, thread_state);
+                libsais64_profile(monitor, LIBSAIS64_PHASE_RECONSTRUCT, 1, depth, n, k, flags);
             }
             else
             {
+                libsais64_profile(monitor, LIBSAIS64_PHASE_RENUMBER, 1, depth, m, names, flags);
                 libsais64_count_lms_suffixes_32s_2k(T, n, k, buckets);
             }
 
+            libsais64_profile(monitor, LIBSAIS64_PHASE_FINAL_SORT, 0, depth, n, k, flags);
             libsais64_initialize_buckets_start_and_end_32s_4k(k, buckets);
             libsais64_place_lms_suffixes_histogram_32s_4k(SA, n, k, m, buckets);
             libsais64_induce_final_order_32s_4k(T, SA, n, k, buckets, threads, thread_state);
+            libsais64_profile(monitor, LIBSAIS64_PHASE_FINAL_SORT, 1, depth, n, k, flags);
+            if (libsais64_cancelled(monitor)) { return -5; }
         }
         else
         {
+            libsais64_profile(monitor, LIBSAIS64_PHASE_FINAL_SORT, 0, depth, n, k, flags);
             SA[0] = SA[n - 1];
 
             libsais64_initialize_buckets_start_and_end_32s_6k(k, buckets);
             libsais64_place_lms_suffixes_histogram_32s_6k(SA, n, k, m, buckets);
             libsais64_induce_final_order_32s_6k(T, SA, n, k, buckets, threads, thread_state);
+            libsais64_profile(monitor, LIBSAIS64_PHASE_FINAL_SORT, 1, depth, n, k, flags);
+            if (libsais64_cancelled(monitor)) { return -5; }
         }
 
+        libsais64_profile(monitor, LIBSAIS64_PHASE_LEVEL, 1, depth, n, k, flags);
         return 0;
     }
-    else if (k > 0 && (n <= SAINT_MAX / 2) && ((fs / k >= 4) || (LIBSAIS_LOCAL_BUFFER_SIZE / k >= 4 && threads == 1)))
+    else if (k > 0 && (n <= SAINT_MAX / 2) && ((fs / k >= 4) || (local_buffer_size / k >= 4 && threads == 1)))
     {
         sa_sint_t alignment = (fs - 1024) / k >= 4 ? (sa_sint_t)1024 : (sa_sint_t)16;
         sa_sint_t * RESTRICT buckets = (fs - alignment) / k >= 4 ? (sa_sint_t *)libsais64_align_up(&SA[n + fs - 4 * (fast_sint_t)k - alignment], (size_t)alignment * sizeof(sa_sint_t)) : &SA[n + fs - 4 * (fast_sint_t)k];
-        buckets = (LIBSAIS_LOCAL_BUFFER_SIZE / k >= 4 && threads == 1) ? local_buffer : buckets;
+        buckets = (local_buffer_size / k >= 4 && threads == 1) ? local_buffer : buckets;
+
+        sa_sint_t flags = LIBSAIS64_PROFILE_4K | (buckets == local_buffer ? LIBSAIS64_PROFILE_LOCAL_BUFFER : LIBSAIS64_PROFILE_FREE_SPACE);
+        libsais64_profile(monitor, LIBSAIS64_PHASE_LEVEL, 0, depth, n, k, flags);
 
+        libsais64_profile(monitor, LIBSAIS64_PHASE_GATHER, 0, depth, n, k, flags);
         sa_sint_t m = libsais64_count_and_gather_lms_suffixes_32s_2k_omp(T, SA, n, k, buckets, threads, thread_state);
+        libsais64_profile(monitor, LIBSAIS64_PHASE_GATHER, 1, depth, n, k, flags);
+
         if (m > 1)
         {
+            libsais64_profile(monitor, LIBSAIS64_PHASE_RADIX_SORT, 0, depth, n, k, flags);
             libsais64_initialize_buckets_for_radix_and_partial_sorting_32s_4k(T, k, buckets, SA[n - m]);
 
-            libsais64_radix_sort_lms_suffixes_32s_2k_omp(T, SA, n, m, &buckets[1], threads, thread_state);
+            libsais64_radix_sort_lms_suffixes_32s_2k_omp(T, SA, n, m, &buckets[1], libsais64_adaptive_threads(monitor, threads, m, k), thread_state);
             libsais64_radix_sort_set_markers_32s_4k_omp(SA, k, &buckets[1], threads);
+            libsais64_profile(monitor, LIBSAIS64_PHASE_RADIX_SORT, 1, depth, n, k, flags);
+            if (libsais64_cancelled(monitor)) { return -5; }
             
+            libsais64_profile(monitor, LIBSAIS64_PHASE_PARTIAL_SORT, 0, depth, n, k, flags);
             libsais64_place_lms_suffixes_interval_32s_4k(SA, n, k, m - 1, buckets);
             libsais64_induce_partial_order_32s_4k_omp(T, SA, n, k, buckets, threads, thread_state);
+            libsais64_profile(monitor, LIBSAIS64_PHASE_PARTIAL_SORT, 1, depth, n, k, flags);
+            if (libsais64_cancelled(monitor)) { return -5; }
 
+            libsais64_profile(monitor, LIBSAIS64_PHASE_RENUMBER, 0, depth, n, k, flags);
             sa_sint_t names = libsais64_renumber_and_mark_distinct_lms_suffixes_32s_4k_omp(SA, n, m, threads, thread_state);
             if (names < m)
             {
                 sa_sint_t f = libsais64_compact_lms_suffixes_32s_omp(T, SA, n, m, fs, threads, thread_state);
+                libsais64_profile(monitor, LIBSAIS64_PHASE_RENUMBER, 1, depth, m, names, flags);
 
-                if (libsais64_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer) != 0)
+                sa_sint_t status = libsais64_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer, local_buffer_size, allocator, ctx32, monitor, depth + 1);
+                if (status != 0)
                 {
-                    return -2;
+                    return status;
                 }
 
+                libsais64_profile(monitor, LIBSAIS64_PHASE_RECONSTRUCT, 0, depth, n, k, flags);
                 libsais64_reconstruct_compacted_lms_suffixes_32s_2k_omp(T, SA, n, k, m, fs, f, buckets, threads, thread_state);
+                libsais64_profile(monitor, LIBSAIS64_PHASE_RECONSTRUCT, 1, depth, n, k, flags);
             }
             else
             {
+                libsais64_profile(monitor, LIBSAIS64_PHASE_RENUMBER, 1, depth, m, names, flags);
                 libsais64_count_lms_suffixes_32s_2k(T, n, k, buckets);
             }
         }
@@ -6424,43 +7571,65 @@ static sa_sint_t libsais64_main_32s_recursion(sa_sint_t * RESTRICT T, sa_sint_t
             SA[0] = SA[n - 1];
         }
 
+        libsais64_profile(monitor, LIBSAIS64_PHASE_FINAL_SORT, 0, depth, n, k, flags);
         libsais64_initialize_buckets_start_and_end_32s_4k(k, buckets);
         libsais64_place_lms_suffixes_histogram_32s_4k(SA, n, k, m, buckets);
         libsais64_induce_final_order_32s_4k(T, SA, n, k, buckets, threads, thread_state);
+        libsais64_profile(monitor, LIBSAIS64_PHASE_FINAL_SORT, 1, depth, n, k, flags);
+        if (libsais64_cancelled(monitor)) { return -5; }
 
+        libsais64_profile(monitor, LIBSAIS64_PHASE_LEVEL, 1, depth, n, k, flags);
         return 0;
     }
-    else if (k > 0 && ((fs / k >= 2) || (LIBSAIS_LOCAL_BUFFER_SIZE / k >= 2 && threads == 1)))
+    else if (k > 0 && ((fs / k >= 2) || (local_buffer_size / k >= 2 && threads == 1)))
     {
         sa_sint_t alignment = (fs - 1024) / k >= 2 ? (sa_sint_t)1024 : (sa_sint_t)16;
         sa_sint_t * RESTRICT buckets = (fs - alignment) / k >= 2 ? (sa_sint_t *)libsais64_align_up(&SA[n + fs - 2 * (fast_sint_t)k - alignment], (size_t)alignment * sizeof(sa_sint_t)) : &SA[n + fs - 2 * (fast_sint_t)k];
-        buckets = (LIBSAIS_LOCAL_BUFFER_SIZE / k >= 2 && threads == 1) ? local_buffer : buckets;
+        buckets = (local_buffer_size / k >= 2 && threads == 1) ? local_buffer : buckets;
+
+        sa_sint_t flags = LIBSAIS64_PROFILE_2K | (buckets == local_buffer ? LIBSAIS64_PROFILE_LOCAL_BUFFER : LIBSAIS64_PROFILE_FREE_SPACE);
+        libsais64_profile(monitor, LIBSAIS64_PHASE_LEVEL, 0, depth, n, k, flags);
 
+        libsais64_profile(monitor, LIBSAIS64_PHASE_GATHER, 0, depth, n, k, flags);
         sa_sint_t m = libsais64_count_and_gather_lms_suffixes_32s_2k_omp(T, SA, n, k, buckets, threads, thread_state);
+        libsais64_profile(monitor, LIBSAIS64_PHASE_GATHER, 1, depth, n, k, flags);
+
         if (m > 1)
         {
+            libsais64_profile(monitor, LIBSAIS64_PHASE_RADIX_SORT, 0, depth, n, k, flags);
             libsais64_initialize_buckets_for_lms_suffixes_radix_sort_32s_2k(T, k, buckets, SA[n - m]);
 
-            libsais64_radix_sort_lms_suffixes_32s_2k_omp(T, SA, n, m, &buckets[1], threads, thread_state);
+            libsais64_radix_sort_lms_suffixes_32s_2k_omp(T, SA, n, m, &buckets[1], libsais64_adaptive_threads(monitor, threads, m, k), thread_state);
             libsais64_place_lms_suffixes_interval_32s_2k(SA, n, k, m - 1, buckets);
+            libsais64_profile(monitor, LIBSAIS64_PHASE_RADIX_SORT, 1, depth, n, k, flags);
+            if (libsais64_cancelled(monitor)) { return -5; }
 
+            libsais64_profile(monitor, LIBSAIS64_PHASE_PARTIAL_SORT, 0, depth, n, k, flags);
             libsais64_initialize_buckets_start_and_end_32s_2k(k, buckets);
             libsais64_induce_partial_order_32s_2k_omp(T, SA, n, k, buckets, threads, thread_state);
+            libsais64_profile(monitor, LIBSAIS64_PHASE_PARTIAL_SORT, 1, depth, n, k, flags);
+            if (libsais64_cancelled(monitor)) { return -5; }
 
+            libsais64_profile(monitor, LIBSAIS64_PHASE_RENUMBER, 0, depth, n, k, flags);
             sa_sint_t names = libsais64_renumber_and_mark_distinct_lms_suffixes_32s_1k_omp(T, SA, n, m, threads);
             if (names < m)
             {
                 sa_sint_t f = libsais64_compact_lms_suffixes_32s_omp(T, SA, n, m, fs, threads, thread_state);
+                libsais64_profile(monitor, LIBSAIS64_PHASE_RENUMBER, 1, depth, m, names, flags);
 
-                if (libsais64_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer) != 0)
+                sa_sint_t status = libsais64_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer, local_buffer_size, allocator, ctx32, monitor, depth + 1);
+                if (status != 0)
                 {
-                    return -2;
+                    return status;
                 }
 
+                libsais64_profile(monitor, LIBSAIS64_PHASE_RECONSTRUCT, 0, depth, n, k, flags);
                 libsais64_reconstruct_compacted_lms_suffixes_32s_2k_omp(T, SA, n, k, m, fs, f, buckets, threads, thread_state);
+                libsais64_profile(monitor, LIBSAIS64_PHASE_RECONSTRUCT, 1, depth, n, k, flags);
             }
             else
             {
+                libsais64_profile(monitor, LIBSAIS64_PHASE_RENUMBER, 1, depth, m, names, flags);
                 libsais64_count_lms_suffixes_32s_2k(T, n, k, buckets);
             }
         }
@@ -6469,167 +7638,174 @@ static sa_sint_t libsais64_main_32s_recursion(sa_sint_t * RESTRICT T, sa_sint_t
             SA[0] = SA[n - 1];
         }
 
+        libsais64_profile(monitor, LIBSAIS64_PHASE_FINAL_SORT, 0, depth, n, k, flags);
         libsais64_initialize_buckets_end_32s_2k(k, buckets);
         libsais64_place_lms_suffixes_histogram_32s_2k(SA, n, k, m, buckets);
 
         libsais64_initialize_buckets_start_and_end_32s_2k(k, buckets);
         libsais64_induce_final_order_32s_2k(T, SA, n, k, buckets, threads, thread_state);
+        libsais64_profile(monitor, LIBSAIS64_PHASE_FINAL_SORT, 1, depth, n, k, flags);
+        if (libsais64_cancelled(monitor)) { return -5; }
 
+        libsais64_profile(monitor, LIBSAIS64_PHASE_LEVEL, 1, depth, n, k, flags);
         return 0;
     }
     else
     {
-        sa_sint_t * buffer = fs < k ? (sa_sint_t *)libsais64_alloc_aligned((size_t)k * sizeof(sa_sint_t), 4096) : (sa_sint_t *)NULL;
+        sa_sint_t * buffer = fs < k ? (sa_sint_t *)libsais64_alloc_memory(allocator, (size_t)k * sizeof(sa_sint_t), 4096) : (sa_sint_t *)NULL;
 
         sa_sint_t alignment = fs - 1024 >= k ? (sa_sint_t)1024 : (sa_sint_t)16;
         sa_sint_t * RESTRICT buckets = fs - alignment >= k ? (sa_sint_t *)libsais64_align_up(&SA[n + fs - k - alignment], (size_t)alignment * sizeof(sa_sint_t)) : fs >= k ? &SA[n + fs - k] : buffer;
 
         if (buckets == NULL) { return -2; }
 
+        sa_sint_t flags = LIBSAIS64_PROFILE_1K | (buffer != NULL ? LIBSAIS64_PROFILE_ALLOCATION : LIBSAIS64_PROFILE_FREE_SPACE);
+        libsais64_profile(monitor, LIBSAIS64_PHASE_LEVEL, 0, depth, n, k, flags);
+
+        libsais64_profile(monitor, LIBSAIS64_PHASE_GATHER, 0, depth, n, k, flags);
         memset(SA, 0, (size_t)n * sizeof(sa_sint_t));
 
         libsais64_count_suffixes_32s(T, n, k, buckets); 
         libsais64_initialize_buckets_end_32s_1k(k, buckets);
+        libsais64_profile(monitor, LIBSAIS64_PHASE_GATHER, 1, depth, n, k, flags);
 
+        libsais64_profile(monitor, LIBSAIS64_PHASE_RADIX_SORT, 0, depth, n, k, flags);
         sa_sint_t m = libsais64_radix_sort_lms_suffixes_32s_1k(T, SA, n, buckets);
+        libsais64_profile(monitor, LIBSAIS64_PHASE_RADIX_SORT, 1, depth, n, k, flags);
+        if (libsais64_cancelled(monitor)) { libsais64_free_memory(allocator, buffer); return -5; }
+
         if (m > 1)
         {
+            libsais64_profile(monitor, LIBSAIS64_PHASE_PARTIAL_SORT, 0, depth, n, k, flags);
             libsais64_induce_partial_order_32s_1k_omp(T, SA, n, k, buckets, threads, thread_state);
+            libsais64_profile(monitor, LIBSAIS64_PHASE_PARTIAL_SORT, 1, depth, n, k, flags);
+            if (libsais64_cancelled(monitor)) { libsais64_free_memory(allocator, buffer); return -5; }
 
+            libsais64_profile(monitor, LIBSAIS64_PHASE_RENUMBER, 0, depth, n, k, flags);
             sa_sint_t names = libsais64_renumber_and_mark_distinct_lms_suffixes_32s_1k_omp(T, SA, n, m, threads);
             if (names < m)
             {
-                if (buffer != NULL) { libsais64_free_aligned(buffer); buckets = NULL; }
+                if (buffer != NULL) { libsais64_free_memory(allocator, buffer); buckets = NULL; }
 
                 sa_sint_t f = libsais64_compact_lms_suffixes_32s_omp(T, SA, n, m, fs, threads, thread_state);
+                libsais64_profile(monitor, LIBSAIS64_PHASE_RENUMBER, 1, depth, m, names, flags);
 
-                if (libsais64_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer) != 0)
+                sa_sint_t status = libsais64_main_32s_recursion(SA + n + fs - m + f, SA, m - f, names - f, fs + n - 2 * m + f, threads, thread_state, local_buffer, local_buffer_size, allocator, ctx32, monitor, depth + 1);
+                if (status != 0)
                 {
-                    return -2;
+                    return status;
                 }
 
+                libsais64_profile(monitor, LIBSAIS64_PHASE_RECONSTRUCT, 0, depth, n, k, flags);
                 libsais64_reconstruct_compacted_lms_suffixes_32s_1k_omp(T, SA, n, m, fs, f, threads, thread_state);
+                libsais64_profile(monitor, LIBSAIS64_PHASE_RECONSTRUCT, 1, depth, n, k, flags);
 
-                if (buckets == NULL) { buckets = buffer = (sa_sint_t *)libsais64_alloc_aligned((size_t)k * sizeof(sa_sint_t), 4096); }
+                if (buckets == NULL) { buckets = buffer = (sa_sint_t *)libsais64_alloc_memory(allocator, (size_t)k * sizeof(sa_sint_t), 4096); }
                 if (buckets == NULL) { return -2; }
             }
+            else
+            {
+                libsais64_profile(monitor, LIBSAIS64_PHASE_RENUMBER, 1, depth, m, names, flags);
+            }
             
+            libsais64_profile(monitor, LIBSAIS64_PHASE_FINAL_SORT, 0, depth, n, k, flags);
             libsais64_count_suffixes_32s(T, n, k, buckets);
             libsais64_initialize_buckets_end_32s_1k(k, buckets);
             libsais64_place_lms_suffixes_interval_32s_1k(T, SA, k, m, buckets);
         }
+        else
+        {
+            libsais64_profile(monitor, LIBSAIS64_PHASE_FINAL_SORT, 0, depth, n, k, flags);
+        }
 
         libsais64_induce_final_order_32s_1k(T, SA, n, k, buckets, threads, thread_state);
-        libsais64_free_aligned(buffer);
+        libsais64_free_memory(allocator, buffer);
+        libsais64_profile(monitor, LIBSAIS64_PHASE_FINAL_SORT, 1, depth, n, k, flags);
+        if (libsais64_cancelled(monitor)) { return -5; }
 
+        libsais64_profile(monitor, LIBSAIS64_PHASE_LEVEL, 1, depth, n, k, flags);
         return 0;
     }
 }
 
-static sa_sint_t libsais64_main_32s_entry(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+static sa_sint_t libsais64_main_32s_entry(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t * RESTRICT local_buffer, sa_sint_t local_buffer_size, const LIBSAIS_ALLOCATOR * allocator, const void * ctx32, LIBSAIS_MONITOR * monitor, sa_sint_t depth)
 {
-    sa_sint_t local_buffer[LIBSAIS_LOCAL_BUFFER_SIZE];
+    sa_sint_t stack_buffer[LIBSAIS_LOCAL_BUFFER_SIZE];
+
+    if (thread_state != NULL) { thread_state[0].state.monitor = monitor; }
 
-    return libsais64_main_32s_recursion(T, SA, n, k, fs, threads, thread_state, local_buffer);
+    return libsais64_main_32s_recursion(T, SA, n, k, fs, threads, thread_state, local_buffer != NULL ? local_buffer : stack_buffer, local_buffer_size, allocator, ctx32, monitor, depth);
 }
 
-static sa_sint_t libsais64_main_8u(const uint8_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t * RESTRICT buckets, sa_sint_t bwt, sa_sint_t r, sa_sint_t * RESTRICT I, sa_sint_t fs, sa_sint_t * freq, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state)
+static void libsais64_mark_alphabet_32s(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    fs = fs < (SAINT_MAX - n) ? fs : (SAINT_MAX - n);
-
-    sa_sint_t m = libsais64_count_and_gather_lms_suffixes_8u_omp(T, SA, n, buckets, threads, thread_state);
-    sa_sint_t k = libsais64_initialize_buckets_start_and_end_8u(buckets, freq);
+    fast_sint_t i; for (i = omp_block_start; i < omp_block_start + omp_block_size; i += 1) { SA[T[i]] = SAINT_MIN; }
+}
 
-    if (m > 0)
+static void libsais64_mark_alphabet_32s_omp(const sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
     {
-        sa_sint_t first_lms_suffix    = SA[n - m];
-        sa_sint_t left_suffixes_count = libsais64_initialize_buckets_for_lms_suffixes_radix_sort_8u(T, buckets, first_lms_suffix);
-
-        if (threads > 1 && n >= 65536) { memset(SA, 0, ((size_t)n - (size_t)m) * sizeof(sa_sint_t)); }
-        libsais64_radix_sort_lms_suffixes_8u_omp(T, SA, n, m, buckets, threads, thread_state);
-        if (threads > 1 && n >= 65536) { memset(&SA[(fast_sint_t)n - (fast_sint_t)m], 0, (size_t)m * sizeof(sa_sint_t)); }
-
-        libsais64_initialize_buckets_for_partial_sorting_8u(T, buckets, first_lms_suffix, left_suffixes_count);
-        libsais64_induce_partial_order_8u_omp(T, SA, n, k, buckets, first_lms_suffix, left_suffixes_count, threads, thread_state);
-
-        sa_sint_t names = libsais64_renumber_and_gather_lms_suffixes_omp(SA, n, m, fs, threads, thread_state);
-        if (names < m)
-        {
-            if (libsais64_main_32s_entry(SA + n + fs - m, SA, m, names, fs + n - 2 * m, threads, thread_state) != 0)
-            {
-                return -2;
-            }
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+#else
+        UNUSED(threads);
 
-            libsais64_gather_lms_suffixes_8u_omp(T, SA, n, threads, thread_state);
-            libsais64_reconstruct_lms_suffixes_omp(SA, n, m, threads);
-        }
+        fast_sint_t omp_block_start   = 0;
+        fast_sint_t omp_block_size    = n;
+#endif
 
-        libsais64_place_lms_suffixes_interval_8u(SA, n, m, buckets);
-    }
-    else
-    {
-        memset(SA, 0, (size_t)n * sizeof(sa_sint_t));
+        libsais64_mark_alphabet_32s(T, SA, omp_block_start, omp_block_size);
     }
-
-    return libsais64_induce_final_order_8u_omp(T, SA, n, k, bwt, r, I, buckets, threads, thread_state);
 }
 
-static sa_sint_t libsais64_main(const uint8_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t bwt, sa_sint_t r, sa_sint_t * I, sa_sint_t fs, sa_sint_t * freq, sa_sint_t threads)
+static sa_sint_t libsais64_rank_alphabet_32s(sa_sint_t * RESTRICT SA, sa_sint_t k)
 {
-    LIBSAIS_THREAD_STATE *  RESTRICT thread_state   = threads > 1 ? libsais64_alloc_thread_state(threads) : NULL;
-    sa_sint_t *             RESTRICT buckets        = (sa_sint_t *)libsais64_alloc_aligned((size_t)8 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
+    sa_sint_t d = 0;
 
-    sa_sint_t index = buckets != NULL && (thread_state != NULL || threads == 1)
-        ? libsais64_main_8u(T, SA, n, buckets, bwt, r, I, fs, freq, threads, thread_state)
-        : -2;
+    fast_sint_t c; for (c = 0; c < (fast_sint_t)k; c += 1) { if (SA[c] < 0) { SA[c] = d++ | SAINT_MIN; } }
 
-    libsais64_free_aligned(buckets);
-    libsais64_free_thread_state(thread_state);
+    return d;
+}
 
-    return index;
+static void libsais64_unrank_alphabet_32s(const sa_sint_t * RESTRICT SA, sa_sint_t k, sa_sint_t * RESTRICT alphabet)
+{
+    fast_sint_t c; for (c = 0; c < (fast_sint_t)k; c += 1) { if (SA[c] < 0) { alphabet[SA[c] & SAINT_MAX] = (sa_sint_t)c; } }
 }
 
-static sa_sint_t libsais64_main_long(sa_sint_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads)
+static void libsais64_remap_alphabet_32s(sa_sint_t * RESTRICT T, const sa_sint_t * RESTRICT map, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    LIBSAIS_THREAD_STATE * RESTRICT thread_state = threads > 1 ? libsais64_alloc_thread_state(threads) : NULL;
-
-    sa_sint_t index = thread_state != NULL || threads == 1
-        ? libsais64_main_32s_entry(T, SA, n, k, fs, threads, thread_state)
-        : -2;
-
-    libsais64_free_thread_state(thread_state);
-
-    return index;
-}
-
-static void libsais64_bwt_copy_8u(uint8_t * RESTRICT U, sa_sint_t * RESTRICT A, sa_sint_t n)
-{
-    const fast_sint_t prefetch_distance = 32;
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
     fast_sint_t i, j;
-    for (i = 0, j = (fast_sint_t)n - 7; i < j; i += 8)
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
     {
-        libsais64_prefetchr(&A[i + prefetch_distance]);
+        libsais64_prefetchw(&T[i + 2 * prefetch_distance]);
 
-        U[i + 0] = (uint8_t)A[i + 0];
-        U[i + 1] = (uint8_t)A[i + 1];
-        U[i + 2] = (uint8_t)A[i + 2];
-        U[i + 3] = (uint8_t)A[i + 3];
-        U[i + 4] = (uint8_t)A[i + 4];
-        U[i + 5] = (uint8_t)A[i + 5];
-        U[i + 6] = (uint8_t)A[i + 6];
-        U[i + 7] = (uint8_t)A[i + 7];
+        libsais64_prefetchr(&map[T[i + prefetch_distance + 0]]);
+        libsais64_prefetchr(&map[T[i + prefetch_distance + 1]]);
+        libsais64_prefetchr(&map[T[i + prefetch_distance + 2]]);
+        libsais64_prefetchr(&map[T[i + prefetch_distance + 3]]);
+
+        T[i + 0] = map[T[i + 0]] & SAINT_MAX;
+        T[i + 1] = map[T[i + 1]] & SAINT_MAX;
+        T[i + 2] = map[T[i + 2]] & SAINT_MAX;
+        T[i + 3] = map[T[i + 3]] & SAINT_MAX;
     }
 
-    for (j += 7; i < j; i += 1)
+    for (j += prefetch_distance + 3; i < j; i += 1)
     {
-        U[i] = (uint8_t)A[i];
+        T[i] = map[T[i]] & SAINT_MAX;
     }
 }
 
-#if defined(LIBSAIS_OPENMP)
-
-static void libsais64_bwt_copy_8u_omp(uint8_t * RESTRICT U, sa_sint_t * RESTRICT A, sa_sint_t n, sa_sint_t threads)
+static void libsais64_remap_alphabet_32s_omp(sa_sint_t * RESTRICT T, sa_sint_t n, const sa_sint_t * RESTRICT map, sa_sint_t threads)
 {
 #if defined(LIBSAIS_OPENMP)
     #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
@@ -6638,1223 +7814,5665 @@ static void libsais64_bwt_copy_8u_omp(uint8_t * RESTRICT U, sa_sint_t * RESTRICT
 #if defined(LIBSAIS_OPENMP)
         fast_sint_t omp_thread_num    = omp_get_thread_num();
         fast_sint_t omp_num_threads   = omp_get_num_threads();
-        fast_sint_t omp_block_stride  = ((fast_sint_t)n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
         fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
-        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : (fast_sint_t)n - omp_block_start;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
 #else
         UNUSED(threads);
 
         fast_sint_t omp_block_start   = 0;
-        fast_sint_t omp_block_size    = (fast_sint_t)n;
+        fast_sint_t omp_block_size    = n;
 #endif
 
-        libsais64_bwt_copy_8u(U + omp_block_start, A + omp_block_start, (sa_sint_t)omp_block_size);
+        libsais64_remap_alphabet_32s(T, map, omp_block_start, omp_block_size);
     }
 }
 
-#endif
-
-int64_t libsais64(const uint8_t * T, int64_t * SA, int64_t n, int64_t fs, int64_t * freq)
+static sa_sint_t libsais64_main_32s_compact(sa_sint_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t * RESTRICT local_buffer, sa_sint_t local_buffer_size, const LIBSAIS_ALLOCATOR * allocator, const void * ctx32, LIBSAIS_MONITOR * monitor)
 {
-    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
+    fs = fs < (SAINT_MAX - n) ? fs : (SAINT_MAX - n);
+
+    if (k > 0 && fs / k < 6)
     {
-        return -1;
+        sa_sint_t * RESTRICT buffer = k > n + fs ? (sa_sint_t *)libsais64_alloc_memory(allocator, (size_t)k * sizeof(sa_sint_t), 4096) : NULL;
+        sa_sint_t * RESTRICT ranks  = k > n + fs ? buffer : SA;
+
+        if (ranks != NULL)
+        {
+            memset(ranks, 0, (size_t)k * sizeof(sa_sint_t));
+            libsais64_mark_alphabet_32s_omp(T, ranks, n, threads);
+
+            sa_sint_t d = libsais64_rank_alphabet_32s(ranks, k);
+            if (d + d <= k || fs / d > fs / k)
+            {
+                sa_sint_t * RESTRICT alphabet = buffer != NULL ? buffer : (sa_sint_t *)libsais64_alloc_memory(allocator, (size_t)d * sizeof(sa_sint_t), 4096);
+                if (alphabet != NULL)
+                {
+                    libsais64_remap_alphabet_32s_omp(T, n, ranks, threads);
+                    libsais64_unrank_alphabet_32s(ranks, k, alphabet);
+
+                    sa_sint_t index = libsais64_main_32s_entry(T, SA, n, d, fs, threads, thread_state, local_buffer, local_buffer_size, allocator, ctx32, monitor, 0);
+                    if (index == 0)
+                    {
+                        libsais64_remap_alphabet_32s_omp(T, n, alphabet, threads);
+                    }
+
+                    libsais64_free_memory(allocator, alphabet);
+                    return index;
+                }
+            }
+
+            libsais64_free_memory(allocator, buffer);
+        }
     }
-    else if (n < 2)
+
+    return libsais64_main_32s_entry(T, SA, n, k, fs, threads, thread_state, local_buffer, local_buffer_size, allocator, ctx32, monitor, 0);
+}
+
+static void libsais64_gsa_rename_separator_lms_suffixes_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n)
+{
+    fast_sint_t i, j;
+    for (i = 1, j = 0; i < (fast_sint_t)n - 1; i += 1)
     {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
-        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
-        return 0;
+        if (T[i] == 0 && T[i - 1] != 0) { SA[j++] = (sa_sint_t)i | SAINT_MIN; }
     }
+}
 
-    if (n <= INT32_MAX)
+static void libsais64_gsa_split_last_lms_suffix_group_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, sa_sint_t m)
+{
+    fast_sint_t l = (fast_sint_t)n - 2; while (l >= 0 && T[l] >= T[l + 1]) { l--; }
+    while (l > 0 && T[l - 1] <= T[l]) { l--; }
+
+    if (l <= 0 || T[l] == 0) { return; }
+
+    fast_sint_t i = 0; while ((SA[i] & SAINT_MAX) != (sa_sint_t)l) { i++; }
+    if (i + 1 >= (fast_sint_t)m) { return; }
+
+    fast_sint_t len = (fast_sint_t)n - 1 - l, p = (fast_sint_t)(SA[i + 1] & SAINT_MAX) + len, t = p;
+    while (t < (fast_sint_t)n - 1 && T[t] == T[t + 1]) { t++; }
+
+    if (T[p - 1] > T[p] && t < (fast_sint_t)n - 1 && T[t] < T[t + 1] && memcmp(&T[SA[i + 1] & SAINT_MAX], &T[l], (size_t)len * sizeof(uint8_t)) == 0)
     {
-        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
-        sa_sint_t index = libsais(T, (int32_t *)SA, (int32_t)n, (int32_t)new_fs, (int32_t *)freq);
+        fast_sint_t j = i + 1; while (SA[j] > 0) { j++; }
 
-        if (index >= 0)
+        fast_sint_t k = i; SA[i] = (sa_sint_t)l;
+        for (t = i + 1; t <= j; t += 1)
         {
-            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)SA, n, 1);
-            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, 1); }
+            sa_sint_t q = SA[t] & SAINT_MAX; SA[t] = q;
+            if (T[q + len] == 0) { SA[t] = SA[k]; SA[k++] = q; }
         }
 
-        return index;
-    }
+        for (t = k; SA[t] != (sa_sint_t)l; t += 1) { }
+        SA[t] = SA[k]; SA[k] = (sa_sint_t)l | SAINT_MIN;
 
-    return libsais64_main(T, SA, n, 0, 0, NULL, fs, freq, 1);
+        if (k > i) { SA[k - 1] |= SAINT_MIN; }
+        SA[j] |= SAINT_MIN;
+    }
 }
 
-int64_t libsais64_long(int64_t * T, int64_t * SA, int64_t n, int64_t k, int64_t fs)
+static void libsais64_gsa_induce_separator_suffixes_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT buckets)
 {
-    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
+    sa_sint_t * RESTRICT induction_bucket = &buckets[6 * ALPHABET_SIZE];
+
+    fast_sint_t i;
+    for (i = 0; i < (fast_sint_t)buckets[7 * ALPHABET_SIZE]; i += 1)
     {
-        return -1;
+        sa_sint_t p = SA[i]; SA[i] = 0; if (p > 0) { p--; SA[induction_bucket[T[p]]++] = p | ((sa_sint_t)(T[p - (p > 0)] < T[p]) << (SAINT_BIT - 1)); }
     }
-    else if (n < 2)
+}
+
+static void libsais64_gsa_place_separator_suffixes_8u(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n)
+{
+    fast_sint_t i, j;
+    for (i = 0, j = 0; i < (fast_sint_t)n; i += 1)
     {
-        if (n == 1) { SA[0] = 0; }
-        return 0;
+        if (T[i] == 0) { SA[j++] = (sa_sint_t)i; }
     }
-
-    return libsais64_main_long(T, SA, n, k, fs, 1);
 }
 
-int64_t libsais64_bwt(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq)
+static sa_sint_t libsais64_main_8u(const uint8_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t * RESTRICT buckets, sa_sint_t bwt, sa_sint_t r, sa_sint_t * RESTRICT I, sa_sint_t * RESTRICT S, sa_sint_t fs, sa_sint_t * freq, sa_sint_t gsa, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t * RESTRICT local_buffer, sa_sint_t local_buffer_size, const LIBSAIS_ALLOCATOR * allocator, const void * ctx32, LIBSAIS_MONITOR * monitor)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0))
-    { 
-        return -1; 
-    }
-    else if (n <= 1) 
-    { 
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
-        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
-        return n; 
-    }
+    fs = fs < (SAINT_MAX - n) ? fs : (SAINT_MAX - n);
+    threads = libsais64_adaptive_threads(monitor, threads, n, ALPHABET_SIZE);
 
-    if (n <= INT32_MAX)
+    if (thread_state != NULL) { thread_state[0].state.monitor = monitor; }
+
+    libsais64_profile(monitor, LIBSAIS64_PHASE_LEVEL, 0, 0, n, ALPHABET_SIZE, LIBSAIS64_PROFILE_NONE);
+
+    libsais64_profile(monitor, LIBSAIS64_PHASE_GATHER, 0, 0, n, ALPHABET_SIZE, LIBSAIS64_PROFILE_NONE);
+    sa_sint_t m = libsais64_count_and_gather_lms_suffixes_8u_omp(T, SA, n, buckets, threads, thread_state);
+    sa_sint_t k = libsais64_initialize_buckets_start_and_end_8u(buckets, freq);
+    libsais64_profile(monitor, LIBSAIS64_PHASE_GATHER, 1, 0, n, ALPHABET_SIZE, LIBSAIS64_PROFILE_NONE);
+
+    if (m > 0)
     {
-        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
-        sa_sint_t index = libsais_bwt(T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq);
+        libsais64_profile(monitor, LIBSAIS64_PHASE_RADIX_SORT, 0, 0, n, ALPHABET_SIZE, LIBSAIS64_PROFILE_NONE);
+        sa_sint_t first_lms_suffix    = SA[n - m];
+        sa_sint_t left_suffixes_count = libsais64_initialize_buckets_for_lms_suffixes_radix_sort_8u(T, buckets, first_lms_suffix);
 
-        if (index >= 0)
+        if (threads > 1 && n >= 65536) { memset(SA, 0, ((size_t)n - (size_t)m) * sizeof(sa_sint_t)); }
+        libsais64_radix_sort_lms_suffixes_8u_omp(T, SA, n, m, buckets, libsais64_adaptive_threads(monitor, threads, m, ALPHABET_SIZE) == threads ? threads : 1, thread_state);
+        if (threads > 1 && n >= 65536) { memset(&SA[(fast_sint_t)n - (fast_sint_t)m], 0, (size_t)m * sizeof(sa_sint_t)); }
+        libsais64_profile(monitor, LIBSAIS64_PHASE_RADIX_SORT, 1, 0, n, ALPHABET_SIZE, LIBSAIS64_PROFILE_NONE);
+        if (libsais64_cancelled(monitor)) { return -5; }
+
+        libsais64_profile(monitor, LIBSAIS64_PHASE_PARTIAL_SORT, 0, 0, n, ALPHABET_SIZE, LIBSAIS64_PROFILE_NONE);
+        libsais64_initialize_buckets_for_partial_sorting_8u(T, buckets, first_lms_suffix, left_suffixes_count);
+        libsais64_induce_partial_order_8u_omp(T, SA, n, k, buckets, first_lms_suffix, left_suffixes_count, threads, thread_state);
+        if (libsais64_cancelled(monitor)) { return -5; }
+        if (gsa) { libsais64_gsa_rename_separator_lms_suffixes_8u(T, SA, n); libsais64_gsa_split_last_lms_suffix_group_8u(T, SA, n, m); }
+        libsais64_profile(monitor, LIBSAIS64_PHASE_PARTIAL_SORT, 1, 0, n, ALPHABET_SIZE, LIBSAIS64_PROFILE_NONE);
+
+        libsais64_profile(monitor, LIBSAIS64_PHASE_RENUMBER, 0, 0, n, ALPHABET_SIZE, LIBSAIS64_PROFILE_NONE);
+        sa_sint_t names = libsais64_renumber_and_gather_lms_suffixes_omp(SA, n, m, fs, threads, thread_state);
+        libsais64_profile(monitor, LIBSAIS64_PHASE_RENUMBER, 1, 0, m, names, LIBSAIS64_PROFILE_NONE);
+
+        if (names < m)
         {
-            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, 1); }
+            sa_sint_t status = libsais64_main_32s_entry(SA + n + fs - m, SA, m, names, fs + n - 2 * m, threads, thread_state, local_buffer, local_buffer_size, allocator, ctx32, monitor, 1);
+            if (status != 0)
+            {
+                return status;
+            }
+
+            libsais64_profile(monitor, LIBSAIS64_PHASE_RECONSTRUCT, 0, 0, n, ALPHABET_SIZE, LIBSAIS64_PROFILE_NONE);
+            libsais64_gather_lms_suffixes_8u_omp(T, SA, n, threads, thread_state);
+            libsais64_reconstruct_lms_suffixes_omp(SA, n, m, threads);
+            libsais64_profile(monitor, LIBSAIS64_PHASE_RECONSTRUCT, 1, 0, n, ALPHABET_SIZE, LIBSAIS64_PROFILE_NONE);
         }
 
-        return index;
+        libsais64_profile(monitor, LIBSAIS64_PHASE_FINAL_SORT, 0, 0, n, ALPHABET_SIZE, LIBSAIS64_PROFILE_NONE);
+        libsais64_place_lms_suffixes_interval_8u(SA, n, m, buckets);
+    }
+    else
+    {
+        libsais64_profile(monitor, LIBSAIS64_PHASE_FINAL_SORT, 0, 0, n, ALPHABET_SIZE, LIBSAIS64_PROFILE_NONE);
+        memset(SA, 0, (size_t)n * sizeof(sa_sint_t));
     }
 
-    sa_sint_t index = libsais64_main(T, A, n, 1, 0, NULL, fs, freq, 1);
-    if (index >= 0) 
-    { 
-        index++;
+    if (gsa) { libsais64_gsa_induce_separator_suffixes_8u(T, SA, buckets); }
 
-        U[0] = T[n - 1];
-        libsais64_bwt_copy_8u(U + 1, A, index - 1);
-        libsais64_bwt_copy_8u(U + index, A + index, n - index);
-    }
+    sa_sint_t index = libsais64_induce_final_order_8u_omp(T, SA, n, k, bwt, r, I, S, buckets, threads, thread_state);
+    libsais64_profile(monitor, LIBSAIS64_PHASE_FINAL_SORT, 1, 0, n, ALPHABET_SIZE, LIBSAIS64_PROFILE_NONE);
+    if (libsais64_cancelled(monitor)) { return -5; }
 
+    libsais64_profile(monitor, LIBSAIS64_PHASE_LEVEL, 1, 0, n, ALPHABET_SIZE, LIBSAIS64_PROFILE_NONE);
     return index;
 }
 
-int64_t libsais64_bwt_aux(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t r, int64_t * I)
+static sa_sint_t libsais64_main_gsa_8u(const uint8_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t * RESTRICT buckets, sa_sint_t fs, sa_sint_t * freq, sa_sint_t threads, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t * RESTRICT local_buffer, sa_sint_t local_buffer_size, const LIBSAIS_ALLOCATOR * allocator, const void * ctx32, LIBSAIS_MONITOR * monitor)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL))
-    { 
-        return -1; 
-    }
-    else if (n <= 1) 
-    { 
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
-        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
-        I[0] = n;
-        return 0;
-    }
+    sa_sint_t q = n - 1; while (q > 0 && T[q - 1] == 0) { q--; }
 
-    if (n <= INT32_MAX && r <= INT32_MAX)
+    if (q > 0)
     {
-        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
-        sa_sint_t index = libsais_bwt_aux(T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)r, (int32_t *)I);
-
-        if (index >= 0)
+        sa_sint_t status = libsais64_main_8u(T, SA + (n - 1 - q), q + 1, buckets, 0, 0, NULL, NULL, fs, freq, 1, threads, thread_state, local_buffer, local_buffer_size, allocator, ctx32, monitor);
+        if (status != 0)
         {
-            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)I, 1 + ((n - 1) / r), 1);
-            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, 1); }
+            return status;
         }
 
-        return index;
+        if (freq != NULL) { freq[0] += n - 1 - q; }
     }
-
-    if (libsais64_main(T, A, n, 1, r, I, fs, freq, 1) != 0)
+    else if (freq != NULL)
     {
-        return -2;
+        memset(freq, 0, ALPHABET_SIZE * sizeof(sa_sint_t)); freq[0] = n;
     }
 
-    U[0] = T[n - 1];
-    libsais64_bwt_copy_8u(U + 1, A, I[0] - 1);
-    libsais64_bwt_copy_8u(U + I[0], A + I[0], n - I[0]);
+    libsais64_gsa_place_separator_suffixes_8u(T, SA, n);
 
     return 0;
 }
 
-#if defined(LIBSAIS_OPENMP)
-
-int64_t libsais64_omp(const uint8_t * T, int64_t * SA, int64_t n, int64_t fs, int64_t * freq, int64_t threads)
+static sa_sint_t libsais64_main(const uint8_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t bwt, sa_sint_t r, sa_sint_t * I, sa_sint_t * S, sa_sint_t fs, sa_sint_t * freq, sa_sint_t threads)
 {
-    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0) || (threads < 0))
-    {
-        return -1;
-    }
-    else if (n < 2)
-    {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
-        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
-        return 0;
-    }
+    LIBSAIS_THREAD_STATE *  RESTRICT thread_state   = threads > 1 ? libsais64_alloc_thread_state(threads, NULL) : NULL;
+    sa_sint_t *             RESTRICT buckets        = (sa_sint_t *)libsais64_alloc_aligned((size_t)8 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
 
-    threads = threads > 0 ? threads : omp_get_max_threads();
+    sa_sint_t index = buckets != NULL && (thread_state != NULL || threads == 1)
+        ? libsais64_main_8u(T, SA, n, buckets, bwt, r, I, S, fs, freq, 0, threads, thread_state, NULL, LIBSAIS_LOCAL_BUFFER_SIZE, NULL, NULL, NULL)
+        : -2;
 
-    if (n <= INT32_MAX)
-    {
-        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
-        sa_sint_t index = libsais_omp(T, (int32_t *)SA, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)threads);
+    libsais64_free_aligned(buckets);
+    libsais64_free_thread_state(thread_state, NULL);
 
-        if (index >= 0)
-        {
-            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)SA, n, threads);
-            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, threads); }
-        }
+    return index;
+}
 
-        return index;
-    }
+static sa_sint_t libsais64_main_gsa(const uint8_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t fs, sa_sint_t * freq, sa_sint_t threads)
+{
+    LIBSAIS_THREAD_STATE *  RESTRICT thread_state   = threads > 1 ? libsais64_alloc_thread_state(threads, NULL) : NULL;
+    sa_sint_t *             RESTRICT buckets        = (sa_sint_t *)libsais64_alloc_aligned((size_t)8 * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
+
+    sa_sint_t index = buckets != NULL && (thread_state != NULL || threads == 1)
+        ? libsais64_main_gsa_8u(T, SA, n, buckets, fs, freq, threads, thread_state, NULL, LIBSAIS_LOCAL_BUFFER_SIZE, NULL, NULL, NULL)
+        : -2;
 
-    return libsais64_main(T, SA, n, 0, 0, NULL, fs, freq, threads);
+    libsais64_free_aligned(buckets);
+    libsais64_free_thread_state(thread_state, NULL);
+
+    return index;
 }
 
-int64_t libsais64_long_omp(int64_t * T, int64_t * SA, int64_t n, int64_t k, int64_t fs, int64_t threads)
+static sa_sint_t libsais64_main_long(sa_sint_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs, sa_sint_t threads)
 {
-    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0) || (threads < 0))
-    {
-        return -1;
-    }
-    else if (n < 2)
-    {
-        if (n == 1) { SA[0] = 0; }
-        return 0;
-    }
+    LIBSAIS_THREAD_STATE * RESTRICT thread_state = threads > 1 ? libsais64_alloc_thread_state(threads, NULL) : NULL;
 
-    threads = threads > 0 ? threads : omp_get_max_threads();
+    sa_sint_t index = thread_state != NULL || threads == 1
+        ? libsais64_main_32s_compact(T, SA, n, k, fs, threads, thread_state, NULL, LIBSAIS_LOCAL_BUFFER_SIZE, NULL, NULL, NULL)
+        : -2;
 
-    return libsais64_main_long(T, SA, n, k, fs, threads);
+    libsais64_free_thread_state(thread_state, NULL);
+
+    return index;
 }
 
-int64_t libsais64_bwt_omp(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t threads)
+static sa_sint_t libsais64_main_ctx(const LIBSAIS_CONTEXT * ctx, const uint8_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t bwt, sa_sint_t r, sa_sint_t * I, sa_sint_t * S, sa_sint_t fs, sa_sint_t * freq)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (threads < 0))
-    {
-        return -1;
-    }
-    else if (n <= 1)
+    if (ctx != NULL && (ctx->buckets != NULL && (ctx->thread_state != NULL || ctx->threads == 1)))
     {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
-        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
-        return n;
+        libsais64_numa_place_omp(ctx, SA, n, fs);
+
+        LIBSAIS_MONITOR monitor = ctx->monitor;
+        if (ctx->numa != LIBSAIS64_NUMA_NONE) { monitor.thread_block_size = 0; }
+        return libsais64_ctx_status(ctx, libsais64_main_8u(T, SA, n, ctx->buckets, bwt, r, I, S, fs, freq, 0, (sa_sint_t)ctx->threads, ctx->thread_state, ctx->local_buffer, (sa_sint_t)ctx->local_buffer_size, &ctx->allocator, ctx->ctx32, &monitor));
     }
 
-    threads = threads > 0 ? threads : omp_get_max_threads();
+    return -2;
+}
 
-    if (n <= INT32_MAX)
+static sa_sint_t libsais64_main_gsa_ctx(const LIBSAIS_CONTEXT * ctx, const uint8_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t fs, sa_sint_t * freq)
+{
+    if (ctx != NULL && (ctx->buckets != NULL && (ctx->thread_state != NULL || ctx->threads == 1)))
     {
-        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
-        sa_sint_t index = libsais_bwt_omp(T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)threads);
+        libsais64_numa_place_omp(ctx, SA, n, fs);
 
-        if (index >= 0)
-        {
-            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, threads); }
-        }
-
-        return index;
+        LIBSAIS_MONITOR monitor = ctx->monitor;
+        if (ctx->numa != LIBSAIS64_NUMA_NONE) { monitor.thread_block_size = 0; }
+        return libsais64_ctx_status(ctx, libsais64_main_gsa_8u(T, SA, n, ctx->buckets, fs, freq, (sa_sint_t)ctx->threads, ctx->thread_state, ctx->local_buffer, (sa_sint_t)ctx->local_buffer_size, &ctx->allocator, ctx->ctx32, &monitor));
     }
 
-    sa_sint_t index = libsais64_main(T, A, n, 1, 0, NULL, fs, freq, threads);
-    if (index >= 0)
+    return -2;
+}
+
+static sa_sint_t libsais64_main_long_ctx(const LIBSAIS_CONTEXT * ctx, sa_sint_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t k, sa_sint_t fs)
+{
+    if (ctx != NULL && (ctx->thread_state != NULL || ctx->threads == 1))
     {
-        index++;
+        libsais64_numa_place_omp(ctx, SA, n, fs);
 
-        U[0] = T[n - 1];
-        libsais64_bwt_copy_8u_omp(U + 1, A, index - 1, threads);
-        libsais64_bwt_copy_8u_omp(U + index, A + index, n - index, threads);
+        LIBSAIS_MONITOR monitor = ctx->monitor;
+        if (ctx->numa != LIBSAIS64_NUMA_NONE) { monitor.thread_block_size = 0; }
+        return libsais64_ctx_status(ctx, libsais64_main_32s_compact(T, SA, n, k, fs, (sa_sint_t)ctx->threads, ctx->thread_state, ctx->local_buffer, (sa_sint_t)ctx->local_buffer_size, &ctx->allocator, ctx->ctx32, &monitor));
     }
 
-    return index;
+    return -2;
 }
 
-int64_t libsais64_bwt_aux_omp(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t r, int64_t * I, int64_t threads)
+static void libsais64_bwt_copy_8u(uint8_t * RESTRICT U, sa_sint_t * RESTRICT A, sa_sint_t n)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL) || (threads < 0))
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = 0, j = (fast_sint_t)n - 7; i < j; i += 8)
     {
-        return -1;
+        libsais64_prefetchr(&A[i + prefetch_distance]);
+
+        U[i + 0] = (uint8_t)A[i + 0];
+        U[i + 1] = (uint8_t)A[i + 1];
+        U[i + 2] = (uint8_t)A[i + 2];
+        U[i + 3] = (uint8_t)A[i + 3];
+        U[i + 4] = (uint8_t)A[i + 4];
+        U[i + 5] = (uint8_t)A[i + 5];
+        U[i + 6] = (uint8_t)A[i + 6];
+        U[i + 7] = (uint8_t)A[i + 7];
     }
-    else if (n <= 1)
+
+    for (j += 7; i < j; i += 1)
     {
-        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
-        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
-        I[0] = n;
-        return 0;
+        U[i] = (uint8_t)A[i];
     }
+}
 
-    threads = threads > 0 ? threads : omp_get_max_threads();
+static fast_sint_t libsais64_rlbwt_gather_range_8u(const sa_sint_t * RESTRICT A, uint8_t * RESTRICT C, sa_sint_t * RESTRICT L, fast_sint_t c, fast_sint_t count, fast_sint_t rs, fast_sint_t offset, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
-    if (n <= INT32_MAX && r <= INT32_MAX)
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size; i < j; i += 1)
     {
-        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
-        sa_sint_t index = libsais_bwt_aux_omp(T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)r, (int32_t *)I, (int32_t)threads);
+        libsais64_prefetchr(&A[i + prefetch_distance]);
 
-        if (index >= 0)
-        {
-            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)I, 1 + ((n - 1) / r), threads);
-            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, threads); }
-        }
+        fast_sint_t s = (uint8_t)A[i];
+        if (s != c) { if (count < rs) { C[count] = (uint8_t)s; L[count] = (sa_sint_t)(i + offset); } count++; c = s; }
+    }
 
-        return index;
+    return count;
+}
+
+static fast_sint_t libsais64_rlbwt_gather_runs_8u(const sa_sint_t * RESTRICT A, uint8_t * RESTRICT C, sa_sint_t * RESTRICT L, fast_sint_t index, fast_sint_t count, fast_sint_t rs, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t p = index - 1, i = omp_block_start, j = omp_block_start + omp_block_size, c = -1;
+
+    if (i > 0) { c = (uint8_t)A[i - 1 == 0 ? p : i - 1 <= p ? i - 2 : i - 1]; }
+
+    if (i == 0 && i < j)
+    {
+        c = (uint8_t)A[p]; if (count < rs) { C[count] = (uint8_t)c; L[count] = 0; } count++; i = 1;
     }
 
-    if (libsais64_main(T, A, n, 1, r, I, fs, freq, threads) != 0)
+    if (i <= p && i < j)
     {
-        return -2;
+        fast_sint_t e = j < p + 1 ? j : p + 1;
+        count = libsais64_rlbwt_gather_range_8u(A, C, L, c, count, rs, 1, i - 1, e - i);
+        c = (uint8_t)A[e - 2]; i = e;
     }
 
-    U[0] = T[n - 1];
-    libsais64_bwt_copy_8u_omp(U + 1, A, I[0] - 1, threads);
-    libsais64_bwt_copy_8u_omp(U + I[0], A + I[0], n - I[0], threads);
+    if (i < j)
+    {
+        count = libsais64_rlbwt_gather_range_8u(A, C, L, c, count, rs, 0, i, j - i);
+    }
 
-    return 0;
+    return count;
 }
 
-#endif
+static void libsais64_rlbwt_convert_runs(sa_sint_t * RESTRICT L, fast_sint_t next, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - 1; i < j; i += 1)
+    {
+        L[i] = L[i + 1] - L[i];
+    }
 
-static void libsais64_unbwt_compute_histogram(const uint8_t * RESTRICT T, fast_sint_t n, sa_uint_t * RESTRICT count)
+    if (omp_block_size > 0) { L[j] = (sa_sint_t)next - L[j]; }
+}
+
+static sa_sint_t libsais64_rlbwt_encode_8u_omp(const sa_sint_t * RESTRICT A, uint8_t * RESTRICT C, sa_sint_t * RESTRICT L, sa_sint_t n, sa_sint_t index, sa_sint_t rs, sa_sint_t threads)
 {
-    const fast_sint_t prefetch_distance = 256;
+    fast_sint_t count = 0;
 
-    const uint8_t * RESTRICT T_p = T;
+#if defined(LIBSAIS_OPENMP)
+    fast_sint_t * RESTRICT counts = threads > 1 && n >= 65536 ? (fast_sint_t *)libsais64_alloc_aligned((size_t)threads * sizeof(fast_sint_t), 64) : NULL;
+    if (threads > 1 && n >= 65536 && counts == NULL) { return -2; }
 
-    if (n >= 1024)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
     {
-        sa_uint_t copy[4 * (ALPHABET_SIZE + 16)];
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
 
-        memset(copy, 0, (size_t)4 * (ALPHABET_SIZE + 16) * sizeof(sa_uint_t));
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
 
-        sa_uint_t * RESTRICT copy0 = copy + 0 * (ALPHABET_SIZE + 16);
-        sa_uint_t * RESTRICT copy1 = copy + 1 * (ALPHABET_SIZE + 16);
-        sa_uint_t * RESTRICT copy2 = copy + 2 * (ALPHABET_SIZE + 16);
-        sa_uint_t * RESTRICT copy3 = copy + 3 * (ALPHABET_SIZE + 16);
+        if (omp_num_threads == 1)
+        {
+            count = libsais64_rlbwt_gather_runs_8u(A, C, L, index, 0, rs, omp_block_start, omp_block_size);
+            if (count <= rs) { libsais64_rlbwt_convert_runs(L, n, 0, count); }
+        }
+#if defined(LIBSAIS_OPENMP)
+        else
+        {
+            counts[omp_thread_num] = libsais64_rlbwt_gather_runs_8u(A, C, L, index, 0, 0, omp_block_start, omp_block_size);
 
-        for (; T_p < (uint8_t * )((ptrdiff_t)(T + 63) & (-64)); T_p += 1) { copy0[T_p[0]]++; }
+            #pragma omp barrier
 
-        fast_uint_t x = ((const uint32_t *)(const void *)T_p)[0], y = ((const uint32_t *)(const void *)T_p)[1];
+            fast_sint_t t, c = 0, total = 0; for (t = 0; t < omp_num_threads; ++t) { c += t < omp_thread_num ? counts[t] : 0; total += counts[t]; }
 
-        for (; T_p < (uint8_t * )((ptrdiff_t)(T + n - 8) & (-64)); T_p += 64)
-        { 
-            libsais64_prefetchr(&T_p[prefetch_distance]);
+            if (total <= rs)
+            {
+                libsais64_rlbwt_gather_runs_8u(A, C, L, index, c, rs, omp_block_start, omp_block_size);
 
-            fast_uint_t z = ((const uint32_t *)(const void *)T_p)[2], w = ((const uint32_t *)(const void *)T_p)[3];
-            copy0[(uint8_t)x]++; x >>= 8; copy1[(uint8_t)x]++; x >>= 8; copy2[(uint8_t)x]++; x >>= 8; copy3[x]++;
-            copy0[(uint8_t)y]++; y >>= 8; copy1[(uint8_t)y]++; y >>= 8; copy2[(uint8_t)y]++; y >>= 8; copy3[y]++;
+                #pragma omp barrier
 
-            x = ((const uint32_t *)(const void *)T_p)[4]; y = ((const uint32_t *)(const void *)T_p)[5];
-            copy0[(uint8_t)z]++; z >>= 8; copy1[(uint8_t)z]++; z >>= 8; copy2[(uint8_t)z]++; z >>= 8; copy3[z]++;
-            copy0[(uint8_t)w]++; w >>= 8; copy1[(uint8_t)w]++; w >>= 8; copy2[(uint8_t)w]++; w >>= 8; copy3[w]++;
+                fast_sint_t next = c + counts[omp_thread_num] < total ? L[c + counts[omp_thread_num]] : n;
 
-            z = ((const uint32_t *)(const void *)T_p)[6]; w = ((const uint32_t *)(const void *)T_p)[7];
-            copy0[(uint8_t)x]++; x >>= 8; copy1[(uint8_t)x]++; x >>= 8; copy2[(uint8_t)x]++; x >>= 8; copy3[x]++;
-            copy0[(uint8_t)y]++; y >>= 8; copy1[(uint8_t)y]++; y >>= 8; copy2[(uint8_t)y]++; y >>= 8; copy3[y]++;
+                #pragma omp barrier
 
-            x = ((const uint32_t *)(const void *)T_p)[8]; y = ((const uint32_t *)(const void *)T_p)[9];
-            copy0[(uint8_t)z]++; z >>= 8; copy1[(uint8_t)z]++; z >>= 8; copy2[(uint8_t)z]++; z >>= 8; copy3[z]++;
-            copy0[(uint8_t)w]++; w >>= 8; copy1[(uint8_t)w]++; w >>= 8; copy2[(uint8_t)w]++; w >>= 8; copy3[w]++;
+                libsais64_rlbwt_convert_runs(L, next, c, counts[omp_thread_num]);
+            }
 
-            z = ((const uint32_t *)(const void *)T_p)[10]; w = ((const uint32_t *)(const void *)T_p)[11];
-            copy0[(uint8_t)x]++; x >>= 8; copy1[(uint8_t)x]++; x >>= 8; copy2[(uint8_t)x]++; x >>= 8; copy3[x]++;
-            copy0[(uint8_t)y]++; y >>= 8; copy1[(uint8_t)y]++; y >>= 8; copy2[(uint8_t)y]++; y >>= 8; copy3[y]++;
+            if (omp_thread_num == omp_num_threads - 1) { count = total; }
+        }
+#endif
+    }
 
-            x = ((const uint32_t *)(const void *)T_p)[12]; y = ((const uint32_t *)(const void *)T_p)[13];
-            copy0[(uint8_t)z]++; z >>= 8; copy1[(uint8_t)z]++; z >>= 8; copy2[(uint8_t)z]++; z >>= 8; copy3[z]++;
-            copy0[(uint8_t)w]++; w >>= 8; copy1[(uint8_t)w]++; w >>= 8; copy2[(uint8_t)w]++; w >>= 8; copy3[w]++;
+#if defined(LIBSAIS_OPENMP)
+    libsais64_free_aligned(counts);
+#endif
 
-            z = ((const uint32_t *)(const void *)T_p)[14]; w = ((const uint32_t *)(const void *)T_p)[15];
-            copy0[(uint8_t)x]++; x >>= 8; copy1[(uint8_t)x]++; x >>= 8; copy2[(uint8_t)x]++; x >>= 8; copy3[x]++;
-            copy0[(uint8_t)y]++; y >>= 8; copy1[(uint8_t)y]++; y >>= 8; copy2[(uint8_t)y]++; y >>= 8; copy3[y]++;
+    return (sa_sint_t)count;
+}
 
-            x = ((const uint32_t *)(const void *)T_p)[16]; y = ((const uint32_t *)(const void *)T_p)[17];
-            copy0[(uint8_t)z]++; z >>= 8; copy1[(uint8_t)z]++; z >>= 8; copy2[(uint8_t)z]++; z >>= 8; copy3[z]++;
-            copy0[(uint8_t)w]++; w >>= 8; copy1[(uint8_t)w]++; w >>= 8; copy2[(uint8_t)w]++; w >>= 8; copy3[w]++;
-        }
 
-        copy0[(uint8_t)x]++; x >>= 8; copy1[(uint8_t)x]++; x >>= 8; copy2[(uint8_t)x]++; x >>= 8; copy3[x]++;
-        copy0[(uint8_t)y]++; y >>= 8; copy1[(uint8_t)y]++; y >>= 8; copy2[(uint8_t)y]++; y >>= 8; copy3[y]++;
+#if defined(LIBSAIS_OPENMP)
 
-        T_p += 8;
+static void libsais64_bwt_copy_8u_omp(uint8_t * RESTRICT U, sa_sint_t * RESTRICT A, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+        fast_sint_t omp_block_stride  = ((fast_sint_t)n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : (fast_sint_t)n - omp_block_start;
+#else
+        UNUSED(threads);
 
-        fast_uint_t i; for (i = 0; i < ALPHABET_SIZE; i++) { count[i] += copy0[i] + copy1[i] + copy2[i] + copy3[i]; }
+        fast_sint_t omp_block_start   = 0;
+        fast_sint_t omp_block_size    = (fast_sint_t)n;
+#endif
+
+        libsais64_bwt_copy_8u(U + omp_block_start, A + omp_block_start, (sa_sint_t)omp_block_size);
     }
+}
 
-    for (; T_p < T + n; T_p += 1) { count[T_p[0]]++; }
+#endif
+
+void * libsais64_create_ctx(void)
+{
+    return (void *)libsais64_create_ctx_main(1, NULL);
 }
 
-static void libsais64_unbwt_transpose_bucket2(sa_uint_t * RESTRICT bucket2)
+void * libsais64_create_ctx_alloc(void * (* alloc_fn)(size_t size, size_t alignment, void * opaque), void (* free_fn)(void * address, void * opaque), void * opaque)
 {
-    fast_uint_t x, y, c, d;
-    for (x = 0; x != ALPHABET_SIZE; x += 16)
+    if ((alloc_fn == NULL) || (free_fn == NULL)) { return NULL; }
+
+    LIBSAIS_ALLOCATOR allocator = { alloc_fn, free_fn, opaque };
+    return (void *)libsais64_create_ctx_main(1, &allocator);
+}
+
+void * libsais64_create_ctx_buffer(void * buffer, size_t size)
+{
+    return (void *)libsais64_create_ctx_buffer_main(1, buffer, size);
+}
+
+void libsais64_free_ctx(void * ctx)
+{
+    libsais64_free_ctx_main((LIBSAIS_CONTEXT *)ctx);
+}
+
+int64_t libsais64_alloc_size(int64_t n, int64_t k, int64_t threads)
+{
+    if ((n < 0) || (k < 0) || (threads < 0))
     {
-        for (c = x; c != x + 16; ++c)
-        {
-            for (d = c + 1; d != x + 16; ++d)
-            {
-                sa_uint_t tmp = bucket2[(d << 8) + c]; bucket2[(d << 8) + c] = bucket2[(c << 8) + d]; bucket2[(c << 8) + d] = tmp;
-            }
-        }
+        return -1;
+    }
 
-        for (y = x + 16; y != ALPHABET_SIZE; y += 16)
-        {
-            for (c = x; c != x + 16; ++c)
-            {
-                sa_uint_t * bucket2_yc = &bucket2[(y << 8) + c];
-                sa_uint_t * bucket2_cy = &bucket2[(c << 8) + y];
+#if defined(LIBSAIS_OPENMP)
+    threads = threads > 0 ? threads : omp_get_max_threads();
+#else
+    threads = 1;
+#endif
 
-                sa_uint_t tmp00 = bucket2_yc[ 0 * 256]; bucket2_yc[ 0 * 256] = bucket2_cy[ 0]; bucket2_cy[ 0] = tmp00;
-                sa_uint_t tmp01 = bucket2_yc[ 1 * 256]; bucket2_yc[ 1 * 256] = bucket2_cy[ 1]; bucket2_cy[ 1] = tmp01;
-                sa_uint_t tmp02 = bucket2_yc[ 2 * 256]; bucket2_yc[ 2 * 256] = bucket2_cy[ 2]; bucket2_cy[ 2] = tmp02;
-                sa_uint_t tmp03 = bucket2_yc[ 3 * 256]; bucket2_yc[ 3 * 256] = bucket2_cy[ 3]; bucket2_cy[ 3] = tmp03;
-                sa_uint_t tmp04 = bucket2_yc[ 4 * 256]; bucket2_yc[ 4 * 256] = bucket2_cy[ 4]; bucket2_cy[ 4] = tmp04;
-                sa_uint_t tmp05 = bucket2_yc[ 5 * 256]; bucket2_yc[ 5 * 256] = bucket2_cy[ 5]; bucket2_cy[ 5] = tmp05;
-                sa_uint_t tmp06 = bucket2_yc[ 6 * 256]; bucket2_yc[ 6 * 256] = bucket2_cy[ 6]; bucket2_cy[ 6] = tmp06;
-                sa_uint_t tmp07 = bucket2_yc[ 7 * 256]; bucket2_yc[ 7 * 256] = bucket2_cy[ 7]; bucket2_cy[ 7] = tmp07;
-                sa_uint_t tmp08 = bucket2_yc[ 8 * 256]; bucket2_yc[ 8 * 256] = bucket2_cy[ 8]; bucket2_cy[ 8] = tmp08;
-                sa_uint_t tmp09 = bucket2_yc[ 9 * 256]; bucket2_yc[ 9 * 256] = bucket2_cy[ 9]; bucket2_cy[ 9] = tmp09;
-                sa_uint_t tmp10 = bucket2_yc[10 * 256]; bucket2_yc[10 * 256] = bucket2_cy[10]; bucket2_cy[10] = tmp10;
-                sa_uint_t tmp11 = bucket2_yc[11 * 256]; bucket2_yc[11 * 256] = bucket2_cy[11]; bucket2_cy[11] = tmp11;
-                sa_uint_t tmp12 = bucket2_yc[12 * 256]; bucket2_yc[12 * 256] = bucket2_cy[12]; bucket2_cy[12] = tmp12;
-                sa_uint_t tmp13 = bucket2_yc[13 * 256]; bucket2_yc[13 * 256] = bucket2_cy[13]; bucket2_cy[13] = tmp13;
-                sa_uint_t tmp14 = bucket2_yc[14 * 256]; bucket2_yc[14 * 256] = bucket2_cy[14]; bucket2_cy[14] = tmp14;
-                sa_uint_t tmp15 = bucket2_yc[15 * 256]; bucket2_yc[15 * 256] = bucket2_cy[15]; bucket2_cy[15] = tmp15;
-            }
-        }
+    return libsais64_alloc_size_main(n, k, threads);
+}
+
+int64_t libsais64_scratch_size(int64_t n, int64_t k, int64_t fs, int64_t threads, int64_t flags)
+{
+    if ((n < 0) || (k < 0) || (fs < 0) || (threads < 0) || (flags < LIBSAIS64_FLAGS_NONE) || (flags > LIBSAIS64_FLAGS_BUFFER))
+    {
+        return -1;
     }
+
+#if defined(LIBSAIS_OPENMP)
+    threads = threads > 0 ? threads : omp_get_max_threads();
+#else
+    threads = 1;
+#endif
+
+    return libsais64_scratch_size_main(n, k, fs, threads, flags);
 }
 
-static void libsais64_unbwt_compute_bigram_histogram_single(const uint8_t * RESTRICT T, sa_uint_t * RESTRICT bucket1, sa_uint_t * RESTRICT bucket2, fast_uint_t index)
+int32_t libsais64_set_profiler(void * ctx, void (* profile_fn)(int32_t phase, int32_t end, int32_t depth, int64_t n, int64_t k, int32_t flags, void * opaque), void * opaque)
 {
-    fast_uint_t sum, c;
-    for (sum = 1, c = 0; c < ALPHABET_SIZE; ++c)
+    if (ctx == NULL)
     {
-        fast_uint_t prev = sum; sum += bucket1[c]; bucket1[c] = (sa_uint_t)prev;
-        if (prev != sum)
-        {
-            sa_uint_t * RESTRICT bucket2_p = &bucket2[c << 8];
+        return -1;
+    }
 
-            {
-                fast_uint_t hi = index; if (sum < hi) { hi = sum; }
-                libsais64_unbwt_compute_histogram(&T[prev], (fast_sint_t)(hi - prev), bucket2_p);
-            }
+    LIBSAIS_CONTEXT * RESTRICT context = (LIBSAIS_CONTEXT *)ctx;
 
-            {
-                fast_uint_t lo = index + 1; if (prev > lo) { lo = prev; }
-                libsais64_unbwt_compute_histogram(&T[lo - 1], (fast_sint_t)(sum - lo), bucket2_p);
-            }
-        }
+    if (libsais_set_profiler(context->ctx32, profile_fn, opaque) != 0)
+    {
+        return -1;
     }
 
-    libsais64_unbwt_transpose_bucket2(bucket2);
+    context->monitor.profile        = profile_fn;
+    context->monitor.profile_opaque = opaque;
+
+    return 0;
 }
 
-static void libsais64_unbwt_calculate_fastbits(sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t lastc, fast_uint_t shift)
+int32_t libsais64_set_cancel(void * ctx, int32_t (* cancel_fn)(void * opaque), void * opaque)
 {
-    fast_uint_t v, w, sum, c, d;
-    for (v = 0, w = 0, sum = 1, c = 0; c < ALPHABET_SIZE; ++c)
+    if (ctx == NULL)
     {
-        if (c == lastc) { sum += 1; }
+        return -1;
+    }
 
-        for (d = 0; d < ALPHABET_SIZE; ++d, ++w)
-        {
-            fast_uint_t prev = sum; sum += bucket2[w]; bucket2[w] = (sa_uint_t)prev;
-            if (prev != sum)
-            {
-                for (; v <= ((sum - 1) >> shift); ++v) { fastbits[v] = (uint16_t)w; }
-            }
+    LIBSAIS_CONTEXT * RESTRICT context = (LIBSAIS_CONTEXT *)ctx;
+
+    if (libsais_set_cancel(context->ctx32, cancel_fn, opaque) != 0)
+    {
+        return -1;
+    }
+
+    context->monitor.cancel         = cancel_fn;
+    context->monitor.cancel_opaque  = opaque;
+
+    return 0;
+}
+
+int32_t libsais64_set_numa(void * ctx, int32_t mode)
+{
+    if ((ctx == NULL) || (mode < LIBSAIS64_NUMA_NONE) || (mode > LIBSAIS64_NUMA_INTERLEAVE))
+    {
+        return -1;
+    }
+
+    LIBSAIS_CONTEXT * RESTRICT context = (LIBSAIS_CONTEXT *)ctx;
+
+    if (libsais_set_numa(context->ctx32, mode) != 0)
+    {
+        return -1;
+    }
+
+    context->numa = mode;
+    if (mode != LIBSAIS64_NUMA_NONE) { libsais64_numa_place_thread_state(context->thread_state, context->threads); }
+
+    return 0;
+}
+
+int32_t libsais64_set_cache_size(void * ctx, int64_t size)
+{
+    LIBSAIS_CONTEXT * RESTRICT context = (LIBSAIS_CONTEXT *)ctx;
+
+    if ((context == NULL) || (size < 1024) || (size > INT32_MAX) || ((fast_sint_t)size <= 32 * context->threads))
+    {
+        return -1;
+    }
+
+    sa_sint_t status = libsais_set_cache_size(context->ctx32, (int32_t)size);
+    if (status != 0)
+    {
+        return libsais64_ctx_status(context, status);
+    }
+
+    if (context->thread_state != NULL)
+    {
+        LIBSAIS_THREAD_CACHE * RESTRICT cache = (LIBSAIS_THREAD_CACHE *)libsais64_alloc_memory(&context->allocator, (size_t)context->threads * (size_t)size * sizeof(LIBSAIS_THREAD_CACHE), 4096);
+        if (cache == NULL)
+        {
+            return libsais64_ctx_status(context, -2);
+        }
+
+        libsais64_free_memory(&context->allocator, context->thread_state[0].state.cache);
+
+        fast_sint_t t;
+        for (t = 0; t < context->threads; ++t)
+        {
+            context->thread_state[t].state.cache      = cache + t * (fast_sint_t)size;
+            context->thread_state[t].state.cache_size = (fast_sint_t)size;
+        }
+
+        if (context->numa != LIBSAIS64_NUMA_NONE) { libsais64_numa_place_thread_state(context->thread_state, context->threads); }
+    }
+
+    return 0;
+}
+
+int32_t libsais64_set_local_buffer_size(void * ctx, int64_t size)
+{
+    LIBSAIS_CONTEXT * RESTRICT context = (LIBSAIS_CONTEXT *)ctx;
+
+    if ((context == NULL) || (size < 0) || (size > INT32_MAX))
+    {
+        return -1;
+    }
+
+    sa_sint_t status = libsais_set_local_buffer_size(context->ctx32, (int32_t)size);
+    if (status != 0)
+    {
+        return libsais64_ctx_status(context, status);
+    }
+
+    sa_sint_t * RESTRICT local_buffer = NULL;
+    if (size > LIBSAIS_LOCAL_BUFFER_SIZE)
+    {
+        local_buffer = (sa_sint_t *)libsais64_alloc_memory(&context->allocator, (size_t)size * sizeof(sa_sint_t), 4096);
+        if (local_buffer == NULL)
+        {
+            return libsais64_ctx_status(context, -2);
+        }
+    }
+
+    libsais64_free_memory(&context->allocator, context->local_buffer);
+
+    context->local_buffer      = local_buffer;
+    context->local_buffer_size  = (fast_sint_t)size;
+
+    return 0;
+}
+
+int32_t libsais64_set_adaptive_threads(void * ctx, int64_t block_size)
+{
+    if ((ctx == NULL) || (block_size < 0))
+    {
+        return -1;
+    }
+
+    LIBSAIS_CONTEXT * RESTRICT context = (LIBSAIS_CONTEXT *)ctx;
+
+    if (libsais_set_adaptive_threads(context->ctx32, block_size < INT32_MAX ? (int32_t)block_size : INT32_MAX) != 0)
+    {
+        return -1;
+    }
+
+    context->monitor.thread_block_size = (sa_sint_t)block_size;
+
+    return 0;
+}
+
+int64_t libsais64(const uint8_t * T, int64_t * SA, int64_t n, int64_t fs, int64_t * freq)
+{
+    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    if (n <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        sa_sint_t index = libsais(T, (int32_t *)SA, (int32_t)n, (int32_t)new_fs, (int32_t *)freq);
+
+        if (index >= 0)
+        {
+            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)SA, n, 1);
+            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, 1); }
+        }
+
+        return index;
+    }
+
+    return libsais64_main(T, SA, n, 0, 0, NULL, NULL, fs, freq, 1);
+}
+
+int64_t libsais64_long(int64_t * T, int64_t * SA, int64_t n, int64_t k, int64_t fs)
+{
+    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (n == 1) { SA[0] = 0; }
+        return 0;
+    }
+
+    return libsais64_main_long(T, SA, n, k, fs, 1);
+}
+
+int64_t libsais64_ctx(const void * ctx, const uint8_t * T, int64_t * SA, int64_t n, int64_t fs, int64_t * freq)
+{
+    if ((ctx == NULL) || (T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    const LIBSAIS_CONTEXT * RESTRICT context = (const LIBSAIS_CONTEXT *)ctx;
+
+    if (n <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        libsais64_numa_place_omp(context, SA, n, fs);
+        sa_sint_t index = libsais_ctx(context->ctx32, T, (int32_t *)SA, (int32_t)n, (int32_t)new_fs, (int32_t *)freq);
+
+        if (index >= 0)
+        {
+            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)SA, n, (sa_sint_t)context->threads);
+            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, (sa_sint_t)context->threads); }
+        }
+
+        return libsais64_ctx_status(context, index);
+    }
+
+    return libsais64_main_ctx(context, T, SA, n, 0, 0, NULL, NULL, fs, freq);
+}
+
+int64_t libsais64_long_ctx(const void * ctx, int64_t * T, int64_t * SA, int64_t n, int64_t k, int64_t fs)
+{
+    if ((ctx == NULL) || (T == NULL) || (SA == NULL) || (n < 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (n == 1) { SA[0] = 0; }
+        return 0;
+    }
+
+    return libsais64_main_long_ctx((const LIBSAIS_CONTEXT *)ctx, T, SA, n, k, fs);
+}
+
+int64_t libsais64_gsa(const uint8_t * T, int64_t * SA, int64_t n, int64_t fs, int64_t * freq)
+{
+    if ((T == NULL) || (SA == NULL) || (n < 0) || (n > 0 && T[n - 1] != 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    if (n <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        sa_sint_t index = libsais_gsa(T, (int32_t *)SA, (int32_t)n, (int32_t)new_fs, (int32_t *)freq);
+
+        if (index >= 0)
+        {
+            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)SA, n, 1);
+            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, 1); }
+        }
+
+        return index;
+    }
+
+    return libsais64_main_gsa(T, SA, n, fs, freq, 1);
+}
+
+int64_t libsais64_gsa_ctx(const void * ctx, const uint8_t * T, int64_t * SA, int64_t n, int64_t fs, int64_t * freq)
+{
+    if ((ctx == NULL) || (T == NULL) || (SA == NULL) || (n < 0) || (n > 0 && T[n - 1] != 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    const LIBSAIS_CONTEXT * RESTRICT context = (const LIBSAIS_CONTEXT *)ctx;
+
+    if (n <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        libsais64_numa_place_omp(context, SA, n, fs);
+        sa_sint_t index = libsais_gsa_ctx(context->ctx32, T, (int32_t *)SA, (int32_t)n, (int32_t)new_fs, (int32_t *)freq);
+
+        if (index >= 0)
+        {
+            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)SA, n, (sa_sint_t)context->threads);
+            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, (sa_sint_t)context->threads); }
+        }
+
+        return libsais64_ctx_status(context, index);
+    }
+
+    return libsais64_main_gsa_ctx(context, T, SA, n, fs, freq);
+}
+
+int64_t libsais64_bwt(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0))
+    { 
+        return -1; 
+    }
+    else if (n <= 1) 
+    { 
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        return n; 
+    }
+
+    if (n <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        sa_sint_t index = libsais_bwt(T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq);
+
+        if (index >= 0)
+        {
+            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, 1); }
+        }
+
+        return index;
+    }
+
+    sa_sint_t index = libsais64_main(T, A, n, 1, 0, NULL, NULL, fs, freq, 1);
+    if (index >= 0) 
+    { 
+        index++;
+
+        U[0] = T[n - 1];
+        libsais64_bwt_copy_8u(U + 1, A, index - 1);
+        libsais64_bwt_copy_8u(U + index, A + index, n - index);
+    }
+
+    return index;
+}
+
+int64_t libsais64_bwt_aux(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t r, int64_t * I)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL))
+    { 
+        return -1; 
+    }
+    else if (n <= 1) 
+    { 
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        I[0] = n;
+        return 0;
+    }
+
+    if (n <= INT32_MAX && r <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        sa_sint_t index = libsais_bwt_aux(T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)r, (int32_t *)I);
+
+        if (index >= 0)
+        {
+            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)I, 1 + ((n - 1) / r), 1);
+            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, 1); }
+        }
+
+        return index;
+    }
+
+    if (libsais64_main(T, A, n, 1, r, I, NULL, fs, freq, 1) != 0)
+    {
+        return -2;
+    }
+
+    U[0] = T[n - 1];
+    libsais64_bwt_copy_8u(U + 1, A, I[0] - 1);
+    libsais64_bwt_copy_8u(U + I[0], A + I[0], n - I[0]);
+
+    return 0;
+}
+
+int64_t libsais64_bwt_aux_sa(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t r, int64_t * I, int64_t * S)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL) || (S == NULL))
+    { 
+        return -1; 
+    }
+    else if (n <= 1) 
+    { 
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        I[0] = n; S[0] = 0;
+        return 0;
+    }
+
+    if (n <= INT32_MAX && r <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        sa_sint_t index = libsais_bwt_aux_sa(T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)r, (int32_t *)I, (int32_t *)S);
+
+        if (index >= 0)
+        {
+            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)I, 1 + ((n - 1) / r), 1);
+            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)S, 1 + ((n - 1) / r), 1);
+            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, 1); }
+        }
+
+        return index;
+    }
+
+    if (libsais64_main(T, A, n, 1, r, I, S, fs, freq, 1) != 0)
+    {
+        return -2;
+    }
+
+    U[0] = T[n - 1];
+    libsais64_bwt_copy_8u(U + 1, A, I[0] - 1);
+    libsais64_bwt_copy_8u(U + I[0], A + I[0], n - I[0]);
+
+    return 0;
+}
+
+int64_t libsais64_bwt_ctx(const void * ctx, const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq)
+{
+    if ((ctx == NULL) || (T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        return n;
+    }
+
+    const LIBSAIS_CONTEXT * RESTRICT context = (const LIBSAIS_CONTEXT *)ctx;
+
+    if (n <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        libsais64_numa_place_omp(context, A, n, fs);
+        sa_sint_t index = libsais_bwt_ctx(context->ctx32, T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq);
+
+        if (index >= 0)
+        {
+            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, (sa_sint_t)context->threads); }
+        }
+
+        return libsais64_ctx_status(context, index);
+    }
+
+    sa_sint_t index = libsais64_main_ctx(context, T, A, n, 1, 0, NULL, NULL, fs, freq);
+    if (index >= 0)
+    {
+        index++;
+
+        U[0] = T[n - 1];
+
+#if defined(LIBSAIS_OPENMP)
+        libsais64_bwt_copy_8u_omp(U + 1, A, index - 1, (sa_sint_t)context->threads);
+        libsais64_bwt_copy_8u_omp(U + index, A + index, n - index, (sa_sint_t)context->threads);
+#else
+        libsais64_bwt_copy_8u(U + 1, A, index - 1);
+        libsais64_bwt_copy_8u(U + index, A + index, n - index);
+#endif
+    }
+
+    return index;
+}
+
+int64_t libsais64_bwt_aux_ctx(const void * ctx, const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t r, int64_t * I)
+{
+    if ((ctx == NULL) || (T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        I[0] = n;
+        return 0;
+    }
+
+    const LIBSAIS_CONTEXT * RESTRICT context = (const LIBSAIS_CONTEXT *)ctx;
+
+    if (n <= INT32_MAX && r <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        libsais64_numa_place_omp(context, A, n, fs);
+        sa_sint_t index = libsais_bwt_aux_ctx(context->ctx32, T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)r, (int32_t *)I);
+
+        if (index >= 0)
+        {
+            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)I, 1 + ((n - 1) / r), (sa_sint_t)context->threads);
+            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, (sa_sint_t)context->threads); }
+        }
+
+        return libsais64_ctx_status(context, index);
+    }
+
+    sa_sint_t index = libsais64_main_ctx(context, T, A, n, 1, r, I, NULL, fs, freq);
+    if (index != 0)
+    {
+        return index;
+    }
+
+    U[0] = T[n - 1];
+
+#if defined(LIBSAIS_OPENMP)
+    libsais64_bwt_copy_8u_omp(U + 1, A, I[0] - 1, (sa_sint_t)context->threads);
+    libsais64_bwt_copy_8u_omp(U + I[0], A + I[0], n - I[0], (sa_sint_t)context->threads);
+#else
+    libsais64_bwt_copy_8u(U + 1, A, I[0] - 1);
+    libsais64_bwt_copy_8u(U + I[0], A + I[0], n - I[0]);
+#endif
+
+    return 0;
+}
+
+int64_t libsais64_bwt_aux_sa_ctx(const void * ctx, const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t r, int64_t * I, int64_t * S)
+{
+    if ((ctx == NULL) || (T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL) || (S == NULL))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        I[0] = n; S[0] = 0;
+        return 0;
+    }
+
+    const LIBSAIS_CONTEXT * RESTRICT context = (const LIBSAIS_CONTEXT *)ctx;
+
+    if (n <= INT32_MAX && r <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        libsais64_numa_place_omp(context, A, n, fs);
+        sa_sint_t index = libsais_bwt_aux_sa_ctx(context->ctx32, T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)r, (int32_t *)I, (int32_t *)S);
+
+        if (index >= 0)
+        {
+            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)I, 1 + ((n - 1) / r), (sa_sint_t)context->threads);
+            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)S, 1 + ((n - 1) / r), (sa_sint_t)context->threads);
+            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, (sa_sint_t)context->threads); }
+        }
+
+        return libsais64_ctx_status(context, index);
+    }
+
+    sa_sint_t index = libsais64_main_ctx(context, T, A, n, 1, r, I, S, fs, freq);
+    if (index != 0)
+    {
+        return index;
+    }
+
+    U[0] = T[n - 1];
+
+#if defined(LIBSAIS_OPENMP)
+    libsais64_bwt_copy_8u_omp(U + 1, A, I[0] - 1, (sa_sint_t)context->threads);
+    libsais64_bwt_copy_8u_omp(U + I[0], A + I[0], n - I[0], (sa_sint_t)context->threads);
+#else
+    libsais64_bwt_copy_8u(U + 1, A, I[0] - 1);
+    libsais64_bwt_copy_8u(U + I[0], A + I[0], n - I[0]);
+#endif
+
+    return 0;
+}
+
+int64_t libsais64_rlbwt(const uint8_t * T, uint8_t * C, int64_t * L, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t rs, int64_t * runs)
+{
+    if ((T == NULL) || (C == NULL) || (L == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (rs < 0) || (runs == NULL))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { if (freq != NULL) { freq[T[0]]++; } A[0] = T[0]; if (rs >= 1) { C[0] = T[0]; L[0] = 1; } }
+        *runs = n;
+        return n;
+    }
+
+    if (n <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        int32_t count = 0;
+        sa_sint_t index = libsais_rlbwt(T, C, (int32_t *)L, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)(rs < INT32_MAX ? rs : INT32_MAX), &count);
+
+        if (index >= 0)
+        {
+            *runs = count;
+            if (count <= rs) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)L, count, 1); }
+            else { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)A, n, 1); }
+            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, 1); }
+        }
+
+        return index;
+    }
+
+    sa_sint_t index = libsais64_main(T, A, n, 1, 0, NULL, NULL, fs, freq, 1);
+    if (index >= 0)
+    {
+        index++; A[index - 1] = T[n - 1];
+
+        sa_sint_t count = libsais64_rlbwt_encode_8u_omp(A, C, L, n, index, rs, 1);
+        if (count < 0) { return count; }
+
+        *runs = count;
+    }
+
+    return index;
+}
+
+int64_t libsais64_rlbwt_encode(const int64_t * A, uint8_t * C, int64_t * L, int64_t n, int64_t i, int64_t rs, int64_t * runs)
+{
+    if ((A == NULL) || (C == NULL) || (L == NULL) || (n < 0) || (i < (n > 0)) || (i > n) || (rs < 0) || (runs == NULL))
+    {
+        return -1;
+    }
+    else if (n == 0)
+    {
+        *runs = 0;
+        return 0;
+    }
+
+    sa_sint_t count = libsais64_rlbwt_encode_8u_omp(A, C, L, n, i, rs, 1);
+    if (count < 0) { return count; }
+
+    *runs = count;
+    return 0;
+}
+
+static sa_sint_t libsais64_batch_main(const uint8_t * const * T, uint8_t * const * U, sa_sint_t * const * SA, const sa_sint_t * n, const sa_sint_t * fs, sa_sint_t * const * freq, sa_sint_t * result, sa_sint_t count, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && count > 1)
+#else
+    UNUSED(threads);
+#endif
+    {
+        LIBSAIS_CONTEXT * ctx = libsais64_create_ctx_main(1, NULL);
+
+        fast_sint_t i;
+
+#if defined(LIBSAIS_OPENMP)
+        #pragma omp for schedule(dynamic, 1)
+#endif
+        for (i = 0; i < (fast_sint_t)count; ++i)
+        {
+            sa_sint_t   job_fs      = fs != NULL ? fs[i] : 0;
+            sa_sint_t * job_freq    = freq != NULL ? freq[i] : NULL;
+
+            result[i] = ctx == NULL ? -2 : U != NULL
+                ? libsais64_bwt_ctx(ctx, T[i], U[i], SA[i], n[i], job_fs, job_freq)
+                : libsais64_ctx(ctx, T[i], SA[i], n[i], job_fs, job_freq);
+        }
+
+        libsais64_free_ctx_main(ctx);
+    }
+
+    fast_sint_t i;
+    for (i = 0; i < (fast_sint_t)count; ++i)
+    {
+        if (result[i] < 0) { return result[i]; }
+    }
+
+    return 0;
+}
+
+int64_t libsais64_batch(const uint8_t * const * T, int64_t * const * SA, const int64_t * n, const int64_t * fs, int64_t * const * freq, int64_t * result, int64_t count)
+{
+    if ((T == NULL) || (SA == NULL) || (n == NULL) || (result == NULL) || (count < 0))
+    {
+        return -1;
+    }
+
+    return libsais64_batch_main(T, NULL, SA, n, fs, freq, result, count, 1);
+}
+
+int64_t libsais64_bwt_batch(const uint8_t * const * T, uint8_t * const * U, int64_t * const * A, const int64_t * n, const int64_t * fs, int64_t * const * freq, int64_t * result, int64_t count)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n == NULL) || (result == NULL) || (count < 0))
+    {
+        return -1;
+    }
+
+    return libsais64_batch_main(T, U, A, n, fs, freq, result, count, 1);
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+void * libsais64_create_ctx_omp(int64_t threads)
+{
+    if (threads < 0) { return NULL; }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return (void *)libsais64_create_ctx_main(threads, NULL);
+}
+
+void * libsais64_create_ctx_alloc_omp(int64_t threads, void * (* alloc_fn)(size_t size, size_t alignment, void * opaque), void (* free_fn)(void * address, void * opaque), void * opaque)
+{
+    if ((threads < 0) || (alloc_fn == NULL) || (free_fn == NULL)) { return NULL; }
+
+    LIBSAIS_ALLOCATOR allocator = { alloc_fn, free_fn, opaque };
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return (void *)libsais64_create_ctx_main(threads, &allocator);
+}
+
+void * libsais64_create_ctx_buffer_omp(int64_t threads, void * buffer, size_t size)
+{
+    if (threads < 0) { return NULL; }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return (void *)libsais64_create_ctx_buffer_main(threads, buffer, size);
+}
+
+int64_t libsais64_omp(const uint8_t * T, int64_t * SA, int64_t n, int64_t fs, int64_t * freq, int64_t threads)
+{
+    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    if (n <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        sa_sint_t index = libsais_omp(T, (int32_t *)SA, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)threads);
+
+        if (index >= 0)
+        {
+            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)SA, n, threads);
+            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, threads); }
+        }
+
+        return index;
+    }
+
+    return libsais64_main(T, SA, n, 0, 0, NULL, NULL, fs, freq, threads);
+}
+
+int64_t libsais64_long_omp(int64_t * T, int64_t * SA, int64_t n, int64_t k, int64_t fs, int64_t threads)
+{
+    if ((T == NULL) || (SA == NULL) || (n < 0) || (fs < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (n == 1) { SA[0] = 0; }
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais64_main_long(T, SA, n, k, fs, threads);
+}
+
+int64_t libsais64_gsa_omp(const uint8_t * T, int64_t * SA, int64_t n, int64_t fs, int64_t * freq, int64_t threads)
+{
+    if ((T == NULL) || (SA == NULL) || (n < 0) || (n > 0 && T[n - 1] != 0) || (fs < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { SA[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    if (n <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        sa_sint_t index = libsais_gsa_omp(T, (int32_t *)SA, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)threads);
+
+        if (index >= 0)
+        {
+            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)SA, n, threads);
+            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, threads); }
+        }
+
+        return index;
+    }
+
+    return libsais64_main_gsa(T, SA, n, fs, freq, threads);
+}
+
+int64_t libsais64_bwt_omp(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        return n;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    if (n <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        sa_sint_t index = libsais_bwt_omp(T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)threads);
+
+        if (index >= 0)
+        {
+            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, threads); }
+        }
+
+        return index;
+    }
+
+    sa_sint_t index = libsais64_main(T, A, n, 1, 0, NULL, NULL, fs, freq, threads);
+    if (index >= 0)
+    {
+        index++;
+
+        U[0] = T[n - 1];
+        libsais64_bwt_copy_8u_omp(U + 1, A, index - 1, threads);
+        libsais64_bwt_copy_8u_omp(U + index, A + index, n - index, threads);
+    }
+
+    return index;
+}
+
+int64_t libsais64_bwt_aux_omp(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t r, int64_t * I, int64_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        I[0] = n;
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    if (n <= INT32_MAX && r <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        sa_sint_t index = libsais_bwt_aux_omp(T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)r, (int32_t *)I, (int32_t)threads);
+
+        if (index >= 0)
+        {
+            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)I, 1 + ((n - 1) / r), threads);
+            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, threads); }
+        }
+
+        return index;
+    }
+
+    if (libsais64_main(T, A, n, 1, r, I, NULL, fs, freq, threads) != 0)
+    {
+        return -2;
+    }
+
+    U[0] = T[n - 1];
+    libsais64_bwt_copy_8u_omp(U + 1, A, I[0] - 1, threads);
+    libsais64_bwt_copy_8u_omp(U + I[0], A + I[0], n - I[0], threads);
+
+    return 0;
+}
+
+int64_t libsais64_bwt_aux_sa_omp(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t r, int64_t * I, int64_t * S, int64_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (r < 2) || ((r & (r - 1)) != 0) || (I == NULL) || (S == NULL) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        I[0] = n; S[0] = 0;
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    if (n <= INT32_MAX && r <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        sa_sint_t index = libsais_bwt_aux_sa_omp(T, U, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)r, (int32_t *)I, (int32_t *)S, (int32_t)threads);
+
+        if (index >= 0)
+        {
+            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)I, 1 + ((n - 1) / r), threads);
+            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)S, 1 + ((n - 1) / r), threads);
+            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, threads); }
+        }
+
+        return index;
+    }
+
+    if (libsais64_main(T, A, n, 1, r, I, S, fs, freq, threads) != 0)
+    {
+        return -2;
+    }
+
+    U[0] = T[n - 1];
+    libsais64_bwt_copy_8u_omp(U + 1, A, I[0] - 1, threads);
+    libsais64_bwt_copy_8u_omp(U + I[0], A + I[0], n - I[0], threads);
+
+    return 0;
+}
+
+int64_t libsais64_rlbwt_omp(const uint8_t * T, uint8_t * C, int64_t * L, int64_t * A, int64_t n, int64_t fs, int64_t * freq, int64_t rs, int64_t * runs, int64_t threads)
+{
+    if ((T == NULL) || (C == NULL) || (L == NULL) || (A == NULL) || (n < 0) || (fs < 0) || (rs < 0) || (runs == NULL) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { if (freq != NULL) { freq[T[0]]++; } A[0] = T[0]; if (rs >= 1) { C[0] = T[0]; L[0] = 1; } }
+        *runs = n;
+        return n;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    if (n <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        int32_t count = 0;
+        sa_sint_t index = libsais_rlbwt_omp(T, C, (int32_t *)L, (int32_t *)A, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)(rs < INT32_MAX ? rs : INT32_MAX), &count, (int32_t)threads);
+
+        if (index >= 0)
+        {
+            *runs = count;
+            if (count <= rs) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)L, count, threads); }
+            else { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)A, n, threads); }
+            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, threads); }
+        }
+
+        return index;
+    }
+
+    sa_sint_t index = libsais64_main(T, A, n, 1, 0, NULL, NULL, fs, freq, threads);
+    if (index >= 0)
+    {
+        index++; A[index - 1] = T[n - 1];
+
+        sa_sint_t count = libsais64_rlbwt_encode_8u_omp(A, C, L, n, index, rs, threads);
+        if (count < 0) { return count; }
+
+        *runs = count;
+    }
+
+    return index;
+}
+
+int64_t libsais64_rlbwt_encode_omp(const int64_t * A, uint8_t * C, int64_t * L, int64_t n, int64_t i, int64_t rs, int64_t * runs, int64_t threads)
+{
+    if ((A == NULL) || (C == NULL) || (L == NULL) || (n < 0) || (i < (n > 0)) || (i > n) || (rs < 0) || (runs == NULL) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n == 0)
+    {
+        *runs = 0;
+        return 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    sa_sint_t count = libsais64_rlbwt_encode_8u_omp(A, C, L, n, i, rs, threads);
+    if (count < 0) { return count; }
+
+    *runs = count;
+    return 0;
+}
+
+int64_t libsais64_batch_omp(const uint8_t * const * T, int64_t * const * SA, const int64_t * n, const int64_t * fs, int64_t * const * freq, int64_t * result, int64_t count, int64_t threads)
+{
+    if ((T == NULL) || (SA == NULL) || (n == NULL) || (result == NULL) || (count < 0) || (threads < 0))
+    {
+        return -1;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais64_batch_main(T, NULL, SA, n, fs, freq, result, count, threads);
+}
+
+int64_t libsais64_bwt_batch_omp(const uint8_t * const * T, uint8_t * const * U, int64_t * const * A, const int64_t * n, const int64_t * fs, int64_t * const * freq, int64_t * result, int64_t count, int64_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n == NULL) || (result == NULL) || (count < 0) || (threads < 0))
+    {
+        return -1;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais64_batch_main(T, U, A, n, fs, freq, result, count, threads);
+}
+
+#endif
+
+static uint64_t libsais64_stream_key(const uint8_t * RESTRICT T, fast_sint_t n, fast_sint_t p, fast_sint_t * RESTRICT length)
+{
+    uint64_t key = 0;
+    if (n - p >= 8)
+    {
+        memcpy(&key, &T[p], sizeof(uint64_t));
+        *length = 8; return libsais64_bswap64(key);
+    }
+
+    fast_sint_t i;
+    for (i = 0; i < 8; ++i) { key = (key << 8) | (p + i < n ? T[p + i] : 0); }
+
+    *length = n - p; return key;
+}
+
+static sa_sint_t libsais64_stream_compare(const LIBSAIS_STREAM * RESTRICT stream, fast_sint_t i, fast_sint_t j, fast_sint_t d)
+{
+    const uint8_t * RESTRICT T = stream->T; fast_sint_t n = stream->n, mask = stream->v - 1;
+    fast_sint_t k = (stream->delta[(i - j) & mask] - i) & mask, m = n - (i > j ? i : j);
+
+    for (; d + 8 <= k && d + 8 <= m; d += 8)
+    {
+        uint64_t x, y; memcpy(&x, &T[i + d], sizeof(uint64_t)); memcpy(&y, &T[j + d], sizeof(uint64_t)); if (x != y) { break; }
+    }
+
+    for (; d < k; ++d)
+    {
+        if (i + d == n) { return -1; }
+        if (j + d == n) { return +1; }
+        if (T[i + d] != T[j + d]) { return T[i + d] < T[j + d] ? -1 : +1; }
+    }
+
+    if (i + k == n) { return -1; }
+    if (j + k == n) { return +1; }
+
+    fast_sint_t p = i + k, q = j + k;
+    return stream->rank[stream->offset[p & mask] + (p >> stream->shift)] < stream->rank[stream->offset[q & mask] + (q >> stream->shift)] ? -1 : +1;
+}
+
+static void libsais64_stream_sift_down(const LIBSAIS_STREAM * RESTRICT stream, sa_sint_t * RESTRICT SA, fast_sint_t i, fast_sint_t count, fast_sint_t d)
+{
+    sa_sint_t p = SA[i]; fast_sint_t c;
+    for (c = 2 * i + 1; c < count; i = c, c = 2 * i + 1)
+    {
+        if (c + 1 < count && libsais64_stream_compare(stream, SA[c], SA[c + 1], d) < 0) { c++; }
+        if (libsais64_stream_compare(stream, p, SA[c], d) >= 0) { break; }
+
+        SA[i] = SA[c];
+    }
+
+    SA[i] = p;
+}
+
+static void libsais64_stream_sort_ranks(const LIBSAIS_STREAM * RESTRICT stream, sa_sint_t * RESTRICT SA, fast_sint_t count, fast_sint_t d)
+{
+    fast_sint_t i, j;
+
+    if (count < 16)
+    {
+        for (i = 1; i < count; ++i)
+        {
+            sa_sint_t p = SA[i]; for (j = i; j > 0 && libsais64_stream_compare(stream, p, SA[j - 1], d) < 0; --j) { SA[j] = SA[j - 1]; } SA[j] = p;
+        }
+
+        return;
+    }
+
+    for (i = count / 2 - 1; i >= 0; --i) { libsais64_stream_sift_down(stream, SA, i, count, d); }
+    for (i = count - 1; i > 0; --i) { sa_sint_t p = SA[0]; SA[0] = SA[i]; SA[i] = p; libsais64_stream_sift_down(stream, SA, 0, i, d); }
+}
+
+static void libsais64_stream_sort(const LIBSAIS_STREAM * RESTRICT stream, sa_sint_t * RESTRICT SA, fast_sint_t count, fast_sint_t d)
+{
+    const uint8_t * RESTRICT T = stream->T; fast_sint_t n = stream->n;
+
+    while (count > 1 && d < stream->v && (stream->names != NULL || count >= 16))
+    {
+        fast_sint_t la, lb, lc, lp;
+        uint64_t a = libsais64_stream_key(T, n, SA[0] + d, &la);
+        uint64_t b = libsais64_stream_key(T, n, SA[count >> 1] + d, &lb);
+        uint64_t c = libsais64_stream_key(T, n, SA[count - 1] + d, &lc);
+
+        uint64_t pivot;
+        if ((a < b || (a == b && la <= lb)) == (b < c || (b == c && lb <= lc)))         { pivot = b; lp = lb; }
+        else if ((b < a || (b == a && lb <= la)) == (a < c || (a == c && la <= lc)))    { pivot = a; lp = la; }
+        else                                                                            { pivot = c; lp = lc; }
+
+        fast_sint_t lt = 0, i = 0, gt = count;
+        while (i < gt)
+        {
+            sa_sint_t p = SA[i]; fast_sint_t l; uint64_t x = libsais64_stream_key(T, n, p + d, &l);
+
+            if (x < pivot || (x == pivot && l < lp))        { SA[i++] = SA[lt]; SA[lt++] = p; }
+            else if (x > pivot || (x == pivot && l > lp))   { SA[i] = SA[--gt]; SA[gt] = p; }
+            else                                            { i++; }
+        }
+
+        fast_sint_t l = lt, e = gt - lt, r = count - gt;
+        if (l >= e && l >= r)
+        {
+            libsais64_stream_sort(stream, SA + lt, e, d + 8);
+            libsais64_stream_sort(stream, SA + gt, r, d);
+            count = l;
+        }
+        else if (r >= e)
+        {
+            libsais64_stream_sort(stream, SA, l, d);
+            libsais64_stream_sort(stream, SA + lt, e, d + 8);
+            SA += gt; count = r;
+        }
+        else
+        {
+            libsais64_stream_sort(stream, SA, l, d);
+            libsais64_stream_sort(stream, SA + gt, r, d);
+            SA += lt; count = e; d += 8;
+        }
+    }
+
+    if (stream->names != NULL)
+    {
+        fast_sint_t i, mask = stream->v - 1; sa_sint_t name = (sa_sint_t)(SA - stream->block) + 1;
+        for (i = 0; i < count; ++i) { stream->names[stream->offset[SA[i] & mask] + (SA[i] >> stream->shift)] = name; }
+    }
+    else if (count > 1)
+    {
+        libsais64_stream_sort_ranks(stream, SA, count, d);
+    }
+}
+
+static fast_sint_t libsais64_stream_cover(LIBSAIS_STREAM * RESTRICT stream, fast_sint_t n, fast_sint_t v)
+{
+    fast_sint_t s = (fast_sint_t)1 << ((stream->shift + 1) >> 1);
+    fast_sint_t a, b, size = 0;
+
+    for (a = 0; a < v; ++a) { stream->offset[a] = -1; stream->delta[a] = -1; }
+    for (a = 0; a < s; ++a) { stream->offset[a] = 0; }
+    for (a = s; a < v; a += s) { stream->offset[a] = 0; }
+
+    for (a = 0; a < v; ++a)
+    {
+        if (stream->offset[a] < 0) { continue; }
+
+        for (b = 0; b < v; ++b)
+        {
+            if (stream->offset[b] >= 0 && stream->delta[(a - b) & (v - 1)] < 0) { stream->delta[(a - b) & (v - 1)] = a; }
+        }
+
+        stream->offset[a] = size; size += (a < n ? (n - 1 - a) / v + 1 : 0) + 1;
+    }
+
+    return size;
+}
+
+static sa_sint_t libsais64_stream_rank_samples(LIBSAIS_STREAM * RESTRICT stream, fast_sint_t size, sa_sint_t threads)
+{
+    fast_sint_t n = stream->n, v = stream->v, a, p, m = 0;
+
+    sa_sint_t * RESTRICT SA = (sa_sint_t *)libsais64_alloc_aligned((size_t)size * sizeof(sa_sint_t), 4096);
+    sa_sint_t * RESTRICT R  = (sa_sint_t *)libsais64_alloc_aligned((size_t)size * sizeof(sa_sint_t), 4096);
+
+    if (SA == NULL || R == NULL)
+    {
+        libsais64_free_aligned(R);
+        libsais64_free_aligned(SA);
+
+        return -2;
+    }
+
+    for (a = 0; a < v; ++a)
+    {
+        if (stream->offset[a] < 0) { continue; }
+
+        for (p = a; p < n; p += v) { SA[m++] = p; }
+        R[stream->offset[a] + (a < n ? (n - 1 - a) / v + 1 : 0)] = 0;
+    }
+
+    stream->names = R; stream->block = SA;
+    libsais64_stream_sort(stream, SA, m, 0);
+    stream->names = NULL; stream->block = NULL;
+
+    sa_sint_t index = libsais64_main_long(R, SA, size, m + 1, 0, threads);
+    if (index >= 0)
+    {
+        for (p = 0; p < size; ++p) { R[SA[p]] = p; }
+        stream->rank = R; R = NULL;
+    }
+
+    libsais64_free_aligned(R);
+    libsais64_free_aligned(SA);
+
+    return index < 0 ? index : 0;
+}
+
+static sa_sint_t libsais64_stream_member(const LIBSAIS_STREAM * RESTRICT stream, fast_sint_t p, fast_sint_t lo, fast_sint_t hi)
+{
+    return (lo < 0 || p == lo || libsais64_stream_compare(stream, p, lo, 0) > 0) && (hi < 0 || (p != hi && libsais64_stream_compare(stream, p, hi, 0) < 0));
+}
+
+static sa_sint_t libsais64_stream_write(LIBSAIS_STREAM * RESTRICT stream, sa_sint_t * RESTRICT SA, fast_sint_t count)
+{
+    if (stream->write_bwt != NULL)
+    {
+        const uint8_t * RESTRICT T = stream->T; uint8_t * RESTRICT U = (uint8_t *)(void *)SA;
+
+        fast_sint_t i, j;
+        for (i = 0, j = 0; i < count; ++i)
+        {
+            sa_sint_t p = SA[i];
+            if (p > 0) { U[j++] = T[p - 1]; } else { stream->index = (sa_sint_t)(stream->emitted + i + 1); }
+        }
+
+        stream->emitted += count;
+        return j > 0 && stream->write_bwt(U, (int64_t)j, stream->opaque) != 0 ? -4 : 0;
+    }
+
+    stream->emitted += count;
+    return stream->write_sa(SA, (int64_t)count, stream->opaque) != 0 ? -4 : 0;
+}
+
+static sa_sint_t libsais64_stream_block(LIBSAIS_STREAM * RESTRICT stream, fast_sint_t lo, fast_sint_t hi, fast_sint_t count)
+{
+    sa_sint_t * RESTRICT SA = stream->block;
+
+    fast_sint_t p, m = 0;
+    for (p = 0; p < stream->n && m < count; ++p)
+    {
+        if (libsais64_stream_member(stream, p, lo, hi)) { SA[m++] = p; }
+    }
+
+    libsais64_stream_sort(stream, SA, m, 0);
+    return libsais64_stream_write(stream, SA, m);
+}
+
+static sa_sint_t libsais64_stream_partition(LIBSAIS_STREAM * RESTRICT stream, fast_sint_t lo, fast_sint_t hi, fast_sint_t count)
+{
+    if (count <= stream->block_size)
+    {
+        return count > 0 ? libsais64_stream_block(stream, lo, hi, count) : 0;
+    }
+
+    fast_sint_t q = (count / stream->block_size) * 8 + 1; q = q < count - 1 ? q : count - 1;
+
+    sa_sint_t * RESTRICT splitters  = (sa_sint_t *)libsais64_alloc_aligned((size_t)q * sizeof(sa_sint_t), 4096);
+    sa_sint_t * RESTRICT counts     = (sa_sint_t *)libsais64_alloc_aligned(((size_t)q + 1) * sizeof(sa_sint_t), 4096);
+
+    sa_sint_t index = splitters != NULL && counts != NULL ? 0 : -2;
+    if (index == 0)
+    {
+        fast_sint_t p, j, seen = 0;
+        for (p = 0; p < stream->n; ++p)
+        {
+            if (p != lo && libsais64_stream_member(stream, p, lo, hi))
+            {
+                if (seen < q)
+                {
+                    splitters[seen] = p;
+                }
+                else
+                {
+                    stream->seed ^= stream->seed << 13; stream->seed ^= stream->seed >> 7; stream->seed ^= stream->seed << 17;
+                    fast_sint_t r = (fast_sint_t)(stream->seed % (uint64_t)(seen + 1)); if (r < q) { splitters[r] = p; }
+                }
+
+                seen++;
+            }
+        }
+
+        q = q < seen ? q : seen;
+        libsais64_stream_sort(stream, splitters, q, 0);
+
+        memset(counts, 0, ((size_t)q + 1) * sizeof(sa_sint_t));
+        for (p = 0; p < stream->n; ++p)
+        {
+            if (libsais64_stream_member(stream, p, lo, hi))
+            {
+                fast_sint_t l = 0, r = q;
+                while (l < r)
+                {
+                    fast_sint_t m = (l + r) >> 1;
+                    if (p == splitters[m] || libsais64_stream_compare(stream, p, splitters[m], 0) > 0) { l = m + 1; } else { r = m; }
+                }
+
+                counts[l]++;
+            }
+        }
+
+        for (j = 0; j <= q && index == 0;)
+        {
+            fast_sint_t e = j + 1, sum = counts[j];
+            while (e <= q && sum + counts[e] <= stream->block_size) { sum += counts[e++]; }
+
+            index = libsais64_stream_partition(stream, j > 0 ? splitters[j - 1] : lo, e <= q ? splitters[e - 1] : hi, sum);
+            j = e;
+        }
+    }
+
+    libsais64_free_aligned(counts);
+    libsais64_free_aligned(splitters);
+
+    return index;
+}
+
+static sa_sint_t libsais64_stream_main(const uint8_t * T, sa_sint_t n, int64_t budget, int32_t (* write_sa)(const int64_t * SA, int64_t count, void * opaque), int32_t (* write_bwt)(const uint8_t * U, int64_t count, void * opaque), void * opaque, sa_sint_t threads)
+{
+    if (write_bwt != NULL && write_bwt(&T[n - 1], 1, opaque) != 0)
+    {
+        return -4;
+    }
+
+    LIBSAIS_STREAM * RESTRICT stream = (LIBSAIS_STREAM *)libsais64_alloc_aligned(sizeof(LIBSAIS_STREAM), 64);
+    if (stream == NULL)
+    {
+        return -2;
+    }
+
+    memset(stream, 0, sizeof(LIBSAIS_STREAM));
+    stream->T           = T;
+    stream->n           = n;
+    stream->seed        = 0x9e3779b97f4a7c15ULL;
+    stream->write_sa    = write_sa;
+    stream->write_bwt   = write_bwt;
+    stream->opaque      = opaque;
+
+    sa_sint_t index = 0;
+    if ((uint64_t)n <= (uint64_t)budget / sizeof(sa_sint_t))
+    {
+        stream->block = (sa_sint_t *)libsais64_alloc_aligned((size_t)n * sizeof(sa_sint_t), 4096);
+        if (stream->block == NULL) { index = -2; }
+
+#if defined(LIBSAIS_OPENMP)
+        if (index == 0) { index = libsais64_omp(T, stream->block, n, 0, NULL, threads); }
+#else
+        if (index == 0) { index = libsais64(T, stream->block, n, 0, NULL); }
+#endif
+
+        if (index == 0) { index = libsais64_stream_write(stream, stream->block, n); }
+    }
+    else
+    {
+        fast_sint_t size = 0;
+        for (stream->v = LIBSAIS_STREAM_MIN_COVER, stream->shift = 6; stream->v <= LIBSAIS_STREAM_MAX_COVER; stream->v <<= 1, stream->shift++)
+        {
+            size = libsais64_stream_cover(stream, n, stream->v);
+            if ((uint64_t)size <= (uint64_t)budget / (2 * sizeof(sa_sint_t))) { break; }
+        }
+
+        if (stream->v > LIBSAIS_STREAM_MAX_COVER)
+        {
+            index = -3;
+        }
+        else
+        {
+            stream->block_size = (fast_sint_t)((budget / (int64_t)sizeof(sa_sint_t)) - size);
+
+            index = libsais64_stream_rank_samples(stream, size, threads);
+            if (index == 0)
+            {
+                stream->block = (sa_sint_t *)libsais64_alloc_aligned((size_t)stream->block_size * sizeof(sa_sint_t), 4096);
+                index = stream->block != NULL ? libsais64_stream_partition(stream, -1, -1, n) : -2;
+            }
+        }
+    }
+
+    if (index == 0 && write_bwt != NULL) { index = stream->index; }
+
+    libsais64_free_aligned(stream->block);
+    libsais64_free_aligned(stream->rank);
+    libsais64_free_aligned(stream);
+
+    return index;
+}
+
+static int32_t libsais64_bwt_lowmem_write(const uint8_t * U, int64_t count, void * opaque)
+{
+    uint8_t ** RESTRICT output = (uint8_t **)opaque;
+
+    memcpy(*output, U, (size_t)count); *output += count;
+    return 0;
+}
+
+static sa_sint_t libsais64_bwt_lowmem_main(const uint8_t * T, uint8_t * U, sa_sint_t n, int64_t budget, sa_sint_t * freq, sa_sint_t threads)
+{
+    if (n <= INT32_MAX && (uint64_t)n <= (uint64_t)budget / sizeof(int32_t))
+    {
+        int32_t * RESTRICT A = (int32_t *)libsais64_alloc_aligned((size_t)n * sizeof(int32_t), 4096);
+        if (A == NULL)
+        {
+            return -2;
+        }
+
+#if defined(LIBSAIS_OPENMP)
+        sa_sint_t index = libsais_bwt_omp(T, U, A, (int32_t)n, 0, (int32_t *)freq, (int32_t)threads);
+#else
+        sa_sint_t index = libsais_bwt(T, U, A, (int32_t)n, 0, (int32_t *)freq);
+#endif
+
+        if (index >= 0)
+        {
+            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, threads); }
+        }
+
+        libsais64_free_aligned(A);
+        return index;
+    }
+
+    if (freq != NULL)
+    {
+        fast_sint_t i; memset(freq, 0, ALPHABET_SIZE * sizeof(sa_sint_t));
+        for (i = 0; i < n; ++i) { freq[T[i]]++; }
+    }
+
+    uint8_t * output = U;
+    return libsais64_stream_main(T, n, budget, NULL, libsais64_bwt_lowmem_write, &output, threads);
+}
+
+int64_t libsais64_stream_min_budget(int64_t n)
+{
+    if (n < 0)
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        return 0;
+    }
+
+    LIBSAIS_STREAM * RESTRICT stream = (LIBSAIS_STREAM *)libsais64_alloc_aligned(sizeof(LIBSAIS_STREAM), 64);
+    if (stream == NULL)
+    {
+        return -2;
+    }
+
+    uint64_t budget = (uint64_t)n * sizeof(sa_sint_t);
+    for (stream->v = LIBSAIS_STREAM_MIN_COVER, stream->shift = 6; stream->v <= LIBSAIS_STREAM_MAX_COVER; stream->v <<= 1, stream->shift++)
+    {
+        uint64_t size = (uint64_t)libsais64_stream_cover(stream, n, stream->v) * (2 * sizeof(sa_sint_t));
+        budget = size < budget ? size : budget;
+    }
+
+    libsais64_free_aligned(stream);
+
+    return (int64_t)budget;
+}
+
+int64_t libsais64_stream(const uint8_t * T, int64_t n, int64_t budget, int32_t (* write_fn)(const int64_t * SA, int64_t count, void * opaque), void * opaque)
+{
+    if ((T == NULL) || (n < 0) || (budget < 0) || (write_fn == NULL))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        sa_sint_t SA[1] = { 0 };
+        return n == 1 && write_fn(SA, 1, opaque) != 0 ? -4 : 0;
+    }
+
+    return libsais64_stream_main(T, n, budget, write_fn, NULL, opaque, 1);
+}
+
+int64_t libsais64_bwt_stream(const uint8_t * T, int64_t n, int64_t budget, int32_t (* write_fn)(const uint8_t * U, int64_t count, void * opaque), void * opaque)
+{
+    if ((T == NULL) || (n < 0) || (budget < 0) || (write_fn == NULL))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        return n == 1 && write_fn(T, 1, opaque) != 0 ? -4 : n;
+    }
+
+    return libsais64_stream_main(T, n, budget, NULL, write_fn, opaque, 1);
+}
+
+int64_t libsais64_bwt_lowmem(const uint8_t * T, uint8_t * U, int64_t n, int64_t budget, int64_t * freq)
+{
+    if ((T == NULL) || (U == NULL) || (n < 0) || (budget < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        return n;
+    }
+
+    return libsais64_bwt_lowmem_main(T, U, n, budget, freq, 1);
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+int64_t libsais64_stream_omp(const uint8_t * T, int64_t n, int64_t budget, int32_t (* write_fn)(const int64_t * SA, int64_t count, void * opaque), void * opaque, int64_t threads)
+{
+    if ((T == NULL) || (n < 0) || (budget < 0) || (write_fn == NULL) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n < 2)
+    {
+        sa_sint_t SA[1] = { 0 };
+        return n == 1 && write_fn(SA, 1, opaque) != 0 ? -4 : 0;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return libsais64_stream_main(T, n, budget, write_fn, NULL, opaque, threads);
+}
+
+int64_t libsais64_bwt_stream_omp(const uint8_t * T, int64_t n, int64_t budget, int32_t (* write_fn)(const uint8_t * U, int64_t count, void * opaque), void * opaque, int64_t threads)
+{
+    if ((T == NULL) || (n < 0) || (budget < 0) || (write_fn == NULL) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        return n == 1 && write_fn(T, 1, opaque) != 0 ? -4 : n;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return libsais64_stream_main(T, n, budget, NULL, write_fn, opaque, threads);
+}
+
+int64_t libsais64_bwt_lowmem_omp(const uint8_t * T, uint8_t * U, int64_t n, int64_t budget, int64_t * freq, int64_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (n < 0) || (budget < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { U[0] = T[0]; if (freq != NULL) { freq[T[0]]++; } }
+        return n;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return libsais64_bwt_lowmem_main(T, U, n, budget, freq, threads);
+}
+
+#endif
+
+static LIBSAIS_UNBWT_CONTEXT * libsais64_unbwt_create_ctx_main(sa_sint_t threads, const LIBSAIS_ALLOCATOR * allocator)
+{
+    LIBSAIS_UNBWT_CONTEXT *     RESTRICT ctx            = (LIBSAIS_UNBWT_CONTEXT *)libsais64_alloc_memory(allocator, sizeof(LIBSAIS_UNBWT_CONTEXT), 64);
+    sa_uint_t *                 RESTRICT bucket2        = (sa_uint_t *)libsais64_alloc_memory(allocator, ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_uint_t), 4096);
+    uint16_t *                  RESTRICT fastbits       = (uint16_t *)libsais64_alloc_memory(allocator, (1 + (1 << UNBWT_FASTBITS)) * sizeof(uint16_t), 4096);
+    sa_uint_t *                 RESTRICT buckets        = threads > 1 ? (sa_uint_t *)libsais64_alloc_memory(allocator, (size_t)threads * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE)) * sizeof(sa_uint_t), 4096) : NULL;
+#if defined(LIBSAIS_OPENMP)
+    void *                               ctx32          = allocator != NULL && allocator->alloc != NULL
+        ? libsais_unbwt_create_ctx_alloc_omp((int32_t)threads, allocator->alloc, allocator->free, allocator->opaque)
+        : libsais_unbwt_create_ctx_omp((int32_t)threads);
+#else
+    void *                               ctx32          = allocator != NULL && allocator->alloc != NULL
+        ? libsais_unbwt_create_ctx_alloc(allocator->alloc, allocator->free, allocator->opaque)
+        : libsais_unbwt_create_ctx();
+#endif
+
+    if (ctx != NULL && bucket2 != NULL && fastbits != NULL && (buckets != NULL || threads == 1) && ctx32 != NULL)
+    {
+        ctx->bucket2      = bucket2;
+        ctx->fastbits     = fastbits;
+        ctx->buckets      = buckets;
+        ctx->fastbits_log = UNBWT_FASTBITS;
+        ctx->threads      = threads;
+        ctx->ctx32        = ctx32;
+
+        if (allocator != NULL) { ctx->allocator = *allocator; } else { memset(&ctx->allocator, 0, sizeof(LIBSAIS_ALLOCATOR)); }
+
+        return ctx;
+    }
+
+    libsais_unbwt_free_ctx(ctx32);
+    libsais64_free_memory(allocator, buckets);
+    libsais64_free_memory(allocator, fastbits);
+    libsais64_free_memory(allocator, bucket2);
+    libsais64_free_memory(allocator, ctx);
+
+    return NULL;
+}
+
+static void libsais64_unbwt_free_ctx_main(LIBSAIS_UNBWT_CONTEXT * ctx)
+{
+    if (ctx != NULL)
+    {
+        LIBSAIS_ALLOCATOR allocator = ctx->allocator;
+
+        libsais_unbwt_free_ctx(ctx->ctx32);
+        libsais64_free_memory(&allocator, ctx->buckets);
+        libsais64_free_memory(&allocator, ctx->fastbits);
+        libsais64_free_memory(&allocator, ctx->bucket2);
+        libsais64_free_memory(&allocator, ctx);
+    }
+}
+
+static int64_t libsais64_unbwt_alloc_size_main(fast_sint_t threads)
+{
+    int64_t size = (int64_t)sizeof(LIBSAIS_UNBWT_CONTEXT) + 64;
+
+    size += (int64_t)ALPHABET_SIZE * ALPHABET_SIZE * (int64_t)sizeof(sa_uint_t) + 4096;
+    size += ((int64_t)1 + ((int64_t)1 << UNBWT_FASTBITS)) * (int64_t)sizeof(uint16_t) + 4096;
+
+    if (threads > 1)
+    {
+        size += (int64_t)threads * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE)) * (int64_t)sizeof(sa_uint_t) + 4096;
+    }
+
+    size += libsais_unbwt_alloc_size((int32_t)threads);
+
+    return size;
+}
+
+static void libsais64_unbwt_compute_histogram(const uint8_t * RESTRICT T, fast_sint_t n, sa_uint_t * RESTRICT count)
+{
+    const fast_sint_t prefetch_distance = 256;
+
+    const uint8_t * RESTRICT T_p = T;
+
+    if (n >= 1024)
+    {
+        sa_uint_t copy[4 * (ALPHABET_SIZE + 16)];
+
+        memset(copy, 0, (size_t)4 * (ALPHABET_SIZE + 16) * sizeof(sa_uint_t));
+
+        sa_uint_t * RESTRICT copy0 = copy + 0 * (ALPHABET_SIZE + 16);
+        sa_uint_t * RESTRICT copy1 = copy + 1 * (ALPHABET_SIZE + 16);
+        sa_uint_t * RESTRICT copy2 = copy + 2 * (ALPHABET_SIZE + 16);
+        sa_uint_t * RESTRICT copy3 = copy + 3 * (ALPHABET_SIZE + 16);
+
+        for (; T_p < (uint8_t * )((ptrdiff_t)(T + 63) & (-64)); T_p += 1) { copy0[T_p[0]]++; }
+
+        fast_uint_t x = ((const uint32_t *)(const void *)T_p)[0], y = ((const uint32_t *)(const void *)T_p)[1];
+
+        for (; T_p < (uint8_t * )((ptrdiff_t)(T + n - 8) & (-64)); T_p += 64)
+        { 
+            libsais64_prefetchr(&T_p[prefetch_distance]);
+
+            fast_uint_t z = ((const uint32_t *)(const void *)T_p)[2], w = ((const uint32_t *)(const void *)T_p)[3];
+            copy0[(uint8_t)x]++; x >>= 8; copy1[(uint8_t)x]++; x >>= 8; copy2[(uint8_t)x]++; x >>= 8; copy3[x]++;
+            copy0[(uint8_t)y]++; y >>= 8; copy1[(uint8_t)y]++; y >>= 8; copy2[(uint8_t)y]++; y >>= 8; copy3[y]++;
+
+            x = ((const uint32_t *)(const void *)T_p)[4]; y = ((const uint32_t *)(const void *)T_p)[5];
+            copy0[(uint8_t)z]++; z >>= 8; copy1[(uint8_t)z]++; z >>= 8; copy2[(uint8_t)z]++; z >>= 8; copy3[z]++;
+            copy0[(uint8_t)w]++; w >>= 8; copy1[(uint8_t)w]++; w >>= 8; copy2[(uint8_t)w]++; w >>= 8; copy3[w]++;
+
+            z = ((const uint32_t *)(const void *)T_p)[6]; w = ((const uint32_t *)(const void *)T_p)[7];
+            copy0[(uint8_t)x]++; x >>= 8; copy1[(uint8_t)x]++; x >>= 8; copy2[(uint8_t)x]++; x >>= 8; copy3[x]++;
+            copy0[(uint8_t)y]++; y >>= 8; copy1[(uint8_t)y]++; y >>= 8; copy2[(uint8_t)y]++; y >>= 8; copy3[y]++;
+
+            x = ((const uint32_t *)(const void *)T_p)[8]; y = ((const uint32_t *)(const void *)T_p)[9];
+            copy0[(uint8_t)z]++; z >>= 8; copy1[(uint8_t)z]++; z >>= 8; copy2[(uint8_t)z]++; z >>= 8; copy3[z]++;
+            copy0[(uint8_t)w]++; w >>= 8; copy1[(uint8_t)w]++; w >>= 8; copy2[(uint8_t)w]++; w >>= 8; copy3[w]++;
+
+            z = ((const uint32_t *)(const void *)T_p)[10]; w = ((const uint32_t *)(const void *)T_p)[11];
+            copy0[(uint8_t)x]++; x >>= 8; copy1[(uint8_t)x]++; x >>= 8; copy2[(uint8_t)x]++; x >>= 8; copy3[x]++;
+            copy0[(uint8_t)y]++; y >>= 8; copy1[(uint8_t)y]++; y >>= 8; copy2[(uint8_t)y]++; y >>= 8; copy3[y]++;
+
+            x = ((const uint32_t *)(const void *)T_p)[12]; y = ((const uint32_t *)(const void *)T_p)[13];
+            copy0[(uint8_t)z]++; z >>= 8; copy1[(uint8_t)z]++; z >>= 8; copy2[(uint8_t)z]++; z >>= 8; copy3[z]++;
+            copy0[(uint8_t)w]++; w >>= 8; copy1[(uint8_t)w]++; w >>= 8; copy2[(uint8_t)w]++; w >>= 8; copy3[w]++;
+
+            z = ((const uint32_t *)(const void *)T_p)[14]; w = ((const uint32_t *)(const void *)T_p)[15];
+            copy0[(uint8_t)x]++; x >>= 8; copy1[(uint8_t)x]++; x >>= 8; copy2[(uint8_t)x]++; x >>= 8; copy3[x]++;
+            copy0[(uint8_t)y]++; y >>= 8; copy1[(uint8_t)y]++; y >>= 8; copy2[(uint8_t)y]++; y >>= 8; copy3[y]++;
+
+            x = ((const uint32_t *)(const void *)T_p)[16]; y = ((const uint32_t *)(const void *)T_p)[17];
+            copy0[(uint8_t)z]++; z >>= 8; copy1[(uint8_t)z]++; z >>= 8; copy2[(uint8_t)z]++; z >>= 8; copy3[z]++;
+            copy0[(uint8_t)w]++; w >>= 8; copy1[(uint8_t)w]++; w >>= 8; copy2[(uint8_t)w]++; w >>= 8; copy3[w]++;
+        }
+
+        copy0[(uint8_t)x]++; x >>= 8; copy1[(uint8_t)x]++; x >>= 8; copy2[(uint8_t)x]++; x >>= 8; copy3[x]++;
+        copy0[(uint8_t)y]++; y >>= 8; copy1[(uint8_t)y]++; y >>= 8; copy2[(uint8_t)y]++; y >>= 8; copy3[y]++;
+
+        T_p += 8;
+
+        fast_uint_t i; for (i = 0; i < ALPHABET_SIZE; i++) { count[i] += copy0[i] + copy1[i] + copy2[i] + copy3[i]; }
+    }
+
+    for (; T_p < T + n; T_p += 1) { count[T_p[0]]++; }
+}
+
+static void libsais64_unbwt_transpose_bucket2(sa_uint_t * RESTRICT bucket2)
+{
+    fast_uint_t x, y, c, d;
+    for (x = 0; x != ALPHABET_SIZE; x += 16)
+    {
+        for (c = x; c != x + 16; ++c)
+        {
+            for (d = c + 1; d != x + 16; ++d)
+            {
+                sa_uint_t tmp = bucket2[(d << 8) + c]; bucket2[(d << 8) + c] = bucket2[(c << 8) + d]; bucket2[(c << 8) + d] = tmp;
+            }
+        }
+
+        for (y = x + 16; y != ALPHABET_SIZE; y += 16)
+        {
+            for (c = x; c != x + 16; ++c)
+            {
+                sa_uint_t * bucket2_yc = &bucket2[(y << 8) + c];
+                sa_uint_t * bucket2_cy = &bucket2[(c << 8) + y];
+
+                sa_uint_t tmp00 = bucket2_yc[ 0 * 256]; bucket2_yc[ 0 * 256] = bucket2_cy[ 0]; bucket2_cy[ 0] = tmp00;
+                sa_uint_t tmp01 = bucket2_yc[ 1 * 256]; bucket2_yc[ 1 * 256] = bucket2_cy[ 1]; bucket2_cy[ 1] = tmp01;
+                sa_uint_t tmp02 = bucket2_yc[ 2 * 256]; bucket2_yc[ 2 * 256] = bucket2_cy[ 2]; bucket2_cy[ 2] = tmp02;
+                sa_uint_t tmp03 = bucket2_yc[ 3 * 256]; bucket2_yc[ 3 * 256] = bucket2_cy[ 3]; bucket2_cy[ 3] = tmp03;
+                sa_uint_t tmp04 = bucket2_yc[ 4 * 256]; bucket2_yc[ 4 * 256] = bucket2_cy[ 4]; bucket2_cy[ 4] = tmp04;
+                sa_uint_t tmp05 = bucket2_yc[ 5 * 256]; bucket2_yc[ 5 * 256] = bucket2_cy[ 5]; bucket2_cy[ 5] = tmp05;
+                sa_uint_t tmp06 = bucket2_yc[ 6 * 256]; bucket2_yc[ 6 * 256] = bucket2_cy[ 6]; bucket2_cy[ 6] = tmp06;
+                sa_uint_t tmp07 = bucket2_yc[ 7 * 256]; bucket2_yc[ 7 * 256] = bucket2_cy[ 7]; bucket2_cy[ 7] = tmp07;
+                sa_uint_t tmp08 = bucket2_yc[ 8 * 256]; bucket2_yc[ 8 * 256] = bucket2_cy[ 8]; bucket2_cy[ 8] = tmp08;
+                sa_uint_t tmp09 = bucket2_yc[ 9 * 256]; bucket2_yc[ 9 * 256] = bucket2_cy[ 9]; bucket2_cy[ 9] = tmp09;
+                sa_uint_t tmp10 = bucket2_yc[10 * 256]; bucket2_yc[10 * 256] = bucket2_cy[10]; bucket2_cy[10] = tmp10;
+                sa_uint_t tmp11 = bucket2_yc[11 * 256]; bucket2_yc[11 * 256] = bucket2_cy[11]; bucket2_cy[11] = tmp11;
+                sa_uint_t tmp12 = bucket2_yc[12 * 256]; bucket2_yc[12 * 256] = bucket2_cy[12]; bucket2_cy[12] = tmp12;
+                sa_uint_t tmp13 = bucket2_yc[13 * 256]; bucket2_yc[13 * 256] = bucket2_cy[13]; bucket2_cy[13] = tmp13;
+                sa_uint_t tmp14 = bucket2_yc[14 * 256]; bucket2_yc[14 * 256] = bucket2_cy[14]; bucket2_cy[14] = tmp14;
+                sa_uint_t tmp15 = bucket2_yc[15 * 256]; bucket2_yc[15 * 256] = bucket2_cy[15]; bucket2_cy[15] = tmp15;
+            }
+        }
+    }
+}
+
+static void libsais64_unbwt_compute_bigram_histogram_single(const uint8_t * RESTRICT T, sa_uint_t * RESTRICT bucket1, sa_uint_t * RESTRICT bucket2, fast_uint_t index)
+{
+    fast_uint_t sum, c;
+    for (sum = 1, c = 0; c < ALPHABET_SIZE; ++c)
+    {
+        fast_uint_t prev = sum; sum += bucket1[c]; bucket1[c] = (sa_uint_t)prev;
+        if (prev != sum)
+        {
+            sa_uint_t * RESTRICT bucket2_p = &bucket2[c << 8];
+
+            {
+                fast_uint_t hi = index; if (sum < hi) { hi = sum; }
+                libsais64_unbwt_compute_histogram(&T[prev], (fast_sint_t)(hi - prev), bucket2_p);
+            }
+
+            {
+                fast_uint_t lo = index + 1; if (prev > lo) { lo = prev; }
+                libsais64_unbwt_compute_histogram(&T[lo - 1], (fast_sint_t)(sum - lo), bucket2_p);
+            }
+        }
+    }
+
+    libsais64_unbwt_transpose_bucket2(bucket2);
+}
+
+static void libsais64_unbwt_calculate_fastbits(sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t lastc, fast_uint_t shift)
+{
+    fast_uint_t v, w, sum, c, d;
+    for (v = 0, w = 0, sum = 1, c = 0; c < ALPHABET_SIZE; ++c)
+    {
+        if (c == lastc) { sum += 1; }
+
+        for (d = 0; d < ALPHABET_SIZE; ++d, ++w)
+        {
+            fast_uint_t prev = sum; sum += bucket2[w]; bucket2[w] = (sa_uint_t)prev;
+            if (prev != sum)
+            {
+                for (; v <= ((sum - 1) >> shift); ++v) { fastbits[v] = (uint16_t)w; }
+            }
+        }
+    }
+}
+
+static void libsais64_unbwt_calculate_biPSI(const uint8_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket1, sa_uint_t * RESTRICT bucket2, fast_uint_t index, fast_sint_t omp_block_start, fast_sint_t omp_block_end)
+{
+    {
+        fast_sint_t i = omp_block_start, j = (fast_sint_t)index; if (omp_block_end < j) { j = omp_block_end; }
+        for (; i < j; ++i)
+        {
+            fast_uint_t c = T[i];
+            fast_uint_t p = bucket1[c]++;
+            fast_sint_t t = (fast_sint_t)(index - p);
+
+            if (t != 0)
+            {
+                fast_uint_t w = (((fast_uint_t)T[p + (fast_uint_t)(t >> ((sizeof(fast_sint_t) * 8) - 1))]) << 8) + c;
+                P[bucket2[w]++] = (sa_uint_t)i;
+            }
+        }
+    }
+
+    {
+        fast_sint_t i = (fast_sint_t)index, j = omp_block_end; if (omp_block_start > i) { i = omp_block_start; }
+        for (i += 1; i <= j; ++i)
+        {
+            fast_uint_t c = T[i - 1];
+            fast_uint_t p = bucket1[c]++;
+            fast_sint_t t = (fast_sint_t)(index - p);
+
+            if (t != 0)
+            {
+                fast_uint_t w = (((fast_uint_t)T[p + (fast_uint_t)(t >> ((sizeof(fast_sint_t) * 8) - 1))]) << 8) + c;
+                P[bucket2[w]++] = (sa_uint_t)i;
+            }
+        }
+    }
+}
+
+static void libsais64_unbwt_init_single(const uint8_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift)
+{
+    sa_uint_t bucket1[ALPHABET_SIZE];
+
+    fast_uint_t index = I[0];
+    fast_uint_t lastc = T[0];
+
+    if (freq != NULL)
+    {
+        memcpy(bucket1, freq, ALPHABET_SIZE * sizeof(sa_uint_t));
+    }
+    else
+    {
+        memset(bucket1, 0, ALPHABET_SIZE * sizeof(sa_uint_t));
+        libsais64_unbwt_compute_histogram(T, n, bucket1);
+    }
+
+    memset(bucket2, 0, ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_uint_t));
+    libsais64_unbwt_compute_bigram_histogram_single(T, bucket1, bucket2, index);
+
+    libsais64_unbwt_calculate_fastbits(bucket2, fastbits, lastc, shift);
+    libsais64_unbwt_calculate_biPSI(T, P, bucket1, bucket2, index, 0, n);
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+static void libsais64_unbwt_compute_bigram_histogram_parallel(const uint8_t * RESTRICT T, fast_uint_t index, sa_uint_t * RESTRICT bucket1, sa_uint_t * RESTRICT bucket2, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i;
+    for (i = omp_block_start; i < omp_block_start + omp_block_size; ++i)
+    {
+        fast_uint_t c = T[i];
+        fast_uint_t p = bucket1[c]++;
+        fast_sint_t t = (fast_sint_t)(index - p);
+
+        if (t != 0)
+        {
+            fast_uint_t w = (((fast_uint_t)T[p + (fast_uint_t)(t >> ((sizeof(fast_sint_t) * 8) - 1))]) << 8) + c;
+            bucket2[w]++;
+        }
+    }
+}
+
+static void libsais64_unbwt_init_parallel_histogram(const uint8_t * RESTRICT T, sa_sint_t n, sa_uint_t * RESTRICT buckets, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    sa_uint_t * RESTRICT bucket1_local  = buckets + omp_thread_num * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE));
+
+    fast_sint_t omp_block_stride        = (n / omp_num_threads) & (-16);
+    fast_sint_t omp_block_start         = omp_thread_num * omp_block_stride;
+    fast_sint_t omp_block_size          = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+    memset(bucket1_local, 0, ALPHABET_SIZE * sizeof(sa_uint_t));
+    libsais64_unbwt_compute_histogram(T + omp_block_start, omp_block_size, bucket1_local);
+}
+
+static void libsais64_unbwt_init_parallel_bucket1(sa_uint_t * RESTRICT bucket1, sa_uint_t * RESTRICT buckets, fast_sint_t omp_num_threads)
+{
+    {
+        sa_uint_t * RESTRICT bucket1_temp = buckets;
+
+        fast_sint_t t;
+        for (t = 0; t < omp_num_threads; ++t, bucket1_temp += ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE))
+        {
+            fast_sint_t c; for (c = 0; c < ALPHABET_SIZE; c += 1) { sa_uint_t A = bucket1[c], B = bucket1_temp[c]; bucket1[c] = A + B; bucket1_temp[c] = A; }
+        }
+    }
+
+    {
+        fast_uint_t sum, c;
+        for (sum = 1, c = 0; c < ALPHABET_SIZE; ++c) { fast_uint_t prev = sum; sum += bucket1[c]; bucket1[c] = (sa_uint_t)prev; }
+    }
+}
+
+static void libsais64_unbwt_init_parallel_bigram_histogram(const uint8_t * RESTRICT T, sa_sint_t n, fast_uint_t index, const sa_uint_t * RESTRICT bucket1, sa_uint_t * RESTRICT buckets, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    sa_uint_t * RESTRICT bucket1_local  = buckets + omp_thread_num * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE));
+    sa_uint_t * RESTRICT bucket2_local  = bucket1_local + ALPHABET_SIZE;
+
+    fast_sint_t omp_block_stride        = (n / omp_num_threads) & (-16);
+    fast_sint_t omp_block_start         = omp_thread_num * omp_block_stride;
+    fast_sint_t omp_block_size          = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+    fast_sint_t c; for (c = 0; c < ALPHABET_SIZE; c += 1) { sa_uint_t A = bucket1[c], B = bucket1_local[c]; bucket1_local[c] = A + B; }
+
+    memset(bucket2_local, 0, ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_uint_t));
+    libsais64_unbwt_compute_bigram_histogram_parallel(T, index, bucket1_local, bucket2_local, omp_block_start, omp_block_size);
+}
+
+static void libsais64_unbwt_init_parallel_bucket2(sa_uint_t * RESTRICT bucket2, sa_uint_t * RESTRICT buckets, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    fast_sint_t omp_bucket2_stride  = ((ALPHABET_SIZE * ALPHABET_SIZE) / omp_num_threads) & (-16);
+    fast_sint_t omp_bucket2_start   = omp_thread_num * omp_bucket2_stride;
+    fast_sint_t omp_bucket2_size    = omp_thread_num < omp_num_threads - 1 ? omp_bucket2_stride : (ALPHABET_SIZE * ALPHABET_SIZE) - omp_bucket2_start;
+
+    sa_uint_t * RESTRICT bucket2_temp = buckets + ALPHABET_SIZE;
+
+    fast_sint_t t;
+    for (t = 0; t < omp_num_threads; ++t, bucket2_temp += ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE))
+    {
+        fast_sint_t c; for (c = omp_bucket2_start; c < omp_bucket2_start + omp_bucket2_size; c += 1) { sa_uint_t A = bucket2[c], B = bucket2_temp[c]; bucket2[c] = A + B; bucket2_temp[c] = A; }
+    }
+}
+
+static void libsais64_unbwt_init_parallel_fastbits(const sa_uint_t * RESTRICT bucket1, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, sa_uint_t * RESTRICT buckets, fast_uint_t lastc, fast_uint_t shift, fast_sint_t omp_num_threads)
+{
+    libsais64_unbwt_calculate_fastbits(bucket2, fastbits, lastc, shift);
+
+    {
+        fast_sint_t t;
+        for (t = omp_num_threads - 1; t >= 1; --t) 
+        { 
+            sa_uint_t * RESTRICT dst_bucket1 = buckets + t * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE));
+            sa_uint_t * RESTRICT src_bucket1 = dst_bucket1 - (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE));
+
+            memcpy(dst_bucket1, src_bucket1, ALPHABET_SIZE * sizeof(sa_uint_t));
+        }
+
+        memcpy(buckets, bucket1, ALPHABET_SIZE * sizeof(sa_uint_t));
+    }
+}
+
+static void libsais64_unbwt_init_parallel_biPSI(const uint8_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_sint_t n, fast_uint_t index, const sa_uint_t * RESTRICT bucket2, sa_uint_t * RESTRICT buckets, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    sa_uint_t * RESTRICT bucket1_local  = buckets + omp_thread_num * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE));
+    sa_uint_t * RESTRICT bucket2_local  = bucket1_local + ALPHABET_SIZE;
+
+    fast_sint_t omp_block_stride        = (n / omp_num_threads) & (-16);
+    fast_sint_t omp_block_start         = omp_thread_num * omp_block_stride;
+    fast_sint_t omp_block_size          = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+    fast_sint_t c; for (c = 0; c < ALPHABET_SIZE * ALPHABET_SIZE; c += 1) { sa_uint_t A = bucket2[c], B = bucket2_local[c]; bucket2_local[c] = A + B; }
+
+    libsais64_unbwt_calculate_biPSI(T, P, bucket1_local, bucket2_local, index, omp_block_start, omp_block_start + omp_block_size);
+}
+
+static void libsais64_unbwt_init_parallel(const uint8_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, sa_uint_t * RESTRICT buckets, sa_sint_t threads)
+{
+    sa_uint_t bucket1[ALPHABET_SIZE];
+
+    fast_uint_t index = I[0];
+    fast_uint_t lastc = T[0];
+
+    memset(bucket1, 0, ALPHABET_SIZE * sizeof(sa_uint_t));
+    memset(bucket2, 0, ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_uint_t));
+
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+    {
+        fast_sint_t omp_thread_num  = omp_get_thread_num();
+        fast_sint_t omp_num_threads = omp_get_num_threads();
+
+        if (omp_num_threads == 1)
+        {
+            libsais64_unbwt_init_single(T, P, n, freq, I, bucket2, fastbits, shift);
+        }
+        else
+        {
+            libsais64_unbwt_init_parallel_histogram(T, n, buckets, omp_thread_num, omp_num_threads);
+
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                libsais64_unbwt_init_parallel_bucket1(bucket1, buckets, omp_num_threads);
+            }
+
+            #pragma omp barrier
+
+            libsais64_unbwt_init_parallel_bigram_histogram(T, n, index, bucket1, buckets, omp_thread_num, omp_num_threads);
+
+            #pragma omp barrier
+
+            libsais64_unbwt_init_parallel_bucket2(bucket2, buckets, omp_thread_num, omp_num_threads);
+
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                libsais64_unbwt_init_parallel_fastbits(bucket1, bucket2, fastbits, buckets, lastc, shift, omp_num_threads);
+            }
+
+            #pragma omp barrier
+
+            libsais64_unbwt_init_parallel_biPSI(T, P, n, index, bucket2, buckets, omp_thread_num, omp_num_threads);
+
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                memcpy(bucket2, buckets + ALPHABET_SIZE + (omp_num_threads - 1) * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE)), ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_uint_t));
+            }
+        }
+    }
+}
+
+#endif
+
+static void libsais64_unbwt_decode_1(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t * i0, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
+
+    fast_uint_t i, p0 = *i0;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais64_bswap16(c0);
+    }
+
+    *i0 = p0;
+}
+
+static void libsais64_unbwt_decode_2(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
+    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
+
+    fast_uint_t i, p0 = *i0, p1 = *i1;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais64_bswap16(c0);
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais64_bswap16(c1);
+    }
+
+    *i0 = p0; *i1 = p1;
+}
+
+static void libsais64_unbwt_decode_3(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
+    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
+    uint16_t * RESTRICT U2 = (uint16_t *)(void *)(((uint8_t *)U1) + r);
+
+    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais64_bswap16(c0);
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais64_bswap16(c1);
+        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = libsais64_bswap16(c2);
+    }
+
+    *i0 = p0; *i1 = p1; *i2 = p2;
+}
+
+static void libsais64_unbwt_decode_4(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
+    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
+    uint16_t * RESTRICT U2 = (uint16_t *)(void *)(((uint8_t *)U1) + r);
+    uint16_t * RESTRICT U3 = (uint16_t *)(void *)(((uint8_t *)U2) + r);
+
+    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais64_bswap16(c0);
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais64_bswap16(c1);
+        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = libsais64_bswap16(c2);
+        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = libsais64_bswap16(c3);
+    }
+
+    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3;
+}
+
+static void libsais64_unbwt_decode_5(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
+    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
+    uint16_t * RESTRICT U2 = (uint16_t *)(void *)(((uint8_t *)U1) + r);
+    uint16_t * RESTRICT U3 = (uint16_t *)(void *)(((uint8_t *)U2) + r);
+    uint16_t * RESTRICT U4 = (uint16_t *)(void *)(((uint8_t *)U3) + r);
+
+    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais64_bswap16(c0);
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais64_bswap16(c1);
+        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = libsais64_bswap16(c2);
+        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = libsais64_bswap16(c3);
+        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = libsais64_bswap16(c4);
+    }
+
+    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4;
+}
+
+static void libsais64_unbwt_decode_6(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t * i5, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
+    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
+    uint16_t * RESTRICT U2 = (uint16_t *)(void *)(((uint8_t *)U1) + r);
+    uint16_t * RESTRICT U3 = (uint16_t *)(void *)(((uint8_t *)U2) + r);
+    uint16_t * RESTRICT U4 = (uint16_t *)(void *)(((uint8_t *)U3) + r);
+    uint16_t * RESTRICT U5 = (uint16_t *)(void *)(((uint8_t *)U4) + r);
+
+    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4, p5 = *i5;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais64_bswap16(c0);
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais64_bswap16(c1);
+        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = libsais64_bswap16(c2);
+        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = libsais64_bswap16(c3);
+        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = libsais64_bswap16(c4);
+        uint16_t c5 = fastbits[p5 >> shift]; if (bucket2[c5] <= p5) { do { c5++; } while (bucket2[c5] <= p5); } p5 = P[p5]; U5[i] = libsais64_bswap16(c5);
+    }
+
+    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4; *i5 = p5;
+}
+
+static void libsais64_unbwt_decode_7(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t * i5, fast_uint_t * i6, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
+    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
+    uint16_t * RESTRICT U2 = (uint16_t *)(void *)(((uint8_t *)U1) + r);
+    uint16_t * RESTRICT U3 = (uint16_t *)(void *)(((uint8_t *)U2) + r);
+    uint16_t * RESTRICT U4 = (uint16_t *)(void *)(((uint8_t *)U3) + r);
+    uint16_t * RESTRICT U5 = (uint16_t *)(void *)(((uint8_t *)U4) + r);
+    uint16_t * RESTRICT U6 = (uint16_t *)(void *)(((uint8_t *)U5) + r);
+
+    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4, p5 = *i5, p6 = *i6;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais64_bswap16(c0);
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais64_bswap16(c1);
+        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = libsais64_bswap16(c2);
+        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = libsais64_bswap16(c3);
+        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = libsais64_bswap16(c4);
+        uint16_t c5 = fastbits[p5 >> shift]; if (bucket2[c5] <= p5) { do { c5++; } while (bucket2[c5] <= p5); } p5 = P[p5]; U5[i] = libsais64_bswap16(c5);
+        uint16_t c6 = fastbits[p6 >> shift]; if (bucket2[c6] <= p6) { do { c6++; } while (bucket2[c6] <= p6); } p6 = P[p6]; U6[i] = libsais64_bswap16(c6);
+    }
+
+    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4; *i5 = p5; *i6 = p6;
+}
+
+static void libsais64_unbwt_decode_8(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t * i5, fast_uint_t * i6, fast_uint_t * i7, fast_uint_t k)
+{
+    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
+    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
+    uint16_t * RESTRICT U2 = (uint16_t *)(void *)(((uint8_t *)U1) + r);
+    uint16_t * RESTRICT U3 = (uint16_t *)(void *)(((uint8_t *)U2) + r);
+    uint16_t * RESTRICT U4 = (uint16_t *)(void *)(((uint8_t *)U3) + r);
+    uint16_t * RESTRICT U5 = (uint16_t *)(void *)(((uint8_t *)U4) + r);
+    uint16_t * RESTRICT U6 = (uint16_t *)(void *)(((uint8_t *)U5) + r);
+    uint16_t * RESTRICT U7 = (uint16_t *)(void *)(((uint8_t *)U6) + r);
+
+    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4, p5 = *i5, p6 = *i6, p7 = *i7;
+
+    for (i = 0; i != k; ++i)
+    {
+        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais64_bswap16(c0);
+        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais64_bswap16(c1);
+        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = libsais64_bswap16(c2);
+        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = libsais64_bswap16(c3);
+        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = libsais64_bswap16(c4);
+        uint16_t c5 = fastbits[p5 >> shift]; if (bucket2[c5] <= p5) { do { c5++; } while (bucket2[c5] <= p5); } p5 = P[p5]; U5[i] = libsais64_bswap16(c5);
+        uint16_t c6 = fastbits[p6 >> shift]; if (bucket2[c6] <= p6) { do { c6++; } while (bucket2[c6] <= p6); } p6 = P[p6]; U6[i] = libsais64_bswap16(c6);
+        uint16_t c7 = fastbits[p7 >> shift]; if (bucket2[c7] <= p7) { do { c7++; } while (bucket2[c7] <= p7); } p7 = P[p7]; U7[i] = libsais64_bswap16(c7);
+    }
+
+    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4; *i5 = p5; *i6 = p6; *i7 = p7;
+}
+
+static void libsais64_unbwt_decode(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_sint_t blocks, fast_uint_t remainder)
+{
+    fast_uint_t offset      = 0;
+
+    while (blocks > 8)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5], i6 = I[6], i7 = I[7];
+        libsais64_unbwt_decode_8(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, &i7, (fast_uint_t)r >> 1);
+        I += 8; blocks -= 8; offset += 8 * (fast_uint_t)r;
+    }
+
+    if (blocks == 1)
+    {
+        fast_uint_t i0 = I[0];
+        libsais64_unbwt_decode_1(U + offset, P, bucket2, fastbits, shift, &i0, remainder >> 1);
+    }
+    else if (blocks == 2)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1];
+        libsais64_unbwt_decode_2(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, remainder >> 1);
+        libsais64_unbwt_decode_1(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, &i0, ((fast_uint_t)r >> 1) - (remainder >> 1));
+    }
+    else if (blocks == 3)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2];
+        libsais64_unbwt_decode_3(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, remainder >> 1);
+        libsais64_unbwt_decode_2(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, ((fast_uint_t)r >> 1) - (remainder >> 1));
+    }
+    else if (blocks == 4)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3];
+        libsais64_unbwt_decode_4(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, remainder >> 1);
+        libsais64_unbwt_decode_3(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, ((fast_uint_t)r >> 1) - (remainder >> 1));
+    }
+    else if (blocks == 5)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4];
+        libsais64_unbwt_decode_5(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, remainder >> 1);
+        libsais64_unbwt_decode_4(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, ((fast_uint_t)r >> 1) - (remainder >> 1));
+    }
+    else if (blocks == 6)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5];
+        libsais64_unbwt_decode_6(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, remainder >> 1);
+        libsais64_unbwt_decode_5(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, ((fast_uint_t)r >> 1) - (remainder >> 1));
+    }
+    else if (blocks == 7)
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5], i6 = I[6];
+        libsais64_unbwt_decode_7(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, remainder >> 1);
+        libsais64_unbwt_decode_6(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, ((fast_uint_t)r >> 1) - (remainder >> 1));
+    }
+    else
+    {
+        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5], i6 = I[6], i7 = I[7];
+        libsais64_unbwt_decode_8(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, &i7, remainder >> 1);
+        libsais64_unbwt_decode_7(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, ((fast_uint_t)r >> 1) - (remainder >> 1));
+    }
+}
+
+static void libsais64_unbwt_decode_parallel(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_sint_t blocks, fast_uint_t remainder, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    fast_sint_t omp_block_stride    = blocks / omp_num_threads;
+    fast_sint_t omp_block_remainder = blocks % omp_num_threads;
+    fast_sint_t omp_block_size      = omp_block_stride + (omp_thread_num < omp_block_remainder);
+    fast_sint_t omp_block_start     = omp_block_stride * omp_thread_num + (omp_thread_num < omp_block_remainder ? omp_thread_num : omp_block_remainder);
+
+    libsais64_unbwt_decode(U + r * omp_block_start, P, r, I + omp_block_start, bucket2, fastbits, shift, omp_block_size, omp_thread_num < omp_num_threads - 1 ? (fast_uint_t)r : remainder);
+}
+
+static void libsais64_unbwt_decode_omp(const uint8_t * RESTRICT T, uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, sa_sint_t threads)
+{
+    fast_uint_t lastc       = T[0];
+    fast_sint_t blocks      = 1 + (((fast_sint_t)n - 1) / (fast_sint_t)r);
+    fast_uint_t remainder   = (fast_uint_t)n - ((fast_uint_t)r * ((fast_uint_t)blocks - 1));
+
+#if defined(LIBSAIS_OPENMP)
+    fast_sint_t max_threads = blocks < threads ? blocks : threads;
+    #pragma omp parallel num_threads(max_threads) if(max_threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num      = omp_get_thread_num();
+        fast_sint_t omp_num_threads     = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num      = 0;
+        fast_sint_t omp_num_threads     = 1;
+#endif
+
+        libsais64_unbwt_decode_parallel(U, P, r, I, bucket2, fastbits, shift, blocks, remainder, omp_thread_num, omp_num_threads);
+    }
+
+    U[n - 1] = (uint8_t)lastc;
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+static void libsais64_unbwt_mark_splitters(sa_uint_t * RESTRICT P, fast_uint_t index, fast_uint_t step, fast_sint_t splitters, sa_uint_t mark)
+{
+    fast_sint_t k;
+    for (k = 0; k <= splitters; ++k)
+    {
+        fast_uint_t q = k < splitters ? (fast_uint_t)k * step : index;
+        if (P[q] != (sa_uint_t)-1) { P[q] = (P[q] & (sa_uint_t)SAINT_MAX) | mark; }
+    }
+}
+
+static void libsais64_unbwt_walk_splitters(const sa_uint_t * RESTRICT P, fast_uint_t index, fast_uint_t step, fast_sint_t splitters, sa_uint_t * RESTRICT buckets, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    sa_uint_t * RESTRICT next   = buckets;
+    sa_uint_t * RESTRICT length = buckets + splitters + 1;
+
+    fast_sint_t omp_block_stride    = (splitters + 1) / omp_num_threads;
+    fast_sint_t omp_block_remainder = (splitters + 1) % omp_num_threads;
+    fast_sint_t omp_block_size      = omp_block_stride + (omp_thread_num < omp_block_remainder);
+    fast_sint_t omp_block_start     = omp_block_stride * omp_thread_num + (omp_thread_num < omp_block_remainder ? omp_thread_num : omp_block_remainder);
+
+    fast_sint_t k;
+    for (k = omp_block_start; k < omp_block_start + omp_block_size; ++k)
+    {
+        fast_uint_t q = k < splitters ? (fast_uint_t)k * step : index;
+        fast_uint_t s = 0;
+
+        if (k < splitters && q == index) { next[k] = (sa_uint_t)-1; length[k] = 0; continue; }
+
+        for (;;)
+        {
+            sa_uint_t p = P[q];
+
+            if (p == (sa_uint_t)-1) { next[k] = (sa_uint_t)-1; length[k] = (sa_uint_t)(s + 1); break; }
+            if (s > 0 && (p & (sa_uint_t)SAINT_MIN) != 0) { next[k] = (sa_uint_t)(q == index ? (fast_uint_t)splitters : q / step); length[k] = (sa_uint_t)s; break; }
+
+            q = p & (sa_uint_t)SAINT_MAX; s++;
+        }
+    }
+}
+
+static fast_sint_t libsais64_unbwt_rank_splitters(fast_uint_t index, fast_uint_t step, fast_sint_t splitters, fast_uint_t steps, sa_uint_t * RESTRICT buckets)
+{
+    const sa_uint_t * RESTRICT next     = buckets;
+    const sa_uint_t * RESTRICT length   = buckets + 1 * (splitters + 1);
+    sa_uint_t *       RESTRICT rows     = buckets + 2 * (splitters + 1);
+    sa_uint_t *       RESTRICT offsets  = buckets + 3 * (splitters + 1);
+    sa_uint_t *       RESTRICT lengths  = buckets + 4 * (splitters + 1);
+
+    fast_sint_t segments = 0; fast_uint_t offset = 0, k = (fast_uint_t)splitters;
+    while (offset < steps && segments <= splitters)
+    {
+        rows[segments]      = (sa_uint_t)(k < (fast_uint_t)splitters ? k * step : index);
+        offsets[segments]   = (sa_uint_t)offset;
+        lengths[segments]   = (sa_uint_t)(length[k] < steps - offset ? length[k] : steps - offset);
+
+        offset += length[k]; segments++; if (next[k] == (sa_uint_t)-1) { break; } k = next[k];
+    }
+
+    return segments;
+}
+
+static void libsais64_unbwt_decode_splitters(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_sint_t splitters, fast_sint_t segments, fast_uint_t steps, const sa_uint_t * RESTRICT buckets, fast_sint_t omp_thread_num, fast_sint_t omp_num_threads)
+{
+    const sa_uint_t * RESTRICT rows     = buckets + 2 * (splitters + 1);
+    const sa_uint_t * RESTRICT offsets  = buckets + 3 * (splitters + 1);
+    const sa_uint_t * RESTRICT lengths  = buckets + 4 * (splitters + 1);
+
+    fast_uint_t omp_block_stride    = steps / (fast_uint_t)omp_num_threads;
+    fast_uint_t omp_block_start     = omp_block_stride * (fast_uint_t)omp_thread_num;
+    fast_uint_t omp_block_end       = omp_thread_num < omp_num_threads - 1 ? omp_block_start + omp_block_stride : steps;
+
+    fast_sint_t l = 0, h = segments;
+    while (l < h) { fast_sint_t m = l + ((h - l) >> 1); if (offsets[m] < omp_block_start) { l = m + 1; } else { h = m; } }
+
+    for (; l < segments && offsets[l] < omp_block_end; ++l)
+    {
+        fast_uint_t i0 = rows[l];
+        libsais64_unbwt_decode_1(U + 2 * (fast_uint_t)offsets[l], P, bucket2, fastbits, shift, &i0, lengths[l]);
+    }
+}
+
+static sa_sint_t libsais64_unbwt_use_splitters(sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    sa_sint_t cores = (sa_sint_t)omp_get_num_procs(); threads = threads < cores ? threads : cores;
+#endif
+
+    return threads >= UNBWT_SPLITTERS_MIN_THREADS && n >= UNBWT_SPLITTERS_MIN_SIZE;
+}
+
+static fast_sint_t libsais64_unbwt_count_splitters(sa_sint_t n, sa_sint_t threads)
+{
+    fast_sint_t splitters = (fast_sint_t)threads * 1024;
+    return splitters < ((fast_sint_t)n + 1) / 16 ? splitters : ((fast_sint_t)n + 1) / 16;
+}
+
+static void libsais64_unbwt_decode_splitters_omp(const uint8_t * RESTRICT T, uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, fast_uint_t index, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, sa_uint_t * RESTRICT buckets, sa_sint_t threads)
+{
+    fast_uint_t lastc       = T[0];
+    fast_sint_t splitters   = libsais64_unbwt_count_splitters(n, threads);
+    fast_uint_t step        = ((fast_uint_t)n + 1) / (fast_uint_t)splitters;
+    fast_uint_t steps       = (fast_uint_t)n >> 1;
+    fast_sint_t segments    = 0;
+
+    libsais64_unbwt_mark_splitters(P, index, step, splitters, (sa_uint_t)SAINT_MIN);
+
+    #pragma omp parallel num_threads(threads) if(threads > 1)
+    {
+        fast_sint_t omp_thread_num      = omp_get_thread_num();
+        fast_sint_t omp_num_threads     = omp_get_num_threads();
+
+        libsais64_unbwt_walk_splitters(P, index, step, splitters, buckets, omp_thread_num, omp_num_threads);
+
+        #pragma omp barrier
+
+        #pragma omp master
+        {
+            libsais64_unbwt_mark_splitters(P, index, step, splitters, 0);
+            segments = libsais64_unbwt_rank_splitters(index, step, splitters, steps, buckets);
+        }
+
+        #pragma omp barrier
+
+        libsais64_unbwt_decode_splitters(U, P, bucket2, fastbits, shift, splitters, segments, steps, buckets, omp_thread_num, omp_num_threads);
+    }
+
+    U[n - 1] = (uint8_t)lastc;
+}
+
+#endif
+
+static sa_sint_t libsais64_unbwt_decode_range(uint8_t * RESTRICT U, const sa_uint_t * RESTRICT P, sa_sint_t n, sa_sint_t r, const sa_uint_t * RESTRICT I, const sa_uint_t * RESTRICT bucket2, const uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t lastc, fast_uint_t start, fast_uint_t len)
+{
+    fast_uint_t end     = start + len;
+
+    if (end == (fast_uint_t)n) { U[len - 1] = (uint8_t)lastc; end--; }
+
+    fast_uint_t i = start;
+    while (i < end)
+    {
+        fast_uint_t b = i / (fast_uint_t)r, block_end = (b + 1) * (fast_uint_t)r < end ? (b + 1) * (fast_uint_t)r : end;
+        fast_uint_t j = b * (fast_uint_t)r, p = I[b]; if (p > (fast_uint_t)n) { return -1; }
+
+        for (; j + 2 <= i; j += 2) { p = P[p]; if (p > (fast_uint_t)n) { return -1; } }
+
+        for (; j < block_end; j += 2)
+        {
+            uint16_t c = fastbits[p >> shift]; if (bucket2[c] <= p) { do { c++; } while (bucket2[c] <= p); } p = P[p]; if (p > (fast_uint_t)n) { return -1; }
+
+            if (j >= i)             { U[j - start]      = (uint8_t)(c >> 8); }
+            if (j + 1 < block_end)  { U[j + 1 - start]  = (uint8_t)c; }
+        }
+
+        i = block_end;
+    }
+
+    return 0;
+}
+
+static sa_sint_t libsais64_unbwt_range_core(const uint8_t * RESTRICT T, uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_sint_t start, sa_sint_t len, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, sa_uint_t * RESTRICT buckets, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    if (threads > 1 && n >= 262144)
+    {
+        libsais64_unbwt_init_parallel(T, P, n, freq, I, bucket2, fastbits, shift, buckets, threads);
+    }
+    else
+#else
+    UNUSED(buckets); UNUSED(threads);
+#endif
+    {
+        libsais64_unbwt_init_single(T, P, n, freq, I, bucket2, fastbits, shift);
+    }
+
+    libsais64_unbwt_decode_range(U, P, n, r, I, bucket2, fastbits, shift, T[0], (fast_uint_t)start, (fast_uint_t)len);
+    return 0;
+}
+
+static sa_sint_t libsais64_unbwt_core(const uint8_t * RESTRICT T, uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_sint_t start, sa_sint_t len, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, sa_uint_t * RESTRICT buckets, sa_sint_t threads)
+{
+    if (len < n)
+    {
+        return libsais64_unbwt_range_core(T, U, P, n, freq, r, I, start, len, bucket2, fastbits, shift, buckets, threads);
+    }
+
+#if defined(LIBSAIS_OPENMP)
+    if (threads > 1 && n >= 262144)
+    {
+        if (r >= n && libsais64_unbwt_use_splitters(n, threads)) { memset(P, 0xff, ((size_t)n + 1) * sizeof(sa_uint_t)); }
+
+        libsais64_unbwt_init_parallel(T, P, n, freq, I, bucket2, fastbits, shift, buckets, threads);
+
+        if (r >= n && libsais64_unbwt_use_splitters(n, threads)) { libsais64_unbwt_decode_splitters_omp(T, U, P, n, I[0], bucket2, fastbits, shift, buckets, threads); return 0; }
+    }
+    else
+#else
+    UNUSED(buckets);
+#endif
+    {
+        libsais64_unbwt_init_single(T, P, n, freq, I, bucket2, fastbits, shift);
+    }
+
+    libsais64_unbwt_decode_omp(T, U, P, n, r, I, bucket2, fastbits, shift, threads);
+    return 0;
+}
+
+static sa_sint_t libsais64_unbwt_main(const uint8_t * T, uint8_t * U, sa_uint_t * P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * I, sa_sint_t start, sa_sint_t len, sa_sint_t threads)
+{
+    fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+
+    sa_uint_t *     RESTRICT bucket2        = (sa_uint_t *)libsais64_alloc_aligned(ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_uint_t), 4096);
+    uint16_t *      RESTRICT fastbits       = (uint16_t *)libsais64_alloc_aligned(((size_t)1 + (size_t)(n >> shift)) * sizeof(uint16_t), 4096);
+    sa_uint_t *     RESTRICT buckets        = threads > 1 && n >= 262144 ? (sa_uint_t *)libsais64_alloc_aligned((size_t)threads * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE)) * sizeof(sa_uint_t), 4096) : NULL;
+
+    sa_sint_t index = bucket2 != NULL && fastbits != NULL && (buckets != NULL || threads == 1 || n < 262144)
+        ? libsais64_unbwt_core(T, U, P, n, freq, r, I, start, len, bucket2, fastbits, shift, buckets, threads)
+        : -2;
+
+    libsais64_free_aligned(buckets);
+    libsais64_free_aligned(fastbits);
+    libsais64_free_aligned(bucket2);
+
+    return index;
+}
+
+static sa_sint_t libsais64_unbwt_main_ctx(const LIBSAIS_UNBWT_CONTEXT * ctx, const uint8_t * T, uint8_t * U, sa_uint_t * P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * I, sa_sint_t start, sa_sint_t len)
+{
+    if (ctx != NULL && ctx->bucket2 != NULL && ctx->fastbits != NULL && (ctx->buckets != NULL || ctx->threads == 1))
+    {
+        fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << ctx->fastbits_log)) { shift++; }
+        return libsais64_unbwt_core(T, U, P, n, freq, r, I, start, len, ctx->bucket2, ctx->fastbits, shift, ctx->buckets, (sa_sint_t)ctx->threads);
+    }
+
+    return -2;
+}
+
+void * libsais64_unbwt_create_ctx(void)
+{
+    return (void *)libsais64_unbwt_create_ctx_main(1, NULL);
+}
+
+void * libsais64_unbwt_create_ctx_alloc(void * (* alloc_fn)(size_t size, size_t alignment, void * opaque), void (* free_fn)(void * address, void * opaque), void * opaque)
+{
+    if ((alloc_fn == NULL) || (free_fn == NULL)) { return NULL; }
+
+    LIBSAIS_ALLOCATOR allocator = { alloc_fn, free_fn, opaque };
+    return (void *)libsais64_unbwt_create_ctx_main(1, &allocator);
+}
+
+void libsais64_unbwt_free_ctx(void * ctx)
+{
+    libsais64_unbwt_free_ctx_main((LIBSAIS_UNBWT_CONTEXT *)ctx);
+}
+
+int32_t libsais64_unbwt_set_fastbits(void * ctx, int32_t bits)
+{
+    if ((ctx == NULL) || (bits < UNBWT_FASTBITS_MIN) || (bits > UNBWT_FASTBITS_MAX))
+    {
+        return -1;
+    }
+
+    LIBSAIS_UNBWT_CONTEXT * RESTRICT context = (LIBSAIS_UNBWT_CONTEXT *)ctx;
+
+    sa_sint_t status = libsais_unbwt_set_fastbits(context->ctx32, bits);
+    if (status != 0)
+    {
+        return status;
+    }
+
+    uint16_t * RESTRICT fastbits = (uint16_t *)libsais64_alloc_memory(&context->allocator, ((size_t)1 + ((size_t)1 << bits)) * sizeof(uint16_t), 4096);
+    if (fastbits == NULL)
+    {
+        return -2;
+    }
+
+    libsais64_free_memory(&context->allocator, context->fastbits);
+
+    context->fastbits       = fastbits;
+    context->fastbits_log   = bits;
+
+    return 0;
+}
+
+int64_t libsais64_unbwt_alloc_size(int64_t threads)
+{
+    if (threads < 0)
+    {
+        return -1;
+    }
+
+#if defined(LIBSAIS_OPENMP)
+    threads = threads > 0 ? threads : omp_get_max_threads();
+#else
+    threads = 1;
+#endif
+
+    return libsais64_unbwt_alloc_size_main(threads);
+}
+
+int64_t libsais64_unbwt_recommend_r(int64_t n, int64_t threads)
+{
+    if ((n < 0) || (threads < 0))
+    {
+        return -1;
+    }
+
+#if defined(LIBSAIS_OPENMP)
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    threads = threads < omp_get_num_procs() ? threads : omp_get_num_procs();
+#else
+    threads = threads > 0 ? threads : 1;
+#endif
+
+    if (threads == 1) { return n; }
+
+    fast_sint_t r = 2; while (r <= (fast_sint_t)n / ((fast_sint_t)threads * 16)) { r <<= 1; }
+    return (int64_t)r;
+}
+
+int64_t libsais64_unbwt(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t i)
+{
+    return libsais64_unbwt_aux(T, U, A, n, freq, n, &i);
+}
+
+int64_t libsais64_unbwt_ctx(const void * ctx, const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t i)
+{
+    return libsais64_unbwt_aux_ctx(ctx, T, U, A, n, freq, n, &i);
+}
+
+int64_t libsais64_unbwt_aux(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t r, const int64_t * I)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+        if (n == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+
+    if (n <= INT32_MAX && r <= INT32_MAX && (n - 1) / r < 1024)
+    {
+        int32_t indexes[1024]; for (t = 0; t <= (n - 1) / r; ++t) { indexes[t] = (int32_t)I[t]; }
+        int32_t frequencies[ALPHABET_SIZE]; if (freq != NULL) { for (t = 0; t < ALPHABET_SIZE; ++t) { frequencies[t] = (int32_t)freq[t]; } }
+
+        return libsais_unbwt_aux(T, U, (int32_t *)A, (int32_t)n, freq != NULL ? frequencies : NULL, (int32_t)r, indexes);
+    }
+
+    return libsais64_unbwt_main(T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, 0, n, 1);
+}
+
+int64_t libsais64_unbwt_range(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t r, const int64_t * I, int64_t start, int64_t len)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (start < 0) || (len < 0) || (start > n - len))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+        if (len == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+
+    if (len == 0) { return 0; }
+
+    if (n <= INT32_MAX && r <= INT32_MAX && (n - 1) / r < 1024)
+    {
+        int32_t indexes[1024]; for (t = 0; t <= (n - 1) / r; ++t) { indexes[t] = (int32_t)I[t]; }
+        int32_t frequencies[ALPHABET_SIZE]; if (freq != NULL) { for (t = 0; t < ALPHABET_SIZE; ++t) { frequencies[t] = (int32_t)freq[t]; } }
+
+        return libsais_unbwt_range(T, U, (int32_t *)A, (int32_t)n, freq != NULL ? frequencies : NULL, (int32_t)r, indexes, (int32_t)start, (int32_t)len);
+    }
+
+    return libsais64_unbwt_main(T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, start, len, 1);
+}
+
+int64_t libsais64_unbwt_aux_ctx(const void * ctx, const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t r, const int64_t * I)
+{
+    if ((ctx == NULL) || (T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+        if (n == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+
+    const LIBSAIS_UNBWT_CONTEXT * RESTRICT context = (const LIBSAIS_UNBWT_CONTEXT *)ctx;
+
+    if (n <= INT32_MAX && r <= INT32_MAX && (n - 1) / r < 1024)
+    {
+        int32_t indexes[1024]; for (t = 0; t <= (n - 1) / r; ++t) { indexes[t] = (int32_t)I[t]; }
+        int32_t frequencies[ALPHABET_SIZE]; if (freq != NULL) { for (t = 0; t < ALPHABET_SIZE; ++t) { frequencies[t] = (int32_t)freq[t]; } }
+
+        return libsais_unbwt_aux_ctx(context->ctx32, T, U, (int32_t *)A, (int32_t)n, freq != NULL ? frequencies : NULL, (int32_t)r, indexes);
+    }
+
+    return libsais64_unbwt_main_ctx(context, T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, 0, n);
+}
+
+int64_t libsais64_unbwt_range_ctx(const void * ctx, const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t r, const int64_t * I, int64_t start, int64_t len)
+{
+    if ((ctx == NULL) || (T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (start < 0) || (len < 0) || (start > n - len))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+        if (len == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+
+    if (len == 0) { return 0; }
+
+    const LIBSAIS_UNBWT_CONTEXT * RESTRICT context = (const LIBSAIS_UNBWT_CONTEXT *)ctx;
+
+    if (n <= INT32_MAX && r <= INT32_MAX && (n - 1) / r < 1024)
+    {
+        int32_t indexes[1024]; for (t = 0; t <= (n - 1) / r; ++t) { indexes[t] = (int32_t)I[t]; }
+        int32_t frequencies[ALPHABET_SIZE]; if (freq != NULL) { for (t = 0; t < ALPHABET_SIZE; ++t) { frequencies[t] = (int32_t)freq[t]; } }
+
+        return libsais_unbwt_range_ctx(context->ctx32, T, U, (int32_t *)A, (int32_t)n, freq != NULL ? frequencies : NULL, (int32_t)r, indexes, (int32_t)start, (int32_t)len);
+    }
+
+    return libsais64_unbwt_main_ctx(context, T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, start, len);
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+void * libsais64_unbwt_create_ctx_omp(int64_t threads)
+{
+    if (threads < 0) { return NULL; }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return (void *)libsais64_unbwt_create_ctx_main(threads, NULL);
+}
+
+void * libsais64_unbwt_create_ctx_alloc_omp(int64_t threads, void * (* alloc_fn)(size_t size, size_t alignment, void * opaque), void (* free_fn)(void * address, void * opaque), void * opaque)
+{
+    if ((threads < 0) || (alloc_fn == NULL) || (free_fn == NULL)) { return NULL; }
+
+    LIBSAIS_ALLOCATOR allocator = { alloc_fn, free_fn, opaque };
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return (void *)libsais64_unbwt_create_ctx_main(threads, &allocator);
+}
+
+int64_t libsais64_unbwt_omp(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t i, int64_t threads)
+{
+    return libsais64_unbwt_aux_omp(T, U, A, n, freq, n, &i, threads);
+}
+
+int64_t libsais64_unbwt_aux_omp(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t r, const int64_t * I, int64_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+        if (n == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+
+    if (n <= INT32_MAX && r <= INT32_MAX && (n - 1) / r < 1024)
+    {
+        int32_t indexes[1024]; for (t = 0; t <= (n - 1) / r; ++t) { indexes[t] = (int32_t)I[t]; }
+        int32_t frequencies[ALPHABET_SIZE]; if (freq != NULL) { for (t = 0; t < ALPHABET_SIZE; ++t) { frequencies[t] = (int32_t)freq[t]; } }
+
+        return libsais_unbwt_aux_omp(T, U, (int32_t *)A, (int32_t)n, freq != NULL ? frequencies : NULL,(int32_t)r, indexes, (int32_t)threads);
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return libsais64_unbwt_main(T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, 0, n, threads);
+}
+
+int64_t libsais64_unbwt_range_omp(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t r, const int64_t * I, int64_t start, int64_t len, int64_t threads)
+{
+    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (start < 0) || (len < 0) || (start > n - len) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+        if (len == 1) { U[0] = T[0]; }
+        return 0;
+    }
+
+    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+
+    if (len == 0) { return 0; }
+
+    if (n <= INT32_MAX && r <= INT32_MAX && (n - 1) / r < 1024)
+    {
+        int32_t indexes[1024]; for (t = 0; t <= (n - 1) / r; ++t) { indexes[t] = (int32_t)I[t]; }
+        int32_t frequencies[ALPHABET_SIZE]; if (freq != NULL) { for (t = 0; t < ALPHABET_SIZE; ++t) { frequencies[t] = (int32_t)freq[t]; } }
+
+        return libsais_unbwt_range_omp(T, U, (int32_t *)A, (int32_t)n, freq != NULL ? frequencies : NULL,(int32_t)r, indexes, (int32_t)start, (int32_t)len, (int32_t)threads);
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return libsais64_unbwt_main(T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, start, len, threads);
+}
+
+#endif
+
+static int64_t libsais64_unbwt_index_layout(sa_sint_t n, sa_sint_t r, int64_t * RESTRICT offsets)
+{
+    fast_uint_t shift   = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+    int64_t     samples = n > 1 ? (int64_t)1 + (int64_t)((n - 1) / r) : 1;
+
+    offsets[0] = (int64_t)sizeof(LIBSAIS_UNBWT_INDEX);
+    offsets[1] = offsets[0] + (int64_t)(ALPHABET_SIZE * ALPHABET_SIZE) * (int64_t)sizeof(sa_uint_t);
+    offsets[2] = offsets[1] + ((((int64_t)1 + (int64_t)(n >> shift)) * (int64_t)sizeof(uint16_t) + 63) & (-64));
+    offsets[3] = offsets[2] + ((samples * (int64_t)sizeof(sa_uint_t) + 63) & (-64));
+
+    return offsets[3] + ((int64_t)n + 1) * (int64_t)sizeof(sa_uint_t);
+}
+
+static sa_sint_t libsais64_unbwt_index_validate(const void * index, size_t size)
+{
+    const LIBSAIS_UNBWT_INDEX * RESTRICT header = (const LIBSAIS_UNBWT_INDEX *)index;
+
+    if ((index == NULL) || (((size_t)index & 7) != 0) || (size < sizeof(LIBSAIS_UNBWT_INDEX)) || (header->magic != LIBSAIS_UNBWT_INDEX_MAGIC))
+    {
+        return -1;
+    }
+
+    int64_t n = header->n, r = header->r;
+    if ((n < 0) || ((int64_t)(sa_sint_t)n != n) || ((r != n) && ((r < 2) || ((int64_t)(sa_sint_t)r != r) || ((r & (r - 1)) != 0))))
+    {
+        return -1;
+    }
+
+    int64_t offsets[4];
+    if ((uint64_t)libsais64_unbwt_index_layout((sa_sint_t)n, (sa_sint_t)r, offsets) > (uint64_t)size)
+    {
+        return -1;
+    }
+
+    if ((n > 1) && (((const sa_uint_t *)(const void *)((const uint8_t *)index + offsets[0]))[ALPHABET_SIZE * ALPHABET_SIZE - 1] <= (sa_uint_t)n))
+    {
+        return -1;
+    }
+
+    if ((header->lastc < 0) || (header->lastc >= ALPHABET_SIZE))
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+static sa_sint_t libsais64_unbwt_index_build_main(const uint8_t * T, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * I, void * index, size_t size, sa_sint_t threads)
+{
+    int64_t offsets[4];
+    if ((uint64_t)libsais64_unbwt_index_layout(n, r, offsets) > (uint64_t)size)
+    {
+        return -3;
+    }
+
+    LIBSAIS_UNBWT_INDEX *   RESTRICT header     = (LIBSAIS_UNBWT_INDEX *)index;
+    sa_uint_t *             RESTRICT bucket2    = (sa_uint_t *)(void *)((uint8_t *)index + offsets[0]);
+    uint16_t *              RESTRICT fastbits   = (uint16_t *)(void *)((uint8_t *)index + offsets[1]);
+    sa_uint_t *             RESTRICT samples    = (sa_uint_t *)(void *)((uint8_t *)index + offsets[2]);
+    sa_uint_t *             RESTRICT P          = (sa_uint_t *)(void *)((uint8_t *)index + offsets[3]);
+
+    fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+
+    memset(header, 0, sizeof(LIBSAIS_UNBWT_INDEX));
+    memcpy(samples, I, (n > 1 ? (size_t)1 + (size_t)((n - 1) / r) : 1) * sizeof(sa_uint_t));
+
+    if (n > 1)
+    {
+#if defined(LIBSAIS_OPENMP)
+        if (threads > 1 && n >= 262144)
+        {
+            sa_uint_t * RESTRICT buckets = (sa_uint_t *)libsais64_alloc_aligned((size_t)threads * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE)) * sizeof(sa_uint_t), 4096);
+            if (buckets == NULL)
+            {
+                return -2;
+            }
+
+            libsais64_unbwt_init_parallel(T, P, n, freq, samples, bucket2, fastbits, shift, buckets, threads);
+            libsais64_free_aligned(buckets);
+        }
+        else
+#else
+        UNUSED(threads);
+#endif
+        {
+            libsais64_unbwt_init_single(T, P, n, freq, samples, bucket2, fastbits, shift);
+        }
+    }
+
+    header->n       = (int64_t)n;
+    header->r       = (int64_t)r;
+    header->lastc   = n > 0 ? (int64_t)T[0] : 0;
+    header->magic   = LIBSAIS_UNBWT_INDEX_MAGIC;
+
+    return 0;
+}
+
+static sa_sint_t libsais64_unbwt_index_decode_main(const void * index, uint8_t * U, sa_sint_t start, sa_sint_t len, sa_sint_t threads)
+{
+    const LIBSAIS_UNBWT_INDEX * RESTRICT header = (const LIBSAIS_UNBWT_INDEX *)index;
+
+    sa_sint_t   n       = (sa_sint_t)header->n;
+    sa_sint_t   r       = (sa_sint_t)header->r;
+    fast_uint_t lastc   = (fast_uint_t)header->lastc;
+
+    if (n <= 1)
+    {
+        if (len == 1) { U[0] = (uint8_t)lastc; }
+        return 0;
+    }
+
+    int64_t offsets[4]; libsais64_unbwt_index_layout(n, r, offsets);
+
+    const sa_uint_t *   RESTRICT bucket2    = (const sa_uint_t *)(const void *)((const uint8_t *)index + offsets[0]);
+    const uint16_t *    RESTRICT fastbits   = (const uint16_t *)(const void *)((const uint8_t *)index + offsets[1]);
+    const sa_uint_t *   RESTRICT samples    = (const sa_uint_t *)(const void *)((const uint8_t *)index + offsets[2]);
+    const sa_uint_t *   RESTRICT P          = (const sa_uint_t *)(const void *)((const uint8_t *)index + offsets[3]);
+
+    fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+    sa_sint_t corrupted = 0;
+
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && len >= 65536) reduction(|:corrupted)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num      = omp_get_thread_num();
+        fast_sint_t omp_num_threads     = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num      = 0;
+        fast_sint_t omp_num_threads     = 1;
+#endif
+        fast_sint_t omp_block_stride    = ((fast_sint_t)len / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start     = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size      = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : (fast_sint_t)len - omp_block_start;
+
+        corrupted |= libsais64_unbwt_decode_range(U + omp_block_start, P, n, r, samples, bucket2, fastbits, shift, lastc, (fast_uint_t)start + (fast_uint_t)omp_block_start, (fast_uint_t)omp_block_size) != 0;
+    }
+
+    return corrupted ? -1 : 0;
+}
+
+int64_t libsais64_unbwt_index_size(int64_t n, int64_t r)
+{
+    if ((n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))))
+    {
+        return -1;
+    }
+
+    if (n <= INT32_MAX && r <= INT32_MAX && (n <= 1 || (n - 1) / r < 1024))
+    {
+        return libsais_unbwt_index_size((int32_t)n, (int32_t)r);
+    }
+
+    int64_t offsets[4]; return libsais64_unbwt_index_layout(n, r, offsets);
+}
+
+int64_t libsais64_unbwt_index_build(const uint8_t * T, int64_t n, const int64_t * freq, int64_t r, const int64_t * I, void * index, size_t size)
+{
+    if ((T == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (index == NULL) || (((size_t)index & 7) != 0))
+    {
+        return -1;
+    }
+
+    fast_sint_t t;
+    if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+    }
+    else
+    {
+        for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+    }
+
+    if (n <= INT32_MAX && r <= INT32_MAX && (n <= 1 || (n - 1) / r < 1024))
+    {
+        int32_t indexes[1024]; for (t = 0; t <= (n > 1 ? (n - 1) / r : 0); ++t) { indexes[t] = (int32_t)I[t]; }
+        int32_t frequencies[ALPHABET_SIZE]; if (freq != NULL) { for (t = 0; t < ALPHABET_SIZE; ++t) { frequencies[t] = (int32_t)freq[t]; } }
+
+        return libsais_unbwt_index_build(T, (int32_t)n, freq != NULL ? frequencies : NULL, (int32_t)r, indexes, index, size);
+    }
+
+    return libsais64_unbwt_index_build_main(T, n, freq, r, (const sa_uint_t *)I, index, size, 1);
+}
+
+int64_t libsais64_unbwt_index_decode(const void * index, size_t size, uint8_t * U, int64_t start, int64_t len)
+{
+    if ((index != NULL) && (((size_t)index & 7) == 0) && (size >= sizeof(LIBSAIS_UNBWT_INDEX)) && (((const LIBSAIS_UNBWT_INDEX *)index)->magic != LIBSAIS_UNBWT_INDEX_MAGIC))
+    {
+        return (start >= 0) && (start <= INT32_MAX) && (len >= 0) && (len <= INT32_MAX) ? libsais_unbwt_index_decode(index, size, U, (int32_t)start, (int32_t)len) : -1;
+    }
+
+    if ((U == NULL) || (libsais64_unbwt_index_validate(index, size) != 0) || (start < 0) || (len < 0) || (start > ((const LIBSAIS_UNBWT_INDEX *)index)->n - len))
+    {
+        return -1;
+    }
+
+    if (len == 0) { return 0; }
+
+    return libsais64_unbwt_index_decode_main(index, U, start, len, 1);
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+int64_t libsais64_unbwt_index_build_omp(const uint8_t * T, int64_t n, const int64_t * freq, int64_t r, const int64_t * I, void * index, size_t size, int64_t threads)
+{
+    if ((T == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (index == NULL) || (((size_t)index & 7) != 0) || (threads < 0))
+    {
+        return -1;
+    }
+
+    fast_sint_t t;
+    if (n <= 1)
+    {
+        if (I[0] != n) { return -1; }
+    }
+    else
+    {
+        for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    if (n <= INT32_MAX && r <= INT32_MAX && (n <= 1 || (n - 1) / r < 1024))
+    {
+        int32_t indexes[1024]; for (t = 0; t <= (n > 1 ? (n - 1) / r : 0); ++t) { indexes[t] = (int32_t)I[t]; }
+        int32_t frequencies[ALPHABET_SIZE]; if (freq != NULL) { for (t = 0; t < ALPHABET_SIZE; ++t) { frequencies[t] = (int32_t)freq[t]; } }
+
+        return libsais_unbwt_index_build_omp(T, (int32_t)n, freq != NULL ? frequencies : NULL, (int32_t)r, indexes, index, size, (int32_t)threads);
+    }
+
+    return libsais64_unbwt_index_build_main(T, n, freq, r, (const sa_uint_t *)I, index, size, threads);
+}
+
+int64_t libsais64_unbwt_index_decode_omp(const void * index, size_t size, uint8_t * U, int64_t start, int64_t len, int64_t threads)
+{
+    if ((index != NULL) && (((size_t)index & 7) == 0) && (size >= sizeof(LIBSAIS_UNBWT_INDEX)) && (((const LIBSAIS_UNBWT_INDEX *)index)->magic != LIBSAIS_UNBWT_INDEX_MAGIC))
+    {
+        return (start >= 0) && (start <= INT32_MAX) && (len >= 0) && (len <= INT32_MAX) ? libsais_unbwt_index_decode_omp(index, size, U, (int32_t)start, (int32_t)len, (int32_t)threads) : -1;
+    }
+
+    if ((U == NULL) || (libsais64_unbwt_index_validate(index, size) != 0) || (start < 0) || (len < 0) || (start > ((const LIBSAIS_UNBWT_INDEX *)index)->n - len) || (threads < 0))
+    {
+        return -1;
+    }
+
+    if (len == 0) { return 0; }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+    return libsais64_unbwt_index_decode_main(index, U, start, len, threads);
+}
+
+#endif
+
+static void libsais64_bwt_merge_count_superblock(const uint8_t * RESTRICT U, fast_sint_t n, sa_uint_t * RESTRICT super, uint16_t * RESTRICT block, fast_sint_t s)
+{
+    sa_sint_t counts[ALPHABET_SIZE]; memset(counts, 0, sizeof(counts));
+
+    fast_sint_t b, p, c;
+    for (b = s << 8; b < ((s + 1) << 8) && b <= (n >> 8); b += 1)
+    {
+        for (c = 0; c < ALPHABET_SIZE; c += 1) { block[b * ALPHABET_SIZE + c] = (uint16_t)counts[c]; }
+        for (p = b << 8; p < ((b + 1) << 8) && p < n; p += 1) { counts[U[p]]++; }
+    }
+
+    for (c = 0; c < ALPHABET_SIZE; c += 1) { super[(s + 1) * ALPHABET_SIZE + c] = (sa_uint_t)counts[c]; }
+}
+
+static void libsais64_bwt_merge_build_occ_omp(const uint8_t * RESTRICT U, sa_sint_t n, sa_uint_t * RESTRICT super, uint16_t * RESTRICT block, sa_sint_t threads)
+{
+    fast_sint_t superblocks = ((fast_sint_t)n >> 16) + 1;
+
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = superblocks / omp_num_threads;
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : superblocks - omp_block_start;
+
+        fast_sint_t s; for (s = omp_block_start; s < omp_block_start + omp_block_size; s += 1) { libsais64_bwt_merge_count_superblock(U, n, super, block, s); }
+    }
+
+    fast_sint_t s, c;
+    for (c = 0; c < ALPHABET_SIZE; c += 1) { super[c] = 0; }
+    for (s = 1; s <= superblocks; s += 1)
+    {
+        for (c = 0; c < ALPHABET_SIZE; c += 1) { super[s * ALPHABET_SIZE + c] += super[(s - 1) * ALPHABET_SIZE + c]; }
+    }
+}
+
+static fast_sint_t libsais64_bwt_merge_occ(const uint8_t * RESTRICT U, const sa_uint_t * RESTRICT super, const uint16_t * RESTRICT block, fast_sint_t c, fast_sint_t r)
+{
+    fast_sint_t count = (fast_sint_t)super[(r >> 16) * ALPHABET_SIZE + c] + (fast_sint_t)block[(r >> 8) * ALPHABET_SIZE + c];
+
+    fast_sint_t p; for (p = r & (-256); p < r; p += 1) { count += U[p] == c; }
+
+    return count;
+}
+
+static fast_sint_t libsais64_bwt_merge_count_sentinels(const sa_sint_t * RESTRICT I, fast_sint_t m, fast_sint_t r)
+{
+    fast_sint_t lo = 0, hi = m;
+    while (lo < hi) { fast_sint_t mid = lo + ((hi - lo) >> 1); if (I[mid] < r) { lo = mid + 1; } else { hi = mid; } }
+
+    return lo;
+}
+
+static void libsais64_bwt_merge_compute_gaps(const uint8_t * RESTRICT U1, const sa_sint_t * RESTRICT I1, sa_sint_t n1, sa_sint_t m1, const uint8_t * RESTRICT T2, sa_sint_t n2, const sa_uint_t * RESTRICT super, const uint16_t * RESTRICT block, sa_sint_t * RESTRICT gap)
+{
+    fast_sint_t C[ALPHABET_SIZE];
+
+    {
+        fast_sint_t c, sum = m1;
+        for (c = 0; c < ALPHABET_SIZE; c += 1) { C[c] = sum; sum += (fast_sint_t)super[(((fast_sint_t)n1 >> 16) + 1) * ALPHABET_SIZE + c]; }
+    }
+
+    fast_sint_t j, r = m1; gap[r]++;
+    if (m1 == 1)
+    {
+        fast_sint_t i1 = I1[0];
+        for (j = (fast_sint_t)n2 - 1; j >= 0; j -= 1)
+        {
+            fast_sint_t c = T2[j]; r = C[c] + libsais64_bwt_merge_occ(U1, super, block, c, r - (r > i1)); gap[r]++;
+        }
+    }
+    else
+    {
+        for (j = (fast_sint_t)n2 - 1; j >= 0; j -= 1)
+        {
+            fast_sint_t c = T2[j]; r = C[c] + libsais64_bwt_merge_occ(U1, super, block, c, r - libsais64_bwt_merge_count_sentinels(I1, m1, r)); gap[r]++;
+        }
+    }
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+static fast_sint_t libsais64_bwt_merge_sum_gaps(const sa_sint_t * RESTRICT gap, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i, sum = 0;
+    for (i = omp_block_start; i < omp_block_start + omp_block_size; i += 1) { sum += gap[i]; }
+
+    return sum;
+}
+
+#endif
+
+static fast_sint_t libsais64_bwt_merge_interleave(const uint8_t * RESTRICT U1, const sa_sint_t * RESTRICT I1, sa_sint_t n1, sa_sint_t m1, const uint8_t * RESTRICT U2, sa_sint_t i2, const sa_sint_t * RESTRICT gap, uint8_t * RESTRICT U, sa_sint_t * RESTRICT I, fast_sint_t omp_block_start, fast_sint_t omp_block_size, fast_sint_t b)
+{
+    fast_sint_t a = omp_block_start, n = (fast_sint_t)n1 + m1, sentinel = -1;
+    fast_sint_t t = libsais64_bwt_merge_count_sentinels(I1, m1, a), q = a + b, u = q - t - (b > i2);
+
+    for (; a < omp_block_start + omp_block_size; a += 1)
+    {
+        fast_sint_t g;
+        for (g = gap[a]; g > 0; g -= 1, b += 1, q += 1)
+        {
+            if (b != i2) { U[u++] = U2[b - (b > i2)]; } else { sentinel = q; }
+        }
+
+        if (a < n)
+        {
+            if (t < m1 && I1[t] == a) { I[t++] = (sa_sint_t)q; } else { U[u++] = U1[a - t]; }
+            q += 1;
+        }
+    }
+
+    return sentinel;
+}
+
+static sa_sint_t libsais64_bwt_merge_main(const uint8_t * U1, const sa_sint_t * I1, sa_sint_t n1, sa_sint_t m1, const uint8_t * T2, const uint8_t * U2, sa_sint_t n2, sa_sint_t i2, uint8_t * U, sa_sint_t * I, sa_sint_t threads)
+{
+    fast_sint_t superblocks = ((fast_sint_t)n1 >> 16) + 1, slots = (fast_sint_t)n1 + m1 + 1;
+
+    LIBSAIS_THREAD_STATE *  RESTRICT thread_state   = threads > 1 ? libsais64_alloc_thread_state(threads, NULL) : NULL;
+    sa_uint_t *             RESTRICT super          = (sa_uint_t *)libsais64_alloc_aligned((size_t)(superblocks + 1) * ALPHABET_SIZE * sizeof(sa_uint_t), 4096);
+    uint16_t *              RESTRICT block          = (uint16_t *)libsais64_alloc_aligned((size_t)(((fast_sint_t)n1 >> 8) + 1) * ALPHABET_SIZE * sizeof(uint16_t), 4096);
+    sa_sint_t *             RESTRICT gap            = (sa_sint_t *)libsais64_alloc_aligned((size_t)slots * sizeof(sa_sint_t), 4096);
+
+    sa_sint_t index = (threads <= 1 || thread_state != NULL) && super != NULL && block != NULL && gap != NULL ? 0 : -2;
+    if (index == 0)
+    {
+        fast_sint_t sentinel = -1;
+
+        memset(gap, 0, (size_t)slots * sizeof(sa_sint_t));
+
+        libsais64_bwt_merge_build_occ_omp(U1, n1, super, block, threads);
+        libsais64_bwt_merge_compute_gaps(U1, I1, n1, m1, T2, n2, super, block, gap);
+
+#if defined(LIBSAIS_OPENMP)
+        #pragma omp parallel num_threads(threads) if(threads > 1 && slots >= 65536 && omp_get_dynamic() == 0)
+#endif
+        {
+#if defined(LIBSAIS_OPENMP)
+            fast_sint_t omp_thread_num    = omp_get_thread_num();
+            fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+            UNUSED(threads); UNUSED(thread_state);
+
+            fast_sint_t omp_thread_num    = 0;
+            fast_sint_t omp_num_threads   = 1;
+#endif
+            fast_sint_t omp_block_stride  = (slots / omp_num_threads) & (-16);
+            fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+            fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : slots - omp_block_start;
+
+            if (omp_num_threads == 1)
+            {
+                sentinel = libsais64_bwt_merge_interleave(U1, I1, n1, m1, U2, i2, gap, U, I, omp_block_start, omp_block_size, 0);
+            }
+#if defined(LIBSAIS_OPENMP)
+            else
+            {
+                thread_state[omp_thread_num].state.count = libsais64_bwt_merge_sum_gaps(gap, omp_block_start, omp_block_size);
+
+                #pragma omp barrier
+
+                fast_sint_t t, b = 0; for (t = 0; t < omp_thread_num; ++t) { b += thread_state[t].state.count; }
+
+                fast_sint_t position = libsais64_bwt_merge_interleave(U1, I1, n1, m1, U2, i2, gap, U, I, omp_block_start, omp_block_size, b);
+                if (position >= 0) { sentinel = position; }
+            }
+#endif
+        }
+
+        {
+            fast_sint_t t = m1;
+            while (t > 0 && I[t - 1] > sentinel) { I[t] = I[t - 1]; t -= 1; }
+            I[t] = (sa_sint_t)sentinel;
+        }
+    }
+
+    libsais64_free_aligned(gap);
+    libsais64_free_aligned(block);
+    libsais64_free_aligned(super);
+    libsais64_free_thread_state(thread_state, NULL);
+
+    return index;
+}
+
+static sa_sint_t libsais64_bwt_merge_validate(const uint8_t * U1, const sa_sint_t * I1, sa_sint_t n1, sa_sint_t m1, const uint8_t * T2, const uint8_t * U2, sa_sint_t n2, sa_sint_t i2, const uint8_t * U, const sa_sint_t * I)
+{
+    if ((U1 == NULL) || (I1 == NULL) || (m1 <= 0) || (n1 < m1) || (T2 == NULL) || (U2 == NULL) || (n2 <= 0) || (i2 <= 0) || (i2 > n2) || (U == NULL) || (I == NULL))
+    {
+        return -1;
+    }
+
+    if (n1 > SAINT_MAX - 1 - n2 - m1)
+    {
+        return -1;
+    }
+
+    fast_sint_t t;
+    for (t = 0; t < m1; ++t)
+    {
+        if ((I1[t] < m1) || (I1[t] >= n1 + m1) || (t > 0 && I1[t] <= I1[t - 1])) { return -1; }
+    }
+
+    return 0;
+}
+
+int64_t libsais64_bwt_merge(const uint8_t * U1, const int64_t * I1, int64_t n1, int64_t m1, const uint8_t * T2, const uint8_t * U2, int64_t n2, int64_t i2, uint8_t * U, int64_t * I)
+{
+    if (libsais64_bwt_merge_validate(U1, I1, n1, m1, T2, U2, n2, i2, U, I) != 0)
+    {
+        return -1;
+    }
+
+    if (n1 < INT32_MAX - n2 - m1)
+    {
+        int32_t * I32 = (int32_t *)libsais64_alloc_aligned(((size_t)m1 + (size_t)m1 + 1) * sizeof(int32_t), 64);
+        if (I32 == NULL)
+        {
+            return -2;
+        }
+
+        fast_sint_t t; for (t = 0; t < m1; ++t) { I32[t] = (int32_t)I1[t]; }
+
+        sa_sint_t index = libsais_bwt_merge(U1, I32, (int32_t)n1, (int32_t)m1, T2, U2, (int32_t)n2, (int32_t)i2, U, I32 + m1);
+        if (index == 0)
+        {
+            for (t = 0; t <= m1; ++t) { I[t] = (int64_t)I32[m1 + t]; }
+        }
+
+        libsais64_free_aligned(I32);
+        return index;
+    }
+
+    return libsais64_bwt_merge_main(U1, I1, n1, m1, T2, U2, n2, i2, U, I, 1);
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+int64_t libsais64_bwt_merge_omp(const uint8_t * U1, const int64_t * I1, int64_t n1, int64_t m1, const uint8_t * T2, const uint8_t * U2, int64_t n2, int64_t i2, uint8_t * U, int64_t * I, int64_t threads)
+{
+    if ((libsais64_bwt_merge_validate(U1, I1, n1, m1, T2, U2, n2, i2, U, I) != 0) || (threads < 0))
+    {
+        return -1;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    if (n1 < INT32_MAX - n2 - m1)
+    {
+        int32_t * I32 = (int32_t *)libsais64_alloc_aligned(((size_t)m1 + (size_t)m1 + 1) * sizeof(int32_t), 64);
+        if (I32 == NULL)
+        {
+            return -2;
+        }
+
+        fast_sint_t t; for (t = 0; t < m1; ++t) { I32[t] = (int32_t)I1[t]; }
+
+        sa_sint_t index = libsais_bwt_merge_omp(U1, I32, (int32_t)n1, (int32_t)m1, T2, U2, (int32_t)n2, (int32_t)i2, U, I32 + m1, (int32_t)threads);
+        if (index == 0)
+        {
+            for (t = 0; t <= m1; ++t) { I[t] = (int64_t)I32[m1 + t]; }
+        }
+
+        libsais64_free_aligned(I32);
+        return index;
+    }
+
+    return libsais64_bwt_merge_main(U1, I1, n1, m1, T2, U2, n2, i2, U, I, threads);
+}
+
+#endif
+
+static void libsais64_sa_slice_count_bigrams(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT counts, fast_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i, j = omp_block_start + omp_block_size;
+    if (j == n && n > 0) { j -= 1; counts[(fast_sint_t)T[j] << 8]++; }
+
+    for (i = omp_block_start; i < j; i += 1) { counts[((fast_sint_t)T[i] << 8) | T[i + 1]]++; }
+}
+
+static void libsais64_sa_slice_count_bigrams_omp(const uint8_t * RESTRICT T, sa_sint_t n, sa_sint_t * RESTRICT counts, sa_sint_t * RESTRICT buffer, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads); UNUSED(buffer);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        if (omp_num_threads == 1)
+        {
+            memset(counts, 0, ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_sint_t));
+            libsais64_sa_slice_count_bigrams(T, counts, n, omp_block_start, omp_block_size);
+        }
+#if defined(LIBSAIS_OPENMP)
+        else
+        {
+            {
+                sa_sint_t * RESTRICT local = buffer + omp_thread_num * ALPHABET_SIZE * ALPHABET_SIZE;
+
+                memset(local, 0, ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_sint_t));
+                libsais64_sa_slice_count_bigrams(T, local, n, omp_block_start, omp_block_size);
+            }
+
+            #pragma omp barrier
+
+            {
+                fast_sint_t k, t;
+                fast_sint_t key_stride  = ((ALPHABET_SIZE * ALPHABET_SIZE) / omp_num_threads) & (-16);
+                fast_sint_t key_start   = omp_thread_num * key_stride;
+                fast_sint_t key_end     = omp_thread_num < omp_num_threads - 1 ? key_start + key_stride : ALPHABET_SIZE * ALPHABET_SIZE;
+
+                for (k = key_start; k < key_end; k += 1)
+                {
+                    sa_sint_t sum = 0; for (t = 0; t < omp_num_threads; t += 1) { sum += buffer[t * ALPHABET_SIZE * ALPHABET_SIZE + k]; }
+                    counts[k] = sum;
+                }
+            }
+        }
+#endif
+    }
+}
+
+static void libsais64_sa_partition_bounds(const sa_sint_t * RESTRICT counts, sa_sint_t n, sa_sint_t parts, sa_sint_t * RESTRICT bounds, sa_sint_t * RESTRICT sizes)
+{
+    fast_sint_t p, k = 0, sum = 0, prev = 0;
+
+    bounds[0] = 0;
+    for (p = 1; p < parts; p += 1)
+    {
+        fast_sint_t target = p * ((fast_sint_t)n / parts) + (p * ((fast_sint_t)n % parts)) / parts;
+
+        while (k < ALPHABET_SIZE * ALPHABET_SIZE && sum + counts[k] <= target) { sum += counts[k]; k += 1; }
+        if (k < ALPHABET_SIZE * ALPHABET_SIZE && sum + counts[k] - target < target - sum) { sum += counts[k]; k += 1; }
+
+        bounds[p] = (sa_sint_t)k; if (sizes != NULL) { sizes[p - 1] = (sa_sint_t)(sum - prev); } prev = sum;
+    }
+
+    bounds[parts] = ALPHABET_SIZE * ALPHABET_SIZE; if (sizes != NULL) { sizes[parts - 1] = (sa_sint_t)(n - prev); }
+}
+
+static sa_sint_t libsais64_sa_partition_main(const uint8_t * T, sa_sint_t n, sa_sint_t parts, sa_sint_t * bounds, sa_sint_t * sizes, sa_sint_t threads)
+{
+    sa_sint_t * RESTRICT counts = (sa_sint_t *)libsais64_alloc_aligned(ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_sint_t), 4096);
+    sa_sint_t * RESTRICT buffer = threads > 1 ? (sa_sint_t *)libsais64_alloc_aligned((size_t)threads * ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_sint_t), 4096) : NULL;
+
+    sa_sint_t index = counts != NULL && (threads <= 1 || buffer != NULL) ? 0 : -2;
+    if (index == 0)
+    {
+        libsais64_sa_slice_count_bigrams_omp(T, n, counts, buffer, threads);
+        libsais64_sa_partition_bounds(counts, n, parts, bounds, sizes);
+    }
+
+    libsais64_free_aligned(buffer);
+    libsais64_free_aligned(counts);
+
+    return index;
+}
+
+static fast_sint_t libsais64_sa_slice_compare(const uint8_t * RESTRICT T, fast_sint_t n, fast_sint_t i, fast_sint_t j, fast_sint_t d, fast_sint_t * RESTRICT budget)
+{
+    const uint8_t * RESTRICT a = T + i + d;
+    const uint8_t * RESTRICT b = T + j + d;
+
+    fast_sint_t p = 0, l = n - (i > j ? i : j) - d;
+    while (p < l && a[p] == b[p]) { p += 1; }
+
+    *budget -= p;
+
+    return p < l ? (fast_sint_t)a[p] - (fast_sint_t)b[p] : (i > j ? -1 : 1);
+}
+
+static sa_sint_t libsais64_sa_slice_insertion_sort(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, fast_sint_t n, fast_sint_t lo, fast_sint_t hi, fast_sint_t d, fast_sint_t * RESTRICT budget)
+{
+    fast_sint_t i, j;
+    for (i = lo + 1; i < hi && *budget >= 0; i += 1)
+    {
+        sa_sint_t s = SA[i];
+        for (j = i; j > lo && libsais64_sa_slice_compare(T, n, SA[j - 1], s, d, budget) > 0; j -= 1) { SA[j] = SA[j - 1]; }
+        SA[j] = s;
+    }
+
+    return *budget >= 0 ? 0 : -1;
+}
+
+static fast_sint_t libsais64_sa_slice_symbol(const uint8_t * RESTRICT T, fast_sint_t n, fast_sint_t p)
+{
+    return p < n ? (fast_sint_t)T[p] : -1;
+}
+
+static sa_sint_t libsais64_sa_slice_sort(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, fast_sint_t n, fast_sint_t lo, fast_sint_t hi, fast_sint_t d, fast_sint_t * RESTRICT budget)
+{
+    while (hi - lo > 16)
+    {
+        if ((*budget -= hi - lo) < 0) { return -1; }
+
+        fast_sint_t p, lt = lo, gt = hi, i = lo;
+        {
+            fast_sint_t a = libsais64_sa_slice_symbol(T, n, (fast_sint_t)SA[lo] + d);
+            fast_sint_t b = libsais64_sa_slice_symbol(T, n, (fast_sint_t)SA[lo + ((hi - lo) >> 1)] + d);
+            fast_sint_t c = libsais64_sa_slice_symbol(T, n, (fast_sint_t)SA[hi - 1] + d);
+
+            p = a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+        }
+
+        while (i < gt)
+        {
+            sa_sint_t s = SA[i]; fast_sint_t c = libsais64_sa_slice_symbol(T, n, (fast_sint_t)s + d);
+
+            if (c < p)      { SA[i] = SA[lt]; SA[lt] = s; lt += 1; i += 1; }
+            else if (c > p) { gt -= 1; SA[i] = SA[gt]; SA[gt] = s; }
+            else            { i += 1; }
+        }
+
+        if (gt - lt >= lt - lo && gt - lt >= hi - gt)
+        {
+            if (libsais64_sa_slice_sort(T, SA, n, lo, lt, d, budget) != 0 || libsais64_sa_slice_sort(T, SA, n, gt, hi, d, budget) != 0) { return -1; }
+            lo = lt; hi = gt; d += 1;
+        }
+        else if (lt - lo >= hi - gt)
+        {
+            if (libsais64_sa_slice_sort(T, SA, n, lt, gt, d + 1, budget) != 0 || libsais64_sa_slice_sort(T, SA, n, gt, hi, d, budget) != 0) { return -1; }
+            hi = lt;
+        }
+        else
+        {
+            if (libsais64_sa_slice_sort(T, SA, n, lo, lt, d, budget) != 0 || libsais64_sa_slice_sort(T, SA, n, lt, gt, d + 1, budget) != 0) { return -1; }
+            lo = gt;
+        }
+    }
+
+    return libsais64_sa_slice_insertion_sort(T, SA, n, lo, hi, d, budget);
+}
+
+static fast_sint_t libsais64_sa_slice_find_bucket(const sa_sint_t * RESTRICT bucket, fast_sint_t buckets, fast_sint_t target)
+{
+    fast_sint_t lo = 0, hi = buckets;
+    while (lo < hi) { fast_sint_t mid = lo + ((hi - lo) >> 1); if (bucket[mid] < target) { lo = mid + 1; } else { hi = mid; } }
+
+    return lo;
+}
+
+static sa_sint_t libsais64_sa_slice_sort_buckets(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, fast_sint_t n, const sa_sint_t * RESTRICT bucket, fast_sint_t bucket_start, fast_sint_t bucket_end, fast_sint_t budget)
+{
+    fast_sint_t k;
+    for (k = bucket_start; k < bucket_end; k += 1)
+    {
+        if (libsais64_sa_slice_sort(T, SA, n, bucket[k], bucket[k + 1], 1, &budget) != 0) { return -1; }
+    }
+
+    return 0;
+}
+
+static sa_sint_t libsais64_sa_slice_sort_buckets_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t n, const sa_sint_t * RESTRICT bucket, fast_sint_t buckets, LIBSAIS_THREAD_STATE * RESTRICT thread_state, sa_sint_t threads)
+{
+    sa_sint_t index = 0; fast_sint_t m = bucket[buckets];
+
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && m >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads); UNUSED(thread_state);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t bucket_start      = libsais64_sa_slice_find_bucket(bucket, buckets, (m / omp_num_threads) * omp_thread_num);
+        fast_sint_t bucket_end        = omp_thread_num < omp_num_threads - 1 ? libsais64_sa_slice_find_bucket(bucket, buckets, (m / omp_num_threads) * (omp_thread_num + 1)) : buckets;
+        fast_sint_t budget            = (fast_sint_t)n / omp_num_threads + ((fast_sint_t)(bucket[bucket_end] - bucket[bucket_start]) << 6);
+
+        if (omp_num_threads == 1)
+        {
+            index = libsais64_sa_slice_sort_buckets(T, SA, n, bucket, bucket_start, bucket_end, budget);
+        }
+#if defined(LIBSAIS_OPENMP)
+        else
+        {
+            thread_state[omp_thread_num].state.count = libsais64_sa_slice_sort_buckets(T, SA, n, bucket, bucket_start, bucket_end, budget);
+
+            #pragma omp barrier
+
+            #pragma omp master
+            {
+                fast_sint_t t; for (t = 0; t < omp_num_threads; ++t) { if (thread_state[t].state.count != 0) { index = -1; } }
+            }
+        }
+#endif
+    }
+
+    return index;
+}
+
+static sa_sint_t libsais64_sa_slice_fallback(const uint8_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t size, fast_sint_t first, fast_sint_t m, sa_sint_t threads)
+{
+    sa_sint_t * RESTRICT buffer = size >= n ? SA : (sa_sint_t *)libsais64_alloc_aligned((size_t)n * sizeof(sa_sint_t), 4096);
+    if (buffer == NULL)
+    {
+        return -2;
+    }
+
+#if defined(LIBSAIS_OPENMP)
+    sa_sint_t index = threads > 1 ? libsais64_omp(T, buffer, n, buffer == SA ? size - n : 0, NULL, threads) : libsais64(T, buffer, n, buffer == SA ? size - n : 0, NULL);
+#else
+    UNUSED(threads);
+
+    sa_sint_t index = libsais64(T, buffer, n, buffer == SA ? size - n : 0, NULL);
+#endif
+
+    if (index == 0)
+    {
+        memmove(SA, buffer + first, (size_t)m * sizeof(sa_sint_t));
+    }
+
+    if (buffer != SA) { libsais64_free_aligned(buffer); }
+
+    return index;
+}
+
+static sa_sint_t libsais64_sa_slice_main(const uint8_t * T, sa_sint_t * SA, sa_sint_t n, sa_sint_t lo, sa_sint_t hi, sa_sint_t size, sa_sint_t threads)
+{
+    fast_sint_t buckets = (fast_sint_t)hi - lo;
+
+    LIBSAIS_THREAD_STATE *  RESTRICT thread_state   = threads > 1 ? libsais64_alloc_thread_state(threads, NULL) : NULL;
+    sa_sint_t *             RESTRICT bucket         = (sa_sint_t *)libsais64_alloc_aligned((size_t)(buckets + 1) * sizeof(sa_sint_t), 4096);
+
+    sa_sint_t index = (threads <= 1 || thread_state != NULL) && bucket != NULL ? 0 : -2;
+    if (index == 0)
+    {
+        fast_sint_t i, k, m = 0, first = 0;
+
+        memset(bucket, 0, (size_t)(buckets + 1) * sizeof(sa_sint_t));
+
+        for (i = 0; i < n; i += 1)
+        {
+            k = (i < n - 1 ? (((fast_sint_t)T[i] << 8) | T[i + 1]) : ((fast_sint_t)T[i] << 8)) - lo;
+            if (k < 0) { first += 1; } else if (k < buckets) { bucket[k + 1] += 1; }
+        }
+
+        for (k = 1; k <= buckets; k += 1) { sa_sint_t c = bucket[k]; bucket[k] = (sa_sint_t)m; m += c; }
+
+        if (m > size)
+        {
+            index = -3;
+        }
+        else if (m > 0)
+        {
+            for (i = 0; i < n; i += 1)
+            {
+                k = (i < n - 1 ? (((fast_sint_t)T[i] << 8) | T[i + 1]) : ((fast_sint_t)T[i] << 8)) - lo;
+                if (k >= 0 && k < buckets) { SA[bucket[k + 1]++] = (sa_sint_t)i; }
+            }
+
+            if (libsais64_sa_slice_sort_buckets_omp(T, SA, n, bucket, buckets, thread_state, threads) != 0)
+            {
+                index = libsais64_sa_slice_fallback(T, SA, n, size, first, m, threads);
+            }
+        }
+
+        if (index == 0) { index = (sa_sint_t)m; }
+    }
+
+    libsais64_free_aligned(bucket);
+    libsais64_free_thread_state(thread_state, NULL);
+
+    return index;
+}
+
+static sa_sint_t libsais64_sa_slice_validate(const uint8_t * T, const sa_sint_t * SA, sa_sint_t n, sa_sint_t lo, sa_sint_t hi, sa_sint_t size)
+{
+    return (T == NULL) || (SA == NULL) || (n < 0) || (lo < 0) || (lo > hi) || (hi > ALPHABET_SIZE * ALPHABET_SIZE) || (size < 0) ? -1 : 0;
+}
+
+int64_t libsais64_sa_partition(const uint8_t * T, int64_t n, int64_t parts, int64_t * bounds, int64_t * sizes)
+{
+    if ((T == NULL) || (n < 0) || (parts <= 0) || (parts > ALPHABET_SIZE * ALPHABET_SIZE) || (bounds == NULL))
+    {
+        return -1;
+    }
+
+    return libsais64_sa_partition_main(T, n, parts, bounds, sizes, 1);
+}
+
+int64_t libsais64_sa_slice(const uint8_t * T, int64_t * SA, int64_t n, int64_t lo, int64_t hi, int64_t size)
+{
+    if (libsais64_sa_slice_validate(T, SA, n, lo, hi, size) != 0)
+    {
+        return -1;
+    }
+
+    return libsais64_sa_slice_main(T, SA, n, lo, hi, size, 1);
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+int64_t libsais64_sa_partition_omp(const uint8_t * T, int64_t n, int64_t parts, int64_t * bounds, int64_t * sizes, int64_t threads)
+{
+    if ((T == NULL) || (n < 0) || (parts <= 0) || (parts > ALPHABET_SIZE * ALPHABET_SIZE) || (bounds == NULL) || (threads < 0))
+    {
+        return -1;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais64_sa_partition_main(T, n, parts, bounds, sizes, threads);
+}
+
+int64_t libsais64_sa_slice_omp(const uint8_t * T, int64_t * SA, int64_t n, int64_t lo, int64_t hi, int64_t size, int64_t threads)
+{
+    if ((libsais64_sa_slice_validate(T, SA, n, lo, hi, size) != 0) || (threads < 0))
+    {
+        return -1;
+    }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais64_sa_slice_main(T, SA, n, lo, hi, size, threads);
+}
+
+#endif
+
+static void libsais64_compute_phi(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j; sa_sint_t k = omp_block_start > 0 ? SA[omp_block_start - 1] : n;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
+    {
+        libsais64_prefetchr(&SA[i + 2 * prefetch_distance]);
+
+        libsais64_prefetchw(&PLCP[SA[i + prefetch_distance + 0]]);
+        libsais64_prefetchw(&PLCP[SA[i + prefetch_distance + 1]]);
+
+        PLCP[SA[i + 0]] = k; k = SA[i + 0];
+        PLCP[SA[i + 1]] = k; k = SA[i + 1];
+
+        libsais64_prefetchw(&PLCP[SA[i + prefetch_distance + 2]]);
+        libsais64_prefetchw(&PLCP[SA[i + prefetch_distance + 3]]);
+
+        PLCP[SA[i + 2]] = k; k = SA[i + 2];
+        PLCP[SA[i + 3]] = k; k = SA[i + 3];
+    }
+
+    for (j += prefetch_distance + 3; i < j; i += 1)
+    {
+        PLCP[SA[i]] = k; k = SA[i];
+    }
+}
+
+static void libsais64_compute_phi_omp(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais64_compute_phi(SA, PLCP, n, omp_block_start, omp_block_size);
+    }
+}
+
+static void libsais64_compute_plcp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, fast_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j, l = 0;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais64_prefetchw(&PLCP[i + 2 * prefetch_distance]);
+        libsais64_prefetchr(&T[PLCP[i + prefetch_distance] + l]);
+
+        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
+        while (l < m && T[i + l] == T[k + l]) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+    }
+
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
+        while (l < m && T[i + l] == T[k + l]) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+    }
+}
+
+static void libsais64_compute_plcp_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais64_compute_plcp(T, PLCP, n, omp_block_start, omp_block_size);
+    }
+}
+
+static void libsais64_compute_plcp_gsa(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, fast_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j, l = 0;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais64_prefetchw(&PLCP[i + 2 * prefetch_distance]);
+        libsais64_prefetchr(&T[PLCP[i + prefetch_distance] + l]);
+
+        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
+        while (l < m && T[i + l] == T[k + l] && T[i + l] != 0) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+    }
+
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
+        while (l < m && T[i + l] == T[k + l] && T[i + l] != 0) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+    }
+}
+
+static void libsais64_compute_plcp_gsa_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais64_compute_plcp_gsa(T, PLCP, n, omp_block_start, omp_block_size);
+    }
+}
+
+static void libsais64_compute_lcp(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
+    {
+        libsais64_prefetchr(&SA[i + 2 * prefetch_distance]);
+        libsais64_prefetchw(&LCP[i + prefetch_distance]);
+
+        libsais64_prefetchr(&PLCP[SA[i + prefetch_distance + 0]]);
+        libsais64_prefetchr(&PLCP[SA[i + prefetch_distance + 1]]);
+
+        LCP[i + 0] = PLCP[SA[i + 0]];
+        LCP[i + 1] = PLCP[SA[i + 1]];
+
+        libsais64_prefetchr(&PLCP[SA[i + prefetch_distance + 2]]);
+        libsais64_prefetchr(&PLCP[SA[i + prefetch_distance + 3]]);
+
+        LCP[i + 2] = PLCP[SA[i + 2]];
+        LCP[i + 3] = PLCP[SA[i + 3]];
+    }
+
+    for (j += prefetch_distance + 3; i < j; i += 1)
+    {
+        LCP[i] = PLCP[SA[i]];
+    }
+}
+
+static void libsais64_compute_lcp_omp(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais64_compute_lcp(PLCP, SA, LCP, omp_block_start, omp_block_size);
+    }
+}
+
+static sa_sint_t libsais64_load_40u(const uint8_t * RESTRICT A, fast_sint_t i)
+{
+    const uint8_t * RESTRICT p = &A[i * 5];
+    return (sa_sint_t)((uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24) | ((uint64_t)p[4] << 32));
+}
+
+static void libsais64_store_40u(uint8_t * RESTRICT A, fast_sint_t i, sa_sint_t v)
+{
+    uint8_t * RESTRICT p = &A[i * 5];
+    p[0] = (uint8_t)((uint64_t)v >> 0); p[1] = (uint8_t)((uint64_t)v >> 8); p[2] = (uint8_t)((uint64_t)v >> 16); p[3] = (uint8_t)((uint64_t)v >> 24); p[4] = (uint8_t)((uint64_t)v >> 32);
+}
+
+static void libsais64_convert_64u_to_40u(const sa_sint_t * RESTRICT S, uint8_t * RESTRICT D, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size; i < j; i += 1)
+    {
+        libsais64_store_40u(D, i, S[i]);
+    }
+}
+
+static void libsais64_convert_40u_to_64u(const uint8_t * RESTRICT S, sa_sint_t * RESTRICT D, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size; i < j; i += 1)
+    {
+        D[i] = libsais64_load_40u(S, i);
+    }
+}
+
+static void libsais64_convert_inplace_64u_to_40u(sa_sint_t * V, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    uint8_t * D = (uint8_t *)(void *)V;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size; i < j; i += 1)
+    {
+        uint64_t v = (uint64_t)V[i];
+        D[i * 5 + 0] = (uint8_t)(v >> 0); D[i * 5 + 1] = (uint8_t)(v >> 8); D[i * 5 + 2] = (uint8_t)(v >> 16); D[i * 5 + 3] = (uint8_t)(v >> 24); D[i * 5 + 4] = (uint8_t)(v >> 32);
+    }
+}
+
+static void libsais64_convert_inplace_40u_to_64u(sa_sint_t * V, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const uint8_t * S = (const uint8_t *)(void *)V;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start + omp_block_size - 1, j = omp_block_start; i >= j; i -= 1)
+    {
+        uint64_t v = (uint64_t)S[i * 5 + 0] | ((uint64_t)S[i * 5 + 1] << 8) | ((uint64_t)S[i * 5 + 2] << 16) | ((uint64_t)S[i * 5 + 3] << 24) | ((uint64_t)S[i * 5 + 4] << 32);
+        V[i] = (sa_sint_t)v;
+    }
+}
+
+static void libsais64_convert_inplace_64u_to_40u_omp(sa_sint_t * V, sa_sint_t n, sa_sint_t threads)
+{
+    fast_sint_t m = n < 65536 ? n : 65536;
+
+    libsais64_convert_inplace_64u_to_40u(V, 0, m);
+
+    while (m < n)
+    {
+        fast_sint_t block_size = (m >> 1) < (n - m) ? (m >> 1) : (n - m);
+
+#if defined(LIBSAIS_OPENMP)
+        #pragma omp parallel num_threads(threads) if(threads > 1)
+#endif
+        {
+#if defined(LIBSAIS_OPENMP)
+            fast_sint_t omp_thread_num      = omp_get_thread_num();
+            fast_sint_t omp_num_threads     = omp_get_num_threads();
+#else
+            UNUSED(threads);
+
+            fast_sint_t omp_thread_num      = 0;
+            fast_sint_t omp_num_threads     = 1;
+#endif
+            fast_sint_t omp_block_stride    = (block_size / omp_num_threads) & (-16);
+            fast_sint_t omp_block_start     = omp_thread_num * omp_block_stride;
+            fast_sint_t omp_block_size      = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : block_size - omp_block_start;
+
+            libsais64_convert_64u_to_40u(V + m, ((uint8_t *)(void *)V) + m * 5, omp_block_start, omp_block_size);
+        }
+
+        m += block_size;
+    }
+}
+
+static void libsais64_convert_inplace_40u_to_64u_omp(sa_sint_t * V, sa_sint_t n, sa_sint_t threads)
+{
+    while (n >= 65536)
+    {
+        fast_sint_t block_size = n >> 2; n -= block_size;
+
+#if defined(LIBSAIS_OPENMP)
+        #pragma omp parallel num_threads(threads) if(threads > 1)
+#endif
+        {
+#if defined(LIBSAIS_OPENMP)
+            fast_sint_t omp_thread_num      = omp_get_thread_num();
+            fast_sint_t omp_num_threads     = omp_get_num_threads();
+#else
+            UNUSED(threads);
+
+            fast_sint_t omp_thread_num      = 0;
+            fast_sint_t omp_num_threads     = 1;
+#endif
+            fast_sint_t omp_block_stride    = (block_size / omp_num_threads) & (-16);
+            fast_sint_t omp_block_start     = omp_thread_num * omp_block_stride;
+            fast_sint_t omp_block_size      = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : block_size - omp_block_start;
+
+            libsais64_convert_40u_to_64u(((uint8_t *)(void *)V) + (fast_sint_t)n * 5, V + n, omp_block_start, omp_block_size);
+        }
+    }
+
+    libsais64_convert_inplace_40u_to_64u(V, 0, n);
+}
+
+static void libsais64_compute_phi_40u(const uint8_t * RESTRICT SA, uint8_t * RESTRICT PLCP, sa_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j; sa_sint_t k = omp_block_start > 0 ? libsais64_load_40u(SA, omp_block_start - 1) : n;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais64_prefetchr(&SA[(i + 2 * prefetch_distance) * 5]);
+        libsais64_prefetchw(&PLCP[libsais64_load_40u(SA, i + prefetch_distance) * 5]);
+
+        sa_sint_t s = libsais64_load_40u(SA, i); libsais64_store_40u(PLCP, s, k); k = s;
+    }
+
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        sa_sint_t s = libsais64_load_40u(SA, i); libsais64_store_40u(PLCP, s, k); k = s;
+    }
+}
+
+static void libsais64_compute_phi_40u_omp(const uint8_t * RESTRICT SA, uint8_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais64_compute_phi_40u(SA, PLCP, n, omp_block_start, omp_block_size);
+    }
+}
+
+static void libsais64_compute_plcp_40u(const uint8_t * RESTRICT T, uint8_t * RESTRICT PLCP, fast_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j, l = 0;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais64_prefetchw(&PLCP[(i + 2 * prefetch_distance) * 5]);
+        libsais64_prefetchr(&T[libsais64_load_40u(PLCP, i + prefetch_distance) + l]);
+
+        fast_sint_t k = libsais64_load_40u(PLCP, i), m = n - (i > k ? i : k);
+        while (l < m && T[i + l] == T[k + l]) { l++; }
+
+        libsais64_store_40u(PLCP, i, (sa_sint_t)l); l -= (l != 0);
+    }
+
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        fast_sint_t k = libsais64_load_40u(PLCP, i), m = n - (i > k ? i : k);
+        while (l < m && T[i + l] == T[k + l]) { l++; }
+
+        libsais64_store_40u(PLCP, i, (sa_sint_t)l); l -= (l != 0);
+    }
+}
+
+static void libsais64_compute_plcp_40u_omp(const uint8_t * RESTRICT T, uint8_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais64_compute_plcp_40u(T, PLCP, n, omp_block_start, omp_block_size);
+    }
+}
+
+static void libsais64_compute_lcp_40u(const uint8_t * RESTRICT PLCP, const uint8_t * RESTRICT SA, uint8_t * RESTRICT LCP, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais64_prefetchr(&SA[(i + 2 * prefetch_distance) * 5]);
+        libsais64_prefetchw(&LCP[(i + prefetch_distance) * 5]);
+
+        libsais64_prefetchr(&PLCP[libsais64_load_40u(SA, i + prefetch_distance) * 5]);
+
+        libsais64_store_40u(LCP, i, libsais64_load_40u(PLCP, libsais64_load_40u(SA, i)));
+    }
+
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        libsais64_store_40u(LCP, i, libsais64_load_40u(PLCP, libsais64_load_40u(SA, i)));
+    }
+}
+
+static void libsais64_compute_lcp_40u_omp(const uint8_t * RESTRICT PLCP, const uint8_t * RESTRICT SA, uint8_t * RESTRICT LCP, sa_sint_t n, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais64_compute_lcp_40u(PLCP, SA, LCP, omp_block_start, omp_block_size);
+    }
+}
+
+static void libsais64_compute_isa(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT ISA, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
+    {
+        libsais64_prefetchr(&SA[i + 2 * prefetch_distance]);
+
+        libsais64_prefetchw(&ISA[SA[i + prefetch_distance + 0]]);
+        libsais64_prefetchw(&ISA[SA[i + prefetch_distance + 1]]);
+
+        ISA[SA[i + 0]] = (sa_sint_t)(i + 0);
+        ISA[SA[i + 1]] = (sa_sint_t)(i + 1);
+
+        libsais64_prefetchw(&ISA[SA[i + prefetch_distance + 2]]);
+        libsais64_prefetchw(&ISA[SA[i + prefetch_distance + 3]]);
+
+        ISA[SA[i + 2]] = (sa_sint_t)(i + 2);
+        ISA[SA[i + 3]] = (sa_sint_t)(i + 3);
+    }
+
+    for (j += prefetch_distance + 3; i < j; i += 1)
+    {
+        ISA[SA[i]] = (sa_sint_t)i;
+    }
+}
+
+static void libsais64_compute_isa_inplace(sa_sint_t * RESTRICT SA, sa_sint_t n)
+{
+    fast_sint_t i;
+    for (i = 0; i < n; i += 1)
+    {
+        if (SA[i] >= 0)
+        {
+            sa_sint_t p = (sa_sint_t)i, q = SA[i];
+            while (q != (sa_sint_t)i) { sa_sint_t r = SA[q]; SA[q] = p | SAINT_MIN; p = q; q = r; }
+
+            SA[i] = p | SAINT_MIN;
+        }
+    }
+}
+
+static void libsais64_unmark_array(sa_sint_t * RESTRICT A, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i;
+    for (i = omp_block_start; i < omp_block_start + omp_block_size; i += 1)
+    {
+        A[i] &= SAINT_MAX;
+    }
+}
+
+static void libsais64_compute_isa_omp(const sa_sint_t * SA, sa_sint_t * ISA, sa_sint_t n, sa_sint_t threads)
+{
+    if (SA == ISA)
+    {
+        libsais64_compute_isa_inplace(ISA, n);
+    }
+
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        if (SA == ISA)
+        {
+            libsais64_unmark_array(ISA, omp_block_start, omp_block_size);
+        }
+        else
+        {
+            libsais64_compute_isa(SA, ISA, omp_block_start, omp_block_size);
+        }
+    }
+}
+
+static void libsais64_compute_lcp_inplace(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n)
+{
+    fast_sint_t i;
+    for (i = 0; i < n; i += 1)
+    {
+        if (PLCP[i] >= 0)
+        {
+            sa_sint_t l = PLCP[i]; fast_sint_t j = i, k;
+            while ((k = (fast_sint_t)SA[j]) != i) { PLCP[j] = PLCP[k] | SAINT_MIN; j = k; }
+
+            PLCP[j] = l | SAINT_MIN;
         }
     }
 }
 
-static void libsais64_unbwt_calculate_biPSI(const uint8_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket1, sa_uint_t * RESTRICT bucket2, fast_uint_t index, fast_sint_t omp_block_start, fast_sint_t omp_block_end)
+static void libsais64_compute_lcp_inplace_omp(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+{
+    libsais64_compute_lcp_inplace(SA, PLCP, n);
+
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais64_unmark_array(PLCP, omp_block_start, omp_block_size);
+    }
+}
+
+static void libsais64_compute_sa_lcp_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, sa_sint_t n, sa_sint_t fs, sa_sint_t threads)
+{
+    if (fs >= n)
+    {
+        libsais64_compute_phi_omp(SA, &SA[n], n, threads);
+        libsais64_compute_plcp_omp(T, &SA[n], n, threads);
+        libsais64_compute_lcp_omp(&SA[n], SA, LCP, n, threads);
+    }
+    else
+    {
+        libsais64_compute_phi_omp(SA, LCP, n, threads);
+        libsais64_compute_plcp_omp(T, LCP, n, threads);
+        libsais64_compute_lcp_inplace_omp(SA, LCP, n, threads);
+    }
+}
+
+static void libsais64_compute_phi_sampled(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t r, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j; sa_sint_t k = omp_block_start > 0 ? SA[omp_block_start - 1] : n, s;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - 3; i < j; i += 4)
+    {
+        libsais64_prefetchr(&SA[i + prefetch_distance]);
+
+        s = SA[i + 0]; if ((s & (r - 1)) == 0) { PLCP[s / r] = k; } k = s;
+        s = SA[i + 1]; if ((s & (r - 1)) == 0) { PLCP[s / r] = k; } k = s;
+        s = SA[i + 2]; if ((s & (r - 1)) == 0) { PLCP[s / r] = k; } k = s;
+        s = SA[i + 3]; if ((s & (r - 1)) == 0) { PLCP[s / r] = k; } k = s;
+    }
+
+    for (j += 3; i < j; i += 1)
+    {
+        s = SA[i]; if ((s & (r - 1)) == 0) { PLCP[s / r] = k; } k = s;
+    }
+}
+
+static void libsais64_compute_phi_sampled_omp(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t r, sa_sint_t threads)
+{
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        libsais64_compute_phi_sampled(SA, PLCP, n, r, omp_block_start, omp_block_size);
+    }
+}
+
+static void libsais64_compute_plcp_sampled(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, fast_sint_t n, fast_sint_t r, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j, l = 0;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais64_prefetchw(&PLCP[i + 2 * prefetch_distance]);
+        libsais64_prefetchr(&T[(i + prefetch_distance) * r + l]);
+        libsais64_prefetchr(&T[PLCP[i + prefetch_distance] + l]);
+
+        fast_sint_t p = i * r, k = PLCP[i], m = n - (p > k ? p : k);
+        while (l < m && T[p + l] == T[k + l]) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l = l > r ? l - r : 0;
+    }
+
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        fast_sint_t p = i * r, k = PLCP[i], m = n - (p > k ? p : k);
+        while (l < m && T[p + l] == T[k + l]) { l++; }
+
+        PLCP[i] = (sa_sint_t)l; l = l > r ? l - r : 0;
+    }
+}
+
+static void libsais64_compute_plcp_sampled_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t r, sa_sint_t threads)
+{
+    fast_sint_t m = ((fast_sint_t)n - 1) / r + 1;
+
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (m / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : m - omp_block_start;
+
+        libsais64_compute_plcp_sampled(T, PLCP, n, r, omp_block_start, omp_block_size);
+    }
+}
+
+static sa_sint_t libsais64_compute_lcp_sample(const uint8_t * RESTRICT T, const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, fast_sint_t n, fast_sint_t r, fast_sint_t i)
+{
+    if (i == 0) { return 0; }
+
+    fast_sint_t p = SA[i], k = SA[i - 1], m = n - (p > k ? p : k);
+    fast_sint_t l = PLCP[p / r] - (p & (r - 1)); l = l > 0 ? l : 0;
+    while (l < m && T[p + l] == T[k + l]) { l++; }
+
+    return (sa_sint_t)l;
+}
+
+static void libsais64_compute_lcp_sampled(const uint8_t * RESTRICT T, const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, fast_sint_t n, fast_sint_t r, fast_sint_t k, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
+
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
     {
-        fast_sint_t i = omp_block_start, j = (fast_sint_t)index; if (omp_block_end < j) { j = omp_block_end; }
-        for (; i < j; ++i)
-        {
-            fast_uint_t c = T[i];
-            fast_uint_t p = bucket1[c]++;
-            fast_sint_t t = (fast_sint_t)(index - p);
+        libsais64_prefetchr(&SA[(i + 2 * prefetch_distance) * k - 1]);
+        libsais64_prefetchr(&PLCP[SA[(i + prefetch_distance) * k] / r]);
 
-            if (t != 0)
-            {
-                fast_uint_t w = (((fast_uint_t)T[p + (fast_uint_t)(t >> ((sizeof(fast_sint_t) * 8) - 1))]) << 8) + c;
-                P[bucket2[w]++] = (sa_uint_t)i;
-            }
-        }
+        LCP[i] = libsais64_compute_lcp_sample(T, PLCP, SA, n, r, i * k);
     }
 
+    for (j += prefetch_distance; i < j; i += 1)
     {
-        fast_sint_t i = (fast_sint_t)index, j = omp_block_end; if (omp_block_start > i) { i = omp_block_start; }
-        for (i += 1; i <= j; ++i)
-        {
-            fast_uint_t c = T[i - 1];
-            fast_uint_t p = bucket1[c]++;
-            fast_sint_t t = (fast_sint_t)(index - p);
-
-            if (t != 0)
-            {
-                fast_uint_t w = (((fast_uint_t)T[p + (fast_uint_t)(t >> ((sizeof(fast_sint_t) * 8) - 1))]) << 8) + c;
-                P[bucket2[w]++] = (sa_uint_t)i;
-            }
-        }
+        LCP[i] = libsais64_compute_lcp_sample(T, PLCP, SA, n, r, i * k);
     }
 }
 
-static void libsais64_unbwt_init_single(const uint8_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits)
+static void libsais64_compute_lcp_sampled_omp(const uint8_t * RESTRICT T, const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, sa_sint_t n, sa_sint_t r, sa_sint_t k, sa_sint_t threads)
 {
-    sa_uint_t bucket1[ALPHABET_SIZE];
-
-    fast_uint_t index = I[0];
-    fast_uint_t lastc = T[0];
-    fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+    fast_sint_t m = ((fast_sint_t)n - 1) / k + 1;
 
-    if (freq != NULL)
+#if defined(LIBSAIS_OPENMP)
+    #pragma omp parallel num_threads(threads) if(threads > 1 && m >= 65536)
+#endif
     {
-        memcpy(bucket1, freq, ALPHABET_SIZE * sizeof(sa_uint_t));
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (m / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : m - omp_block_start;
+
+        libsais64_compute_lcp_sampled(T, PLCP, SA, LCP, n, r, k, omp_block_start, omp_block_size);
     }
-    else
+}
+
+#if defined(LIBSAIS_OPENMP)
+
+static fast_sint_t libsais64_count_marked(const uint8_t * RESTRICT B, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i, j, c = 0;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - 7; i < j; i += 8)
     {
-        memset(bucket1, 0, ALPHABET_SIZE * sizeof(sa_uint_t));
-        libsais64_unbwt_compute_histogram(T, n, bucket1);
+        fast_uint_t x = B[i >> 3];
+
+        x = x - ((x >> 1) & 0x55); x = (x & 0x33) + ((x >> 2) & 0x33); c += (fast_sint_t)((x + (x >> 4)) & 0x0f);
     }
 
-    memset(bucket2, 0, ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_uint_t));
-    libsais64_unbwt_compute_bigram_histogram_single(T, bucket1, bucket2, index);
+    for (j += 7; i < j; i += 1)
+    {
+        c += (B[i >> 3] >> (i & 7)) & 1;
+    }
 
-    libsais64_unbwt_calculate_fastbits(bucket2, fastbits, lastc, shift);
-    libsais64_unbwt_calculate_biPSI(T, P, bucket1, bucket2, index, 0, n);
+    return c;
 }
 
-#if defined(LIBSAIS_OPENMP)
+#endif
 
-static void libsais64_unbwt_compute_bigram_histogram_parallel(const uint8_t * RESTRICT T, fast_uint_t index, sa_uint_t * RESTRICT bucket1, sa_uint_t * RESTRICT bucket2, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+static fast_sint_t libsais64_compute_lcp_marked(const uint8_t * RESTRICT T, const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, const uint8_t * RESTRICT B, sa_sint_t * RESTRICT LCP, fast_sint_t n, fast_sint_t r, fast_sint_t c, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
 {
-    fast_sint_t i;
-    for (i = omp_block_start; i < omp_block_start + omp_block_size; ++i)
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size; i < j; i += 1)
     {
-        fast_uint_t c = T[i];
-        fast_uint_t p = bucket1[c]++;
-        fast_sint_t t = (fast_sint_t)(index - p);
-
-        if (t != 0)
+        if ((B[i >> 3] >> (i & 7)) & 1)
         {
-            fast_uint_t w = (((fast_uint_t)T[p + (fast_uint_t)(t >> ((sizeof(fast_sint_t) * 8) - 1))]) << 8) + c;
-            bucket2[w]++;
+            LCP[c++] = libsais64_compute_lcp_sample(T, PLCP, SA, n, r, i);
         }
     }
+
+    return c;
 }
 
-static void libsais64_unbwt_init_parallel(const uint8_t * RESTRICT T, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, sa_uint_t * RESTRICT buckets, sa_sint_t threads)
+static sa_sint_t libsais64_compute_lcp_marked_omp(const uint8_t * RESTRICT T, const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, const uint8_t * RESTRICT B, sa_sint_t * RESTRICT LCP, sa_sint_t n, sa_sint_t r, sa_sint_t threads)
 {
-    sa_uint_t bucket1[ALPHABET_SIZE];
-
-    fast_uint_t index = I[0];
-    fast_uint_t lastc = T[0];
-    fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+    fast_sint_t count = 0;
 
-    memset(bucket1, 0, ALPHABET_SIZE * sizeof(sa_uint_t));
-    memset(bucket2, 0, ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_uint_t));
+#if defined(LIBSAIS_OPENMP)
+    fast_sint_t * RESTRICT counts = threads > 1 && n >= 65536 ? (fast_sint_t *)libsais64_alloc_aligned((size_t)threads * sizeof(fast_sint_t), 64) : NULL;
+    if (threads > 1 && n >= 65536 && counts == NULL) { return -2; }
 
     #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
     {
-        fast_sint_t omp_thread_num  = omp_get_thread_num();
-        fast_sint_t omp_num_threads = omp_get_num_threads();
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
+
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
 
         if (omp_num_threads == 1)
         {
-            libsais64_unbwt_init_single(T, P, n, freq, I, bucket2, fastbits);
+            count = libsais64_compute_lcp_marked(T, PLCP, SA, B, LCP, n, r, 0, omp_block_start, omp_block_size);
         }
+#if defined(LIBSAIS_OPENMP)
         else
         {
-            sa_uint_t * RESTRICT bucket1_local  = buckets + omp_thread_num * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE));
-            sa_uint_t * RESTRICT bucket2_local  = bucket1_local + ALPHABET_SIZE;
-
-            fast_sint_t omp_block_stride        = (n / omp_num_threads) & (-16);
-            fast_sint_t omp_block_start         = omp_thread_num * omp_block_stride;
-            fast_sint_t omp_block_size          = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
-
-            {
-                memset(bucket1_local, 0, ALPHABET_SIZE * sizeof(sa_uint_t));
-                libsais64_unbwt_compute_histogram(T + omp_block_start, omp_block_size, bucket1_local);
-            }
+            counts[omp_thread_num] = libsais64_count_marked(B, omp_block_start, omp_block_size);
 
             #pragma omp barrier
 
             #pragma omp master
             {
-                {
-                    sa_uint_t * RESTRICT bucket1_temp = buckets;
-
-                    fast_sint_t t;
-                    for (t = 0; t < omp_num_threads; ++t, bucket1_temp += ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE))
-                    {
-                        fast_sint_t c; for (c = 0; c < ALPHABET_SIZE; c += 1) { sa_uint_t A = bucket1[c], B = bucket1_temp[c]; bucket1[c] = A + B; bucket1_temp[c] = A; }
-                    }
-                }
+                fast_sint_t t, c = 0; for (t = 0; t < omp_num_threads; ++t) { fast_sint_t m = counts[t]; counts[t] = c; c += m; }
 
-                {
-                    fast_uint_t sum, c;
-                    for (sum = 1, c = 0; c < ALPHABET_SIZE; ++c) { fast_uint_t prev = sum; sum += bucket1[c]; bucket1[c] = (sa_uint_t)prev; }
-                }
+                count = c;
             }
 
             #pragma omp barrier
 
-            {
-                fast_sint_t c; for (c = 0; c < ALPHABET_SIZE; c += 1) { sa_uint_t A = bucket1[c], B = bucket1_local[c]; bucket1_local[c] = A + B; }
+            libsais64_compute_lcp_marked(T, PLCP, SA, B, LCP, n, r, counts[omp_thread_num], omp_block_start, omp_block_size);
+        }
+#endif
+    }
 
-                memset(bucket2_local, 0, ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_uint_t));
-                libsais64_unbwt_compute_bigram_histogram_parallel(T, index, bucket1_local, bucket2_local, omp_block_start, omp_block_size);
-            }
+#if defined(LIBSAIS_OPENMP)
+    libsais64_free_aligned(counts);
+#endif
 
-            #pragma omp barrier
+    return (sa_sint_t)count;
+}
 
-            {
-                fast_sint_t omp_bucket2_stride  = ((ALPHABET_SIZE * ALPHABET_SIZE) / omp_num_threads) & (-16);
-                fast_sint_t omp_bucket2_start   = omp_thread_num * omp_bucket2_stride;
-                fast_sint_t omp_bucket2_size    = omp_thread_num < omp_num_threads - 1 ? omp_bucket2_stride : (ALPHABET_SIZE * ALPHABET_SIZE) - omp_bucket2_start;
+static fast_sint_t libsais64_compute_lcp_8u(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, uint8_t * RESTRICT LCP, sa_sint_t * RESTRICT X, fast_sint_t xs, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    const fast_sint_t prefetch_distance = LIBSAIS_PREFETCH_DISTANCE;
 
-                sa_uint_t * RESTRICT bucket2_temp = buckets + ALPHABET_SIZE;
+    fast_sint_t i, j, c = 0;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    {
+        libsais64_prefetchr(&SA[i + 2 * prefetch_distance]);
+        libsais64_prefetchr(&PLCP[SA[i + prefetch_distance]]);
 
-                fast_sint_t t;
-                for (t = 0; t < omp_num_threads; ++t, bucket2_temp += ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE))
-                {
-                    fast_sint_t c; for (c = omp_bucket2_start; c < omp_bucket2_start + omp_bucket2_size; c += 1) { sa_uint_t A = bucket2[c], B = bucket2_temp[c]; bucket2[c] = A + B; bucket2_temp[c] = A; }
-                }
-            }
+        sa_sint_t l = PLCP[SA[i]];
+        if (l < UINT8_MAX) { LCP[i] = (uint8_t)l; } else { LCP[i] = UINT8_MAX; if (c < xs) { X[2 * c + 0] = (sa_sint_t)i; X[2 * c + 1] = l; } c++; }
+    }
 
-            #pragma omp barrier
+    for (j += prefetch_distance; i < j; i += 1)
+    {
+        sa_sint_t l = PLCP[SA[i]];
+        if (l < UINT8_MAX) { LCP[i] = (uint8_t)l; } else { LCP[i] = UINT8_MAX; if (c < xs) { X[2 * c + 0] = (sa_sint_t)i; X[2 * c + 1] = l; } c++; }
+    }
 
-            #pragma omp master
-            {
+    return c;
+}
 
-                libsais64_unbwt_calculate_fastbits(bucket2, fastbits, lastc, shift);
+#if defined(LIBSAIS_OPENMP)
 
-                {
-                    fast_sint_t t;
-                    for (t = omp_num_threads - 1; t >= 1; --t) 
-                    { 
-                        sa_uint_t * RESTRICT dst_bucket1 = buckets + t * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE));
-                        sa_uint_t * RESTRICT src_bucket1 = dst_bucket1 - (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE));
+static void libsais64_gather_lcp_8u_exceptions(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, const uint8_t * RESTRICT LCP, sa_sint_t * RESTRICT X, fast_sint_t xs, fast_sint_t c, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+{
+    fast_sint_t i, j;
+    for (i = omp_block_start, j = omp_block_start + omp_block_size; i < j && c < xs; i += 1)
+    {
+        if (LCP[i] == UINT8_MAX) { X[2 * c + 0] = (sa_sint_t)i; X[2 * c + 1] = PLCP[SA[i]]; c++; }
+    }
+}
 
-                        memcpy(dst_bucket1, src_bucket1, ALPHABET_SIZE * sizeof(sa_uint_t));
-                    }
+#endif
 
-                    memcpy(buckets, bucket1, ALPHABET_SIZE * sizeof(sa_uint_t));
-                }
-            }
+static sa_sint_t libsais64_compute_lcp_8u_omp(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, uint8_t * RESTRICT LCP, sa_sint_t n, sa_sint_t * RESTRICT X, sa_sint_t xs, sa_sint_t threads)
+{
+    fast_sint_t count = 0;
 
-            #pragma omp barrier
+#if defined(LIBSAIS_OPENMP)
+    fast_sint_t * RESTRICT counts = threads > 1 && n >= 65536 ? (fast_sint_t *)libsais64_alloc_aligned((size_t)threads * sizeof(fast_sint_t), 64) : NULL;
+    if (threads > 1 && n >= 65536 && counts == NULL) { return -2; }
 
-            {
-                fast_sint_t c; for (c = 0; c < ALPHABET_SIZE * ALPHABET_SIZE; c += 1) { sa_uint_t A = bucket2[c], B = bucket2_local[c]; bucket2_local[c] = A + B; }
+    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
+#endif
+    {
+#if defined(LIBSAIS_OPENMP)
+        fast_sint_t omp_thread_num    = omp_get_thread_num();
+        fast_sint_t omp_num_threads   = omp_get_num_threads();
+#else
+        UNUSED(threads);
 
-                libsais64_unbwt_calculate_biPSI(T, P, bucket1_local, bucket2_local, index, omp_block_start, omp_block_start + omp_block_size);
-            }
+        fast_sint_t omp_thread_num    = 0;
+        fast_sint_t omp_num_threads   = 1;
+#endif
+        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
+        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
+        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+
+        if (omp_num_threads == 1)
+        {
+            count = libsais64_compute_lcp_8u(PLCP, SA, LCP, X, xs, omp_block_start, omp_block_size);
+        }
+#if defined(LIBSAIS_OPENMP)
+        else
+        {
+            counts[omp_thread_num] = libsais64_compute_lcp_8u(PLCP, SA, LCP, X, 0, omp_block_start, omp_block_size);
 
             #pragma omp barrier
 
-            #pragma omp master
-            {
-                memcpy(bucket2, buckets + ALPHABET_SIZE + (omp_num_threads - 1) * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE)), ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_uint_t));
-            }
+            fast_sint_t t, c = 0; for (t = 0; t < omp_thread_num; ++t) { c += counts[t]; }
+
+            libsais64_gather_lcp_8u_exceptions(PLCP, SA, LCP, X, xs, c, omp_block_start, omp_block_size);
+
+            if (omp_thread_num == omp_num_threads - 1) { count = c + counts[omp_thread_num]; }
         }
+#endif
     }
-}
 
+#if defined(LIBSAIS_OPENMP)
+    libsais64_free_aligned(counts);
 #endif
 
-static void libsais64_unbwt_decode_1(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t * i0, fast_uint_t k)
-{
-    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
-
-    fast_uint_t i, p0 = *i0;
+    return (sa_sint_t)count;
+}
 
-    for (i = 0; i != k; ++i)
+int64_t libsais64_plcp(const uint8_t * T, const int64_t * SA, int64_t * PLCP, int64_t n)
+{
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0))
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais64_bswap16(c0);
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { PLCP[0] = 0; }
+        return 0;
     }
 
-    *i0 = p0;
+    libsais64_compute_phi_omp(SA, PLCP, n, 1);
+    libsais64_compute_plcp_omp(T, PLCP, n, 1);
+
+    return 0;
 }
 
-static void libsais64_unbwt_decode_2(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t k)
+int64_t libsais64_plcp_gsa(const uint8_t * T, const int64_t * SA, int64_t * PLCP, int64_t n)
 {
-    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
-    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
-
-    fast_uint_t i, p0 = *i0, p1 = *i1;
-
-    for (i = 0; i != k; ++i)
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0))
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais64_bswap16(c0);
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais64_bswap16(c1);
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { PLCP[0] = 0; }
+        return 0;
     }
 
-    *i0 = p0; *i1 = p1;
+    libsais64_compute_phi_omp(SA, PLCP, n, 1);
+    libsais64_compute_plcp_gsa_omp(T, PLCP, n, 1);
+
+    return 0;
 }
 
-static void libsais64_unbwt_decode_3(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t k)
+int64_t libsais64_lcp(const int64_t * PLCP, const int64_t * SA, int64_t * LCP, int64_t n)
 {
-    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
-    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
-    uint16_t * RESTRICT U2 = (uint16_t *)(void *)(((uint8_t *)U1) + r);
-
-    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2;
-
-    for (i = 0; i != k; ++i)
+    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0))
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais64_bswap16(c0);
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais64_bswap16(c1);
-        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = libsais64_bswap16(c2);
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { LCP[0] = PLCP[SA[0]]; }
+        return 0;
     }
 
-    *i0 = p0; *i1 = p1; *i2 = p2;
+    libsais64_compute_lcp_omp(PLCP, SA, LCP, n, 1);
+
+    return 0;
 }
 
-static void libsais64_unbwt_decode_4(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t k)
+int64_t libsais64_plcp_sampled(const uint8_t * T, const int64_t * SA, int64_t * PLCP, int64_t n, int64_t r)
 {
-    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
-    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
-    uint16_t * RESTRICT U2 = (uint16_t *)(void *)(((uint8_t *)U1) + r);
-    uint16_t * RESTRICT U3 = (uint16_t *)(void *)(((uint8_t *)U2) + r);
-
-    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3;
-
-    for (i = 0; i != k; ++i)
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (r <= 0) || ((r & (r - 1)) != 0))
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais64_bswap16(c0);
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais64_bswap16(c1);
-        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = libsais64_bswap16(c2);
-        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = libsais64_bswap16(c3);
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { PLCP[0] = 0; }
+        return 0;
     }
 
-    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3;
+    libsais64_compute_phi_sampled_omp(SA, PLCP, n, r, 1);
+    libsais64_compute_plcp_sampled_omp(T, PLCP, n, r, 1);
+
+    return 0;
 }
 
-static void libsais64_unbwt_decode_5(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t k)
+int64_t libsais64_lcp_sampled(const uint8_t * T, const int64_t * PLCP, const int64_t * SA, int64_t * LCP, int64_t n, int64_t r, int64_t k)
 {
-    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
-    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
-    uint16_t * RESTRICT U2 = (uint16_t *)(void *)(((uint8_t *)U1) + r);
-    uint16_t * RESTRICT U3 = (uint16_t *)(void *)(((uint8_t *)U2) + r);
-    uint16_t * RESTRICT U4 = (uint16_t *)(void *)(((uint8_t *)U3) + r);
-
-    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4;
-
-    for (i = 0; i != k; ++i)
+    if ((T == NULL) || (PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (r <= 0) || ((r & (r - 1)) != 0) || (k <= 0))
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais64_bswap16(c0);
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais64_bswap16(c1);
-        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = libsais64_bswap16(c2);
-        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = libsais64_bswap16(c3);
-        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = libsais64_bswap16(c4);
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { LCP[0] = 0; }
+        return 0;
     }
 
-    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4;
+    libsais64_compute_lcp_sampled_omp(T, PLCP, SA, LCP, n, r, k, 1);
+
+    return 0;
 }
 
-static void libsais64_unbwt_decode_6(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t * i5, fast_uint_t k)
+int64_t libsais64_lcp_marked(const uint8_t * T, const int64_t * PLCP, const int64_t * SA, const uint8_t * B, int64_t * LCP, int64_t n, int64_t r)
 {
-    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
-    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
-    uint16_t * RESTRICT U2 = (uint16_t *)(void *)(((uint8_t *)U1) + r);
-    uint16_t * RESTRICT U3 = (uint16_t *)(void *)(((uint8_t *)U2) + r);
-    uint16_t * RESTRICT U4 = (uint16_t *)(void *)(((uint8_t *)U3) + r);
-    uint16_t * RESTRICT U5 = (uint16_t *)(void *)(((uint8_t *)U4) + r);
-
-    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4, p5 = *i5;
-
-    for (i = 0; i != k; ++i)
+    if ((T == NULL) || (PLCP == NULL) || (SA == NULL) || (B == NULL) || (LCP == NULL) || (n < 0) || (r <= 0) || ((r & (r - 1)) != 0))
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais64_bswap16(c0);
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais64_bswap16(c1);
-        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = libsais64_bswap16(c2);
-        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = libsais64_bswap16(c3);
-        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = libsais64_bswap16(c4);
-        uint16_t c5 = fastbits[p5 >> shift]; if (bucket2[c5] <= p5) { do { c5++; } while (bucket2[c5] <= p5); } p5 = P[p5]; U5[i] = libsais64_bswap16(c5);
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1 && (B[0] & 1)) { LCP[0] = 0; return 1; }
+        return 0;
     }
 
-    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4; *i5 = p5;
+    return libsais64_compute_lcp_marked_omp(T, PLCP, SA, B, LCP, n, r, 1);
 }
 
-static void libsais64_unbwt_decode_7(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t * i5, fast_uint_t * i6, fast_uint_t k)
+int64_t libsais64_lcp_8u(const int64_t * PLCP, const int64_t * SA, uint8_t * LCP, int64_t n, int64_t * X, int64_t xs)
 {
-    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
-    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
-    uint16_t * RESTRICT U2 = (uint16_t *)(void *)(((uint8_t *)U1) + r);
-    uint16_t * RESTRICT U3 = (uint16_t *)(void *)(((uint8_t *)U2) + r);
-    uint16_t * RESTRICT U4 = (uint16_t *)(void *)(((uint8_t *)U3) + r);
-    uint16_t * RESTRICT U5 = (uint16_t *)(void *)(((uint8_t *)U4) + r);
-    uint16_t * RESTRICT U6 = (uint16_t *)(void *)(((uint8_t *)U5) + r);
-
-    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4, p5 = *i5, p6 = *i6;
-
-    for (i = 0; i != k; ++i)
+    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (xs < 0) || (X == NULL && xs > 0))
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais64_bswap16(c0);
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais64_bswap16(c1);
-        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = libsais64_bswap16(c2);
-        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = libsais64_bswap16(c3);
-        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = libsais64_bswap16(c4);
-        uint16_t c5 = fastbits[p5 >> shift]; if (bucket2[c5] <= p5) { do { c5++; } while (bucket2[c5] <= p5); } p5 = P[p5]; U5[i] = libsais64_bswap16(c5);
-        uint16_t c6 = fastbits[p6 >> shift]; if (bucket2[c6] <= p6) { do { c6++; } while (bucket2[c6] <= p6); } p6 = P[p6]; U6[i] = libsais64_bswap16(c6);
+        return -1;
     }
 
-    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4; *i5 = p5; *i6 = p6;
+    return libsais64_compute_lcp_8u_omp(PLCP, SA, LCP, n, X, xs, 1);
 }
 
-static void libsais64_unbwt_decode_8(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_uint_t shift, fast_uint_t r, fast_uint_t * i0, fast_uint_t * i1, fast_uint_t * i2, fast_uint_t * i3, fast_uint_t * i4, fast_uint_t * i5, fast_uint_t * i6, fast_uint_t * i7, fast_uint_t k)
+int64_t libsais64_isa(const int64_t * SA, int64_t * ISA, int64_t n)
 {
-    uint16_t * RESTRICT U0 = (uint16_t *)(void *)U;
-    uint16_t * RESTRICT U1 = (uint16_t *)(void *)(((uint8_t *)U0) + r);
-    uint16_t * RESTRICT U2 = (uint16_t *)(void *)(((uint8_t *)U1) + r);
-    uint16_t * RESTRICT U3 = (uint16_t *)(void *)(((uint8_t *)U2) + r);
-    uint16_t * RESTRICT U4 = (uint16_t *)(void *)(((uint8_t *)U3) + r);
-    uint16_t * RESTRICT U5 = (uint16_t *)(void *)(((uint8_t *)U4) + r);
-    uint16_t * RESTRICT U6 = (uint16_t *)(void *)(((uint8_t *)U5) + r);
-    uint16_t * RESTRICT U7 = (uint16_t *)(void *)(((uint8_t *)U6) + r);
-
-    fast_uint_t i, p0 = *i0, p1 = *i1, p2 = *i2, p3 = *i3, p4 = *i4, p5 = *i5, p6 = *i6, p7 = *i7;
-
-    for (i = 0; i != k; ++i)
+    if ((SA == NULL) || (ISA == NULL) || (n < 0))
     {
-        uint16_t c0 = fastbits[p0 >> shift]; if (bucket2[c0] <= p0) { do { c0++; } while (bucket2[c0] <= p0); } p0 = P[p0]; U0[i] = libsais64_bswap16(c0);
-        uint16_t c1 = fastbits[p1 >> shift]; if (bucket2[c1] <= p1) { do { c1++; } while (bucket2[c1] <= p1); } p1 = P[p1]; U1[i] = libsais64_bswap16(c1);
-        uint16_t c2 = fastbits[p2 >> shift]; if (bucket2[c2] <= p2) { do { c2++; } while (bucket2[c2] <= p2); } p2 = P[p2]; U2[i] = libsais64_bswap16(c2);
-        uint16_t c3 = fastbits[p3 >> shift]; if (bucket2[c3] <= p3) { do { c3++; } while (bucket2[c3] <= p3); } p3 = P[p3]; U3[i] = libsais64_bswap16(c3);
-        uint16_t c4 = fastbits[p4 >> shift]; if (bucket2[c4] <= p4) { do { c4++; } while (bucket2[c4] <= p4); } p4 = P[p4]; U4[i] = libsais64_bswap16(c4);
-        uint16_t c5 = fastbits[p5 >> shift]; if (bucket2[c5] <= p5) { do { c5++; } while (bucket2[c5] <= p5); } p5 = P[p5]; U5[i] = libsais64_bswap16(c5);
-        uint16_t c6 = fastbits[p6 >> shift]; if (bucket2[c6] <= p6) { do { c6++; } while (bucket2[c6] <= p6); } p6 = P[p6]; U6[i] = libsais64_bswap16(c6);
-        uint16_t c7 = fastbits[p7 >> shift]; if (bucket2[c7] <= p7) { do { c7++; } while (bucket2[c7] <= p7); } p7 = P[p7]; U7[i] = libsais64_bswap16(c7);
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { ISA[0] = 0; }
+        return 0;
     }
 
-    *i0 = p0; *i1 = p1; *i2 = p2; *i3 = p3; *i4 = p4; *i5 = p5; *i6 = p6; *i7 = p7;
+    libsais64_compute_isa_omp(SA, ISA, n, 1);
+
+    return 0;
 }
 
-static void libsais64_unbwt_decode(uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, fast_sint_t blocks, fast_uint_t remainder)
+int64_t libsais64_sa_lcp(const uint8_t * T, int64_t * SA, int64_t * LCP, int64_t n, int64_t fs, int64_t * freq)
 {
-    fast_uint_t shift       = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
-    fast_uint_t offset      = 0;
-
-    while (blocks > 8)
-    {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5], i6 = I[6], i7 = I[7];
-        libsais64_unbwt_decode_8(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, &i7, (fast_uint_t)r >> 1);
-        I += 8; blocks -= 8; offset += 8 * (fast_uint_t)r;
-    }
-
-    if (blocks == 1)
+    if ((T == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (fs < 0))
     {
-        fast_uint_t i0 = I[0];
-        libsais64_unbwt_decode_1(U + offset, P, bucket2, fastbits, shift, &i0, remainder >> 1);
+        return -1;
     }
-    else if (blocks == 2)
+    else if (n < 2)
     {
-        fast_uint_t i0 = I[0], i1 = I[1];
-        libsais64_unbwt_decode_2(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, remainder >> 1);
-        libsais64_unbwt_decode_1(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, &i0, ((fast_uint_t)r >> 1) - (remainder >> 1));
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { SA[0] = 0; LCP[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
     }
-    else if (blocks == 3)
+
+    if (n <= INT32_MAX)
     {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2];
-        libsais64_unbwt_decode_3(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, remainder >> 1);
-        libsais64_unbwt_decode_2(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, ((fast_uint_t)r >> 1) - (remainder >> 1));
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        sa_sint_t index = libsais_sa_lcp(T, (int32_t *)SA, (int32_t *)LCP, (int32_t)n, (int32_t)new_fs, (int32_t *)freq);
+
+        if (index >= 0)
+        {
+            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)SA, n, 1);
+            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)LCP, n, 1);
+            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, 1); }
+        }
+
+        return index;
     }
-    else if (blocks == 4)
+
+    sa_sint_t index = libsais64_main(T, SA, n, 0, 0, NULL, NULL, fs, freq, 1);
+    if (index == 0)
     {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3];
-        libsais64_unbwt_decode_4(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, remainder >> 1);
-        libsais64_unbwt_decode_3(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, ((fast_uint_t)r >> 1) - (remainder >> 1));
+        libsais64_compute_sa_lcp_omp(T, SA, LCP, n, fs, 1);
     }
-    else if (blocks == 5)
+
+    return index;
+}
+
+int64_t libsais64_sa_lcp_ctx(const void * ctx, const uint8_t * T, int64_t * SA, int64_t * LCP, int64_t n, int64_t fs, int64_t * freq)
+{
+    if ((ctx == NULL) || (T == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (fs < 0))
     {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4];
-        libsais64_unbwt_decode_5(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, remainder >> 1);
-        libsais64_unbwt_decode_4(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, ((fast_uint_t)r >> 1) - (remainder >> 1));
+        return -1;
     }
-    else if (blocks == 6)
+    else if (n < 2)
     {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5];
-        libsais64_unbwt_decode_6(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, remainder >> 1);
-        libsais64_unbwt_decode_5(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, ((fast_uint_t)r >> 1) - (remainder >> 1));
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { SA[0] = 0; LCP[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
     }
-    else if (blocks == 7)
+
+    const LIBSAIS_CONTEXT * RESTRICT context = (const LIBSAIS_CONTEXT *)ctx;
+
+    if (n <= INT32_MAX)
     {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5], i6 = I[6];
-        libsais64_unbwt_decode_7(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, remainder >> 1);
-        libsais64_unbwt_decode_6(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, ((fast_uint_t)r >> 1) - (remainder >> 1));
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        libsais64_numa_place_omp(context, SA, n, fs);
+        sa_sint_t index = libsais_sa_lcp_ctx(context->ctx32, T, (int32_t *)SA, (int32_t *)LCP, (int32_t)n, (int32_t)new_fs, (int32_t *)freq);
+
+        if (index >= 0)
+        {
+            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)SA, n, (sa_sint_t)context->threads);
+            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)LCP, n, (sa_sint_t)context->threads);
+            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, (sa_sint_t)context->threads); }
+        }
+
+        return libsais64_ctx_status(context, index);
     }
-    else
+
+    sa_sint_t index = libsais64_main_ctx(context, T, SA, n, 0, 0, NULL, NULL, fs, freq);
+    if (index == 0)
     {
-        fast_uint_t i0 = I[0], i1 = I[1], i2 = I[2], i3 = I[3], i4 = I[4], i5 = I[5], i6 = I[6], i7 = I[7];
-        libsais64_unbwt_decode_8(U + offset, P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, &i7, remainder >> 1);
-        libsais64_unbwt_decode_7(U + offset + 2 * (remainder >> 1), P, bucket2, fastbits, shift, (fast_uint_t)r, &i0, &i1, &i2, &i3, &i4, &i5, &i6, ((fast_uint_t)r >> 1) - (remainder >> 1));
+        libsais64_compute_sa_lcp_omp(T, SA, LCP, n, fs, (sa_sint_t)context->threads);
     }
+
+    return index;
 }
 
-static void libsais64_unbwt_decode_omp(const uint8_t * RESTRICT T, uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, sa_sint_t threads)
+int64_t libsais64_pack_40u(int64_t * A, int64_t n)
 {
-    fast_uint_t lastc       = T[0];
-    fast_sint_t blocks      = 1 + (((fast_sint_t)n - 1) / (fast_sint_t)r);
-    fast_uint_t remainder   = (fast_uint_t)n - ((fast_uint_t)r * ((fast_uint_t)blocks - 1));
-
-#if defined(LIBSAIS_OPENMP)
-    fast_sint_t max_threads = blocks < threads ? blocks : threads;
-    #pragma omp parallel num_threads(max_threads) if(max_threads > 1 && n >= 65536)
-#endif
+    if ((A == NULL) || (n < 0) || (n > LIBSAIS_40U_MAX))
     {
-#if defined(LIBSAIS_OPENMP)
-        fast_sint_t omp_thread_num      = omp_get_thread_num();
-        fast_sint_t omp_num_threads     = omp_get_num_threads();
-#else
-        UNUSED(threads);
+        return -1;
+    }
 
-        fast_sint_t omp_thread_num      = 0;
-        fast_sint_t omp_num_threads     = 1;
-#endif
+    libsais64_convert_inplace_64u_to_40u_omp(A, n, 1);
 
-        fast_sint_t omp_block_stride    = blocks / omp_num_threads;
-        fast_sint_t omp_block_remainder = blocks % omp_num_threads;
-        fast_sint_t omp_block_size      = omp_block_stride + (omp_thread_num < omp_block_remainder);
-        fast_sint_t omp_block_start     = omp_block_stride * omp_thread_num + (omp_thread_num < omp_block_remainder ? omp_thread_num : omp_block_remainder);
+    return 0;
+}
 
-        libsais64_unbwt_decode(U + r * omp_block_start, P, n, r, I + omp_block_start, bucket2, fastbits, omp_block_size, omp_thread_num < omp_num_threads - 1 ? (fast_uint_t)r : remainder);
+int64_t libsais64_unpack_40u(int64_t * A, int64_t n)
+{
+    if ((A == NULL) || (n < 0) || (n > LIBSAIS_40U_MAX))
+    {
+        return -1;
     }
 
-    U[n - 1] = (uint8_t)lastc;
+    libsais64_convert_inplace_40u_to_64u_omp(A, n, 1);
+
+    return 0;
 }
 
-static sa_sint_t libsais64_unbwt_core(const uint8_t * RESTRICT T, uint8_t * RESTRICT U, sa_uint_t * RESTRICT P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * RESTRICT I, sa_uint_t * RESTRICT bucket2, uint16_t * RESTRICT fastbits, sa_uint_t * RESTRICT buckets, sa_sint_t threads)
+int64_t libsais64_plcp_40u(const uint8_t * T, const uint8_t * SA, uint8_t * PLCP, int64_t n)
 {
-#if defined(LIBSAIS_OPENMP)
-    if (threads > 1 && n >= 262144)
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (n >= LIBSAIS_40U_MAX))
     {
-        libsais64_unbwt_init_parallel(T, P, n, freq, I, bucket2, fastbits, buckets, threads);
+        return -1;
     }
-    else
-#else
-    UNUSED(buckets);
-#endif
+    else if (n <= 1)
     {
-        libsais64_unbwt_init_single(T, P, n, freq, I, bucket2, fastbits);
+        if (n == 1) { libsais64_store_40u(PLCP, 0, 0); }
+        return 0;
     }
 
-    libsais64_unbwt_decode_omp(T, U, P, n, r, I, bucket2, fastbits, threads);
+    libsais64_compute_phi_40u_omp(SA, PLCP, n, 1);
+    libsais64_compute_plcp_40u_omp(T, PLCP, n, 1);
+
     return 0;
 }
 
-static sa_sint_t libsais64_unbwt_main(const uint8_t * T, uint8_t * U, sa_uint_t * P, sa_sint_t n, const sa_sint_t * freq, sa_sint_t r, const sa_uint_t * I, sa_sint_t threads)
+int64_t libsais64_lcp_40u(const uint8_t * PLCP, const uint8_t * SA, uint8_t * LCP, int64_t n)
 {
-    fast_uint_t shift = 0; while ((n >> shift) > ((sa_sint_t)1 << UNBWT_FASTBITS)) { shift++; }
+    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (n > LIBSAIS_40U_MAX))
+    {
+        return -1;
+    }
 
-    sa_uint_t *     RESTRICT bucket2        = (sa_uint_t *)libsais64_alloc_aligned(ALPHABET_SIZE * ALPHABET_SIZE * sizeof(sa_uint_t), 4096);
-    uint16_t *      RESTRICT fastbits       = (uint16_t *)libsais64_alloc_aligned(((size_t)1 + (size_t)(n >> shift)) * sizeof(uint16_t), 4096);
-    sa_uint_t *     RESTRICT buckets        = threads > 1 && n >= 262144 ? (sa_uint_t *)libsais64_alloc_aligned((size_t)threads * (ALPHABET_SIZE + (ALPHABET_SIZE * ALPHABET_SIZE)) * sizeof(sa_uint_t), 4096) : NULL;
+    libsais64_compute_lcp_40u_omp(PLCP, SA, LCP, n, 1);
 
-    sa_sint_t index = bucket2 != NULL && fastbits != NULL && (buckets != NULL || threads == 1 || n < 262144)
-        ? libsais64_unbwt_core(T, U, P, n, freq, r, I, bucket2, fastbits, buckets, threads)
-        : -2;
+    return 0;
+}
 
-    libsais64_free_aligned(buckets);
-    libsais64_free_aligned(fastbits);
-    libsais64_free_aligned(bucket2);
+#if defined(LIBSAIS_OPENMP)
+
+int64_t libsais64_plcp_omp(const uint8_t * T, const int64_t * SA, int64_t * PLCP, int64_t n, int64_t threads)
+{
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { PLCP[0] = 0; }
+        return 0;
+    }
+    
+    threads = threads > 0 ? threads : omp_get_max_threads();
 
-    return index;
-}
+    libsais64_compute_phi_omp(SA, PLCP, n, threads);
+    libsais64_compute_plcp_omp(T, PLCP, n, threads);
 
-int64_t libsais64_unbwt(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t i)
-{
-    return libsais64_unbwt_aux(T, U, A, n, freq, n, &i);
+    return 0;
 }
 
-int64_t libsais64_unbwt_aux(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t r, const int64_t * I)
+int64_t libsais64_plcp_gsa_omp(const uint8_t * T, const int64_t * SA, int64_t * PLCP, int64_t n, int64_t threads)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL))
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (threads < 0))
     {
         return -1;
     }
     else if (n <= 1)
     {
-        if (I[0] != n) { return -1; }
-        if (n == 1) { U[0] = T[0]; }
+        if (n == 1) { PLCP[0] = 0; }
         return 0;
     }
+    
+    threads = threads > 0 ? threads : omp_get_max_threads();
 
-    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
+    libsais64_compute_phi_omp(SA, PLCP, n, threads);
+    libsais64_compute_plcp_gsa_omp(T, PLCP, n, threads);
 
-    if (n <= INT32_MAX && r <= INT32_MAX && (n - 1) / r < 1024)
-    {
-        int32_t indexes[1024]; for (t = 0; t <= (n - 1) / r; ++t) { indexes[t] = (int32_t)I[t]; }
-        int32_t frequencies[ALPHABET_SIZE]; if (freq != NULL) { for (t = 0; t < ALPHABET_SIZE; ++t) { frequencies[t] = (int32_t)freq[t]; } }
+    return 0;
+}
 
-        return libsais_unbwt_aux(T, U, (int32_t *)A, (int32_t)n, freq != NULL ? frequencies : NULL, (int32_t)r, indexes);
+int64_t libsais64_lcp_omp(const int64_t * PLCP, const int64_t * SA, int64_t * LCP, int64_t n, int64_t threads)
+{
+    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (threads < 0))
+    {
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { LCP[0] = PLCP[SA[0]]; }
+        return 0;
     }
 
-    return libsais64_unbwt_main(T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, 1);
-}
+    threads = threads > 0 ? threads : omp_get_max_threads();
 
-#if defined(LIBSAIS_OPENMP)
+    libsais64_compute_lcp_omp(PLCP, SA, LCP, n, threads);
 
-int64_t libsais64_unbwt_omp(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t i, int64_t threads)
-{
-    return libsais64_unbwt_aux_omp(T, U, A, n, freq, n, &i, threads);
+    return 0;
 }
 
-int64_t libsais64_unbwt_aux_omp(const uint8_t * T, uint8_t * U, int64_t * A, int64_t n, const int64_t * freq, int64_t r, const int64_t * I, int64_t threads)
+int64_t libsais64_plcp_sampled_omp(const uint8_t * T, const int64_t * SA, int64_t * PLCP, int64_t n, int64_t r, int64_t threads)
 {
-    if ((T == NULL) || (U == NULL) || (A == NULL) || (n < 0) || ((r != n) && ((r < 2) || ((r & (r - 1)) != 0))) || (I == NULL) || (threads < 0))
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (r <= 0) || ((r & (r - 1)) != 0) || (threads < 0))
     {
         return -1;
     }
     else if (n <= 1)
     {
-        if (I[0] != n) { return -1; }
-        if (n == 1) { U[0] = T[0]; }
+        if (n == 1) { PLCP[0] = 0; }
         return 0;
     }
 
-    fast_sint_t t; for (t = 0; t <= (n - 1) / r; ++t) { if (I[t] <= 0 || I[t] > n) { return -1; } }
-
-    if (n <= INT32_MAX && r <= INT32_MAX && (n - 1) / r < 1024)
-    {
-        int32_t indexes[1024]; for (t = 0; t <= (n - 1) / r; ++t) { indexes[t] = (int32_t)I[t]; }
-        int32_t frequencies[ALPHABET_SIZE]; if (freq != NULL) { for (t = 0; t < ALPHABET_SIZE; ++t) { frequencies[t] = (int32_t)freq[t]; } }
+    threads = threads > 0 ? threads : omp_get_max_threads();
 
-        return libsais_unbwt_aux_omp(T, U, (int32_t *)A, (int32_t)n, freq != NULL ? frequencies : NULL,(int32_t)r, indexes, (int32_t)threads);
-    }
+    libsais64_compute_phi_sampled_omp(SA, PLCP, n, r, threads);
+    libsais64_compute_plcp_sampled_omp(T, PLCP, n, r, threads);
 
-    threads = threads > 0 ? threads : omp_get_max_threads();
-    return libsais64_unbwt_main(T, U, (sa_uint_t *)A, n, freq, r, (const sa_uint_t *)I, threads);
+    return 0;
 }
 
-#endif
-
-static void libsais64_compute_phi(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+int64_t libsais64_lcp_sampled_omp(const uint8_t * T, const int64_t * PLCP, const int64_t * SA, int64_t * LCP, int64_t n, int64_t r, int64_t k, int64_t threads)
 {
-    const fast_sint_t prefetch_distance = 32;
-
-    fast_sint_t i, j; sa_sint_t k = omp_block_start > 0 ? SA[omp_block_start - 1] : n;
-    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
+    if ((T == NULL) || (PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (r <= 0) || ((r & (r - 1)) != 0) || (k <= 0) || (threads < 0))
     {
-        libsais64_prefetchr(&SA[i + 2 * prefetch_distance]);
+        return -1;
+    }
+    else if (n <= 1)
+    {
+        if (n == 1) { LCP[0] = 0; }
+        return 0;
+    }
 
-        libsais64_prefetchw(&PLCP[SA[i + prefetch_distance + 0]]);
-        libsais64_prefetchw(&PLCP[SA[i + prefetch_distance + 1]]);
+    threads = threads > 0 ? threads : omp_get_max_threads();
 
-        PLCP[SA[i + 0]] = k; k = SA[i + 0];
-        PLCP[SA[i + 1]] = k; k = SA[i + 1];
+    libsais64_compute_lcp_sampled_omp(T, PLCP, SA, LCP, n, r, k, threads);
 
-        libsais64_prefetchw(&PLCP[SA[i + prefetch_distance + 2]]);
-        libsais64_prefetchw(&PLCP[SA[i + prefetch_distance + 3]]);
+    return 0;
+}
 
-        PLCP[SA[i + 2]] = k; k = SA[i + 2];
-        PLCP[SA[i + 3]] = k; k = SA[i + 3];
+int64_t libsais64_lcp_marked_omp(const uint8_t * T, const int64_t * PLCP, const int64_t * SA, const uint8_t * B, int64_t * LCP, int64_t n, int64_t r, int64_t threads)
+{
+    if ((T == NULL) || (PLCP == NULL) || (SA == NULL) || (B == NULL) || (LCP == NULL) || (n < 0) || (r <= 0) || ((r & (r - 1)) != 0) || (threads < 0))
+    {
+        return -1;
     }
-
-    for (j += prefetch_distance + 3; i < j; i += 1)
+    else if (n <= 1)
     {
-        PLCP[SA[i]] = k; k = SA[i];
+        if (n == 1 && (B[0] & 1)) { LCP[0] = 0; return 1; }
+        return 0;
     }
+
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    return libsais64_compute_lcp_marked_omp(T, PLCP, SA, B, LCP, n, r, threads);
 }
 
-static void libsais64_compute_phi_omp(const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
+int64_t libsais64_lcp_8u_omp(const int64_t * PLCP, const int64_t * SA, uint8_t * LCP, int64_t n, int64_t * X, int64_t xs, int64_t threads)
 {
-#if defined(LIBSAIS_OPENMP)
-    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
-#endif
+    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (xs < 0) || (X == NULL && xs > 0) || (threads < 0))
     {
-#if defined(LIBSAIS_OPENMP)
-        fast_sint_t omp_thread_num    = omp_get_thread_num();
-        fast_sint_t omp_num_threads   = omp_get_num_threads();
-#else
-        UNUSED(threads);
+        return -1;
+    }
 
-        fast_sint_t omp_thread_num    = 0;
-        fast_sint_t omp_num_threads   = 1;
-#endif
-        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
-        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
-        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+    threads = threads > 0 ? threads : omp_get_max_threads();
 
-        libsais64_compute_phi(SA, PLCP, n, omp_block_start, omp_block_size);
-    }
+    return libsais64_compute_lcp_8u_omp(PLCP, SA, LCP, n, X, xs, threads);
 }
 
-static void libsais64_compute_plcp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, fast_sint_t n, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+int64_t libsais64_isa_omp(const int64_t * SA, int64_t * ISA, int64_t n, int64_t threads)
 {
-    const fast_sint_t prefetch_distance = 32;
-
-    fast_sint_t i, j, l = 0;
-    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance; i < j; i += 1)
+    if ((SA == NULL) || (ISA == NULL) || (n < 0) || (threads < 0))
     {
-        libsais64_prefetchw(&PLCP[i + 2 * prefetch_distance]);
-        libsais64_prefetchr(&T[PLCP[i + prefetch_distance] + l]);
-
-        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
-        while (l < m && T[i + l] == T[k + l]) { l++; }
-
-        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+        return -1;
     }
-
-    for (j += prefetch_distance; i < j; i += 1)
+    else if (n <= 1)
     {
-        fast_sint_t k = PLCP[i], m = n - (i > k ? i : k);
-        while (l < m && T[i + l] == T[k + l]) { l++; }
-
-        PLCP[i] = (sa_sint_t)l; l -= (l != 0);
+        if (n == 1) { ISA[0] = 0; }
+        return 0;
     }
-}
 
-static void libsais64_compute_plcp_omp(const uint8_t * RESTRICT T, sa_sint_t * RESTRICT PLCP, sa_sint_t n, sa_sint_t threads)
-{
-#if defined(LIBSAIS_OPENMP)
-    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
-#endif
-    {
-#if defined(LIBSAIS_OPENMP)
-        fast_sint_t omp_thread_num    = omp_get_thread_num();
-        fast_sint_t omp_num_threads   = omp_get_num_threads();
-#else
-        UNUSED(threads);
+    threads = threads > 0 ? threads : omp_get_max_threads();
 
-        fast_sint_t omp_thread_num    = 0;
-        fast_sint_t omp_num_threads   = 1;
-#endif
-        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
-        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
-        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
+    libsais64_compute_isa_omp(SA, ISA, n, threads);
 
-        libsais64_compute_plcp(T, PLCP, n, omp_block_start, omp_block_size);
-    }
+    return 0;
 }
 
-static void libsais64_compute_lcp(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, fast_sint_t omp_block_start, fast_sint_t omp_block_size)
+int64_t libsais64_sa_lcp_omp(const uint8_t * T, int64_t * SA, int64_t * LCP, int64_t n, int64_t fs, int64_t * freq, int64_t threads)
 {
-    const fast_sint_t prefetch_distance = 32;
-
-    fast_sint_t i, j;
-    for (i = omp_block_start, j = omp_block_start + omp_block_size - prefetch_distance - 3; i < j; i += 4)
+    if ((T == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (fs < 0) || (threads < 0))
     {
-        libsais64_prefetchr(&SA[i + 2 * prefetch_distance]);
-        libsais64_prefetchw(&LCP[i + prefetch_distance]);
+        return -1;
+    }
+    else if (n < 2)
+    {
+        if (freq != NULL) { memset(freq, 0, ALPHABET_SIZE * sizeof(int64_t)); }
+        if (n == 1) { SA[0] = 0; LCP[0] = 0; if (freq != NULL) { freq[T[0]]++; } }
+        return 0;
+    }
 
-        libsais64_prefetchr(&PLCP[SA[i + prefetch_distance + 0]]);
-        libsais64_prefetchr(&PLCP[SA[i + prefetch_distance + 1]]);
+    threads = threads > 0 ? threads : omp_get_max_threads();
 
-        LCP[i + 0] = PLCP[SA[i + 0]];
-        LCP[i + 1] = PLCP[SA[i + 1]];
+    if (n <= INT32_MAX)
+    {
+        sa_sint_t new_fs = (fs + fs + n + n) <= INT32_MAX ? (fs + fs + n) : INT32_MAX - n;
+        sa_sint_t index = libsais_sa_lcp_omp(T, (int32_t *)SA, (int32_t *)LCP, (int32_t)n, (int32_t)new_fs, (int32_t *)freq, (int32_t)threads);
 
-        libsais64_prefetchr(&PLCP[SA[i + prefetch_distance + 2]]);
-        libsais64_prefetchr(&PLCP[SA[i + prefetch_distance + 3]]);
+        if (index >= 0)
+        {
+            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)SA, n, threads);
+            libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)LCP, n, threads);
+            if (freq != NULL) { libsais64_convert_inplace_32u_to_64u_omp((uint32_t *)freq, ALPHABET_SIZE, threads); }
+        }
 
-        LCP[i + 2] = PLCP[SA[i + 2]];
-        LCP[i + 3] = PLCP[SA[i + 3]];
+        return index;
     }
 
-    for (j += prefetch_distance + 3; i < j; i += 1)
+    sa_sint_t index = libsais64_main(T, SA, n, 0, 0, NULL, NULL, fs, freq, threads);
+    if (index == 0)
     {
-        LCP[i] = PLCP[SA[i]];
+        libsais64_compute_sa_lcp_omp(T, SA, LCP, n, fs, threads);
     }
-}
-
-static void libsais64_compute_lcp_omp(const sa_sint_t * RESTRICT PLCP, const sa_sint_t * RESTRICT SA, sa_sint_t * RESTRICT LCP, sa_sint_t n, sa_sint_t threads)
-{
-#if defined(LIBSAIS_OPENMP)
-    #pragma omp parallel num_threads(threads) if(threads > 1 && n >= 65536)
-#endif
-    {
-#if defined(LIBSAIS_OPENMP)
-        fast_sint_t omp_thread_num    = omp_get_thread_num();
-        fast_sint_t omp_num_threads   = omp_get_num_threads();
-#else
-        UNUSED(threads);
 
-        fast_sint_t omp_thread_num    = 0;
-        fast_sint_t omp_num_threads   = 1;
-#endif
-        fast_sint_t omp_block_stride  = (n / omp_num_threads) & (-16);
-        fast_sint_t omp_block_start   = omp_thread_num * omp_block_stride;
-        fast_sint_t omp_block_size    = omp_thread_num < omp_num_threads - 1 ? omp_block_stride : n - omp_block_start;
-
-        libsais64_compute_lcp(PLCP, SA, LCP, omp_block_start, omp_block_size);
-    }
+    return index;
 }
 
-int64_t libsais64_plcp(const uint8_t * T, const int64_t * SA, int64_t * PLCP, int64_t n)
+int64_t libsais64_pack_40u_omp(int64_t * A, int64_t n, int64_t threads)
 {
-    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0))
+    if ((A == NULL) || (n < 0) || (n > LIBSAIS_40U_MAX) || (threads < 0))
     {
         return -1;
     }
-    else if (n <= 1)
-    {
-        if (n == 1) { PLCP[0] = 0; }
-        return 0;
-    }
 
-    libsais64_compute_phi_omp(SA, PLCP, n, 1);
-    libsais64_compute_plcp_omp(T, PLCP, n, 1);
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    libsais64_convert_inplace_64u_to_40u_omp(A, n, threads);
 
     return 0;
 }
 
-int64_t libsais64_lcp(const int64_t * PLCP, const int64_t * SA, int64_t * LCP, int64_t n)
+int64_t libsais64_unpack_40u_omp(int64_t * A, int64_t n, int64_t threads)
 {
-    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0))
+    if ((A == NULL) || (n < 0) || (n > LIBSAIS_40U_MAX) || (threads < 0))
     {
         return -1;
     }
-    else if (n <= 1)
-    {
-        if (n == 1) { LCP[0] = PLCP[SA[0]]; }
-        return 0;
-    }
 
-    libsais64_compute_lcp_omp(PLCP, SA, LCP, n, 1);
+    threads = threads > 0 ? threads : omp_get_max_threads();
+
+    libsais64_convert_inplace_40u_to_64u_omp(A, n, threads);
 
     return 0;
 }
 
-#if defined(LIBSAIS_OPENMP)
-
-int64_t libsais64_plcp_omp(const uint8_t * T, const int64_t * SA, int64_t * PLCP, int64_t n, int64_t threads)
+int64_t libsais64_plcp_40u_omp(const uint8_t * T, const uint8_t * SA, uint8_t * PLCP, int64_t n, int64_t threads)
 {
-    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (threads < 0))
+    if ((T == NULL) || (SA == NULL) || (PLCP == NULL) || (n < 0) || (n >= LIBSAIS_40U_MAX) || (threads < 0))
     {
         return -1;
     }
     else if (n <= 1)
     {
-        if (n == 1) { PLCP[0] = 0; }
+        if (n == 1) { libsais64_store_40u(PLCP, 0, 0); }
         return 0;
     }
-    
+
     threads = threads > 0 ? threads : omp_get_max_threads();
 
-    libsais64_compute_phi_omp(SA, PLCP, n, threads);
-    libsais64_compute_plcp_omp(T, PLCP, n, threads);
+    libsais64_compute_phi_40u_omp(SA, PLCP, n, threads);
+    libsais64_compute_plcp_40u_omp(T, PLCP, n, threads);
 
     return 0;
 }
 
-int64_t libsais64_lcp_omp(const int64_t * PLCP, const int64_t * SA, int64_t * LCP, int64_t n, int64_t threads)
+int64_t libsais64_lcp_40u_omp(const uint8_t * PLCP, const uint8_t * SA, uint8_t * LCP, int64_t n, int64_t threads)
 {
-    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (threads < 0))
+    if ((PLCP == NULL) || (SA == NULL) || (LCP == NULL) || (n < 0) || (n > LIBSAIS_40U_MAX) || (threads < 0))
     {
         return -1;
     }
-    else if (n <= 1)
-    {
-        if (n == 1) { LCP[0] = PLCP[SA[0]]; }
-        return 0;
-    }
 
     threads = threads > 0 ? threads : omp_get_max_threads();
 
-    libsais64_compute_lcp_omp(PLCP, SA, LCP, n, threads);
+    libsais64_compute_lcp_40u_omp(PLCP, SA, LCP, n, threads);
 
     return 0;
 }